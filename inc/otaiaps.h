@@ -107,6 +107,21 @@ typedef void (*otai_aps_report_switch_info_fn)(
         _In_ otai_object_id_t aps_id,
         _In_ otai_olp_switch_t switch_info);
 
+/**
+ * @brief APS report switch info notification, passed by reference
+ *
+ * Switch info is in adapter owned buffer, which is not copied. Buffer
+ * stays valid after notification returns, until it is released with
+ * release_aps_switch_info(), which must be called exactly once for each
+ * notification.
+ *
+ * @param[in] aps_id APS Id
+ * @param[in] switch_info Switch info
+ */
+typedef void (*otai_aps_report_switch_info_ref_fn)(
+        _In_ otai_object_id_t aps_id,
+        _In_ const otai_olp_switch_t *switch_info);
+
 /**
  * @defgroup OTAIAPS OTAI - APS specific API definitions
  *
@@ -350,6 +365,18 @@ typedef enum _otai_aps_attr_t
      */
     OTAI_APS_ATTR_COLLECT_SWITCH_INFO,
 
+    /**
+     * @brief Switch info notify, passed by reference
+     *
+     * When set, switch info is reported with this notification instead of
+     * #OTAI_APS_ATTR_SWITCH_INFO_NOTIFY.
+     *
+     * @type otai_pointer_t otai_aps_report_switch_info_ref_fn
+     * @flags CREATE_ONLY
+     * @default NULL
+     */
+    OTAI_APS_ATTR_SWITCH_INFO_REF_NOTIFY,
+
     /**
      * @brief End of attributes
      */
@@ -491,6 +518,18 @@ typedef otai_status_t (*otai_clear_aps_stats_fn)(
         _In_ uint32_t number_of_counters,
         _In_ const otai_stat_id_t *counter_ids);
 
+/**
+ * @brief Release APS switch info
+ *
+ * Returns switch info buffer passed by reference notification to adapter.
+ *
+ * @param[in] switch_info Switch info passed to notification
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, failure status code on error
+ */
+typedef otai_status_t (*otai_release_aps_switch_info_fn)(
+        _In_ const otai_olp_switch_t *switch_info);
+
 /**
  * @brief Routing interface methods table retrieved with otai_api_query()
  */
@@ -503,6 +542,12 @@ typedef struct _otai_aps_api_t
     otai_get_aps_stats_fn             get_aps_stats;
     otai_get_aps_stats_ext_fn         get_aps_stats_ext;
     otai_clear_aps_stats_fn           clear_aps_stats;
+    otai_bulk_object_create_fn        create_apses;
+    otai_bulk_object_remove_fn        remove_apses;
+    otai_bulk_object_set_attribute_fn set_apses_attribute;
+    otai_bulk_object_get_attribute_fn get_apses_attribute;
+    otai_bulk_object_get_stats_fn     get_apses_stats;
+    otai_release_aps_switch_info_fn   release_aps_switch_info;
 } otai_aps_api_t;
 
 /**
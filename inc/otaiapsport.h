@@ -263,6 +263,11 @@ typedef struct _otai_apsport_api_t
     otai_get_apsport_stats_fn             get_apsport_stats;
     otai_get_apsport_stats_ext_fn         get_apsport_stats_ext;
     otai_clear_apsport_stats_fn           clear_apsport_stats;
+    otai_bulk_object_create_fn            create_apsports;
+    otai_bulk_object_remove_fn            remove_apsports;
+    otai_bulk_object_set_attribute_fn     set_apsports_attribute;
+    otai_bulk_object_get_attribute_fn     get_apsports_attribute;
+    otai_bulk_object_get_stats_fn         get_apsports_stats;
 } otai_apsport_api_t;
 
 /**
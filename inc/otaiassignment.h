@@ -281,6 +281,11 @@ typedef struct _otai_assignment_api_t
     otai_get_assignment_stats_fn           get_assignment_stats;
     otai_get_assignment_stats_ext_fn       get_assignment_stats_ext;
     otai_clear_assignment_stats_fn         clear_assignment_stats;
+    otai_bulk_object_create_fn             create_assignments;
+    otai_bulk_object_remove_fn             remove_assignments;
+    otai_bulk_object_set_attribute_fn      set_assignments_attribute;
+    otai_bulk_object_get_attribute_fn      get_assignments_attribute;
+    otai_bulk_object_get_stats_fn          get_assignments_stats;
 } otai_assignment_api_t;
 
 /**
@@ -285,6 +285,11 @@ typedef struct _otai_attenuator_api_t
     otai_get_attenuator_stats_fn             get_attenuator_stats;
     otai_get_attenuator_stats_ext_fn         get_attenuator_stats_ext;
     otai_clear_attenuator_stats_fn           clear_attenuator_stats;
+    otai_bulk_object_create_fn               create_attenuators;
+    otai_bulk_object_remove_fn               remove_attenuators;
+    otai_bulk_object_set_attribute_fn        set_attenuators_attribute;
+    otai_bulk_object_get_attribute_fn        get_attenuators_attribute;
+    otai_bulk_object_get_stats_fn            get_attenuators_stats;
 } otai_attenuator_api_t;
 
 /**
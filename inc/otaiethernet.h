@@ -1130,6 +1130,11 @@ typedef struct _otai_ethernet_api_t
     otai_get_ethernet_stats_fn             get_ethernet_stats;
     otai_get_ethernet_stats_ext_fn         get_ethernet_stats_ext;
     otai_clear_ethernet_stats_fn           clear_ethernet_stats;
+    otai_bulk_object_create_fn             create_ethernets;
+    otai_bulk_object_remove_fn             remove_ethernets;
+    otai_bulk_object_set_attribute_fn      set_ethernets_attribute;
+    otai_bulk_object_get_attribute_fn      get_ethernets_attribute;
+    otai_bulk_object_get_stats_fn          get_ethernets_stats;
 } otai_ethernet_api_t;
 
 /**
@@ -578,6 +578,11 @@ typedef struct _otai_interface_api_t
     otai_get_interface_stats_fn             get_interface_stats;
     otai_get_interface_stats_ext_fn         get_interface_stats_ext;
     otai_clear_interface_stats_fn           clear_interface_stats;
+    otai_bulk_object_create_fn              create_interfaces;
+    otai_bulk_object_remove_fn              remove_interfaces;
+    otai_bulk_object_set_attribute_fn       set_interfaces_attribute;
+    otai_bulk_object_get_attribute_fn       get_interfaces_attribute;
+    otai_bulk_object_get_stats_fn           get_interfaces_stats;
 } otai_interface_api_t;
 
 /**
@@ -107,6 +107,9 @@ typedef void (*otai_linecard_alarm_notification_fn)(
 /**
  * @brief Linecard OCM spectrum power notification
  *
+ * Spectrum list is owned by adapter and is valid only until notification
+ * returns, user copies it to keep it.
+ *
  * @param[in] linecard_id Linecard Id
  * @param[in] ocm_id OCM Id
  * @param[in] ocm_result OCM Result
@@ -774,6 +777,11 @@ typedef struct _otai_linecard_api_t
     otai_get_linecard_stats_fn         get_linecard_stats;
     otai_get_linecard_stats_ext_fn     get_linecard_stats_ext;
     otai_clear_linecard_stats_fn       clear_linecard_stats;
+    otai_bulk_object_create_fn         create_linecards;
+    otai_bulk_object_remove_fn         remove_linecards;
+    otai_bulk_object_set_attribute_fn  set_linecards_attribute;
+    otai_bulk_object_get_attribute_fn  get_linecards_attribute;
+    otai_bulk_object_get_stats_fn      get_linecards_stats;
 } otai_linecard_api_t;
 
 /**
@@ -327,6 +327,11 @@ typedef struct _otai_lldp_api_t
     otai_get_lldp_stats_fn             get_lldp_stats;
     otai_get_lldp_stats_ext_fn         get_lldp_stats_ext;
     otai_clear_lldp_stats_fn           clear_lldp_stats;
+    otai_bulk_object_create_fn         create_lldps;
+    otai_bulk_object_remove_fn         remove_lldps;
+    otai_bulk_object_set_attribute_fn  set_lldps_attribute;
+    otai_bulk_object_get_attribute_fn  get_lldps_attribute;
+    otai_bulk_object_get_stats_fn      get_lldps_stats;
 } otai_lldp_api_t;
 
 /**
@@ -437,6 +437,11 @@ typedef struct _otai_logicalchannel_api_t
     otai_get_logicalchannel_stats_fn       get_logicalchannel_stats;
     otai_get_logicalchannel_stats_ext_fn   get_logicalchannel_stats_ext;
     otai_clear_logicalchannel_stats_fn     clear_logicalchannel_stats;
+    otai_bulk_object_create_fn             create_logicalchannels;
+    otai_bulk_object_remove_fn             remove_logicalchannels;
+    otai_bulk_object_set_attribute_fn      set_logicalchannels_attribute;
+    otai_bulk_object_get_attribute_fn      get_logicalchannels_attribute;
+    otai_bulk_object_get_stats_fn          get_logicalchannels_stats;
 } otai_logicalchannel_api_t;
 
 /**
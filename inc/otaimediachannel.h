@@ -329,6 +329,11 @@ typedef struct _otai_mediachannel_api_t
     otai_get_mediachannel_stats_fn             get_mediachannel_stats;
     otai_get_mediachannel_stats_ext_fn         get_mediachannel_stats_ext;
     otai_clear_mediachannel_stats_fn           clear_mediachannel_stats;
+    otai_bulk_object_create_fn                 create_mediachannels;
+    otai_bulk_object_remove_fn                 remove_mediachannels;
+    otai_bulk_object_set_attribute_fn          set_mediachannels_attribute;
+    otai_bulk_object_get_attribute_fn          get_mediachannels_attribute;
+    otai_bulk_object_get_stats_fn              get_mediachannels_stats;
 } otai_mediachannel_api_t;
 
 /**
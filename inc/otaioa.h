@@ -775,6 +775,11 @@ typedef struct _otai_oa_api_t
     otai_get_oa_stats_fn             get_oa_stats;
     otai_get_oa_stats_ext_fn         get_oa_stats_ext;
     otai_clear_oa_stats_fn           clear_oa_stats;
+    otai_bulk_object_create_fn       create_oas;
+    otai_bulk_object_remove_fn       remove_oas;
+    otai_bulk_object_set_attribute_fn set_oas_attribute;
+    otai_bulk_object_get_attribute_fn get_oas_attribute;
+    otai_bulk_object_get_stats_fn    get_oas_stats;
 } otai_oa_api_t;
 
 /**
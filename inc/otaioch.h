@@ -391,6 +391,11 @@ typedef struct _otai_och_api_t
     otai_get_och_stats_fn           get_och_stats;
     otai_get_och_stats_ext_fn       get_och_stats_ext;
     otai_clear_och_stats_fn         clear_och_stats;
+    otai_bulk_object_create_fn      create_ochs;
+    otai_bulk_object_remove_fn      remove_ochs;
+    otai_bulk_object_set_attribute_fn set_ochs_attribute;
+    otai_bulk_object_get_attribute_fn get_ochs_attribute;
+    otai_bulk_object_get_stats_fn   get_ochs_stats;
 } otai_och_api_t;
 
 /**
@@ -304,6 +304,11 @@ typedef struct _otai_ocm_api_t
     otai_get_ocm_stats_fn             get_ocm_stats;
     otai_get_ocm_stats_ext_fn         get_ocm_stats_ext;
     otai_clear_ocm_stats_fn           clear_ocm_stats;
+    otai_bulk_object_create_fn        create_ocms;
+    otai_bulk_object_remove_fn        remove_ocms;
+    otai_bulk_object_set_attribute_fn set_ocms_attribute;
+    otai_bulk_object_get_attribute_fn get_ocms_attribute;
+    otai_bulk_object_get_stats_fn     get_ocms_stats;
 } otai_ocm_api_t;
 
 /**
@@ -458,6 +458,11 @@ typedef struct _otai_osc_api_t
     otai_get_osc_stats_fn             get_osc_stats;
     otai_get_osc_stats_ext_fn         get_osc_stats_ext;
     otai_clear_osc_stats_fn           clear_osc_stats;
+    otai_bulk_object_create_fn        create_oscs;
+    otai_bulk_object_remove_fn        remove_oscs;
+    otai_bulk_object_set_attribute_fn set_oscs_attribute;
+    otai_bulk_object_get_attribute_fn get_oscs_attribute;
+    otai_bulk_object_get_stats_fn     get_oscs_stats;
 } otai_osc_api_t;
 
 /**
@@ -432,6 +432,11 @@ typedef struct _otai_otdr_api_t
     otai_get_otdr_stats_fn             get_otdr_stats;
     otai_get_otdr_stats_ext_fn         get_otdr_stats_ext;
     otai_clear_otdr_stats_fn           clear_otdr_stats;
+    otai_bulk_object_create_fn         create_otdrs;
+    otai_bulk_object_remove_fn         remove_otdrs;
+    otai_bulk_object_set_attribute_fn  set_otdrs_attribute;
+    otai_bulk_object_get_attribute_fn  get_otdrs_attribute;
+    otai_bulk_object_get_stats_fn      get_otdrs_stats;
 } otai_otdr_api_t;
 
 /**
@@ -488,6 +488,11 @@ typedef struct _otai_otn_api_t
     otai_get_otn_stats_fn             get_otn_stats;
     otai_get_otn_stats_ext_fn         get_otn_stats_ext;
     otai_clear_otn_stats_fn           clear_otn_stats;
+    otai_bulk_object_create_fn        create_otns;
+    otai_bulk_object_remove_fn        remove_otns;
+    otai_bulk_object_set_attribute_fn set_otns_attribute;
+    otai_bulk_object_get_attribute_fn get_otns_attribute;
+    otai_bulk_object_get_stats_fn     get_otns_stats;
 } otai_otn_api_t;
 
 /**
@@ -253,6 +253,11 @@ typedef struct _otai_physicalchannel_api_t
     otai_get_physicalchannel_stats_fn           get_physicalchannel_stats;
     otai_get_physicalchannel_stats_ext_fn       get_physicalchannel_stats_ext;
     otai_clear_physicalchannel_stats_fn         clear_physicalchannel_stats;
+    otai_bulk_object_create_fn                  create_physicalchannels;
+    otai_bulk_object_remove_fn                  remove_physicalchannels;
+    otai_bulk_object_set_attribute_fn           set_physicalchannels_attribute;
+    otai_bulk_object_get_attribute_fn           get_physicalchannels_attribute;
+    otai_bulk_object_get_stats_fn               get_physicalchannels_stats;
 } otai_physicalchannel_api_t;
 
 /**
@@ -389,13 +389,18 @@ typedef otai_status_t (*otai_clear_port_stats_fn)(
  */
 typedef struct _otai_port_api_t
 {
-    otai_create_port_fn          create_port;
-    otai_remove_port_fn          remove_port;
-    otai_set_port_attribute_fn   set_port_attribute;
-    otai_get_port_attribute_fn   get_port_attribute;
-    otai_get_port_stats_fn       get_port_stats;
-    otai_get_port_stats_ext_fn   get_port_stats_ext;
-    otai_clear_port_stats_fn     clear_port_stats;
+    otai_create_port_fn               create_port;
+    otai_remove_port_fn               remove_port;
+    otai_set_port_attribute_fn        set_port_attribute;
+    otai_get_port_attribute_fn        get_port_attribute;
+    otai_get_port_stats_fn            get_port_stats;
+    otai_get_port_stats_ext_fn        get_port_stats_ext;
+    otai_clear_port_stats_fn          clear_port_stats;
+    otai_bulk_object_create_fn        create_ports;
+    otai_bulk_object_remove_fn        remove_ports;
+    otai_bulk_object_set_attribute_fn set_ports_attribute;
+    otai_bulk_object_get_attribute_fn get_ports_attribute;
+    otai_bulk_object_get_stats_fn     get_ports_stats;
 } otai_port_api_t;
 
 /**
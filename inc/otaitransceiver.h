@@ -1188,6 +1188,11 @@ typedef struct _otai_transceiver_api_t
     otai_get_transceiver_stats_fn             get_transceiver_stats;
     otai_get_transceiver_stats_ext_fn         get_transceiver_stats_ext;
     otai_clear_transceiver_stats_fn           clear_transceiver_stats;
+    otai_bulk_object_create_fn                create_transceivers;
+    otai_bulk_object_remove_fn                remove_transceivers;
+    otai_bulk_object_set_attribute_fn         set_transceivers_attribute;
+    otai_bulk_object_get_attribute_fn         get_transceivers_attribute;
+    otai_bulk_object_get_stats_fn             get_transceivers_stats;
 } otai_transceiver_api_t;
 
 /**
@@ -303,7 +303,7 @@ typedef enum _otai_bulk_op_error_mode_t
     /**
      * @brief Bulk operation error handling mode where operation stops on the first failed creation
      *
-     * Rest of objects will use OTAI_STATUS_NON_EXECUTED return status value.
+     * Rest of objects will use OTAI_STATUS_NOT_EXECUTED return status value.
      */
     OTAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR,
 
@@ -313,6 +313,100 @@ typedef enum _otai_bulk_op_error_mode_t
     OTAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
 } otai_bulk_op_error_mode_t;
 
+/**
+ * @brief Bulk objects creation.
+ *
+ * @param[in] linecard_id Linecard Object id
+ * @param[in] object_count Number of objects to create
+ * @param[in] attr_count List of attr_count. Caller passes the number
+ *    of attribute for each object to create.
+ * @param[in] attr_list List of attributes for every object.
+ * @param[in] mode Bulk operation error handling mode.
+ * @param[out] object_id List of object ids returned
+ * @param[out] object_statuses List of status for every object. Caller needs to
+ * allocate the buffer
+ *
+ * @return #OTAI_STATUS_SUCCESS on success when all objects are created or
+ * #OTAI_STATUS_FAILURE when any of the objects fails to create. When there is
+ * failure, Caller is expected to go through the list of returned statuses to
+ * find out which fails and which succeeds.
+ */
+typedef otai_status_t (*otai_bulk_object_create_fn)(
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t object_count,
+        _In_ const uint32_t *attr_count,
+        _In_ const otai_attribute_t **attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_object_id_t *object_id,
+        _Out_ otai_status_t *object_statuses);
+
+/**
+ * @brief Bulk objects removal.
+ *
+ * @param[in] object_count Number of objects to remove
+ * @param[in] object_id List of object ids
+ * @param[in] mode Bulk operation error handling mode.
+ * @param[out] object_statuses List of status for every object. Caller needs to
+ * allocate the buffer
+ *
+ * @return #OTAI_STATUS_SUCCESS on success when all objects are removed or
+ * #OTAI_STATUS_FAILURE when any of the objects fails to remove. When there is
+ * failure, Caller is expected to go through the list of returned statuses to
+ * find out which fails and which succeeds.
+ */
+typedef otai_status_t (*otai_bulk_object_remove_fn)(
+        _In_ uint32_t object_count,
+        _In_ const otai_object_id_t *object_id,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses);
+
+/**
+ * @brief Bulk objects set attributes.
+ *
+ * @param[in] object_count Number of objects to set attribute
+ * @param[in] object_id List of objects to set attribute
+ * @param[in] attr_list List of attributes to set on objects, one attribute per object
+ * @param[in] mode Bulk operation error handling mode.
+ * @param[out] object_statuses List of status for every object. Caller needs to
+ * allocate the buffer
+ *
+ * @return #OTAI_STATUS_SUCCESS on success when all objects are set or
+ * #OTAI_STATUS_FAILURE when any of the objects fails to set. When there is
+ * failure, Caller is expected to go through the list of returned statuses to
+ * find out which fails and which succeeds.
+ */
+typedef otai_status_t (*otai_bulk_object_set_attribute_fn)(
+        _In_ uint32_t object_count,
+        _In_ const otai_object_id_t *object_id,
+        _In_ const otai_attribute_t *attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses);
+
+/**
+ * @brief Bulk objects get attributes.
+ *
+ * @param[in] object_count Number of objects to get attribute
+ * @param[in] object_id List of objects to get attribute
+ * @param[in] attr_count List of attr_count. Caller passes the number
+ *    of attribute for each object to get
+ * @param[inout] attr_list List of attributes to get on objects
+ * @param[in] mode Bulk operation error handling mode
+ * @param[out] object_statuses List of status for every object. Caller needs to
+ * allocate the buffer
+ *
+ * @return #OTAI_STATUS_SUCCESS on success when all objects are get or
+ * #OTAI_STATUS_FAILURE when any of the objects fails to get. When there is
+ * failure, Caller is expected to go through the list of returned statuses to
+ * find out which fails and which succeeds.
+ */
+typedef otai_status_t (*otai_bulk_object_get_attribute_fn)(
+        _In_ uint32_t object_count,
+        _In_ const otai_object_id_t *object_id,
+        _In_ const uint32_t *attr_count,
+        _Inout_ otai_attribute_t **attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses);
+
 /**
  * @brief OTAI statistics modes
  *
@@ -334,6 +428,37 @@ typedef enum _otai_stats_mode_t
     OTAI_STATS_MODE_READ_AND_CLEAR = 1 << 1,
 } otai_stats_mode_t;
 
+/**
+ * @brief Bulk objects get statistics.
+ *
+ * Counters are returned as object_count x number_of_counters matrix in row
+ * major order, values for object object_id[i] start at
+ * counters[i * number_of_counters].
+ *
+ * @param[in] object_count Number of objects to get statistics
+ * @param[in] object_id List of objects to get statistics
+ * @param[in] number_of_counters Number of counters in the array
+ * @param[in] counter_ids Specifies the array of counter ids, shared by all objects
+ * @param[in] mode Statistics mode
+ * @param[out] object_statuses List of status for every object. Caller needs to
+ * allocate the buffer
+ * @param[out] counters Array of resulting counter values. Caller needs to
+ * allocate object_count * number_of_counters values
+ *
+ * @return #OTAI_STATUS_SUCCESS on success when statistics are read for all
+ * objects or #OTAI_STATUS_FAILURE when any of the objects fails. When there is
+ * failure, Caller is expected to go through the list of returned statuses to
+ * find out which fails and which succeeds.
+ */
+typedef otai_status_t (*otai_bulk_object_get_stats_fn)(
+        _In_ uint32_t object_count,
+        _In_ const otai_object_id_t *object_id,
+        _In_ uint32_t number_of_counters,
+        _In_ const otai_stat_id_t *counter_ids,
+        _In_ otai_stats_mode_t mode,
+        _Out_ otai_status_t *object_statuses,
+        _Out_ otai_stat_value_t *counters);
+
 /** @brief Operational status */
 typedef enum _otai_oper_status_t
 {
@@ -271,6 +271,11 @@ typedef struct _otai_wss_api_t
     otai_get_wss_stats_fn             get_wss_stats;
     otai_get_wss_stats_ext_fn         get_wss_stats_ext;
     otai_clear_wss_stats_fn           clear_wss_stats;
+    otai_bulk_object_create_fn        create_wsses;
+    otai_bulk_object_remove_fn        remove_wsses;
+    otai_bulk_object_set_attribute_fn set_wsses_attribute;
+    otai_bulk_object_get_attribute_fn get_wsses_attribute;
+    otai_bulk_object_get_stats_fn     get_wsses_stats;
 } otai_wss_api_t;
 
 /**
@@ -0,0 +1,828 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadataalarm.c
+ *
+ * @brief   This module implements OTAI Metadata alarm aggregator
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <otai.h>
+#include "otaimetadatalogger.h"
+#include "otaimetadataalarm.h"
+
+/*
+ * Number of notifications collected under table lock and delivered after
+ * lock is released.
+ */
+#define OTAI_METADATA_ALARM_BATCH 32
+
+typedef struct _otai_metadata_alarm_entry_t
+{
+    bool used;
+
+    /* there is something to report */
+    bool dirty;
+
+    /* severity or text changed without status change */
+    bool updated;
+
+    otai_object_id_t linecardid;
+
+    otai_object_id_t resourceoid;
+
+    otai_alarm_type_t alarmtype;
+
+    /* last status passed to user */
+    otai_alarm_status_t reported;
+
+    /* last status received from adapter */
+    otai_alarm_status_t current;
+
+    /* status changes since last report */
+    uint32_t transitions;
+
+    /* time of last status change */
+    uint64_t changed;
+
+    /* time of last report */
+    uint64_t delivered;
+
+    otai_alarm_severity_t severity;
+
+    uint64_t timecreated;
+
+    uint32_t textlength;
+
+    int8_t text[OTAI_METADATA_ALARM_MAX_TEXT];
+
+} otai_metadata_alarm_entry_t;
+
+typedef struct _otai_metadata_alarm_delivery_t
+{
+    otai_object_id_t linecardid;
+
+    otai_alarm_type_t alarmtype;
+
+    otai_alarm_info_t info;
+
+    int8_t text[OTAI_METADATA_ALARM_MAX_TEXT];
+
+    otai_linecard_alarm_notification_fn handler;
+
+} otai_metadata_alarm_delivery_t;
+
+typedef struct _otai_metadata_alarm_handler_t
+{
+    /* OTAI_NULL_OBJECT_ID for linecard which is being created */
+    otai_object_id_t linecardid;
+
+    otai_linecard_alarm_notification_fn handler;
+
+} otai_metadata_alarm_handler_t;
+
+typedef struct _otai_metadata_alarm_t
+{
+    bool started;
+
+    uint32_t mask;
+
+    uint32_t raisehold;
+
+    uint32_t clearhold;
+
+    uint32_t summaryinterval;
+
+    otai_metadata_alarm_clock_fn clock;
+
+    /* open addressing with linear probing */
+    otai_metadata_alarm_entry_t *entries;
+
+    otai_metadata_alarm_stats_t stats;
+
+    /* user callbacks, few linecards, so searched linearly */
+    otai_metadata_alarm_handler_t *handlers;
+
+    uint32_t handlercount;
+
+} otai_metadata_alarm_t;
+
+/*
+ * Notification callback has no user context, so aggregator is global. Table
+ * and handlers are protected by mutex, delivery mutex is held by poll for
+ * whole scan, so notifications of the same alarm are not reordered by
+ * concurrent polls.
+ */
+static otai_metadata_alarm_t otai_metadata_alarm_global;
+
+static pthread_mutex_t otai_metadata_alarm_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_mutex_t otai_metadata_alarm_delivery_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static otai_metadata_alarm_handler_t* otai_metadata_alarm_find_handler(
+        _In_ const otai_metadata_alarm_t *alarm,
+        _In_ otai_object_id_t linecard_id)
+{
+    uint32_t idx = 0;
+
+    for (; idx < alarm->handlercount; idx++)
+    {
+        if (alarm->handlers[idx].linecardid == linecard_id)
+        {
+            return &alarm->handlers[idx];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Linecard without own handler is notified during its create, so it gets
+ * handler of linecard which is being created.
+ */
+static otai_linecard_alarm_notification_fn otai_metadata_alarm_handler(
+        _In_ const otai_metadata_alarm_t *alarm,
+        _In_ otai_object_id_t linecard_id)
+{
+    const otai_metadata_alarm_handler_t *handler = otai_metadata_alarm_find_handler(alarm, linecard_id);
+
+    if (handler == NULL)
+    {
+        handler = otai_metadata_alarm_find_handler(alarm, OTAI_NULL_OBJECT_ID);
+    }
+
+    return (handler == NULL) ? NULL : handler->handler;
+}
+
+static void otai_metadata_alarm_unset_handler(
+        _Inout_ otai_metadata_alarm_t *alarm,
+        _In_ otai_metadata_alarm_handler_t *handler)
+{
+    *handler = alarm->handlers[--alarm->handlercount];
+
+    if (alarm->handlercount == 0)
+    {
+        free(alarm->handlers);
+
+        alarm->handlers = NULL;
+    }
+}
+
+static otai_status_t otai_metadata_alarm_set_handler(
+        _Inout_ otai_metadata_alarm_t *alarm,
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_linecard_alarm_notification_fn handler)
+{
+    otai_metadata_alarm_handler_t *entry = otai_metadata_alarm_find_handler(alarm, linecard_id);
+
+    if (entry == NULL)
+    {
+        otai_metadata_alarm_handler_t *handlers = realloc(alarm->handlers,
+                (alarm->handlercount + 1) * sizeof(otai_metadata_alarm_handler_t));
+
+        if (handlers == NULL)
+        {
+            return OTAI_STATUS_NO_MEMORY;
+        }
+
+        alarm->handlers = handlers;
+
+        entry = &handlers[alarm->handlercount++];
+
+        entry->linecardid = linecard_id;
+    }
+
+    entry->handler = handler;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static size_t otai_metadata_alarm_hash(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_object_id_t resource_oid,
+        _In_ otai_alarm_type_t alarm_type)
+{
+    uint64_t h = linecard_id * 31 + resource_oid;
+
+    h = h * 31 + (uint32_t)alarm_type;
+
+    return (size_t)((h * UINT64_C(0x9E3779B97F4A7C15)) >> 32);
+}
+
+static otai_metadata_alarm_entry_t* otai_metadata_alarm_find(
+        _In_ const otai_metadata_alarm_t *alarm,
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_object_id_t resource_oid,
+        _In_ otai_alarm_type_t alarm_type,
+        _In_ bool insert)
+{
+    size_t idx = otai_metadata_alarm_hash(linecard_id, resource_oid, alarm_type) & alarm->mask;
+
+    size_t probe = 0;
+
+    for (; probe <= alarm->mask; probe++, idx = (idx + 1) & alarm->mask)
+    {
+        otai_metadata_alarm_entry_t *entry = &alarm->entries[idx];
+
+        if (!entry->used)
+        {
+            if (!insert)
+            {
+                return NULL;
+            }
+
+            memset(entry, 0, sizeof(otai_metadata_alarm_entry_t));
+
+            entry->used = true;
+            entry->linecardid = linecard_id;
+            entry->resourceoid = resource_oid;
+            entry->alarmtype = alarm_type;
+            entry->reported = OTAI_ALARM_STATUS_INACTIVE;
+            entry->current = OTAI_ALARM_STATUS_INACTIVE;
+
+            return entry;
+        }
+
+        if (entry->linecardid == linecard_id && entry->resourceoid == resource_oid && entry->alarmtype == alarm_type)
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Backward shift deletion, entries after removed one are moved back, so
+ * there are no tombstones.
+ */
+static void otai_metadata_alarm_remove(
+        _Inout_ otai_metadata_alarm_t *alarm,
+        _In_ size_t index)
+{
+    size_t hole = index;
+
+    size_t idx = (index + 1) & alarm->mask;
+
+    alarm->entries[hole].used = false;
+
+    while (alarm->entries[idx].used)
+    {
+        otai_metadata_alarm_entry_t *entry = &alarm->entries[idx];
+
+        size_t home = otai_metadata_alarm_hash(entry->linecardid, entry->resourceoid, entry->alarmtype) & alarm->mask;
+
+        /* entry can move to hole only if hole is between its home and idx */
+
+        if (((idx - home) & alarm->mask) >= ((idx - hole) & alarm->mask))
+        {
+            alarm->entries[hole] = *entry;
+
+            entry->used = false;
+
+            hole = idx;
+        }
+
+        idx = (idx + 1) & alarm->mask;
+    }
+}
+
+static void otai_metadata_alarm_fill(
+        _In_ const otai_metadata_alarm_entry_t *entry,
+        _In_ otai_alarm_status_t status,
+        _Out_ otai_metadata_alarm_delivery_t *delivery)
+{
+    memcpy(delivery->text, entry->text, entry->textlength);
+
+    delivery->linecardid = entry->linecardid;
+    delivery->alarmtype = entry->alarmtype;
+    delivery->info.status = status;
+    delivery->info.time_created = entry->timecreated;
+    delivery->info.text.count = entry->textlength;
+    delivery->info.text.list = delivery->text;
+    delivery->info.resource_oid = entry->resourceoid;
+    delivery->info.severity = entry->severity;
+}
+
+/*
+ * Returns true if entry has notification to deliver now. If force is set,
+ * hold times are not waited.
+ */
+static bool otai_metadata_alarm_collect(
+        _Inout_ otai_metadata_alarm_t *alarm,
+        _Inout_ otai_metadata_alarm_entry_t *entry,
+        _In_ uint64_t now,
+        _In_ bool force,
+        _Out_ otai_metadata_alarm_delivery_t *delivery)
+{
+    uint32_t hold = (entry->current == OTAI_ALARM_STATUS_ACTIVE) ? alarm->raisehold : alarm->clearhold;
+
+    otai_alarm_status_t status;
+
+    if (force || now - entry->changed >= hold)
+    {
+        if (entry->current != entry->reported)
+        {
+            status = entry->current;
+
+            if (status == OTAI_ALARM_STATUS_ACTIVE)
+            {
+                alarm->stats.active++;
+            }
+            else
+            {
+                alarm->stats.active--;
+            }
+
+            entry->reported = status;
+        }
+        else if (entry->transitions != 0)
+        {
+            status = OTAI_ALARM_STATUS_TRANSIENT;
+        }
+        else if (entry->updated)
+        {
+            status = entry->current;
+        }
+        else
+        {
+            entry->dirty = false;
+
+            return false;
+        }
+
+        entry->dirty = false;
+        entry->updated = false;
+    }
+    else if (entry->transitions != 0 && alarm->summaryinterval != 0 &&
+            now - entry->delivered >= alarm->summaryinterval)
+    {
+        /* alarm keeps flapping, final status is reported when it settles */
+
+        status = OTAI_ALARM_STATUS_TRANSIENT;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (status == OTAI_ALARM_STATUS_TRANSIENT)
+    {
+        alarm->stats.transient++;
+    }
+
+    entry->transitions = 0;
+    entry->delivered = now;
+
+    alarm->stats.delivered++;
+
+    otai_metadata_alarm_fill(entry, status, delivery);
+
+    return true;
+}
+
+static void otai_metadata_alarm_deliver(
+        _In_ const otai_metadata_alarm_delivery_t *deliveries,
+        _In_ size_t count)
+{
+    size_t idx = 0;
+
+    for (; idx < count; idx++)
+    {
+        if (deliveries[idx].handler != NULL)
+        {
+            deliveries[idx].handler(deliveries[idx].linecardid, deliveries[idx].alarmtype, deliveries[idx].info);
+        }
+    }
+}
+
+static void otai_metadata_alarm_flush(
+        _In_ uint64_t now,
+        _In_ bool force)
+{
+    otai_metadata_alarm_t *alarm = &otai_metadata_alarm_global;
+
+    otai_metadata_alarm_delivery_t deliveries[OTAI_METADATA_ALARM_BATCH];
+
+    pthread_mutex_lock(&otai_metadata_alarm_delivery_mutex);
+
+    size_t idx = 0;
+
+    bool done = false;
+
+    while (!done)
+    {
+        size_t count = 0;
+
+        pthread_mutex_lock(&otai_metadata_alarm_mutex);
+
+        /*
+         * Only this function removes entries and it holds delivery mutex,
+         * so index is still valid after table lock was released.
+         */
+
+        while (alarm->entries != NULL && idx <= alarm->mask && count < OTAI_METADATA_ALARM_BATCH)
+        {
+            otai_metadata_alarm_entry_t *entry = &alarm->entries[idx];
+
+            if (!entry->used || !entry->dirty ||
+                    !otai_metadata_alarm_collect(alarm, entry, now, force, &deliveries[count]))
+            {
+                idx++;
+
+                continue;
+            }
+
+            deliveries[count++].handler = otai_metadata_alarm_handler(alarm, entry->linecardid);
+
+            if (!entry->dirty && entry->reported == OTAI_ALARM_STATUS_INACTIVE)
+            {
+                /* next entry can be moved to this index, so it is checked again */
+
+                otai_metadata_alarm_remove(alarm, idx);
+
+                alarm->stats.entries--;
+
+                continue;
+            }
+
+            idx++;
+        }
+
+        done = (alarm->entries == NULL || idx > alarm->mask);
+
+        pthread_mutex_unlock(&otai_metadata_alarm_mutex);
+
+        otai_metadata_alarm_deliver(deliveries, count);
+    }
+
+    pthread_mutex_unlock(&otai_metadata_alarm_delivery_mutex);
+}
+
+static void otai_metadata_alarm_update(
+        _Inout_ otai_metadata_alarm_entry_t *entry,
+        _In_ uint64_t now,
+        _In_ const otai_alarm_info_t *alarm_info,
+        _In_ bool created)
+{
+    bool changed = created || entry->severity != alarm_info->severity;
+
+    entry->severity = alarm_info->severity;
+    entry->timecreated = alarm_info->time_created;
+    entry->textlength = 0;
+
+    if (alarm_info->text.list != NULL)
+    {
+        entry->textlength = (alarm_info->text.count < OTAI_METADATA_ALARM_MAX_TEXT) ?
+            alarm_info->text.count : OTAI_METADATA_ALARM_MAX_TEXT;
+
+        memcpy(entry->text, alarm_info->text.list, entry->textlength);
+    }
+
+    if (alarm_info->status == OTAI_ALARM_STATUS_TRANSIENT)
+    {
+        entry->transitions++;
+        entry->dirty = true;
+    }
+    else if (alarm_info->status != entry->current)
+    {
+        entry->current = alarm_info->status;
+        entry->changed = now;
+        entry->transitions++;
+        entry->dirty = true;
+    }
+    else if (changed)
+    {
+        /*
+         * Clear of unknown alarm is passed too, user may know it from
+         * before aggregator was started.
+         */
+
+        entry->updated = true;
+        entry->dirty = true;
+    }
+}
+
+void otai_metadata_alarm_process(
+        _In_ uint64_t now,
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_alarm_type_t alarm_type,
+        _In_ const otai_alarm_info_t *alarm_info)
+{
+    otai_metadata_alarm_t *alarm = &otai_metadata_alarm_global;
+
+    pthread_mutex_lock(&otai_metadata_alarm_mutex);
+
+    otai_linecard_alarm_notification_fn handler = otai_metadata_alarm_handler(alarm, linecard_id);
+
+    otai_metadata_alarm_entry_t *entry = NULL;
+
+    bool valid = (alarm_info->status == OTAI_ALARM_STATUS_ACTIVE ||
+            alarm_info->status == OTAI_ALARM_STATUS_INACTIVE ||
+            alarm_info->status == OTAI_ALARM_STATUS_TRANSIENT);
+
+    if (alarm->started && valid)
+    {
+        alarm->stats.received++;
+
+        entry = otai_metadata_alarm_find(alarm, linecard_id, alarm_info->resource_oid, alarm_type, false);
+
+        bool created = (entry == NULL);
+
+        if (created)
+        {
+            entry = otai_metadata_alarm_find(alarm, linecard_id, alarm_info->resource_oid, alarm_type, true);
+        }
+
+        if (entry == NULL)
+        {
+            alarm->stats.overflow++;
+            alarm->stats.delivered++;
+        }
+        else
+        {
+            if (created)
+            {
+                alarm->stats.entries++;
+
+                entry->changed = now;
+                entry->delivered = now;
+            }
+
+            otai_metadata_alarm_update(entry, now, alarm_info, created);
+        }
+    }
+
+    bool direct = (!alarm->started || !valid || entry == NULL);
+
+    pthread_mutex_unlock(&otai_metadata_alarm_mutex);
+
+    if (direct && handler != NULL)
+    {
+        handler(linecard_id, alarm_type, *alarm_info);
+    }
+}
+
+static void otai_metadata_alarm_on_linecard_alarm(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_alarm_type_t alarm_type,
+        _In_ otai_alarm_info_t alarm_info)
+{
+    otai_metadata_alarm_clock_fn clock = __atomic_load_n(&otai_metadata_alarm_global.clock, __ATOMIC_SEQ_CST);
+
+    otai_metadata_alarm_process((clock == NULL) ? 0 : clock(), linecard_id, alarm_type, &alarm_info);
+}
+
+void otai_metadata_alarm_poll(
+        _In_ uint64_t now)
+{
+    otai_metadata_alarm_flush(now, false);
+}
+
+otai_status_t otai_metadata_alarm_start(
+        _In_ const otai_metadata_alarm_config_t *config)
+{
+    otai_metadata_alarm_t *alarm = &otai_metadata_alarm_global;
+
+    if (config == NULL || config->clock == NULL)
+    {
+        OTAI_META_LOG_ERROR("config or clock is NULL");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (config->capacity < 2 || (config->capacity & (config->capacity - 1)) != 0)
+    {
+        OTAI_META_LOG_ERROR("capacity %u is not power of 2", config->capacity);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    otai_metadata_alarm_entry_t *entries = calloc(config->capacity, sizeof(otai_metadata_alarm_entry_t));
+
+    if (entries == NULL)
+    {
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    pthread_mutex_lock(&otai_metadata_alarm_mutex);
+
+    if (alarm->started)
+    {
+        pthread_mutex_unlock(&otai_metadata_alarm_mutex);
+
+        free(entries);
+
+        OTAI_META_LOG_ERROR("alarm aggregator is already started");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    memset(&alarm->stats, 0, sizeof(otai_metadata_alarm_stats_t));
+
+    alarm->mask = config->capacity - 1;
+    alarm->raisehold = config->raisehold;
+    alarm->clearhold = config->clearhold;
+    alarm->summaryinterval = config->summaryinterval;
+    alarm->entries = entries;
+    alarm->started = true;
+
+    __atomic_store_n(&alarm->clock, config->clock, __ATOMIC_SEQ_CST);
+
+    pthread_mutex_unlock(&otai_metadata_alarm_mutex);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+void otai_metadata_alarm_stop(void)
+{
+    otai_metadata_alarm_t *alarm = &otai_metadata_alarm_global;
+
+    pthread_mutex_lock(&otai_metadata_alarm_mutex);
+
+    bool started = alarm->started;
+
+    /* new notifications are delivered directly from now */
+
+    alarm->started = false;
+
+    pthread_mutex_unlock(&otai_metadata_alarm_mutex);
+
+    if (!started)
+    {
+        return;
+    }
+
+    otai_metadata_alarm_flush(alarm->clock(), true);
+
+    pthread_mutex_lock(&otai_metadata_alarm_delivery_mutex);
+    pthread_mutex_lock(&otai_metadata_alarm_mutex);
+
+    free(alarm->entries);
+
+    alarm->entries = NULL;
+
+    pthread_mutex_unlock(&otai_metadata_alarm_mutex);
+    pthread_mutex_unlock(&otai_metadata_alarm_delivery_mutex);
+}
+
+otai_status_t otai_metadata_alarm_wrap_attr_list(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t attr_count,
+        _Inout_ otai_attribute_t *attr_list)
+{
+    otai_metadata_alarm_t *alarm = &otai_metadata_alarm_global;
+
+    if (attr_count != 0 && attr_list == NULL)
+    {
+        OTAI_META_LOG_ERROR("attribute list is NULL");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (object_type != OTAI_OBJECT_TYPE_LINECARD)
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < attr_count; idx++)
+    {
+        otai_attribute_t *attr = &attr_list[idx];
+
+        otai_pointer_t ptr = attr->value.ptr;
+
+        if (attr->id != OTAI_LINECARD_ATTR_LINECARD_ALARM_NOTIFY || ptr == NULL ||
+                ptr == (otai_pointer_t)otai_metadata_alarm_on_linecard_alarm)
+        {
+            continue;
+        }
+
+        pthread_mutex_lock(&otai_metadata_alarm_mutex);
+
+        otai_status_t status = otai_metadata_alarm_set_handler(alarm, linecard_id, (otai_linecard_alarm_notification_fn)ptr);
+
+        pthread_mutex_unlock(&otai_metadata_alarm_mutex);
+
+        if (status != OTAI_STATUS_SUCCESS)
+        {
+            OTAI_META_LOG_ERROR("failed to keep alarm handler");
+
+            return status;
+        }
+
+        attr->value.ptr = (otai_pointer_t)otai_metadata_alarm_on_linecard_alarm;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_alarm_bind_linecard(
+        _In_ otai_object_id_t linecard_id)
+{
+    otai_metadata_alarm_t *alarm = &otai_metadata_alarm_global;
+
+    if (linecard_id == OTAI_NULL_OBJECT_ID)
+    {
+        OTAI_META_LOG_ERROR("linecard id is NULL");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_lock(&otai_metadata_alarm_mutex);
+
+    otai_metadata_alarm_handler_t *created = otai_metadata_alarm_find_handler(alarm, OTAI_NULL_OBJECT_ID);
+
+    if (created != NULL)
+    {
+        /* linecard id can be reused without remove of old linecard */
+
+        otai_metadata_alarm_handler_t *old = otai_metadata_alarm_find_handler(alarm, linecard_id);
+
+        if (old != NULL)
+        {
+            old->handler = created->handler;
+
+            otai_metadata_alarm_unset_handler(alarm, created);
+        }
+        else
+        {
+            created->linecardid = linecard_id;
+        }
+    }
+
+    pthread_mutex_unlock(&otai_metadata_alarm_mutex);
+
+    return (created == NULL) ? OTAI_STATUS_ITEM_NOT_FOUND : OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_alarm_remove_linecard(
+        _In_ otai_object_id_t linecard_id)
+{
+    otai_metadata_alarm_t *alarm = &otai_metadata_alarm_global;
+
+    pthread_mutex_lock(&otai_metadata_alarm_mutex);
+
+    otai_metadata_alarm_handler_t *handler = otai_metadata_alarm_find_handler(alarm, linecard_id);
+
+    if (handler != NULL)
+    {
+        otai_metadata_alarm_unset_handler(alarm, handler);
+    }
+
+    pthread_mutex_unlock(&otai_metadata_alarm_mutex);
+
+    return (handler == NULL) ? OTAI_STATUS_ITEM_NOT_FOUND : OTAI_STATUS_SUCCESS;
+}
+
+bool otai_metadata_alarm_is_active(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_object_id_t resource_oid,
+        _In_ otai_alarm_type_t alarm_type)
+{
+    otai_metadata_alarm_t *alarm = &otai_metadata_alarm_global;
+
+    pthread_mutex_lock(&otai_metadata_alarm_mutex);
+
+    const otai_metadata_alarm_entry_t *entry = (alarm->entries == NULL) ? NULL :
+        otai_metadata_alarm_find(alarm, linecard_id, resource_oid, alarm_type, false);
+
+    bool active = (entry != NULL && entry->reported == OTAI_ALARM_STATUS_ACTIVE);
+
+    pthread_mutex_unlock(&otai_metadata_alarm_mutex);
+
+    return active;
+}
+
+otai_status_t otai_metadata_alarm_get_stats(
+        _Out_ otai_metadata_alarm_stats_t *stats)
+{
+    otai_metadata_alarm_t *alarm = &otai_metadata_alarm_global;
+
+    pthread_mutex_lock(&otai_metadata_alarm_mutex);
+
+    bool started = alarm->started;
+
+    *stats = alarm->stats;
+
+    pthread_mutex_unlock(&otai_metadata_alarm_mutex);
+
+    return started ? OTAI_STATUS_SUCCESS : OTAI_STATUS_UNINITIALIZED;
+}
@@ -0,0 +1,266 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadataalarm.h
+ *
+ * @brief   This module defines OTAI Metadata alarm aggregator
+ */
+
+#ifndef __OTAIMETADATAALARM_H_
+#define __OTAIMETADATAALARM_H_
+
+#include "otaimetadatatypes.h"
+
+/**
+ * @defgroup OTAIMETADATAALARM OTAI - Metadata alarm aggregator
+ *
+ * Aggregator sits between adapter and user linecard alarm notification and
+ * keeps table of alarms keyed on linecard, resource and alarm type.
+ *
+ * Alarm status change is reported only after new status was stable for
+ * raise or clear hold time. Alarm which changed status and returned back
+ * within hold time is reported once as #OTAI_ALARM_STATUS_TRANSIENT, and
+ * alarm which keeps flapping is reported as transient at most once per
+ * summary interval. Repeated notifications with the same status and
+ * severity are dropped. Last status of each alarm is always reported.
+ *
+ * Attribute list is passed to otai_metadata_alarm_wrap_attr_list() before
+ * linecard create. When wrapped list is then created through
+ * otai_metadata_dispatcher_create_linecard(), aggregator is after dispatcher
+ * ring, so it runs on dispatcher thread.
+ *
+ * User callback is kept per linecard, created linecard is bound to callback
+ * of its attribute list by otai_metadata_alarm_bind_linecard(), so each
+ * linecard's alarms are delivered to its own callback.
+ *
+ * Delayed notifications are delivered by otai_metadata_alarm_poll(), which
+ * user calls periodically, on calling thread.
+ *
+ * @{
+ */
+
+/**
+ * @def OTAI_METADATA_ALARM_MAX_TEXT
+ *
+ * Maximum length of alarm text kept in alarm table, longer text is
+ * truncated.
+ */
+#define OTAI_METADATA_ALARM_MAX_TEXT 128
+
+/**
+ * @brief Get current time.
+ *
+ * @return Monotonic time in milliseconds
+ */
+typedef uint64_t (*otai_metadata_alarm_clock_fn)(void);
+
+/**
+ * @brief Alarm aggregator configuration.
+ */
+typedef struct _otai_metadata_alarm_config_t
+{
+    /**
+     * @brief Number of alarms in alarm table, power of 2.
+     *
+     * Alarms which don't fit are delivered without aggregation.
+     */
+    otai_uint32_t                                capacity;
+
+    /**
+     * @brief Time in milliseconds alarm must be active before it is reported.
+     */
+    otai_uint32_t                                raisehold;
+
+    /**
+     * @brief Time in milliseconds alarm must be inactive before it is reported.
+     */
+    otai_uint32_t                                clearhold;
+
+    /**
+     * @brief Minimal time in milliseconds between transient reports of
+     * flapping alarm, 0 to report transient only when alarm settles.
+     */
+    otai_uint32_t                                summaryinterval;
+
+    /**
+     * @brief Clock used for notifications from adapter.
+     */
+    const otai_metadata_alarm_clock_fn           clock;
+
+} otai_metadata_alarm_config_t;
+
+/**
+ * @brief Alarm aggregator counters.
+ */
+typedef struct _otai_metadata_alarm_stats_t
+{
+    /**
+     * @brief Number of alarm notifications from adapter.
+     */
+    otai_uint64_t                                received;
+
+    /**
+     * @brief Number of alarm notifications passed to user callback.
+     */
+    otai_uint64_t                                delivered;
+
+    /**
+     * @brief Number of delivered transient notifications.
+     */
+    otai_uint64_t                                transient;
+
+    /**
+     * @brief Number of notifications delivered without aggregation, since
+     * alarm table was full.
+     */
+    otai_uint64_t                                overflow;
+
+    /**
+     * @brief Number of alarms in alarm table.
+     */
+    otai_uint64_t                                entries;
+
+    /**
+     * @brief Number of alarms reported as active.
+     */
+    otai_uint64_t                                active;
+
+} otai_metadata_alarm_stats_t;
+
+/**
+ * @brief Start alarm aggregator
+ *
+ * Until aggregator is started, or after it is stopped, wrapped callback
+ * calls user callback directly.
+ *
+ * @param[in] config Aggregator configuration
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if configuration is invalid or aggregator is already started,
+ * #OTAI_STATUS_NO_MEMORY if alarm table can't be allocated
+ */
+extern otai_status_t otai_metadata_alarm_start(
+        _In_ const otai_metadata_alarm_config_t *config);
+
+/**
+ * @brief Stop alarm aggregator
+ *
+ * Pending alarm status changes are delivered before alarm table is
+ * released.
+ */
+extern void otai_metadata_alarm_stop(void);
+
+/**
+ * @brief Replace alarm notification callback with aggregator callback
+ *
+ * Replaced callback is kept for linecard_id. List of linecard create is
+ * wrapped with #OTAI_NULL_OBJECT_ID, its callback gets alarms of linecards
+ * without own callback until otai_metadata_alarm_bind_linecard() is called
+ * with created linecard id, so only one linecard can be created at a time.
+ *
+ * @param[in] object_type Object type of attributes
+ * @param[in] linecard_id Linecard Id for set, #OTAI_NULL_OBJECT_ID for create
+ * @param[in] attr_count Number of attributes
+ * @param[inout] attr_list Attribute list, passed later to create or set API
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, failure status code on error
+ */
+extern otai_status_t otai_metadata_alarm_wrap_attr_list(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t attr_count,
+        _Inout_ otai_attribute_t *attr_list);
+
+/**
+ * @brief Bind callback of created linecard to its id
+ *
+ * Called after create of linecard whose list was wrapped with
+ * #OTAI_NULL_OBJECT_ID.
+ *
+ * @param[in] linecard_id Created linecard Id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * no create list was wrapped
+ */
+extern otai_status_t otai_metadata_alarm_bind_linecard(
+        _In_ otai_object_id_t linecard_id);
+
+/**
+ * @brief Forget callback of removed linecard
+ *
+ * Alarms of linecard which are still in alarm table are dropped on
+ * delivery, unless callback for create is wrapped.
+ *
+ * @param[in] linecard_id Linecard Id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * linecard has no callback
+ */
+extern otai_status_t otai_metadata_alarm_remove_linecard(
+        _In_ otai_object_id_t linecard_id);
+
+/**
+ * @brief Pass alarm notification to aggregator
+ *
+ * Wrapped callback calls this with time from configured clock.
+ *
+ * @param[in] now Current time in milliseconds
+ * @param[in] linecard_id Linecard Id
+ * @param[in] alarm_type Alarm type
+ * @param[in] alarm_info Alarm info
+ */
+extern void otai_metadata_alarm_process(
+        _In_ uint64_t now,
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_alarm_type_t alarm_type,
+        _In_ const otai_alarm_info_t *alarm_info);
+
+/**
+ * @brief Deliver alarms which are due
+ *
+ * @param[in] now Current time in milliseconds
+ */
+extern void otai_metadata_alarm_poll(
+        _In_ uint64_t now);
+
+/**
+ * @brief Check if alarm is reported as active
+ *
+ * @param[in] linecard_id Linecard Id
+ * @param[in] resource_oid Resource object id
+ * @param[in] alarm_type Alarm type
+ *
+ * @return True if last reported status of alarm is active
+ */
+extern bool otai_metadata_alarm_is_active(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_object_id_t resource_oid,
+        _In_ otai_alarm_type_t alarm_type);
+
+/**
+ * @brief Get alarm aggregator counters
+ *
+ * @param[out] stats Counters
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_UNINITIALIZED if
+ * aggregator is not started
+ */
+extern otai_status_t otai_metadata_alarm_get_stats(
+        _Out_ otai_metadata_alarm_stats_t *stats);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATAALARM_H_ */
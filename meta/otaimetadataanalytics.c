@@ -0,0 +1,477 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadataanalytics.c
+ *
+ * @brief   This module implements OTAI Metadata spectrum analytics
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <inttypes.h>
+#include <otai.h>
+#include "otaimetadatautils.h"
+#include "otaimetadatalogger.h"
+#include "otaimetadataanalytics.h"
+
+#define ANALYTICS_LOG2_10_BY_10     0.33219280948873623479
+#define ANALYTICS_LN2               0.69314718055994530942
+#define ANALYTICS_SQRT2             1.41421356237309504880
+#define ANALYTICS_10_BY_LN10        4.34294481903251827651
+#define ANALYTICS_MAX_DBM           1000.0
+
+/*
+ * Sum keeps 4 independent lanes, so compiler can map them to vector
+ * registers without reordering floating point operations.
+ */
+#define ANALYTICS_LANES 4
+
+static double otai_metadata_analytics_exp10(
+        _In_ double dbm)
+{
+    /*
+     * 10^(dbm/10) = 2^y = 2^n * 2^f, with n nearest integer to y, so f is
+     * in [-0.5, 0.5] and short Taylor series of e^(f ln2) is enough. Power
+     * must be within ANALYTICS_MAX_DBM, there is no clamping here since it
+     * would stop vectorization.
+     */
+
+    double y = dbm * ANALYTICS_LOG2_10_BY_10;
+
+    int32_t n = (int32_t)(y + 1022.5) - 1022;
+
+    double t = (y - (double)n) * ANALYTICS_LN2;
+
+    double p = 1.0 + t * (1.0 + t * (1.0 / 2 + t * (1.0 / 6 + t * (1.0 / 24 + t * (1.0 / 120 +
+                        t * (1.0 / 720 + t * (1.0 / 5040 + t * (1.0 / 40320))))))));
+
+    uint64_t bits = (uint64_t)(int64_t)(n + 1023) << 52;
+
+    double scale;
+
+    memcpy(&scale, &bits, sizeof(scale));
+
+    return p * scale;
+}
+
+double otai_metadata_analytics_db_to_linear(
+        _In_ double dbm)
+{
+    if (!(dbm >= -ANALYTICS_MAX_DBM))
+    {
+        return 0;
+    }
+
+    if (dbm > ANALYTICS_MAX_DBM)
+    {
+        return HUGE_VAL;
+    }
+
+    return otai_metadata_analytics_exp10(dbm);
+}
+
+double otai_metadata_analytics_linear_to_db(
+        _In_ double mw)
+{
+    if (!(mw > 0))
+    {
+        return -HUGE_VAL;
+    }
+
+    int32_t e = 0;
+
+    if (mw < 1e-300)
+    {
+        /* subnormal, bring it to normal range */
+
+        mw *= 18446744073709551616.0;
+        e = -64;
+    }
+
+    uint64_t bits;
+
+    memcpy(&bits, &mw, sizeof(bits));
+
+    e += (int32_t)((bits >> 52) & 0x7ff) - 1023;
+
+    bits = (bits & 0xfffffffffffffULL) | ((uint64_t)1023 << 52);
+
+    double m;
+
+    memcpy(&m, &bits, sizeof(m));
+
+    if (m > ANALYTICS_SQRT2)
+    {
+        m /= 2;
+        e++;
+    }
+
+    /* ln(m) = 2 atanh(s), with |s| below 0.18 */
+
+    double s = (m - 1) / (m + 1);
+    double s2 = s * s;
+
+    double ln = 2 * s * (1.0 + s2 * (1.0 / 3 + s2 * (1.0 / 5 + s2 * (1.0 / 7 + s2 * (1.0 / 9 + s2 / 11)))));
+
+    return (ln + (double)e * ANALYTICS_LN2) * ANALYTICS_10_BY_LN10;
+}
+
+static void otai_metadata_analytics_convert(
+        _In_ const otai_spectrum_power_t *__restrict list,
+        _In_ size_t count,
+        _Out_ double *__restrict linear)
+{
+    size_t idx;
+
+    for (idx = 0; idx < count; idx++)
+    {
+        linear[idx] = otai_metadata_analytics_exp10(list[idx].power);
+    }
+}
+
+/*
+ * Powers in mW are not negative, and bits of non-negative doubles are
+ * ordered as integers, so max and min are integer reductions, which
+ * vectorize without reordering floating point operations.
+ */
+
+static void otai_metadata_analytics_kernel(
+        _In_ const double *__restrict linear,
+        _In_ size_t count,
+        _Out_ double *sum,
+        _Out_ double *max,
+        _Out_ double *min)
+{
+    double lane[ANALYTICS_LANES] = { 0, 0, 0, 0 };
+
+    int64_t maxbits = 0;
+    int64_t minbits = INT64_MAX;
+
+    size_t idx = 0;
+
+    for (; idx + ANALYTICS_LANES <= count; idx += ANALYTICS_LANES)
+    {
+        lane[0] += linear[idx];
+        lane[1] += linear[idx + 1];
+        lane[2] += linear[idx + 2];
+        lane[3] += linear[idx + 3];
+    }
+
+    for (; idx < count; idx++)
+    {
+        lane[0] += linear[idx];
+    }
+
+    for (idx = 0; idx < count; idx++)
+    {
+        int64_t bits;
+
+        memcpy(&bits, &linear[idx], sizeof(bits));
+
+        maxbits = bits > maxbits ? bits : maxbits;
+        minbits = bits < minbits ? bits : minbits;
+    }
+
+    *sum = (lane[0] + lane[1]) + (lane[2] + lane[3]);
+
+    memcpy(max, &maxbits, sizeof(double));
+    memcpy(min, &minbits, sizeof(double));
+}
+
+static uint64_t otai_metadata_analytics_start(
+        _In_ const otai_spectrum_power_t *entry,
+        _In_ uint64_t width)
+{
+    if (entry->upper_frequency > entry->lower_frequency)
+    {
+        return entry->lower_frequency;
+    }
+
+    return entry->lower_frequency - (width / 2 < entry->lower_frequency ? width / 2 : entry->lower_frequency);
+}
+
+static uint64_t otai_metadata_analytics_end(
+        _In_ const otai_spectrum_power_t *entry,
+        _In_ uint64_t width)
+{
+    if (entry->upper_frequency > entry->lower_frequency)
+    {
+        return entry->upper_frequency;
+    }
+
+    return otai_metadata_analytics_start(entry, width) + width;
+}
+
+static double otai_metadata_analytics_weight(
+        _In_ const otai_spectrum_power_t *entry,
+        _In_ uint64_t width,
+        _In_ const otai_metadata_analytics_channel_t *channel)
+{
+    uint64_t start = otai_metadata_analytics_start(entry, width);
+    uint64_t end = otai_metadata_analytics_end(entry, width);
+
+    uint64_t lower = start > channel->lowerfrequency ? start : channel->lowerfrequency;
+    uint64_t upper = end < channel->upperfrequency ? end : channel->upperfrequency;
+
+    if (upper <= lower)
+    {
+        return 0;
+    }
+
+    return (double)(upper - lower) / (double)(end - start);
+}
+
+otai_status_t otai_metadata_analytics_init(
+        _Out_ otai_metadata_analytics_t *analytics,
+        _In_ uint32_t count)
+{
+    memset(analytics, 0, sizeof(otai_metadata_analytics_t));
+
+    if (count == 0)
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    analytics->linear = calloc(count, sizeof(double));
+
+    if (analytics->linear == NULL)
+    {
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    analytics->capacity = count;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+void otai_metadata_analytics_destroy(
+        _Inout_ otai_metadata_analytics_t *analytics)
+{
+    free(analytics->linear);
+
+    memset(analytics, 0, sizeof(otai_metadata_analytics_t));
+}
+
+static otai_status_t otai_metadata_analytics_validate(
+        _In_ const otai_spectrum_power_list_t *spectrum,
+        _In_ uint32_t count,
+        _In_ const otai_metadata_analytics_channel_t *channels)
+{
+    uint32_t idx;
+
+    if (spectrum->count != 0 && spectrum->list == NULL)
+    {
+        OTAI_META_LOG_ERROR("spectrum list is NULL");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (count != 0 && channels == NULL)
+    {
+        OTAI_META_LOG_ERROR("channels are NULL");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    for (idx = 0; idx < spectrum->count; idx++)
+    {
+        double power = spectrum->list[idx].power;
+
+        if (!(power >= -ANALYTICS_MAX_DBM && power <= ANALYTICS_MAX_DBM))
+        {
+            OTAI_META_LOG_ERROR("spectrum entry %u has invalid power", idx);
+
+            return OTAI_STATUS_INVALID_PARAMETER;
+        }
+
+        if (idx != 0 && spectrum->list[idx].lower_frequency < spectrum->list[idx - 1].lower_frequency)
+        {
+            OTAI_META_LOG_ERROR("spectrum entry %u is not sorted", idx);
+
+            return OTAI_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    for (idx = 0; idx < count; idx++)
+    {
+        if (channels[idx].upperfrequency <= channels[idx].lowerfrequency)
+        {
+            OTAI_META_LOG_ERROR("channel %u has empty frequency range", idx);
+
+            return OTAI_STATUS_INVALID_PARAMETER;
+        }
+
+        if (idx != 0 && channels[idx].lowerfrequency < channels[idx - 1].upperfrequency)
+        {
+            OTAI_META_LOG_ERROR("channel %u is not sorted or overlaps previous", idx);
+
+            return OTAI_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static void otai_metadata_analytics_reduce(
+        _In_ const otai_spectrum_power_t *list,
+        _In_ const double *linear,
+        _In_ size_t first,
+        _In_ size_t last,
+        _In_ uint64_t width,
+        _Inout_ otai_metadata_analytics_channel_t *channel)
+{
+    size_t count = last - first;
+
+    double power;
+    double peak;
+    double noise;
+
+    otai_metadata_analytics_kernel(linear + first, count, &power, &peak, &noise);
+
+    /* only first and last entry can partially overlap channel */
+
+    power -= linear[first] * (1 - otai_metadata_analytics_weight(&list[first], width, channel));
+
+    if (count > 1)
+    {
+        power -= linear[last - 1] * (1 - otai_metadata_analytics_weight(&list[last - 1], width, channel));
+    }
+
+    size_t idx = first;
+
+    while (idx < last - 1 && linear[idx] < peak)
+    {
+        idx++;
+    }
+
+    uint64_t start = otai_metadata_analytics_start(&list[idx], width);
+    uint64_t end = otai_metadata_analytics_end(&list[idx], width);
+
+    channel->peakfrequency = start + (end - start) / 2;
+
+    idx = first;
+
+    while (idx < last - 1 && linear[idx] > noise)
+    {
+        idx++;
+    }
+
+    start = otai_metadata_analytics_start(&list[idx], width);
+    end = otai_metadata_analytics_end(&list[idx], width);
+
+    /* noise density from lowest entry, in mW per MHz */
+
+    noise /= (double)(end - start);
+
+    double signal = power - noise * (double)(channel->upperfrequency - channel->lowerfrequency);
+
+    channel->entries = (uint32_t)count;
+    channel->power = otai_metadata_analytics_linear_to_db(power);
+    channel->peak = otai_metadata_analytics_linear_to_db(peak);
+
+    /* signal lost in rounding means channel has no power above noise */
+
+    if (!(signal > power * 1e-9))
+    {
+        channel->osnr = -HUGE_VAL;
+    }
+    else if (!(noise > 0))
+    {
+        channel->osnr = HUGE_VAL;
+    }
+    else
+    {
+        channel->osnr = otai_metadata_analytics_linear_to_db(signal / (noise * OTAI_METADATA_ANALYTICS_REFERENCE_BANDWIDTH));
+    }
+}
+
+otai_status_t otai_metadata_analytics_compute(
+        _Inout_ otai_metadata_analytics_t *analytics,
+        _In_ const otai_spectrum_power_list_t *spectrum,
+        _In_ uint64_t granularity,
+        _In_ uint32_t count,
+        _Inout_ otai_metadata_analytics_channel_t *channels)
+{
+    otai_status_t status = otai_metadata_analytics_validate(spectrum, count, channels);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    if (spectrum->count > analytics->capacity)
+    {
+        double *linear = realloc(analytics->linear, spectrum->count * sizeof(double));
+
+        if (linear == NULL)
+        {
+            return OTAI_STATUS_NO_MEMORY;
+        }
+
+        analytics->linear = linear;
+        analytics->capacity = spectrum->count;
+    }
+
+    const otai_spectrum_power_t *list = spectrum->list;
+
+    /* sample without granularity is taken as 1 MHz wide */
+
+    uint64_t width = granularity == 0 ? 1 : granularity;
+
+    otai_metadata_analytics_convert(list, spectrum->count, analytics->linear);
+
+    size_t first = 0;
+    uint32_t idx;
+
+    for (idx = 0; idx < count; idx++)
+    {
+        otai_metadata_analytics_channel_t *channel = &channels[idx];
+
+        while (first < spectrum->count &&
+                otai_metadata_analytics_end(&list[first], width) <= channel->lowerfrequency)
+        {
+            first++;
+        }
+
+        size_t last = first;
+
+        while (last < spectrum->count &&
+                otai_metadata_analytics_start(&list[last], width) < channel->upperfrequency)
+        {
+            last++;
+        }
+
+        if (last == first)
+        {
+            channel->entries = 0;
+            channel->power = -HUGE_VAL;
+            channel->peak = -HUGE_VAL;
+            channel->peakfrequency = 0;
+            channel->osnr = -HUGE_VAL;
+
+            continue;
+        }
+
+        otai_metadata_analytics_reduce(list, analytics->linear, first, last, width, channel);
+
+        /* last entry can overlap next channel too */
+
+        first = last - 1;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
@@ -0,0 +1,183 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadataanalytics.h
+ *
+ * @brief   This module defines OTAI Metadata spectrum analytics
+ */
+
+#ifndef __OTAIMETADATAANALYTICS_H_
+#define __OTAIMETADATAANALYTICS_H_
+
+#include "otaimetadatatypes.h"
+
+/**
+ * @defgroup OTAIMETADATAANALYTICS OTAI - Metadata spectrum analytics
+ *
+ * Spectrum analytics computes integrated power, peak power and rough OSNR
+ * of media channels from OCM spectrum. Spectrum powers are converted from
+ * dBm to mW in single loop over whole spectrum, then each channel is
+ * reduced over contiguous range of converted powers, in one pass over
+ * spectrum sorted by frequency. Loops are written so compiler vectorizes
+ * them at -O3, which module is built with, and conversion doesn't use libm.
+ *
+ * Spectrum entry with upper frequency above lower frequency covers that
+ * range, otherwise it is sample at lower frequency covering frequency
+ * granularity of OCM around it. Entry which partially overlaps channel
+ * adds its power proportionally to overlap.
+ *
+ * OSNR is estimated from lowest entry overlapping channel taken as noise
+ * floor, so entries should have same width, as entries of OCM sweep do.
+ * Noise is in 12.5 GHz reference bandwidth. Frequencies are in MHz.
+ *
+ * @{
+ */
+
+/**
+ * @def OTAI_METADATA_ANALYTICS_REFERENCE_BANDWIDTH
+ *
+ * OSNR reference bandwidth in MHz.
+ */
+#define OTAI_METADATA_ANALYTICS_REFERENCE_BANDWIDTH 12500
+
+/**
+ * @brief Media channel analytics.
+ */
+typedef struct _otai_metadata_analytics_channel_t
+{
+    /**
+     * @brief Lower frequency, as #OTAI_MEDIACHANNEL_ATTR_LOWER_FREQUENCY.
+     */
+    otai_uint64_t                                lowerfrequency;
+
+    /**
+     * @brief Upper frequency, as #OTAI_MEDIACHANNEL_ATTR_UPPER_FREQUENCY.
+     */
+    otai_uint64_t                                upperfrequency;
+
+    /**
+     * @brief Number of spectrum entries overlapping channel.
+     */
+    otai_uint32_t                                entries;
+
+    /**
+     * @brief Integrated power in dBm.
+     */
+    otai_double_t                                power;
+
+    /**
+     * @brief Peak power in dBm.
+     */
+    otai_double_t                                peak;
+
+    /**
+     * @brief Center frequency of spectrum entry with peak power.
+     */
+    otai_uint64_t                                peakfrequency;
+
+    /**
+     * @brief Estimated OSNR in dB.
+     */
+    otai_double_t                                osnr;
+
+} otai_metadata_analytics_channel_t;
+
+/**
+ * @brief Spectrum analytics context.
+ */
+typedef struct _otai_metadata_analytics_t
+{
+    /**
+     * @brief Number of entries of work array.
+     */
+    otai_uint32_t                                capacity;
+
+    /**
+     * @brief Entry powers in mW.
+     */
+    otai_double_t*                               linear;
+
+} otai_metadata_analytics_t;
+
+/**
+ * @brief Initialize spectrum analytics context
+ *
+ * @param[out] analytics Analytics context
+ * @param[in] count Expected number of spectrum entries, array grows when needed
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_NO_MEMORY if work
+ * array can't be allocated
+ */
+extern otai_status_t otai_metadata_analytics_init(
+        _Out_ otai_metadata_analytics_t *analytics,
+        _In_ uint32_t count);
+
+/**
+ * @brief Release spectrum analytics context memory
+ *
+ * @param[inout] analytics Analytics context
+ */
+extern void otai_metadata_analytics_destroy(
+        _Inout_ otai_metadata_analytics_t *analytics);
+
+/**
+ * @brief Compute analytics of media channels
+ *
+ * Channels without spectrum entries get -HUGE_VAL power, peak and OSNR.
+ *
+ * @param[inout] analytics Analytics context
+ * @param[in] spectrum Spectrum sorted by lower frequency
+ * @param[in] granularity Frequency granularity, as #OTAI_OCM_ATTR_FREQUENCY_GRANULARITY
+ * @param[in] count Number of channels
+ * @param[inout] channels Channels sorted by lower frequency, not overlapping
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if spectrum or channels are not sorted or power is not within 1000 dBm,
+ * #OTAI_STATUS_NO_MEMORY if work
+ * array can't grow
+ */
+extern otai_status_t otai_metadata_analytics_compute(
+        _Inout_ otai_metadata_analytics_t *analytics,
+        _In_ const otai_spectrum_power_list_t *spectrum,
+        _In_ uint64_t granularity,
+        _In_ uint32_t count,
+        _Inout_ otai_metadata_analytics_channel_t *channels);
+
+/**
+ * @brief Convert power from dBm to mW
+ *
+ * Polynomial approximation with relative error below 1e-8.
+ *
+ * @param[in] dbm Power in dBm
+ *
+ * @return Power in mW, 0 or HUGE_VAL if power is not within 1000 dBm
+ */
+extern double otai_metadata_analytics_db_to_linear(
+        _In_ double dbm);
+
+/**
+ * @brief Convert power from mW to dBm
+ *
+ * @param[in] mw Power in mW
+ *
+ * @return Power in dBm, -HUGE_VAL if power is not positive
+ */
+extern double otai_metadata_analytics_linear_to_db(
+        _In_ double mw);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATAANALYTICS_H_ */
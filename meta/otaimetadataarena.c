@@ -0,0 +1,252 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadataarena.c
+ *
+ * @brief   This module implements OTAI Metadata arena allocator
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <otai.h>
+#include "otaimetadataarena.h"
+
+#define OTAI_METADATA_ARENA_ALIGN sizeof(uint64_t)
+#define OTAI_METADATA_ARENA_POOL_MIN_SIZE 16
+#define OTAI_METADATA_ARENA_POOL_NO_CLASS OTAI_METADATA_ARENA_POOL_CLASSES
+
+/*
+ * Block data follows block header, header size is multiple of 8, so data
+ * is aligned.
+ */
+typedef struct _otai_metadata_arena_block_t
+{
+    struct _otai_metadata_arena_block_t *next;
+
+    size_t size;
+
+    size_t used;
+
+} otai_metadata_arena_block_t;
+
+/*
+ * In pool mode every allocation is preceded by 8 byte header with size
+ * class, so free doesn't need to know allocation size.
+ */
+typedef uint64_t otai_metadata_arena_pool_header_t;
+
+void otai_metadata_arena_init(
+        _Out_ otai_metadata_arena_t *arena,
+        _In_ size_t block_size,
+        _In_ bool pool)
+{
+    memset(arena, 0, sizeof(otai_metadata_arena_t));
+
+    arena->blocksize = block_size ? block_size : OTAI_METADATA_ARENA_DEFAULT_BLOCK_SIZE;
+    arena->pool = pool;
+}
+
+static uint8_t* otai_metadata_arena_block_data(
+        _In_ otai_metadata_arena_block_t *block)
+{
+    return (uint8_t*)block + sizeof(otai_metadata_arena_block_t);
+}
+
+static uint8_t* otai_metadata_arena_bump(
+        _Inout_ otai_metadata_arena_t *arena,
+        _In_ size_t size)
+{
+    otai_metadata_arena_block_t *block = arena->current;
+
+    if (block != NULL && block->size - block->used >= size)
+    {
+        uint8_t *ptr = otai_metadata_arena_block_data(block) + block->used;
+
+        block->used += size;
+
+        return ptr;
+    }
+
+    /*
+     * Blocks after current one are empty after reset, so next block is
+     * reused if it is big enough, otherwise new block is inserted.
+     */
+
+    otai_metadata_arena_block_t *next = (block == NULL) ? arena->head : block->next;
+
+    if (next == NULL || next->size < size)
+    {
+        size_t blocksize = (size > arena->blocksize) ? size : arena->blocksize;
+
+        otai_metadata_arena_block_t *nb = malloc(sizeof(otai_metadata_arena_block_t) + blocksize);
+
+        if (nb == NULL)
+        {
+            return NULL;
+        }
+
+        nb->size = blocksize;
+        nb->used = 0;
+        nb->next = next;
+
+        if (block == NULL)
+        {
+            arena->head = nb;
+        }
+        else
+        {
+            block->next = nb;
+        }
+
+        arena->reserved += blocksize;
+
+        next = nb;
+    }
+
+    arena->current = next;
+
+    next->used = size;
+
+    return otai_metadata_arena_block_data(next);
+}
+
+static size_t otai_metadata_arena_pool_class(
+        _In_ size_t size)
+{
+    size_t cls = 0;
+    size_t clssize = OTAI_METADATA_ARENA_POOL_MIN_SIZE;
+
+    while (cls < OTAI_METADATA_ARENA_POOL_CLASSES && clssize < size)
+    {
+        cls++;
+        clssize <<= 1;
+    }
+
+    return cls;
+}
+
+void* otai_metadata_arena_alloc(
+        _Inout_ otai_metadata_arena_t *arena,
+        _In_ size_t size)
+{
+    /*
+     * Alignment, pool header and block header are added to size, so too
+     * large size would wrap around.
+     */
+
+    if (size > SIZE_MAX / 2)
+    {
+        return NULL;
+    }
+
+    size = (size + OTAI_METADATA_ARENA_ALIGN - 1) & ~(OTAI_METADATA_ARENA_ALIGN - 1);
+
+    if (!arena->pool)
+    {
+        uint8_t *ptr = otai_metadata_arena_bump(arena, size);
+
+        if (ptr != NULL)
+        {
+            memset(ptr, 0, size);
+        }
+
+        return ptr;
+    }
+
+    otai_metadata_arena_pool_header_t cls = otai_metadata_arena_pool_class(size);
+
+    if (cls != OTAI_METADATA_ARENA_POOL_NO_CLASS)
+    {
+        size = (size_t)OTAI_METADATA_ARENA_POOL_MIN_SIZE << cls;
+
+        void *ptr = arena->freelist[cls];
+
+        if (ptr != NULL)
+        {
+            memcpy(&arena->freelist[cls], ptr, sizeof(void*));
+            memset(ptr, 0, size);
+
+            return ptr;
+        }
+    }
+
+    uint8_t *ptr = otai_metadata_arena_bump(arena, sizeof(cls) + size);
+
+    if (ptr == NULL)
+    {
+        return NULL;
+    }
+
+    memcpy(ptr, &cls, sizeof(cls));
+    memset(ptr + sizeof(cls), 0, size);
+
+    return ptr + sizeof(cls);
+}
+
+void otai_metadata_arena_free(
+        _Inout_ otai_metadata_arena_t *arena,
+        _Inout_ void *ptr)
+{
+    if (!arena->pool || ptr == NULL)
+    {
+        return;
+    }
+
+    otai_metadata_arena_pool_header_t cls;
+
+    memcpy(&cls, (uint8_t*)ptr - sizeof(cls), sizeof(cls));
+
+    if (cls >= OTAI_METADATA_ARENA_POOL_NO_CLASS)
+    {
+        return;
+    }
+
+    memcpy(ptr, &arena->freelist[cls], sizeof(void*));
+
+    arena->freelist[cls] = ptr;
+}
+
+void otai_metadata_arena_reset(
+        _Inout_ otai_metadata_arena_t *arena)
+{
+    otai_metadata_arena_block_t *block = arena->head;
+
+    for (; block != NULL; block = block->next)
+    {
+        block->used = 0;
+    }
+
+    arena->current = arena->head;
+
+    memset(arena->freelist, 0, sizeof(arena->freelist));
+}
+
+void otai_metadata_arena_destroy(
+        _Inout_ otai_metadata_arena_t *arena)
+{
+    otai_metadata_arena_block_t *block = arena->head;
+
+    while (block != NULL)
+    {
+        otai_metadata_arena_block_t *next = block->next;
+
+        free(block);
+
+        block = next;
+    }
+
+    otai_metadata_arena_init(arena, arena->blocksize, arena->pool);
+}
@@ -0,0 +1,154 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadataarena.h
+ *
+ * @brief   This module defines OTAI Metadata arena allocator
+ */
+
+#ifndef __OTAIMETADATAARENA_H_
+#define __OTAIMETADATAARENA_H_
+
+#include "otaimetadatatypes.h"
+
+/**
+ * @defgroup OTAIMETADATAARENA OTAI - Metadata arena allocator
+ *
+ * Arena allocates memory from large blocks, so lists of many attributes,
+ * like snapshot of all objects on linecard, are kept in few regions and
+ * released with single call.
+ *
+ * @{
+ */
+
+/**
+ * @def OTAI_METADATA_ARENA_DEFAULT_BLOCK_SIZE
+ *
+ * Default size of arena block in bytes.
+ */
+#define OTAI_METADATA_ARENA_DEFAULT_BLOCK_SIZE 0x10000
+
+/**
+ * @def OTAI_METADATA_ARENA_POOL_CLASSES
+ *
+ * Number of pool size classes, smallest class is 16 bytes and each next
+ * class is twice as big.
+ */
+#define OTAI_METADATA_ARENA_POOL_CLASSES 20
+
+/**
+ * @brief Arena allocator.
+ *
+ * In pool mode, freed memory is kept on free list of its size class and
+ * reused by next allocation of the same class, so repeated polls with the
+ * same list sizes don't grow the arena.
+ */
+typedef struct _otai_metadata_arena_t
+{
+    /**
+     * @brief First block, blocks are kept in allocation order.
+     */
+    void*                                        head;
+
+    /**
+     * @brief Block from which memory is currently allocated.
+     */
+    void*                                        current;
+
+    /**
+     * @brief Minimal size of new block in bytes.
+     */
+    size_t                                       blocksize;
+
+    /**
+     * @brief Arena is in pool mode.
+     */
+    bool                                         pool;
+
+    /**
+     * @brief Free lists of pool size classes.
+     */
+    void*                                        freelist[OTAI_METADATA_ARENA_POOL_CLASSES];
+
+    /**
+     * @brief Number of bytes allocated from system for blocks.
+     */
+    size_t                                       reserved;
+
+} otai_metadata_arena_t;
+
+/**
+ * @brief Initialize arena
+ *
+ * No memory is allocated until first allocation from arena.
+ *
+ * @param[out] arena Arena to be initialized
+ * @param[in] block_size Minimal block size, 0 for default
+ * @param[in] pool Enable pool mode
+ */
+extern void otai_metadata_arena_init(
+        _Out_ otai_metadata_arena_t *arena,
+        _In_ size_t block_size,
+        _In_ bool pool);
+
+/**
+ * @brief Allocate memory from arena
+ *
+ * Memory is aligned to 8 bytes and it is zeroed.
+ *
+ * @param[inout] arena Arena
+ * @param[in] size Number of bytes
+ *
+ * @return Allocated memory or NULL if system is out of memory
+ */
+extern void* otai_metadata_arena_alloc(
+        _Inout_ otai_metadata_arena_t *arena,
+        _In_ size_t size);
+
+/**
+ * @brief Free memory allocated from arena
+ *
+ * Memory is put back to size class free list in pool mode, otherwise it
+ * is released when arena is reset.
+ *
+ * @param[inout] arena Arena
+ * @param[inout] ptr Memory returned by otai_metadata_arena_alloc()
+ */
+extern void otai_metadata_arena_free(
+        _Inout_ otai_metadata_arena_t *arena,
+        _Inout_ void *ptr);
+
+/**
+ * @brief Release all memory allocated from arena
+ *
+ * Blocks are kept and reused by next allocations.
+ *
+ * @param[inout] arena Arena
+ */
+extern void otai_metadata_arena_reset(
+        _Inout_ otai_metadata_arena_t *arena);
+
+/**
+ * @brief Release all arena blocks to system
+ *
+ * @param[inout] arena Arena
+ */
+extern void otai_metadata_arena_destroy(
+        _Inout_ otai_metadata_arena_t *arena);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATAARENA_H_ */
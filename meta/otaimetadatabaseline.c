@@ -0,0 +1,497 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatabaseline.c
+ *
+ * @brief   This module implements OTAI Metadata OTDR baseline diff
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <otai.h>
+#include "otaimetadatautils.h"
+#include "otaimetadatalogger.h"
+#include "otaimetadataotdr.h"
+#include "otaimetadatabaseline.h"
+
+#define BASELINE_SAMPLE_SCALE       0.001
+#define BASELINE_WINDOW             256
+
+/* window is made of this many blocks */
+#define BASELINE_BLOCKS             4
+
+otai_status_t otai_metadata_baseline_config_from_attr_list(
+        _Inout_ otai_metadata_baseline_config_t *config,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    otai_metadata_otdr_config_t otdr;
+
+    memset(&otdr, 0, sizeof(otdr));
+
+    otdr.distanceaccuracy = config->distanceaccuracy;
+    otdr.samplingresolution = config->samplingresolution;
+    otdr.splicelossthreshold = config->lossthreshold;
+
+    otai_status_t status = otai_metadata_otdr_config_from_attr_list(&otdr, attr_count, attr_list);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    config->distanceaccuracy = otdr.distanceaccuracy;
+    config->samplingresolution = otdr.samplingresolution;
+    config->lossthreshold = otdr.splicelossthreshold;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_baseline_init(
+        _Out_ otai_metadata_baseline_t *baseline,
+        _In_ const otai_metadata_baseline_config_t *config)
+{
+    memset(baseline, 0, sizeof(otai_metadata_baseline_t));
+
+    if (config->capacity == 0 || !(config->samplingresolution > 0) || !(config->lossthreshold > 0))
+    {
+        OTAI_META_LOG_ERROR("capacity, sampling resolution and loss threshold must be positive");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    baseline->config = *config;
+
+    if (!(baseline->config.samplescale > 0))
+    {
+        baseline->config.samplescale = BASELINE_SAMPLE_SCALE;
+    }
+
+    if (!(baseline->config.distanceaccuracy > 0))
+    {
+        baseline->config.distanceaccuracy = config->samplingresolution;
+    }
+
+    if (baseline->config.window < BASELINE_BLOCKS)
+    {
+        baseline->config.window = BASELINE_WINDOW;
+    }
+
+    baseline->entries = calloc(config->capacity, sizeof(otai_metadata_baseline_entry_t));
+
+    if (baseline->entries == NULL ||
+            otai_metadata_objectmap_init(&baseline->objectmap, config->capacity) != OTAI_STATUS_SUCCESS)
+    {
+        otai_metadata_baseline_destroy(baseline);
+
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static void otai_metadata_baseline_free_entry(
+        _Inout_ otai_metadata_baseline_entry_t *entry)
+{
+    free(entry->events.events.list);
+    free(entry->samples);
+
+    memset(entry, 0, sizeof(otai_metadata_baseline_entry_t));
+}
+
+void otai_metadata_baseline_destroy(
+        _Inout_ otai_metadata_baseline_t *baseline)
+{
+    uint32_t idx;
+
+    for (idx = 0; idx < baseline->count; idx++)
+    {
+        otai_metadata_baseline_free_entry(&baseline->entries[idx]);
+    }
+
+    free(baseline->entries);
+
+    otai_metadata_objectmap_destroy(&baseline->objectmap);
+
+    memset(baseline, 0, sizeof(otai_metadata_baseline_t));
+}
+
+static otai_metadata_baseline_entry_t* otai_metadata_baseline_find(
+        _In_ const otai_metadata_baseline_t *baseline,
+        _In_ otai_object_id_t otdr_id)
+{
+    uint32_t index;
+
+    if (!otai_metadata_objectmap_find(&baseline->objectmap, otdr_id, &index))
+    {
+        return NULL;
+    }
+
+    return &baseline->entries[index];
+}
+
+const otai_metadata_baseline_entry_t* otai_metadata_baseline_get(
+        _In_ const otai_metadata_baseline_t *baseline,
+        _In_ otai_object_id_t otdr_id)
+{
+    return otai_metadata_baseline_find(baseline, otdr_id);
+}
+
+otai_status_t otai_metadata_baseline_set(
+        _Inout_ otai_metadata_baseline_t *baseline,
+        _In_ otai_object_id_t otdr_id,
+        _In_ const otai_otdr_result_t *otdr_result)
+{
+    otai_metadata_baseline_entry_t *entry = otai_metadata_baseline_find(baseline, otdr_id);
+
+    if (entry == NULL && baseline->count == baseline->config.capacity)
+    {
+        OTAI_META_LOG_ERROR("no room for baseline of OTDR 0x%" PRIx64, otdr_id);
+
+        return OTAI_STATUS_TABLE_FULL;
+    }
+
+    const otai_otdr_event_list_t *events = &otdr_result->events.events;
+    const otai_u8_list_t *trace = &otdr_result->trace.data;
+
+    otai_metadata_baseline_entry_t copy;
+
+    memset(&copy, 0, sizeof(copy));
+
+    copy.otdrid = otdr_id;
+    copy.events = otdr_result->events;
+    copy.events.events.list = NULL;
+    copy.samplecount = trace->list == NULL ? 0 : trace->count / 2;
+
+    if (events->count != 0 && events->list != NULL)
+    {
+        copy.events.events.list = malloc(events->count * sizeof(otai_otdr_event_t));
+    }
+    else
+    {
+        copy.events.events.count = 0;
+    }
+
+    if (copy.samplecount != 0)
+    {
+        copy.samples = malloc(copy.samplecount * sizeof(uint16_t));
+    }
+
+    if ((copy.events.events.count != 0 && copy.events.events.list == NULL) ||
+            (copy.samplecount != 0 && copy.samples == NULL))
+    {
+        otai_metadata_baseline_free_entry(&copy);
+
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    if (copy.events.events.count != 0)
+    {
+        memcpy(copy.events.events.list, events->list, events->count * sizeof(otai_otdr_event_t));
+    }
+
+    uint32_t idx;
+
+    for (idx = 0; idx < copy.samplecount; idx++)
+    {
+        copy.samples[idx] = (uint16_t)(trace->list[2 * idx] << 8 | trace->list[2 * idx + 1]);
+    }
+
+    if (entry == NULL)
+    {
+        otai_status_t status = otai_metadata_objectmap_insert(&baseline->objectmap, otdr_id, baseline->count);
+
+        if (status != OTAI_STATUS_SUCCESS)
+        {
+            otai_metadata_baseline_free_entry(&copy);
+
+            return status;
+        }
+
+        entry = &baseline->entries[baseline->count++];
+    }
+    else
+    {
+        otai_metadata_baseline_free_entry(entry);
+    }
+
+    *entry = copy;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_baseline_remove(
+        _Inout_ otai_metadata_baseline_t *baseline,
+        _In_ otai_object_id_t otdr_id)
+{
+    uint32_t index;
+
+    if (!otai_metadata_objectmap_find(&baseline->objectmap, otdr_id, &index))
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    otai_metadata_objectmap_remove(&baseline->objectmap, otdr_id);
+
+    otai_metadata_baseline_entry_t *entry = &baseline->entries[index];
+
+    otai_metadata_baseline_free_entry(entry);
+
+    *entry = baseline->entries[--baseline->count];
+
+    memset(&baseline->entries[baseline->count], 0, sizeof(otai_metadata_baseline_entry_t));
+
+    if (index != baseline->count)
+    {
+        otai_metadata_objectmap_set(&baseline->objectmap, entry->otdrid, index);
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static bool otai_metadata_baseline_is_point(
+        _In_ otai_otdr_event_type_t type)
+{
+    return type == OTAI_OTDR_EVENT_TYPE_REFLECTION ||
+        type == OTAI_OTDR_EVENT_TYPE_NON_REFLECTION ||
+        type == OTAI_OTDR_EVENT_TYPE_END;
+}
+
+static uint32_t otai_metadata_baseline_next_point(
+        _In_ const otai_otdr_event_list_t *events,
+        _In_ uint32_t idx)
+{
+    while (idx < events->count && !otai_metadata_baseline_is_point(events->list[idx].type))
+    {
+        idx++;
+    }
+
+    return idx;
+}
+
+static void otai_metadata_baseline_add_change(
+        _In_ otai_metadata_baseline_change_type_t type,
+        _In_ const otai_otdr_event_t *event,
+        _In_ double baselineloss,
+        _In_ double loss,
+        _In_ uint32_t size,
+        _Inout_ uint32_t *found,
+        _Out_ otai_metadata_baseline_change_t *changes)
+{
+    if (*found < size)
+    {
+        otai_metadata_baseline_change_t *change = &changes[*found];
+
+        change->type = type;
+        change->eventtype = event->type;
+        change->distance = event->length;
+        change->baselineloss = baselineloss;
+        change->loss = loss;
+    }
+
+    (*found)++;
+}
+
+otai_status_t otai_metadata_baseline_diff_events(
+        _In_ const otai_metadata_baseline_t *baseline,
+        _In_ otai_object_id_t otdr_id,
+        _In_ const otai_otdr_events_t *events,
+        _Inout_ uint32_t *count,
+        _Out_ otai_metadata_baseline_change_t *changes)
+{
+    const otai_metadata_baseline_entry_t *entry = otai_metadata_baseline_find(baseline, otdr_id);
+
+    if (entry == NULL)
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    const otai_otdr_event_list_t *scan = &events->events;
+    const otai_otdr_event_list_t *base = &entry->events.events;
+
+    double accuracy = baseline->config.distanceaccuracy / 1000;
+    double threshold = baseline->config.lossthreshold;
+
+    uint32_t size = *count;
+    uint32_t found = 0;
+
+    uint32_t idx = otai_metadata_baseline_next_point(scan, 0);
+    uint32_t bidx = otai_metadata_baseline_next_point(base, 0);
+
+    if (scan->list == NULL)
+    {
+        idx = scan->count;
+    }
+
+    while (idx < scan->count || bidx < base->count)
+    {
+        const otai_otdr_event_t *event = idx < scan->count ? &scan->list[idx] : NULL;
+        const otai_otdr_event_t *bevent = bidx < base->count ? &base->list[bidx] : NULL;
+
+        if (bevent == NULL || (event != NULL && event->length < bevent->length - accuracy))
+        {
+            /* end of fiber moving is always reported, since it may be cut */
+
+            if (event->loss >= threshold || event->type != OTAI_OTDR_EVENT_TYPE_NON_REFLECTION)
+            {
+                otai_metadata_baseline_add_change(OTAI_METADATA_BASELINE_CHANGE_TYPE_NEW, event, 0, event->loss, size, &found, changes);
+            }
+
+            idx = otai_metadata_baseline_next_point(scan, idx + 1);
+        }
+        else if (event == NULL || event->length > bevent->length + accuracy)
+        {
+            otai_metadata_baseline_add_change(OTAI_METADATA_BASELINE_CHANGE_TYPE_MISSING, bevent, bevent->loss, 0, size, &found, changes);
+
+            bidx = otai_metadata_baseline_next_point(base, bidx + 1);
+        }
+        else
+        {
+            if (event->loss - bevent->loss >= threshold)
+            {
+                otai_metadata_baseline_add_change(OTAI_METADATA_BASELINE_CHANGE_TYPE_GROWN, event, bevent->loss, event->loss, size, &found, changes);
+            }
+
+            idx = otai_metadata_baseline_next_point(scan, idx + 1);
+            bidx = otai_metadata_baseline_next_point(base, bidx + 1);
+        }
+    }
+
+    if (found > size)
+    {
+        *count = size;
+
+        return OTAI_STATUS_BUFFER_OVERFLOW;
+    }
+
+    *count = found;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static int64_t otai_metadata_baseline_block(
+        _In_ const uint8_t *__restrict data,
+        _In_ const uint16_t *__restrict samples,
+        _In_ size_t count)
+{
+    int64_t sum = 0;
+
+    size_t idx;
+
+    for (idx = 0; idx < count; idx++)
+    {
+        sum += (int64_t)(data[2 * idx] << 8 | data[2 * idx + 1]) - samples[idx];
+    }
+
+    return sum;
+}
+
+otai_status_t otai_metadata_baseline_diff_trace(
+        _In_ const otai_metadata_baseline_t *baseline,
+        _In_ otai_object_id_t otdr_id,
+        _In_ const otai_u8_list_t *trace,
+        _Out_ otai_metadata_baseline_trace_diff_t *diff)
+{
+    const otai_metadata_baseline_entry_t *entry = otai_metadata_baseline_find(baseline, otdr_id);
+
+    memset(diff, 0, sizeof(otai_metadata_baseline_trace_diff_t));
+
+    diff->distance = -1;
+
+    if (entry == NULL)
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    uint32_t count = trace->list == NULL ? 0 : trace->count / 2;
+
+    count = count < entry->samplecount ? count : entry->samplecount;
+
+    diff->samples = count;
+
+    if (count == 0)
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    double scale = baseline->config.samplescale;
+
+    uint32_t step = baseline->config.window / BASELINE_BLOCKS;
+
+    if (count < BASELINE_BLOCKS * step)
+    {
+        /* shorter than window, only offset */
+
+        diff->offset = (double)otai_metadata_baseline_block(trace->list, entry->samples, count) / count * scale;
+
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    int64_t blocks[BASELINE_BLOCKS];
+    int64_t sum = 0;
+    double offset = 0;
+    double deviation = 0;
+    uint32_t block;
+
+    for (block = 0; (block + 1) * step <= count; block++)
+    {
+        int64_t *slot = &blocks[block % BASELINE_BLOCKS];
+
+        if (block >= BASELINE_BLOCKS)
+        {
+            sum -= *slot;
+        }
+
+        *slot = otai_metadata_baseline_block(trace->list + 2 * (size_t)block * step, entry->samples + (size_t)block * step, step);
+
+        sum += *slot;
+
+        if (block + 1 < BASELINE_BLOCKS)
+        {
+            continue;
+        }
+
+        double mean = (double)sum / (BASELINE_BLOCKS * step);
+
+        if (block + 1 == BASELINE_BLOCKS)
+        {
+            offset = mean;
+            continue;
+        }
+
+        deviation = (mean - offset) * scale;
+
+        if (deviation > diff->deviation || -deviation > diff->deviation)
+        {
+            diff->deviation = deviation > 0 ? deviation : -deviation;
+        }
+
+        if (diff->distance < 0 && (deviation >= baseline->config.lossthreshold || -deviation >= baseline->config.lossthreshold))
+        {
+            /* middle of window */
+
+            uint64_t middle = (uint64_t)(block + 1) * step - baseline->config.window / 2;
+
+            diff->distance = (double)middle * baseline->config.samplingresolution / 1000;
+        }
+    }
+
+    diff->offset = offset * scale;
+    diff->extraloss = deviation;
+
+    return OTAI_STATUS_SUCCESS;
+}
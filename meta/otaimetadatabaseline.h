@@ -0,0 +1,353 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatabaseline.h
+ *
+ * @brief   This module defines OTAI Metadata OTDR baseline diff
+ */
+
+#ifndef __OTAIMETADATABASELINE_H_
+#define __OTAIMETADATABASELINE_H_
+
+#include "otaimetadatatypes.h"
+#include "otaimetadataobjectmap.h"
+
+/**
+ * @defgroup OTAIMETADATABASELINE OTAI - Metadata OTDR baseline diff
+ *
+ * Baseline store keeps events and trace of reference scan of each OTDR,
+ * and compares each periodic scan with it.
+ *
+ * Events are aligned by distance within distance accuracy, walking both
+ * sorted lists once. Event which is not in baseline, event whose loss grew
+ * by loss threshold and baseline event which is gone are reported.
+ *
+ * Traces are compared by mean difference over sliding window, after
+ * removing offset of first window, so change of launch level is not
+ * reported. New loss shifts all samples after it, so first window which
+ * deviates locates it, and last window gives extra loss. Differences are
+ * summed over blocks of quarter window in loops compiler vectorizes, and
+ * window moves by block, so 100 km trace takes well below millisecond.
+ *
+ * Trace format is same as of OTDR trace analysis.
+ *
+ * @{
+ */
+
+/**
+ * @brief Baseline change type.
+ */
+typedef enum _otai_metadata_baseline_change_type_t
+{
+    /**
+     * @brief Event is not in baseline.
+     */
+    OTAI_METADATA_BASELINE_CHANGE_TYPE_NEW,
+
+    /**
+     * @brief Event loss grew.
+     */
+    OTAI_METADATA_BASELINE_CHANGE_TYPE_GROWN,
+
+    /**
+     * @brief Baseline event is not in scan.
+     */
+    OTAI_METADATA_BASELINE_CHANGE_TYPE_MISSING,
+
+} otai_metadata_baseline_change_type_t;
+
+/**
+ * @brief Baseline change.
+ */
+typedef struct _otai_metadata_baseline_change_t
+{
+    /**
+     * @brief Change type.
+     */
+    otai_metadata_baseline_change_type_t         type;
+
+    /**
+     * @brief Event type.
+     */
+    otai_otdr_event_type_t                       eventtype;
+
+    /**
+     * @brief Event distance in km.
+     */
+    otai_double_t                                distance;
+
+    /**
+     * @brief Baseline event loss in dB, 0 for new event.
+     */
+    otai_double_t                                baselineloss;
+
+    /**
+     * @brief Event loss in dB, 0 for missing event.
+     */
+    otai_double_t                                loss;
+
+} otai_metadata_baseline_change_t;
+
+/**
+ * @brief Trace difference.
+ */
+typedef struct _otai_metadata_baseline_trace_diff_t
+{
+    /**
+     * @brief Number of compared samples.
+     */
+    otai_uint32_t                                samples;
+
+    /**
+     * @brief Level difference of first window in dB, positive if scan is lower.
+     */
+    otai_double_t                                offset;
+
+    /**
+     * @brief Distance of first window deviating by loss threshold in km, negative if none.
+     */
+    otai_double_t                                distance;
+
+    /**
+     * @brief Largest deviation from offset in dB.
+     */
+    otai_double_t                                deviation;
+
+    /**
+     * @brief Deviation of last window in dB, positive if scan lost level.
+     */
+    otai_double_t                                extraloss;
+
+} otai_metadata_baseline_trace_diff_t;
+
+/**
+ * @brief Baseline store configuration.
+ */
+typedef struct _otai_metadata_baseline_config_t
+{
+    /**
+     * @brief Maximum number of OTDRs.
+     */
+    otai_uint32_t                                capacity;
+
+    /**
+     * @brief Distance accuracy in meters, as #OTAI_OTDR_ATTR_DISTANCE_ACCURACY.
+     */
+    otai_double_t                                distanceaccuracy;
+
+    /**
+     * @brief Meters per sample, as #OTAI_OTDR_ATTR_SAMPLING_RESOLUTION.
+     */
+    otai_double_t                                samplingresolution;
+
+    /**
+     * @brief Reported loss change in dB, as #OTAI_OTDR_ATTR_SPLICE_LOSS_THRESHOLD.
+     */
+    otai_double_t                                lossthreshold;
+
+    /**
+     * @brief Level of sample unit in dB, 0 for 0.001 dB.
+     */
+    otai_double_t                                samplescale;
+
+    /**
+     * @brief Number of samples of trace window, 0 for 256.
+     */
+    otai_uint32_t                                window;
+
+} otai_metadata_baseline_config_t;
+
+/**
+ * @brief Baseline of single OTDR.
+ */
+typedef struct _otai_metadata_baseline_entry_t
+{
+    /**
+     * @brief OTDR Id.
+     */
+    otai_object_id_t                             otdrid;
+
+    /**
+     * @brief Events.
+     */
+    otai_otdr_events_t                           events;
+
+    /**
+     * @brief Number of trace samples.
+     */
+    otai_uint32_t                                samplecount;
+
+    /**
+     * @brief Decoded trace samples.
+     */
+    otai_uint16_t*                               samples;
+
+} otai_metadata_baseline_entry_t;
+
+/**
+ * @brief Baseline store.
+ */
+typedef struct _otai_metadata_baseline_t
+{
+    /**
+     * @brief Configuration.
+     */
+    otai_metadata_baseline_config_t              config;
+
+    /**
+     * @brief Number of baselines.
+     */
+    otai_uint32_t                                count;
+
+    /**
+     * @brief Baselines.
+     */
+    otai_metadata_baseline_entry_t*              entries;
+
+    /**
+     * @brief Index of baseline of each OTDR.
+     */
+    otai_metadata_objectmap_t                    objectmap;
+
+} otai_metadata_baseline_t;
+
+/**
+ * @brief Fill configuration from OTDR attributes
+ *
+ * Attributes are parsed as OTDR analysis configuration, so both get same
+ * values. Attributes which are not in list don't change configuration.
+ *
+ * @param[inout] config Configuration
+ * @param[in] attr_count Number of attributes
+ * @param[in] attr_list Attribute list
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if list is NULL
+ */
+extern otai_status_t otai_metadata_baseline_config_from_attr_list(
+        _Inout_ otai_metadata_baseline_config_t *config,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list);
+
+/**
+ * @brief Initialize baseline store
+ *
+ * @param[out] baseline Baseline store
+ * @param[in] config Configuration
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if configuration is invalid, #OTAI_STATUS_NO_MEMORY if store can't be
+ * allocated
+ */
+extern otai_status_t otai_metadata_baseline_init(
+        _Out_ otai_metadata_baseline_t *baseline,
+        _In_ const otai_metadata_baseline_config_t *config);
+
+/**
+ * @brief Release baseline store memory
+ *
+ * @param[inout] baseline Baseline store
+ */
+extern void otai_metadata_baseline_destroy(
+        _Inout_ otai_metadata_baseline_t *baseline);
+
+/**
+ * @brief Set baseline of OTDR
+ *
+ * Events and trace are copied, previous baseline of OTDR is replaced.
+ *
+ * @param[inout] baseline Baseline store
+ * @param[in] otdr_id OTDR Id
+ * @param[in] otdr_result OTDR result
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_TABLE_FULL if there
+ * is no room, #OTAI_STATUS_NO_MEMORY if copy can't be allocated
+ */
+extern otai_status_t otai_metadata_baseline_set(
+        _Inout_ otai_metadata_baseline_t *baseline,
+        _In_ otai_object_id_t otdr_id,
+        _In_ const otai_otdr_result_t *otdr_result);
+
+/**
+ * @brief Remove baseline of OTDR
+ *
+ * @param[inout] baseline Baseline store
+ * @param[in] otdr_id OTDR Id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * OTDR has no baseline
+ */
+extern otai_status_t otai_metadata_baseline_remove(
+        _Inout_ otai_metadata_baseline_t *baseline,
+        _In_ otai_object_id_t otdr_id);
+
+/**
+ * @brief Get baseline of OTDR
+ *
+ * @param[in] baseline Baseline store
+ * @param[in] otdr_id OTDR Id
+ *
+ * @return Baseline, NULL if OTDR has no baseline
+ */
+extern const otai_metadata_baseline_entry_t* otai_metadata_baseline_get(
+        _In_ const otai_metadata_baseline_t *baseline,
+        _In_ otai_object_id_t otdr_id);
+
+/**
+ * @brief Compare events with baseline
+ *
+ * Fiber sections and start are not compared. Changes are in distance
+ * order.
+ *
+ * @param[in] baseline Baseline store
+ * @param[in] otdr_id OTDR Id
+ * @param[in] events Events of scan, sorted by distance
+ * @param[inout] count Size of changes array on input, number of changes on output
+ * @param[out] changes Changes
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * OTDR has no baseline, #OTAI_STATUS_BUFFER_OVERFLOW if there are more
+ * changes than array size, which is filled with nearest ones
+ */
+extern otai_status_t otai_metadata_baseline_diff_events(
+        _In_ const otai_metadata_baseline_t *baseline,
+        _In_ otai_object_id_t otdr_id,
+        _In_ const otai_otdr_events_t *events,
+        _Inout_ uint32_t *count,
+        _Out_ otai_metadata_baseline_change_t *changes);
+
+/**
+ * @brief Compare trace with baseline
+ *
+ * Traces are compared up to shorter one.
+ *
+ * @param[in] baseline Baseline store
+ * @param[in] otdr_id OTDR Id
+ * @param[in] trace Trace of scan
+ * @param[out] diff Trace difference
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * OTDR has no baseline
+ */
+extern otai_status_t otai_metadata_baseline_diff_trace(
+        _In_ const otai_metadata_baseline_t *baseline,
+        _In_ otai_object_id_t otdr_id,
+        _In_ const otai_u8_list_t *trace,
+        _Out_ otai_metadata_baseline_trace_diff_t *diff);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATABASELINE_H_ */
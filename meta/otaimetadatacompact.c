@@ -0,0 +1,550 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatacompact.c
+ *
+ * @brief   This module implements OTAI Metadata compact attribute list
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <otai.h>
+#include "otaimetadatautils.h"
+#include "otaimetadatalogger.h"
+#include "otaimetadatacompact.h"
+#include "otaimetadata.h"
+
+#define OTAI_METADATA_COMPACT_ALIGN sizeof(uint64_t)
+
+void otai_metadata_compact_list_init(
+        _Out_ otai_compact_attribute_list_t *list,
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t count,
+        _Out_ otai_compact_attribute_t *attr_list,
+        _In_ size_t heap_size,
+        _Out_ uint8_t *heap)
+{
+    list->objecttype = object_type;
+    list->attrcount = 0;
+    list->attrcapacity = count;
+    list->attrlist = attr_list;
+    list->heap = heap;
+    list->heapsize = heap_size;
+    list->heapused = 0;
+}
+
+void otai_metadata_compact_list_clear(
+        _Inout_ otai_compact_attribute_list_t *list)
+{
+    list->attrcount = 0;
+    list->heapused = 0;
+}
+
+static size_t otai_metadata_compact_item_size(
+        _In_ otai_attr_value_type_t attr_value_type)
+{
+    switch (attr_value_type)
+    {
+        case OTAI_ATTR_VALUE_TYPE_CHARDATA:
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            return sizeof(uint8_t);
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            return sizeof(int8_t);
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            return sizeof(uint16_t);
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            return sizeof(int16_t);
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            return sizeof(uint32_t);
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            return sizeof(int32_t);
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            return sizeof(otai_object_id_t);
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            return sizeof(otai_spectrum_power_t);
+        default:
+            return 0;
+    }
+}
+
+/*
+ * Gets count and items of list value, false is returned if attribute
+ * value type is not a list.
+ */
+static bool otai_metadata_compact_get_value_list(
+        _In_ otai_attr_value_type_t attr_value_type,
+        _In_ const otai_attribute_value_t *value,
+        _Out_ uint32_t *count,
+        _Out_ const void **list)
+{
+    switch (attr_value_type)
+    {
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            *count = value->objlist.count;
+            *list = value->objlist.list;
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            *count = value->u8list.count;
+            *list = value->u8list.list;
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            *count = value->s8list.count;
+            *list = value->s8list.list;
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            *count = value->u16list.count;
+            *list = value->u16list.list;
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            *count = value->s16list.count;
+            *list = value->s16list.list;
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            *count = value->u32list.count;
+            *list = value->u32list.list;
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            *count = value->s32list.count;
+            *list = value->s32list.list;
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            *count = value->spectrumpowerlist.count;
+            *list = value->spectrumpowerlist.list;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void otai_metadata_compact_set_value_list(
+        _In_ otai_attr_value_type_t attr_value_type,
+        _Inout_ otai_attribute_value_t *value,
+        _In_ uint32_t count,
+        _In_ uint8_t *list)
+{
+    void *items = list;
+
+    switch (attr_value_type)
+    {
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            value->objlist.count = count;
+            value->objlist.list = (otai_object_id_t*)items;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            value->u8list.count = count;
+            value->u8list.list = (uint8_t*)items;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            value->s8list.count = count;
+            value->s8list.list = (int8_t*)items;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            value->u16list.count = count;
+            value->u16list.list = (uint16_t*)items;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            value->s16list.count = count;
+            value->s16list.list = (int16_t*)items;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            value->u32list.count = count;
+            value->u32list.list = (uint32_t*)items;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            value->s32list.count = count;
+            value->s32list.list = (int32_t*)items;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            value->spectrumpowerlist.count = count;
+            value->spectrumpowerlist.list = (otai_spectrum_power_t*)items;
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * Copies data to heap aligned to 8 bytes, offset is kept 32 bit to keep
+ * compact attribute 16 bytes.
+ */
+static otai_status_t otai_metadata_compact_heap_push(
+        _Inout_ otai_compact_attribute_list_t *list,
+        _In_ const void *data,
+        _In_ size_t size,
+        _Out_ uint32_t *offset)
+{
+    size_t start = (list->heapused + OTAI_METADATA_COMPACT_ALIGN - 1) & ~(OTAI_METADATA_COMPACT_ALIGN - 1);
+
+    if (start > list->heapsize || list->heapsize - start < size || start + size > UINT32_MAX)
+    {
+        return OTAI_STATUS_BUFFER_OVERFLOW;
+    }
+
+    if (size && data)
+    {
+        memcpy(list->heap + start, data, size);
+    }
+
+    list->heapused = start + size;
+
+    *offset = (uint32_t)start;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_compact_list_append(
+        _Inout_ otai_compact_attribute_list_t *list,
+        _In_ const otai_attribute_t *attr)
+{
+    const otai_attr_metadata_t *md = otai_metadata_get_attr_metadata(list->objecttype, attr->id);
+
+    if (md == NULL)
+    {
+        OTAI_META_LOG_ERROR("attribute %d not found on object type %d", attr->id, list->objecttype);
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (list->attrcount >= list->attrcapacity)
+    {
+        return OTAI_STATUS_BUFFER_OVERFLOW;
+    }
+
+    otai_compact_attribute_t *compact = &list->attrlist[list->attrcount];
+
+    compact->id = attr->id;
+    compact->count = 0;
+    compact->value.u64 = 0;
+
+    const otai_attribute_value_t *value = &attr->value;
+
+    const void *items = NULL;
+
+    otai_status_t status = OTAI_STATUS_SUCCESS;
+
+    switch (md->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_BOOL:
+            compact->value.booldata = value->booldata;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT8:
+            compact->value.u8 = value->u8;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT8:
+            compact->value.s8 = value->s8;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT16:
+            compact->value.u16 = value->u16;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT16:
+            compact->value.s16 = value->s16;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32:
+            compact->value.u32 = value->u32;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT32:
+            compact->value.s32 = value->s32;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT64:
+            compact->value.u64 = value->u64;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT64:
+            compact->value.s64 = value->s64;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_DOUBLE:
+            compact->value.d64 = value->d64;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_POINTER:
+            compact->value.ptr = value->ptr;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_ID:
+            compact->value.oid = value->oid;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32_RANGE:
+            compact->value.u32range = value->u32range;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT32_RANGE:
+            compact->value.s32range = value->s32range;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_CHARDATA:
+
+            items = memchr(value->chardata, 0, sizeof(value->chardata));
+
+            compact->count = (uint32_t)(items ? (size_t)((const char*)items - value->chardata) : sizeof(value->chardata));
+
+            /*
+             * Char data may fill whole buffer without terminating zero,
+             * terminating zero is added in heap, so char data can be used
+             * directly from heap.
+             */
+
+            status = otai_metadata_compact_heap_push(list, NULL, compact->count + 1, &compact->value.offset);
+
+            if (status == OTAI_STATUS_SUCCESS)
+            {
+                memcpy(list->heap + compact->value.offset, value->chardata, compact->count);
+
+                list->heap[compact->value.offset + compact->count] = 0;
+            }
+
+            break;
+
+        default:
+
+            if (!otai_metadata_compact_get_value_list(md->attrvaluetype, value, &compact->count, &items))
+            {
+                OTAI_META_LOG_ERROR("attr value type %d is not supported", md->attrvaluetype);
+                return OTAI_STATUS_INVALID_PARAMETER;
+            }
+
+            if (compact->count && items == NULL)
+            {
+                OTAI_META_LOG_ERROR("%s list is NULL, but count is %u", md->attridname, compact->count);
+                return OTAI_STATUS_INVALID_PARAMETER;
+            }
+
+            if (compact->count > SIZE_MAX / otai_metadata_compact_item_size(md->attrvaluetype))
+            {
+                return OTAI_STATUS_BUFFER_OVERFLOW;
+            }
+
+            status = otai_metadata_compact_heap_push(list, items,
+                    compact->count * otai_metadata_compact_item_size(md->attrvaluetype), &compact->value.offset);
+
+            break;
+    }
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    list->attrcount++;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_compact_list_from_attr_list(
+        _Inout_ otai_compact_attribute_list_t *list,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    otai_metadata_compact_list_clear(list);
+
+    uint32_t idx = 0;
+
+    for (; idx < attr_count; idx++)
+    {
+        otai_status_t status = otai_metadata_compact_list_append(list, &attr_list[idx]);
+
+        if (status != OTAI_STATUS_SUCCESS)
+        {
+            return status;
+        }
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_compact_list_get_attr(
+        _In_ const otai_compact_attribute_list_t *list,
+        _In_ const otai_compact_attribute_t *compact,
+        _Inout_ otai_attribute_t *attr)
+{
+    const otai_attr_metadata_t *md = otai_metadata_get_attr_metadata(list->objecttype, compact->id);
+
+    if (md == NULL)
+    {
+        OTAI_META_LOG_ERROR("attribute %d not found on object type %d", compact->id, list->objecttype);
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    attr->id = compact->id;
+
+    otai_attribute_value_t *value = &attr->value;
+
+    switch (md->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_BOOL:
+            value->booldata = compact->value.booldata;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT8:
+            value->u8 = compact->value.u8;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT8:
+            value->s8 = compact->value.s8;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT16:
+            value->u16 = compact->value.u16;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT16:
+            value->s16 = compact->value.s16;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32:
+            value->u32 = compact->value.u32;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT32:
+            value->s32 = compact->value.s32;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT64:
+            value->u64 = compact->value.u64;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT64:
+            value->s64 = compact->value.s64;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_DOUBLE:
+            value->d64 = compact->value.d64;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_POINTER:
+            value->ptr = compact->value.ptr;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_ID:
+            value->oid = compact->value.oid;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32_RANGE:
+            value->u32range = compact->value.u32range;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT32_RANGE:
+            value->s32range = compact->value.s32range;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_CHARDATA:
+
+            memcpy(value->chardata, list->heap + compact->value.offset, compact->count);
+
+            if (compact->count < sizeof(value->chardata))
+            {
+                value->chardata[compact->count] = 0;
+            }
+
+            break;
+
+        default:
+
+            if (otai_metadata_compact_item_size(md->attrvaluetype) == 0)
+            {
+                OTAI_META_LOG_ERROR("attr value type %d is not supported", md->attrvaluetype);
+                return OTAI_STATUS_INVALID_PARAMETER;
+            }
+
+            otai_metadata_compact_set_value_list(md->attrvaluetype, value, compact->count,
+                    compact->count ? list->heap + compact->value.offset : NULL);
+
+            break;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_compact_list_to_attr_list(
+        _In_ const otai_compact_attribute_list_t *list,
+        _Inout_ uint32_t *attr_count,
+        _Inout_ otai_attribute_t *attr_list)
+{
+    if (*attr_count < list->attrcount)
+    {
+        *attr_count = list->attrcount;
+        return OTAI_STATUS_BUFFER_OVERFLOW;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < list->attrcount; idx++)
+    {
+        otai_status_t status = otai_metadata_compact_list_get_attr(list, &list->attrlist[idx], &attr_list[idx]);
+
+        if (status != OTAI_STATUS_SUCCESS)
+        {
+            return status;
+        }
+    }
+
+    *attr_count = list->attrcount;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+const otai_compact_attribute_t* otai_metadata_compact_list_find(
+        _In_ const otai_compact_attribute_list_t *list,
+        _In_ otai_attr_id_t attr_id)
+{
+    uint32_t idx = 0;
+
+    for (; idx < list->attrcount; idx++)
+    {
+        if (list->attrlist[idx].id == attr_id)
+        {
+            return &list->attrlist[idx];
+        }
+    }
+
+    return NULL;
+}
+
+const char* otai_metadata_compact_list_get_chardata(
+        _In_ const otai_compact_attribute_list_t *list,
+        _In_ const otai_compact_attribute_t *compact)
+{
+    const otai_attr_metadata_t *md = otai_metadata_get_attr_metadata(list->objecttype, compact->id);
+
+    if (md == NULL || md->attrvaluetype != OTAI_ATTR_VALUE_TYPE_CHARDATA)
+    {
+        return NULL;
+    }
+
+    return (const char*)(list->heap + compact->value.offset);
+}
+
+const void* otai_metadata_compact_list_get_items(
+        _In_ const otai_compact_attribute_list_t *list,
+        _In_ const otai_compact_attribute_t *compact)
+{
+    const otai_attr_metadata_t *md = otai_metadata_get_attr_metadata(list->objecttype, compact->id);
+
+    if (md == NULL || md->attrvaluetype == OTAI_ATTR_VALUE_TYPE_CHARDATA ||
+            otai_metadata_compact_item_size(md->attrvaluetype) == 0 || compact->count == 0)
+    {
+        return NULL;
+    }
+
+    return list->heap + compact->value.offset;
+}
@@ -0,0 +1,328 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatacompact.h
+ *
+ * @brief   This module defines OTAI Metadata compact attribute list
+ */
+
+#ifndef __OTAIMETADATACOMPACT_H_
+#define __OTAIMETADATACOMPACT_H_
+
+#include "otaimetadatatypes.h"
+
+/**
+ * @defgroup OTAIMETADATACOMPACT OTAI - Metadata compact attribute list
+ *
+ * Compact attribute is 16 bytes, instead of over 512 bytes of
+ * otai_attribute_t. Char data and list items are kept out of line in list
+ * heap, provided by caller, so no memory is allocated.
+ *
+ * @{
+ */
+
+/**
+ * @brief Compact attribute value.
+ *
+ * Scalar values are stored in place, char data and list values are stored
+ * in list heap at given offset.
+ */
+typedef union _otai_compact_attribute_value_t
+{
+    /**
+     * @brief Boolean value.
+     */
+    bool                                         booldata;
+
+    /**
+     * @brief Unsigned 8 bit value.
+     */
+    otai_uint8_t                                 u8;
+
+    /**
+     * @brief Signed 8 bit value.
+     */
+    otai_int8_t                                  s8;
+
+    /**
+     * @brief Unsigned 16 bit value.
+     */
+    otai_uint16_t                                u16;
+
+    /**
+     * @brief Signed 16 bit value.
+     */
+    otai_int16_t                                 s16;
+
+    /**
+     * @brief Unsigned 32 bit value.
+     */
+    otai_uint32_t                                u32;
+
+    /**
+     * @brief Signed 32 bit value.
+     */
+    otai_int32_t                                 s32;
+
+    /**
+     * @brief Unsigned 64 bit value.
+     */
+    otai_uint64_t                                u64;
+
+    /**
+     * @brief Signed 64 bit value.
+     */
+    otai_int64_t                                 s64;
+
+    /**
+     * @brief Double value.
+     */
+    otai_double_t                                d64;
+
+    /**
+     * @brief Pointer value.
+     */
+    otai_pointer_t                               ptr;
+
+    /**
+     * @brief Object id value.
+     */
+    otai_object_id_t                             oid;
+
+    /**
+     * @brief Unsigned 32 bit range value.
+     */
+    otai_u32_range_t                             u32range;
+
+    /**
+     * @brief Signed 32 bit range value.
+     */
+    otai_s32_range_t                             s32range;
+
+    /**
+     * @brief Offset of char data or list items in list heap.
+     */
+    otai_uint32_t                                offset;
+
+} otai_compact_attribute_value_t;
+
+/**
+ * @brief Compact attribute.
+ */
+typedef struct _otai_compact_attribute_t
+{
+    /**
+     * @brief Attribute id.
+     */
+    otai_attr_id_t                               id;
+
+    /**
+     * @brief Char data length without terminating zero, or list count.
+     */
+    otai_uint32_t                                count;
+
+    /**
+     * @brief Attribute value.
+     */
+    otai_compact_attribute_value_t               value;
+
+} otai_compact_attribute_t;
+
+/**
+ * @brief Compact attribute list.
+ *
+ * All memory is provided by caller in otai_metadata_compact_list_init().
+ */
+typedef struct _otai_compact_attribute_list_t
+{
+    /**
+     * @brief Object type of all attributes on the list.
+     */
+    otai_object_type_t                           objecttype;
+
+    /**
+     * @brief Number of attributes on the list.
+     */
+    otai_uint32_t                                attrcount;
+
+    /**
+     * @brief Capacity of attribute array.
+     */
+    otai_uint32_t                                attrcapacity;
+
+    /**
+     * @brief Attribute array.
+     */
+    otai_compact_attribute_t*                    attrlist;
+
+    /**
+     * @brief Heap for char data and list items.
+     */
+    uint8_t*                                     heap;
+
+    /**
+     * @brief Heap size in bytes.
+     */
+    size_t                                       heapsize;
+
+    /**
+     * @brief Number of heap bytes used.
+     */
+    size_t                                       heapused;
+
+} otai_compact_attribute_list_t;
+
+/**
+ * @brief Initialize empty compact attribute list
+ *
+ * Heap should be aligned to 8 bytes, so list items in heap are aligned.
+ *
+ * @param[out] list Compact list to be initialized
+ * @param[in] object_type Object type of attributes
+ * @param[in] count Capacity of attribute array
+ * @param[out] attr_list Attribute array
+ * @param[in] heap_size Heap size in bytes
+ * @param[out] heap Heap for char data and list items
+ */
+extern void otai_metadata_compact_list_init(
+        _Out_ otai_compact_attribute_list_t *list,
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t count,
+        _Out_ otai_compact_attribute_t *attr_list,
+        _In_ size_t heap_size,
+        _Out_ uint8_t *heap);
+
+/**
+ * @brief Remove all attributes from compact attribute list
+ *
+ * @param[inout] list Compact list
+ */
+extern void otai_metadata_compact_list_clear(
+        _Inout_ otai_compact_attribute_list_t *list);
+
+/**
+ * @brief Append attribute to compact attribute list
+ *
+ * Value is stored based on attribute metadata, char data and list items
+ * are copied to list heap.
+ *
+ * @param[inout] list Compact list
+ * @param[in] attr Attribute to be appended
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_BUFFER_OVERFLOW if
+ * attribute array or heap is full, #OTAI_STATUS_INVALID_PARAMETER on
+ * other failure
+ */
+extern otai_status_t otai_metadata_compact_list_append(
+        _Inout_ otai_compact_attribute_list_t *list,
+        _In_ const otai_attribute_t *attr);
+
+/**
+ * @brief Convert attribute list to compact attribute list
+ *
+ * Compact list is cleared first.
+ *
+ * @param[inout] list Compact list
+ * @param[in] attr_count Number of attributes
+ * @param[in] attr_list Attributes to be converted
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, failure status code on error
+ */
+extern otai_status_t otai_metadata_compact_list_from_attr_list(
+        _Inout_ otai_compact_attribute_list_t *list,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list);
+
+/**
+ * @brief Convert compact attribute to attribute
+ *
+ * List values will point to compact list heap, so they are valid as long
+ * as compact list is not changed.
+ *
+ * @param[in] list Compact list
+ * @param[in] compact Compact attribute from compact list
+ * @param[inout] attr Converted attribute
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, failure status code on error
+ */
+extern otai_status_t otai_metadata_compact_list_get_attr(
+        _In_ const otai_compact_attribute_list_t *list,
+        _In_ const otai_compact_attribute_t *compact,
+        _Inout_ otai_attribute_t *attr);
+
+/**
+ * @brief Convert compact attribute list to attribute list
+ *
+ * List values will point to compact list heap, so they are valid as long
+ * as compact list is not changed.
+ *
+ * @param[in] list Compact list
+ * @param[inout] attr_count Capacity of attribute list on input, number of
+ * attributes on output
+ * @param[inout] attr_list Converted attributes
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_BUFFER_OVERFLOW if
+ * attribute list is too small, failure status code on other error
+ */
+extern otai_status_t otai_metadata_compact_list_to_attr_list(
+        _In_ const otai_compact_attribute_list_t *list,
+        _Inout_ uint32_t *attr_count,
+        _Inout_ otai_attribute_t *attr_list);
+
+/**
+ * @brief Find attribute on compact attribute list
+ *
+ * @param[in] list Compact list
+ * @param[in] attr_id Attribute id
+ *
+ * @return Compact attribute or NULL if attribute is not on the list
+ */
+extern const otai_compact_attribute_t* otai_metadata_compact_list_find(
+        _In_ const otai_compact_attribute_list_t *list,
+        _In_ otai_attr_id_t attr_id);
+
+/**
+ * @brief Get char data of compact attribute
+ *
+ * @param[in] list Compact list
+ * @param[in] compact Compact attribute with char data value
+ *
+ * @return Zero terminated char data or NULL if attribute value is not
+ * char data
+ */
+extern const char* otai_metadata_compact_list_get_chardata(
+        _In_ const otai_compact_attribute_list_t *list,
+        _In_ const otai_compact_attribute_t *compact);
+
+/**
+ * @brief Get list items of compact attribute
+ *
+ * Number of items is compact attribute count, item type is defined by
+ * attribute value type.
+ *
+ * @param[in] list Compact list
+ * @param[in] compact Compact attribute with list value
+ *
+ * @return List items or NULL if attribute value is not a list or list is
+ * empty
+ */
+extern const void* otai_metadata_compact_list_get_items(
+        _In_ const otai_compact_attribute_list_t *list,
+        _In_ const otai_compact_attribute_t *compact);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATACOMPACT_H_ */
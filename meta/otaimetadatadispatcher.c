@@ -0,0 +1,2134 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatadispatcher.c
+ *
+ * @brief   This module implements OTAI Metadata notification dispatcher
+ */
+
+/* pthread_rwlock_t is not declared in strict ANSI mode */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stddef.h>
+#include <inttypes.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <otai.h>
+#include "otaimetadatautils.h"
+#include "otaimetadatalogger.h"
+#include "otaimetadatadispatcher.h"
+
+#define OTAI_METADATA_DISPATCHER_ALIGN(_size) (((_size) + 7) & ~(size_t)7)
+
+/*
+ * Number of notifications dispatched from one ring before moving to next
+ * ring of the same thread, so busy linecard doesn't starve others.
+ */
+#define OTAI_METADATA_DISPATCHER_BATCH 64
+
+#define OTAI_METADATA_DISPATCHER_COALESCE_PROBES 16
+
+#define OTAI_METADATA_DISPATCHER_MIN_BUCKETS 64
+
+#define OTAI_METADATA_DISPATCHER_LOAD(_ptr) __atomic_load_n((_ptr), __ATOMIC_SEQ_CST)
+#define OTAI_METADATA_DISPATCHER_STORE(_ptr, _val) __atomic_store_n((_ptr), (_val), __ATOMIC_SEQ_CST)
+#define OTAI_METADATA_DISPATCHER_INC(_ptr) __atomic_fetch_add((_ptr), 1, __ATOMIC_SEQ_CST)
+#define OTAI_METADATA_DISPATCHER_DEC(_ptr) __atomic_fetch_sub((_ptr), 1, __ATOMIC_SEQ_CST)
+
+typedef enum _otai_metadata_dispatcher_event_type_t
+{
+    OTAI_METADATA_DISPATCHER_EVENT_LINECARD_STATE_CHANGE,
+
+    OTAI_METADATA_DISPATCHER_EVENT_LINECARD_ALARM,
+
+    OTAI_METADATA_DISPATCHER_EVENT_LINECARD_OCM_SPECTRUM_POWER,
+
+    OTAI_METADATA_DISPATCHER_EVENT_LINECARD_OTDR_RESULT,
+
+    OTAI_METADATA_DISPATCHER_EVENT_APS_SWITCH_INFO,
+
+    OTAI_METADATA_DISPATCHER_EVENT_APS_SWITCH_INFO_REF,
+
+} otai_metadata_dispatcher_event_type_t;
+
+typedef struct _otai_metadata_dispatcher_key_t
+{
+    otai_metadata_dispatcher_event_type_t type;
+
+    /* linecard or APS id */
+    otai_object_id_t id;
+
+    /* OCM or OTDR id, or alarm resource */
+    otai_object_id_t objectid;
+
+    /* alarm type */
+    int32_t subkey;
+
+} otai_metadata_dispatcher_key_t;
+
+typedef struct _otai_metadata_dispatcher_alarm_t
+{
+    otai_alarm_type_t type;
+
+    otai_alarm_info_t info;
+
+} otai_metadata_dispatcher_alarm_t;
+
+/*
+ * User callback of notifying object, taken when notification is queued.
+ */
+typedef union _otai_metadata_dispatcher_handler_t
+{
+    otai_linecard_state_change_notification_fn statechange;
+
+    otai_linecard_alarm_notification_fn alarm;
+
+    otai_linecard_ocm_spectrum_power_notification_fn spectrum;
+
+    otai_linecard_otdr_result_notification_fn otdr;
+
+    otai_aps_report_switch_info_fn switchinfo;
+
+    otai_aps_report_switch_info_ref_fn switchinforef;
+
+} otai_metadata_dispatcher_handler_t;
+
+/*
+ * Event is allocated with size of its data member, list items are copied
+ * right after it.
+ */
+typedef struct _otai_metadata_dispatcher_event_t
+{
+    otai_metadata_dispatcher_key_t key;
+
+    otai_metadata_dispatcher_handler_t handler;
+
+    union
+    {
+        otai_oper_status_t operstatus;
+
+        otai_metadata_dispatcher_alarm_t alarm;
+
+        otai_spectrum_power_list_t spectrum;
+
+        otai_otdr_result_t otdr;
+
+        otai_olp_switch_t switchinfo;
+
+        /* adapter buffer, not copied */
+        const otai_olp_switch_t *switchinforef;
+
+    } data;
+
+} otai_metadata_dispatcher_event_t;
+
+typedef struct _otai_metadata_dispatcher_cell_t
+{
+    uint64_t sequence;
+
+    otai_metadata_dispatcher_event_t *event;
+
+} otai_metadata_dispatcher_cell_t;
+
+/*
+ * Slot is free when it has no event, key is valid only while event is set.
+ */
+typedef struct _otai_metadata_dispatcher_slot_t
+{
+    otai_metadata_dispatcher_key_t key;
+
+    otai_metadata_dispatcher_event_t *event;
+
+} otai_metadata_dispatcher_slot_t;
+
+/*
+ * Bounded ring with per cell sequence numbers. Ring has single consumer
+ * thread, but producers dequeue too when dropping oldest notification, so
+ * dequeue position is also advanced with compare and swap. Coalesce slots
+ * are used only when ring is full, they are protected by coalesce lock.
+ */
+typedef struct _otai_metadata_dispatcher_ring_t
+{
+    uint64_t mask;
+
+    otai_metadata_dispatcher_cell_t *cells;
+
+    otai_metadata_dispatcher_slot_t *slots;
+
+    pthread_mutex_t coalescelock;
+
+    uint8_t pad0[64];
+
+    uint64_t enqueuepos;
+
+    uint8_t pad1[64];
+
+    uint64_t dequeuepos;
+
+    uint8_t pad2[64];
+
+    uint64_t coalescepending;
+
+    uint64_t enqueued;
+
+    uint64_t dispatched;
+
+    uint64_t dropped;
+
+    uint64_t coalesced;
+
+    uint64_t blocked;
+
+} otai_metadata_dispatcher_ring_t;
+
+typedef struct _otai_metadata_dispatcher_handlers_t
+{
+    otai_linecard_state_change_notification_fn statechange;
+
+    otai_linecard_alarm_notification_fn alarm;
+
+    otai_linecard_ocm_spectrum_power_notification_fn spectrum;
+
+    otai_linecard_otdr_result_notification_fn otdr;
+
+    otai_aps_report_switch_info_fn switchinfo;
+
+    otai_aps_report_switch_info_ref_fn switchinforef;
+
+} otai_metadata_dispatcher_handlers_t;
+
+/*
+ * Linecard or APS object created through dispatcher. Entry is referenced
+ * by object table until object is removed, and by producers and dispatcher
+ * threads while they use its ring.
+ */
+typedef struct _otai_metadata_dispatcher_entry_t
+{
+    /* NULL until create returns or first notification arrives */
+    otai_object_id_t objectid;
+
+    otai_object_type_t objecttype;
+
+    /* selects dispatcher thread */
+    uint32_t index;
+
+    uint32_t refs;
+
+    otai_metadata_dispatcher_handlers_t handlers;
+
+    otai_metadata_dispatcher_ring_t ring;
+
+    struct _otai_metadata_dispatcher_entry_t *next;
+
+} otai_metadata_dispatcher_entry_t;
+
+typedef struct _otai_metadata_dispatcher_t
+{
+    bool started;
+
+    bool stopping;
+
+    uint32_t inflight;
+
+    otai_metadata_dispatcher_policy_t policy;
+
+    otai_metadata_dispatcher_linecard_query_fn linecardquery;
+
+    otai_release_aps_switch_info_fn releaseswitchinfo;
+
+    /* ring size while rings are allocated, 0 otherwise */
+    uint32_t ringsize;
+
+    /* object table, chained hash */
+    otai_metadata_dispatcher_entry_t **buckets;
+
+    size_t bucketcount;
+
+    size_t entrycount;
+
+    /* object being created, its id is not known until create returns */
+    otai_metadata_dispatcher_entry_t *creating;
+
+    uint32_t nextindex;
+
+    /* notifications of unknown objects */
+    uint64_t dropped;
+
+    uint32_t threadindex[OTAI_METADATA_DISPATCHER_MAX_THREADS];
+
+    pthread_t threads[OTAI_METADATA_DISPATCHER_MAX_THREADS];
+
+    uint32_t threadcount;
+
+    /* incremented on each notification queued for thread */
+    uint64_t signals[OTAI_METADATA_DISPATCHER_MAX_THREADS];
+
+    /* entries of thread referenced during one pass */
+    otai_metadata_dispatcher_entry_t **snapshots[OTAI_METADATA_DISPATCHER_MAX_THREADS];
+
+    size_t snapshotsizes[OTAI_METADATA_DISPATCHER_MAX_THREADS];
+
+    uint32_t sleepers;
+
+    uint32_t waiters;
+
+} otai_metadata_dispatcher_t;
+
+/*
+ * Notification callbacks have no user context, so dispatcher is global.
+ */
+static otai_metadata_dispatcher_t otai_metadata_dispatcher_global;
+
+/*
+ * Protects object table and ring allocation.
+ */
+static pthread_rwlock_t otai_metadata_dispatcher_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+/*
+ * Serializes creates, so notification of unknown object during create
+ * belongs to object being created.
+ */
+static pthread_mutex_t otai_metadata_dispatcher_create_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Dispatcher threads wait on work condition, producers on room condition
+ * when ring is full, and stop on idle condition until no producer is
+ * pushing. Mutex and conditions live as long as the process, since
+ * producers may still touch them after stop.
+ */
+static pthread_mutex_t otai_metadata_dispatcher_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_cond_t otai_metadata_dispatcher_work_cond = PTHREAD_COND_INITIALIZER;
+
+static pthread_cond_t otai_metadata_dispatcher_room_cond = PTHREAD_COND_INITIALIZER;
+
+static pthread_cond_t otai_metadata_dispatcher_idle_cond = PTHREAD_COND_INITIALIZER;
+
+static bool otai_metadata_dispatcher_ring_enqueue(
+        _Inout_ otai_metadata_dispatcher_ring_t *ring,
+        _In_ otai_metadata_dispatcher_event_t *event)
+{
+    uint64_t pos = __atomic_load_n(&ring->enqueuepos, __ATOMIC_RELAXED);
+
+    for (;;)
+    {
+        otai_metadata_dispatcher_cell_t *cell = &ring->cells[pos & ring->mask];
+
+        uint64_t seq = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+
+        int64_t diff = (int64_t)(seq - pos);
+
+        if (diff == 0)
+        {
+            if (__atomic_compare_exchange_n(&ring->enqueuepos, &pos, pos + 1, true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            {
+                cell->event = event;
+
+                __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            return false;
+        }
+        else
+        {
+            pos = __atomic_load_n(&ring->enqueuepos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static otai_metadata_dispatcher_event_t* otai_metadata_dispatcher_ring_dequeue(
+        _Inout_ otai_metadata_dispatcher_ring_t *ring)
+{
+    uint64_t pos = __atomic_load_n(&ring->dequeuepos, __ATOMIC_RELAXED);
+
+    for (;;)
+    {
+        otai_metadata_dispatcher_cell_t *cell = &ring->cells[pos & ring->mask];
+
+        uint64_t seq = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+
+        int64_t diff = (int64_t)(seq - (pos + 1));
+
+        if (diff == 0)
+        {
+            if (__atomic_compare_exchange_n(&ring->dequeuepos, &pos, pos + 1, true, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            {
+                otai_metadata_dispatcher_event_t *event = cell->event;
+
+                __atomic_store_n(&cell->sequence, pos + ring->mask + 1, __ATOMIC_RELEASE);
+
+                return event;
+            }
+        }
+        else if (diff < 0)
+        {
+            return NULL;
+        }
+        else
+        {
+            pos = __atomic_load_n(&ring->dequeuepos, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static uint64_t otai_metadata_dispatcher_ring_depth(
+        _In_ otai_metadata_dispatcher_ring_t *ring)
+{
+    uint64_t dequeuepos = OTAI_METADATA_DISPATCHER_LOAD(&ring->dequeuepos);
+    uint64_t enqueuepos = OTAI_METADATA_DISPATCHER_LOAD(&ring->enqueuepos);
+
+    return (enqueuepos > dequeuepos) ? enqueuepos - dequeuepos : 0;
+}
+
+static bool otai_metadata_dispatcher_ring_alloc(
+        _Inout_ otai_metadata_dispatcher_ring_t *ring,
+        _In_ uint32_t ring_size)
+{
+    ring->cells = calloc(ring_size, sizeof(otai_metadata_dispatcher_cell_t));
+    ring->slots = calloc(OTAI_METADATA_DISPATCHER_COALESCE_SLOTS, sizeof(otai_metadata_dispatcher_slot_t));
+
+    if (ring->cells == NULL || ring->slots == NULL)
+    {
+        free(ring->cells);
+        free(ring->slots);
+
+        ring->cells = NULL;
+        ring->slots = NULL;
+
+        return false;
+    }
+
+    ring->mask = ring_size - 1;
+    ring->enqueuepos = 0;
+    ring->dequeuepos = 0;
+    ring->coalescepending = 0;
+
+    uint64_t pos = 0;
+
+    for (; pos <= ring->mask; pos++)
+    {
+        ring->cells[pos].sequence = pos;
+    }
+
+    return true;
+}
+
+/*
+ * Frees notification which is not dispatched. Switch info passed by
+ * reference is given back to adapter, since user will not see it.
+ */
+static void otai_metadata_dispatcher_event_free(
+        _In_ otai_metadata_dispatcher_event_t *event)
+{
+    otai_release_aps_switch_info_fn release = otai_metadata_dispatcher_global.releaseswitchinfo;
+
+    if (event->key.type == OTAI_METADATA_DISPATCHER_EVENT_APS_SWITCH_INFO_REF)
+    {
+        if (release != NULL)
+        {
+            release(event->data.switchinforef);
+        }
+        else
+        {
+            OTAI_META_LOG_ERROR("switch info of APS 0x%" PRIx64 " dropped without release function", event->key.id);
+        }
+    }
+
+    free(event);
+}
+
+/*
+ * Releases cells and slots with notifications still on them, counters are
+ * kept.
+ */
+static void otai_metadata_dispatcher_ring_free(
+        _Inout_ otai_metadata_dispatcher_ring_t *ring)
+{
+    otai_metadata_dispatcher_event_t *event;
+
+    if (ring->cells != NULL)
+    {
+        while ((event = otai_metadata_dispatcher_ring_dequeue(ring)) != NULL)
+        {
+            otai_metadata_dispatcher_event_free(event);
+        }
+    }
+
+    if (ring->slots != NULL)
+    {
+        size_t slot = 0;
+
+        for (; slot < OTAI_METADATA_DISPATCHER_COALESCE_SLOTS; slot++)
+        {
+            if (ring->slots[slot].event != NULL)
+            {
+                otai_metadata_dispatcher_event_free(ring->slots[slot].event);
+            }
+        }
+    }
+
+    free(ring->cells);
+    free(ring->slots);
+
+    ring->cells = NULL;
+    ring->slots = NULL;
+    ring->coalescepending = 0;
+}
+
+static bool otai_metadata_dispatcher_key_equal(
+        _In_ const otai_metadata_dispatcher_key_t *a,
+        _In_ const otai_metadata_dispatcher_key_t *b)
+{
+    return a->type == b->type && a->id == b->id && a->objectid == b->objectid && a->subkey == b->subkey;
+}
+
+static size_t otai_metadata_dispatcher_key_hash(
+        _In_ const otai_metadata_dispatcher_key_t *key)
+{
+    uint64_t h = key->id * 31 + key->objectid;
+
+    h = h * 31 + (uint64_t)key->type;
+    h = h * 31 + (uint32_t)key->subkey;
+
+    return (size_t)((h * UINT64_C(0x9E3779B97F4A7C15)) >> 32);
+}
+
+typedef enum _otai_metadata_dispatcher_coalesce_t
+{
+    OTAI_METADATA_DISPATCHER_COALESCE_NONE,
+
+    /* event took free slot */
+    OTAI_METADATA_DISPATCHER_COALESCE_PENDING,
+
+    /* event replaced pending event of the same key */
+    OTAI_METADATA_DISPATCHER_COALESCE_REPLACED,
+
+} otai_metadata_dispatcher_coalesce_t;
+
+/*
+ * Put event to coalesce slot of its key, older event in the slot is
+ * replaced. If only_pending is set, event is put only if there is already
+ * pending event of the same key, so newer event is not delivered before
+ * older one from the slot. Slot is freed when its event is dispatched, all
+ * probes are checked for the key, so key is never pending twice.
+ */
+static otai_metadata_dispatcher_coalesce_t otai_metadata_dispatcher_coalesce(
+        _Inout_ otai_metadata_dispatcher_ring_t *ring,
+        _In_ otai_metadata_dispatcher_event_t *event,
+        _In_ bool only_pending)
+{
+    size_t hash = otai_metadata_dispatcher_key_hash(&event->key);
+
+    otai_metadata_dispatcher_slot_t *empty = NULL;
+
+    pthread_mutex_lock(&ring->coalescelock);
+
+    size_t probe = 0;
+
+    for (; probe < OTAI_METADATA_DISPATCHER_COALESCE_PROBES; probe++)
+    {
+        otai_metadata_dispatcher_slot_t *slot = &ring->slots[(hash + probe) % OTAI_METADATA_DISPATCHER_COALESCE_SLOTS];
+
+        if (slot->event == NULL)
+        {
+            empty = (empty == NULL) ? slot : empty;
+
+            continue;
+        }
+
+        if (otai_metadata_dispatcher_key_equal(&slot->key, &event->key))
+        {
+            otai_metadata_dispatcher_event_free(slot->event);
+
+            slot->event = event;
+
+            pthread_mutex_unlock(&ring->coalescelock);
+
+            OTAI_METADATA_DISPATCHER_INC(&ring->coalesced);
+
+            return OTAI_METADATA_DISPATCHER_COALESCE_REPLACED;
+        }
+    }
+
+    if (only_pending || empty == NULL)
+    {
+        pthread_mutex_unlock(&ring->coalescelock);
+
+        return OTAI_METADATA_DISPATCHER_COALESCE_NONE;
+    }
+
+    empty->key = event->key;
+    empty->event = event;
+
+    OTAI_METADATA_DISPATCHER_INC(&ring->coalescepending);
+
+    pthread_mutex_unlock(&ring->coalescelock);
+
+    return OTAI_METADATA_DISPATCHER_COALESCE_PENDING;
+}
+
+static otai_metadata_dispatcher_event_t* otai_metadata_dispatcher_coalesce_take(
+        _Inout_ otai_metadata_dispatcher_ring_t *ring,
+        _In_ size_t idx)
+{
+    pthread_mutex_lock(&ring->coalescelock);
+
+    otai_metadata_dispatcher_event_t *event = ring->slots[idx].event;
+
+    if (event != NULL)
+    {
+        ring->slots[idx].event = NULL;
+
+        OTAI_METADATA_DISPATCHER_DEC(&ring->coalescepending);
+    }
+
+    pthread_mutex_unlock(&ring->coalescelock);
+
+    return event;
+}
+
+/* object table */
+
+static size_t otai_metadata_dispatcher_bucket(
+        _In_ const otai_metadata_dispatcher_t *dispatcher,
+        _In_ otai_object_id_t object_id)
+{
+    return (size_t)((object_id * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & (dispatcher->bucketcount - 1);
+}
+
+static otai_metadata_dispatcher_entry_t* otai_metadata_dispatcher_find(
+        _In_ const otai_metadata_dispatcher_t *dispatcher,
+        _In_ otai_object_id_t object_id)
+{
+    if (dispatcher->bucketcount == 0)
+    {
+        return NULL;
+    }
+
+    otai_metadata_dispatcher_entry_t *entry = dispatcher->buckets[otai_metadata_dispatcher_bucket(dispatcher, object_id)];
+
+    while (entry != NULL && entry->objectid != object_id)
+    {
+        entry = entry->next;
+    }
+
+    return entry;
+}
+
+static otai_metadata_dispatcher_entry_t* otai_metadata_dispatcher_unlink(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher,
+        _In_ otai_object_id_t object_id)
+{
+    if (dispatcher->bucketcount == 0)
+    {
+        return NULL;
+    }
+
+    otai_metadata_dispatcher_entry_t **link = &dispatcher->buckets[otai_metadata_dispatcher_bucket(dispatcher, object_id)];
+
+    while (*link != NULL && (*link)->objectid != object_id)
+    {
+        link = &(*link)->next;
+    }
+
+    otai_metadata_dispatcher_entry_t *entry = *link;
+
+    if (entry != NULL)
+    {
+        *link = entry->next;
+
+        entry->next = NULL;
+
+        dispatcher->entrycount--;
+    }
+
+    return entry;
+}
+
+static void otai_metadata_dispatcher_grow(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher)
+{
+    size_t count = (dispatcher->bucketcount == 0) ? OTAI_METADATA_DISPATCHER_MIN_BUCKETS : 2 * dispatcher->bucketcount;
+
+    otai_metadata_dispatcher_entry_t **buckets = calloc(count, sizeof(otai_metadata_dispatcher_entry_t*));
+
+    if (buckets == NULL)
+    {
+        /* longer chains are still correct */
+
+        return;
+    }
+
+    otai_metadata_dispatcher_entry_t **old = dispatcher->buckets;
+
+    size_t oldcount = dispatcher->bucketcount;
+
+    dispatcher->buckets = buckets;
+    dispatcher->bucketcount = count;
+
+    size_t idx = 0;
+
+    for (; idx < oldcount; idx++)
+    {
+        while (old[idx] != NULL)
+        {
+            otai_metadata_dispatcher_entry_t *entry = old[idx];
+
+            old[idx] = entry->next;
+
+            size_t bucket = otai_metadata_dispatcher_bucket(dispatcher, entry->objectid);
+
+            entry->next = buckets[bucket];
+            buckets[bucket] = entry;
+        }
+    }
+
+    free(old);
+}
+
+static void otai_metadata_dispatcher_release(
+        _Inout_ otai_metadata_dispatcher_entry_t *entry)
+{
+    if (OTAI_METADATA_DISPATCHER_DEC(&entry->refs) != 1)
+    {
+        return;
+    }
+
+    /* notifications still queued for removed object are dropped */
+
+    otai_metadata_dispatcher_ring_free(&entry->ring);
+
+    pthread_mutex_destroy(&entry->ring.coalescelock);
+
+    free(entry);
+}
+
+/*
+ * Inserts entry under its object id, entry of removed object which was
+ * not passed to otai_metadata_dispatcher_remove() is replaced.
+ */
+static bool otai_metadata_dispatcher_insert(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher,
+        _Inout_ otai_metadata_dispatcher_entry_t *entry)
+{
+    otai_metadata_dispatcher_entry_t *old = otai_metadata_dispatcher_unlink(dispatcher, entry->objectid);
+
+    if (old != NULL)
+    {
+        OTAI_META_LOG_WARN("object 0x%" PRIx64 " was not removed from dispatcher", entry->objectid);
+
+        otai_metadata_dispatcher_release(old);
+    }
+
+    if (dispatcher->entrycount >= dispatcher->bucketcount)
+    {
+        otai_metadata_dispatcher_grow(dispatcher);
+    }
+
+    if (dispatcher->bucketcount == 0)
+    {
+        OTAI_META_LOG_ERROR("failed to allocate dispatcher object table");
+
+        return false;
+    }
+
+    size_t bucket = otai_metadata_dispatcher_bucket(dispatcher, entry->objectid);
+
+    entry->next = dispatcher->buckets[bucket];
+
+    dispatcher->buckets[bucket] = entry;
+
+    dispatcher->entrycount++;
+
+    /* ring of object created between start and end of create */
+
+    if (dispatcher->ringsize != 0 && entry->ring.cells == NULL &&
+            !otai_metadata_dispatcher_ring_alloc(&entry->ring, dispatcher->ringsize))
+    {
+        OTAI_META_LOG_ERROR("failed to allocate ring of object 0x%" PRIx64 ", notifications will be dropped", entry->objectid);
+    }
+
+    return true;
+}
+
+/*
+ * Takes reference of object entry. If object is unknown and bind is set,
+ * object being created gets the id, since adapter may notify before create
+ * returns.
+ */
+static otai_metadata_dispatcher_entry_t* otai_metadata_dispatcher_acquire(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher,
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t object_id,
+        _In_ bool bind)
+{
+    pthread_rwlock_rdlock(&otai_metadata_dispatcher_lock);
+
+    otai_metadata_dispatcher_entry_t *entry = otai_metadata_dispatcher_find(dispatcher, object_id);
+
+    if (entry != NULL && entry->objecttype == object_type)
+    {
+        OTAI_METADATA_DISPATCHER_INC(&entry->refs);
+
+        pthread_rwlock_unlock(&otai_metadata_dispatcher_lock);
+
+        return entry;
+    }
+
+    pthread_rwlock_unlock(&otai_metadata_dispatcher_lock);
+
+    if (entry != NULL || !bind)
+    {
+        return NULL;
+    }
+
+    pthread_rwlock_wrlock(&otai_metadata_dispatcher_lock);
+
+    entry = otai_metadata_dispatcher_find(dispatcher, object_id);
+
+    otai_metadata_dispatcher_entry_t *creating = dispatcher->creating;
+
+    if (entry == NULL && creating != NULL && creating->objecttype == object_type &&
+            creating->objectid == OTAI_NULL_OBJECT_ID)
+    {
+        creating->objectid = object_id;
+
+        if (otai_metadata_dispatcher_insert(dispatcher, creating))
+        {
+            entry = creating;
+        }
+        else
+        {
+            creating->objectid = OTAI_NULL_OBJECT_ID;
+        }
+    }
+
+    if (entry != NULL && entry->objecttype == object_type)
+    {
+        OTAI_METADATA_DISPATCHER_INC(&entry->refs);
+    }
+    else
+    {
+        entry = NULL;
+    }
+
+    pthread_rwlock_unlock(&otai_metadata_dispatcher_lock);
+
+    return entry;
+}
+
+static void otai_metadata_dispatcher_wake(
+        _Inout_ pthread_cond_t *cond,
+        _In_ uint32_t *waiting)
+{
+    if (OTAI_METADATA_DISPATCHER_LOAD(waiting) == 0)
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&otai_metadata_dispatcher_mutex);
+    pthread_cond_broadcast(cond);
+    pthread_mutex_unlock(&otai_metadata_dispatcher_mutex);
+}
+
+/*
+ * Signal is counted before sleepers are checked, dispatcher thread counts
+ * itself as sleeper before it checks signals, so wakeup is not lost.
+ */
+static void otai_metadata_dispatcher_signal(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher,
+        _In_ const otai_metadata_dispatcher_entry_t *entry)
+{
+    OTAI_METADATA_DISPATCHER_INC(&dispatcher->signals[entry->index % dispatcher->threadcount]);
+
+    otai_metadata_dispatcher_wake(&otai_metadata_dispatcher_work_cond, &dispatcher->sleepers);
+}
+
+static void otai_metadata_dispatcher_wait_room(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher,
+        _Inout_ otai_metadata_dispatcher_ring_t *ring)
+{
+    OTAI_METADATA_DISPATCHER_INC(&ring->blocked);
+
+    pthread_mutex_lock(&otai_metadata_dispatcher_mutex);
+
+    OTAI_METADATA_DISPATCHER_INC(&dispatcher->waiters);
+
+    while (otai_metadata_dispatcher_ring_depth(ring) > ring->mask &&
+            !OTAI_METADATA_DISPATCHER_LOAD(&dispatcher->stopping))
+    {
+        pthread_cond_wait(&otai_metadata_dispatcher_room_cond, &otai_metadata_dispatcher_mutex);
+    }
+
+    OTAI_METADATA_DISPATCHER_DEC(&dispatcher->waiters);
+
+    pthread_mutex_unlock(&otai_metadata_dispatcher_mutex);
+}
+
+static void otai_metadata_dispatcher_push(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher,
+        _Inout_ otai_metadata_dispatcher_entry_t *entry,
+        _In_ otai_metadata_dispatcher_event_t *event)
+{
+    otai_metadata_dispatcher_ring_t *ring = &entry->ring;
+
+    otai_metadata_dispatcher_policy_t policy = dispatcher->policy;
+
+    if (ring->cells == NULL)
+    {
+        otai_metadata_dispatcher_event_free(event);
+
+        OTAI_METADATA_DISPATCHER_INC(&ring->dropped);
+
+        return;
+    }
+
+    /* replaced notification is counted as coalesced, not as enqueued */
+
+    if (policy == OTAI_METADATA_DISPATCHER_POLICY_COALESCE &&
+            OTAI_METADATA_DISPATCHER_LOAD(&ring->coalescepending) != 0 &&
+            otai_metadata_dispatcher_coalesce(ring, event, true) == OTAI_METADATA_DISPATCHER_COALESCE_REPLACED)
+    {
+        otai_metadata_dispatcher_signal(dispatcher, entry);
+
+        return;
+    }
+
+    bool queued = false;
+
+    while (!queued && !otai_metadata_dispatcher_ring_enqueue(ring, event))
+    {
+        otai_metadata_dispatcher_event_t *old;
+
+        switch (policy)
+        {
+            case OTAI_METADATA_DISPATCHER_POLICY_DROP_OLDEST:
+
+                old = otai_metadata_dispatcher_ring_dequeue(ring);
+
+                if (old != NULL)
+                {
+                    otai_metadata_dispatcher_event_free(old);
+
+                    OTAI_METADATA_DISPATCHER_INC(&ring->dropped);
+                }
+
+                break;
+
+            case OTAI_METADATA_DISPATCHER_POLICY_COALESCE:
+
+                switch (otai_metadata_dispatcher_coalesce(ring, event, false))
+                {
+                    case OTAI_METADATA_DISPATCHER_COALESCE_REPLACED:
+
+                        otai_metadata_dispatcher_signal(dispatcher, entry);
+
+                        return;
+
+                    case OTAI_METADATA_DISPATCHER_COALESCE_PENDING:
+
+                        queued = true;
+
+                        break;
+
+                    default:
+
+                        otai_metadata_dispatcher_event_free(event);
+
+                        OTAI_METADATA_DISPATCHER_INC(&ring->dropped);
+
+                        return;
+                }
+
+                break;
+
+            case OTAI_METADATA_DISPATCHER_POLICY_BLOCK:
+
+                otai_metadata_dispatcher_wait_room(dispatcher, ring);
+
+                break;
+
+            default:
+
+                otai_metadata_dispatcher_event_free(event);
+
+                OTAI_METADATA_DISPATCHER_INC(&ring->dropped);
+
+                return;
+        }
+    }
+
+    OTAI_METADATA_DISPATCHER_INC(&ring->enqueued);
+
+    otai_metadata_dispatcher_signal(dispatcher, entry);
+}
+
+static void otai_metadata_dispatcher_dispatch(
+        _Inout_ otai_metadata_dispatcher_ring_t *ring,
+        _In_ otai_metadata_dispatcher_event_t *event)
+{
+    otai_metadata_dispatcher_handler_t *handler = &event->handler;
+
+    switch (event->key.type)
+    {
+        case OTAI_METADATA_DISPATCHER_EVENT_LINECARD_STATE_CHANGE:
+            handler->statechange(event->key.id, event->data.operstatus);
+            break;
+
+        case OTAI_METADATA_DISPATCHER_EVENT_LINECARD_ALARM:
+            handler->alarm(event->key.id, event->data.alarm.type, event->data.alarm.info);
+            break;
+
+        case OTAI_METADATA_DISPATCHER_EVENT_LINECARD_OCM_SPECTRUM_POWER:
+            handler->spectrum(event->key.id, event->key.objectid, event->data.spectrum);
+            break;
+
+        case OTAI_METADATA_DISPATCHER_EVENT_LINECARD_OTDR_RESULT:
+            handler->otdr(event->key.id, event->key.objectid, event->data.otdr);
+            break;
+
+        case OTAI_METADATA_DISPATCHER_EVENT_APS_SWITCH_INFO:
+            handler->switchinfo(event->key.id, event->data.switchinfo);
+            break;
+
+        case OTAI_METADATA_DISPATCHER_EVENT_APS_SWITCH_INFO_REF:
+            handler->switchinforef(event->key.id, event->data.switchinforef);
+            break;
+
+        default:
+            OTAI_META_LOG_ERROR("unknown notification type %d", event->key.type);
+            break;
+    }
+
+    free(event);
+
+    OTAI_METADATA_DISPATCHER_INC(&ring->dispatched);
+
+    otai_metadata_dispatcher_wake(&otai_metadata_dispatcher_room_cond, &otai_metadata_dispatcher_global.waiters);
+}
+
+static bool otai_metadata_dispatcher_drain(
+        _Inout_ otai_metadata_dispatcher_ring_t *ring)
+{
+    bool work = false;
+
+    int count = 0;
+
+    otai_metadata_dispatcher_event_t *event;
+
+    if (ring->cells == NULL)
+    {
+        return false;
+    }
+
+    while (count++ < OTAI_METADATA_DISPATCHER_BATCH &&
+            (event = otai_metadata_dispatcher_ring_dequeue(ring)) != NULL)
+    {
+        otai_metadata_dispatcher_dispatch(ring, event);
+
+        work = true;
+    }
+
+    if (otai_metadata_dispatcher_ring_depth(ring) != 0 ||
+            OTAI_METADATA_DISPATCHER_LOAD(&ring->coalescepending) == 0)
+    {
+        return work;
+    }
+
+    /* coalesced notifications are newer than all notifications on the ring */
+
+    size_t idx = 0;
+
+    for (; idx < OTAI_METADATA_DISPATCHER_COALESCE_SLOTS; idx++)
+    {
+        event = otai_metadata_dispatcher_coalesce_take(ring, idx);
+
+        if (event != NULL)
+        {
+            otai_metadata_dispatcher_dispatch(ring, event);
+
+            work = true;
+        }
+    }
+
+    return work;
+}
+
+/*
+ * Entries of thread are referenced under table lock and drained without
+ * it, so user callback may create or remove objects.
+ */
+static bool otai_metadata_dispatcher_drain_thread(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher,
+        _In_ uint32_t index)
+{
+    size_t count = 0;
+
+    pthread_rwlock_rdlock(&otai_metadata_dispatcher_lock);
+
+    if (dispatcher->snapshotsizes[index] < dispatcher->entrycount)
+    {
+        otai_metadata_dispatcher_entry_t **snapshot = realloc(dispatcher->snapshots[index],
+                dispatcher->entrycount * sizeof(otai_metadata_dispatcher_entry_t*));
+
+        if (snapshot != NULL)
+        {
+            dispatcher->snapshots[index] = snapshot;
+            dispatcher->snapshotsizes[index] = dispatcher->entrycount;
+        }
+    }
+
+    size_t bucket = 0;
+
+    for (; bucket < dispatcher->bucketcount; bucket++)
+    {
+        otai_metadata_dispatcher_entry_t *entry = dispatcher->buckets[bucket];
+
+        for (; entry != NULL && count < dispatcher->snapshotsizes[index]; entry = entry->next)
+        {
+            if (entry->index % dispatcher->threadcount == index)
+            {
+                OTAI_METADATA_DISPATCHER_INC(&entry->refs);
+
+                dispatcher->snapshots[index][count++] = entry;
+            }
+        }
+    }
+
+    pthread_rwlock_unlock(&otai_metadata_dispatcher_lock);
+
+    bool work = false;
+
+    size_t idx = 0;
+
+    for (; idx < count; idx++)
+    {
+        work |= otai_metadata_dispatcher_drain(&dispatcher->snapshots[index][idx]->ring);
+
+        otai_metadata_dispatcher_release(dispatcher->snapshots[index][idx]);
+    }
+
+    return work;
+}
+
+static void* otai_metadata_dispatcher_thread(
+        _In_ void *arg)
+{
+    otai_metadata_dispatcher_t *dispatcher = &otai_metadata_dispatcher_global;
+
+    uint32_t index = *(const uint32_t*)arg;
+
+    for (;;)
+    {
+        uint64_t seen = OTAI_METADATA_DISPATCHER_LOAD(&dispatcher->signals[index]);
+
+        if (otai_metadata_dispatcher_drain_thread(dispatcher, index))
+        {
+            continue;
+        }
+
+        /*
+         * Stopping is set when no producer is pushing, so nothing is left if
+         * no notification was signaled since last pass.
+         */
+
+        if (OTAI_METADATA_DISPATCHER_LOAD(&dispatcher->stopping) &&
+                OTAI_METADATA_DISPATCHER_LOAD(&dispatcher->signals[index]) == seen)
+        {
+            return NULL;
+        }
+
+        pthread_mutex_lock(&otai_metadata_dispatcher_mutex);
+
+        OTAI_METADATA_DISPATCHER_INC(&dispatcher->sleepers);
+
+        while (OTAI_METADATA_DISPATCHER_LOAD(&dispatcher->signals[index]) == seen &&
+                !OTAI_METADATA_DISPATCHER_LOAD(&dispatcher->stopping))
+        {
+            pthread_cond_wait(&otai_metadata_dispatcher_work_cond, &otai_metadata_dispatcher_mutex);
+        }
+
+        OTAI_METADATA_DISPATCHER_DEC(&dispatcher->sleepers);
+
+        pthread_mutex_unlock(&otai_metadata_dispatcher_mutex);
+    }
+}
+
+/*
+ * Producers are counted, so stop can wait until no adapter thread is
+ * pushing to rings.
+ */
+static void otai_metadata_dispatcher_leave(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher)
+{
+    if (OTAI_METADATA_DISPATCHER_DEC(&dispatcher->inflight) == 1 &&
+            !OTAI_METADATA_DISPATCHER_LOAD(&dispatcher->started))
+    {
+        pthread_mutex_lock(&otai_metadata_dispatcher_mutex);
+        pthread_cond_broadcast(&otai_metadata_dispatcher_idle_cond);
+        pthread_mutex_unlock(&otai_metadata_dispatcher_mutex);
+    }
+}
+
+static bool otai_metadata_dispatcher_enter(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher)
+{
+    OTAI_METADATA_DISPATCHER_INC(&dispatcher->inflight);
+
+    if (OTAI_METADATA_DISPATCHER_LOAD(&dispatcher->started))
+    {
+        return true;
+    }
+
+    otai_metadata_dispatcher_leave(dispatcher);
+
+    return false;
+}
+
+static otai_metadata_dispatcher_event_t* otai_metadata_dispatcher_event_alloc(
+        _In_ otai_metadata_dispatcher_event_type_t type,
+        _In_ otai_object_id_t id,
+        _In_ otai_object_id_t object_id,
+        _In_ size_t data_size,
+        _In_ size_t extra_size)
+{
+    size_t size = OTAI_METADATA_DISPATCHER_ALIGN(offsetof(otai_metadata_dispatcher_event_t, data) + data_size);
+
+    otai_metadata_dispatcher_event_t *event = malloc(size + extra_size);
+
+    if (event != NULL)
+    {
+        event->key.type = type;
+        event->key.id = id;
+        event->key.objectid = object_id;
+        event->key.subkey = 0;
+    }
+
+    return event;
+}
+
+static void* otai_metadata_dispatcher_event_copy(
+        _Inout_ uint8_t **extra,
+        _In_ const void *list,
+        _In_ size_t size)
+{
+    void *ptr = *extra;
+
+    if (list == NULL || size == 0)
+    {
+        return NULL;
+    }
+
+    memcpy(ptr, list, size);
+
+    *extra += OTAI_METADATA_DISPATCHER_ALIGN(size);
+
+    return ptr;
+}
+
+static uint8_t* otai_metadata_dispatcher_event_extra(
+        _In_ otai_metadata_dispatcher_event_t *event,
+        _In_ size_t data_size)
+{
+    return (uint8_t*)event + OTAI_METADATA_DISPATCHER_ALIGN(offsetof(otai_metadata_dispatcher_event_t, data) + data_size);
+}
+
+static void otai_metadata_dispatcher_queue(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher,
+        _Inout_ otai_metadata_dispatcher_entry_t *entry,
+        _In_ otai_metadata_dispatcher_event_t *event)
+{
+    if (event == NULL)
+    {
+        OTAI_META_LOG_ERROR("failed to allocate notification, dropped");
+
+        OTAI_METADATA_DISPATCHER_INC(&entry->ring.dropped);
+
+        return;
+    }
+
+    otai_metadata_dispatcher_push(dispatcher, entry, event);
+}
+
+/*
+ * Notification of object which was not created through dispatcher, or
+ * was already removed.
+ */
+static void otai_metadata_dispatcher_drop_unknown(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher,
+        _In_ otai_object_id_t object_id)
+{
+    OTAI_META_LOG_DEBUG("notification of unknown object 0x%" PRIx64 " dropped", object_id);
+
+    OTAI_METADATA_DISPATCHER_INC(&dispatcher->dropped);
+}
+
+static void otai_metadata_dispatcher_on_linecard_state_change(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_oper_status_t linecard_oper_status)
+{
+    otai_metadata_dispatcher_t *dispatcher = &otai_metadata_dispatcher_global;
+
+    otai_metadata_dispatcher_entry_t *entry = otai_metadata_dispatcher_acquire(dispatcher, OTAI_OBJECT_TYPE_LINECARD, linecard_id, true);
+
+    if (entry == NULL)
+    {
+        otai_metadata_dispatcher_drop_unknown(dispatcher, linecard_id);
+
+        return;
+    }
+
+    if (!otai_metadata_dispatcher_enter(dispatcher))
+    {
+        entry->handlers.statechange(linecard_id, linecard_oper_status);
+
+        otai_metadata_dispatcher_release(entry);
+
+        return;
+    }
+
+    otai_metadata_dispatcher_event_t *event = otai_metadata_dispatcher_event_alloc(
+            OTAI_METADATA_DISPATCHER_EVENT_LINECARD_STATE_CHANGE, linecard_id, OTAI_NULL_OBJECT_ID,
+            sizeof(otai_oper_status_t), 0);
+
+    if (event != NULL)
+    {
+        event->handler.statechange = entry->handlers.statechange;
+        event->data.operstatus = linecard_oper_status;
+    }
+
+    otai_metadata_dispatcher_queue(dispatcher, entry, event);
+
+    otai_metadata_dispatcher_leave(dispatcher);
+
+    otai_metadata_dispatcher_release(entry);
+}
+
+static void otai_metadata_dispatcher_on_linecard_alarm(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_alarm_type_t alarm_type,
+        _In_ otai_alarm_info_t alarm_info)
+{
+    otai_metadata_dispatcher_t *dispatcher = &otai_metadata_dispatcher_global;
+
+    otai_metadata_dispatcher_entry_t *entry = otai_metadata_dispatcher_acquire(dispatcher, OTAI_OBJECT_TYPE_LINECARD, linecard_id, true);
+
+    if (entry == NULL)
+    {
+        otai_metadata_dispatcher_drop_unknown(dispatcher, linecard_id);
+
+        return;
+    }
+
+    if (!otai_metadata_dispatcher_enter(dispatcher))
+    {
+        entry->handlers.alarm(linecard_id, alarm_type, alarm_info);
+
+        otai_metadata_dispatcher_release(entry);
+
+        return;
+    }
+
+    size_t textsize = sizeof(int8_t) * alarm_info.text.count;
+
+    otai_metadata_dispatcher_event_t *event = otai_metadata_dispatcher_event_alloc(
+            OTAI_METADATA_DISPATCHER_EVENT_LINECARD_ALARM, linecard_id, alarm_info.resource_oid,
+            sizeof(otai_metadata_dispatcher_alarm_t), OTAI_METADATA_DISPATCHER_ALIGN(textsize));
+
+    if (event != NULL)
+    {
+        uint8_t *extra = otai_metadata_dispatcher_event_extra(event, sizeof(otai_metadata_dispatcher_alarm_t));
+
+        event->handler.alarm = entry->handlers.alarm;
+        event->key.subkey = alarm_type;
+        event->data.alarm.type = alarm_type;
+        event->data.alarm.info = alarm_info;
+        event->data.alarm.info.text.list = otai_metadata_dispatcher_event_copy(&extra, alarm_info.text.list, textsize);
+    }
+
+    otai_metadata_dispatcher_queue(dispatcher, entry, event);
+
+    otai_metadata_dispatcher_leave(dispatcher);
+
+    otai_metadata_dispatcher_release(entry);
+}
+
+static void otai_metadata_dispatcher_on_linecard_ocm_spectrum_power(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_object_id_t ocm_id,
+        _In_ otai_spectrum_power_list_t ocm_result)
+{
+    otai_metadata_dispatcher_t *dispatcher = &otai_metadata_dispatcher_global;
+
+    otai_metadata_dispatcher_entry_t *entry = otai_metadata_dispatcher_acquire(dispatcher, OTAI_OBJECT_TYPE_LINECARD, linecard_id, true);
+
+    if (entry == NULL)
+    {
+        otai_metadata_dispatcher_drop_unknown(dispatcher, linecard_id);
+
+        return;
+    }
+
+    if (!otai_metadata_dispatcher_enter(dispatcher))
+    {
+        entry->handlers.spectrum(linecard_id, ocm_id, ocm_result);
+
+        otai_metadata_dispatcher_release(entry);
+
+        return;
+    }
+
+    size_t listsize = sizeof(otai_spectrum_power_t) * ocm_result.count;
+
+    otai_metadata_dispatcher_event_t *event = otai_metadata_dispatcher_event_alloc(
+            OTAI_METADATA_DISPATCHER_EVENT_LINECARD_OCM_SPECTRUM_POWER, linecard_id, ocm_id,
+            sizeof(otai_spectrum_power_list_t), OTAI_METADATA_DISPATCHER_ALIGN(listsize));
+
+    if (event != NULL)
+    {
+        uint8_t *extra = otai_metadata_dispatcher_event_extra(event, sizeof(otai_spectrum_power_list_t));
+
+        event->handler.spectrum = entry->handlers.spectrum;
+        event->data.spectrum.count = ocm_result.count;
+        event->data.spectrum.list = otai_metadata_dispatcher_event_copy(&extra, ocm_result.list, listsize);
+    }
+
+    otai_metadata_dispatcher_queue(dispatcher, entry, event);
+
+    otai_metadata_dispatcher_leave(dispatcher);
+
+    otai_metadata_dispatcher_release(entry);
+}
+
+static void otai_metadata_dispatcher_on_linecard_otdr_result(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_object_id_t otdr_id,
+        _In_ otai_otdr_result_t otdr_result)
+{
+    otai_metadata_dispatcher_t *dispatcher = &otai_metadata_dispatcher_global;
+
+    otai_metadata_dispatcher_entry_t *entry = otai_metadata_dispatcher_acquire(dispatcher, OTAI_OBJECT_TYPE_LINECARD, linecard_id, true);
+
+    if (entry == NULL)
+    {
+        otai_metadata_dispatcher_drop_unknown(dispatcher, linecard_id);
+
+        return;
+    }
+
+    if (!otai_metadata_dispatcher_enter(dispatcher))
+    {
+        entry->handlers.otdr(linecard_id, otdr_id, otdr_result);
+
+        otai_metadata_dispatcher_release(entry);
+
+        return;
+    }
+
+    size_t eventssize = sizeof(otai_otdr_event_t) * otdr_result.events.events.count;
+    size_t tracesize = sizeof(uint8_t) * otdr_result.trace.data.count;
+
+    otai_metadata_dispatcher_event_t *event = otai_metadata_dispatcher_event_alloc(
+            OTAI_METADATA_DISPATCHER_EVENT_LINECARD_OTDR_RESULT, linecard_id, otdr_id,
+            sizeof(otai_otdr_result_t), OTAI_METADATA_DISPATCHER_ALIGN(eventssize) + OTAI_METADATA_DISPATCHER_ALIGN(tracesize));
+
+    if (event != NULL)
+    {
+        uint8_t *extra = otai_metadata_dispatcher_event_extra(event, sizeof(otai_otdr_result_t));
+
+        event->handler.otdr = entry->handlers.otdr;
+        event->data.otdr = otdr_result;
+        event->data.otdr.events.events.list = otai_metadata_dispatcher_event_copy(&extra, otdr_result.events.events.list, eventssize);
+        event->data.otdr.trace.data.list = otai_metadata_dispatcher_event_copy(&extra, otdr_result.trace.data.list, tracesize);
+    }
+
+    otai_metadata_dispatcher_queue(dispatcher, entry, event);
+
+    otai_metadata_dispatcher_leave(dispatcher);
+
+    otai_metadata_dispatcher_release(entry);
+}
+
+/*
+ * APS notification is kept in order with notifications of its linecard.
+ */
+static void otai_metadata_dispatcher_queue_aps(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher,
+        _Inout_ otai_metadata_dispatcher_entry_t *entry,
+        _In_ otai_metadata_dispatcher_event_t *event)
+{
+    otai_metadata_dispatcher_entry_t *ringentry = NULL;
+
+    if (dispatcher->linecardquery != NULL)
+    {
+        otai_object_id_t linecard_id = dispatcher->linecardquery(entry->objectid);
+
+        if (linecard_id != OTAI_NULL_OBJECT_ID)
+        {
+            ringentry = otai_metadata_dispatcher_acquire(dispatcher, OTAI_OBJECT_TYPE_LINECARD, linecard_id, false);
+        }
+    }
+
+    otai_metadata_dispatcher_queue(dispatcher, (ringentry != NULL) ? ringentry : entry, event);
+
+    if (ringentry != NULL)
+    {
+        otai_metadata_dispatcher_release(ringentry);
+    }
+}
+
+static void otai_metadata_dispatcher_on_aps_switch_info(
+        _In_ otai_object_id_t aps_id,
+        _In_ otai_olp_switch_t switch_info)
+{
+    otai_metadata_dispatcher_t *dispatcher = &otai_metadata_dispatcher_global;
+
+    otai_metadata_dispatcher_entry_t *entry = otai_metadata_dispatcher_acquire(dispatcher, OTAI_OBJECT_TYPE_APS, aps_id, true);
+
+    if (entry == NULL)
+    {
+        otai_metadata_dispatcher_drop_unknown(dispatcher, aps_id);
+
+        return;
+    }
+
+    if (!otai_metadata_dispatcher_enter(dispatcher))
+    {
+        entry->handlers.switchinfo(aps_id, switch_info);
+
+        otai_metadata_dispatcher_release(entry);
+
+        return;
+    }
+
+    otai_metadata_dispatcher_event_t *event = otai_metadata_dispatcher_event_alloc(
+            OTAI_METADATA_DISPATCHER_EVENT_APS_SWITCH_INFO, aps_id, OTAI_NULL_OBJECT_ID,
+            sizeof(otai_olp_switch_t), 0);
+
+    if (event != NULL)
+    {
+        event->handler.switchinfo = entry->handlers.switchinfo;
+        event->data.switchinfo = switch_info;
+    }
+
+    otai_metadata_dispatcher_queue_aps(dispatcher, entry, event);
+
+    otai_metadata_dispatcher_leave(dispatcher);
+
+    otai_metadata_dispatcher_release(entry);
+}
+
+/*
+ * Only pointer to adapter buffer is queued. Buffer is released by user
+ * handler, or by dispatcher if notification is dropped.
+ */
+static void otai_metadata_dispatcher_on_aps_switch_info_ref(
+        _In_ otai_object_id_t aps_id,
+        _In_ const otai_olp_switch_t *switch_info)
+{
+    otai_metadata_dispatcher_t *dispatcher = &otai_metadata_dispatcher_global;
+
+    otai_metadata_dispatcher_entry_t *entry = otai_metadata_dispatcher_acquire(dispatcher, OTAI_OBJECT_TYPE_APS, aps_id, true);
+
+    if (entry == NULL)
+    {
+        otai_metadata_dispatcher_drop_unknown(dispatcher, aps_id);
+
+        if (dispatcher->releaseswitchinfo != NULL)
+        {
+            dispatcher->releaseswitchinfo(switch_info);
+        }
+
+        return;
+    }
+
+    if (!otai_metadata_dispatcher_enter(dispatcher))
+    {
+        entry->handlers.switchinforef(aps_id, switch_info);
+
+        otai_metadata_dispatcher_release(entry);
+
+        return;
+    }
+
+    otai_metadata_dispatcher_event_t *event = otai_metadata_dispatcher_event_alloc(
+            OTAI_METADATA_DISPATCHER_EVENT_APS_SWITCH_INFO_REF, aps_id, OTAI_NULL_OBJECT_ID,
+            sizeof(const otai_olp_switch_t*), 0);
+
+    if (event != NULL)
+    {
+        event->handler.switchinforef = entry->handlers.switchinforef;
+        event->data.switchinforef = switch_info;
+    }
+    else if (dispatcher->releaseswitchinfo != NULL)
+    {
+        dispatcher->releaseswitchinfo(switch_info);
+    }
+
+    otai_metadata_dispatcher_queue_aps(dispatcher, entry, event);
+
+    otai_metadata_dispatcher_leave(dispatcher);
+
+    otai_metadata_dispatcher_release(entry);
+}
+
+/*
+ * Called with table lock held for write, when no producer or dispatcher
+ * thread uses rings.
+ */
+static void otai_metadata_dispatcher_free_rings(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher)
+{
+    size_t bucket = 0;
+
+    for (; bucket < dispatcher->bucketcount; bucket++)
+    {
+        otai_metadata_dispatcher_entry_t *entry = dispatcher->buckets[bucket];
+
+        for (; entry != NULL; entry = entry->next)
+        {
+            otai_metadata_dispatcher_ring_free(&entry->ring);
+        }
+    }
+
+    if (dispatcher->creating != NULL)
+    {
+        otai_metadata_dispatcher_ring_free(&dispatcher->creating->ring);
+    }
+
+    dispatcher->ringsize = 0;
+}
+
+static otai_status_t otai_metadata_dispatcher_alloc_rings(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher,
+        _In_ uint32_t ring_size)
+{
+    dispatcher->ringsize = ring_size;
+
+    size_t bucket = 0;
+
+    for (; bucket < dispatcher->bucketcount; bucket++)
+    {
+        otai_metadata_dispatcher_entry_t *entry = dispatcher->buckets[bucket];
+
+        for (; entry != NULL; entry = entry->next)
+        {
+            if (!otai_metadata_dispatcher_ring_alloc(&entry->ring, ring_size))
+            {
+                otai_metadata_dispatcher_free_rings(dispatcher);
+
+                return OTAI_STATUS_NO_MEMORY;
+            }
+        }
+    }
+
+    if (dispatcher->creating != NULL &&
+            !otai_metadata_dispatcher_ring_alloc(&dispatcher->creating->ring, ring_size))
+    {
+        otai_metadata_dispatcher_free_rings(dispatcher);
+
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static void otai_metadata_dispatcher_join_threads(
+        _Inout_ otai_metadata_dispatcher_t *dispatcher,
+        _In_ uint32_t count)
+{
+    pthread_mutex_lock(&otai_metadata_dispatcher_mutex);
+
+    OTAI_METADATA_DISPATCHER_STORE(&dispatcher->stopping, true);
+
+    pthread_cond_broadcast(&otai_metadata_dispatcher_work_cond);
+    pthread_cond_broadcast(&otai_metadata_dispatcher_room_cond);
+
+    pthread_mutex_unlock(&otai_metadata_dispatcher_mutex);
+
+    uint32_t thread = 0;
+
+    for (; thread < count; thread++)
+    {
+        pthread_join(dispatcher->threads[thread], NULL);
+
+        free(dispatcher->snapshots[thread]);
+
+        dispatcher->snapshots[thread] = NULL;
+        dispatcher->snapshotsizes[thread] = 0;
+    }
+
+    pthread_rwlock_wrlock(&otai_metadata_dispatcher_lock);
+
+    otai_metadata_dispatcher_free_rings(dispatcher);
+
+    pthread_rwlock_unlock(&otai_metadata_dispatcher_lock);
+
+    dispatcher->threadcount = 0;
+}
+
+otai_status_t otai_metadata_dispatcher_start(
+        _In_ const otai_metadata_dispatcher_config_t *config)
+{
+    otai_metadata_dispatcher_t *dispatcher = &otai_metadata_dispatcher_global;
+
+    if (config == NULL || OTAI_METADATA_DISPATCHER_LOAD(&dispatcher->started))
+    {
+        OTAI_META_LOG_ERROR("config is NULL or dispatcher is already started");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (config->ringsize < 2 || (config->ringsize & (config->ringsize - 1)) != 0)
+    {
+        OTAI_META_LOG_ERROR("ring size %u is not power of 2", config->ringsize);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (config->threads == 0 || config->threads > OTAI_METADATA_DISPATCHER_MAX_THREADS)
+    {
+        OTAI_META_LOG_ERROR("number of threads %u is out of range", config->threads);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    switch (config->policy)
+    {
+        case OTAI_METADATA_DISPATCHER_POLICY_DROP_OLDEST:
+        case OTAI_METADATA_DISPATCHER_POLICY_COALESCE:
+        case OTAI_METADATA_DISPATCHER_POLICY_BLOCK:
+            break;
+
+        default:
+
+            OTAI_META_LOG_ERROR("invalid policy %d", config->policy);
+
+            return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    dispatcher->policy = config->policy;
+    dispatcher->linecardquery = config->linecardquery;
+    dispatcher->releaseswitchinfo = config->releaseswitchinfo;
+    dispatcher->stopping = false;
+    dispatcher->sleepers = 0;
+    dispatcher->waiters = 0;
+
+    pthread_rwlock_wrlock(&otai_metadata_dispatcher_lock);
+
+    otai_status_t status = otai_metadata_dispatcher_alloc_rings(dispatcher, config->ringsize);
+
+    pthread_rwlock_unlock(&otai_metadata_dispatcher_lock);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        OTAI_META_LOG_ERROR("failed to allocate rings");
+
+        return status;
+    }
+
+    dispatcher->threadcount = config->threads;
+
+    uint32_t thread = 0;
+
+    for (; thread < config->threads; thread++)
+    {
+        dispatcher->threadindex[thread] = thread;
+        dispatcher->signals[thread] = 0;
+
+        if (pthread_create(&dispatcher->threads[thread], NULL, otai_metadata_dispatcher_thread, &dispatcher->threadindex[thread]) != 0)
+        {
+            OTAI_META_LOG_ERROR("failed to create dispatcher thread %u", thread);
+
+            otai_metadata_dispatcher_join_threads(dispatcher, thread);
+
+            return OTAI_STATUS_FAILURE;
+        }
+    }
+
+    OTAI_METADATA_DISPATCHER_STORE(&dispatcher->started, true);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+void otai_metadata_dispatcher_stop(void)
+{
+    otai_metadata_dispatcher_t *dispatcher = &otai_metadata_dispatcher_global;
+
+    if (!OTAI_METADATA_DISPATCHER_LOAD(&dispatcher->started))
+    {
+        return;
+    }
+
+    OTAI_METADATA_DISPATCHER_STORE(&dispatcher->started, false);
+
+    /*
+     * New notifications are delivered directly from now, wait for adapter
+     * threads which are still pushing, dispatcher threads are still running
+     * so blocked producers will get room. Last producer signals idle
+     * condition.
+     */
+
+    pthread_mutex_lock(&otai_metadata_dispatcher_mutex);
+
+    while (OTAI_METADATA_DISPATCHER_LOAD(&dispatcher->inflight) != 0)
+    {
+        pthread_cond_wait(&otai_metadata_dispatcher_idle_cond, &otai_metadata_dispatcher_mutex);
+    }
+
+    pthread_mutex_unlock(&otai_metadata_dispatcher_mutex);
+
+    otai_metadata_dispatcher_join_threads(dispatcher, dispatcher->threadcount);
+}
+
+/*
+ * Copies attribute list with dispatcher callbacks in place of user
+ * callbacks, user callbacks are kept in new entry.
+ */
+static otai_status_t otai_metadata_dispatcher_begin_create(
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list,
+        _Out_ otai_metadata_dispatcher_entry_t **entry,
+        _Out_ otai_attribute_t **attrs)
+{
+    otai_metadata_dispatcher_t *dispatcher = &otai_metadata_dispatcher_global;
+
+    *entry = NULL;
+    *attrs = NULL;
+
+    if (attr_count != 0 && attr_list == NULL)
+    {
+        OTAI_META_LOG_ERROR("attribute list is NULL");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    otai_metadata_dispatcher_entry_t *created = calloc(1, sizeof(otai_metadata_dispatcher_entry_t));
+
+    otai_attribute_t *copy = malloc(sizeof(otai_attribute_t) * (attr_count ? attr_count : 1));
+
+    if (created == NULL || copy == NULL)
+    {
+        free(created);
+        free(copy);
+
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    if (attr_count != 0)
+    {
+        memcpy(copy, attr_list, sizeof(otai_attribute_t) * attr_count);
+    }
+
+    otai_metadata_dispatcher_handlers_t *handlers = &created->handlers;
+
+    uint32_t idx = 0;
+
+    for (; idx < attr_count; idx++)
+    {
+        otai_attribute_t *attr = &copy[idx];
+
+        otai_pointer_t ptr = attr->value.ptr;
+
+        if (object_type == OTAI_OBJECT_TYPE_LINECARD && ptr != NULL)
+        {
+            switch (attr->id)
+            {
+                case OTAI_LINECARD_ATTR_LINECARD_STATE_CHANGE_NOTIFY:
+                    handlers->statechange = (otai_linecard_state_change_notification_fn)ptr;
+                    attr->value.ptr = (otai_pointer_t)otai_metadata_dispatcher_on_linecard_state_change;
+                    break;
+
+                case OTAI_LINECARD_ATTR_LINECARD_ALARM_NOTIFY:
+                    handlers->alarm = (otai_linecard_alarm_notification_fn)ptr;
+                    attr->value.ptr = (otai_pointer_t)otai_metadata_dispatcher_on_linecard_alarm;
+                    break;
+
+                case OTAI_LINECARD_ATTR_LINECARD_OCM_SPECTRUM_POWER_NOTIFY:
+                    handlers->spectrum = (otai_linecard_ocm_spectrum_power_notification_fn)ptr;
+                    attr->value.ptr = (otai_pointer_t)otai_metadata_dispatcher_on_linecard_ocm_spectrum_power;
+                    break;
+
+                case OTAI_LINECARD_ATTR_LINECARD_OTDR_RESULT_NOTIFY:
+                    handlers->otdr = (otai_linecard_otdr_result_notification_fn)ptr;
+                    attr->value.ptr = (otai_pointer_t)otai_metadata_dispatcher_on_linecard_otdr_result;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+        else if (object_type == OTAI_OBJECT_TYPE_APS && ptr != NULL)
+        {
+            switch (attr->id)
+            {
+                case OTAI_APS_ATTR_SWITCH_INFO_NOTIFY:
+                    handlers->switchinfo = (otai_aps_report_switch_info_fn)ptr;
+                    attr->value.ptr = (otai_pointer_t)otai_metadata_dispatcher_on_aps_switch_info;
+                    break;
+
+                case OTAI_APS_ATTR_SWITCH_INFO_REF_NOTIFY:
+                    handlers->switchinforef = (otai_aps_report_switch_info_ref_fn)ptr;
+                    attr->value.ptr = (otai_pointer_t)otai_metadata_dispatcher_on_aps_switch_info_ref;
+                    break;
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    created->objecttype = object_type;
+    created->refs = 1;
+    created->index = OTAI_METADATA_DISPATCHER_INC(&dispatcher->nextindex);
+
+    pthread_mutex_init(&created->ring.coalescelock, NULL);
+
+    pthread_mutex_lock(&otai_metadata_dispatcher_create_mutex);
+
+    pthread_rwlock_wrlock(&otai_metadata_dispatcher_lock);
+
+    bool allocated = dispatcher->ringsize == 0 || otai_metadata_dispatcher_ring_alloc(&created->ring, dispatcher->ringsize);
+
+    if (allocated)
+    {
+        dispatcher->creating = created;
+    }
+
+    pthread_rwlock_unlock(&otai_metadata_dispatcher_lock);
+
+    if (!allocated)
+    {
+        pthread_mutex_unlock(&otai_metadata_dispatcher_create_mutex);
+
+        otai_metadata_dispatcher_release(created);
+
+        free(copy);
+
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    *entry = created;
+    *attrs = copy;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static void otai_metadata_dispatcher_end_create(
+        _Inout_ otai_metadata_dispatcher_entry_t *entry,
+        _Inout_ otai_attribute_t *attrs,
+        _In_ otai_status_t status,
+        _In_ otai_object_id_t object_id)
+{
+    otai_metadata_dispatcher_t *dispatcher = &otai_metadata_dispatcher_global;
+
+    pthread_rwlock_wrlock(&otai_metadata_dispatcher_lock);
+
+    dispatcher->creating = NULL;
+
+    /* entry may be already inserted by notification sent during create */
+
+    otai_object_id_t bound = entry->objectid;
+
+    if (bound != OTAI_NULL_OBJECT_ID && (status != OTAI_STATUS_SUCCESS || bound != object_id))
+    {
+        otai_metadata_dispatcher_unlink(dispatcher, bound);
+
+        entry->objectid = OTAI_NULL_OBJECT_ID;
+
+        if (status == OTAI_STATUS_SUCCESS)
+        {
+            OTAI_META_LOG_WARN("object 0x%" PRIx64 " notified during create of 0x%" PRIx64, bound, object_id);
+        }
+    }
+
+    bool owned = true;
+
+    if (status == OTAI_STATUS_SUCCESS && entry->objectid == OTAI_NULL_OBJECT_ID)
+    {
+        entry->objectid = object_id;
+
+        owned = !otai_metadata_dispatcher_insert(dispatcher, entry);
+    }
+    else if (status == OTAI_STATUS_SUCCESS)
+    {
+        owned = false;
+    }
+
+    pthread_rwlock_unlock(&otai_metadata_dispatcher_lock);
+
+    pthread_mutex_unlock(&otai_metadata_dispatcher_create_mutex);
+
+    if (owned)
+    {
+        otai_metadata_dispatcher_release(entry);
+    }
+
+    free(attrs);
+}
+
+otai_status_t otai_metadata_dispatcher_create_linecard(
+        _In_ otai_create_linecard_fn create_linecard,
+        _Out_ otai_object_id_t *linecard_id,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    otai_metadata_dispatcher_entry_t *entry;
+    otai_attribute_t *attrs;
+
+    if (create_linecard == NULL || linecard_id == NULL)
+    {
+        OTAI_META_LOG_ERROR("create function or linecard id is NULL");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    otai_status_t status = otai_metadata_dispatcher_begin_create(OTAI_OBJECT_TYPE_LINECARD, attr_count, attr_list, &entry, &attrs);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    status = create_linecard(linecard_id, attr_count, attrs);
+
+    otai_metadata_dispatcher_end_create(entry, attrs, status, *linecard_id);
+
+    return status;
+}
+
+otai_status_t otai_metadata_dispatcher_create_aps(
+        _In_ otai_create_aps_fn create_aps,
+        _Out_ otai_object_id_t *aps_id,
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    otai_metadata_dispatcher_entry_t *entry;
+    otai_attribute_t *attrs;
+
+    if (create_aps == NULL || aps_id == NULL)
+    {
+        OTAI_META_LOG_ERROR("create function or APS id is NULL");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    otai_status_t status = otai_metadata_dispatcher_begin_create(OTAI_OBJECT_TYPE_APS, attr_count, attr_list, &entry, &attrs);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    status = create_aps(aps_id, linecard_id, attr_count, attrs);
+
+    otai_metadata_dispatcher_end_create(entry, attrs, status, *aps_id);
+
+    return status;
+}
+
+otai_status_t otai_metadata_dispatcher_remove(
+        _In_ otai_object_id_t object_id)
+{
+    otai_metadata_dispatcher_t *dispatcher = &otai_metadata_dispatcher_global;
+
+    pthread_rwlock_wrlock(&otai_metadata_dispatcher_lock);
+
+    otai_metadata_dispatcher_entry_t *entry = otai_metadata_dispatcher_unlink(dispatcher, object_id);
+
+    pthread_rwlock_unlock(&otai_metadata_dispatcher_lock);
+
+    if (entry == NULL)
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    otai_metadata_dispatcher_release(entry);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static void otai_metadata_dispatcher_add_stats(
+        _In_ otai_metadata_dispatcher_ring_t *ring,
+        _Inout_ otai_metadata_dispatcher_stats_t *stats)
+{
+    stats->depth += otai_metadata_dispatcher_ring_depth(ring) + OTAI_METADATA_DISPATCHER_LOAD(&ring->coalescepending);
+    stats->capacity += (ring->cells != NULL) ? ring->mask + 1 : 0;
+    stats->enqueued += OTAI_METADATA_DISPATCHER_LOAD(&ring->enqueued);
+    stats->dispatched += OTAI_METADATA_DISPATCHER_LOAD(&ring->dispatched);
+    stats->dropped += OTAI_METADATA_DISPATCHER_LOAD(&ring->dropped);
+    stats->coalesced += OTAI_METADATA_DISPATCHER_LOAD(&ring->coalesced);
+    stats->blocked += OTAI_METADATA_DISPATCHER_LOAD(&ring->blocked);
+}
+
+otai_status_t otai_metadata_dispatcher_get_stats(
+        _In_ otai_object_id_t object_id,
+        _Out_ otai_metadata_dispatcher_stats_t *stats)
+{
+    otai_metadata_dispatcher_t *dispatcher = &otai_metadata_dispatcher_global;
+
+    memset(stats, 0, sizeof(otai_metadata_dispatcher_stats_t));
+
+    if (!OTAI_METADATA_DISPATCHER_LOAD(&dispatcher->started))
+    {
+        return OTAI_STATUS_UNINITIALIZED;
+    }
+
+    otai_status_t status = OTAI_STATUS_SUCCESS;
+
+    pthread_rwlock_rdlock(&otai_metadata_dispatcher_lock);
+
+    if (object_id == OTAI_NULL_OBJECT_ID)
+    {
+        size_t bucket = 0;
+
+        for (; bucket < dispatcher->bucketcount; bucket++)
+        {
+            otai_metadata_dispatcher_entry_t *entry = dispatcher->buckets[bucket];
+
+            for (; entry != NULL; entry = entry->next)
+            {
+                otai_metadata_dispatcher_add_stats(&entry->ring, stats);
+            }
+        }
+
+        stats->dropped += OTAI_METADATA_DISPATCHER_LOAD(&dispatcher->dropped);
+    }
+    else
+    {
+        otai_metadata_dispatcher_entry_t *entry = otai_metadata_dispatcher_find(dispatcher, object_id);
+
+        if (entry != NULL)
+        {
+            otai_metadata_dispatcher_add_stats(&entry->ring, stats);
+        }
+        else
+        {
+            status = OTAI_STATUS_ITEM_NOT_FOUND;
+        }
+    }
+
+    pthread_rwlock_unlock(&otai_metadata_dispatcher_lock);
+
+    return status;
+}
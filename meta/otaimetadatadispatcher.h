@@ -0,0 +1,287 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatadispatcher.h
+ *
+ * @brief   This module defines OTAI Metadata notification dispatcher
+ */
+
+#ifndef __OTAIMETADATADISPATCHER_H_
+#define __OTAIMETADATADISPATCHER_H_
+
+#include "otaimetadatatypes.h"
+
+/**
+ * @defgroup OTAIMETADATADISPATCHER OTAI - Metadata notification dispatcher
+ *
+ * Dispatcher decouples linecard and APS notifications from adapter threads.
+ * Notification is copied to bounded lock free ring of its linecard and
+ * user callback is called later from dispatcher thread, so slow consumer
+ * will not stall adapter.
+ *
+ * Notifications are registered as before, using *_NOTIFY attributes, but
+ * linecard and APS are created through otai_metadata_dispatcher_create_linecard()
+ * and otai_metadata_dispatcher_create_aps(). Notify attributes are create
+ * only and callbacks have no user context, so dispatcher substitutes own
+ * callbacks and keeps user callbacks of each object. Object is passed to
+ * otai_metadata_dispatcher_remove() when it is removed, which releases its
+ * ring.
+ *
+ * Notifications of the same linecard are delivered in order by the same
+ * dispatcher thread.
+ *
+ * @{
+ */
+
+/**
+ * @def OTAI_METADATA_DISPATCHER_MAX_THREADS
+ *
+ * Maximum number of dispatcher threads.
+ */
+#define OTAI_METADATA_DISPATCHER_MAX_THREADS 16
+
+/**
+ * @def OTAI_METADATA_DISPATCHER_COALESCE_SLOTS
+ *
+ * Number of coalesce slots of each ring.
+ */
+#define OTAI_METADATA_DISPATCHER_COALESCE_SLOTS 256
+
+/**
+ * @brief Policy when linecard ring is full.
+ */
+typedef enum _otai_metadata_dispatcher_policy_t
+{
+    /**
+     * @brief Drop oldest notification on the ring.
+     */
+    OTAI_METADATA_DISPATCHER_POLICY_DROP_OLDEST,
+
+    /**
+     * @brief Keep only latest notification of the same object.
+     *
+     * Alarms are coalesced per resource and alarm type. Notification is
+     * dropped if there is no free coalesce slot, slots are freed when
+     * their notifications are dispatched.
+     */
+    OTAI_METADATA_DISPATCHER_POLICY_COALESCE,
+
+    /**
+     * @brief Block adapter thread until there is room on the ring.
+     */
+    OTAI_METADATA_DISPATCHER_POLICY_BLOCK,
+
+} otai_metadata_dispatcher_policy_t;
+
+/**
+ * @brief Query linecard of object.
+ *
+ * Signature is the same as otai_linecard_id_query().
+ *
+ * @param[in] object_id Object id
+ *
+ * @return Linecard id or #OTAI_NULL_OBJECT_ID
+ */
+typedef otai_object_id_t (*otai_metadata_dispatcher_linecard_query_fn)(
+        _In_ otai_object_id_t object_id);
+
+/**
+ * @brief Dispatcher configuration.
+ */
+typedef struct _otai_metadata_dispatcher_config_t
+{
+    /**
+     * @brief Number of notifications on each ring, power of 2.
+     */
+    otai_uint32_t                                ringsize;
+
+    /**
+     * @brief Number of dispatcher threads.
+     */
+    otai_uint32_t                                threads;
+
+    /**
+     * @brief Policy when ring is full.
+     */
+    otai_metadata_dispatcher_policy_t            policy;
+
+    /**
+     * @brief Query linecard of APS notification, or NULL.
+     *
+     * APS notification is queued on ring of returned linecard if the
+     * linecard was created through dispatcher. Otherwise, or if not set,
+     * APS object is dispatched from its own ring.
+     */
+    const otai_metadata_dispatcher_linecard_query_fn linecardquery;
+
+    /**
+     * @brief Release switch info of dropped by reference APS notification.
+     *
+     * Usually release_aps_switch_info of APS API. Must be set when
+     * #OTAI_APS_ATTR_SWITCH_INFO_REF_NOTIFY is created through dispatcher,
+     * since notification which is dropped never reaches user handler.
+     */
+    const otai_release_aps_switch_info_fn        releaseswitchinfo;
+
+} otai_metadata_dispatcher_config_t;
+
+/**
+ * @brief Dispatcher counters.
+ *
+ * Counters of object are kept until it is removed.
+ */
+typedef struct _otai_metadata_dispatcher_stats_t
+{
+    /**
+     * @brief Number of notifications waiting on the ring.
+     */
+    otai_uint64_t                                depth;
+
+    /**
+     * @brief Ring capacity.
+     */
+    otai_uint64_t                                capacity;
+
+    /**
+     * @brief Number of queued notifications.
+     */
+    otai_uint64_t                                enqueued;
+
+    /**
+     * @brief Number of notifications passed to user callback.
+     */
+    otai_uint64_t                                dispatched;
+
+    /**
+     * @brief Number of dropped notifications.
+     */
+    otai_uint64_t                                dropped;
+
+    /**
+     * @brief Number of notifications replaced by newer one.
+     */
+    otai_uint64_t                                coalesced;
+
+    /**
+     * @brief Number of times adapter thread was blocked on full ring.
+     */
+    otai_uint64_t                                blocked;
+
+} otai_metadata_dispatcher_stats_t;
+
+/**
+ * @brief Start dispatcher threads
+ *
+ * Until dispatcher is started, or after it is stopped, dispatcher
+ * callbacks call user callbacks directly on adapter thread.
+ *
+ * @param[in] config Dispatcher configuration
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if configuration is invalid or dispatcher is already started,
+ * #OTAI_STATUS_NO_MEMORY or #OTAI_STATUS_FAILURE if rings or threads can't
+ * be created
+ */
+extern otai_status_t otai_metadata_dispatcher_start(
+        _In_ const otai_metadata_dispatcher_config_t *config);
+
+/**
+ * @brief Stop dispatcher threads
+ *
+ * Queued notifications are delivered before threads exit.
+ */
+extern void otai_metadata_dispatcher_stop(void);
+
+/**
+ * @brief Create linecard with notifications passed through dispatcher
+ *
+ * Linecard *_NOTIFY attributes on the list are replaced by dispatcher
+ * callbacks, user callbacks are kept for this linecard only. Creates are
+ * serialized, notification sent by adapter before create returns is
+ * delivered as well.
+ *
+ * @param[in] create_linecard Create linecard API
+ * @param[out] linecard_id Linecard id
+ * @param[in] attr_count Number of attributes
+ * @param[in] attr_list Attribute list
+ *
+ * @return Status of create, #OTAI_STATUS_NO_MEMORY or
+ * #OTAI_STATUS_INVALID_PARAMETER if create was not called
+ */
+extern otai_status_t otai_metadata_dispatcher_create_linecard(
+        _In_ otai_create_linecard_fn create_linecard,
+        _Out_ otai_object_id_t *linecard_id,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list);
+
+/**
+ * @brief Create APS with notifications passed through dispatcher
+ *
+ * Same as otai_metadata_dispatcher_create_linecard() for APS *_NOTIFY
+ * attributes. By reference switch info is queued without copy, user
+ * handler releases it as if it was called by adapter.
+ *
+ * @param[in] create_aps Create APS API
+ * @param[out] aps_id APS id
+ * @param[in] linecard_id Linecard id
+ * @param[in] attr_count Number of attributes
+ * @param[in] attr_list Attribute list
+ *
+ * @return Status of create, #OTAI_STATUS_NO_MEMORY or
+ * #OTAI_STATUS_INVALID_PARAMETER if create was not called
+ */
+extern otai_status_t otai_metadata_dispatcher_create_aps(
+        _In_ otai_create_aps_fn create_aps,
+        _Out_ otai_object_id_t *aps_id,
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list);
+
+/**
+ * @brief Forget linecard or APS created through dispatcher
+ *
+ * Called after object is removed. Ring of object is released, its queued
+ * notifications which are not yet dispatched are dropped.
+ *
+ * @param[in] object_id Linecard or APS id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object was not created through dispatcher
+ */
+extern otai_status_t otai_metadata_dispatcher_remove(
+        _In_ otai_object_id_t object_id);
+
+/**
+ * @brief Get dispatcher counters
+ *
+ * Notification of APS queued on ring of its linecard is counted by the
+ * linecard.
+ *
+ * @param[in] object_id Linecard or APS id, or #OTAI_NULL_OBJECT_ID for sum
+ * of all objects, including notifications dropped for unknown objects
+ * @param[out] stats Counters
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object was not created through dispatcher, #OTAI_STATUS_UNINITIALIZED if
+ * dispatcher is not started
+ */
+extern otai_status_t otai_metadata_dispatcher_get_stats(
+        _In_ otai_object_id_t object_id,
+        _Out_ otai_metadata_dispatcher_stats_t *stats);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATADISPATCHER_H_ */
@@ -0,0 +1,787 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatahistory.c
+ *
+ * @brief   This module implements OTAI Metadata gauge history store
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <otai.h>
+#include "otaimetadatautils.h"
+#include "otaimetadatalogger.h"
+#include "otaimetadatahistory.h"
+
+/*
+ * Block starts with 64 bit time and value, sample takes at most 4 + 64
+ * bits of time and 2 + 5 + 6 + 64 bits of value.
+ */
+
+#define OTAI_METADATA_HISTORY_HEADER_BITS 128
+#define OTAI_METADATA_HISTORY_SAMPLE_BITS 145
+
+#define OTAI_METADATA_HISTORY_NO_WINDOW 64
+
+static uint32_t otai_metadata_history_get_scale(
+        _In_ otai_stat_value_precision_t precision)
+{
+    switch (precision)
+    {
+        case OTAI_STAT_VALUE_PRECISION_0:
+            return 1;
+
+        case OTAI_STAT_VALUE_PRECISION_1:
+            return 10;
+
+        case OTAI_STAT_VALUE_PRECISION_2:
+            return 100;
+
+        default:
+            return 0;
+    }
+}
+
+static otai_status_t otai_metadata_history_add_stat(
+        _Inout_ otai_metadata_history_t *history,
+        _In_ otai_stat_id_t stat_id)
+{
+    const otai_stat_metadata_t *md = otai_metadata_get_stat_metadata(history->objecttype, stat_id);
+
+    if (md == NULL || md->statvalueiscounter)
+    {
+        OTAI_META_LOG_ERROR("statistic %d is not gauge of object type %d", stat_id, history->objecttype);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t idx = history->statcount++;
+
+    history->statids[idx] = stat_id;
+    history->statvaluetypes[idx] = md->statvaluetype;
+    history->scale[idx] = otai_metadata_history_get_scale(md->statvalueprecision);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_history_init(
+        _Out_ otai_metadata_history_t *history,
+        _In_ const otai_metadata_history_config_t *config)
+{
+    memset(history, 0, sizeof(otai_metadata_history_t));
+
+    const otai_object_type_info_t *info = otai_metadata_get_object_type_info(config->objecttype);
+
+    if (info == NULL || info->statenum == NULL)
+    {
+        OTAI_META_LOG_ERROR("object type %d has no statistics", config->objecttype);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if ((config->statcount != 0 && config->statids == NULL) || config->capacity == 0 || config->blockcount == 0 ||
+            (uint64_t)config->blocksize * 8 < OTAI_METADATA_HISTORY_HEADER_BITS + OTAI_METADATA_HISTORY_SAMPLE_BITS)
+    {
+        OTAI_META_LOG_ERROR("invalid objects, block size %u or block count %u", config->blocksize, config->blockcount);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    const otai_enum_metadata_t *statenum = info->statenum;
+
+    uint32_t statcount = (config->statcount != 0) ? config->statcount : (uint32_t)statenum->valuescount;
+
+    history->objecttype = config->objecttype;
+    history->info = info;
+    history->capacity = config->capacity;
+    history->blocksize = config->blocksize;
+    history->blockcount = config->blockcount;
+
+    history->statids = calloc(statcount + 1, sizeof(otai_stat_id_t));
+    history->statvaluetypes = calloc(statcount + 1, sizeof(otai_stat_value_type_t));
+    history->scale = calloc(statcount + 1, sizeof(uint32_t));
+    history->values = calloc(statcount + 1, sizeof(otai_stat_value_t));
+    history->objects = calloc(config->capacity, sizeof(otai_object_id_t));
+
+    if (history->statids == NULL || history->statvaluetypes == NULL || history->scale == NULL ||
+            history->values == NULL || history->objects == NULL ||
+            otai_metadata_objectmap_init(&history->objectmap, config->capacity) != OTAI_STATUS_SUCCESS)
+    {
+        otai_metadata_history_destroy(history);
+
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < statcount; idx++)
+    {
+        if (config->statcount == 0)
+        {
+            /* all gauges of object type are stored */
+
+            otai_stat_id_t stat_id = (otai_stat_id_t)statenum->values[idx];
+
+            const otai_stat_metadata_t *md = otai_metadata_get_stat_metadata(config->objecttype, stat_id);
+
+            if (md == NULL || md->statvalueiscounter)
+            {
+                continue;
+            }
+
+            otai_metadata_history_add_stat(history, stat_id);
+
+            continue;
+        }
+
+        otai_status_t status = otai_metadata_history_add_stat(history, config->statids[idx]);
+
+        if (status != OTAI_STATUS_SUCCESS)
+        {
+            otai_metadata_history_destroy(history);
+
+            return status;
+        }
+    }
+
+    if (history->statcount == 0)
+    {
+        OTAI_META_LOG_ERROR("object type %d has no gauges", config->objecttype);
+
+        otai_metadata_history_destroy(history);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    size_t seriescount = (size_t)history->statcount * config->capacity;
+
+    history->series = calloc(seriescount, sizeof(otai_metadata_history_series_t));
+    history->blocks = calloc(seriescount * config->blockcount, sizeof(otai_metadata_history_block_t));
+    history->data = calloc(seriescount * config->blockcount, config->blocksize);
+
+    if (history->series == NULL || history->blocks == NULL || history->data == NULL)
+    {
+        otai_metadata_history_destroy(history);
+
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+void otai_metadata_history_destroy(
+        _Inout_ otai_metadata_history_t *history)
+{
+    free(history->statids);
+    free(history->statvaluetypes);
+    free(history->scale);
+    free(history->values);
+    free(history->objects);
+    free(history->series);
+    free(history->blocks);
+    free(history->data);
+
+    otai_metadata_objectmap_destroy(&history->objectmap);
+
+    memset(history, 0, sizeof(otai_metadata_history_t));
+}
+
+otai_status_t otai_metadata_history_add_object(
+        _Inout_ otai_metadata_history_t *history,
+        _In_ otai_object_id_t object_id)
+{
+    uint32_t index = history->objectcount;
+
+    otai_status_t status = otai_metadata_objectmap_insert(&history->objectmap, object_id, index);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    history->objectcount++;
+
+    history->objects[index] = object_id;
+
+    uint32_t idx = 0;
+
+    for (; idx < history->statcount; idx++)
+    {
+        otai_metadata_history_series_t *series = &history->series[(size_t)idx * history->capacity + index];
+
+        memset(series, 0, sizeof(otai_metadata_history_series_t));
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_history_remove_object(
+        _Inout_ otai_metadata_history_t *history,
+        _In_ otai_object_id_t object_id)
+{
+    uint32_t index;
+
+    if (!otai_metadata_objectmap_find(&history->objectmap, object_id, &index))
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    otai_metadata_objectmap_remove(&history->objectmap, object_id);
+
+    uint32_t last = --history->objectcount;
+
+    if (index == last)
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    history->objects[index] = history->objects[last];
+
+    otai_metadata_objectmap_set(&history->objectmap, history->objects[index], index);
+
+    size_t blockcount = history->blockcount;
+    size_t datasize = blockcount * history->blocksize;
+
+    uint32_t idx = 0;
+
+    for (; idx < history->statcount; idx++)
+    {
+        size_t dst = (size_t)idx * history->capacity + index;
+        size_t src = (size_t)idx * history->capacity + last;
+
+        history->series[dst] = history->series[src];
+
+        memcpy(&history->blocks[dst * blockcount], &history->blocks[src * blockcount], blockcount * sizeof(otai_metadata_history_block_t));
+        memcpy(&history->data[dst * datasize], &history->data[src * datasize], datasize);
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+/*
+ * Bits are written most significant first, block data is zeroed when
+ * block is started, so bits are only ORed in.
+ */
+
+static void otai_metadata_history_put(
+        _Inout_ uint8_t *data,
+        _Inout_ uint32_t *pos,
+        _In_ uint64_t value,
+        _In_ uint32_t width)
+{
+    while (width > 0)
+    {
+        uint32_t room = 8 - (*pos & 7);
+        uint32_t n = (width < room) ? width : room;
+
+        uint64_t chunk = (value >> (width - n)) & ((1u << n) - 1);
+
+        data[*pos >> 3] = (uint8_t)(data[*pos >> 3] | (chunk << (room - n)));
+
+        *pos += n;
+        width -= n;
+    }
+}
+
+static uint64_t otai_metadata_history_get(
+        _In_ const uint8_t *data,
+        _Inout_ uint32_t *pos,
+        _In_ uint32_t width)
+{
+    uint64_t value = 0;
+
+    while (width > 0)
+    {
+        uint32_t room = 8 - (*pos & 7);
+        uint32_t n = (width < room) ? width : room;
+
+        uint64_t chunk = ((uint64_t)data[*pos >> 3] >> (room - n)) & ((1u << n) - 1);
+
+        value = (value << n) | chunk;
+
+        *pos += n;
+        width -= n;
+    }
+
+    return value;
+}
+
+static int64_t otai_metadata_history_get_signed(
+        _In_ const uint8_t *data,
+        _Inout_ uint32_t *pos,
+        _In_ uint32_t width)
+{
+    uint64_t value = otai_metadata_history_get(data, pos, width);
+
+    uint64_t sign = (uint64_t)1 << (width - 1);
+
+    return (int64_t)((value ^ sign) - sign);
+}
+
+static void otai_metadata_history_put_time(
+        _Inout_ uint8_t *data,
+        _Inout_ uint32_t *pos,
+        _In_ int64_t dod)
+{
+    if (dod == 0)
+    {
+        otai_metadata_history_put(data, pos, 0, 1);
+    }
+    else if (dod >= -64 && dod < 64)
+    {
+        otai_metadata_history_put(data, pos, 2, 2);
+        otai_metadata_history_put(data, pos, (uint64_t)dod, 7);
+    }
+    else if (dod >= -256 && dod < 256)
+    {
+        otai_metadata_history_put(data, pos, 6, 3);
+        otai_metadata_history_put(data, pos, (uint64_t)dod, 9);
+    }
+    else if (dod >= -2048 && dod < 2048)
+    {
+        otai_metadata_history_put(data, pos, 14, 4);
+        otai_metadata_history_put(data, pos, (uint64_t)dod, 12);
+    }
+    else
+    {
+        otai_metadata_history_put(data, pos, 15, 4);
+        otai_metadata_history_put(data, pos, (uint64_t)dod, 64);
+    }
+}
+
+static int64_t otai_metadata_history_get_time(
+        _In_ const uint8_t *data,
+        _Inout_ uint32_t *pos)
+{
+    uint32_t prefix = 0;
+
+    while (prefix < 4 && otai_metadata_history_get(data, pos, 1) != 0)
+    {
+        prefix++;
+    }
+
+    switch (prefix)
+    {
+        case 0:
+            return 0;
+
+        case 1:
+            return otai_metadata_history_get_signed(data, pos, 7);
+
+        case 2:
+            return otai_metadata_history_get_signed(data, pos, 9);
+
+        case 3:
+            return otai_metadata_history_get_signed(data, pos, 12);
+
+        default:
+            return (int64_t)otai_metadata_history_get(data, pos, 64);
+    }
+}
+
+static void otai_metadata_history_put_value(
+        _Inout_ uint8_t *data,
+        _Inout_ uint32_t *pos,
+        _Inout_ otai_metadata_history_series_t *series,
+        _In_ uint64_t value)
+{
+    uint64_t xor = value ^ series->lastvalue;
+
+    if (xor == 0)
+    {
+        otai_metadata_history_put(data, pos, 0, 1);
+
+        return;
+    }
+
+    uint32_t leading = (uint32_t)__builtin_clzll(xor);
+    uint32_t trailing = (uint32_t)__builtin_ctzll(xor);
+
+    leading = (leading > 31) ? 31 : leading;
+
+    if (series->leading != OTAI_METADATA_HISTORY_NO_WINDOW && leading >= series->leading && trailing >= series->trailing)
+    {
+        /* meaningful bits fit in previous window */
+
+        otai_metadata_history_put(data, pos, 2, 2);
+        otai_metadata_history_put(data, pos, xor >> series->trailing, 64 - series->leading - series->trailing);
+
+        return;
+    }
+
+    uint32_t length = 64 - leading - trailing;
+
+    otai_metadata_history_put(data, pos, 3, 2);
+    otai_metadata_history_put(data, pos, leading, 5);
+    otai_metadata_history_put(data, pos, length & 63, 6);
+    otai_metadata_history_put(data, pos, xor >> trailing, length);
+
+    series->leading = leading;
+    series->trailing = trailing;
+}
+
+static uint64_t otai_metadata_history_get_value(
+        _In_ const uint8_t *data,
+        _Inout_ uint32_t *pos,
+        _Inout_ otai_metadata_history_series_t *series)
+{
+    if (otai_metadata_history_get(data, pos, 1) == 0)
+    {
+        return series->lastvalue;
+    }
+
+    if (otai_metadata_history_get(data, pos, 1) != 0)
+    {
+        series->leading = (uint32_t)otai_metadata_history_get(data, pos, 5);
+
+        uint32_t length = (uint32_t)otai_metadata_history_get(data, pos, 6);
+
+        length = (length == 0) ? 64 : length;
+
+        series->trailing = 64 - series->leading - length;
+    }
+
+    uint32_t length = 64 - series->leading - series->trailing;
+
+    series->lastvalue ^= otai_metadata_history_get(data, pos, length) << series->trailing;
+
+    return series->lastvalue;
+}
+
+static void otai_metadata_history_append(
+        _Inout_ otai_metadata_history_t *history,
+        _In_ size_t index,
+        _In_ uint64_t time,
+        _In_ uint64_t value)
+{
+    otai_metadata_history_series_t *series = &history->series[index];
+    otai_metadata_history_block_t *blocks = &history->blocks[index * history->blockcount];
+    uint8_t *data = &history->data[index * history->blockcount * history->blocksize];
+
+    if (series->count != 0)
+    {
+        uint32_t last = (series->first + series->count - 1) % history->blockcount;
+
+        otai_metadata_history_block_t *block = &blocks[last];
+
+        if ((uint64_t)block->bits + OTAI_METADATA_HISTORY_SAMPLE_BITS <= (uint64_t)history->blocksize * 8)
+        {
+            int64_t delta = (int64_t)(time - series->lasttime);
+
+            otai_metadata_history_put_time(&data[(size_t)last * history->blocksize], &block->bits, delta - series->lastdelta);
+            otai_metadata_history_put_value(&data[(size_t)last * history->blocksize], &block->bits, series, value);
+
+            block->endtime = time;
+            block->samples++;
+
+            series->lasttime = time;
+            series->lastdelta = delta;
+            series->lastvalue = value;
+
+            return;
+        }
+    }
+
+    if (series->count == history->blockcount)
+    {
+        /* oldest block is dropped */
+
+        series->first = (series->first + 1) % history->blockcount;
+        series->count--;
+    }
+
+    uint32_t next = (series->first + series->count) % history->blockcount;
+
+    series->count++;
+
+    otai_metadata_history_block_t *block = &blocks[next];
+
+    uint8_t *blockdata = &data[(size_t)next * history->blocksize];
+
+    memset(blockdata, 0, history->blocksize);
+
+    block->starttime = time;
+    block->endtime = time;
+    block->samples = 1;
+    block->bits = 0;
+
+    otai_metadata_history_put(blockdata, &block->bits, time, 64);
+    otai_metadata_history_put(blockdata, &block->bits, value, 64);
+
+    series->lasttime = time;
+    series->lastdelta = 0;
+    series->lastvalue = value;
+    series->leading = OTAI_METADATA_HISTORY_NO_WINDOW;
+    series->trailing = 0;
+}
+
+static double otai_metadata_history_to_double(
+        _In_ otai_stat_value_type_t type,
+        _In_ const otai_stat_value_t *value)
+{
+    switch (type)
+    {
+        case OTAI_STAT_VALUE_TYPE_INT32:
+            return (double)value->s32;
+
+        case OTAI_STAT_VALUE_TYPE_UINT32:
+            return (double)value->u32;
+
+        case OTAI_STAT_VALUE_TYPE_INT64:
+            return (double)value->s64;
+
+        case OTAI_STAT_VALUE_TYPE_UINT64:
+            return (double)value->u64;
+
+        case OTAI_STAT_VALUE_TYPE_DOUBLE:
+            return value->d64;
+
+        default:
+            return 0;
+    }
+}
+
+/*
+ * Value is rounded to statistic precision, so repeated values give zero
+ * XOR. Values out of 53 bit range and NaN are kept as they are.
+ */
+static double otai_metadata_history_round(
+        _In_ double value,
+        _In_ uint32_t scale)
+{
+    if (scale == 0)
+    {
+        return value;
+    }
+
+    double scaled = value * scale;
+
+    if (!(scaled > -9.0e15 && scaled < 9.0e15))
+    {
+        return value;
+    }
+
+    int64_t rounded = (int64_t)(scaled + ((scaled < 0) ? -0.5 : 0.5));
+
+    return (double)rounded / scale;
+}
+
+static otai_status_t otai_metadata_history_update_index(
+        _Inout_ otai_metadata_history_t *history,
+        _In_ uint32_t index,
+        _In_ uint64_t time,
+        _In_ const otai_stat_value_t *counters)
+{
+    /* all series of object have the same samples, so first is checked */
+
+    const otai_metadata_history_series_t *first = &history->series[index];
+
+    if (first->count != 0 && time < first->lasttime)
+    {
+        OTAI_META_LOG_ERROR("sample time %" PRIu64 " is older than last sample %" PRIu64, time, first->lasttime);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < history->statcount; idx++)
+    {
+        otai_stat_value_t value;
+
+        value.d64 = otai_metadata_history_round(otai_metadata_history_to_double(history->statvaluetypes[idx], &counters[idx]), history->scale[idx]);
+
+        otai_metadata_history_append(history, (size_t)idx * history->capacity + index, time, value.u64);
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_history_update(
+        _Inout_ otai_metadata_history_t *history,
+        _In_ otai_object_id_t object_id,
+        _In_ uint64_t time,
+        _In_ const otai_stat_value_t *counters)
+{
+    uint32_t index;
+
+    if (!otai_metadata_objectmap_find(&history->objectmap, object_id, &index))
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    return otai_metadata_history_update_index(history, index, time, counters);
+}
+
+otai_status_t otai_metadata_history_sample(
+        _Inout_ otai_metadata_history_t *history,
+        _In_ uint64_t time)
+{
+    otai_status_t result = OTAI_STATUS_SUCCESS;
+
+    if (history->info == NULL || history->info->getstatsext == NULL)
+    {
+        OTAI_META_LOG_ERROR("object type %d has no get stats extended API", history->objecttype);
+
+        return OTAI_STATUS_NOT_IMPLEMENTED;
+    }
+
+    otai_object_meta_key_t meta_key;
+
+    meta_key.objecttype = history->objecttype;
+
+    uint32_t index = 0;
+
+    for (; index < history->objectcount; index++)
+    {
+        meta_key.objectkey.key.object_id = history->objects[index];
+
+        otai_status_t status = history->info->getstatsext(&meta_key, history->statcount, history->statids, OTAI_STATS_MODE_READ, history->values);
+
+        if (status == OTAI_STATUS_SUCCESS)
+        {
+            status = otai_metadata_history_update_index(history, index, time, history->values);
+        }
+
+        if (status != OTAI_STATUS_SUCCESS)
+        {
+            OTAI_META_LOG_DEBUG("failed to sample 0x%" PRIx64 ": %d", history->objects[index], status);
+
+            result = status;
+        }
+    }
+
+    return result;
+}
+
+otai_status_t otai_metadata_history_query(
+        _In_ const otai_metadata_history_t *history,
+        _In_ otai_object_id_t object_id,
+        _In_ otai_stat_id_t stat_id,
+        _In_ uint64_t start_time,
+        _In_ uint64_t end_time,
+        _Inout_ uint32_t *count,
+        _Out_ uint64_t *times,
+        _Out_ double *values)
+{
+    uint32_t index;
+
+    if (!otai_metadata_objectmap_find(&history->objectmap, object_id, &index))
+    {
+        *count = 0;
+
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    uint32_t idx = 0;
+
+    while (idx < history->statcount && history->statids[idx] != stat_id)
+    {
+        idx++;
+    }
+
+    if (idx == history->statcount)
+    {
+        *count = 0;
+
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    size_t seriesindex = (size_t)idx * history->capacity + index;
+
+    const otai_metadata_history_series_t *series = &history->series[seriesindex];
+    const otai_metadata_history_block_t *blocks = &history->blocks[seriesindex * history->blockcount];
+    const uint8_t *data = &history->data[seriesindex * history->blockcount * history->blocksize];
+
+    uint32_t filled = 0;
+
+    uint32_t n = 0;
+
+    for (; n < series->count; n++)
+    {
+        uint32_t b = (series->first + n) % history->blockcount;
+
+        const otai_metadata_history_block_t *block = &blocks[b];
+
+        if (block->endtime < start_time)
+        {
+            continue;
+        }
+
+        if (block->starttime > end_time)
+        {
+            break;
+        }
+
+        const uint8_t *blockdata = &data[(size_t)b * history->blocksize];
+
+        /* decoder keeps its own copy of encoder state */
+
+        otai_metadata_history_series_t state;
+
+        memset(&state, 0, sizeof(state));
+
+        uint32_t pos = 0;
+
+        uint64_t time = otai_metadata_history_get(blockdata, &pos, 64);
+
+        state.lastvalue = otai_metadata_history_get(blockdata, &pos, 64);
+        state.leading = OTAI_METADATA_HISTORY_NO_WINDOW;
+
+        uint32_t sample = 0;
+
+        for (; sample < block->samples; sample++)
+        {
+            if (sample != 0)
+            {
+                state.lastdelta += otai_metadata_history_get_time(blockdata, &pos);
+
+                time += (uint64_t)state.lastdelta;
+
+                otai_metadata_history_get_value(blockdata, &pos, &state);
+            }
+
+            if (time < start_time)
+            {
+                continue;
+            }
+
+            if (time > end_time)
+            {
+                break;
+            }
+
+            if (filled == *count)
+            {
+                return OTAI_STATUS_BUFFER_OVERFLOW;
+            }
+
+            otai_stat_value_t value;
+
+            value.u64 = state.lastvalue;
+
+            times[filled] = time;
+            values[filled] = value.d64;
+
+            filled++;
+        }
+    }
+
+    *count = filled;
+
+    return OTAI_STATUS_SUCCESS;
+}
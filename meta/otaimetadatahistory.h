@@ -0,0 +1,357 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatahistory.h
+ *
+ * @brief   This module defines OTAI Metadata gauge history store
+ */
+
+#ifndef __OTAIMETADATAHISTORY_H_
+#define __OTAIMETADATAHISTORY_H_
+
+#include "otaimetadatatypes.h"
+#include "otaimetadataobjectmap.h"
+
+/**
+ * @defgroup OTAIMETADATAHISTORY OTAI - Metadata gauge history store
+ *
+ * History store keeps compressed samples of gauge statistics of objects of
+ * single object type. Each object and statistic has its own series, which
+ * is ring of fixed size blocks, so memory is bounded and allocated once.
+ * When ring is full, oldest block is dropped.
+ *
+ * Block starts with full timestamp and value. Following timestamps are
+ * encoded as delta of delta, and values as XOR with previous value, so
+ * samples taken at steady interval with value which rarely changes take
+ * few bits.
+ *
+ * Statistics metadata selects stored series, only gauges are stored, and
+ * values are rounded to statistic precision before encoding, so noise
+ * below precision doesn't cost bits.
+ *
+ * Each block keeps time range of its samples, so range query decodes only
+ * blocks which overlap queried range.
+ *
+ * @{
+ */
+
+/**
+ * @brief History store configuration.
+ */
+typedef struct _otai_metadata_history_config_t
+{
+    /**
+     * @brief Object type of sampled objects.
+     */
+    otai_object_type_t                           objecttype;
+
+    /**
+     * @brief Number of stored statistics, 0 for all gauges of object type.
+     */
+    otai_uint32_t                                statcount;
+
+    /**
+     * @brief Stored statistics.
+     */
+    const otai_stat_id_t*                        statids;
+
+    /**
+     * @brief Maximum number of objects.
+     */
+    otai_uint32_t                                capacity;
+
+    /**
+     * @brief Block size in bytes.
+     */
+    otai_uint32_t                                blocksize;
+
+    /**
+     * @brief Number of blocks of each series.
+     */
+    otai_uint32_t                                blockcount;
+
+} otai_metadata_history_config_t;
+
+/**
+ * @brief History block header.
+ */
+typedef struct _otai_metadata_history_block_t
+{
+    /**
+     * @brief Time of first sample.
+     */
+    otai_uint64_t                                starttime;
+
+    /**
+     * @brief Time of last sample.
+     */
+    otai_uint64_t                                endtime;
+
+    /**
+     * @brief Number of samples.
+     */
+    otai_uint32_t                                samples;
+
+    /**
+     * @brief Number of used bits.
+     */
+    otai_uint32_t                                bits;
+
+} otai_metadata_history_block_t;
+
+/**
+ * @brief History series of single object and statistic.
+ */
+typedef struct _otai_metadata_history_series_t
+{
+    /**
+     * @brief Oldest block.
+     */
+    otai_uint32_t                                first;
+
+    /**
+     * @brief Number of used blocks.
+     */
+    otai_uint32_t                                count;
+
+    /**
+     * @brief Time of last sample.
+     */
+    otai_uint64_t                                lasttime;
+
+    /**
+     * @brief Delta between last two timestamps.
+     */
+    otai_int64_t                                 lastdelta;
+
+    /**
+     * @brief Bits of last value.
+     */
+    otai_uint64_t                                lastvalue;
+
+    /**
+     * @brief Leading zeros of last encoded XOR window, 64 if there is none.
+     */
+    otai_uint32_t                                leading;
+
+    /**
+     * @brief Trailing zeros of last encoded XOR window.
+     */
+    otai_uint32_t                                trailing;
+
+} otai_metadata_history_series_t;
+
+/**
+ * @brief History store.
+ */
+typedef struct _otai_metadata_history_t
+{
+    /**
+     * @brief Object type of sampled objects.
+     */
+    otai_object_type_t                           objecttype;
+
+    /**
+     * @brief Object type info, used to get stats.
+     */
+    const otai_object_type_info_t*               info;
+
+    /**
+     * @brief Number of stored statistics.
+     */
+    otai_uint32_t                                statcount;
+
+    /**
+     * @brief Stored statistics.
+     */
+    otai_stat_id_t*                              statids;
+
+    /**
+     * @brief Value type of stored statistics.
+     */
+    otai_stat_value_type_t*                      statvaluetypes;
+
+    /**
+     * @brief Rounding scale of stored statistics, 0 for full precision.
+     */
+    otai_uint32_t*                               scale;
+
+    /**
+     * @brief Maximum number of objects.
+     */
+    otai_uint32_t                                capacity;
+
+    /**
+     * @brief Number of objects.
+     */
+    otai_uint32_t                                objectcount;
+
+    /**
+     * @brief Stored objects.
+     */
+    otai_object_id_t*                            objects;
+
+    /**
+     * @brief Index of each stored object.
+     */
+    otai_metadata_objectmap_t                    objectmap;
+
+    /**
+     * @brief Block size in bytes.
+     */
+    otai_uint32_t                                blocksize;
+
+    /**
+     * @brief Number of blocks of each series.
+     */
+    otai_uint32_t                                blockcount;
+
+    /**
+     * @brief Series, indexed by statistic and object.
+     */
+    otai_metadata_history_series_t*              series;
+
+    /**
+     * @brief Block headers, indexed by series and block.
+     */
+    otai_metadata_history_block_t*               blocks;
+
+    /**
+     * @brief Block data, indexed by series and block.
+     */
+    otai_uint8_t*                                data;
+
+    /**
+     * @brief Sample buffer.
+     */
+    otai_stat_value_t*                           values;
+
+} otai_metadata_history_t;
+
+/**
+ * @brief Initialize history store
+ *
+ * All blocks are allocated here.
+ *
+ * @param[out] history History store
+ * @param[in] config Configuration
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if configuration is invalid or statistic is not gauge,
+ * #OTAI_STATUS_NO_MEMORY if blocks can't be allocated
+ */
+extern otai_status_t otai_metadata_history_init(
+        _Out_ otai_metadata_history_t *history,
+        _In_ const otai_metadata_history_config_t *config);
+
+/**
+ * @brief Release history store memory
+ *
+ * @param[inout] history History store
+ */
+extern void otai_metadata_history_destroy(
+        _Inout_ otai_metadata_history_t *history);
+
+/**
+ * @brief Add stored object
+ *
+ * @param[inout] history History store
+ * @param[in] object_id Object id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_ALREADY_EXISTS
+ * if object is already added, #OTAI_STATUS_TABLE_FULL if there is no room
+ */
+extern otai_status_t otai_metadata_history_add_object(
+        _Inout_ otai_metadata_history_t *history,
+        _In_ otai_object_id_t object_id);
+
+/**
+ * @brief Remove stored object and its history
+ *
+ * Last object takes place of removed object.
+ *
+ * @param[inout] history History store
+ * @param[in] object_id Object id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object is not added
+ */
+extern otai_status_t otai_metadata_history_remove_object(
+        _Inout_ otai_metadata_history_t *history,
+        _In_ otai_object_id_t object_id);
+
+/**
+ * @brief Append sample of single object
+ *
+ * @param[inout] history History store
+ * @param[in] object_id Object id
+ * @param[in] time Sample time in milliseconds
+ * @param[in] counters Values of stored statistics, in stored order
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object is not added, #OTAI_STATUS_INVALID_PARAMETER if time is older
+ * than last sample
+ */
+extern otai_status_t otai_metadata_history_update(
+        _Inout_ otai_metadata_history_t *history,
+        _In_ otai_object_id_t object_id,
+        _In_ uint64_t time,
+        _In_ const otai_stat_value_t *counters);
+
+/**
+ * @brief Sample all objects with get stats extended API
+ *
+ * Objects for which API fails are skipped.
+ *
+ * @param[inout] history History store
+ * @param[in] time Sample time in milliseconds
+ *
+ * @return #OTAI_STATUS_SUCCESS if all objects were sampled, otherwise
+ * status of last failed object
+ */
+extern otai_status_t otai_metadata_history_sample(
+        _Inout_ otai_metadata_history_t *history,
+        _In_ uint64_t time);
+
+/**
+ * @brief Get samples of series in time range
+ *
+ * @param[in] history History store
+ * @param[in] object_id Object id
+ * @param[in] stat_id Statistic id
+ * @param[in] start_time First time of range, inclusive
+ * @param[in] end_time Last time of range, inclusive
+ * @param[inout] count Size of output arrays on input, number of samples on output
+ * @param[out] times Sample times
+ * @param[out] values Sample values
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object or statistic is not stored, #OTAI_STATUS_BUFFER_OVERFLOW if range
+ * has more samples than output arrays, which are filled with oldest ones
+ */
+extern otai_status_t otai_metadata_history_query(
+        _In_ const otai_metadata_history_t *history,
+        _In_ otai_object_id_t object_id,
+        _In_ otai_stat_id_t stat_id,
+        _In_ uint64_t start_time,
+        _In_ uint64_t end_time,
+        _Inout_ uint32_t *count,
+        _Out_ uint64_t *times,
+        _Out_ double *values);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATAHISTORY_H_ */
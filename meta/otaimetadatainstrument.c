@@ -0,0 +1,751 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatainstrument.c
+ *
+ * @brief   This module implements OTAI Metadata API call instrumentation
+ */
+
+/* clock_gettime is not declared in strict ANSI mode */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <time.h>
+#include <pthread.h>
+#include "otaimetadata.h"
+#include "otaimetadatalogger.h"
+#include "otaimetadatainstrument.h"
+
+#define OTAI_METADATA_INSTRUMENT_SUB_BITS 3
+
+/* latencies of 2^36 ns and over go to last bucket */
+#define OTAI_METADATA_INSTRUMENT_MAX_MAGNITUDE 35
+
+#define OTAI_METADATA_INSTRUMENT_DEFAULT_SLOTS 1024
+
+/* set in key of used slot, so empty slot has key 0 */
+#define OTAI_METADATA_INSTRUMENT_USED (UINT64_C(1) << 63)
+
+#define OTAI_METADATA_INSTRUMENT_LOAD(_ptr) __atomic_load_n((_ptr), __ATOMIC_RELAXED)
+#define OTAI_METADATA_INSTRUMENT_STORE(_ptr, _val) __atomic_store_n((_ptr), (_val), __ATOMIC_RELAXED)
+
+/*
+ * Slot is written only by thread owning shard, so counters are updated
+ * with plain load and store, atomic only so snapshot reads whole values.
+ */
+#define OTAI_METADATA_INSTRUMENT_ADD(_ptr, _val) \
+    OTAI_METADATA_INSTRUMENT_STORE((_ptr), OTAI_METADATA_INSTRUMENT_LOAD(_ptr) + (_val))
+
+typedef struct _otai_metadata_instrument_slot_t
+{
+    /* published with release after histogram is allocated */
+    uint64_t key;
+
+    uint64_t calls;
+
+    uint64_t errors;
+
+    uint64_t total;
+
+    uint64_t max;
+
+    uint64_t *histogram;
+
+} otai_metadata_instrument_slot_t;
+
+typedef struct _otai_metadata_instrument_shard_t
+{
+    struct _otai_metadata_instrument_shard_t *next;
+
+    /* set while thread owns shard, shard of exited thread is adopted by next new thread */
+    uint32_t owned;
+
+    /* clear generation shard was cleared for */
+    uint32_t generation;
+
+    uint64_t dropped;
+
+    otai_metadata_instrument_slot_t *slots;
+
+} otai_metadata_instrument_shard_t;
+
+typedef struct _otai_metadata_instrument_t
+{
+    bool initialized;
+
+    uint32_t slots;
+
+    uint32_t generation;
+
+    /* calls of threads which have no shard */
+    uint64_t dropped;
+
+    otai_metadata_instrument_api_query_fn apiquery;
+
+    pthread_key_t key;
+
+    /* shards are never freed, so snapshot can walk list without lock */
+    otai_metadata_instrument_shard_t *shards;
+
+} otai_metadata_instrument_t;
+
+/*
+ * Instrumented methods have no user context, so instrumentation is global.
+ */
+static otai_metadata_instrument_t otai_metadata_instrument_global;
+
+static pthread_mutex_t otai_metadata_instrument_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const char otai_metadata_instrument_op_names[OTAI_METADATA_INSTRUMENT_OP_MAX][16] = {
+    "create",
+    "remove",
+    "set",
+    "get",
+    "bulk_create",
+    "bulk_remove",
+    "bulk_set",
+    "bulk_get",
+    "get_stats",
+    "get_stats_ext",
+    "clear_stats",
+    "bulk_get_stats",
+};
+
+static void otai_metadata_instrument_release_shard(
+        _In_ void *ptr)
+{
+    otai_metadata_instrument_shard_t *shard = (otai_metadata_instrument_shard_t*)ptr;
+
+    __atomic_store_n(&shard->owned, 0, __ATOMIC_RELEASE);
+}
+
+otai_status_t otai_metadata_instrument_init(
+        _In_ const otai_metadata_instrument_config_t *config)
+{
+    otai_metadata_instrument_t *instrument = &otai_metadata_instrument_global;
+
+    uint32_t slots = (config == NULL) ? 0 : config->slots;
+
+    if (slots == 0)
+    {
+        slots = OTAI_METADATA_INSTRUMENT_DEFAULT_SLOTS;
+    }
+
+    if (config == NULL || config->apiquery == NULL || (slots & (slots - 1)) != 0)
+    {
+        OTAI_META_LOG_ERROR("api query is NULL or slots %u is not power of 2", slots);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_lock(&otai_metadata_instrument_mutex);
+
+    if (instrument->initialized)
+    {
+        pthread_mutex_unlock(&otai_metadata_instrument_mutex);
+
+        OTAI_META_LOG_ERROR("instrumentation is already initialized");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (pthread_key_create(&instrument->key, otai_metadata_instrument_release_shard) != 0)
+    {
+        pthread_mutex_unlock(&otai_metadata_instrument_mutex);
+
+        OTAI_META_LOG_ERROR("failed to create thread key");
+
+        return OTAI_STATUS_FAILURE;
+    }
+
+    instrument->slots = slots;
+    instrument->apiquery = config->apiquery;
+
+    __atomic_store_n(&instrument->initialized, true, __ATOMIC_SEQ_CST);
+
+    pthread_mutex_unlock(&otai_metadata_instrument_mutex);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_instrument_api_query(
+        _In_ otai_api_t api,
+        _Out_ void **api_method_table)
+{
+    otai_metadata_instrument_t *instrument = &otai_metadata_instrument_global;
+
+    if (!__atomic_load_n(&instrument->initialized, __ATOMIC_ACQUIRE))
+    {
+        OTAI_META_LOG_ERROR("instrumentation is not initialized");
+
+        return OTAI_STATUS_UNINITIALIZED;
+    }
+
+    void *native = NULL;
+
+    otai_status_t status = instrument->apiquery(api, &native);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        *api_method_table = native;
+
+        return status;
+    }
+
+    /* wrapper tables are generated from api structs */
+
+    return otai_metadata_instrument_wrap_api(api, native, api_method_table);
+}
+
+uint64_t otai_metadata_instrument_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static otai_metadata_instrument_shard_t* otai_metadata_instrument_get_shard(
+        _In_ otai_metadata_instrument_t *instrument)
+{
+    otai_metadata_instrument_shard_t *shard = pthread_getspecific(instrument->key);
+
+    if (shard != NULL)
+    {
+        return shard;
+    }
+
+    /* adopt shard of exited thread, its calls are kept */
+
+    shard = __atomic_load_n(&instrument->shards, __ATOMIC_ACQUIRE);
+
+    for (; shard != NULL; shard = shard->next)
+    {
+        uint32_t expected = 0;
+
+        if (__atomic_compare_exchange_n(&shard->owned, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            break;
+        }
+    }
+
+    if (shard == NULL)
+    {
+        shard = calloc(1, sizeof(otai_metadata_instrument_shard_t));
+
+        if (shard == NULL)
+        {
+            return NULL;
+        }
+
+        shard->slots = calloc(instrument->slots, sizeof(otai_metadata_instrument_slot_t));
+
+        if (shard->slots == NULL)
+        {
+            free(shard);
+
+            return NULL;
+        }
+
+        shard->owned = 1;
+        shard->generation = __atomic_load_n(&instrument->generation, __ATOMIC_ACQUIRE);
+        shard->next = __atomic_load_n(&instrument->shards, __ATOMIC_RELAXED);
+
+        while (!__atomic_compare_exchange_n(&instrument->shards, &shard->next, shard, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    }
+
+    pthread_setspecific(instrument->key, shard);
+
+    return shard;
+}
+
+static void otai_metadata_instrument_clear_shard(
+        _In_ const otai_metadata_instrument_t *instrument,
+        _Inout_ otai_metadata_instrument_shard_t *shard)
+{
+    uint32_t idx;
+
+    /* keys stay, so slots don't move, snapshot skips slots without calls */
+
+    for (idx = 0; idx < instrument->slots; idx++)
+    {
+        otai_metadata_instrument_slot_t *slot = &shard->slots[idx];
+
+        if (slot->key == 0)
+        {
+            continue;
+        }
+
+        OTAI_METADATA_INSTRUMENT_STORE(&slot->calls, 0);
+        OTAI_METADATA_INSTRUMENT_STORE(&slot->errors, 0);
+        OTAI_METADATA_INSTRUMENT_STORE(&slot->total, 0);
+        OTAI_METADATA_INSTRUMENT_STORE(&slot->max, 0);
+
+        uint32_t bucket;
+
+        for (bucket = 0; bucket < OTAI_METADATA_INSTRUMENT_BUCKETS; bucket++)
+        {
+            OTAI_METADATA_INSTRUMENT_STORE(&slot->histogram[bucket], 0);
+        }
+    }
+
+    OTAI_METADATA_INSTRUMENT_STORE(&shard->dropped, 0);
+}
+
+static uint32_t otai_metadata_instrument_bucket(
+        _In_ uint64_t value)
+{
+    if (value < OTAI_METADATA_INSTRUMENT_SUB_BUCKETS)
+    {
+        return (uint32_t)value;
+    }
+
+    uint32_t magnitude = 63 - (uint32_t)__builtin_clzll(value);
+
+    if (magnitude > OTAI_METADATA_INSTRUMENT_MAX_MAGNITUDE)
+    {
+        return OTAI_METADATA_INSTRUMENT_BUCKETS - 1;
+    }
+
+    uint32_t sub = (uint32_t)(value >> (magnitude - OTAI_METADATA_INSTRUMENT_SUB_BITS)) & (OTAI_METADATA_INSTRUMENT_SUB_BUCKETS - 1);
+
+    return (magnitude - OTAI_METADATA_INSTRUMENT_SUB_BITS + 1) * OTAI_METADATA_INSTRUMENT_SUB_BUCKETS + sub;
+}
+
+static uint64_t otai_metadata_instrument_bucket_high(
+        _In_ uint32_t bucket)
+{
+    if (bucket < OTAI_METADATA_INSTRUMENT_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+
+    uint32_t shift = bucket / OTAI_METADATA_INSTRUMENT_SUB_BUCKETS - 1;
+    uint64_t sub = bucket % OTAI_METADATA_INSTRUMENT_SUB_BUCKETS;
+
+    return ((OTAI_METADATA_INSTRUMENT_SUB_BUCKETS + sub + 1) << shift) - 1;
+}
+
+void otai_metadata_instrument_record(
+        _In_ otai_api_t api,
+        _In_ otai_metadata_instrument_op_t op,
+        _In_ otai_object_type_t object_type,
+        _In_ otai_attr_id_t attr_id,
+        _In_ uint64_t start,
+        _In_ otai_status_t status)
+{
+    otai_metadata_instrument_t *instrument = &otai_metadata_instrument_global;
+
+    uint64_t now = otai_metadata_instrument_now();
+    uint64_t elapsed = now > start ? now - start : 0;
+
+    if (!__atomic_load_n(&instrument->initialized, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    otai_metadata_instrument_shard_t *shard = otai_metadata_instrument_get_shard(instrument);
+
+    if (shard == NULL)
+    {
+        __atomic_fetch_add(&instrument->dropped, 1, __ATOMIC_RELAXED);
+
+        return;
+    }
+
+    uint32_t generation = __atomic_load_n(&instrument->generation, __ATOMIC_ACQUIRE);
+
+    if (shard->generation != generation)
+    {
+        otai_metadata_instrument_clear_shard(instrument, shard);
+
+        __atomic_store_n(&shard->generation, generation, __ATOMIC_RELEASE);
+    }
+
+    uint64_t key = OTAI_METADATA_INSTRUMENT_USED |
+        (uint64_t)((uint32_t)api & 0x7FFF) << 48 |
+        (uint64_t)((uint32_t)op & 0xFF) << 40 |
+        (uint64_t)((uint32_t)object_type & 0xFF) << 32 |
+        attr_id;
+
+    uint32_t mask = instrument->slots - 1;
+    uint32_t idx = (uint32_t)((key * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & mask;
+    uint32_t probe;
+
+    otai_metadata_instrument_slot_t *slot = NULL;
+
+    for (probe = 0; probe <= mask; probe++, idx = (idx + 1) & mask)
+    {
+        slot = &shard->slots[idx];
+
+        if (slot->key == key)
+        {
+            break;
+        }
+
+        if (slot->key == 0)
+        {
+            if (slot->histogram == NULL)
+            {
+                slot->histogram = calloc(OTAI_METADATA_INSTRUMENT_BUCKETS, sizeof(uint64_t));
+            }
+
+            if (slot->histogram == NULL)
+            {
+                probe = mask + 1;
+
+                break;
+            }
+
+            __atomic_store_n(&slot->key, key, __ATOMIC_RELEASE);
+
+            break;
+        }
+    }
+
+    if (probe > mask)
+    {
+        OTAI_METADATA_INSTRUMENT_ADD(&shard->dropped, 1);
+
+        return;
+    }
+
+    OTAI_METADATA_INSTRUMENT_ADD(&slot->calls, 1);
+    OTAI_METADATA_INSTRUMENT_ADD(&slot->errors, (uint64_t)(status != OTAI_STATUS_SUCCESS));
+    OTAI_METADATA_INSTRUMENT_ADD(&slot->total, elapsed);
+    OTAI_METADATA_INSTRUMENT_ADD(&slot->histogram[otai_metadata_instrument_bucket(elapsed)], 1);
+
+    if (elapsed > slot->max)
+    {
+        OTAI_METADATA_INSTRUMENT_STORE(&slot->max, elapsed);
+    }
+}
+
+static int otai_metadata_instrument_compare(
+        _In_ const void *a,
+        _In_ const void *b)
+{
+    uint64_t ka = (*(const otai_metadata_instrument_slot_t* const*)a)->key;
+    uint64_t kb = (*(const otai_metadata_instrument_slot_t* const*)b)->key;
+
+    return (ka > kb) - (ka < kb);
+}
+
+static bool otai_metadata_instrument_is_current(
+        _In_ const otai_metadata_instrument_t *instrument,
+        _In_ const otai_metadata_instrument_shard_t *shard)
+{
+    /* shard not cleared yet by its thread is read as empty */
+
+    return __atomic_load_n(&shard->generation, __ATOMIC_ACQUIRE) ==
+        __atomic_load_n(&instrument->generation, __ATOMIC_ACQUIRE);
+}
+
+static void otai_metadata_instrument_merge(
+        _Inout_ otai_metadata_instrument_entry_t *entry,
+        _In_ const otai_metadata_instrument_slot_t *slot)
+{
+    uint64_t max = OTAI_METADATA_INSTRUMENT_LOAD(&slot->max);
+    uint32_t bucket;
+
+    entry->calls += OTAI_METADATA_INSTRUMENT_LOAD(&slot->calls);
+    entry->errors += OTAI_METADATA_INSTRUMENT_LOAD(&slot->errors);
+    entry->total += OTAI_METADATA_INSTRUMENT_LOAD(&slot->total);
+    entry->max = max > entry->max ? max : entry->max;
+
+    for (bucket = 0; bucket < OTAI_METADATA_INSTRUMENT_BUCKETS; bucket++)
+    {
+        entry->histogram[bucket] += OTAI_METADATA_INSTRUMENT_LOAD(&slot->histogram[bucket]);
+    }
+}
+
+otai_status_t otai_metadata_instrument_snapshot(
+        _Inout_ uint32_t *count,
+        _Out_ otai_metadata_instrument_entry_t *entries)
+{
+    otai_metadata_instrument_t *instrument = &otai_metadata_instrument_global;
+
+    if (!__atomic_load_n(&instrument->initialized, __ATOMIC_ACQUIRE))
+    {
+        *count = 0;
+
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    otai_metadata_instrument_shard_t *head = __atomic_load_n(&instrument->shards, __ATOMIC_ACQUIRE);
+    otai_metadata_instrument_shard_t *shard;
+
+    size_t capacity = 0;
+
+    for (shard = head; shard != NULL; shard = shard->next)
+    {
+        capacity += instrument->slots;
+    }
+
+    /* slots of all shards sorted by key, so equal keys are adjacent */
+
+    const otai_metadata_instrument_slot_t **sorted = calloc(capacity + 1, sizeof(otai_metadata_instrument_slot_t*));
+
+    if (sorted == NULL)
+    {
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    size_t used = 0;
+
+    for (shard = head; shard != NULL; shard = shard->next)
+    {
+        uint32_t idx;
+
+        if (!otai_metadata_instrument_is_current(instrument, shard))
+        {
+            continue;
+        }
+
+        for (idx = 0; idx < instrument->slots; idx++)
+        {
+            if (__atomic_load_n(&shard->slots[idx].key, __ATOMIC_ACQUIRE) != 0)
+            {
+                sorted[used++] = &shard->slots[idx];
+            }
+        }
+    }
+
+    qsort(sorted, used, sizeof(otai_metadata_instrument_slot_t*), otai_metadata_instrument_compare);
+
+    otai_metadata_instrument_entry_t entry;
+
+    uint32_t size = *count;
+    uint32_t found = 0;
+    size_t idx = 0;
+
+    while (idx < used)
+    {
+        uint64_t key = sorted[idx]->key;
+
+        memset(&entry, 0, sizeof(entry));
+
+        for (; idx < used && sorted[idx]->key == key; idx++)
+        {
+            otai_metadata_instrument_merge(&entry, sorted[idx]);
+        }
+
+        if (entry.calls == 0)
+        {
+            continue;
+        }
+
+        entry.api = (otai_api_t)(key >> 48 & 0x7FFF);
+        entry.op = (otai_metadata_instrument_op_t)(key >> 40 & 0xFF);
+        entry.objecttype = (otai_object_type_t)(key >> 32 & 0xFF);
+        entry.id = (uint32_t)key;
+
+        if (found < size)
+        {
+            entries[found] = entry;
+        }
+
+        found++;
+    }
+
+    free(sorted);
+
+    *count = found;
+
+    return found > size ? OTAI_STATUS_BUFFER_OVERFLOW : OTAI_STATUS_SUCCESS;
+}
+
+uint64_t otai_metadata_instrument_get_dropped(void)
+{
+    otai_metadata_instrument_t *instrument = &otai_metadata_instrument_global;
+
+    uint64_t dropped = __atomic_load_n(&instrument->dropped, __ATOMIC_RELAXED);
+
+    otai_metadata_instrument_shard_t *shard = __atomic_load_n(&instrument->shards, __ATOMIC_ACQUIRE);
+
+    for (; shard != NULL; shard = shard->next)
+    {
+        if (otai_metadata_instrument_is_current(instrument, shard))
+        {
+            dropped += OTAI_METADATA_INSTRUMENT_LOAD(&shard->dropped);
+        }
+    }
+
+    return dropped;
+}
+
+uint64_t otai_metadata_instrument_percentile(
+        _In_ const otai_metadata_instrument_entry_t *entry,
+        _In_ double percentile)
+{
+    uint64_t calls = 0;
+    uint32_t bucket;
+
+    /* histogram is read separately from calls, so count it again */
+
+    for (bucket = 0; bucket < OTAI_METADATA_INSTRUMENT_BUCKETS; bucket++)
+    {
+        calls += entry->histogram[bucket];
+    }
+
+    if (calls == 0)
+    {
+        return 0;
+    }
+
+    double rank = percentile * (double)calls / 100;
+
+    uint64_t target = rank < 1 ? 1 : (uint64_t)rank;
+
+    target += (rank > (double)target) ? 1 : 0;
+    target = target > calls ? calls : target;
+
+    uint64_t seen = 0;
+
+    for (bucket = 0; bucket < OTAI_METADATA_INSTRUMENT_BUCKETS - 1; bucket++)
+    {
+        seen += entry->histogram[bucket];
+
+        if (seen >= target)
+        {
+            break;
+        }
+    }
+
+    uint64_t high = otai_metadata_instrument_bucket_high(bucket);
+
+    return (bucket == OTAI_METADATA_INSTRUMENT_BUCKETS - 1 || high > entry->max) ? entry->max : high;
+}
+
+void otai_metadata_instrument_clear(void)
+{
+    otai_metadata_instrument_t *instrument = &otai_metadata_instrument_global;
+
+    __atomic_store_n(&instrument->dropped, 0, __ATOMIC_RELAXED);
+
+    __atomic_fetch_add(&instrument->generation, 1, __ATOMIC_ACQ_REL);
+}
+
+static void otai_metadata_instrument_dump_id(
+        _In_ const otai_metadata_instrument_entry_t *entry,
+        _Out_ char *buffer,
+        _In_ size_t size)
+{
+    const char *name = NULL;
+
+    if (entry->id == OTAI_METADATA_INSTRUMENT_ID_ANY)
+    {
+        name = "-";
+    }
+    else if (entry->op == OTAI_METADATA_INSTRUMENT_OP_SET || entry->op == OTAI_METADATA_INSTRUMENT_OP_GET)
+    {
+        const otai_attr_metadata_t *meta = otai_metadata_get_attr_metadata(entry->objecttype, entry->id);
+
+        name = (meta == NULL) ? NULL : meta->attridname;
+    }
+    else
+    {
+        const otai_stat_metadata_t *meta = otai_metadata_get_stat_metadata(entry->objecttype, entry->id);
+
+        name = (meta == NULL) ? NULL : meta->statidname;
+    }
+
+    if (name == NULL)
+    {
+        snprintf(buffer, size, "0x%x", entry->id);
+    }
+    else
+    {
+        snprintf(buffer, size, "%s", name);
+    }
+}
+
+otai_status_t otai_metadata_instrument_dump(
+        _In_ const char *dump_file_name)
+{
+    otai_metadata_instrument_entry_t *entries = NULL;
+
+    uint32_t count = 0;
+
+    otai_status_t status = otai_metadata_instrument_snapshot(&count, NULL);
+
+    /* calls may add entries between size query and snapshot */
+
+    while (status == OTAI_STATUS_BUFFER_OVERFLOW)
+    {
+        free(entries);
+
+        count += 16;
+
+        entries = calloc(count, sizeof(otai_metadata_instrument_entry_t));
+
+        if (entries == NULL)
+        {
+            return OTAI_STATUS_NO_MEMORY;
+        }
+
+        status = otai_metadata_instrument_snapshot(&count, entries);
+    }
+
+    FILE *file = (status == OTAI_STATUS_SUCCESS) ? fopen(dump_file_name, "a") : NULL;
+
+    if (file == NULL)
+    {
+        free(entries);
+
+        OTAI_META_LOG_ERROR("failed to open %s", dump_file_name);
+
+        return (status == OTAI_STATUS_SUCCESS) ? OTAI_STATUS_FAILURE : status;
+    }
+
+    fprintf(file, "OTAI API calls, latencies in ns, dropped %" PRIu64 "\n", otai_metadata_instrument_get_dropped());
+    fprintf(file, "%-28s %-14s %-48s %10s %8s %10s %10s %10s %10s %10s\n",
+            "api", "op", "id", "calls", "errors", "avg", "p50", "p99", "p99.9", "max");
+
+    uint32_t idx;
+
+    for (idx = 0; idx < count; idx++)
+    {
+        const otai_metadata_instrument_entry_t *entry = &entries[idx];
+
+        const char *api = otai_metadata_get_enum_value_name(&otai_metadata_enum_otai_api_t, entry->api);
+
+        char id[128];
+
+        otai_metadata_instrument_dump_id(entry, id, sizeof(id));
+
+        fprintf(file, "%-28s %-14s %-48s %10" PRIu64 " %8" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n",
+                api == NULL ? "unknown" : api,
+                entry->op < OTAI_METADATA_INSTRUMENT_OP_MAX ? otai_metadata_instrument_op_names[entry->op] : "unknown",
+                id,
+                entry->calls,
+                entry->errors,
+                entry->total / entry->calls,
+                otai_metadata_instrument_percentile(entry, 50),
+                otai_metadata_instrument_percentile(entry, 99),
+                otai_metadata_instrument_percentile(entry, 99.9),
+                entry->max);
+    }
+
+    int result = fclose(file);
+
+    free(entries);
+
+    return (result == 0) ? OTAI_STATUS_SUCCESS : OTAI_STATUS_FAILURE;
+}
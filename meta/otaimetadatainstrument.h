@@ -0,0 +1,344 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatainstrument.h
+ *
+ * @brief   This module defines OTAI Metadata API call instrumentation
+ */
+
+#ifndef __OTAIMETADATAINSTRUMENT_H_
+#define __OTAIMETADATAINSTRUMENT_H_
+
+#include "otaimetadatatypes.h"
+
+/**
+ * @defgroup OTAIMETADATAINSTRUMENT OTAI - Metadata API call instrumentation
+ *
+ * Instrumentation wraps method tables returned by otai_api_query() with
+ * tables of the same type, whose methods call adapter and record call
+ * count, error count and latency histogram of each API, operation, object
+ * type and attribute or statistics id.
+ *
+ * Application passes otai_metadata_instrument_api_query() where it would
+ * use otai_api_query(), for example to otai_metadata_apis_query(). Methods
+ * which adapter doesn't implement stay NULL.
+ *
+ * Each thread records to its own shard, so recording takes no lock and
+ * shares no cache line with other threads. Snapshot merges all shards.
+ *
+ * Latency histogram has logarithmic buckets, each power of 2 is split to
+ * #OTAI_METADATA_INSTRUMENT_SUB_BUCKETS linear buckets, so value is known
+ * within 12.5 percent from 1 ns to over a minute.
+ *
+ * @{
+ */
+
+/**
+ * @def OTAI_METADATA_INSTRUMENT_SUB_BUCKETS
+ * Number of histogram buckets of each power of 2.
+ */
+#define OTAI_METADATA_INSTRUMENT_SUB_BUCKETS 8
+
+/**
+ * @def OTAI_METADATA_INSTRUMENT_BUCKETS
+ * Number of histogram buckets, last one also counts latencies over 2^36 ns.
+ */
+#define OTAI_METADATA_INSTRUMENT_BUCKETS 272
+
+/**
+ * @def OTAI_METADATA_INSTRUMENT_ID_ANY
+ * Id of call with no attribute or statistics id, or with more than one.
+ */
+#define OTAI_METADATA_INSTRUMENT_ID_ANY 0xFFFFFFFF
+
+/**
+ * @brief Instrumented operation.
+ *
+ * Operations of otai_common_api_t have the same value, statistics
+ * operations follow them.
+ */
+typedef enum _otai_metadata_instrument_op_t
+{
+    /**
+     * @brief Create object.
+     */
+    OTAI_METADATA_INSTRUMENT_OP_CREATE = OTAI_COMMON_API_CREATE,
+
+    /**
+     * @brief Remove object.
+     */
+    OTAI_METADATA_INSTRUMENT_OP_REMOVE = OTAI_COMMON_API_REMOVE,
+
+    /**
+     * @brief Set attribute.
+     */
+    OTAI_METADATA_INSTRUMENT_OP_SET = OTAI_COMMON_API_SET,
+
+    /**
+     * @brief Get attributes.
+     */
+    OTAI_METADATA_INSTRUMENT_OP_GET = OTAI_COMMON_API_GET,
+
+    /**
+     * @brief Bulk create objects.
+     */
+    OTAI_METADATA_INSTRUMENT_OP_BULK_CREATE = OTAI_COMMON_API_BULK_CREATE,
+
+    /**
+     * @brief Bulk remove objects.
+     */
+    OTAI_METADATA_INSTRUMENT_OP_BULK_REMOVE = OTAI_COMMON_API_BULK_REMOVE,
+
+    /**
+     * @brief Bulk set attribute.
+     */
+    OTAI_METADATA_INSTRUMENT_OP_BULK_SET = OTAI_COMMON_API_BULK_SET,
+
+    /**
+     * @brief Bulk get attributes.
+     */
+    OTAI_METADATA_INSTRUMENT_OP_BULK_GET = OTAI_COMMON_API_BULK_GET,
+
+    /**
+     * @brief Get statistics.
+     */
+    OTAI_METADATA_INSTRUMENT_OP_GET_STATS = OTAI_COMMON_API_MAX,
+
+    /**
+     * @brief Get statistics with mode.
+     */
+    OTAI_METADATA_INSTRUMENT_OP_GET_STATS_EXT,
+
+    /**
+     * @brief Clear statistics.
+     */
+    OTAI_METADATA_INSTRUMENT_OP_CLEAR_STATS,
+
+    /**
+     * @brief Bulk get statistics.
+     */
+    OTAI_METADATA_INSTRUMENT_OP_BULK_GET_STATS,
+
+    /**
+     * @brief Number of operations.
+     */
+    OTAI_METADATA_INSTRUMENT_OP_MAX,
+
+} otai_metadata_instrument_op_t;
+
+/**
+ * @brief Query API method table.
+ *
+ * Signature is the same as otai_api_query().
+ *
+ * @param[in] api API id
+ * @param[out] api_method_table Method table
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, failure status code on error
+ */
+typedef otai_status_t (*otai_metadata_instrument_api_query_fn)(
+        _In_ otai_api_t api,
+        _Out_ void **api_method_table);
+
+/**
+ * @brief Instrumentation configuration.
+ */
+typedef struct _otai_metadata_instrument_config_t
+{
+    /**
+     * @brief Adapter API query, usually otai_api_query().
+     */
+    const otai_metadata_instrument_api_query_fn  apiquery;
+
+    /**
+     * @brief Maximum number of keys recorded by each thread, power of 2, or 0.
+     */
+    otai_uint32_t                                slots;
+
+} otai_metadata_instrument_config_t;
+
+/**
+ * @brief Calls of single key.
+ */
+typedef struct _otai_metadata_instrument_entry_t
+{
+    /**
+     * @brief API.
+     */
+    otai_api_t                                   api;
+
+    /**
+     * @brief Operation.
+     */
+    otai_metadata_instrument_op_t                op;
+
+    /**
+     * @brief Object type.
+     */
+    otai_object_type_t                           objecttype;
+
+    /**
+     * @brief Attribute or statistics id.
+     */
+    otai_uint32_t                                id;
+
+    /**
+     * @brief Number of calls.
+     */
+    otai_uint64_t                                calls;
+
+    /**
+     * @brief Number of calls which didn't return #OTAI_STATUS_SUCCESS.
+     */
+    otai_uint64_t                                errors;
+
+    /**
+     * @brief Sum of latencies in nanoseconds.
+     */
+    otai_uint64_t                                total;
+
+    /**
+     * @brief Largest latency in nanoseconds.
+     */
+    otai_uint64_t                                max;
+
+    /**
+     * @brief Number of calls in each latency bucket.
+     */
+    otai_uint64_t                                histogram[OTAI_METADATA_INSTRUMENT_BUCKETS];
+
+} otai_metadata_instrument_entry_t;
+
+/**
+ * @brief Initialize instrumentation
+ *
+ * Slots of 0 selects default size.
+ *
+ * @param[in] config Configuration
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if configuration is invalid or instrumentation is already initialized
+ */
+extern otai_status_t otai_metadata_instrument_init(
+        _In_ const otai_metadata_instrument_config_t *config);
+
+/**
+ * @brief Query instrumented API method table
+ *
+ * Signature is the same as otai_api_query(). Tables are never freed, so
+ * threads may call through table while API is queried again. Query of
+ * same adapter table returns same table.
+ *
+ * @param[in] api API id
+ * @param[out] api_method_table Instrumented method table
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_UNINITIALIZED if
+ * instrumentation is not initialized, #OTAI_STATUS_NO_MEMORY if table
+ * can't be allocated, or status of adapter query
+ */
+extern otai_status_t otai_metadata_instrument_api_query(
+        _In_ otai_api_t api,
+        _Out_ void **api_method_table);
+
+/**
+ * @brief Get current time for latency
+ *
+ * @return Monotonic time in nanoseconds
+ */
+extern uint64_t otai_metadata_instrument_now(void);
+
+/**
+ * @brief Record call
+ *
+ * Used by instrumented methods, and may be used to record calls made
+ * outside of method tables.
+ *
+ * @param[in] api API
+ * @param[in] op Operation
+ * @param[in] object_type Object type
+ * @param[in] attr_id Attribute id, or statistics id of statistics operation
+ * @param[in] start Time of call from otai_metadata_instrument_now()
+ * @param[in] status Status returned by call
+ */
+extern void otai_metadata_instrument_record(
+        _In_ otai_api_t api,
+        _In_ otai_metadata_instrument_op_t op,
+        _In_ otai_object_type_t object_type,
+        _In_ otai_attr_id_t attr_id,
+        _In_ uint64_t start,
+        _In_ otai_status_t status);
+
+/**
+ * @brief Get snapshot of all shards
+ *
+ * Entries are sorted by API, operation, object type and id. Shards are
+ * read while threads record, so entry may miss calls in progress.
+ *
+ * @param[inout] count Size of entries array on input, number of entries on output
+ * @param[out] entries Entries
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_BUFFER_OVERFLOW if
+ * there are more entries, count is then set to required size,
+ * #OTAI_STATUS_NO_MEMORY if merge buffer can't be allocated
+ */
+extern otai_status_t otai_metadata_instrument_snapshot(
+        _Inout_ uint32_t *count,
+        _Out_ otai_metadata_instrument_entry_t *entries);
+
+/**
+ * @brief Get number of calls which didn't fit thread shard
+ *
+ * @return Number of calls not recorded
+ */
+extern uint64_t otai_metadata_instrument_get_dropped(void);
+
+/**
+ * @brief Get latency percentile
+ *
+ * @param[in] entry Entry
+ * @param[in] percentile Percentile from 0 to 100
+ *
+ * @return Highest latency of bucket of percentile in nanoseconds, 0 if
+ * there are no calls
+ */
+extern uint64_t otai_metadata_instrument_percentile(
+        _In_ const otai_metadata_instrument_entry_t *entry,
+        _In_ double percentile);
+
+/**
+ * @brief Clear all shards
+ *
+ * Each thread clears its shard on its next call.
+ */
+extern void otai_metadata_instrument_clear(void);
+
+/**
+ * @brief Append text dump of snapshot to file
+ *
+ * Signature is the same as otai_dbg_generate_dump(), so adapter can call
+ * it from its own dump.
+ *
+ * @param[in] dump_file_name File name
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_FAILURE if file
+ * can't be written, #OTAI_STATUS_NO_MEMORY if snapshot can't be allocated
+ */
+extern otai_status_t otai_metadata_instrument_dump(
+        _In_ const char *dump_file_name);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATAINSTRUMENT_H_ */
@@ -0,0 +1,220 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadataobjectmap.c
+ *
+ * @brief   This module implements OTAI Metadata object index map
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <otai.h>
+#include "otaimetadataobjectmap.h"
+
+#define OTAI_METADATA_OBJECTMAP_MAX_CAPACITY 0x40000000
+
+/*
+ * Object ids of one type differ only in low bits, so bits are mixed before
+ * slot is taken from low bits of hash.
+ */
+static uint32_t otai_metadata_objectmap_hash(
+        _In_ otai_object_id_t object_id)
+{
+    uint64_t hash = object_id;
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+
+    return (uint32_t)hash;
+}
+
+otai_status_t otai_metadata_objectmap_init(
+        _Out_ otai_metadata_objectmap_t *map,
+        _In_ uint32_t capacity)
+{
+    memset(map, 0, sizeof(otai_metadata_objectmap_t));
+
+    if (capacity == 0 || capacity > OTAI_METADATA_OBJECTMAP_MAX_CAPACITY)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t size = 4;
+
+    while (size < 2 * capacity)
+    {
+        size <<= 1;
+    }
+
+    map->slots = calloc(size, sizeof(otai_metadata_objectmap_slot_t));
+
+    if (map->slots == NULL)
+    {
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    map->mask = size - 1;
+    map->capacity = capacity;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+void otai_metadata_objectmap_destroy(
+        _Inout_ otai_metadata_objectmap_t *map)
+{
+    free(map->slots);
+
+    memset(map, 0, sizeof(otai_metadata_objectmap_t));
+}
+
+/*
+ * Returns slot of object or empty slot where object would be placed.
+ */
+static uint32_t otai_metadata_objectmap_probe(
+        _In_ const otai_metadata_objectmap_t *map,
+        _In_ otai_object_id_t object_id)
+{
+    uint32_t slot = otai_metadata_objectmap_hash(object_id) & map->mask;
+
+    while (map->slots[slot].index != 0 && map->slots[slot].objectid != object_id)
+    {
+        slot = (slot + 1) & map->mask;
+    }
+
+    return slot;
+}
+
+bool otai_metadata_objectmap_find(
+        _In_ const otai_metadata_objectmap_t *map,
+        _In_ otai_object_id_t object_id,
+        _Out_ uint32_t *index)
+{
+    if (map->slots == NULL)
+    {
+        return false;
+    }
+
+    const otai_metadata_objectmap_slot_t *slot = &map->slots[otai_metadata_objectmap_probe(map, object_id)];
+
+    if (slot->index == 0)
+    {
+        return false;
+    }
+
+    *index = slot->index - 1;
+
+    return true;
+}
+
+otai_status_t otai_metadata_objectmap_insert(
+        _Inout_ otai_metadata_objectmap_t *map,
+        _In_ otai_object_id_t object_id,
+        _In_ uint32_t index)
+{
+    if (map->slots == NULL)
+    {
+        return OTAI_STATUS_UNINITIALIZED;
+    }
+
+    otai_metadata_objectmap_slot_t *slot = &map->slots[otai_metadata_objectmap_probe(map, object_id)];
+
+    if (slot->index != 0)
+    {
+        return OTAI_STATUS_ITEM_ALREADY_EXISTS;
+    }
+
+    if (map->count >= map->capacity)
+    {
+        return OTAI_STATUS_TABLE_FULL;
+    }
+
+    slot->objectid = object_id;
+    slot->index = index + 1;
+
+    map->count++;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_objectmap_set(
+        _Inout_ otai_metadata_objectmap_t *map,
+        _In_ otai_object_id_t object_id,
+        _In_ uint32_t index)
+{
+    if (map->slots == NULL)
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    otai_metadata_objectmap_slot_t *slot = &map->slots[otai_metadata_objectmap_probe(map, object_id)];
+
+    if (slot->index == 0)
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    slot->index = index + 1;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_objectmap_remove(
+        _Inout_ otai_metadata_objectmap_t *map,
+        _In_ otai_object_id_t object_id)
+{
+    if (map->slots == NULL)
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    uint32_t hole = otai_metadata_objectmap_probe(map, object_id);
+
+    if (map->slots[hole].index == 0)
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    /*
+     * Entries after hole, which would not be found once hole is empty, are
+     * moved back into hole, up to first empty slot.
+     */
+
+    uint32_t slot = (hole + 1) & map->mask;
+
+    while (map->slots[slot].index != 0)
+    {
+        uint32_t home = otai_metadata_objectmap_hash(map->slots[slot].objectid) & map->mask;
+
+        if (((slot - home) & map->mask) >= ((slot - hole) & map->mask))
+        {
+            map->slots[hole] = map->slots[slot];
+
+            hole = slot;
+        }
+
+        slot = (slot + 1) & map->mask;
+    }
+
+    map->slots[hole].objectid = OTAI_NULL_OBJECT_ID;
+    map->slots[hole].index = 0;
+
+    map->count--;
+
+    return OTAI_STATUS_SUCCESS;
+}
@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadataobjectmap.h
+ *
+ * @brief   This module defines OTAI Metadata object index map
+ */
+
+#ifndef __OTAIMETADATAOBJECTMAP_H_
+#define __OTAIMETADATAOBJECTMAP_H_
+
+#include "otaimetadatatypes.h"
+
+/**
+ * @defgroup OTAIMETADATAOBJECTMAP OTAI - Metadata object index map
+ *
+ * Object map maps object id to index of object in arrays of fixed capacity
+ * tables, like PM, rate or history engine, so lookup of object doesn't
+ * scan all objects.
+ *
+ * Map is open addressing hash table with at least twice as many slots as
+ * capacity, so probe sequences stay short. Removed entries are not marked,
+ * following entries are moved back instead.
+ *
+ * @{
+ */
+
+/**
+ * @brief Object map slot.
+ */
+typedef struct _otai_metadata_objectmap_slot_t
+{
+    /**
+     * @brief Object id.
+     */
+    otai_object_id_t                             objectid;
+
+    /**
+     * @brief Object index plus one, zero for empty slot.
+     */
+    otai_uint32_t                                index;
+
+} otai_metadata_objectmap_slot_t;
+
+/**
+ * @brief Object map.
+ */
+typedef struct _otai_metadata_objectmap_t
+{
+    /**
+     * @brief Slots, number of slots is power of two.
+     */
+    otai_metadata_objectmap_slot_t*              slots;
+
+    /**
+     * @brief Number of slots minus one.
+     */
+    otai_uint32_t                                mask;
+
+    /**
+     * @brief Maximum number of objects.
+     */
+    otai_uint32_t                                capacity;
+
+    /**
+     * @brief Number of objects.
+     */
+    otai_uint32_t                                count;
+
+} otai_metadata_objectmap_t;
+
+/**
+ * @brief Initialize object map
+ *
+ * @param[out] map Object map
+ * @param[in] capacity Maximum number of objects
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if capacity is zero or too big, #OTAI_STATUS_NO_MEMORY if slots can't be
+ * allocated
+ */
+extern otai_status_t otai_metadata_objectmap_init(
+        _Out_ otai_metadata_objectmap_t *map,
+        _In_ uint32_t capacity);
+
+/**
+ * @brief Release object map memory
+ *
+ * @param[inout] map Object map
+ */
+extern void otai_metadata_objectmap_destroy(
+        _Inout_ otai_metadata_objectmap_t *map);
+
+/**
+ * @brief Find object index
+ *
+ * @param[in] map Object map
+ * @param[in] object_id Object id
+ * @param[out] index Object index
+ *
+ * @return True if object is in map
+ */
+extern bool otai_metadata_objectmap_find(
+        _In_ const otai_metadata_objectmap_t *map,
+        _In_ otai_object_id_t object_id,
+        _Out_ uint32_t *index);
+
+/**
+ * @brief Add object
+ *
+ * @param[inout] map Object map
+ * @param[in] object_id Object id
+ * @param[in] index Object index
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_ALREADY_EXISTS
+ * if object is already in map, #OTAI_STATUS_TABLE_FULL if there is no room
+ */
+extern otai_status_t otai_metadata_objectmap_insert(
+        _Inout_ otai_metadata_objectmap_t *map,
+        _In_ otai_object_id_t object_id,
+        _In_ uint32_t index);
+
+/**
+ * @brief Change index of object
+ *
+ * Used when table moves object, like when last object takes place of
+ * removed one.
+ *
+ * @param[inout] map Object map
+ * @param[in] object_id Object id
+ * @param[in] index New object index
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object is not in map
+ */
+extern otai_status_t otai_metadata_objectmap_set(
+        _Inout_ otai_metadata_objectmap_t *map,
+        _In_ otai_object_id_t object_id,
+        _In_ uint32_t index);
+
+/**
+ * @brief Remove object
+ *
+ * @param[inout] map Object map
+ * @param[in] object_id Object id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object is not in map
+ */
+extern otai_status_t otai_metadata_objectmap_remove(
+        _Inout_ otai_metadata_objectmap_t *map,
+        _In_ otai_object_id_t object_id);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATAOBJECTMAP_H_ */
@@ -0,0 +1,617 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadataotdr.c
+ *
+ * @brief   This module implements OTAI Metadata streaming OTDR trace analysis
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <otai.h>
+#include "otaimetadatautils.h"
+#include "otaimetadatalogger.h"
+#include "otaimetadataanalytics.h"
+#include "otaimetadataotdr.h"
+
+/* light travels 0.2998 m per ns, and OTDR sees it twice */
+#define OTDR_METERS_PER_NS          0.299792458
+#define OTDR_REFRACTIVE_INDEX       1.4682
+#define OTDR_SAMPLE_SCALE           0.001
+#define OTDR_MIN_WINDOW             32
+#define OTDR_TRIGGER                3
+
+#define OTDR_STATE_FIT              0
+#define OTDR_STATE_DETECT           1
+#define OTDR_STATE_EVENT            2
+#define OTDR_STATE_SETTLE           3
+#define OTDR_STATE_END              4
+
+otai_status_t otai_metadata_otdr_config_from_attr_list(
+        _Inout_ otai_metadata_otdr_config_t *config,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    if (attr_count != 0 && attr_list == NULL)
+    {
+        OTAI_META_LOG_ERROR("attribute list is NULL");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < attr_count; idx++)
+    {
+        const otai_attribute_t *attr = &attr_list[idx];
+
+        switch (attr->id)
+        {
+            case OTAI_OTDR_ATTR_REFLECTION_THRESHOLD:
+                config->reflectionthreshold = attr->value.d64;
+                break;
+
+            case OTAI_OTDR_ATTR_SPLICE_LOSS_THRESHOLD:
+                config->splicelossthreshold = attr->value.d64;
+                break;
+
+            case OTAI_OTDR_ATTR_END_OF_FIBER_THRESHOLD:
+                config->endoffiberthreshold = attr->value.d64;
+                break;
+
+            case OTAI_OTDR_ATTR_BACKSCATTER_INDEX:
+                config->backscatterindex = attr->value.d64;
+                break;
+
+            case OTAI_OTDR_ATTR_REFRACTIVE_INDEX:
+                config->refractiveindex = attr->value.d64;
+                break;
+
+            case OTAI_OTDR_ATTR_PULSE_WIDTH:
+                config->pulsewidth = attr->value.u32;
+                break;
+
+            case OTAI_OTDR_ATTR_SAMPLING_RESOLUTION:
+                config->samplingresolution = attr->value.d64;
+                break;
+
+            case OTAI_OTDR_ATTR_DISTANCE_ACCURACY:
+                config->distanceaccuracy = attr->value.d64;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_otdr_init(
+        _Out_ otai_metadata_otdr_t *analysis,
+        _In_ const otai_metadata_otdr_config_t *config)
+{
+    memset(analysis, 0, sizeof(otai_metadata_otdr_t));
+
+    if (!(config->samplingresolution > 0) || !(config->splicelossthreshold > 0) ||
+            !(config->endoffiberthreshold > 0) || config->capacity == 0)
+    {
+        OTAI_META_LOG_ERROR("sampling resolution, loss thresholds and capacity must be positive");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    analysis->config = *config;
+
+    if (!(analysis->config.samplescale > 0))
+    {
+        analysis->config.samplescale = OTDR_SAMPLE_SCALE;
+    }
+
+    if (!(analysis->config.refractiveindex > 0))
+    {
+        analysis->config.refractiveindex = OTDR_REFRACTIVE_INDEX;
+    }
+
+    double pulselength = (double)config->pulsewidth * OTDR_METERS_PER_NS / (2 * analysis->config.refractiveindex);
+
+    analysis->pulse = (uint32_t)(pulselength / config->samplingresolution) + 1;
+
+    if (analysis->config.window == 0)
+    {
+        analysis->config.window = 8 * analysis->pulse > OTDR_MIN_WINDOW ? 8 * analysis->pulse : OTDR_MIN_WINDOW;
+    }
+
+    /* event lasts at least pulse, shorter deviation is noise */
+
+    analysis->trigger = analysis->pulse < OTDR_TRIGGER ? analysis->pulse : OTDR_TRIGGER;
+
+    if (analysis->config.window < 4)
+    {
+        OTAI_META_LOG_ERROR("window of %u samples is too short for slope fit", analysis->config.window);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    /*
+     * Reflectance R = B + 10 log10(D) + 10 log10(10^(H/5) - 1), with
+     * backscatter B, pulse width D in ns and spike height H, solved for H
+     * at threshold.
+     */
+
+    double pulsedb = otai_metadata_analytics_linear_to_db(config->pulsewidth == 0 ? 1.0 : (double)config->pulsewidth);
+
+    analysis->height = otai_metadata_analytics_linear_to_db(1 + otai_metadata_analytics_db_to_linear(
+                config->reflectionthreshold - config->backscatterindex - pulsedb)) / 2;
+
+    analysis->ring = calloc(analysis->config.window, sizeof(uint16_t));
+    analysis->events.events.list = calloc(config->capacity, sizeof(otai_otdr_event_t));
+
+    if (analysis->ring == NULL || analysis->events.events.list == NULL)
+    {
+        otai_metadata_otdr_destroy(analysis);
+
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+void otai_metadata_otdr_destroy(
+        _Inout_ otai_metadata_otdr_t *analysis)
+{
+    free(analysis->ring);
+    free(analysis->events.events.list);
+
+    memset(analysis, 0, sizeof(otai_metadata_otdr_t));
+}
+
+void otai_metadata_otdr_reset(
+        _Inout_ otai_metadata_otdr_t *analysis)
+{
+    analysis->head = 0;
+    analysis->fill = 0;
+    analysis->sy = 0;
+    analysis->sxy = 0;
+    analysis->index = 0;
+    analysis->haspartial = false;
+    analysis->state = OTDR_STATE_FIT;
+    analysis->deviating = 0;
+    analysis->frozen = false;
+    analysis->fitsection = true;
+    analysis->sectionstart = 0;
+    analysis->sectionlevel = 0;
+    analysis->attenuation = 0;
+    analysis->events.span_distance = 0;
+    analysis->events.span_loss = 0;
+    analysis->events.events.count = 0;
+    analysis->dropped = 0;
+}
+
+static double otai_metadata_otdr_distance(
+        _In_ const otai_metadata_otdr_t *analysis,
+        _In_ uint64_t index)
+{
+    return (double)index * analysis->config.samplingresolution / 1000;
+}
+
+static double otai_metadata_otdr_accumulated(
+        _In_ const otai_metadata_otdr_t *analysis)
+{
+    uint32_t count = analysis->events.events.count;
+
+    return count == 0 ? 0 : analysis->events.events.list[count - 1].accumulate_loss;
+}
+
+static void otai_metadata_otdr_add_event(
+        _Inout_ otai_metadata_otdr_t *analysis,
+        _In_ otai_otdr_event_type_t type,
+        _In_ double length,
+        _In_ double loss,
+        _In_ double reflection)
+{
+    otai_otdr_event_list_t *events = &analysis->events.events;
+
+    double accumulated = otai_metadata_otdr_accumulated(analysis);
+
+    if (events->count == analysis->config.capacity)
+    {
+        /* keep accumulated loss right, end of fiber takes place of last event */
+
+        if (type != OTAI_OTDR_EVENT_TYPE_END)
+        {
+            events->list[events->count - 1].accumulate_loss += loss;
+            analysis->dropped++;
+
+            return;
+        }
+
+        events->count--;
+        analysis->dropped++;
+    }
+
+    otai_otdr_event_t *event = &events->list[events->count++];
+
+    event->type = type;
+    event->length = length;
+    event->loss = loss;
+    event->reflection = reflection;
+    event->accumulate_loss = accumulated + loss;
+}
+
+static void otai_metadata_otdr_push(
+        _Inout_ otai_metadata_otdr_t *analysis,
+        _In_ uint16_t sample)
+{
+    if (analysis->fill == analysis->config.window)
+    {
+        /* drop oldest, others move one position down */
+
+        uint16_t oldest = analysis->ring[analysis->head];
+
+        analysis->sxy -= analysis->sy - oldest;
+        analysis->sy -= oldest;
+        analysis->fill--;
+    }
+
+    analysis->sxy += (int64_t)analysis->fill * sample;
+    analysis->sy += sample;
+    analysis->fill++;
+
+    analysis->ring[analysis->head] = sample;
+    analysis->head = (analysis->head + 1) % analysis->config.window;
+}
+
+static void otai_metadata_otdr_fit(
+        _In_ const otai_metadata_otdr_t *analysis,
+        _Out_ double *level,
+        _Out_ double *slope)
+{
+    /* least squares line over positions 0 .. n - 1, level at position n */
+
+    double n = (double)analysis->fill;
+    double sx = n * (n - 1) / 2;
+    double sxx = (n - 1) * n * (2 * n - 1) / 6;
+    double sy = (double)analysis->sy;
+
+    double b = (n * (double)analysis->sxy - sx * sy) / (n * sxx - sx * sx);
+
+    *slope = b;
+    *level = (sy - b * sx) / n + b * n;
+}
+
+static void otai_metadata_otdr_section(
+        _Inout_ otai_metadata_otdr_t *analysis,
+        _In_ uint64_t end,
+        _In_ double level)
+{
+    if (end <= analysis->sectionstart)
+    {
+        return;
+    }
+
+    /* levels at both ends are fitted, so loss doesn't depend on slope noise */
+
+    double loss = (level - analysis->sectionlevel) * analysis->config.samplescale;
+    double length = otai_metadata_otdr_distance(analysis, end - analysis->sectionstart);
+
+    analysis->attenuation = loss / length;
+
+    otai_metadata_otdr_add_event(analysis, OTAI_OTDR_EVENT_TYPE_FIBER_SECTION, length, loss, 0);
+}
+
+static void otai_metadata_otdr_end(
+        _Inout_ otai_metadata_otdr_t *analysis,
+        _In_ uint64_t end,
+        _In_ double level,
+        _In_ double loss,
+        _In_ double reflection)
+{
+    otai_metadata_otdr_section(analysis, end, level);
+
+    otai_metadata_otdr_add_event(analysis, OTAI_OTDR_EVENT_TYPE_END, otai_metadata_otdr_distance(analysis, end), loss, reflection);
+
+    analysis->events.span_distance = otai_metadata_otdr_distance(analysis, end);
+    analysis->events.span_loss = otai_metadata_otdr_accumulated(analysis);
+    analysis->state = OTDR_STATE_END;
+}
+
+static void otai_metadata_otdr_refit(
+        _Inout_ otai_metadata_otdr_t *analysis)
+{
+    /* samples of event are not in window, so fit starts again */
+
+    analysis->head = 0;
+    analysis->fill = 0;
+    analysis->sy = 0;
+    analysis->sxy = 0;
+    analysis->frozen = true;
+    analysis->state = OTDR_STATE_FIT;
+}
+
+static double otai_metadata_otdr_reflectance(
+        _In_ const otai_metadata_otdr_t *analysis)
+{
+    double pulsedb = otai_metadata_analytics_linear_to_db(analysis->config.pulsewidth == 0 ? 1.0 : (double)analysis->config.pulsewidth);
+
+    return analysis->config.backscatterindex + pulsedb +
+        otai_metadata_analytics_linear_to_db(otai_metadata_analytics_db_to_linear(2 * analysis->peak) - 1);
+}
+
+static void otai_metadata_otdr_classify(
+        _Inout_ otai_metadata_otdr_t *analysis)
+{
+    double loss = analysis->statesamples == 0 ? 0 : -analysis->settle / analysis->statesamples;
+
+    bool reflective = analysis->peak > analysis->height;
+
+    double reflection = reflective ? otai_metadata_otdr_reflectance(analysis) : 0;
+
+    if (loss >= analysis->config.endoffiberthreshold)
+    {
+        otai_metadata_otdr_end(analysis, analysis->eventstart, analysis->base, loss, reflection);
+
+        return;
+    }
+
+    if (!reflective && loss < analysis->config.splicelossthreshold)
+    {
+        /* noise, frozen line is still good */
+
+        otai_metadata_otdr_refit(analysis);
+
+        return;
+    }
+
+    otai_metadata_otdr_section(analysis, analysis->eventstart, analysis->base);
+
+    otai_metadata_otdr_add_event(analysis,
+            reflective ? OTAI_OTDR_EVENT_TYPE_REFLECTION : OTAI_OTDR_EVENT_TYPE_NON_REFLECTION,
+            otai_metadata_otdr_distance(analysis, analysis->eventstart), loss, reflection);
+
+    /* level changed by loss, fit new section */
+
+    analysis->base += loss / analysis->config.samplescale;
+    analysis->sectionstart = analysis->eventstart;
+    analysis->sectionlevel = analysis->base;
+    analysis->fitsection = true;
+
+    otai_metadata_otdr_refit(analysis);
+}
+
+/*
+ * Returns sample to put in window, deviating sample is replaced with line
+ * level, so short noise doesn't bend fit.
+ */
+static uint16_t otai_metadata_otdr_detect(
+        _Inout_ otai_metadata_otdr_t *analysis,
+        _In_ uint64_t index,
+        _In_ double level,
+        _In_ double slope,
+        _In_ uint16_t sample)
+{
+    if (analysis->deviating != 0)
+    {
+        /* line is frozen at first deviating sample */
+
+        level = analysis->base + analysis->slope * (double)(index - analysis->eventstart);
+    }
+
+    /* larger sample is lower level, so positive deviation is spike */
+
+    double deviation = (level - (double)sample) * analysis->config.samplescale;
+
+    double limit = analysis->config.splicelossthreshold / 2;
+
+    if (deviation <= (analysis->height < limit ? analysis->height : limit) && deviation >= -limit)
+    {
+        analysis->deviating = 0;
+
+        return sample;
+    }
+
+    if (analysis->deviating == 0)
+    {
+        analysis->eventstart = index;
+        analysis->base = level;
+        analysis->slope = slope;
+        analysis->peak = 0;
+    }
+
+    analysis->peak = deviation > analysis->peak ? deviation : analysis->peak;
+
+    if (++analysis->deviating >= analysis->trigger)
+    {
+        analysis->state = OTDR_STATE_EVENT;
+        analysis->statesamples = analysis->deviating;
+        analysis->deviating = 0;
+    }
+
+    level += 0.5;
+
+    return (uint16_t)(level < 0 ? 0 : level > UINT16_MAX ? UINT16_MAX : level);
+}
+
+static void otai_metadata_otdr_sample(
+        _Inout_ otai_metadata_otdr_t *analysis,
+        _In_ uint16_t sample)
+{
+    uint64_t index = analysis->index++;
+
+    if (index == 0)
+    {
+        otai_metadata_otdr_add_event(analysis, OTAI_OTDR_EVENT_TYPE_START, 0, 0, 0);
+    }
+
+    double scale = analysis->config.samplescale;
+    double level;
+    double slope;
+    double deviation;
+
+    switch (analysis->state)
+    {
+        case OTDR_STATE_FIT:
+
+            if (analysis->frozen)
+            {
+                /* window is not full yet, so look for events with frozen line */
+
+                sample = otai_metadata_otdr_detect(analysis, index,
+                        analysis->base + analysis->slope * (double)(index - analysis->eventstart), analysis->slope, sample);
+
+                if (analysis->state != OTDR_STATE_FIT)
+                {
+                    break;
+                }
+            }
+
+            otai_metadata_otdr_push(analysis, sample);
+
+            if (analysis->fill == analysis->config.window && analysis->deviating == 0)
+            {
+                otai_metadata_otdr_fit(analysis, &level, &analysis->slope);
+
+                if (analysis->fitsection)
+                {
+                    analysis->sectionlevel = level - analysis->slope * (double)(index + 1 - analysis->sectionstart);
+                    analysis->fitsection = false;
+                }
+
+                analysis->state = OTDR_STATE_DETECT;
+            }
+
+            break;
+
+        case OTDR_STATE_DETECT:
+
+            otai_metadata_otdr_fit(analysis, &level, &slope);
+
+            sample = otai_metadata_otdr_detect(analysis, index, level, slope, sample);
+
+            if (analysis->state == OTDR_STATE_DETECT)
+            {
+                otai_metadata_otdr_push(analysis, sample);
+            }
+
+            break;
+
+        case OTDR_STATE_EVENT:
+
+            deviation = (analysis->base + analysis->slope * (double)(index - analysis->eventstart) - (double)sample) * scale;
+
+            analysis->peak = deviation > analysis->peak ? deviation : analysis->peak;
+
+            /* ramp or spike lasts pulse, it's over after two */
+
+            if (++analysis->statesamples >= 2 * analysis->pulse)
+            {
+                analysis->state = OTDR_STATE_SETTLE;
+                analysis->statesamples = 0;
+                analysis->settle = 0;
+            }
+
+            break;
+
+        case OTDR_STATE_SETTLE:
+
+            deviation = (analysis->base + analysis->slope * (double)(index - analysis->eventstart) - (double)sample) * scale;
+
+            analysis->settle += deviation;
+
+            if (++analysis->statesamples >= (2 * analysis->pulse > 4 ? 2 * analysis->pulse : 4))
+            {
+                otai_metadata_otdr_classify(analysis);
+            }
+
+            break;
+
+        default:
+            break;
+    }
+}
+
+void otai_metadata_otdr_process(
+        _Inout_ otai_metadata_otdr_t *analysis,
+        _In_ uint32_t count,
+        _In_ const uint8_t *data)
+{
+    uint32_t idx = 0;
+
+    if (analysis->haspartial && count != 0)
+    {
+        otai_metadata_otdr_sample(analysis, (uint16_t)(analysis->partial << 8 | data[0]));
+
+        analysis->haspartial = false;
+        idx = 1;
+    }
+
+    for (; idx + 1 < count && analysis->state != OTDR_STATE_END; idx += 2)
+    {
+        otai_metadata_otdr_sample(analysis, (uint16_t)(data[idx] << 8 | data[idx + 1]));
+    }
+
+    if (idx < count && analysis->state != OTDR_STATE_END)
+    {
+        analysis->partial = data[idx];
+        analysis->haspartial = true;
+    }
+}
+
+void otai_metadata_otdr_finish(
+        _Inout_ otai_metadata_otdr_t *analysis)
+{
+    switch (analysis->state)
+    {
+        case OTDR_STATE_END:
+            break;
+
+        case OTDR_STATE_EVENT:
+        case OTDR_STATE_SETTLE:
+
+            /* trace ended inside event, so it is end of fiber */
+
+            otai_metadata_otdr_end(analysis, analysis->eventstart, analysis->base,
+                    analysis->state == OTDR_STATE_SETTLE && analysis->statesamples != 0 ? -analysis->settle / analysis->statesamples : 0,
+                    analysis->peak > analysis->height ? otai_metadata_otdr_reflectance(analysis) : 0);
+            break;
+
+        default:
+
+            if (analysis->index != 0)
+            {
+                double level = analysis->sectionlevel + analysis->slope * (double)(analysis->index - 1 - analysis->sectionstart);
+
+                if (analysis->fill >= 4)
+                {
+                    otai_metadata_otdr_fit(analysis, &level, &analysis->slope);
+
+                    level -= analysis->slope;
+                }
+
+                otai_metadata_otdr_end(analysis, analysis->index - 1, level, 0, 0);
+            }
+
+            break;
+    }
+}
+
+void otai_metadata_otdr_get_events(
+        _In_ const otai_metadata_otdr_t *analysis,
+        _Out_ otai_otdr_events_t *events)
+{
+    *events = analysis->events;
+}
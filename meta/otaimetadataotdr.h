@@ -0,0 +1,346 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadataotdr.h
+ *
+ * @brief   This module defines OTAI Metadata streaming OTDR trace analysis
+ */
+
+#ifndef __OTAIMETADATAOTDR_H_
+#define __OTAIMETADATAOTDR_H_
+
+#include "otaimetadatatypes.h"
+
+/**
+ * @defgroup OTAIMETADATAOTDR OTAI - Metadata streaming OTDR trace analysis
+ *
+ * OTDR trace is passed in chunks of any size, and events are detected while
+ * samples arrive, so whole trace is never kept. Memory is slope fit window
+ * and event list, whatever distance range is.
+ *
+ * Trace sample is 16 bit big endian level below maximum level, as data
+ * points of Bellcore SOR file, so larger sample is lower level.
+ *
+ * Backscatter slope is least squares line over window of last samples.
+ * Few consecutive samples which deviate from line more than thresholds
+ * start event, single deviating sample is noise. Line is frozen during
+ * event and level after event is compared with it to get event loss.
+ * Spike height is converted to reflectance with backscatter index and
+ * pulse width.
+ *
+ * Window is filled again after event, and until it is full samples are
+ * compared with frozen line moved by event loss, so events closer than
+ * window length are still found.
+ *
+ * Events follow order of OTDR result, start, fiber sections and events
+ * between them, and end.
+ *
+ * @{
+ */
+
+/**
+ * @brief OTDR analysis configuration.
+ */
+typedef struct _otai_metadata_otdr_config_t
+{
+    /**
+     * @brief Reflectance threshold in dB, as #OTAI_OTDR_ATTR_REFLECTION_THRESHOLD.
+     */
+    otai_double_t                                reflectionthreshold;
+
+    /**
+     * @brief Loss threshold in dB, as #OTAI_OTDR_ATTR_SPLICE_LOSS_THRESHOLD.
+     */
+    otai_double_t                                splicelossthreshold;
+
+    /**
+     * @brief Loss threshold in dB, as #OTAI_OTDR_ATTR_END_OF_FIBER_THRESHOLD.
+     */
+    otai_double_t                                endoffiberthreshold;
+
+    /**
+     * @brief Backscatter coefficient of 1 ns pulse in dB, as #OTAI_OTDR_ATTR_BACKSCATTER_INDEX.
+     */
+    otai_double_t                                backscatterindex;
+
+    /**
+     * @brief Refractive index, as #OTAI_OTDR_ATTR_REFRACTIVE_INDEX.
+     */
+    otai_double_t                                refractiveindex;
+
+    /**
+     * @brief Pulse width in nanoseconds, as #OTAI_OTDR_ATTR_PULSE_WIDTH.
+     */
+    otai_uint32_t                                pulsewidth;
+
+    /**
+     * @brief Meters per sample, as #OTAI_OTDR_ATTR_SAMPLING_RESOLUTION.
+     */
+    otai_double_t                                samplingresolution;
+
+    /**
+     * @brief Distance accuracy in meters, as #OTAI_OTDR_ATTR_DISTANCE_ACCURACY.
+     */
+    otai_double_t                                distanceaccuracy;
+
+    /**
+     * @brief Level of sample unit in dB, 0 for 0.001 dB.
+     */
+    otai_double_t                                samplescale;
+
+    /**
+     * @brief Number of samples of slope fit, 0 to derive it from pulse width.
+     */
+    otai_uint32_t                                window;
+
+    /**
+     * @brief Maximum number of events.
+     */
+    otai_uint32_t                                capacity;
+
+} otai_metadata_otdr_config_t;
+
+/**
+ * @brief Streaming OTDR trace analysis.
+ */
+typedef struct _otai_metadata_otdr_t
+{
+    /**
+     * @brief Configuration.
+     */
+    otai_metadata_otdr_config_t                  config;
+
+    /**
+     * @brief Spike height in dB at reflectance threshold.
+     */
+    otai_double_t                                height;
+
+    /**
+     * @brief Samples covered by pulse.
+     */
+    otai_uint32_t                                pulse;
+
+    /**
+     * @brief Consecutive deviating samples which start event.
+     */
+    otai_uint32_t                                trigger;
+
+    /**
+     * @brief Last samples, ring of window size.
+     */
+    otai_uint16_t*                               ring;
+
+    /**
+     * @brief Next ring position.
+     */
+    otai_uint32_t                                head;
+
+    /**
+     * @brief Number of samples in ring.
+     */
+    otai_uint32_t                                fill;
+
+    /**
+     * @brief Sum of samples in ring.
+     */
+    otai_int64_t                                 sy;
+
+    /**
+     * @brief Sum of samples in ring weighted by position, oldest at 0.
+     */
+    otai_int64_t                                 sxy;
+
+    /**
+     * @brief Number of processed samples.
+     */
+    otai_uint64_t                                index;
+
+    /**
+     * @brief First byte of sample split between chunks.
+     */
+    otai_uint8_t                                 partial;
+
+    /**
+     * @brief Whether partial byte is set.
+     */
+    bool                                         haspartial;
+
+    /**
+     * @brief Analysis state.
+     */
+    otai_uint32_t                                state;
+
+    /**
+     * @brief Number of consecutive deviating samples.
+     */
+    otai_uint32_t                                deviating;
+
+    /**
+     * @brief Whether frozen line is valid while window fills.
+     */
+    bool                                         frozen;
+
+    /**
+     * @brief Whether level at section start is fitted when window is full.
+     */
+    bool                                         fitsection;
+
+    /**
+     * @brief Index of first sample of event.
+     */
+    otai_uint64_t                                eventstart;
+
+    /**
+     * @brief Number of samples in current state.
+     */
+    otai_uint32_t                                statesamples;
+
+    /**
+     * @brief Frozen line level at event start, in sample units.
+     */
+    otai_double_t                                base;
+
+    /**
+     * @brief Frozen line slope, in sample units per sample.
+     */
+    otai_double_t                                slope;
+
+    /**
+     * @brief Highest spike above line in dB.
+     */
+    otai_double_t                                peak;
+
+    /**
+     * @brief Sum of deviations from line while settling, in dB.
+     */
+    otai_double_t                                settle;
+
+    /**
+     * @brief Index of first sample of current fiber section.
+     */
+    otai_uint64_t                                sectionstart;
+
+    /**
+     * @brief Fitted level at start of current fiber section, in sample units.
+     */
+    otai_double_t                                sectionlevel;
+
+    /**
+     * @brief Attenuation of last fiber section in dB per km.
+     */
+    otai_double_t                                attenuation;
+
+    /**
+     * @brief Detected events.
+     */
+    otai_otdr_events_t                           events;
+
+    /**
+     * @brief Number of events which didn't fit.
+     */
+    otai_uint32_t                                dropped;
+
+} otai_metadata_otdr_t;
+
+/**
+ * @brief Fill configuration from OTDR attributes
+ *
+ * Attributes which are not in list don't change configuration, so list
+ * can be attributes of create API followed by read only attributes.
+ *
+ * @param[inout] config Configuration
+ * @param[in] attr_count Number of attributes
+ * @param[in] attr_list Attribute list
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if list is NULL
+ */
+extern otai_status_t otai_metadata_otdr_config_from_attr_list(
+        _Inout_ otai_metadata_otdr_config_t *config,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list);
+
+/**
+ * @brief Initialize OTDR analysis
+ *
+ * @param[out] analysis OTDR analysis
+ * @param[in] config Configuration
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if configuration is invalid, #OTAI_STATUS_NO_MEMORY if window or event
+ * list can't be allocated
+ */
+extern otai_status_t otai_metadata_otdr_init(
+        _Out_ otai_metadata_otdr_t *analysis,
+        _In_ const otai_metadata_otdr_config_t *config);
+
+/**
+ * @brief Release OTDR analysis memory
+ *
+ * @param[inout] analysis OTDR analysis
+ */
+extern void otai_metadata_otdr_destroy(
+        _Inout_ otai_metadata_otdr_t *analysis);
+
+/**
+ * @brief Start new trace
+ *
+ * @param[inout] analysis OTDR analysis
+ */
+extern void otai_metadata_otdr_reset(
+        _Inout_ otai_metadata_otdr_t *analysis);
+
+/**
+ * @brief Process trace chunk
+ *
+ * Chunk may end in middle of sample. Samples after end of fiber are
+ * ignored.
+ *
+ * @param[inout] analysis OTDR analysis
+ * @param[in] count Number of bytes
+ * @param[in] data Trace bytes
+ */
+extern void otai_metadata_otdr_process(
+        _Inout_ otai_metadata_otdr_t *analysis,
+        _In_ uint32_t count,
+        _In_ const uint8_t *data);
+
+/**
+ * @brief End trace
+ *
+ * Pending event is classified, and if end of fiber was not detected, last
+ * sample is end of fiber.
+ *
+ * @param[inout] analysis OTDR analysis
+ */
+extern void otai_metadata_otdr_finish(
+        _Inout_ otai_metadata_otdr_t *analysis);
+
+/**
+ * @brief Get detected events
+ *
+ * Event list points to analysis memory and is valid until reset.
+ *
+ * @param[in] analysis OTDR analysis
+ * @param[out] events Events, total distance and loss are set after finish
+ */
+extern void otai_metadata_otdr_get_events(
+        _In_ const otai_metadata_otdr_t *analysis,
+        _Out_ otai_otdr_events_t *events);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATAOTDR_H_ */
@@ -0,0 +1,639 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatapm.c
+ *
+ * @brief   This module implements OTAI Metadata performance monitoring bins
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <otai.h>
+#include "otaimetadatautils.h"
+#include "otaimetadatalogger.h"
+#include "otaimetadatapm.h"
+
+static bool otai_metadata_pm_bin_alloc(
+        _Inout_ otai_metadata_pm_bin_t *bin,
+        _In_ uint32_t capacity,
+        _In_ uint32_t gauges,
+        _In_ uint32_t counters)
+{
+    size_t gaugesize = (size_t)gauges * capacity;
+    size_t countersize = (size_t)counters * capacity;
+
+    /* calloc of zero elements may return NULL */
+
+    bin->samples = calloc(capacity, sizeof(uint32_t));
+    bin->min = calloc(gaugesize + 1, sizeof(double));
+    bin->max = calloc(gaugesize + 1, sizeof(double));
+    bin->sum = calloc(gaugesize + 1, sizeof(double));
+    bin->delta = calloc(countersize + 1, sizeof(otai_stat_value_t));
+
+    return bin->samples != NULL && bin->min != NULL && bin->max != NULL &&
+        bin->sum != NULL && bin->delta != NULL;
+}
+
+static void otai_metadata_pm_bin_free(
+        _Inout_ otai_metadata_pm_bin_t *bin)
+{
+    free(bin->samples);
+    free(bin->min);
+    free(bin->max);
+    free(bin->sum);
+    free(bin->delta);
+}
+
+static void otai_metadata_pm_bin_reset(
+        _Inout_ otai_metadata_pm_bin_t *bin,
+        _In_ const otai_metadata_pm_t *pm,
+        _In_ uint64_t start_time)
+{
+    /*
+     * Gauge values are valid only when object has samples, so only sample
+     * counts and deltas are cleared.
+     */
+
+    memset(bin->samples, 0, sizeof(uint32_t) * pm->capacity);
+    memset(bin->delta, 0, sizeof(otai_stat_value_t) * pm->countercount * pm->capacity);
+
+    bin->starttime = start_time;
+}
+
+otai_status_t otai_metadata_pm_init(
+        _Out_ otai_metadata_pm_t *pm,
+        _In_ const otai_metadata_pm_config_t *config)
+{
+    memset(pm, 0, sizeof(otai_metadata_pm_t));
+
+    const otai_object_type_info_t *info = otai_metadata_get_object_type_info(config->objecttype);
+
+    if (info == NULL || info->statenum == NULL)
+    {
+        OTAI_META_LOG_ERROR("object type %d has no statistics", config->objecttype);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (config->statcount == 0 || config->statids == NULL || config->capacity == 0)
+    {
+        OTAI_META_LOG_ERROR("no statistics or objects to sample");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    pm->objecttype = config->objecttype;
+    pm->mode = config->mode;
+    pm->info = info;
+    pm->statcount = config->statcount;
+    pm->capacity = config->capacity;
+
+    pm->statids = calloc(config->statcount, sizeof(otai_stat_id_t));
+    pm->statmetadata = calloc(config->statcount, sizeof(otai_stat_metadata_t*));
+    pm->column = calloc(config->statcount, sizeof(uint32_t));
+    pm->values = calloc(config->statcount, sizeof(otai_stat_value_t));
+    pm->objects = calloc(config->capacity, sizeof(otai_object_id_t));
+    pm->lastvalid = calloc(config->capacity, sizeof(bool));
+
+    if (pm->statids == NULL || pm->statmetadata == NULL || pm->column == NULL ||
+            pm->values == NULL || pm->objects == NULL || pm->lastvalid == NULL ||
+            otai_metadata_objectmap_init(&pm->objectmap, config->capacity) != OTAI_STATUS_SUCCESS)
+    {
+        otai_metadata_pm_destroy(pm);
+
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < config->statcount; idx++)
+    {
+        const otai_stat_metadata_t *md = otai_metadata_get_stat_metadata(config->objecttype, config->statids[idx]);
+
+        if (md == NULL)
+        {
+            OTAI_META_LOG_ERROR("statistic %d is not valid for object type %d", config->statids[idx], config->objecttype);
+
+            otai_metadata_pm_destroy(pm);
+
+            return OTAI_STATUS_INVALID_PARAMETER;
+        }
+
+        pm->statids[idx] = config->statids[idx];
+        pm->statmetadata[idx] = md;
+        pm->column[idx] = md->statvalueiscounter ? pm->countercount++ : pm->gaugecount++;
+    }
+
+    pm->last = calloc((size_t)pm->countercount * config->capacity + 1, sizeof(otai_stat_value_t));
+
+    if (pm->last == NULL)
+    {
+        otai_metadata_pm_destroy(pm);
+
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    int interval = 0;
+
+    for (; interval < OTAI_METADATA_PM_INTERVAL_MAX; interval++)
+    {
+        uint32_t count = config->history[interval] + 1;
+
+        pm->history[interval] = config->history[interval];
+        pm->bins[interval] = calloc(count, sizeof(otai_metadata_pm_bin_t));
+
+        if (pm->bins[interval] == NULL)
+        {
+            otai_metadata_pm_destroy(pm);
+
+            return OTAI_STATUS_NO_MEMORY;
+        }
+
+        for (idx = 0; idx < count; idx++)
+        {
+            if (!otai_metadata_pm_bin_alloc(&pm->bins[interval][idx], pm->capacity, pm->gaugecount, pm->countercount))
+            {
+                otai_metadata_pm_destroy(pm);
+
+                return OTAI_STATUS_NO_MEMORY;
+            }
+        }
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+void otai_metadata_pm_destroy(
+        _Inout_ otai_metadata_pm_t *pm)
+{
+    int interval = 0;
+
+    for (; interval < OTAI_METADATA_PM_INTERVAL_MAX; interval++)
+    {
+        uint32_t idx = 0;
+
+        for (; pm->bins[interval] != NULL && idx <= pm->history[interval]; idx++)
+        {
+            otai_metadata_pm_bin_free(&pm->bins[interval][idx]);
+        }
+
+        free(pm->bins[interval]);
+    }
+
+    free(pm->statids);
+    free(pm->statmetadata);
+    free(pm->column);
+    free(pm->values);
+    free(pm->objects);
+    free(pm->lastvalid);
+    free(pm->last);
+
+    otai_metadata_objectmap_destroy(&pm->objectmap);
+
+    memset(pm, 0, sizeof(otai_metadata_pm_t));
+}
+
+otai_status_t otai_metadata_pm_add_object(
+        _Inout_ otai_metadata_pm_t *pm,
+        _In_ otai_object_id_t object_id)
+{
+    uint32_t index = pm->objectcount;
+
+    otai_status_t status = otai_metadata_objectmap_insert(&pm->objectmap, object_id, index);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    pm->objectcount++;
+
+    pm->objects[index] = object_id;
+    pm->lastvalid[index] = false;
+
+    /* object starts with empty bins */
+
+    int interval = 0;
+
+    for (; interval < OTAI_METADATA_PM_INTERVAL_MAX; interval++)
+    {
+        uint32_t idx = 0;
+
+        for (; idx <= pm->history[interval]; idx++)
+        {
+            otai_metadata_pm_bin_t *bin = &pm->bins[interval][idx];
+
+            bin->samples[index] = 0;
+
+            uint32_t col = 0;
+
+            for (; col < pm->countercount; col++)
+            {
+                bin->delta[col * pm->capacity + index].u64 = 0;
+            }
+        }
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_pm_remove_object(
+        _Inout_ otai_metadata_pm_t *pm,
+        _In_ otai_object_id_t object_id)
+{
+    uint32_t index;
+
+    if (!otai_metadata_objectmap_find(&pm->objectmap, object_id, &index))
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    otai_metadata_objectmap_remove(&pm->objectmap, object_id);
+
+    uint32_t last = --pm->objectcount;
+
+    if (index == last)
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    pm->objects[index] = pm->objects[last];
+
+    otai_metadata_objectmap_set(&pm->objectmap, pm->objects[index], index);
+
+    pm->lastvalid[index] = pm->lastvalid[last];
+
+    uint32_t col = 0;
+
+    for (; col < pm->countercount; col++)
+    {
+        pm->last[col * pm->capacity + index] = pm->last[col * pm->capacity + last];
+    }
+
+    int interval = 0;
+
+    for (; interval < OTAI_METADATA_PM_INTERVAL_MAX; interval++)
+    {
+        uint32_t idx = 0;
+
+        for (; idx <= pm->history[interval]; idx++)
+        {
+            otai_metadata_pm_bin_t *bin = &pm->bins[interval][idx];
+
+            bin->samples[index] = bin->samples[last];
+
+            for (col = 0; col < pm->gaugecount; col++)
+            {
+                bin->min[col * pm->capacity + index] = bin->min[col * pm->capacity + last];
+                bin->max[col * pm->capacity + index] = bin->max[col * pm->capacity + last];
+                bin->sum[col * pm->capacity + index] = bin->sum[col * pm->capacity + last];
+            }
+
+            for (col = 0; col < pm->countercount; col++)
+            {
+                bin->delta[col * pm->capacity + index] = bin->delta[col * pm->capacity + last];
+            }
+        }
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static double otai_metadata_pm_to_double(
+        _In_ otai_stat_value_type_t type,
+        _In_ const otai_stat_value_t *value)
+{
+    switch (type)
+    {
+        case OTAI_STAT_VALUE_TYPE_INT32:
+            return (double)value->s32;
+
+        case OTAI_STAT_VALUE_TYPE_UINT32:
+            return (double)value->u32;
+
+        case OTAI_STAT_VALUE_TYPE_INT64:
+            return (double)value->s64;
+
+        case OTAI_STAT_VALUE_TYPE_UINT64:
+            return (double)value->u64;
+
+        case OTAI_STAT_VALUE_TYPE_DOUBLE:
+            return value->d64;
+
+        default:
+            return 0;
+    }
+}
+
+/*
+ * Counter is widened to s64, u64 or d64 member of delta.
+ */
+static otai_stat_value_t otai_metadata_pm_widen(
+        _In_ otai_stat_value_type_t type,
+        _In_ const otai_stat_value_t *value)
+{
+    otai_stat_value_t wide;
+
+    wide.u64 = 0;
+
+    switch (type)
+    {
+        case OTAI_STAT_VALUE_TYPE_INT32:
+            wide.s64 = value->s32;
+            break;
+
+        case OTAI_STAT_VALUE_TYPE_UINT32:
+            wide.u64 = value->u32;
+            break;
+
+        case OTAI_STAT_VALUE_TYPE_INT64:
+        case OTAI_STAT_VALUE_TYPE_UINT64:
+            wide.u64 = value->u64;
+            break;
+
+        case OTAI_STAT_VALUE_TYPE_DOUBLE:
+            wide.d64 = value->d64;
+            break;
+
+        default:
+            break;
+    }
+
+    return wide;
+}
+
+/*
+ * 32 bit counter lower than last value either wrapped or was cleared. Wrap
+ * from upper half of range gives delta lower than 2^31, while clear of
+ * counter, which didn't come close to wrap, gives bigger one, so then
+ * value is counted from zero.
+ */
+static uint64_t otai_metadata_pm_u32_delta(
+        _In_ uint32_t value,
+        _In_ uint32_t last)
+{
+    uint32_t delta = value - last;
+
+    if (value < last && delta > (UINT32_MAX >> 1))
+    {
+        return value;
+    }
+
+    return delta;
+}
+
+static void otai_metadata_pm_add_delta(
+        _In_ otai_stat_value_type_t type,
+        _Inout_ otai_stat_value_t *delta,
+        _In_ const otai_stat_value_t *value,
+        _In_ const otai_stat_value_t *last)
+{
+    /*
+     * Counter lower than last value was reset, so value is counted from
+     * zero. Without last value, value is delta itself.
+     */
+
+    switch (type)
+    {
+        case OTAI_STAT_VALUE_TYPE_INT32:
+        case OTAI_STAT_VALUE_TYPE_INT64:
+            delta->s64 += (last == NULL || value->s64 < last->s64) ? value->s64 : value->s64 - last->s64;
+            break;
+
+        case OTAI_STAT_VALUE_TYPE_DOUBLE:
+            delta->d64 += (last == NULL || value->d64 < last->d64) ? value->d64 : value->d64 - last->d64;
+            break;
+
+        case OTAI_STAT_VALUE_TYPE_UINT32:
+            delta->u64 += (last == NULL) ? value->u64 : otai_metadata_pm_u32_delta((uint32_t)value->u64, (uint32_t)last->u64);
+            break;
+
+        default:
+            delta->u64 += (last == NULL || value->u64 < last->u64) ? value->u64 : value->u64 - last->u64;
+            break;
+    }
+}
+
+static void otai_metadata_pm_update_index(
+        _Inout_ otai_metadata_pm_t *pm,
+        _In_ uint32_t index,
+        _In_ const otai_stat_value_t *counters)
+{
+    bool readandclear = (pm->mode == OTAI_STATS_MODE_READ_AND_CLEAR);
+
+    bool lastvalid = pm->lastvalid[index];
+
+    otai_metadata_pm_bin_t *current[OTAI_METADATA_PM_INTERVAL_MAX];
+
+    int interval = 0;
+
+    for (; interval < OTAI_METADATA_PM_INTERVAL_MAX; interval++)
+    {
+        current[interval] = &pm->bins[interval][pm->current[interval]];
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < pm->statcount; idx++)
+    {
+        otai_stat_value_type_t type = pm->statmetadata[idx]->statvaluetype;
+
+        size_t pos = (size_t)pm->column[idx] * pm->capacity + index;
+
+        if (pm->statmetadata[idx]->statvalueiscounter)
+        {
+            otai_stat_value_t value = otai_metadata_pm_widen(type, &counters[idx]);
+
+            if (readandclear || lastvalid)
+            {
+                for (interval = 0; interval < OTAI_METADATA_PM_INTERVAL_MAX; interval++)
+                {
+                    otai_metadata_pm_add_delta(type, &current[interval]->delta[pos], &value, readandclear ? NULL : &pm->last[pos]);
+                }
+            }
+
+            pm->last[pos] = value;
+
+            continue;
+        }
+
+        double value = otai_metadata_pm_to_double(type, &counters[idx]);
+
+        for (interval = 0; interval < OTAI_METADATA_PM_INTERVAL_MAX; interval++)
+        {
+            otai_metadata_pm_bin_t *bin = current[interval];
+
+            if (bin->samples[index] == 0)
+            {
+                bin->min[pos] = value;
+                bin->max[pos] = value;
+                bin->sum[pos] = value;
+
+                continue;
+            }
+
+            bin->min[pos] = (value < bin->min[pos]) ? value : bin->min[pos];
+            bin->max[pos] = (value > bin->max[pos]) ? value : bin->max[pos];
+            bin->sum[pos] += value;
+        }
+    }
+
+    for (interval = 0; interval < OTAI_METADATA_PM_INTERVAL_MAX; interval++)
+    {
+        current[interval]->samples[index]++;
+    }
+
+    pm->lastvalid[index] = true;
+}
+
+otai_status_t otai_metadata_pm_update(
+        _Inout_ otai_metadata_pm_t *pm,
+        _In_ otai_object_id_t object_id,
+        _In_ const otai_stat_value_t *counters)
+{
+    uint32_t index;
+
+    if (!otai_metadata_objectmap_find(&pm->objectmap, object_id, &index))
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    otai_metadata_pm_update_index(pm, index, counters);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_pm_sample(
+        _Inout_ otai_metadata_pm_t *pm)
+{
+    otai_status_t result = OTAI_STATUS_SUCCESS;
+
+    if (pm->info == NULL || pm->info->getstatsext == NULL)
+    {
+        OTAI_META_LOG_ERROR("object type %d has no get stats extended API", pm->objecttype);
+
+        return OTAI_STATUS_NOT_IMPLEMENTED;
+    }
+
+    otai_object_meta_key_t meta_key;
+
+    meta_key.objecttype = pm->objecttype;
+
+    uint32_t index = 0;
+
+    for (; index < pm->objectcount; index++)
+    {
+        meta_key.objectkey.key.object_id = pm->objects[index];
+
+        otai_status_t status = pm->info->getstatsext(&meta_key, pm->statcount, pm->statids, pm->mode, pm->values);
+
+        if (status != OTAI_STATUS_SUCCESS)
+        {
+            OTAI_META_LOG_DEBUG("failed to get stats of 0x%" PRIx64 ": %d", pm->objects[index], status);
+
+            result = status;
+
+            continue;
+        }
+
+        otai_metadata_pm_update_index(pm, index, pm->values);
+    }
+
+    return result;
+}
+
+void otai_metadata_pm_end_bin(
+        _Inout_ otai_metadata_pm_t *pm,
+        _In_ otai_metadata_pm_interval_t interval,
+        _In_ uint64_t start_time)
+{
+    if (interval < 0 || interval >= OTAI_METADATA_PM_INTERVAL_MAX)
+    {
+        return;
+    }
+
+    uint32_t next = pm->current[interval] + 1;
+
+    if (next > pm->history[interval])
+    {
+        next = 0;
+    }
+
+    otai_metadata_pm_bin_reset(&pm->bins[interval][next], pm, start_time);
+
+    pm->current[interval] = next;
+}
+
+otai_status_t otai_metadata_pm_get_value(
+        _In_ const otai_metadata_pm_t *pm,
+        _In_ otai_metadata_pm_interval_t interval,
+        _In_ size_t age,
+        _In_ otai_object_id_t object_id,
+        _In_ otai_stat_id_t stat_id,
+        _Out_ uint64_t *start_time,
+        _Out_ otai_metadata_pm_value_t *value)
+{
+    memset(value, 0, sizeof(otai_metadata_pm_value_t));
+
+    if (interval < 0 || interval >= OTAI_METADATA_PM_INTERVAL_MAX || age > pm->history[interval])
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t index;
+
+    if (!otai_metadata_objectmap_find(&pm->objectmap, object_id, &index))
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    uint32_t idx = 0;
+
+    while (idx < pm->statcount && pm->statids[idx] != stat_id)
+    {
+        idx++;
+    }
+
+    if (idx == pm->statcount)
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    uint32_t count = pm->history[interval] + 1;
+
+    const otai_metadata_pm_bin_t *bin = &pm->bins[interval][(pm->current[interval] + count - (uint32_t)age) % count];
+
+    size_t pos = (size_t)pm->column[idx] * pm->capacity + index;
+
+    *start_time = bin->starttime;
+
+    value->iscounter = pm->statmetadata[idx]->statvalueiscounter;
+    value->samples = bin->samples[index];
+
+    if (value->iscounter)
+    {
+        value->delta = bin->delta[pos];
+    }
+    else if (value->samples != 0)
+    {
+        value->min = bin->min[pos];
+        value->max = bin->max[pos];
+        value->avg = bin->sum[pos] / value->samples;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
@@ -0,0 +1,409 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatapm.h
+ *
+ * @brief   This module defines OTAI Metadata performance monitoring bins
+ */
+
+#ifndef __OTAIMETADATAPM_H_
+#define __OTAIMETADATAPM_H_
+
+#include "otaimetadatatypes.h"
+#include "otaimetadataobjectmap.h"
+
+/**
+ * @defgroup OTAIMETADATAPM OTAI - Metadata performance monitoring bins
+ *
+ * PM engine keeps 15 minute and 24 hour bins of statistics of objects of
+ * single object type. Objects are sampled with get stats extended API of
+ * object type, so otai_metadata_apis_query() must be called first, or
+ * samples are passed by user.
+ *
+ * For counters, as marked by statvalueiscounter in statistics metadata, bin
+ * keeps delta over bin interval, for gauges it keeps minimum, maximum and
+ * average of samples. Unsigned 32 bit counter lower than last value is
+ * taken as wrapped, unless delta modulo 2^32 is bigger than half of range,
+ * then counter was cleared and value is counted from zero.
+ *
+ * Bin values are kept in arrays per statistic, indexed by object, so
+ * sampling and ending bin go over contiguous memory. Ending bin only
+ * resets oldest bin, which becomes new current bin.
+ *
+ * @{
+ */
+
+/**
+ * @brief PM bin interval.
+ */
+typedef enum _otai_metadata_pm_interval_t
+{
+    /**
+     * @brief Fifteen minute bins.
+     */
+    OTAI_METADATA_PM_INTERVAL_15_MIN,
+
+    /**
+     * @brief Twenty four hour bins.
+     */
+    OTAI_METADATA_PM_INTERVAL_24_HOUR,
+
+    /**
+     * @brief Number of intervals.
+     */
+    OTAI_METADATA_PM_INTERVAL_MAX,
+
+} otai_metadata_pm_interval_t;
+
+/**
+ * @brief PM engine configuration.
+ */
+typedef struct _otai_metadata_pm_config_t
+{
+    /**
+     * @brief Object type of sampled objects.
+     */
+    otai_object_type_t                           objecttype;
+
+    /**
+     * @brief Number of sampled statistics.
+     */
+    otai_uint32_t                                statcount;
+
+    /**
+     * @brief Sampled statistics.
+     */
+    const otai_stat_id_t*                        statids;
+
+    /**
+     * @brief Maximum number of objects.
+     */
+    otai_uint32_t                                capacity;
+
+    /**
+     * @brief Number of historical bins of each interval.
+     */
+    otai_uint32_t                                history[OTAI_METADATA_PM_INTERVAL_MAX];
+
+    /**
+     * @brief Statistics mode.
+     *
+     * With #OTAI_STATS_MODE_READ_AND_CLEAR counters are read as deltas.
+     */
+    otai_stats_mode_t                            mode;
+
+} otai_metadata_pm_config_t;
+
+/**
+ * @brief PM bin of all objects.
+ */
+typedef struct _otai_metadata_pm_bin_t
+{
+    /**
+     * @brief Bin start time, as passed by user.
+     */
+    otai_uint64_t                                starttime;
+
+    /**
+     * @brief Number of samples of each object.
+     */
+    otai_uint32_t*                               samples;
+
+    /**
+     * @brief Gauge minimum, indexed by gauge and object.
+     */
+    otai_double_t*                               min;
+
+    /**
+     * @brief Gauge maximum, indexed by gauge and object.
+     */
+    otai_double_t*                               max;
+
+    /**
+     * @brief Gauge sum, indexed by gauge and object.
+     */
+    otai_double_t*                               sum;
+
+    /**
+     * @brief Counter delta, indexed by counter and object.
+     */
+    otai_stat_value_t*                           delta;
+
+} otai_metadata_pm_bin_t;
+
+/**
+ * @brief PM engine.
+ */
+typedef struct _otai_metadata_pm_t
+{
+    /**
+     * @brief Object type of sampled objects.
+     */
+    otai_object_type_t                           objecttype;
+
+    /**
+     * @brief Statistics mode.
+     */
+    otai_stats_mode_t                            mode;
+
+    /**
+     * @brief Object type info, used to get stats.
+     */
+    const otai_object_type_info_t*               info;
+
+    /**
+     * @brief Number of sampled statistics.
+     */
+    otai_uint32_t                                statcount;
+
+    /**
+     * @brief Sampled statistics.
+     */
+    otai_stat_id_t*                              statids;
+
+    /**
+     * @brief Metadata of sampled statistics.
+     */
+    const otai_stat_metadata_t**                 statmetadata;
+
+    /**
+     * @brief Gauge or counter index of each statistic.
+     */
+    otai_uint32_t*                               column;
+
+    /**
+     * @brief Number of gauges.
+     */
+    otai_uint32_t                                gaugecount;
+
+    /**
+     * @brief Number of counters.
+     */
+    otai_uint32_t                                countercount;
+
+    /**
+     * @brief Maximum number of objects.
+     */
+    otai_uint32_t                                capacity;
+
+    /**
+     * @brief Number of objects.
+     */
+    otai_uint32_t                                objectcount;
+
+    /**
+     * @brief Sampled objects.
+     */
+    otai_object_id_t*                            objects;
+
+    /**
+     * @brief Index of each sampled object.
+     */
+    otai_metadata_objectmap_t                    objectmap;
+
+    /**
+     * @brief Last counter value, indexed by counter and object.
+     */
+    otai_stat_value_t*                           last;
+
+    /**
+     * @brief Whether object has last counter values.
+     */
+    bool*                                        lastvalid;
+
+    /**
+     * @brief Sample buffer.
+     */
+    otai_stat_value_t*                           values;
+
+    /**
+     * @brief Number of historical bins of each interval.
+     */
+    otai_uint32_t                                history[OTAI_METADATA_PM_INTERVAL_MAX];
+
+    /**
+     * @brief Current bin of each interval.
+     */
+    otai_uint32_t                                current[OTAI_METADATA_PM_INTERVAL_MAX];
+
+    /**
+     * @brief Current and historical bins of each interval.
+     */
+    otai_metadata_pm_bin_t*                      bins[OTAI_METADATA_PM_INTERVAL_MAX];
+
+} otai_metadata_pm_t;
+
+/**
+ * @brief PM value of single object and statistic.
+ */
+typedef struct _otai_metadata_pm_value_t
+{
+    /**
+     * @brief Whether statistic is counter.
+     */
+    bool                                         iscounter;
+
+    /**
+     * @brief Number of samples in bin.
+     */
+    otai_uint32_t                                samples;
+
+    /**
+     * @brief Counter delta, of s64, u64 or d64 type.
+     *
+     * Signed counters use s64, unsigned u64 and double d64.
+     */
+    otai_stat_value_t                            delta;
+
+    /**
+     * @brief Gauge minimum.
+     */
+    otai_double_t                                min;
+
+    /**
+     * @brief Gauge maximum.
+     */
+    otai_double_t                                max;
+
+    /**
+     * @brief Gauge average.
+     */
+    otai_double_t                                avg;
+
+} otai_metadata_pm_value_t;
+
+/**
+ * @brief Initialize PM engine
+ *
+ * All bins are allocated here.
+ *
+ * @param[out] pm PM engine
+ * @param[in] config Configuration
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if configuration is invalid, #OTAI_STATUS_NO_MEMORY if bins can't be
+ * allocated
+ */
+extern otai_status_t otai_metadata_pm_init(
+        _Out_ otai_metadata_pm_t *pm,
+        _In_ const otai_metadata_pm_config_t *config);
+
+/**
+ * @brief Release PM engine memory
+ *
+ * @param[inout] pm PM engine
+ */
+extern void otai_metadata_pm_destroy(
+        _Inout_ otai_metadata_pm_t *pm);
+
+/**
+ * @brief Add sampled object
+ *
+ * @param[inout] pm PM engine
+ * @param[in] object_id Object id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_ALREADY_EXISTS
+ * if object is already added, #OTAI_STATUS_TABLE_FULL if there is no room
+ */
+extern otai_status_t otai_metadata_pm_add_object(
+        _Inout_ otai_metadata_pm_t *pm,
+        _In_ otai_object_id_t object_id);
+
+/**
+ * @brief Remove sampled object
+ *
+ * Last object takes place of removed object.
+ *
+ * @param[inout] pm PM engine
+ * @param[in] object_id Object id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object is not added
+ */
+extern otai_status_t otai_metadata_pm_remove_object(
+        _Inout_ otai_metadata_pm_t *pm,
+        _In_ otai_object_id_t object_id);
+
+/**
+ * @brief Add sample of single object to current bins
+ *
+ * @param[inout] pm PM engine
+ * @param[in] object_id Object id
+ * @param[in] counters Values of configured statistics, in configured order
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object is not added
+ */
+extern otai_status_t otai_metadata_pm_update(
+        _Inout_ otai_metadata_pm_t *pm,
+        _In_ otai_object_id_t object_id,
+        _In_ const otai_stat_value_t *counters);
+
+/**
+ * @brief Sample all objects with get stats extended API
+ *
+ * Objects for which API fails are skipped.
+ *
+ * @param[inout] pm PM engine
+ *
+ * @return #OTAI_STATUS_SUCCESS if all objects were sampled, otherwise
+ * status of last failed object
+ */
+extern otai_status_t otai_metadata_pm_sample(
+        _Inout_ otai_metadata_pm_t *pm);
+
+/**
+ * @brief End current bin and start new one
+ *
+ * Oldest historical bin is reset and becomes current bin.
+ *
+ * @param[inout] pm PM engine
+ * @param[in] interval Bin interval
+ * @param[in] start_time Start time of new bin
+ */
+extern void otai_metadata_pm_end_bin(
+        _Inout_ otai_metadata_pm_t *pm,
+        _In_ otai_metadata_pm_interval_t interval,
+        _In_ uint64_t start_time);
+
+/**
+ * @brief Get bin value
+ *
+ * @param[in] pm PM engine
+ * @param[in] interval Bin interval
+ * @param[in] age Age of bin, 0 for current bin, 1 for last ended bin and
+ * so on
+ * @param[in] object_id Object id
+ * @param[in] stat_id Statistic id
+ * @param[out] start_time Bin start time
+ * @param[out] value Bin value
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object or statistic is not sampled, #OTAI_STATUS_INVALID_PARAMETER if
+ * interval or age is out of range
+ */
+extern otai_status_t otai_metadata_pm_get_value(
+        _In_ const otai_metadata_pm_t *pm,
+        _In_ otai_metadata_pm_interval_t interval,
+        _In_ size_t age,
+        _In_ otai_object_id_t object_id,
+        _In_ otai_stat_id_t stat_id,
+        _Out_ uint64_t *start_time,
+        _Out_ otai_metadata_pm_value_t *value);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATAPM_H_ */
@@ -0,0 +1,255 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatapool.c
+ *
+ * @brief   This module implements OTAI Metadata reference counted buffer pool
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <otai.h>
+#include "otaimetadatalogger.h"
+#include "otaimetadatapool.h"
+
+#define OTAI_METADATA_POOL_ALIGN 64
+
+otai_status_t otai_metadata_pool_init(
+        _Out_ otai_metadata_pool_t *pool,
+        _In_ size_t buffer_size,
+        _In_ uint32_t count)
+{
+    memset(pool, 0, sizeof(otai_metadata_pool_t));
+
+    if (buffer_size == 0 || count == 0)
+    {
+        OTAI_META_LOG_ERROR("invalid buffer size %zu or count %u", buffer_size, count);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    pool->buffersize = (buffer_size + OTAI_METADATA_POOL_ALIGN - 1) & ~(size_t)(OTAI_METADATA_POOL_ALIGN - 1);
+    pool->count = count;
+
+    /*
+     * Buffers are allocated with malloc alignment, first buffer is moved
+     * to 64 byte boundary, so extra buffer size is allocated.
+     */
+
+    pool->buffers = malloc(pool->buffersize * count + OTAI_METADATA_POOL_ALIGN);
+    pool->refcount = calloc(count, sizeof(uint32_t));
+    pool->next = calloc(count, sizeof(uint32_t));
+
+    if (pool->buffers == NULL || pool->refcount == NULL || pool->next == NULL)
+    {
+        otai_metadata_pool_destroy(pool);
+
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < count; idx++)
+    {
+        pool->next[idx] = (idx + 1 < count) ? idx + 2 : 0;
+    }
+
+    pool->head = 1;
+    pool->available = count;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+void otai_metadata_pool_destroy(
+        _Inout_ otai_metadata_pool_t *pool)
+{
+    free(pool->buffers);
+    free(pool->refcount);
+    free(pool->next);
+
+    memset(pool, 0, sizeof(otai_metadata_pool_t));
+}
+
+static uint8_t* otai_metadata_pool_get_buffer(
+        _In_ const otai_metadata_pool_t *pool,
+        _In_ uint32_t idx)
+{
+    size_t offset = (OTAI_METADATA_POOL_ALIGN - (uintptr_t)pool->buffers % OTAI_METADATA_POOL_ALIGN) % OTAI_METADATA_POOL_ALIGN;
+
+    return pool->buffers + offset + pool->buffersize * idx;
+}
+
+void* otai_metadata_pool_acquire(
+        _Inout_ otai_metadata_pool_t *pool)
+{
+    uint64_t head = __atomic_load_n(&pool->head, __ATOMIC_ACQUIRE);
+
+    uint64_t next;
+
+    do
+    {
+        uint32_t idx = (uint32_t)head;
+
+        if (idx == 0)
+        {
+            return NULL;
+        }
+
+        next = (((head >> 32) + 1) << 32) | __atomic_load_n(&pool->next[idx - 1], __ATOMIC_RELAXED);
+    }
+    while (!__atomic_compare_exchange_n(&pool->head, &head, next, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+    uint32_t idx = (uint32_t)head - 1;
+
+    __atomic_store_n(&pool->refcount[idx], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&pool->available, 1, __ATOMIC_RELAXED);
+
+    return otai_metadata_pool_get_buffer(pool, idx);
+}
+
+static bool otai_metadata_pool_get_index(
+        _In_ const otai_metadata_pool_t *pool,
+        _In_ const void *buffer,
+        _Out_ uint32_t *idx)
+{
+    const uint8_t *first = otai_metadata_pool_get_buffer(pool, 0);
+    const uint8_t *ptr = buffer;
+
+    if (pool->buffers == NULL || ptr < first || ptr >= first + pool->buffersize * pool->count)
+    {
+        return false;
+    }
+
+    size_t offset = (size_t)(ptr - first);
+
+    if (offset % pool->buffersize != 0)
+    {
+        return false;
+    }
+
+    *idx = (uint32_t)(offset / pool->buffersize);
+
+    return true;
+}
+
+otai_status_t otai_metadata_pool_ref(
+        _Inout_ otai_metadata_pool_t *pool,
+        _In_ const void *buffer)
+{
+    uint32_t idx;
+
+    if (!otai_metadata_pool_get_index(pool, buffer, &idx))
+    {
+        OTAI_META_LOG_ERROR("buffer %p is not from pool", buffer);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t refcount = __atomic_load_n(&pool->refcount[idx], __ATOMIC_RELAXED);
+
+    do
+    {
+        if (refcount == 0)
+        {
+            OTAI_META_LOG_ERROR("buffer %p is not in use", buffer);
+
+            return OTAI_STATUS_INVALID_PARAMETER;
+        }
+    }
+    while (!__atomic_compare_exchange_n(&pool->refcount[idx], &refcount, refcount + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_pool_release(
+        _Inout_ otai_metadata_pool_t *pool,
+        _In_ const void *buffer)
+{
+    uint32_t idx;
+
+    if (!otai_metadata_pool_get_index(pool, buffer, &idx))
+    {
+        OTAI_META_LOG_ERROR("buffer %p is not from pool", buffer);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t refcount = __atomic_load_n(&pool->refcount[idx], __ATOMIC_RELAXED);
+
+    do
+    {
+        if (refcount == 0)
+        {
+            OTAI_META_LOG_ERROR("buffer %p is not in use", buffer);
+
+            return OTAI_STATUS_INVALID_PARAMETER;
+        }
+    }
+    while (!__atomic_compare_exchange_n(&pool->refcount[idx], &refcount, refcount - 1, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    if (refcount != 1)
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    /* last reference, buffer goes back to free list */
+
+    uint64_t head = __atomic_load_n(&pool->head, __ATOMIC_ACQUIRE);
+
+    uint64_t next;
+
+    do
+    {
+        __atomic_store_n(&pool->next[idx], (uint32_t)head, __ATOMIC_RELAXED);
+
+        next = (((head >> 32) + 1) << 32) | (idx + 1);
+    }
+    while (!__atomic_compare_exchange_n(&pool->head, &head, next, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+
+    __atomic_fetch_add(&pool->available, 1, __ATOMIC_RELAXED);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+uint32_t otai_metadata_pool_get_available(
+        _In_ const otai_metadata_pool_t *pool)
+{
+    return __atomic_load_n(&pool->available, __ATOMIC_RELAXED);
+}
+
+void otai_metadata_pool_report_aps_switch_info(
+        _Inout_ otai_metadata_pool_t *pool,
+        _In_ otai_pointer_t ref_notify,
+        _In_ otai_pointer_t notify,
+        _In_ otai_object_id_t aps_id,
+        _In_ const otai_olp_switch_t *switch_info)
+{
+    if (ref_notify != NULL)
+    {
+        /* reference is passed to user, user releases it */
+
+        ((otai_aps_report_switch_info_ref_fn)ref_notify)(aps_id, switch_info);
+
+        return;
+    }
+
+    if (notify != NULL)
+    {
+        ((otai_aps_report_switch_info_fn)notify)(aps_id, *switch_info);
+    }
+
+    otai_metadata_pool_release(pool, switch_info);
+}
@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatapool.h
+ *
+ * @brief   This module defines OTAI Metadata reference counted buffer pool
+ */
+
+#ifndef __OTAIMETADATAPOOL_H_
+#define __OTAIMETADATAPOOL_H_
+
+#include "otaimetadatatypes.h"
+
+/**
+ * @defgroup OTAIMETADATAPOOL OTAI - Metadata reference counted buffer pool
+ *
+ * Pool of fixed size buffers for notifications passed by reference, like
+ * otai_aps_report_switch_info_ref_fn. Adapter fills buffer in place and
+ * passes pointer to notification, buffer returns to pool when last
+ * reference is released. Acquire and release are lock free.
+ *
+ * @{
+ */
+
+/**
+ * @brief Reference counted buffer pool.
+ */
+typedef struct _otai_metadata_pool_t
+{
+    /**
+     * @brief Buffer memory.
+     */
+    uint8_t*                                     buffers;
+
+    /**
+     * @brief Reference count of each buffer.
+     */
+    uint32_t*                                    refcount;
+
+    /**
+     * @brief Next free buffer index plus one, for each free buffer.
+     */
+    uint32_t*                                    next;
+
+    /**
+     * @brief Size of single buffer in bytes.
+     */
+    size_t                                       buffersize;
+
+    /**
+     * @brief Number of buffers.
+     */
+    otai_uint32_t                                count;
+
+    /**
+     * @brief Free list head, change tag in upper and index plus one in
+     * lower 32 bits.
+     */
+    otai_uint64_t                                head;
+
+    /**
+     * @brief Number of free buffers.
+     */
+    otai_uint32_t                                available;
+
+} otai_metadata_pool_t;
+
+/**
+ * @brief Initialize buffer pool
+ *
+ * All buffers are allocated here, so no memory is allocated later.
+ *
+ * @param[out] pool Pool to be initialized
+ * @param[in] buffer_size Size of single buffer in bytes
+ * @param[in] count Number of buffers
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if size or count is zero, #OTAI_STATUS_NO_MEMORY if buffers can't be
+ * allocated
+ */
+extern otai_status_t otai_metadata_pool_init(
+        _Out_ otai_metadata_pool_t *pool,
+        _In_ size_t buffer_size,
+        _In_ uint32_t count);
+
+/**
+ * @brief Release pool memory
+ *
+ * All buffers must be released before pool is destroyed.
+ *
+ * @param[inout] pool Pool
+ */
+extern void otai_metadata_pool_destroy(
+        _Inout_ otai_metadata_pool_t *pool);
+
+/**
+ * @brief Acquire buffer from pool
+ *
+ * Buffer has single reference and it is aligned to 64 bytes.
+ *
+ * @param[inout] pool Pool
+ *
+ * @return Buffer or NULL if all buffers are in use
+ */
+extern void* otai_metadata_pool_acquire(
+        _Inout_ otai_metadata_pool_t *pool);
+
+/**
+ * @brief Add buffer reference
+ *
+ * @param[inout] pool Pool
+ * @param[in] buffer Buffer acquired from pool
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if buffer is not in use
+ */
+extern otai_status_t otai_metadata_pool_ref(
+        _Inout_ otai_metadata_pool_t *pool,
+        _In_ const void *buffer);
+
+/**
+ * @brief Release buffer reference
+ *
+ * Buffer returns to pool when last reference is released.
+ *
+ * @param[inout] pool Pool
+ * @param[in] buffer Buffer acquired from pool
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if buffer is not in use
+ */
+extern otai_status_t otai_metadata_pool_release(
+        _Inout_ otai_metadata_pool_t *pool,
+        _In_ const void *buffer);
+
+/**
+ * @brief Get number of free buffers
+ *
+ * @param[in] pool Pool
+ *
+ * @return Number of free buffers
+ */
+extern uint32_t otai_metadata_pool_get_available(
+        _In_ const otai_metadata_pool_t *pool);
+
+/**
+ * @brief Report APS switch info from pool buffer
+ *
+ * Helper for adapters. If reference notification is registered, buffer
+ * reference is passed to it and user releases it. Otherwise switch info is
+ * passed by value to old notification and buffer is released here, so
+ * users of old notification keep working.
+ *
+ * @param[inout] pool Pool of switch info buffers
+ * @param[in] ref_notify Value of #OTAI_APS_ATTR_SWITCH_INFO_REF_NOTIFY
+ * @param[in] notify Value of #OTAI_APS_ATTR_SWITCH_INFO_NOTIFY
+ * @param[in] aps_id APS id
+ * @param[in] switch_info Switch info in buffer acquired from pool
+ */
+extern void otai_metadata_pool_report_aps_switch_info(
+        _Inout_ otai_metadata_pool_t *pool,
+        _In_ otai_pointer_t ref_notify,
+        _In_ otai_pointer_t notify,
+        _In_ otai_object_id_t aps_id,
+        _In_ const otai_olp_switch_t *switch_info);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATAPOOL_H_ */
@@ -0,0 +1,610 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatarate.c
+ *
+ * @brief   This module implements OTAI Metadata counter rate engine
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <otai.h>
+#include "otaimetadatautils.h"
+#include "otaimetadatalogger.h"
+#include "otaimetadatarate.h"
+
+otai_status_t otai_metadata_rate_init(
+        _Out_ otai_metadata_rate_t *rate,
+        _In_ const otai_metadata_rate_config_t *config)
+{
+    memset(rate, 0, sizeof(otai_metadata_rate_t));
+
+    const otai_object_type_info_t *info = otai_metadata_get_object_type_info(config->objecttype);
+
+    if (info == NULL || info->statenum == NULL)
+    {
+        OTAI_META_LOG_ERROR("object type %d has no statistics", config->objecttype);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (config->statcount == 0 || config->statids == NULL || config->capacity == 0)
+    {
+        OTAI_META_LOG_ERROR("no counters or objects to sample");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    rate->objecttype = config->objecttype;
+    rate->mode = config->mode;
+    rate->info = info;
+    rate->statcount = config->statcount;
+    rate->capacity = config->capacity;
+
+    size_t size = (size_t)config->statcount * config->capacity;
+
+    rate->statids = calloc(config->statcount, sizeof(otai_stat_id_t));
+    rate->statvaluetypes = calloc(config->statcount, sizeof(otai_stat_value_type_t));
+    rate->objects = calloc(config->capacity, sizeof(otai_object_id_t));
+    rate->pending = calloc(config->capacity, sizeof(uint64_t));
+    rate->valid = calloc(config->capacity, sizeof(uint64_t));
+    rate->lasttime = calloc(config->capacity, sizeof(uint64_t));
+    rate->scale = calloc(config->capacity, sizeof(double));
+    rate->current = calloc(size, sizeof(uint64_t));
+    rate->last = calloc(size, sizeof(uint64_t));
+    rate->delta = calloc(size, sizeof(uint64_t));
+    rate->rate = calloc(size, sizeof(double));
+    rate->values = calloc(config->statcount, sizeof(otai_stat_value_t));
+
+    if (rate->statids == NULL || rate->statvaluetypes == NULL || rate->objects == NULL ||
+            rate->pending == NULL || rate->valid == NULL || rate->lasttime == NULL ||
+            rate->scale == NULL || rate->current == NULL || rate->last == NULL ||
+            rate->delta == NULL || rate->rate == NULL || rate->values == NULL ||
+            otai_metadata_objectmap_init(&rate->objectmap, config->capacity) != OTAI_STATUS_SUCCESS)
+    {
+        otai_metadata_rate_destroy(rate);
+
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < config->statcount; idx++)
+    {
+        const otai_stat_metadata_t *md = otai_metadata_get_stat_metadata(config->objecttype, config->statids[idx]);
+
+        if (md == NULL || !md->statvalueiscounter)
+        {
+            OTAI_META_LOG_ERROR("statistic %d is not counter of object type %d", config->statids[idx], config->objecttype);
+
+            otai_metadata_rate_destroy(rate);
+
+            return OTAI_STATUS_INVALID_PARAMETER;
+        }
+
+        rate->statids[idx] = config->statids[idx];
+        rate->statvaluetypes[idx] = md->statvaluetype;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+void otai_metadata_rate_destroy(
+        _Inout_ otai_metadata_rate_t *rate)
+{
+    free(rate->statids);
+    free(rate->statvaluetypes);
+    free(rate->objects);
+    free(rate->pending);
+    free(rate->valid);
+    free(rate->lasttime);
+    free(rate->scale);
+    free(rate->current);
+    free(rate->last);
+    free(rate->delta);
+    free(rate->rate);
+    free(rate->values);
+
+    otai_metadata_objectmap_destroy(&rate->objectmap);
+
+    memset(rate, 0, sizeof(otai_metadata_rate_t));
+}
+
+otai_status_t otai_metadata_rate_add_object(
+        _Inout_ otai_metadata_rate_t *rate,
+        _In_ otai_object_id_t object_id)
+{
+    uint32_t index = rate->objectcount;
+
+    otai_status_t status = otai_metadata_objectmap_insert(&rate->objectmap, object_id, index);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    rate->objectcount++;
+
+    rate->objects[index] = object_id;
+    rate->pending[index] = 0;
+    rate->valid[index] = 0;
+    rate->lasttime[index] = 0;
+    rate->scale[index] = 0;
+
+    uint32_t idx = 0;
+
+    for (; idx < rate->statcount; idx++)
+    {
+        size_t pos = (size_t)idx * rate->capacity + index;
+
+        rate->delta[pos] = 0;
+        rate->rate[pos] = 0;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_rate_remove_object(
+        _Inout_ otai_metadata_rate_t *rate,
+        _In_ otai_object_id_t object_id)
+{
+    uint32_t index;
+
+    if (!otai_metadata_objectmap_find(&rate->objectmap, object_id, &index))
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    otai_metadata_objectmap_remove(&rate->objectmap, object_id);
+
+    uint32_t last = --rate->objectcount;
+
+    if (index == last)
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    rate->objects[index] = rate->objects[last];
+
+    otai_metadata_objectmap_set(&rate->objectmap, rate->objects[index], index);
+
+    rate->pending[index] = rate->pending[last];
+    rate->valid[index] = rate->valid[last];
+    rate->lasttime[index] = rate->lasttime[last];
+    rate->scale[index] = rate->scale[last];
+
+    uint32_t idx = 0;
+
+    for (; idx < rate->statcount; idx++)
+    {
+        size_t base = (size_t)idx * rate->capacity;
+
+        rate->current[base + index] = rate->current[base + last];
+        rate->last[base + index] = rate->last[base + last];
+        rate->delta[base + index] = rate->delta[base + last];
+        rate->rate[base + index] = rate->rate[base + last];
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static void otai_metadata_rate_update_index(
+        _Inout_ otai_metadata_rate_t *rate,
+        _In_ uint32_t index,
+        _In_ const otai_stat_value_t *counters)
+{
+    uint32_t idx = 0;
+
+    for (; idx < rate->statcount; idx++)
+    {
+        otai_stat_value_t value = counters[idx];
+
+        switch (rate->statvaluetypes[idx])
+        {
+            case OTAI_STAT_VALUE_TYPE_INT32:
+                value.s64 = counters[idx].s32;
+                break;
+
+            case OTAI_STAT_VALUE_TYPE_UINT32:
+                value.u64 = counters[idx].u32;
+                break;
+
+            default:
+                break;
+        }
+
+        rate->current[(size_t)idx * rate->capacity + index] = value.u64;
+    }
+
+    rate->pending[index] = UINT64_MAX;
+}
+
+otai_status_t otai_metadata_rate_update(
+        _Inout_ otai_metadata_rate_t *rate,
+        _In_ otai_object_id_t object_id,
+        _In_ const otai_stat_value_t *counters)
+{
+    uint32_t index;
+
+    if (!otai_metadata_objectmap_find(&rate->objectmap, object_id, &index))
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    otai_metadata_rate_update_index(rate, index, counters);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_rate_sample(
+        _Inout_ otai_metadata_rate_t *rate)
+{
+    otai_status_t result = OTAI_STATUS_SUCCESS;
+
+    if (rate->info == NULL || rate->info->getstatsext == NULL)
+    {
+        OTAI_META_LOG_ERROR("object type %d has no get stats extended API", rate->objecttype);
+
+        return OTAI_STATUS_NOT_IMPLEMENTED;
+    }
+
+    otai_object_meta_key_t meta_key;
+
+    meta_key.objecttype = rate->objecttype;
+
+    uint32_t index = 0;
+
+    for (; index < rate->objectcount; index++)
+    {
+        meta_key.objectkey.key.object_id = rate->objects[index];
+
+        otai_status_t status = rate->info->getstatsext(&meta_key, rate->statcount, rate->statids, rate->mode, rate->values);
+
+        if (status != OTAI_STATUS_SUCCESS)
+        {
+            OTAI_META_LOG_DEBUG("failed to get stats of 0x%" PRIx64 ": %d", rate->objects[index], status);
+
+            result = status;
+
+            continue;
+        }
+
+        otai_metadata_rate_update_index(rate, index, rate->values);
+    }
+
+    return result;
+}
+
+/*
+ * Loops below have no branches, object masks select which objects get
+ * new delta, which keep delta of last computation and which take new
+ * sample as previous one, so compiler can vectorize them. All counters in
+ * OTAI headers are unsigned, so only unsigned loops are on hot path.
+ */
+
+static void otai_metadata_rate_compute_u32(
+        _In_ uint32_t count,
+        _In_ bool readandclear,
+        _In_ const uint64_t *__restrict pending,
+        _In_ const uint64_t *__restrict valid,
+        _In_ const uint64_t *__restrict current,
+        _Inout_ uint64_t *__restrict last,
+        _Inout_ uint64_t *__restrict delta)
+{
+    uint64_t mask = readandclear ? 0 : UINT64_MAX;
+
+    uint32_t idx = 0;
+
+    for (; idx < count; idx++)
+    {
+        /*
+         * Wrap of 32 bit counter is taken modulo 2^32, but counter lower
+         * than previous sample with delta over half of range was cleared,
+         * and is counted from zero.
+         */
+
+        uint64_t prev = last[idx] & mask;
+        uint64_t wide = current[idx] - prev;
+        uint64_t diff = wide & UINT32_MAX;
+
+        /* both samples are below 2^32, so top bit of wide delta is borrow */
+
+        uint64_t cleared = (uint64_t)0 - ((wide >> 63) & (diff >> 31));
+
+        diff = (diff & ~cleared) | (current[idx] & cleared);
+
+        delta[idx] = (diff & pending[idx] & valid[idx]) | (delta[idx] & ~pending[idx]);
+        last[idx] = (current[idx] & pending[idx]) | (last[idx] & ~pending[idx]);
+    }
+}
+
+static void otai_metadata_rate_compute_u64(
+        _In_ uint32_t count,
+        _In_ bool readandclear,
+        _In_ const uint64_t *__restrict pending,
+        _In_ const uint64_t *__restrict valid,
+        _In_ const uint64_t *__restrict current,
+        _Inout_ uint64_t *__restrict last,
+        _Inout_ uint64_t *__restrict delta)
+{
+    uint64_t mask = readandclear ? 0 : UINT64_MAX;
+
+    uint32_t idx = 0;
+
+    for (; idx < count; idx++)
+    {
+        /* 64 bit counter lower than previous sample was reset */
+
+        uint64_t prev = (current[idx] < last[idx]) ? 0 : last[idx] & mask;
+
+        delta[idx] = ((current[idx] - prev) & pending[idx] & valid[idx]) | (delta[idx] & ~pending[idx]);
+        last[idx] = (current[idx] & pending[idx]) | (last[idx] & ~pending[idx]);
+    }
+}
+
+static void otai_metadata_rate_compute_other(
+        _In_ otai_stat_value_type_t type,
+        _In_ uint32_t count,
+        _In_ bool readandclear,
+        _In_ const uint64_t *pending,
+        _In_ const uint64_t *valid,
+        _In_ const uint64_t *current,
+        _Inout_ uint64_t *last,
+        _Inout_ uint64_t *delta)
+{
+    uint32_t idx = 0;
+
+    for (; idx < count; idx++)
+    {
+        otai_stat_value_t cur;
+        otai_stat_value_t prev;
+        otai_stat_value_t diff;
+
+        cur.u64 = current[idx];
+        prev.u64 = last[idx];
+
+        if (type == OTAI_STAT_VALUE_TYPE_DOUBLE)
+        {
+            diff.d64 = (readandclear || cur.d64 < prev.d64) ? cur.d64 : cur.d64 - prev.d64;
+        }
+        else
+        {
+            diff.s64 = (readandclear || cur.s64 < prev.s64) ? cur.s64 : cur.s64 - prev.s64;
+        }
+
+        delta[idx] = (diff.u64 & pending[idx] & valid[idx]) | (delta[idx] & ~pending[idx]);
+        last[idx] = (cur.u64 & pending[idx]) | (prev.u64 & ~pending[idx]);
+    }
+}
+
+static void otai_metadata_rate_compute_rate(
+        _In_ otai_stat_value_type_t type,
+        _In_ uint32_t count,
+        _In_ const uint64_t *__restrict pending,
+        _In_ const double *__restrict scale,
+        _In_ const uint64_t *__restrict delta,
+        _Inout_ double *__restrict rate)
+{
+    /*
+     * Objects without new sample keep rate of last computation, rate bits
+     * are selected by object mask as in delta loops.
+     */
+
+    uint32_t idx = 0;
+
+    otai_stat_value_t diff;
+    otai_stat_value_t next;
+    otai_stat_value_t prev;
+
+    switch (type)
+    {
+        case OTAI_STAT_VALUE_TYPE_INT32:
+        case OTAI_STAT_VALUE_TYPE_INT64:
+
+            for (; idx < count; idx++)
+            {
+                diff.u64 = delta[idx];
+                prev.d64 = rate[idx];
+                next.d64 = (double)diff.s64 * scale[idx];
+                next.u64 = (next.u64 & pending[idx]) | (prev.u64 & ~pending[idx]);
+
+                rate[idx] = next.d64;
+            }
+
+            break;
+
+        case OTAI_STAT_VALUE_TYPE_DOUBLE:
+
+            for (; idx < count; idx++)
+            {
+                diff.u64 = delta[idx];
+                prev.d64 = rate[idx];
+                next.d64 = diff.d64 * scale[idx];
+                next.u64 = (next.u64 & pending[idx]) | (prev.u64 & ~pending[idx]);
+
+                rate[idx] = next.d64;
+            }
+
+            break;
+
+        default:
+
+            for (; idx < count; idx++)
+            {
+                prev.d64 = rate[idx];
+                next.d64 = (double)delta[idx] * scale[idx];
+                next.u64 = (next.u64 & pending[idx]) | (prev.u64 & ~pending[idx]);
+
+                rate[idx] = next.d64;
+            }
+
+            break;
+    }
+}
+
+void otai_metadata_rate_compute(
+        _Inout_ otai_metadata_rate_t *rate,
+        _In_ uint64_t now)
+{
+    bool readandclear = (rate->mode == OTAI_STATS_MODE_READ_AND_CLEAR);
+
+    uint32_t count = rate->objectcount;
+
+    uint32_t index = 0;
+
+    for (; index < count; index++)
+    {
+        uint64_t lasttime = rate->lasttime[index];
+
+        bool computed = (rate->pending[index] & rate->valid[index]) != 0 && now > lasttime;
+
+        rate->scale[index] = computed ? 1000.0 / (double)(now - lasttime) : 0;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < rate->statcount; idx++)
+    {
+        otai_stat_value_type_t type = rate->statvaluetypes[idx];
+
+        size_t base = (size_t)idx * rate->capacity;
+
+        switch (type)
+        {
+            case OTAI_STAT_VALUE_TYPE_UINT32:
+                otai_metadata_rate_compute_u32(count, readandclear, rate->pending, rate->valid,
+                        &rate->current[base], &rate->last[base], &rate->delta[base]);
+                break;
+
+            case OTAI_STAT_VALUE_TYPE_UINT64:
+                otai_metadata_rate_compute_u64(count, readandclear, rate->pending, rate->valid,
+                        &rate->current[base], &rate->last[base], &rate->delta[base]);
+                break;
+
+            default:
+                otai_metadata_rate_compute_other(type, count, readandclear, rate->pending, rate->valid,
+                        &rate->current[base], &rate->last[base], &rate->delta[base]);
+                break;
+        }
+
+        otai_metadata_rate_compute_rate(type, count, rate->pending, rate->scale, &rate->delta[base], &rate->rate[base]);
+    }
+
+    for (index = 0; index < count; index++)
+    {
+        uint64_t pending = rate->pending[index];
+
+        rate->valid[index] |= pending;
+        rate->lasttime[index] = (now & pending) | (rate->lasttime[index] & ~pending);
+        rate->pending[index] = 0;
+    }
+}
+
+otai_status_t otai_metadata_rate_reset(
+        _Inout_ otai_metadata_rate_t *rate,
+        _In_ otai_object_id_t object_id)
+{
+    uint32_t index;
+
+    if (!otai_metadata_objectmap_find(&rate->objectmap, object_id, &index))
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    /*
+     * Sample taken before clear is dropped too, next sample is only taken
+     * as previous sample.
+     */
+
+    rate->pending[index] = 0;
+    rate->valid[index] = 0;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_rate_clear_stats(
+        _Inout_ otai_metadata_rate_t *rate,
+        _In_ otai_object_id_t object_id)
+{
+    uint32_t index;
+
+    if (!otai_metadata_objectmap_find(&rate->objectmap, object_id, &index))
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    if (rate->info == NULL || rate->info->clearstats == NULL)
+    {
+        OTAI_META_LOG_ERROR("object type %d has no clear stats API", rate->objecttype);
+
+        return OTAI_STATUS_NOT_IMPLEMENTED;
+    }
+
+    otai_object_meta_key_t meta_key;
+
+    meta_key.objecttype = rate->objecttype;
+    meta_key.objectkey.key.object_id = object_id;
+
+    otai_status_t status = rate->info->clearstats(&meta_key, rate->statcount, rate->statids);
+
+    /* counters may be cleared partially, so previous sample is dropped anyway */
+
+    rate->pending[index] = 0;
+    rate->valid[index] = 0;
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        OTAI_META_LOG_ERROR("failed to clear stats of 0x%" PRIx64 ": %d", object_id, status);
+    }
+
+    return status;
+}
+
+otai_status_t otai_metadata_rate_get_value(
+        _In_ const otai_metadata_rate_t *rate,
+        _In_ otai_object_id_t object_id,
+        _In_ otai_stat_id_t stat_id,
+        _Out_ otai_metadata_rate_value_t *value)
+{
+    memset(value, 0, sizeof(otai_metadata_rate_value_t));
+
+    uint32_t index;
+
+    if (!otai_metadata_objectmap_find(&rate->objectmap, object_id, &index))
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    uint32_t idx = 0;
+
+    while (idx < rate->statcount && rate->statids[idx] != stat_id)
+    {
+        idx++;
+    }
+
+    if (idx == rate->statcount)
+    {
+        return OTAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    size_t pos = (size_t)idx * rate->capacity + index;
+
+    value->delta.u64 = rate->delta[pos];
+    value->rate = rate->rate[pos];
+
+    return OTAI_STATUS_SUCCESS;
+}
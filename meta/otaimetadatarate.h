@@ -0,0 +1,348 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatarate.h
+ *
+ * @brief   This module defines OTAI Metadata counter rate engine
+ */
+
+#ifndef __OTAIMETADATARATE_H_
+#define __OTAIMETADATARATE_H_
+
+#include "otaimetadatatypes.h"
+#include "otaimetadataobjectmap.h"
+
+/**
+ * @defgroup OTAIMETADATARATE OTAI - Metadata counter rate engine
+ *
+ * Rate engine keeps previous sample of each object and counter, and
+ * computes delta and per second rate of counters of objects of single
+ * object type. Only statistics marked as statvalueiscounter in statistics
+ * metadata are accepted.
+ *
+ * Samples are collected into arrays per counter, indexed by object, and
+ * otai_metadata_rate_compute() runs over each array in branch free loop,
+ * which compiler vectorizes.
+ *
+ * Delta of 32 bit counter is computed modulo 2^32, so counter wrap is
+ * handled, unless counter is lower than previous sample and delta is
+ * bigger than half of range, then counter was cleared outside of engine
+ * and is counted from zero. 64 bit counter lower than previous sample was
+ * reset, and is counted from zero. After counters are cleared by engine,
+ * next sample of object is only taken as new previous sample, so clear is
+ * not reported as spike.
+ *
+ * @{
+ */
+
+/**
+ * @brief Rate engine configuration.
+ */
+typedef struct _otai_metadata_rate_config_t
+{
+    /**
+     * @brief Object type of sampled objects.
+     */
+    otai_object_type_t                           objecttype;
+
+    /**
+     * @brief Number of sampled counters.
+     */
+    otai_uint32_t                                statcount;
+
+    /**
+     * @brief Sampled counters.
+     */
+    const otai_stat_id_t*                        statids;
+
+    /**
+     * @brief Maximum number of objects.
+     */
+    otai_uint32_t                                capacity;
+
+    /**
+     * @brief Statistics mode.
+     *
+     * With #OTAI_STATS_MODE_READ_AND_CLEAR counters are read as deltas.
+     */
+    otai_stats_mode_t                            mode;
+
+} otai_metadata_rate_config_t;
+
+/**
+ * @brief Rate engine.
+ */
+typedef struct _otai_metadata_rate_t
+{
+    /**
+     * @brief Object type of sampled objects.
+     */
+    otai_object_type_t                           objecttype;
+
+    /**
+     * @brief Statistics mode.
+     */
+    otai_stats_mode_t                            mode;
+
+    /**
+     * @brief Object type info, used to get and clear stats.
+     */
+    const otai_object_type_info_t*               info;
+
+    /**
+     * @brief Number of sampled counters.
+     */
+    otai_uint32_t                                statcount;
+
+    /**
+     * @brief Sampled counters.
+     */
+    otai_stat_id_t*                              statids;
+
+    /**
+     * @brief Value type of sampled counters.
+     */
+    otai_stat_value_type_t*                      statvaluetypes;
+
+    /**
+     * @brief Maximum number of objects.
+     */
+    otai_uint32_t                                capacity;
+
+    /**
+     * @brief Number of objects.
+     */
+    otai_uint32_t                                objectcount;
+
+    /**
+     * @brief Sampled objects.
+     */
+    otai_object_id_t*                            objects;
+
+    /**
+     * @brief Index of each sampled object.
+     */
+    otai_metadata_objectmap_t                    objectmap;
+
+    /**
+     * @brief All ones if object has new sample, indexed by object.
+     */
+    otai_uint64_t*                               pending;
+
+    /**
+     * @brief All ones if object has previous sample, indexed by object.
+     */
+    otai_uint64_t*                               valid;
+
+    /**
+     * @brief Time of previous sample, indexed by object.
+     */
+    otai_uint64_t*                               lasttime;
+
+    /**
+     * @brief Rate scale of last computation, indexed by object.
+     */
+    otai_double_t*                               scale;
+
+    /**
+     * @brief New sample, indexed by counter and object.
+     *
+     * Arrays of samples and deltas keep bits of s64, u64 or d64 member of
+     * widened value, so loops over them load single type.
+     */
+    otai_uint64_t*                               current;
+
+    /**
+     * @brief Previous sample, indexed by counter and object.
+     */
+    otai_uint64_t*                               last;
+
+    /**
+     * @brief Delta of last computation, indexed by counter and object.
+     */
+    otai_uint64_t*                               delta;
+
+    /**
+     * @brief Rate per second of last computation, indexed by counter and object.
+     */
+    otai_double_t*                               rate;
+
+    /**
+     * @brief Sample buffer.
+     */
+    otai_stat_value_t*                           values;
+
+} otai_metadata_rate_t;
+
+/**
+ * @brief Counter delta and rate of single object.
+ */
+typedef struct _otai_metadata_rate_value_t
+{
+    /**
+     * @brief Counter delta, of s64, u64 or d64 type.
+     *
+     * Signed counters use s64, unsigned u64 and double d64.
+     */
+    otai_stat_value_t                            delta;
+
+    /**
+     * @brief Counter rate per second.
+     */
+    otai_double_t                                rate;
+
+} otai_metadata_rate_value_t;
+
+/**
+ * @brief Initialize rate engine
+ *
+ * @param[out] rate Rate engine
+ * @param[in] config Configuration
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if configuration is invalid or statistic is not counter,
+ * #OTAI_STATUS_NO_MEMORY if arrays can't be allocated
+ */
+extern otai_status_t otai_metadata_rate_init(
+        _Out_ otai_metadata_rate_t *rate,
+        _In_ const otai_metadata_rate_config_t *config);
+
+/**
+ * @brief Release rate engine memory
+ *
+ * @param[inout] rate Rate engine
+ */
+extern void otai_metadata_rate_destroy(
+        _Inout_ otai_metadata_rate_t *rate);
+
+/**
+ * @brief Add sampled object
+ *
+ * @param[inout] rate Rate engine
+ * @param[in] object_id Object id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_ALREADY_EXISTS
+ * if object is already added, #OTAI_STATUS_TABLE_FULL if there is no room
+ */
+extern otai_status_t otai_metadata_rate_add_object(
+        _Inout_ otai_metadata_rate_t *rate,
+        _In_ otai_object_id_t object_id);
+
+/**
+ * @brief Remove sampled object
+ *
+ * Last object takes place of removed object.
+ *
+ * @param[inout] rate Rate engine
+ * @param[in] object_id Object id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object is not added
+ */
+extern otai_status_t otai_metadata_rate_remove_object(
+        _Inout_ otai_metadata_rate_t *rate,
+        _In_ otai_object_id_t object_id);
+
+/**
+ * @brief Set new sample of single object
+ *
+ * @param[inout] rate Rate engine
+ * @param[in] object_id Object id
+ * @param[in] counters Values of configured counters, in configured order
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object is not added
+ */
+extern otai_status_t otai_metadata_rate_update(
+        _Inout_ otai_metadata_rate_t *rate,
+        _In_ otai_object_id_t object_id,
+        _In_ const otai_stat_value_t *counters);
+
+/**
+ * @brief Sample all objects with get stats extended API
+ *
+ * Objects for which API fails have no new sample.
+ *
+ * @param[inout] rate Rate engine
+ *
+ * @return #OTAI_STATUS_SUCCESS if all objects were sampled, otherwise
+ * status of last failed object
+ */
+extern otai_status_t otai_metadata_rate_sample(
+        _Inout_ otai_metadata_rate_t *rate);
+
+/**
+ * @brief Compute deltas and rates of objects with new sample
+ *
+ * Objects without new sample keep delta and rate of last computation.
+ * Objects with first sample after add or clear get zero delta and rate.
+ *
+ * @param[inout] rate Rate engine
+ * @param[in] now Current time in milliseconds
+ */
+extern void otai_metadata_rate_compute(
+        _Inout_ otai_metadata_rate_t *rate,
+        _In_ uint64_t now);
+
+/**
+ * @brief Forget previous sample of object
+ *
+ * Must be called when counters of object were cleared other than by
+ * otai_metadata_rate_clear_stats().
+ *
+ * @param[inout] rate Rate engine
+ * @param[in] object_id Object id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object is not added
+ */
+extern otai_status_t otai_metadata_rate_reset(
+        _Inout_ otai_metadata_rate_t *rate,
+        _In_ otai_object_id_t object_id);
+
+/**
+ * @brief Clear configured counters of object with clear stats API
+ *
+ * @param[inout] rate Rate engine
+ * @param[in] object_id Object id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object is not added, failure status of clear stats API otherwise
+ */
+extern otai_status_t otai_metadata_rate_clear_stats(
+        _Inout_ otai_metadata_rate_t *rate,
+        _In_ otai_object_id_t object_id);
+
+/**
+ * @brief Get delta and rate of last computation
+ *
+ * @param[in] rate Rate engine
+ * @param[in] object_id Object id
+ * @param[in] stat_id Counter id
+ * @param[out] value Delta and rate
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * object or counter is not sampled
+ */
+extern otai_status_t otai_metadata_rate_get_value(
+        _In_ const otai_metadata_rate_t *rate,
+        _In_ otai_object_id_t object_id,
+        _In_ otai_stat_id_t stat_id,
+        _Out_ otai_metadata_rate_value_t *value);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATARATE_H_ */
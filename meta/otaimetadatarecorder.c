@@ -0,0 +1,1256 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatarecorder.c
+ *
+ * @brief   This module implements OTAI Metadata API call recorder and replayer
+ */
+
+/* clock_gettime and clock_nanosleep are not declared in strict ANSI mode */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include "otaimetadata.h"
+#include "otaimetadatalogger.h"
+#include "otaimetadataarena.h"
+#include "otaiserialize.h"
+#include "otaimetadatarecorder.h"
+
+#define OTAI_METADATA_RECORDER_DEFAULT_BUFFER_SIZE (1024 * 1024)
+
+#define OTAI_METADATA_RECORDER_HEADER_SIZE 8
+
+#define OTAI_METADATA_RECORDER_LENGTH_SIZE 4
+
+/* attribute lists start at multiple of this from record data */
+#define OTAI_METADATA_RECORDER_ALIGN 8
+
+#define OTAI_METADATA_RECORDER_ARENA_BLOCK_SIZE (64 * 1024)
+
+#define OTAI_METADATA_RECORDER_MAP_MIN_SIZE 256
+
+typedef struct _otai_metadata_recorder_t
+{
+    bool started;
+
+    otai_metadata_instrument_api_query_fn apiquery;
+
+    FILE *file;
+
+    uint8_t *buffer;
+
+    size_t size;
+
+    size_t used;
+
+    /* number of records in buffer, dropped if buffer can't be written */
+    uint64_t buffered;
+
+    /* start of previous record, records keep time difference */
+    uint64_t last;
+
+    uint64_t dropped;
+
+} otai_metadata_recorder_t;
+
+/*
+ * Recorded methods have no user context, so recorder is global, and single
+ * lock keeps order of records.
+ */
+static otai_metadata_recorder_t otai_metadata_recorder_global;
+
+static pthread_mutex_t otai_metadata_recorder_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct _otai_metadata_recorder_writer_t
+{
+    uint8_t *data;
+
+    size_t size;
+
+    size_t pos;
+
+    bool failed;
+
+} otai_metadata_recorder_writer_t;
+
+typedef struct _otai_metadata_recorder_reader_t
+{
+    uint8_t *data;
+
+    size_t size;
+
+    size_t pos;
+
+    bool failed;
+
+} otai_metadata_recorder_reader_t;
+
+/* maps recorded object id to object id created by replay */
+typedef struct _otai_metadata_recorder_map_t
+{
+    otai_object_id_t *keys;
+
+    otai_object_id_t *values;
+
+    size_t size;
+
+    size_t count;
+
+} otai_metadata_recorder_map_t;
+
+uint64_t otai_metadata_recorder_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static void otai_metadata_recorder_put_varint(
+        _Inout_ otai_metadata_recorder_writer_t *w,
+        _In_ uint64_t value)
+{
+    do
+    {
+        if (w->pos >= w->size)
+        {
+            w->failed = true;
+            return;
+        }
+
+        uint8_t byte = (uint8_t)(value & 0x7f);
+
+        value >>= 7;
+
+        w->data[w->pos++] = (uint8_t)(value ? (byte | 0x80) : byte);
+    }
+    while (value);
+}
+
+static void otai_metadata_recorder_put_zigzag(
+        _Inout_ otai_metadata_recorder_writer_t *w,
+        _In_ int64_t value)
+{
+    otai_metadata_recorder_put_varint(w, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static void otai_metadata_recorder_put_attr_list(
+        _Inout_ otai_metadata_recorder_writer_t *w,
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    otai_metadata_recorder_put_varint(w, attr_count);
+
+    while (!w->failed && w->pos % OTAI_METADATA_RECORDER_ALIGN)
+    {
+        otai_metadata_recorder_put_varint(w, 0);
+    }
+
+    if (w->failed)
+    {
+        return;
+    }
+
+    int len = otai_serialize_attribute_list_binary(w->data + w->pos, w->size - w->pos, object_type, attr_count, attr_list);
+
+    if (len == OTAI_SERIALIZE_ERROR)
+    {
+        w->failed = true;
+        return;
+    }
+
+    w->pos += (size_t)len;
+}
+
+static bool otai_metadata_recorder_is_create(
+        _In_ otai_metadata_instrument_op_t op)
+{
+    return op == OTAI_METADATA_INSTRUMENT_OP_CREATE || op == OTAI_METADATA_INSTRUMENT_OP_BULK_CREATE;
+}
+
+static bool otai_metadata_recorder_is_set(
+        _In_ otai_metadata_instrument_op_t op)
+{
+    return op == OTAI_METADATA_INSTRUMENT_OP_SET || op == OTAI_METADATA_INSTRUMENT_OP_BULK_SET;
+}
+
+static bool otai_metadata_recorder_is_get(
+        _In_ otai_metadata_instrument_op_t op)
+{
+    return op == OTAI_METADATA_INSTRUMENT_OP_GET || op == OTAI_METADATA_INSTRUMENT_OP_BULK_GET;
+}
+
+static void otai_metadata_recorder_encode(
+        _Inout_ otai_metadata_recorder_writer_t *w,
+        _In_ const otai_metadata_recorder_call_t *call,
+        _In_ int64_t delta,
+        _In_ uint64_t duration)
+{
+    uint32_t idx;
+
+    otai_metadata_recorder_put_varint(w, (uint64_t)call->op);
+    otai_metadata_recorder_put_varint(w, (uint64_t)call->api);
+    otai_metadata_recorder_put_varint(w, (uint64_t)call->objecttype);
+    otai_metadata_recorder_put_zigzag(w, delta);
+    otai_metadata_recorder_put_varint(w, duration);
+    otai_metadata_recorder_put_zigzag(w, call->status);
+    otai_metadata_recorder_put_varint(w, call->linecardid);
+    otai_metadata_recorder_put_varint(w, (uint64_t)call->statsmode);
+    otai_metadata_recorder_put_varint(w, (uint64_t)call->errormode);
+
+    uint32_t counter_count = (call->counterids == NULL) ? 0 : call->countercount;
+
+    otai_metadata_recorder_put_varint(w, counter_count);
+
+    for (idx = 0; idx < counter_count; idx++)
+    {
+        otai_metadata_recorder_put_varint(w, call->counterids[idx]);
+    }
+
+    uint32_t object_count = (call->objectids == NULL) ? 0 : call->objectcount;
+
+    otai_metadata_recorder_put_varint(w, object_count);
+
+    for (idx = 0; idx < object_count && !w->failed; idx++)
+    {
+        otai_status_t status = (call->objectstatuses == NULL) ? call->status : call->objectstatuses[idx];
+
+        /* object id of failed create is not set */
+
+        bool created = !otai_metadata_recorder_is_create(call->op) || status == OTAI_STATUS_SUCCESS;
+
+        otai_metadata_recorder_put_varint(w, created ? call->objectids[idx] : OTAI_NULL_OBJECT_ID);
+        otai_metadata_recorder_put_zigzag(w, status);
+
+        uint32_t attr_count = 0;
+
+        const otai_attribute_t *attr_list = NULL;
+
+        if (call->attrcounts != NULL && call->attrlists != NULL)
+        {
+            attr_count = call->attrcounts[idx];
+            attr_list = call->attrlists[idx];
+        }
+
+        if (otai_metadata_recorder_is_create(call->op))
+        {
+            otai_metadata_recorder_put_attr_list(w, call->objecttype, attr_count, attr_list);
+        }
+        else if (otai_metadata_recorder_is_set(call->op))
+        {
+            attr_list = (call->attrs == NULL) ? NULL : &call->attrs[idx];
+
+            otai_metadata_recorder_put_attr_list(w, call->objecttype, attr_list ? 1 : 0, attr_list);
+        }
+        else if (otai_metadata_recorder_is_get(call->op))
+        {
+            uint32_t attr_idx;
+
+            attr_count = (attr_list == NULL) ? 0 : attr_count;
+
+            otai_metadata_recorder_put_varint(w, attr_count);
+
+            for (attr_idx = 0; attr_idx < attr_count; attr_idx++)
+            {
+                otai_metadata_recorder_put_varint(w, attr_list[attr_idx].id);
+            }
+        }
+    }
+}
+
+static bool otai_metadata_recorder_write_buffer(
+        _Inout_ otai_metadata_recorder_t *recorder)
+{
+    bool success = fwrite(recorder->buffer, 1, recorder->used, recorder->file) == recorder->used;
+
+    if (!success)
+    {
+        OTAI_META_LOG_ERROR("failed to write %zu bytes to recorder file", recorder->used);
+
+        recorder->dropped += recorder->buffered;
+    }
+
+    recorder->used = 0;
+    recorder->buffered = 0;
+
+    return success;
+}
+
+static bool otai_metadata_recorder_append(
+        _Inout_ otai_metadata_recorder_t *recorder,
+        _In_ const otai_metadata_recorder_call_t *call,
+        _In_ uint64_t duration)
+{
+    otai_metadata_recorder_writer_t w;
+
+    if (recorder->size - recorder->used <= OTAI_METADATA_RECORDER_LENGTH_SIZE)
+    {
+        return false;
+    }
+
+    w.data = recorder->buffer + recorder->used + OTAI_METADATA_RECORDER_LENGTH_SIZE;
+    w.size = recorder->size - recorder->used - OTAI_METADATA_RECORDER_LENGTH_SIZE;
+    w.pos = 0;
+    w.failed = false;
+
+    otai_metadata_recorder_encode(&w, call, (int64_t)(call->start - recorder->last), duration);
+
+    if (w.failed)
+    {
+        return false;
+    }
+
+    uint8_t *length = recorder->buffer + recorder->used;
+
+    length[0] = (uint8_t)w.pos;
+    length[1] = (uint8_t)(w.pos >> 8);
+    length[2] = (uint8_t)(w.pos >> 16);
+    length[3] = (uint8_t)(w.pos >> 24);
+
+    recorder->used += OTAI_METADATA_RECORDER_LENGTH_SIZE + w.pos;
+    recorder->buffered++;
+    recorder->last = call->start;
+
+    return true;
+}
+
+otai_status_t otai_metadata_recorder_start(
+        _In_ const otai_metadata_recorder_config_t *config)
+{
+    otai_metadata_recorder_t *recorder = &otai_metadata_recorder_global;
+
+    if (config == NULL || config->apiquery == NULL || config->filename == NULL)
+    {
+        OTAI_META_LOG_ERROR("api query or file name is NULL");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    size_t size = config->buffersize ? config->buffersize : OTAI_METADATA_RECORDER_DEFAULT_BUFFER_SIZE;
+
+    if (size < OTAI_METADATA_RECORDER_HEADER_SIZE)
+    {
+        OTAI_META_LOG_ERROR("buffer size %zu is too small", size);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_lock(&otai_metadata_recorder_mutex);
+
+    if (recorder->started)
+    {
+        pthread_mutex_unlock(&otai_metadata_recorder_mutex);
+
+        OTAI_META_LOG_ERROR("recorder is already started");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint8_t *buffer = (uint8_t*)malloc(size);
+
+    if (buffer == NULL)
+    {
+        pthread_mutex_unlock(&otai_metadata_recorder_mutex);
+
+        OTAI_META_LOG_ERROR("failed to allocate recorder buffer of %zu bytes", size);
+
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    FILE *file = fopen(config->filename, "wb");
+
+    if (file == NULL)
+    {
+        pthread_mutex_unlock(&otai_metadata_recorder_mutex);
+
+        free(buffer);
+
+        OTAI_META_LOG_ERROR("failed to create recorder file %s", config->filename);
+
+        return OTAI_STATUS_FAILURE;
+    }
+
+    memcpy(buffer, OTAI_METADATA_RECORDER_MAGIC, OTAI_METADATA_RECORDER_HEADER_SIZE - 1);
+
+    buffer[OTAI_METADATA_RECORDER_HEADER_SIZE - 1] = OTAI_METADATA_RECORDER_VERSION;
+
+    recorder->apiquery = config->apiquery;
+    recorder->file = file;
+    recorder->buffer = buffer;
+    recorder->size = size;
+    recorder->used = OTAI_METADATA_RECORDER_HEADER_SIZE;
+    recorder->buffered = 0;
+    recorder->last = 0;
+    recorder->dropped = 0;
+
+    __atomic_store_n(&recorder->started, true, __ATOMIC_RELEASE);
+
+    pthread_mutex_unlock(&otai_metadata_recorder_mutex);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_recorder_stop(void)
+{
+    otai_metadata_recorder_t *recorder = &otai_metadata_recorder_global;
+
+    pthread_mutex_lock(&otai_metadata_recorder_mutex);
+
+    if (!recorder->started)
+    {
+        pthread_mutex_unlock(&otai_metadata_recorder_mutex);
+
+        OTAI_META_LOG_ERROR("recorder is not started");
+
+        return OTAI_STATUS_UNINITIALIZED;
+    }
+
+    __atomic_store_n(&recorder->started, false, __ATOMIC_RELEASE);
+
+    bool success = otai_metadata_recorder_write_buffer(recorder);
+
+    if (fclose(recorder->file) != 0)
+    {
+        OTAI_META_LOG_ERROR("failed to close recorder file");
+
+        success = false;
+    }
+
+    free(recorder->buffer);
+
+    recorder->file = NULL;
+    recorder->buffer = NULL;
+
+    pthread_mutex_unlock(&otai_metadata_recorder_mutex);
+
+    return success ? OTAI_STATUS_SUCCESS : OTAI_STATUS_FAILURE;
+}
+
+otai_status_t otai_metadata_recorder_api_query(
+        _In_ otai_api_t api,
+        _Out_ void **api_method_table)
+{
+    otai_metadata_recorder_t *recorder = &otai_metadata_recorder_global;
+
+    if (!__atomic_load_n(&recorder->started, __ATOMIC_ACQUIRE))
+    {
+        OTAI_META_LOG_ERROR("recorder is not started");
+
+        return OTAI_STATUS_UNINITIALIZED;
+    }
+
+    void *native = NULL;
+
+    otai_status_t status = recorder->apiquery(api, &native);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        *api_method_table = native;
+
+        return status;
+    }
+
+    /* wrapper tables are generated from api structs */
+
+    return otai_metadata_recorder_wrap_api(api, native, api_method_table);
+}
+
+void otai_metadata_recorder_record(
+        _In_ const otai_metadata_recorder_call_t *call)
+{
+    otai_metadata_recorder_t *recorder = &otai_metadata_recorder_global;
+
+    if (!__atomic_load_n(&recorder->started, __ATOMIC_ACQUIRE))
+    {
+        return;
+    }
+
+    uint64_t duration = otai_metadata_recorder_now() - call->start;
+
+    pthread_mutex_lock(&otai_metadata_recorder_mutex);
+
+    if (!recorder->started)
+    {
+        pthread_mutex_unlock(&otai_metadata_recorder_mutex);
+        return;
+    }
+
+    /*
+     * Buffer is written when quarter of it is left, so encoder rarely runs
+     * out of space, and record is encoded again into empty buffer if it
+     * does.
+     */
+
+    if (recorder->size - recorder->used < recorder->size / 4)
+    {
+        otai_metadata_recorder_write_buffer(recorder);
+    }
+
+    if (!otai_metadata_recorder_append(recorder, call, duration))
+    {
+        if (recorder->used == 0 || !otai_metadata_recorder_write_buffer(recorder) ||
+                !otai_metadata_recorder_append(recorder, call, duration))
+        {
+            recorder->dropped++;
+        }
+    }
+
+    pthread_mutex_unlock(&otai_metadata_recorder_mutex);
+}
+
+otai_status_t otai_metadata_recorder_flush(void)
+{
+    otai_metadata_recorder_t *recorder = &otai_metadata_recorder_global;
+
+    pthread_mutex_lock(&otai_metadata_recorder_mutex);
+
+    if (!recorder->started)
+    {
+        pthread_mutex_unlock(&otai_metadata_recorder_mutex);
+
+        OTAI_META_LOG_ERROR("recorder is not started");
+
+        return OTAI_STATUS_UNINITIALIZED;
+    }
+
+    bool success = otai_metadata_recorder_write_buffer(recorder) && fflush(recorder->file) == 0;
+
+    pthread_mutex_unlock(&otai_metadata_recorder_mutex);
+
+    return success ? OTAI_STATUS_SUCCESS : OTAI_STATUS_FAILURE;
+}
+
+uint64_t otai_metadata_recorder_get_dropped(void)
+{
+    pthread_mutex_lock(&otai_metadata_recorder_mutex);
+
+    uint64_t dropped = otai_metadata_recorder_global.dropped;
+
+    pthread_mutex_unlock(&otai_metadata_recorder_mutex);
+
+    return dropped;
+}
+
+static uint64_t otai_metadata_recorder_get_varint(
+        _Inout_ otai_metadata_recorder_reader_t *r)
+{
+    uint64_t value = 0;
+
+    unsigned int shift = 0;
+
+    for (; shift < 64; shift += 7)
+    {
+        if (r->pos >= r->size)
+        {
+            break;
+        }
+
+        uint8_t byte = r->data[r->pos++];
+
+        value |= (uint64_t)(byte & 0x7f) << shift;
+
+        if ((byte & 0x80) == 0)
+        {
+            return value;
+        }
+    }
+
+    r->failed = true;
+
+    return 0;
+}
+
+static int64_t otai_metadata_recorder_get_zigzag(
+        _Inout_ otai_metadata_recorder_reader_t *r)
+{
+    uint64_t value = otai_metadata_recorder_get_varint(r);
+
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static otai_object_id_t* otai_metadata_recorder_map_find(
+        _In_ const otai_metadata_recorder_map_t *map,
+        _In_ otai_object_id_t key)
+{
+    size_t mask = map->size - 1;
+
+    size_t idx = (size_t)((key * UINT64_C(0x9e3779b97f4a7c15)) >> 32) & mask;
+
+    while (map->keys[idx] != key && map->keys[idx] != OTAI_NULL_OBJECT_ID)
+    {
+        idx = (idx + 1) & mask;
+    }
+
+    return &map->keys[idx];
+}
+
+static otai_object_id_t otai_metadata_recorder_map_get(
+        _In_ const otai_metadata_recorder_map_t *map,
+        _In_ otai_object_id_t key)
+{
+    if (key == OTAI_NULL_OBJECT_ID || map->size == 0)
+    {
+        return key;
+    }
+
+    otai_object_id_t *slot = otai_metadata_recorder_map_find(map, key);
+
+    /* object not created by replay, like linecard child objects, keeps its id */
+
+    return (*slot == key) ? map->values[slot - map->keys] : key;
+}
+
+static bool otai_metadata_recorder_map_put(
+        _Inout_ otai_metadata_recorder_map_t *map,
+        _In_ otai_object_id_t key,
+        _In_ otai_object_id_t value)
+{
+    if (key == OTAI_NULL_OBJECT_ID)
+    {
+        return true;
+    }
+
+    if ((map->count + 1) * 2 > map->size)
+    {
+        otai_metadata_recorder_map_t grown;
+
+        size_t idx;
+
+        grown.size = map->size ? map->size * 2 : OTAI_METADATA_RECORDER_MAP_MIN_SIZE;
+        grown.count = map->count;
+        grown.keys = (otai_object_id_t*)calloc(grown.size, sizeof(otai_object_id_t));
+        grown.values = (otai_object_id_t*)calloc(grown.size, sizeof(otai_object_id_t));
+
+        if (grown.keys == NULL || grown.values == NULL)
+        {
+            free(grown.keys);
+            free(grown.values);
+
+            return false;
+        }
+
+        for (idx = 0; idx < map->size; idx++)
+        {
+            if (map->keys[idx] != OTAI_NULL_OBJECT_ID)
+            {
+                otai_object_id_t *slot = otai_metadata_recorder_map_find(&grown, map->keys[idx]);
+
+                *slot = map->keys[idx];
+
+                grown.values[slot - grown.keys] = map->values[idx];
+            }
+        }
+
+        free(map->keys);
+        free(map->values);
+
+        *map = grown;
+    }
+
+    otai_object_id_t *slot = otai_metadata_recorder_map_find(map, key);
+
+    if (*slot == OTAI_NULL_OBJECT_ID)
+    {
+        *slot = key;
+
+        map->count++;
+    }
+
+    map->values[slot - map->keys] = value;
+
+    return true;
+}
+
+static void otai_metadata_recorder_remap_attr_list(
+        _In_ const otai_metadata_recorder_map_t *map,
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t attr_count,
+        _Inout_ otai_attribute_t *attr_list)
+{
+    uint32_t idx;
+
+    for (idx = 0; idx < attr_count; idx++)
+    {
+        const otai_attr_metadata_t *meta = otai_metadata_get_attr_metadata(object_type, attr_list[idx].id);
+
+        if (meta == NULL)
+        {
+            continue;
+        }
+
+        if (meta->attrvaluetype == OTAI_ATTR_VALUE_TYPE_OBJECT_ID)
+        {
+            attr_list[idx].value.oid = otai_metadata_recorder_map_get(map, attr_list[idx].value.oid);
+        }
+        else if (meta->attrvaluetype == OTAI_ATTR_VALUE_TYPE_OBJECT_LIST)
+        {
+            otai_object_list_t *objlist = &attr_list[idx].value.objlist;
+
+            uint32_t oid_idx;
+
+            for (oid_idx = 0; objlist->list != NULL && oid_idx < objlist->count; oid_idx++)
+            {
+                objlist->list[oid_idx] = otai_metadata_recorder_map_get(map, objlist->list[oid_idx]);
+            }
+        }
+    }
+}
+
+/*
+ * Recorded pointer values are addresses of recording process, so they are
+ * replaced by configured ones, and attributes without one are removed.
+ * NULL pointer, which disables notification, is kept.
+ */
+static void otai_metadata_recorder_replace_pointers(
+        _In_ const otai_metadata_recorder_replay_config_t *config,
+        _In_ otai_object_type_t object_type,
+        _Inout_ uint32_t *attr_count,
+        _Inout_ otai_attribute_t *attr_list)
+{
+    uint32_t idx;
+    uint32_t kept = 0;
+
+    for (idx = 0; idx < *attr_count; idx++)
+    {
+        const otai_attr_metadata_t *meta = otai_metadata_get_attr_metadata(object_type, attr_list[idx].id);
+
+        if (meta != NULL && meta->attrvaluetype == OTAI_ATTR_VALUE_TYPE_POINTER && attr_list[idx].value.ptr != NULL)
+        {
+            attr_list[idx].value.ptr = (config->pointer == NULL) ? NULL : config->pointer(object_type, attr_list[idx].id);
+
+            if (attr_list[idx].value.ptr == NULL)
+            {
+                continue;
+            }
+        }
+
+        attr_list[kept++] = attr_list[idx];
+    }
+
+    *attr_count = kept;
+}
+
+static otai_attribute_t* otai_metadata_recorder_get_attr_list(
+        _Inout_ otai_metadata_recorder_reader_t *r,
+        _Inout_ otai_metadata_arena_t *arena,
+        _In_ otai_object_type_t object_type,
+        _Out_ uint32_t *attr_count)
+{
+    uint64_t count = otai_metadata_recorder_get_varint(r);
+
+    r->pos += (OTAI_METADATA_RECORDER_ALIGN - r->pos % OTAI_METADATA_RECORDER_ALIGN) % OTAI_METADATA_RECORDER_ALIGN;
+
+    /* each attribute takes at least one byte of record */
+
+    if (r->failed || r->pos > r->size || count > r->size - r->pos || count > UINT32_MAX / sizeof(otai_attribute_t))
+    {
+        r->failed = true;
+        return NULL;
+    }
+
+    otai_attribute_t *attr_list = (otai_attribute_t*)otai_metadata_arena_alloc(arena, (count ? count : 1) * sizeof(otai_attribute_t));
+
+    *attr_count = (uint32_t)count;
+
+    if (attr_list == NULL)
+    {
+        r->failed = true;
+        return NULL;
+    }
+
+    /* list values point into record */
+
+    int len = otai_deserialize_attribute_list_binary(r->data + r->pos, r->size - r->pos, object_type, true, attr_count, attr_list);
+
+    if (len == OTAI_SERIALIZE_ERROR)
+    {
+        r->failed = true;
+        return NULL;
+    }
+
+    r->pos += (size_t)len;
+
+    return attr_list;
+}
+
+static otai_attribute_t* otai_metadata_recorder_get_attr_ids(
+        _Inout_ otai_metadata_recorder_reader_t *r,
+        _Inout_ otai_metadata_arena_t *arena,
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t list_size,
+        _Out_ uint32_t *attr_count)
+{
+    uint64_t count = otai_metadata_recorder_get_varint(r);
+
+    uint32_t idx;
+
+    if (r->failed || count > r->size - r->pos)
+    {
+        r->failed = true;
+        return NULL;
+    }
+
+    otai_attribute_t *attr_list = (otai_attribute_t*)otai_metadata_arena_alloc(arena, (count ? count : 1) * sizeof(otai_attribute_t));
+
+    if (attr_list == NULL)
+    {
+        r->failed = true;
+        return NULL;
+    }
+
+    otai_alloc_info_t info;
+
+    info.list_size = list_size;
+    info.reference = NULL;
+    info.arena = arena;
+
+    for (idx = 0; idx < count; idx++)
+    {
+        memset(&attr_list[idx], 0, sizeof(otai_attribute_t));
+
+        attr_list[idx].id = (otai_attr_id_t)otai_metadata_recorder_get_varint(r);
+
+        const otai_attr_metadata_t *meta = otai_metadata_get_attr_metadata(object_type, attr_list[idx].id);
+
+        if (meta == NULL || otai_metadata_alloc_attr_value(meta, &attr_list[idx], &info) != OTAI_STATUS_SUCCESS)
+        {
+            r->failed = true;
+            return NULL;
+        }
+    }
+
+    *attr_count = (uint32_t)count;
+
+    return attr_list;
+}
+
+typedef struct _otai_metadata_recorder_replay_t
+{
+    const otai_metadata_recorder_replay_config_t *config;
+
+    otai_metadata_recorder_replay_stats_t *stats;
+
+    otai_metadata_arena_t arena;
+
+    otai_metadata_recorder_map_t map;
+
+} otai_metadata_recorder_replay_t;
+
+static void* otai_metadata_recorder_replay_alloc(
+        _Inout_ otai_metadata_recorder_replay_t *replay,
+        _In_ size_t count,
+        _In_ size_t size)
+{
+    void *ptr = otai_metadata_arena_alloc(&replay->arena, (count ? count : 1) * size);
+
+    if (ptr != NULL)
+    {
+        memset(ptr, 0, (count ? count : 1) * size);
+    }
+
+    return ptr;
+}
+
+/*
+ * Decodes record and issues it. Returns false if record can't be replayed.
+ */
+static bool otai_metadata_recorder_replay_record(
+        _Inout_ otai_metadata_recorder_replay_t *replay,
+        _Inout_ otai_metadata_recorder_reader_t *r,
+        _Inout_ uint64_t *recorded)
+{
+    uint64_t op = otai_metadata_recorder_get_varint(r);
+    uint64_t api = otai_metadata_recorder_get_varint(r);
+    uint64_t ot = otai_metadata_recorder_get_varint(r);
+
+    *recorded += (uint64_t)otai_metadata_recorder_get_zigzag(r);
+
+    otai_metadata_recorder_get_varint(r); /* recorded duration */
+
+    otai_status_t recorded_status = (otai_status_t)otai_metadata_recorder_get_zigzag(r);
+
+    otai_object_id_t linecard_id = otai_metadata_recorder_map_get(&replay->map, otai_metadata_recorder_get_varint(r));
+
+    otai_stats_mode_t stats_mode = (otai_stats_mode_t)otai_metadata_recorder_get_varint(r);
+
+    otai_bulk_op_error_mode_t error_mode = (otai_bulk_op_error_mode_t)otai_metadata_recorder_get_varint(r);
+
+    uint64_t counter_count = otai_metadata_recorder_get_varint(r);
+
+    uint32_t idx;
+
+    if (r->failed || op >= OTAI_METADATA_INSTRUMENT_OP_MAX || api >= OTAI_API_MAX || counter_count > r->size - r->pos)
+    {
+        return false;
+    }
+
+    const otai_object_type_info_t *info = otai_metadata_get_object_type_info((otai_object_type_t)ot);
+
+    if (info == NULL)
+    {
+        return false;
+    }
+
+    otai_stat_id_t *counter_ids = (otai_stat_id_t*)otai_metadata_recorder_replay_alloc(replay, (size_t)counter_count, sizeof(otai_stat_id_t));
+
+    for (idx = 0; counter_ids != NULL && idx < counter_count; idx++)
+    {
+        counter_ids[idx] = (otai_stat_id_t)otai_metadata_recorder_get_varint(r);
+    }
+
+    uint64_t object_count = otai_metadata_recorder_get_varint(r);
+
+    if (r->failed || counter_ids == NULL || object_count == 0 || object_count > r->size - r->pos)
+    {
+        return false;
+    }
+
+    size_t count = (size_t)object_count;
+
+    otai_object_meta_key_t *meta_keys = (otai_object_meta_key_t*)otai_metadata_recorder_replay_alloc(replay, count, sizeof(otai_object_meta_key_t));
+    otai_object_id_t *recorded_ids = (otai_object_id_t*)otai_metadata_recorder_replay_alloc(replay, count, sizeof(otai_object_id_t));
+    otai_status_t *object_statuses = (otai_status_t*)otai_metadata_recorder_replay_alloc(replay, count, sizeof(otai_status_t));
+    uint32_t *attr_counts = (uint32_t*)otai_metadata_recorder_replay_alloc(replay, count, sizeof(uint32_t));
+    otai_attribute_t **attr_lists = (otai_attribute_t**)otai_metadata_recorder_replay_alloc(replay, count, sizeof(otai_attribute_t*));
+    const otai_attribute_t **create_lists = (const otai_attribute_t**)otai_metadata_recorder_replay_alloc(replay, count, sizeof(otai_attribute_t*));
+    otai_attribute_t *attrs = (otai_attribute_t*)otai_metadata_recorder_replay_alloc(replay, count, sizeof(otai_attribute_t));
+    otai_stat_value_t *counters = (otai_stat_value_t*)otai_metadata_recorder_replay_alloc(replay, count * (size_t)counter_count, sizeof(otai_stat_value_t));
+
+    if (meta_keys == NULL || recorded_ids == NULL || object_statuses == NULL || attr_counts == NULL ||
+            attr_lists == NULL || create_lists == NULL || attrs == NULL || counters == NULL)
+    {
+        return false;
+    }
+
+    for (idx = 0; idx < count && !r->failed; idx++)
+    {
+        recorded_ids[idx] = otai_metadata_recorder_get_varint(r);
+
+        otai_metadata_recorder_get_zigzag(r); /* recorded object status */
+
+        meta_keys[idx].objecttype = (otai_object_type_t)ot;
+        meta_keys[idx].objectkey.key.object_id = otai_metadata_recorder_map_get(&replay->map, recorded_ids[idx]);
+
+        if (otai_metadata_recorder_is_create((otai_metadata_instrument_op_t)op) || otai_metadata_recorder_is_set((otai_metadata_instrument_op_t)op))
+        {
+            attr_lists[idx] = otai_metadata_recorder_get_attr_list(r, &replay->arena, (otai_object_type_t)ot, &attr_counts[idx]);
+
+            if (attr_lists[idx] != NULL)
+            {
+                otai_metadata_recorder_remap_attr_list(&replay->map, (otai_object_type_t)ot, attr_counts[idx], attr_lists[idx]);
+                otai_metadata_recorder_replace_pointers(replay->config, (otai_object_type_t)ot, &attr_counts[idx], attr_lists[idx]);
+            }
+
+            create_lists[idx] = attr_lists[idx];
+
+            if (otai_metadata_recorder_is_set((otai_metadata_instrument_op_t)op))
+            {
+                if (attr_counts[idx] != 1 || attr_lists[idx] == NULL)
+                {
+                    return false;
+                }
+
+                attrs[idx] = attr_lists[idx][0];
+            }
+        }
+        else if (otai_metadata_recorder_is_get((otai_metadata_instrument_op_t)op))
+        {
+            attr_lists[idx] = otai_metadata_recorder_get_attr_ids(r, &replay->arena, (otai_object_type_t)ot, replay->config->listsize, &attr_counts[idx]);
+        }
+    }
+
+    if (r->failed)
+    {
+        return false;
+    }
+
+    uint32_t n = (uint32_t)counter_count;
+
+    uint64_t start = otai_metadata_recorder_now();
+
+    otai_status_t status;
+
+    switch (op)
+    {
+        case OTAI_METADATA_INSTRUMENT_OP_CREATE:
+            status = info->create(&meta_keys[0], linecard_id, attr_counts[0], attr_lists[0]);
+            object_statuses[0] = status;
+            break;
+
+        case OTAI_METADATA_INSTRUMENT_OP_REMOVE:
+            status = info->remove(&meta_keys[0]);
+            break;
+
+        case OTAI_METADATA_INSTRUMENT_OP_SET:
+            status = info->set(&meta_keys[0], &attrs[0]);
+            break;
+
+        case OTAI_METADATA_INSTRUMENT_OP_GET:
+            status = info->get(&meta_keys[0], attr_counts[0], attr_lists[0]);
+            break;
+
+        case OTAI_METADATA_INSTRUMENT_OP_BULK_CREATE:
+            status = info->bulkcreate(linecard_id, (uint32_t)count, meta_keys, attr_counts, create_lists, error_mode, object_statuses);
+            break;
+
+        case OTAI_METADATA_INSTRUMENT_OP_BULK_REMOVE:
+            status = info->bulkremove((uint32_t)count, meta_keys, error_mode, object_statuses);
+            break;
+
+        case OTAI_METADATA_INSTRUMENT_OP_BULK_SET:
+            status = info->bulkset((uint32_t)count, meta_keys, attrs, error_mode, object_statuses);
+            break;
+
+        case OTAI_METADATA_INSTRUMENT_OP_BULK_GET:
+            status = info->bulkget((uint32_t)count, meta_keys, attr_counts, attr_lists, error_mode, object_statuses);
+            break;
+
+        case OTAI_METADATA_INSTRUMENT_OP_GET_STATS:
+            status = info->getstats(&meta_keys[0], n, counter_ids, counters);
+            break;
+
+        case OTAI_METADATA_INSTRUMENT_OP_GET_STATS_EXT:
+            status = info->getstatsext(&meta_keys[0], n, counter_ids, stats_mode, counters);
+            break;
+
+        case OTAI_METADATA_INSTRUMENT_OP_CLEAR_STATS:
+            status = info->clearstats(&meta_keys[0], n, counter_ids);
+            break;
+
+        default:
+            status = info->bulkgetstats((uint32_t)count, meta_keys, n, counter_ids, stats_mode, object_statuses, counters);
+            break;
+    }
+
+    replay->stats->busy += otai_metadata_recorder_now() - start;
+    replay->stats->calls++;
+
+    if (status != recorded_status)
+    {
+        replay->stats->mismatches++;
+    }
+
+    if (otai_metadata_recorder_is_create((otai_metadata_instrument_op_t)op))
+    {
+        for (idx = 0; idx < count; idx++)
+        {
+            if (object_statuses[idx] == OTAI_STATUS_SUCCESS &&
+                    !otai_metadata_recorder_map_put(&replay->map, recorded_ids[idx], meta_keys[idx].objectkey.key.object_id))
+            {
+                OTAI_META_LOG_ERROR("failed to allocate object id map");
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool otai_metadata_recorder_read_header(
+        _In_ FILE *file)
+{
+    uint8_t header[OTAI_METADATA_RECORDER_HEADER_SIZE];
+
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+            memcmp(header, OTAI_METADATA_RECORDER_MAGIC, OTAI_METADATA_RECORDER_HEADER_SIZE - 1) != 0)
+    {
+        OTAI_META_LOG_ERROR("file is not recorder file");
+
+        return false;
+    }
+
+    if (header[OTAI_METADATA_RECORDER_HEADER_SIZE - 1] > OTAI_METADATA_RECORDER_VERSION)
+    {
+        OTAI_META_LOG_ERROR("recorder file version %u is not supported", header[OTAI_METADATA_RECORDER_HEADER_SIZE - 1]);
+
+        return false;
+    }
+
+    return true;
+}
+
+static void otai_metadata_recorder_wait(
+        _In_ uint64_t target)
+{
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(target / 1000000000);
+    ts.tv_nsec = (long)(target % 1000000000);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0)
+    {
+        /* interrupted by signal */
+    }
+}
+
+otai_status_t otai_metadata_recorder_replay(
+        _In_ const char *filename,
+        _In_ const otai_metadata_recorder_replay_config_t *config,
+        _Out_ otai_metadata_recorder_replay_stats_t *stats)
+{
+    otai_metadata_recorder_replay_t replay;
+
+    otai_apis_t apis;
+
+    if (filename == NULL || config == NULL || stats == NULL || config->apiquery == NULL || !(config->speed >= 0))
+    {
+        OTAI_META_LOG_ERROR("file name, configuration or stats is NULL, or speed is negative");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    memset(stats, 0, sizeof(otai_metadata_recorder_replay_stats_t));
+
+    FILE *file = fopen(filename, "rb");
+
+    if (file == NULL)
+    {
+        OTAI_META_LOG_ERROR("failed to open recorder file %s", filename);
+
+        return OTAI_STATUS_FAILURE;
+    }
+
+    if (!otai_metadata_recorder_read_header(file))
+    {
+        fclose(file);
+
+        return OTAI_STATUS_FAILURE;
+    }
+
+    /* generic methods call adapter through global method tables */
+
+    otai_metadata_apis_query(config->apiquery, &apis);
+
+    memset(&replay, 0, sizeof(replay));
+
+    replay.config = config;
+    replay.stats = stats;
+
+    otai_metadata_arena_init(&replay.arena, OTAI_METADATA_RECORDER_ARENA_BLOCK_SIZE, false);
+
+    otai_status_t status = OTAI_STATUS_SUCCESS;
+
+    uint8_t *data = NULL;
+
+    size_t capacity = 0;
+
+    uint64_t recorded = 0;
+    uint64_t first = 0;
+    uint64_t begin = otai_metadata_recorder_now();
+
+    while (true)
+    {
+        uint8_t length[OTAI_METADATA_RECORDER_LENGTH_SIZE];
+
+        size_t got = fread(length, 1, sizeof(length), file);
+
+        if (got == 0)
+        {
+            break;
+        }
+
+        size_t size = (size_t)length[0] | (size_t)length[1] << 8 | (size_t)length[2] << 16 | (size_t)length[3] << 24;
+
+        if (got != sizeof(length))
+        {
+            OTAI_META_LOG_ERROR("recorder file is truncated");
+
+            status = OTAI_STATUS_FAILURE;
+            break;
+        }
+
+        if (size > capacity)
+        {
+            /* malloc alignment keeps attribute lists aligned */
+
+            uint8_t *grown = (uint8_t*)realloc(data, size);
+
+            if (grown == NULL)
+            {
+                status = OTAI_STATUS_NO_MEMORY;
+                break;
+            }
+
+            data = grown;
+            capacity = size;
+        }
+
+        if (fread(data, 1, size, file) != size)
+        {
+            OTAI_META_LOG_ERROR("recorder file is truncated");
+
+            status = OTAI_STATUS_FAILURE;
+            break;
+        }
+
+        otai_metadata_recorder_reader_t r;
+
+        r.data = data;
+        r.size = size;
+        r.pos = 0;
+        r.failed = false;
+
+        /* pace by time difference of records before issuing call */
+
+        otai_metadata_recorder_reader_t peek = r;
+
+        otai_metadata_recorder_get_varint(&peek);
+        otai_metadata_recorder_get_varint(&peek);
+        otai_metadata_recorder_get_varint(&peek);
+
+        uint64_t next = recorded + (uint64_t)otai_metadata_recorder_get_zigzag(&peek);
+
+        if (stats->calls + stats->skipped == 0)
+        {
+            first = next;
+            begin = otai_metadata_recorder_now();
+        }
+        else if (config->speed > 0 && next > first)
+        {
+            uint64_t target = begin + (uint64_t)((double)(next - first) / config->speed);
+
+            if (target > otai_metadata_recorder_now())
+            {
+                otai_metadata_recorder_wait(target);
+            }
+        }
+
+        if (!otai_metadata_recorder_replay_record(&replay, &r, &recorded))
+        {
+            stats->skipped++;
+
+            recorded = next;
+        }
+
+        otai_metadata_arena_reset(&replay.arena);
+    }
+
+    stats->elapsed = otai_metadata_recorder_now() - begin;
+
+    free(data);
+    free(replay.map.keys);
+    free(replay.map.values);
+
+    otai_metadata_arena_destroy(&replay.arena);
+
+    fclose(file);
+
+    return status;
+}
@@ -0,0 +1,352 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatarecorder.h
+ *
+ * @brief   This module defines OTAI Metadata API call recorder and replayer
+ */
+
+#ifndef __OTAIMETADATARECORDER_H_
+#define __OTAIMETADATARECORDER_H_
+
+#include "otaimetadatatypes.h"
+#include "otaimetadatainstrument.h"
+
+/**
+ * @defgroup OTAIMETADATARECORDER OTAI - Metadata API call recorder and replayer
+ *
+ * Recorder wraps method tables returned by otai_api_query() like
+ * instrumentation does, and appends each call to binary file: time, object
+ * ids, status and attributes encoded by otai_serialize_attribute_list_binary().
+ * Get operations record attribute ids only, statistics operations record
+ * counter ids only.
+ *
+ * Calls are encoded to memory buffer under lock, so file has calls in order
+ * they returned, and buffer is written to file when full.
+ *
+ * Replayer issues recorded calls against adapter through generic object
+ * type info methods, at recorded speed, scaled, or as fast as adapter
+ * allows. Object ids created by replay replace recorded ones in following
+ * calls, including object id attribute values. Pointer attribute values,
+ * like notification callbacks, are addresses of recording process, so they
+ * are replaced by values from replay configuration, or dropped.
+ *
+ * File starts with #OTAI_METADATA_RECORDER_MAGIC and version byte, each
+ * record is 32 bit little endian length and record data, whose attribute
+ * lists start at multiple of 8 bytes from record data, so replay decodes
+ * them without copy. Replay needs little endian host.
+ *
+ * @{
+ */
+
+/**
+ * @def OTAI_METADATA_RECORDER_MAGIC
+ * First bytes of recorder file.
+ */
+#define OTAI_METADATA_RECORDER_MAGIC "OTAIREC"
+
+/**
+ * @def OTAI_METADATA_RECORDER_VERSION
+ * Version of recorder file, replayer rejects newer versions.
+ */
+#define OTAI_METADATA_RECORDER_VERSION 1
+
+/**
+ * @brief Recorded call.
+ *
+ * Arrays have object count members, except counter ids.
+ */
+typedef struct _otai_metadata_recorder_call_t
+{
+    /**
+     * @brief API.
+     */
+    otai_api_t                                   api;
+
+    /**
+     * @brief Operation.
+     */
+    otai_metadata_instrument_op_t                op;
+
+    /**
+     * @brief Object type.
+     */
+    otai_object_type_t                           objecttype;
+
+    /**
+     * @brief Time of call from otai_metadata_recorder_now().
+     */
+    otai_uint64_t                                start;
+
+    /**
+     * @brief Status returned by call.
+     */
+    otai_status_t                                status;
+
+    /**
+     * @brief Linecard Id of create operations.
+     */
+    otai_object_id_t                             linecardid;
+
+    /**
+     * @brief Number of objects, 1 for single object operations.
+     */
+    otai_uint32_t                                objectcount;
+
+    /**
+     * @brief Object ids, created ones for create operations.
+     */
+    const otai_object_id_t*                      objectids;
+
+    /**
+     * @brief Number of attributes of create and get operations.
+     */
+    const otai_uint32_t*                         attrcounts;
+
+    /**
+     * @brief Attribute lists of create and get operations.
+     */
+    const otai_attribute_t* const* attrlists;
+
+    /**
+     * @brief Attribute of set operations.
+     */
+    const otai_attribute_t*                      attrs;
+
+    /**
+     * @brief Number of counters of statistics operations.
+     */
+    otai_uint32_t                                countercount;
+
+    /**
+     * @brief Counter ids of statistics operations.
+     */
+    const otai_stat_id_t*                        counterids;
+
+    /**
+     * @brief Statistics mode.
+     */
+    otai_stats_mode_t                            statsmode;
+
+    /**
+     * @brief Bulk operation error mode.
+     */
+    otai_bulk_op_error_mode_t                    errormode;
+
+    /**
+     * @brief Object statuses of bulk operations, NULL for single object operations.
+     */
+    const otai_status_t*                         objectstatuses;
+
+} otai_metadata_recorder_call_t;
+
+/**
+ * @brief Recorder configuration.
+ */
+typedef struct _otai_metadata_recorder_config_t
+{
+    /**
+     * @brief Adapter API query, usually otai_api_query().
+     */
+    const otai_metadata_instrument_api_query_fn  apiquery;
+
+    /**
+     * @brief Recorder file name.
+     */
+    const char*                                  filename;
+
+    /**
+     * @brief Size of memory buffer in bytes, 0 for 1 MB.
+     */
+    otai_uint32_t                                buffersize;
+
+} otai_metadata_recorder_config_t;
+
+/**
+ * @brief Get pointer attribute value for replay.
+ *
+ * @param[in] object_type Object type
+ * @param[in] attr_id Attribute id
+ *
+ * @return Pointer passed to adapter, NULL to drop attribute
+ */
+typedef otai_pointer_t (*otai_metadata_recorder_pointer_fn)(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_attr_id_t attr_id);
+
+/**
+ * @brief Replay configuration.
+ */
+typedef struct _otai_metadata_recorder_replay_config_t
+{
+    /**
+     * @brief Adapter API query, usually otai_api_query().
+     */
+    const otai_metadata_instrument_api_query_fn  apiquery;
+
+    /**
+     * @brief Speed factor, 1 for recorded speed, 0 for maximum speed.
+     */
+    otai_double_t                                speed;
+
+    /**
+     * @brief List size of get operation values, 0 for default.
+     */
+    otai_uint32_t                                listsize;
+
+    /**
+     * @brief Values of pointer attributes, NULL to drop all of them.
+     */
+    otai_metadata_recorder_pointer_fn            pointer;
+
+} otai_metadata_recorder_replay_config_t;
+
+/**
+ * @brief Replay result.
+ */
+typedef struct _otai_metadata_recorder_replay_stats_t
+{
+    /**
+     * @brief Number of replayed calls.
+     */
+    otai_uint64_t                                calls;
+
+    /**
+     * @brief Number of calls whose status differs from recorded one.
+     */
+    otai_uint64_t                                mismatches;
+
+    /**
+     * @brief Number of records which could not be replayed, including set
+     * of dropped pointer attribute.
+     */
+    otai_uint64_t                                skipped;
+
+    /**
+     * @brief Sum of call latencies in nanoseconds.
+     */
+    otai_uint64_t                                busy;
+
+    /**
+     * @brief Replay time in nanoseconds.
+     */
+    otai_uint64_t                                elapsed;
+
+} otai_metadata_recorder_replay_stats_t;
+
+/**
+ * @brief Start recording
+ *
+ * File is created or truncated.
+ *
+ * @param[in] config Configuration
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if configuration is invalid or recorder is already started,
+ * #OTAI_STATUS_FAILURE if file can't be created, #OTAI_STATUS_NO_MEMORY if
+ * buffer can't be allocated
+ */
+extern otai_status_t otai_metadata_recorder_start(
+        _In_ const otai_metadata_recorder_config_t *config);
+
+/**
+ * @brief Stop recording
+ *
+ * Buffer is written and file is closed. Recorded method tables pass calls
+ * to adapter after stop.
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_UNINITIALIZED if
+ * recorder is not started, #OTAI_STATUS_FAILURE if file can't be written
+ */
+extern otai_status_t otai_metadata_recorder_stop(void);
+
+/**
+ * @brief Query recorded API method table
+ *
+ * Signature is the same as otai_api_query(). Tables are never freed, so
+ * threads may call through table while API is queried again. Query of
+ * same adapter table returns same table.
+ *
+ * @param[in] api API id
+ * @param[out] api_method_table Recorded method table
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_UNINITIALIZED if
+ * recorder is not started, #OTAI_STATUS_NO_MEMORY if table
+ * can't be allocated, or status of adapter query
+ */
+extern otai_status_t otai_metadata_recorder_api_query(
+        _In_ otai_api_t api,
+        _Out_ void **api_method_table);
+
+/**
+ * @brief Get current time of call
+ *
+ * @return Monotonic time in nanoseconds
+ */
+extern uint64_t otai_metadata_recorder_now(void);
+
+/**
+ * @brief Record call
+ *
+ * Used by recorded methods, and may be used to record calls made outside
+ * of method tables. Call is ignored when recorder is not started.
+ *
+ * @param[in] call Call
+ */
+extern void otai_metadata_recorder_record(
+        _In_ const otai_metadata_recorder_call_t *call);
+
+/**
+ * @brief Write buffer to file
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_UNINITIALIZED if
+ * recorder is not started, #OTAI_STATUS_FAILURE if file can't be written
+ */
+extern otai_status_t otai_metadata_recorder_flush(void);
+
+/**
+ * @brief Get number of calls not recorded
+ *
+ * Call is not recorded when its attributes can't be encoded, or don't fit
+ * buffer, or file can't be written.
+ *
+ * @return Number of calls not recorded since start
+ */
+extern uint64_t otai_metadata_recorder_get_dropped(void);
+
+/**
+ * @brief Replay recorder file
+ *
+ * Method tables of adapter are queried by otai_metadata_apis_query(), and
+ * calls are issued in recorded order from calling thread. Adapter must
+ * implement methods of recorded calls.
+ *
+ * @param[in] filename Recorder file name
+ * @param[in] config Configuration
+ * @param[out] stats Replay result
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if configuration is invalid, #OTAI_STATUS_FAILURE if file can't be read
+ * or is not recorder file, #OTAI_STATUS_NO_MEMORY on allocation failure
+ */
+extern otai_status_t otai_metadata_recorder_replay(
+        _In_ const char *filename,
+        _In_ const otai_metadata_recorder_replay_config_t *config,
+        _Out_ otai_metadata_recorder_replay_stats_t *stats);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATARECORDER_H_ */
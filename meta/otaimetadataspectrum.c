@@ -0,0 +1,649 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadataspectrum.c
+ *
+ * @brief   This module implements OTAI Metadata OCM spectrum cache
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <otai.h>
+#include "otaimetadatalogger.h"
+#include "otaimetadataspectrum.h"
+
+/*
+ * Buffer reference count has writer flag set while notification fills
+ * buffer, borrow which sees it retries.
+ */
+#define OTAI_METADATA_SPECTRUM_WRITER 0x80000000u
+
+#define OTAI_METADATA_SPECTRUM_NONE UINT32_MAX
+
+typedef struct _otai_metadata_spectrum_buffer_t
+{
+    /* first member, released sweep is converted back to buffer */
+    otai_metadata_spectrum_sweep_t sweep;
+
+    uint32_t refcount;
+
+    /* number of allocated spectrum entries */
+    uint32_t capacity;
+
+} otai_metadata_spectrum_buffer_t;
+
+typedef struct _otai_metadata_spectrum_slot_t
+{
+    otai_object_id_t ocmid;
+
+    /* buffer with latest sweep */
+    uint32_t latest;
+
+    uint64_t version;
+
+    otai_metadata_spectrum_buffer_t *buffers;
+
+} otai_metadata_spectrum_slot_t;
+
+typedef struct _otai_metadata_spectrum_handler_t
+{
+    /* OTAI_NULL_OBJECT_ID for linecard which is being created */
+    otai_object_id_t linecardid;
+
+    otai_linecard_ocm_spectrum_power_notification_fn handler;
+
+} otai_metadata_spectrum_handler_t;
+
+typedef struct _otai_metadata_spectrum_t
+{
+    bool started;
+
+    uint32_t capacity;
+
+    uint32_t buffercount;
+
+    /* used slots, slot is published by incrementing count */
+    uint32_t count;
+
+    otai_metadata_spectrum_slot_t *slots;
+
+    otai_metadata_spectrum_stats_t stats;
+
+    /* user callbacks, few linecards, so searched linearly */
+    otai_metadata_spectrum_handler_t *handlers;
+
+    uint32_t handlercount;
+
+} otai_metadata_spectrum_t;
+
+/*
+ * Notification callback has no user context, so cache is global. Mutex
+ * serializes filling of cache by notifications with start and stop and
+ * protects user callbacks, user callback runs after it is released.
+ * Borrow, release, version and counters don't take mutex.
+ */
+static otai_metadata_spectrum_t otai_metadata_spectrum_global;
+
+static pthread_mutex_t otai_metadata_spectrum_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static otai_metadata_spectrum_handler_t* otai_metadata_spectrum_find_handler(
+        _In_ const otai_metadata_spectrum_t *spectrum,
+        _In_ otai_object_id_t linecard_id)
+{
+    uint32_t idx = 0;
+
+    for (; idx < spectrum->handlercount; idx++)
+    {
+        if (spectrum->handlers[idx].linecardid == linecard_id)
+        {
+            return &spectrum->handlers[idx];
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Linecard without own handler is notified during its create, so it gets
+ * handler of linecard which is being created.
+ */
+static otai_linecard_ocm_spectrum_power_notification_fn otai_metadata_spectrum_handler(
+        _In_ const otai_metadata_spectrum_t *spectrum,
+        _In_ otai_object_id_t linecard_id)
+{
+    const otai_metadata_spectrum_handler_t *handler = otai_metadata_spectrum_find_handler(spectrum, linecard_id);
+
+    if (handler == NULL)
+    {
+        handler = otai_metadata_spectrum_find_handler(spectrum, OTAI_NULL_OBJECT_ID);
+    }
+
+    return (handler == NULL) ? NULL : handler->handler;
+}
+
+static void otai_metadata_spectrum_unset_handler(
+        _Inout_ otai_metadata_spectrum_t *spectrum,
+        _In_ otai_metadata_spectrum_handler_t *handler)
+{
+    *handler = spectrum->handlers[--spectrum->handlercount];
+
+    if (spectrum->handlercount == 0)
+    {
+        free(spectrum->handlers);
+
+        spectrum->handlers = NULL;
+    }
+}
+
+static otai_status_t otai_metadata_spectrum_set_handler(
+        _Inout_ otai_metadata_spectrum_t *spectrum,
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_linecard_ocm_spectrum_power_notification_fn handler)
+{
+    otai_metadata_spectrum_handler_t *entry = otai_metadata_spectrum_find_handler(spectrum, linecard_id);
+
+    if (entry == NULL)
+    {
+        otai_metadata_spectrum_handler_t *handlers = realloc(spectrum->handlers,
+                (spectrum->handlercount + 1) * sizeof(otai_metadata_spectrum_handler_t));
+
+        if (handlers == NULL)
+        {
+            return OTAI_STATUS_NO_MEMORY;
+        }
+
+        spectrum->handlers = handlers;
+
+        entry = &handlers[spectrum->handlercount++];
+
+        entry->linecardid = linecard_id;
+    }
+
+    entry->handler = handler;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static void otai_metadata_spectrum_free(
+        _Inout_ otai_metadata_spectrum_t *spectrum)
+{
+    uint32_t idx = 0;
+
+    for (; spectrum->slots != NULL && idx < spectrum->capacity; idx++)
+    {
+        otai_metadata_spectrum_slot_t *slot = &spectrum->slots[idx];
+
+        uint32_t buf = 0;
+
+        for (; slot->buffers != NULL && buf < spectrum->buffercount; buf++)
+        {
+            free(slot->buffers[buf].sweep.spectrum.list);
+        }
+
+        free(slot->buffers);
+    }
+
+    free(spectrum->slots);
+
+    spectrum->slots = NULL;
+}
+
+otai_status_t otai_metadata_spectrum_start(
+        _In_ const otai_metadata_spectrum_config_t *config)
+{
+    otai_metadata_spectrum_t *spectrum = &otai_metadata_spectrum_global;
+
+    if (config == NULL || config->capacity == 0 || config->buffers < 2)
+    {
+        OTAI_META_LOG_ERROR("invalid capacity or less than 2 buffers");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_lock(&otai_metadata_spectrum_mutex);
+
+    if (spectrum->started)
+    {
+        pthread_mutex_unlock(&otai_metadata_spectrum_mutex);
+
+        OTAI_META_LOG_ERROR("spectrum cache is already started");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    spectrum->capacity = config->capacity;
+    spectrum->buffercount = config->buffers;
+    spectrum->slots = calloc(config->capacity, sizeof(otai_metadata_spectrum_slot_t));
+
+    bool allocated = (spectrum->slots != NULL);
+
+    uint32_t idx = 0;
+
+    for (; allocated && idx < config->capacity; idx++)
+    {
+        otai_metadata_spectrum_slot_t *slot = &spectrum->slots[idx];
+
+        slot->buffers = calloc(config->buffers, sizeof(otai_metadata_spectrum_buffer_t));
+
+        allocated = (slot->buffers != NULL);
+
+        uint32_t buf = 0;
+
+        for (; allocated && buf < config->buffers; buf++)
+        {
+            otai_metadata_spectrum_buffer_t *buffer = &slot->buffers[buf];
+
+            /* calloc of zero elements may return NULL */
+
+            buffer->sweep.spectrum.list = calloc((size_t)config->entries + 1, sizeof(otai_spectrum_power_t));
+            buffer->capacity = config->entries + 1;
+
+            allocated = (buffer->sweep.spectrum.list != NULL);
+        }
+    }
+
+    if (!allocated)
+    {
+        otai_metadata_spectrum_free(spectrum);
+
+        pthread_mutex_unlock(&otai_metadata_spectrum_mutex);
+
+        return OTAI_STATUS_NO_MEMORY;
+    }
+
+    memset(&spectrum->stats, 0, sizeof(otai_metadata_spectrum_stats_t));
+
+    spectrum->count = 0;
+
+    __atomic_store_n(&spectrum->started, true, __ATOMIC_SEQ_CST);
+
+    pthread_mutex_unlock(&otai_metadata_spectrum_mutex);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+void otai_metadata_spectrum_stop(void)
+{
+    otai_metadata_spectrum_t *spectrum = &otai_metadata_spectrum_global;
+
+    pthread_mutex_lock(&otai_metadata_spectrum_mutex);
+
+    /* new notifications are delivered directly from now */
+
+    __atomic_store_n(&spectrum->started, false, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&spectrum->count, 0, __ATOMIC_SEQ_CST);
+
+    otai_metadata_spectrum_free(spectrum);
+
+    pthread_mutex_unlock(&otai_metadata_spectrum_mutex);
+}
+
+static otai_metadata_spectrum_slot_t* otai_metadata_spectrum_find(
+        _In_ const otai_metadata_spectrum_t *spectrum,
+        _In_ otai_object_id_t ocm_id)
+{
+    uint32_t count = __atomic_load_n(&spectrum->count, __ATOMIC_ACQUIRE);
+
+    uint32_t idx = 0;
+
+    for (; idx < count; idx++)
+    {
+        if (spectrum->slots[idx].ocmid == ocm_id)
+        {
+            return &spectrum->slots[idx];
+        }
+    }
+
+    return NULL;
+}
+
+static otai_metadata_spectrum_buffer_t* otai_metadata_spectrum_claim(
+        _Inout_ otai_metadata_spectrum_t *spectrum,
+        _Inout_ otai_metadata_spectrum_slot_t *slot)
+{
+    uint32_t latest = __atomic_load_n(&slot->latest, __ATOMIC_ACQUIRE);
+
+    uint32_t idx = 0;
+
+    for (; idx < spectrum->buffercount; idx++)
+    {
+        uint32_t expected = 0;
+
+        if (idx != latest && __atomic_compare_exchange_n(&slot->buffers[idx].refcount, &expected,
+                    OTAI_METADATA_SPECTRUM_WRITER, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            return &slot->buffers[idx];
+        }
+    }
+
+    return NULL;
+}
+
+static bool otai_metadata_spectrum_fill(
+        _Inout_ otai_metadata_spectrum_buffer_t *buffer,
+        _In_ otai_object_id_t linecard_id,
+        _In_ const otai_metadata_spectrum_slot_t *slot,
+        _In_ const otai_spectrum_power_list_t *ocm_result)
+{
+    uint32_t count = (ocm_result->list == NULL) ? 0 : ocm_result->count;
+
+    if (count > buffer->capacity)
+    {
+        /* buffer is claimed, so no reader can see it */
+
+        otai_spectrum_power_t *list = realloc(buffer->sweep.spectrum.list, sizeof(otai_spectrum_power_t) * count);
+
+        if (list == NULL)
+        {
+            return false;
+        }
+
+        buffer->sweep.spectrum.list = list;
+        buffer->capacity = count;
+    }
+
+    if (count != 0)
+    {
+        memcpy(buffer->sweep.spectrum.list, ocm_result->list, sizeof(otai_spectrum_power_t) * count);
+    }
+
+    buffer->sweep.linecardid = linecard_id;
+    buffer->sweep.ocmid = slot->ocmid;
+    buffer->sweep.version = slot->version + 1;
+    buffer->sweep.spectrum.count = count;
+
+    return true;
+}
+
+void otai_metadata_spectrum_process(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_object_id_t ocm_id,
+        _In_ const otai_spectrum_power_list_t *ocm_result)
+{
+    otai_metadata_spectrum_t *spectrum = &otai_metadata_spectrum_global;
+
+    pthread_mutex_lock(&otai_metadata_spectrum_mutex);
+
+    otai_linecard_ocm_spectrum_power_notification_fn handler = otai_metadata_spectrum_handler(spectrum, linecard_id);
+
+    otai_metadata_spectrum_buffer_t *buffer = NULL;
+
+    if (spectrum->started)
+    {
+        __atomic_fetch_add(&spectrum->stats.received, 1, __ATOMIC_RELAXED);
+
+        otai_metadata_spectrum_slot_t *slot = otai_metadata_spectrum_find(spectrum, ocm_id);
+
+        if (slot == NULL && spectrum->count < spectrum->capacity)
+        {
+            slot = &spectrum->slots[spectrum->count];
+
+            slot->ocmid = ocm_id;
+            slot->latest = OTAI_METADATA_SPECTRUM_NONE;
+            slot->version = 0;
+
+            __atomic_store_n(&spectrum->count, spectrum->count + 1, __ATOMIC_RELEASE);
+            __atomic_fetch_add(&spectrum->stats.ocms, 1, __ATOMIC_RELAXED);
+        }
+
+        buffer = (slot == NULL) ? NULL : otai_metadata_spectrum_claim(spectrum, slot);
+
+        if (buffer != NULL && !otai_metadata_spectrum_fill(buffer, linecard_id, slot, ocm_result))
+        {
+            __atomic_fetch_and(&buffer->refcount, ~OTAI_METADATA_SPECTRUM_WRITER, __ATOMIC_RELEASE);
+
+            buffer = NULL;
+        }
+
+        if (buffer != NULL)
+        {
+            /* writer flag is cleared before buffer is published as latest */
+
+            __atomic_fetch_and(&buffer->refcount, ~OTAI_METADATA_SPECTRUM_WRITER, __ATOMIC_RELEASE);
+
+            __atomic_store_n(&slot->version, buffer->sweep.version, __ATOMIC_RELEASE);
+            __atomic_store_n(&slot->latest, (uint32_t)(buffer - slot->buffers), __ATOMIC_RELEASE);
+        }
+        else if (slot == NULL)
+        {
+            __atomic_fetch_add(&spectrum->stats.overflow, 1, __ATOMIC_RELAXED);
+        }
+        else
+        {
+            __atomic_fetch_add(&spectrum->stats.dropped, 1, __ATOMIC_RELAXED);
+        }
+    }
+
+    pthread_mutex_unlock(&otai_metadata_spectrum_mutex);
+
+    /*
+     * User callback gets adapter list, which holds the same data as cached
+     * sweep and is valid until notification returns, so callback runs
+     * without mutex and stop can't release memory it reads.
+     */
+
+    if (handler != NULL)
+    {
+        handler(linecard_id, ocm_id, *ocm_result);
+    }
+}
+
+static void otai_metadata_spectrum_on_ocm_spectrum_power(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_object_id_t ocm_id,
+        _In_ otai_spectrum_power_list_t ocm_result)
+{
+    otai_metadata_spectrum_process(linecard_id, ocm_id, &ocm_result);
+}
+
+otai_status_t otai_metadata_spectrum_wrap_attr_list(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t attr_count,
+        _Inout_ otai_attribute_t *attr_list)
+{
+    otai_metadata_spectrum_t *spectrum = &otai_metadata_spectrum_global;
+
+    if (attr_count != 0 && attr_list == NULL)
+    {
+        OTAI_META_LOG_ERROR("attribute list is NULL");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (object_type != OTAI_OBJECT_TYPE_LINECARD)
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < attr_count; idx++)
+    {
+        otai_attribute_t *attr = &attr_list[idx];
+
+        otai_pointer_t ptr = attr->value.ptr;
+
+        if (attr->id != OTAI_LINECARD_ATTR_LINECARD_OCM_SPECTRUM_POWER_NOTIFY || ptr == NULL ||
+                ptr == (otai_pointer_t)otai_metadata_spectrum_on_ocm_spectrum_power)
+        {
+            continue;
+        }
+
+        pthread_mutex_lock(&otai_metadata_spectrum_mutex);
+
+        otai_status_t status = otai_metadata_spectrum_set_handler(spectrum, linecard_id,
+                (otai_linecard_ocm_spectrum_power_notification_fn)ptr);
+
+        pthread_mutex_unlock(&otai_metadata_spectrum_mutex);
+
+        if (status != OTAI_STATUS_SUCCESS)
+        {
+            OTAI_META_LOG_ERROR("failed to keep spectrum handler");
+
+            return status;
+        }
+
+        attr->value.ptr = (otai_pointer_t)otai_metadata_spectrum_on_ocm_spectrum_power;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_spectrum_bind_linecard(
+        _In_ otai_object_id_t linecard_id)
+{
+    otai_metadata_spectrum_t *spectrum = &otai_metadata_spectrum_global;
+
+    if (linecard_id == OTAI_NULL_OBJECT_ID)
+    {
+        OTAI_META_LOG_ERROR("linecard id is NULL");
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    pthread_mutex_lock(&otai_metadata_spectrum_mutex);
+
+    otai_metadata_spectrum_handler_t *created = otai_metadata_spectrum_find_handler(spectrum, OTAI_NULL_OBJECT_ID);
+
+    if (created != NULL)
+    {
+        /* linecard id can be reused without remove of old linecard */
+
+        otai_metadata_spectrum_handler_t *old = otai_metadata_spectrum_find_handler(spectrum, linecard_id);
+
+        if (old != NULL)
+        {
+            old->handler = created->handler;
+
+            otai_metadata_spectrum_unset_handler(spectrum, created);
+        }
+        else
+        {
+            created->linecardid = linecard_id;
+        }
+    }
+
+    pthread_mutex_unlock(&otai_metadata_spectrum_mutex);
+
+    return (created == NULL) ? OTAI_STATUS_ITEM_NOT_FOUND : OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_spectrum_remove_linecard(
+        _In_ otai_object_id_t linecard_id)
+{
+    otai_metadata_spectrum_t *spectrum = &otai_metadata_spectrum_global;
+
+    pthread_mutex_lock(&otai_metadata_spectrum_mutex);
+
+    otai_metadata_spectrum_handler_t *handler = otai_metadata_spectrum_find_handler(spectrum, linecard_id);
+
+    if (handler != NULL)
+    {
+        otai_metadata_spectrum_unset_handler(spectrum, handler);
+    }
+
+    pthread_mutex_unlock(&otai_metadata_spectrum_mutex);
+
+    return (handler == NULL) ? OTAI_STATUS_ITEM_NOT_FOUND : OTAI_STATUS_SUCCESS;
+}
+
+const otai_metadata_spectrum_sweep_t* otai_metadata_spectrum_borrow(
+        _In_ otai_object_id_t ocm_id)
+{
+    const otai_metadata_spectrum_t *spectrum = &otai_metadata_spectrum_global;
+
+    if (!__atomic_load_n(&spectrum->started, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+
+    otai_metadata_spectrum_slot_t *slot = otai_metadata_spectrum_find(spectrum, ocm_id);
+
+    if (slot == NULL)
+    {
+        return NULL;
+    }
+
+    /*
+     * Reference is taken on latest buffer, and kept only if buffer is not
+     * being filled and is still latest, otherwise notification swapped
+     * buffers meanwhile and borrow retries with new latest buffer.
+     */
+
+    while (true)
+    {
+        uint32_t latest = __atomic_load_n(&slot->latest, __ATOMIC_ACQUIRE);
+
+        if (latest == OTAI_METADATA_SPECTRUM_NONE)
+        {
+            return NULL;
+        }
+
+        otai_metadata_spectrum_buffer_t *buffer = &slot->buffers[latest];
+
+        uint32_t refcount = __atomic_fetch_add(&buffer->refcount, 1, __ATOMIC_SEQ_CST);
+
+        if ((refcount & OTAI_METADATA_SPECTRUM_WRITER) == 0 && __atomic_load_n(&slot->latest, __ATOMIC_SEQ_CST) == latest)
+        {
+            return &buffer->sweep;
+        }
+
+        __atomic_fetch_sub(&buffer->refcount, 1, __ATOMIC_RELEASE);
+    }
+}
+
+void otai_metadata_spectrum_release(
+        _In_ const otai_metadata_spectrum_sweep_t *sweep)
+{
+    if (sweep == NULL)
+    {
+        return;
+    }
+
+    otai_metadata_spectrum_buffer_t *buffer = (otai_metadata_spectrum_buffer_t*)(uintptr_t)sweep;
+
+    __atomic_fetch_sub(&buffer->refcount, 1, __ATOMIC_RELEASE);
+}
+
+uint64_t otai_metadata_spectrum_get_version(
+        _In_ otai_object_id_t ocm_id)
+{
+    const otai_metadata_spectrum_t *spectrum = &otai_metadata_spectrum_global;
+
+    if (!__atomic_load_n(&spectrum->started, __ATOMIC_ACQUIRE))
+    {
+        return 0;
+    }
+
+    const otai_metadata_spectrum_slot_t *slot = otai_metadata_spectrum_find(spectrum, ocm_id);
+
+    return (slot == NULL) ? 0 : __atomic_load_n(&slot->version, __ATOMIC_ACQUIRE);
+}
+
+otai_status_t otai_metadata_spectrum_get_stats(
+        _Out_ otai_metadata_spectrum_stats_t *stats)
+{
+    otai_metadata_spectrum_t *spectrum = &otai_metadata_spectrum_global;
+
+    stats->received = __atomic_load_n(&spectrum->stats.received, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&spectrum->stats.dropped, __ATOMIC_RELAXED);
+    stats->overflow = __atomic_load_n(&spectrum->stats.overflow, __ATOMIC_RELAXED);
+    stats->ocms = __atomic_load_n(&spectrum->stats.ocms, __ATOMIC_RELAXED);
+
+    return __atomic_load_n(&spectrum->started, __ATOMIC_ACQUIRE) ? OTAI_STATUS_SUCCESS : OTAI_STATUS_UNINITIALIZED;
+}
@@ -0,0 +1,256 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadataspectrum.h
+ *
+ * @brief   This module defines OTAI Metadata OCM spectrum cache
+ */
+
+#ifndef __OTAIMETADATASPECTRUM_H_
+#define __OTAIMETADATASPECTRUM_H_
+
+#include "otaimetadatatypes.h"
+
+/**
+ * @defgroup OTAIMETADATASPECTRUM OTAI - Metadata OCM spectrum cache
+ *
+ * Spectrum cache sits between adapter and user OCM spectrum power
+ * notification and copies each sweep once into buffer of its OCM. User
+ * callback is then called with adapter list, outside of cache lock, and
+ * any number of consumers can borrow latest sweep of OCM without copying
+ * it.
+ *
+ * Each OCM has at least two buffers. Notification fills buffer which is
+ * neither latest nor borrowed and then publishes it as latest, so borrow
+ * never waits for notification. When all other buffers are borrowed, sweep
+ * is dropped and latest sweep stays.
+ *
+ * Like alarm aggregator, attribute list is passed to
+ * otai_metadata_spectrum_wrap_attr_list() before linecard create, user
+ * callback is kept per linecard and created linecard is bound to it by
+ * otai_metadata_spectrum_bind_linecard().
+ *
+ * @{
+ */
+
+/**
+ * @brief Spectrum cache configuration.
+ */
+typedef struct _otai_metadata_spectrum_config_t
+{
+    /**
+     * @brief Maximum number of OCMs.
+     */
+    otai_uint32_t                                capacity;
+
+    /**
+     * @brief Number of buffers of each OCM, at least 2.
+     */
+    otai_uint32_t                                buffers;
+
+    /**
+     * @brief Initial number of spectrum entries of each buffer.
+     *
+     * Buffer grows when sweep doesn't fit.
+     */
+    otai_uint32_t                                entries;
+
+} otai_metadata_spectrum_config_t;
+
+/**
+ * @brief Cached OCM sweep.
+ */
+typedef struct _otai_metadata_spectrum_sweep_t
+{
+    /**
+     * @brief Linecard Id.
+     */
+    otai_object_id_t                             linecardid;
+
+    /**
+     * @brief OCM Id.
+     */
+    otai_object_id_t                             ocmid;
+
+    /**
+     * @brief Sweep version, incremented by each sweep of OCM.
+     */
+    otai_uint64_t                                version;
+
+    /**
+     * @brief Spectrum power list.
+     */
+    otai_spectrum_power_list_t                   spectrum;
+
+} otai_metadata_spectrum_sweep_t;
+
+/**
+ * @brief Spectrum cache counters.
+ */
+typedef struct _otai_metadata_spectrum_stats_t
+{
+    /**
+     * @brief Number of sweeps from adapter.
+     */
+    otai_uint64_t                                received;
+
+    /**
+     * @brief Number of sweeps dropped since all buffers were borrowed.
+     */
+    otai_uint64_t                                dropped;
+
+    /**
+     * @brief Number of sweeps passed to user without caching, since there
+     * was no room for OCM.
+     */
+    otai_uint64_t                                overflow;
+
+    /**
+     * @brief Number of cached OCMs.
+     */
+    otai_uint64_t                                ocms;
+
+} otai_metadata_spectrum_stats_t;
+
+/**
+ * @brief Start spectrum cache
+ *
+ * Until cache is started, or after it is stopped, wrapped callback calls
+ * user callback directly.
+ *
+ * @param[in] config Cache configuration
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if configuration is invalid or cache is already started,
+ * #OTAI_STATUS_NO_MEMORY if buffers can't be allocated
+ */
+extern otai_status_t otai_metadata_spectrum_start(
+        _In_ const otai_metadata_spectrum_config_t *config);
+
+/**
+ * @brief Stop spectrum cache
+ *
+ * All borrowed sweeps must be released before and no borrow may run
+ * during stop, since buffers are released.
+ */
+extern void otai_metadata_spectrum_stop(void);
+
+/**
+ * @brief Replace OCM spectrum power notification callback with cache callback
+ *
+ * Replaced callback is kept for linecard_id. List of linecard create is
+ * wrapped with #OTAI_NULL_OBJECT_ID, its callback gets sweeps of linecards
+ * without own callback until otai_metadata_spectrum_bind_linecard() is
+ * called with created linecard id.
+ *
+ * @param[in] object_type Object type of attributes
+ * @param[in] linecard_id Linecard Id for set, #OTAI_NULL_OBJECT_ID for create
+ * @param[in] attr_count Number of attributes
+ * @param[inout] attr_list Attribute list, passed later to create or set API
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, failure status code on error
+ */
+extern otai_status_t otai_metadata_spectrum_wrap_attr_list(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t attr_count,
+        _Inout_ otai_attribute_t *attr_list);
+
+/**
+ * @brief Bind callback of created linecard to its id
+ *
+ * @param[in] linecard_id Created linecard Id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * no create list was wrapped
+ */
+extern otai_status_t otai_metadata_spectrum_bind_linecard(
+        _In_ otai_object_id_t linecard_id);
+
+/**
+ * @brief Forget callback of removed linecard
+ *
+ * Cached sweeps of linecard are kept.
+ *
+ * @param[in] linecard_id Linecard Id
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_ITEM_NOT_FOUND if
+ * linecard has no callback
+ */
+extern otai_status_t otai_metadata_spectrum_remove_linecard(
+        _In_ otai_object_id_t linecard_id);
+
+/**
+ * @brief Pass OCM sweep to cache
+ *
+ * Wrapped callback calls this.
+ *
+ * @param[in] linecard_id Linecard Id
+ * @param[in] ocm_id OCM Id
+ * @param[in] ocm_result OCM Result, copied to cache
+ */
+extern void otai_metadata_spectrum_process(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_object_id_t ocm_id,
+        _In_ const otai_spectrum_power_list_t *ocm_result);
+
+/**
+ * @brief Borrow latest sweep of OCM
+ *
+ * Sweep stays valid and unchanged until it is released.
+ *
+ * @param[in] ocm_id OCM Id
+ *
+ * @return Latest sweep, NULL if OCM has no sweep or cache is not started
+ */
+extern const otai_metadata_spectrum_sweep_t* otai_metadata_spectrum_borrow(
+        _In_ otai_object_id_t ocm_id);
+
+/**
+ * @brief Release borrowed sweep
+ *
+ * @param[in] sweep Borrowed sweep
+ */
+extern void otai_metadata_spectrum_release(
+        _In_ const otai_metadata_spectrum_sweep_t *sweep);
+
+/**
+ * @brief Get version of latest sweep of OCM
+ *
+ * Consumer can compare version with version of sweep it has seen before
+ * borrowing new one.
+ *
+ * @param[in] ocm_id OCM Id
+ *
+ * @return Version of latest sweep, 0 if OCM has no sweep
+ */
+extern uint64_t otai_metadata_spectrum_get_version(
+        _In_ otai_object_id_t ocm_id);
+
+/**
+ * @brief Get spectrum cache counters
+ *
+ * @param[out] stats Counters
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_UNINITIALIZED if
+ * cache is not started
+ */
+extern otai_status_t otai_metadata_spectrum_get_stats(
+        _Out_ otai_metadata_spectrum_stats_t *stats);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATASPECTRUM_H_ */
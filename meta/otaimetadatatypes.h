@@ -503,6 +503,35 @@ typedef struct _otai_attr_condition_t
 
 } otai_attr_condition_t;
 
+/**
+ * @brief Defines minimal perfect hash over metadata names.
+ *
+ * Hash is generated by metadata parser using hash and displace method. Each
+ * name is first hashed with seed zero to select bucket. Negative bucket
+ * displacement points directly to slot (-displacement - 1), otherwise it is
+ * used as seed to hash name again into slot. Slot value is index of candidate
+ * entry in the list for which hash was generated, and candidate name must be
+ * compared with searched name, since hash does not reject unknown names.
+ */
+typedef struct _otai_name_hash_t
+{
+    /**
+     * @brief Number of buckets and slots.
+     */
+    const size_t                        count;
+
+    /**
+     * @brief Bucket displacements.
+     */
+    const int32_t* const                displacements;
+
+    /**
+     * @brief Slot values, index of entry in hashed list.
+     */
+    const uint32_t* const               values;
+
+} otai_name_hash_t;
+
 /**
  * @brief Defines enum metadata information.
  */
@@ -550,6 +579,38 @@ typedef struct _otai_enum_metadata_t
      */
     const char* const* const        ignorevaluesnames;
 
+    /**
+     * @brief Smallest enum value, base of values index.
+     */
+    const int                       valuesindexbase;
+
+    /**
+     * @brief Direct index of enum values.
+     *
+     * Item at (value - valuesindexbase) contains position of value in values
+     * array or -1 if value is not part of enum. Generated only for dense
+     * enums, NULL otherwise.
+     */
+    const int32_t* const            valuesindex;
+
+    /**
+     * @brief Number of items in values index.
+     */
+    const size_t                    valuesindexcount;
+
+    /**
+     * @brief Hash of enum values.
+     *
+     * Generated for sparse enums like flags, when direct index would be too
+     * big. Value is used as hash prefix with empty name. NULL otherwise.
+     */
+    const otai_name_hash_t* const   valueshash;
+
+    /**
+     * @brief Hash of enum values string names.
+     */
+    const otai_name_hash_t* const   valuesnameshash;
+
 } otai_enum_metadata_t;
 
 /**
@@ -1151,6 +1212,45 @@ typedef otai_status_t (*otai_meta_generic_clear_stats_fn)(
         _In_ uint32_t number_of_counters,
         _In_ const otai_stat_id_t *counter_ids);
 
+typedef otai_status_t (*otai_meta_generic_bulk_create_fn)(
+        _In_ otai_object_id_t module_id,
+        _In_ uint32_t object_count,
+        _Inout_ otai_object_meta_key_t *meta_key,
+        _In_ const uint32_t *attr_count,
+        _In_ const otai_attribute_t **attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses);
+
+typedef otai_status_t (*otai_meta_generic_bulk_remove_fn)(
+        _In_ uint32_t object_count,
+        _In_ const otai_object_meta_key_t *meta_key,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses);
+
+typedef otai_status_t (*otai_meta_generic_bulk_set_fn)(
+        _In_ uint32_t object_count,
+        _In_ const otai_object_meta_key_t *meta_key,
+        _In_ const otai_attribute_t *attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses);
+
+typedef otai_status_t (*otai_meta_generic_bulk_get_fn)(
+        _In_ uint32_t object_count,
+        _In_ const otai_object_meta_key_t *meta_key,
+        _In_ const uint32_t *attr_count,
+        _Inout_ otai_attribute_t **attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses);
+
+typedef otai_status_t (*otai_meta_generic_bulk_get_stats_fn)(
+        _In_ uint32_t object_count,
+        _In_ const otai_object_meta_key_t *meta_key,
+        _In_ uint32_t number_of_counters,
+        _In_ const otai_stat_id_t *counter_ids,
+        _In_ otai_stats_mode_t mode,
+        _Out_ otai_status_t *object_statuses,
+        _Out_ otai_stat_value_t *counters);
+
 typedef otai_status_t (*otai_generic_create_fn)(
         _Out_ otai_object_id_t *object_id,
         _In_ otai_object_id_t module_id,
@@ -1276,6 +1376,31 @@ typedef struct _otai_object_type_info_t
      */
     const otai_meta_generic_clear_stats_fn           clearstats;
 
+    /**
+     * @brief Bulk create function pointer.
+     */
+    const otai_meta_generic_bulk_create_fn           bulkcreate;
+
+    /**
+     * @brief Bulk remove function pointer.
+     */
+    const otai_meta_generic_bulk_remove_fn           bulkremove;
+
+    /**
+     * @brief Bulk set function pointer.
+     */
+    const otai_meta_generic_bulk_set_fn              bulkset;
+
+    /**
+     * @brief Bulk get function pointer.
+     */
+    const otai_meta_generic_bulk_get_fn              bulkget;
+
+    /**
+     * @brief Bulk get stats function pointer.
+     */
+    const otai_meta_generic_bulk_get_stats_fn        bulkgetstats;
+
     /**
      * @brief Indicates whether object type is experimental.
      */
@@ -56,19 +56,9 @@ bool otai_metadata_is_allowed_enum_value(
         return false;
     }
 
-    size_t i = 0;
-
-    const otai_enum_metadata_t *emd = metadata->enummetadata;
-
-    for (; i < emd->valuescount; ++i)
-    {
-        if (emd->values[i] == value)
-        {
-            return true;
-        }
-    }
+    size_t index = 0;
 
-    return false;
+    return otai_metadata_get_enum_value_index(metadata->enummetadata, value, &index);
 }
 
 const otai_stat_metadata_t* otai_metadata_get_stat_metadata(
@@ -125,6 +115,64 @@ const otai_attr_metadata_t* otai_metadata_get_attr_metadata(
     return NULL;
 }
 
+uint32_t otai_metadata_hash_name(
+        _In_ int32_t seed,
+        _In_ int32_t prefix,
+        _In_ const char *name,
+        _In_ size_t length)
+{
+    /*
+     * FNV-1a over prefix bytes (little endian) and name, followed by murmur3
+     * finalizer to spread bits before modulo, must match utils.pm.
+     */
+
+    uint32_t hash = 0x811c9dc5U ^ (uint32_t)seed;
+    uint32_t pfx = (uint32_t)prefix;
+
+    size_t i = 0;
+
+    for (; i < 4; ++i)
+    {
+        hash = (hash ^ ((pfx >> (8 * i)) & 0xff)) * 0x01000193U;
+    }
+
+    for (i = 0; i < length; ++i)
+    {
+        hash = (hash ^ (uint32_t)(unsigned char)name[i]) * 0x01000193U;
+    }
+
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bU;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35U;
+    hash ^= hash >> 16;
+
+    return hash;
+}
+
+bool otai_metadata_name_hash_lookup(
+        _In_ const otai_name_hash_t *hash,
+        _In_ int32_t prefix,
+        _In_ const char *name,
+        _In_ size_t length,
+        _Out_ size_t *index)
+{
+    if (hash == NULL || hash->count == 0 || name == NULL)
+    {
+        return false;
+    }
+
+    int32_t displacement = hash->displacements[otai_metadata_hash_name(0, prefix, name, length) % hash->count];
+
+    size_t slot = (displacement < 0)
+        ? (size_t)(-(displacement + 1))
+        : otai_metadata_hash_name(displacement, prefix, name, length) % hash->count;
+
+    *index = hash->values[slot];
+
+    return true;
+}
+
 const otai_attr_metadata_t* otai_metadata_get_attr_metadata_by_attr_id_name(
         _In_ const char *attr_id_name)
 {
@@ -133,31 +181,31 @@ const otai_attr_metadata_t* otai_metadata_get_attr_metadata_by_attr_id_name(
         return NULL;
     }
 
-    /* use binary search */
-
-    ssize_t first = 0;
-    ssize_t last = (ssize_t)(otai_metadata_attr_sorted_by_id_name_count - 1);
+    return otai_metadata_get_attr_metadata_by_attr_id_name_length(attr_id_name, strlen(attr_id_name));
+}
 
-    while (first <= last)
+const otai_attr_metadata_t* otai_metadata_get_attr_metadata_by_attr_id_name_length(
+        _In_ const char *attr_id_name,
+        _In_ size_t length)
+{
+    if (attr_id_name == NULL)
     {
-        ssize_t middle = (first + last) / 2;
+        return NULL;
+    }
 
-        int res = strcmp(attr_id_name, otai_metadata_attr_sorted_by_id_name[middle]->attridname);
+    size_t index = 0;
 
-        if (res > 0)
-        {
-            first = middle + 1;
-        }
-        else if (res < 0)
-        {
-            last = middle - 1;
-        }
-        else
-        {
-            /* found */
+    if (!otai_metadata_name_hash_lookup(&otai_metadata_attr_sorted_by_id_name_hash,
+                0, attr_id_name, length, &index))
+    {
+        return NULL;
+    }
 
-            return otai_metadata_attr_sorted_by_id_name[middle];
-        }
+    const otai_attr_metadata_t *md = otai_metadata_attr_sorted_by_id_name[index];
+
+    if (strncmp(attr_id_name, md->attridname, length) == 0 && md->attridname[length] == 0)
+    {
+        return md;
     }
 
     /* not found */
@@ -173,31 +221,106 @@ const otai_stat_metadata_t* otai_metadata_get_stat_metadata_by_stat_id_name(
         return NULL;
     }
 
-    /* use binary search */
+    size_t index = 0;
+
+    if (!otai_metadata_name_hash_lookup(&otai_metadata_stat_sorted_by_id_name_hash,
+                0, stat_id_name, strlen(stat_id_name), &index))
+    {
+        return NULL;
+    }
 
-    ssize_t first = 0;
-    ssize_t last = (ssize_t)(otai_metadata_stat_sorted_by_id_name_count - 1);
+    const otai_stat_metadata_t *md = otai_metadata_stat_sorted_by_id_name[index];
 
-    while (first <= last)
+    if (strcmp(stat_id_name, md->statidname) == 0)
     {
-        ssize_t middle = (first + last) / 2;
+        return md;
+    }
 
-        int res = strcmp(stat_id_name, otai_metadata_stat_sorted_by_id_name[middle]->statidname);
+    /* not found */
 
-        if (res > 0)
-        {
-            first = middle + 1;
-        }
-        else if (res < 0)
-        {
-            last = middle - 1;
-        }
-        else
-        {
-            /* found */
+    return NULL;
+}
 
-            return otai_metadata_stat_sorted_by_id_name[middle];
-        }
+const otai_attr_metadata_t* otai_metadata_get_attr_metadata_by_attr_id_kebab_name(
+        _In_ otai_object_type_t object_type,
+        _In_ const char *kebab_name)
+{
+    if (kebab_name == NULL)
+    {
+        return NULL;
+    }
+
+    size_t index = 0;
+
+    if (!otai_metadata_name_hash_lookup(&otai_metadata_attr_sorted_by_kebab_name_hash,
+                (int32_t)object_type, kebab_name, strlen(kebab_name), &index))
+    {
+        return NULL;
+    }
+
+    const otai_attr_metadata_t *md = otai_metadata_attr_sorted_by_id_name[index];
+
+    if (md->objecttype == object_type && strcmp(kebab_name, md->attridkebabname) == 0)
+    {
+        return md;
+    }
+
+    /* not found */
+
+    return NULL;
+}
+
+const otai_stat_metadata_t* otai_metadata_get_stat_metadata_by_stat_id_kebab_name(
+        _In_ otai_object_type_t object_type,
+        _In_ const char *kebab_name)
+{
+    if (kebab_name == NULL)
+    {
+        return NULL;
+    }
+
+    size_t index = 0;
+
+    if (!otai_metadata_name_hash_lookup(&otai_metadata_stat_sorted_by_kebab_name_hash,
+                (int32_t)object_type, kebab_name, strlen(kebab_name), &index))
+    {
+        return NULL;
+    }
+
+    const otai_stat_metadata_t *md = otai_metadata_stat_sorted_by_id_name[index];
+
+    if (md->objecttype == object_type && strcmp(kebab_name, md->statidkebabname) == 0)
+    {
+        return md;
+    }
+
+    /* not found */
+
+    return NULL;
+}
+
+const otai_stat_metadata_t* otai_metadata_get_stat_metadata_by_stat_id_camel_name(
+        _In_ otai_object_type_t object_type,
+        _In_ const char *camel_name)
+{
+    if (camel_name == NULL)
+    {
+        return NULL;
+    }
+
+    size_t index = 0;
+
+    if (!otai_metadata_name_hash_lookup(&otai_metadata_stat_sorted_by_camel_name_hash,
+                (int32_t)object_type, camel_name, strlen(camel_name), &index))
+    {
+        return NULL;
+    }
+
+    const otai_stat_metadata_t *md = otai_metadata_stat_sorted_by_id_name[index];
+
+    if (md->objecttype == object_type && strcmp(camel_name, md->statidcamelname) == 0)
+    {
+        return md;
     }
 
     /* not found */
@@ -214,17 +337,118 @@ const char* otai_metadata_get_enum_value_name(
         return NULL;
     }
 
+    size_t index = 0;
+
+    if (otai_metadata_get_enum_value_index(metadata, value, &index))
+    {
+        return metadata->valuesnames[index];
+    }
+
+    return NULL;
+}
+
+bool otai_metadata_get_enum_value_index(
+        _In_ const otai_enum_metadata_t* metadata,
+        _In_ int value,
+        _Out_ size_t *index)
+{
+    if (metadata == NULL || index == NULL)
+    {
+        return false;
+    }
+
+    if (metadata->valuesindex != NULL)
+    {
+        /* dense enum, use direct index */
+
+        int64_t offset = (int64_t)value - (int64_t)metadata->valuesindexbase;
+
+        if (offset < 0 || (uint64_t)offset >= metadata->valuesindexcount)
+        {
+            return false;
+        }
+
+        int32_t pos = metadata->valuesindex[offset];
+
+        if (pos >= 0 && metadata->values[pos] == value)
+        {
+            *index = (size_t)pos;
+            return true;
+        }
+
+        return false;
+    }
+
+    if (metadata->valueshash != NULL)
+    {
+        size_t pos = 0;
+
+        if (otai_metadata_name_hash_lookup(metadata->valueshash, value, "", 0, &pos) &&
+                pos < metadata->valuescount && metadata->values[pos] == value)
+        {
+            *index = pos;
+            return true;
+        }
+
+        return false;
+    }
+
+    /* numeric values were not known when generating metadata */
+
     size_t i = 0;
 
     for (; i < metadata->valuescount; ++i)
     {
         if (metadata->values[i] == value)
         {
-            return metadata->valuesnames[i];
+            *index = i;
+            return true;
         }
     }
 
-    return NULL;
+    return false;
+}
+
+bool otai_metadata_get_enum_value_index_by_name(
+        _In_ const otai_enum_metadata_t* metadata,
+        _In_ const char *name,
+        _In_ size_t length,
+        _Out_ size_t *index)
+{
+    if (metadata == NULL || name == NULL || index == NULL)
+    {
+        return false;
+    }
+
+    if (metadata->valuesnameshash != NULL)
+    {
+        size_t pos = 0;
+
+        if (otai_metadata_name_hash_lookup(metadata->valuesnameshash, 0, name, length, &pos) &&
+                pos < metadata->valuescount &&
+                strncmp(metadata->valuesnames[pos], name, length) == 0 &&
+                metadata->valuesnames[pos][length] == 0)
+        {
+            *index = pos;
+            return true;
+        }
+
+        return false;
+    }
+
+    size_t i = 0;
+
+    for (; i < metadata->valuescount; ++i)
+    {
+        if (strncmp(metadata->valuesnames[i], name, length) == 0 &&
+                metadata->valuesnames[i][length] == 0)
+        {
+            *index = i;
+            return true;
+        }
+    }
+
+    return false;
 }
 
 const otai_attribute_t* otai_metadata_get_attr_by_id(
@@ -280,6 +504,45 @@ bool otai_metadata_is_object_type_valid(
     return object_type > OTAI_OBJECT_TYPE_NULL && object_type < OTAI_OBJECT_TYPE_MAX;
 }
 
+bool otai_metadata_is_condition_value_met(
+        _In_ const otai_attr_metadata_t *metadata,
+        _In_ const otai_attr_condition_t *condition,
+        _In_ const otai_attribute_value_t *value)
+{
+    switch (metadata->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_BOOL:
+            return condition->condition.booldata == value->booldata;
+        case OTAI_ATTR_VALUE_TYPE_INT8:
+            return condition->condition.s8 == value->s8;
+        case OTAI_ATTR_VALUE_TYPE_INT16:
+            return condition->condition.s16 == value->s16;
+        case OTAI_ATTR_VALUE_TYPE_INT32:
+            return condition->condition.s32 == value->s32;
+        case OTAI_ATTR_VALUE_TYPE_INT64:
+            return condition->condition.s64 == value->s64;
+        case OTAI_ATTR_VALUE_TYPE_UINT8:
+            return condition->condition.u8 == value->u8;
+        case OTAI_ATTR_VALUE_TYPE_UINT16:
+            return condition->condition.u16 == value->u16;
+        case OTAI_ATTR_VALUE_TYPE_UINT32:
+            return condition->condition.u32 == value->u32;
+        case OTAI_ATTR_VALUE_TYPE_UINT64:
+            return condition->condition.u64 == value->u64;
+
+        default:
+
+            /*
+             * We should never get here since sanity check tests all
+             * attributes and all conditions.
+             */
+
+            OTAI_META_LOG_ERROR("condition value type %d is not supported, FIXME", metadata->attrvaluetype);
+
+            return false;
+    }
+}
+
 bool otai_metadata_is_condition_met(
         _In_ const otai_attr_metadata_t *metadata,
         _In_ uint32_t attr_count,
@@ -339,49 +602,7 @@ bool otai_metadata_is_condition_met(
             continue;
         }
 
-        bool current = false;
-
-        switch (cmd->attrvaluetype)
-        {
-            case OTAI_ATTR_VALUE_TYPE_BOOL:
-                current = (condition->condition.booldata == cvalue->booldata);
-                break;
-            case OTAI_ATTR_VALUE_TYPE_INT8:
-                current = (condition->condition.s8 == cvalue->s8);
-                break;
-            case OTAI_ATTR_VALUE_TYPE_INT16:
-                current = (condition->condition.s16 == cvalue->s16);
-                break;
-            case OTAI_ATTR_VALUE_TYPE_INT32:
-                current = (condition->condition.s32 == cvalue->s32);
-                break;
-            case OTAI_ATTR_VALUE_TYPE_INT64:
-                current = (condition->condition.s64 == cvalue->s64);
-                break;
-            case OTAI_ATTR_VALUE_TYPE_UINT8:
-                current = (condition->condition.u8 == cvalue->u8);
-                break;
-            case OTAI_ATTR_VALUE_TYPE_UINT16:
-                current = (condition->condition.u16 == cvalue->u16);
-                break;
-            case OTAI_ATTR_VALUE_TYPE_UINT32:
-                current = (condition->condition.u32 == cvalue->u32);
-                break;
-            case OTAI_ATTR_VALUE_TYPE_UINT64:
-                current = (condition->condition.u64 == cvalue->u64);
-                break;
-
-            default:
-
-                /*
-                 * We should never get here since sanity check tests all
-                 * attributes and all conditions.
-                 */
-
-                OTAI_META_LOG_ERROR("condition value type %d is not supported, FIXME", cmd->attrvaluetype);
-
-                return false;
-        }
+        bool current = otai_metadata_is_condition_value_met(cmd, condition, cvalue);
 
         if (metadata->conditiontype == OTAI_ATTR_CONDITION_TYPE_AND)
         {
@@ -396,3 +617,806 @@ bool otai_metadata_is_condition_met(
     return met;
 }
 
+
+/*
+ * Object ids for native bulk calls are converted from meta keys in chunks of
+ * this size on the stack, so bulk operations don't need any allocation.
+ */
+#define OTAI_METADATA_BULK_CHUNK_SIZE 128
+
+static uint32_t otai_metadata_bulk_chunk_count(
+        _In_ uint32_t object_count,
+        _In_ uint32_t idx)
+{
+    uint32_t count = object_count - idx;
+
+    return (count < OTAI_METADATA_BULK_CHUNK_SIZE) ? count : OTAI_METADATA_BULK_CHUNK_SIZE;
+}
+
+static bool otai_metadata_bulk_is_not_supported(
+        _In_ otai_status_t status)
+{
+    return status == OTAI_STATUS_NOT_IMPLEMENTED || status == OTAI_STATUS_NOT_SUPPORTED;
+}
+
+static otai_status_t otai_metadata_bulk_not_executed(
+        _In_ uint32_t idx,
+        _In_ uint32_t object_count,
+        _Out_ otai_status_t *object_statuses)
+{
+    for (; idx < object_count; ++idx)
+    {
+        object_statuses[idx] = OTAI_STATUS_NOT_EXECUTED;
+    }
+
+    return OTAI_STATUS_FAILURE;
+}
+
+otai_status_t otai_metadata_bulk_create(
+        _In_ otai_bulk_object_create_fn bulk_create,
+        _In_ otai_meta_generic_create_fn create,
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t object_count,
+        _Inout_ otai_object_meta_key_t *meta_key,
+        _In_ const uint32_t *attr_count,
+        _In_ const otai_attribute_t **attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses)
+{
+    if (object_count == 0)
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    if (create == NULL || meta_key == NULL || attr_count == NULL ||
+            attr_list == NULL || object_statuses == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    otai_status_t status = OTAI_STATUS_SUCCESS;
+
+    uint32_t idx = 0;
+
+    while (bulk_create != NULL && idx < object_count)
+    {
+        otai_object_id_t object_id[OTAI_METADATA_BULK_CHUNK_SIZE];
+
+        uint32_t count = otai_metadata_bulk_chunk_count(object_count, idx);
+
+        uint32_t i = 0;
+
+        for (; i < count; ++i)
+        {
+            object_id[i] = OTAI_NULL_OBJECT_ID;
+        }
+
+        otai_status_t st = bulk_create(linecard_id, count, attr_count + idx,
+                attr_list + idx, mode, object_id, object_statuses + idx);
+
+        if (otai_metadata_bulk_is_not_supported(st))
+        {
+            break;
+        }
+
+        /* adapter is not required to fill ids of failed or not executed objects */
+
+        for (i = 0; i < count; ++i)
+        {
+            meta_key[idx + i].objectkey.key.object_id =
+                (object_statuses[idx + i] == OTAI_STATUS_SUCCESS) ? object_id[i] : OTAI_NULL_OBJECT_ID;
+        }
+
+        idx += count;
+
+        if (st != OTAI_STATUS_SUCCESS)
+        {
+            status = OTAI_STATUS_FAILURE;
+
+            if (mode == OTAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR)
+            {
+                return otai_metadata_bulk_not_executed(idx, object_count, object_statuses);
+            }
+        }
+    }
+
+    for (; idx < object_count; ++idx)
+    {
+        object_statuses[idx] = create(&meta_key[idx], linecard_id, attr_count[idx], attr_list[idx]);
+
+        if (object_statuses[idx] != OTAI_STATUS_SUCCESS)
+        {
+            status = OTAI_STATUS_FAILURE;
+
+            if (mode == OTAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR)
+            {
+                return otai_metadata_bulk_not_executed(idx + 1, object_count, object_statuses);
+            }
+        }
+    }
+
+    return status;
+}
+
+otai_status_t otai_metadata_bulk_remove(
+        _In_ otai_bulk_object_remove_fn bulk_remove,
+        _In_ otai_meta_generic_remove_fn remove,
+        _In_ uint32_t object_count,
+        _In_ const otai_object_meta_key_t *meta_key,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses)
+{
+    if (object_count == 0)
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    if (remove == NULL || meta_key == NULL || object_statuses == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    otai_status_t status = OTAI_STATUS_SUCCESS;
+
+    uint32_t idx = 0;
+
+    while (bulk_remove != NULL && idx < object_count)
+    {
+        otai_object_id_t object_id[OTAI_METADATA_BULK_CHUNK_SIZE];
+
+        uint32_t count = otai_metadata_bulk_chunk_count(object_count, idx);
+
+        uint32_t i = 0;
+
+        for (; i < count; ++i)
+        {
+            object_id[i] = meta_key[idx + i].objectkey.key.object_id;
+        }
+
+        otai_status_t st = bulk_remove(count, object_id, mode, object_statuses + idx);
+
+        if (otai_metadata_bulk_is_not_supported(st))
+        {
+            break;
+        }
+
+        idx += count;
+
+        if (st != OTAI_STATUS_SUCCESS)
+        {
+            status = OTAI_STATUS_FAILURE;
+
+            if (mode == OTAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR)
+            {
+                return otai_metadata_bulk_not_executed(idx, object_count, object_statuses);
+            }
+        }
+    }
+
+    for (; idx < object_count; ++idx)
+    {
+        object_statuses[idx] = remove(&meta_key[idx]);
+
+        if (object_statuses[idx] != OTAI_STATUS_SUCCESS)
+        {
+            status = OTAI_STATUS_FAILURE;
+
+            if (mode == OTAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR)
+            {
+                return otai_metadata_bulk_not_executed(idx + 1, object_count, object_statuses);
+            }
+        }
+    }
+
+    return status;
+}
+
+otai_status_t otai_metadata_bulk_set(
+        _In_ otai_bulk_object_set_attribute_fn bulk_set,
+        _In_ otai_meta_generic_set_fn set,
+        _In_ uint32_t object_count,
+        _In_ const otai_object_meta_key_t *meta_key,
+        _In_ const otai_attribute_t *attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses)
+{
+    if (object_count == 0)
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    if (set == NULL || meta_key == NULL || attr_list == NULL || object_statuses == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    otai_status_t status = OTAI_STATUS_SUCCESS;
+
+    uint32_t idx = 0;
+
+    while (bulk_set != NULL && idx < object_count)
+    {
+        otai_object_id_t object_id[OTAI_METADATA_BULK_CHUNK_SIZE];
+
+        uint32_t count = otai_metadata_bulk_chunk_count(object_count, idx);
+
+        uint32_t i = 0;
+
+        for (; i < count; ++i)
+        {
+            object_id[i] = meta_key[idx + i].objectkey.key.object_id;
+        }
+
+        otai_status_t st = bulk_set(count, object_id, attr_list + idx, mode, object_statuses + idx);
+
+        if (otai_metadata_bulk_is_not_supported(st))
+        {
+            break;
+        }
+
+        idx += count;
+
+        if (st != OTAI_STATUS_SUCCESS)
+        {
+            status = OTAI_STATUS_FAILURE;
+
+            if (mode == OTAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR)
+            {
+                return otai_metadata_bulk_not_executed(idx, object_count, object_statuses);
+            }
+        }
+    }
+
+    for (; idx < object_count; ++idx)
+    {
+        object_statuses[idx] = set(&meta_key[idx], &attr_list[idx]);
+
+        if (object_statuses[idx] != OTAI_STATUS_SUCCESS)
+        {
+            status = OTAI_STATUS_FAILURE;
+
+            if (mode == OTAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR)
+            {
+                return otai_metadata_bulk_not_executed(idx + 1, object_count, object_statuses);
+            }
+        }
+    }
+
+    return status;
+}
+
+otai_status_t otai_metadata_bulk_get(
+        _In_ otai_bulk_object_get_attribute_fn bulk_get,
+        _In_ otai_meta_generic_get_fn get,
+        _In_ uint32_t object_count,
+        _In_ const otai_object_meta_key_t *meta_key,
+        _In_ const uint32_t *attr_count,
+        _Inout_ otai_attribute_t **attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses)
+{
+    if (object_count == 0)
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    if (get == NULL || meta_key == NULL || attr_count == NULL ||
+            attr_list == NULL || object_statuses == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    otai_status_t status = OTAI_STATUS_SUCCESS;
+
+    uint32_t idx = 0;
+
+    while (bulk_get != NULL && idx < object_count)
+    {
+        otai_object_id_t object_id[OTAI_METADATA_BULK_CHUNK_SIZE];
+
+        uint32_t count = otai_metadata_bulk_chunk_count(object_count, idx);
+
+        uint32_t i = 0;
+
+        for (; i < count; ++i)
+        {
+            object_id[i] = meta_key[idx + i].objectkey.key.object_id;
+        }
+
+        otai_status_t st = bulk_get(count, object_id, attr_count + idx,
+                attr_list + idx, mode, object_statuses + idx);
+
+        if (otai_metadata_bulk_is_not_supported(st))
+        {
+            break;
+        }
+
+        idx += count;
+
+        if (st != OTAI_STATUS_SUCCESS)
+        {
+            status = OTAI_STATUS_FAILURE;
+
+            if (mode == OTAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR)
+            {
+                return otai_metadata_bulk_not_executed(idx, object_count, object_statuses);
+            }
+        }
+    }
+
+    for (; idx < object_count; ++idx)
+    {
+        object_statuses[idx] = get(&meta_key[idx], attr_count[idx], attr_list[idx]);
+
+        if (object_statuses[idx] != OTAI_STATUS_SUCCESS)
+        {
+            status = OTAI_STATUS_FAILURE;
+
+            if (mode == OTAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR)
+            {
+                return otai_metadata_bulk_not_executed(idx + 1, object_count, object_statuses);
+            }
+        }
+    }
+
+    return status;
+}
+
+otai_status_t otai_metadata_bulk_get_stats(
+        _In_ otai_bulk_object_get_stats_fn bulk_get_stats,
+        _In_ otai_meta_generic_get_stats_ext_fn get_stats_ext,
+        _In_ uint32_t object_count,
+        _In_ const otai_object_meta_key_t *meta_key,
+        _In_ uint32_t number_of_counters,
+        _In_ const otai_stat_id_t *counter_ids,
+        _In_ otai_stats_mode_t mode,
+        _Out_ otai_status_t *object_statuses,
+        _Out_ otai_stat_value_t *counters)
+{
+    if (object_count == 0)
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    if (get_stats_ext == NULL || meta_key == NULL || counter_ids == NULL ||
+            object_statuses == NULL || counters == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    otai_status_t status = OTAI_STATUS_SUCCESS;
+
+    uint32_t idx = 0;
+
+    while (bulk_get_stats != NULL && idx < object_count)
+    {
+        otai_object_id_t object_id[OTAI_METADATA_BULK_CHUNK_SIZE];
+
+        uint32_t count = otai_metadata_bulk_chunk_count(object_count, idx);
+
+        uint32_t i = 0;
+
+        for (; i < count; ++i)
+        {
+            object_id[i] = meta_key[idx + i].objectkey.key.object_id;
+        }
+
+        otai_status_t st = bulk_get_stats(count, object_id, number_of_counters, counter_ids, mode,
+                object_statuses + idx, counters + (size_t)idx * number_of_counters);
+
+        if (otai_metadata_bulk_is_not_supported(st))
+        {
+            break;
+        }
+
+        idx += count;
+
+        if (st != OTAI_STATUS_SUCCESS)
+        {
+            status = OTAI_STATUS_FAILURE;
+        }
+    }
+
+    for (; idx < object_count; ++idx)
+    {
+        object_statuses[idx] = get_stats_ext(&meta_key[idx], number_of_counters, counter_ids, mode,
+                counters + (size_t)idx * number_of_counters);
+
+        if (object_statuses[idx] != OTAI_STATUS_SUCCESS)
+        {
+            status = OTAI_STATUS_FAILURE;
+        }
+    }
+
+    return status;
+}
+
+#define OTAI_METADATA_DEFAULT_LIST_SIZE 16
+
+/*
+ * Gets count, items and item size of list value, returns false if
+ * attribute value type is not a list.
+ */
+static bool otai_metadata_get_value_list(
+        _In_ const otai_attr_metadata_t *metadata,
+        _In_ const otai_attribute_value_t *value,
+        _Out_ uint32_t *count,
+        _Out_ void **list,
+        _Out_ size_t *item_size)
+{
+    switch (metadata->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            *count = value->objlist.count;
+            *list = value->objlist.list;
+            *item_size = sizeof(otai_object_id_t);
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            *count = value->u8list.count;
+            *list = value->u8list.list;
+            *item_size = sizeof(uint8_t);
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            *count = value->s8list.count;
+            *list = value->s8list.list;
+            *item_size = sizeof(int8_t);
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            *count = value->u16list.count;
+            *list = value->u16list.list;
+            *item_size = sizeof(uint16_t);
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            *count = value->s16list.count;
+            *list = value->s16list.list;
+            *item_size = sizeof(int16_t);
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            *count = value->u32list.count;
+            *list = value->u32list.list;
+            *item_size = sizeof(uint32_t);
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            *count = value->s32list.count;
+            *list = value->s32list.list;
+            *item_size = sizeof(int32_t);
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            *count = value->spectrumpowerlist.count;
+            *list = value->spectrumpowerlist.list;
+            *item_size = sizeof(otai_spectrum_power_t);
+            return true;
+        default:
+            *count = 0;
+            *list = NULL;
+            *item_size = 0;
+            return false;
+    }
+}
+
+static void otai_metadata_set_value_list(
+        _In_ const otai_attr_metadata_t *metadata,
+        _Inout_ otai_attribute_value_t *value,
+        _In_ uint32_t count,
+        _In_ void *list)
+{
+    switch (metadata->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            value->objlist.count = count;
+            value->objlist.list = list;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            value->u8list.count = count;
+            value->u8list.list = list;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            value->s8list.count = count;
+            value->s8list.list = list;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            value->u16list.count = count;
+            value->u16list.list = list;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            value->s16list.count = count;
+            value->s16list.list = list;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            value->u32list.count = count;
+            value->u32list.list = list;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            value->s32list.count = count;
+            value->s32list.list = list;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            value->spectrumpowerlist.count = count;
+            value->spectrumpowerlist.list = list;
+            break;
+        default:
+            break;
+    }
+}
+
+static void* otai_metadata_alloc_list(
+        _In_ const otai_alloc_info_t *info,
+        _In_ uint32_t count,
+        _In_ size_t item_size)
+{
+    if (item_size && count > SIZE_MAX / item_size)
+    {
+        OTAI_META_LOG_ERROR("list of %u items is too large", count);
+        return NULL;
+    }
+
+    size_t size = count * item_size;
+
+    if (info != NULL && info->arena != NULL)
+    {
+        return otai_metadata_arena_alloc(info->arena, size);
+    }
+
+    return calloc(1, size);
+}
+
+static void otai_metadata_free_list(
+        _In_ const otai_alloc_info_t *info,
+        _Inout_ void *list)
+{
+    if (info != NULL && info->arena != NULL)
+    {
+        otai_metadata_arena_free(info->arena, list);
+    }
+    else
+    {
+        free(list);
+    }
+}
+
+otai_status_t otai_metadata_alloc_attr_value(
+        _In_ const otai_attr_metadata_t *metadata,
+        _Inout_ otai_attribute_t *attr,
+        _In_ const otai_alloc_info_t *info)
+{
+    if (metadata == NULL || attr == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t count;
+    void *list;
+    size_t item_size;
+
+    if (!otai_metadata_get_value_list(metadata, &attr->value, &count, &list, &item_size))
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    count = OTAI_METADATA_DEFAULT_LIST_SIZE;
+
+    if (info != NULL && info->reference != NULL)
+    {
+        otai_metadata_get_value_list(metadata, &info->reference->value, &count, &list, &item_size);
+    }
+    else if (info != NULL && info->list_size)
+    {
+        count = info->list_size;
+    }
+
+    list = NULL;
+
+    if (count)
+    {
+        list = otai_metadata_alloc_list(info, count, item_size);
+
+        if (list == NULL)
+        {
+            otai_metadata_set_value_list(metadata, &attr->value, 0, NULL);
+            return OTAI_STATUS_NO_MEMORY;
+        }
+    }
+
+    otai_metadata_set_value_list(metadata, &attr->value, count, list);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_free_attr_value(
+        _In_ const otai_attr_metadata_t *metadata,
+        _Inout_ otai_attribute_t *attr,
+        _In_ const otai_alloc_info_t *info)
+{
+    if (metadata == NULL || attr == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t count;
+    void *list;
+    size_t item_size;
+
+    if (otai_metadata_get_value_list(metadata, &attr->value, &count, &list, &item_size))
+    {
+        otai_metadata_free_list(info, list);
+
+        otai_metadata_set_value_list(metadata, &attr->value, 0, NULL);
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_clear_attr_value(
+        _In_ const otai_attr_metadata_t *metadata,
+        _Inout_ otai_attribute_t *attr)
+{
+    if (metadata == NULL || attr == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t count;
+    void *list;
+    size_t item_size;
+
+    if (!otai_metadata_get_value_list(metadata, &attr->value, &count, &list, &item_size))
+    {
+        memset(&attr->value, 0, sizeof(attr->value));
+    }
+    else if (list != NULL)
+    {
+        memset(list, 0, count * item_size);
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_deepcopy_attr_value_ext(
+        _In_ const otai_attr_metadata_t *metadata,
+        _In_ const otai_attribute_t *src,
+        _Inout_ otai_attribute_t *dest,
+        _In_ const otai_alloc_info_t *info)
+{
+    if (metadata == NULL || src == NULL || dest == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t count;
+    void *list;
+    size_t item_size;
+
+    dest->id = src->id;
+
+    if (!otai_metadata_get_value_list(metadata, &src->value, &count, &list, &item_size))
+    {
+        dest->value = src->value;
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    void *copy = NULL;
+
+    if (list != NULL && count)
+    {
+        copy = otai_metadata_alloc_list(info, count, item_size);
+
+        if (copy == NULL)
+        {
+            otai_metadata_set_value_list(metadata, &dest->value, 0, NULL);
+            return OTAI_STATUS_NO_MEMORY;
+        }
+
+        memcpy(copy, list, count * item_size);
+    }
+
+    otai_metadata_set_value_list(metadata, &dest->value, count, copy);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_metadata_deepcopy_attr_value(
+        _In_ const otai_attr_metadata_t *metadata,
+        _In_ const otai_attribute_t *src,
+        _Inout_ otai_attribute_t *dest)
+{
+    return otai_metadata_deepcopy_attr_value_ext(metadata, src, dest, NULL);
+}
+
+otai_status_t otai_metadata_deepequal_attr_value(
+        _In_ const otai_attr_metadata_t *metadata,
+        _In_ const otai_attribute_t *lhs,
+        _In_ const otai_attribute_t *rhs,
+        _Out_ bool *result)
+{
+    if (metadata == NULL || lhs == NULL || rhs == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    const otai_attribute_value_t *l = &lhs->value;
+    const otai_attribute_value_t *r = &rhs->value;
+
+    uint32_t lcount;
+    uint32_t rcount;
+    void *llist;
+    void *rlist;
+    size_t item_size;
+
+    switch (metadata->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_BOOL:
+            *result = l->booldata == r->booldata;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_CHARDATA:
+            *result = strncmp(l->chardata, r->chardata, sizeof(l->chardata)) == 0;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT8:
+            *result = l->u8 == r->u8;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT8:
+            *result = l->s8 == r->s8;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT16:
+            *result = l->u16 == r->u16;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT16:
+            *result = l->s16 == r->s16;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT32:
+            *result = l->u32 == r->u32;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT32:
+            *result = l->s32 == r->s32;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT64:
+            *result = l->u64 == r->u64;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT64:
+            *result = l->s64 == r->s64;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_DOUBLE:
+            *result = memcmp(&l->d64, &r->d64, sizeof(l->d64)) == 0;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_POINTER:
+            *result = l->ptr == r->ptr;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_ID:
+            *result = l->oid == r->oid;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT32_RANGE:
+            *result = l->u32range.min == r->u32range.min && l->u32range.max == r->u32range.max;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT32_RANGE:
+            *result = l->s32range.min == r->s32range.min && l->s32range.max == r->s32range.max;
+            break;
+
+        default:
+
+            if (!otai_metadata_get_value_list(metadata, l, &lcount, &llist, &item_size))
+            {
+                OTAI_META_LOG_ERROR("attr value type %d is not supported", metadata->attrvaluetype);
+                return OTAI_STATUS_INVALID_PARAMETER;
+            }
+
+            otai_metadata_get_value_list(metadata, r, &rcount, &rlist, &item_size);
+
+            /*
+             * List without items is equal only to list without items.
+             */
+
+            if (lcount != rcount || (llist == NULL) != (rlist == NULL))
+            {
+                *result = false;
+            }
+            else
+            {
+                *result = llist == NULL || memcmp(llist, rlist, lcount * item_size) == 0;
+            }
+
+            break;
+    }
+
+    *result = *result && lhs->id == rhs->id;
+
+    return OTAI_STATUS_SUCCESS;
+}
@@ -22,6 +22,7 @@
 #define __OTAIMETADATAUTILS_H_
 
 #include "otaimetadatatypes.h"
+#include "otaimetadataarena.h"
 
 /**
  * @defgroup OTAIMETADATAUTILS OTAI - Metadata Utilities Definitions
@@ -87,6 +88,21 @@ extern const otai_attr_metadata_t* otai_metadata_get_attr_metadata(
 extern const otai_attr_metadata_t* otai_metadata_get_attr_metadata_by_attr_id_name(
         _In_ const char *attr_id_name);
 
+/**
+ * @brief Gets attribute metadata based on attribute id name and length
+ *
+ * Name don't need to be zero terminated, so it can point directly into
+ * serialized buffer.
+ *
+ * @param[in] attr_id_name Attribute id name
+ * @param[in] length Attribute id name length
+ *
+ * @return Pointer to object metadata or NULL in case of failure
+ */
+extern const otai_attr_metadata_t* otai_metadata_get_attr_metadata_by_attr_id_name_length(
+        _In_ const char *attr_id_name,
+        _In_ size_t length);
+
 /**
  * @brief Gets statistics metadata based on statistics id name
  *
@@ -97,6 +113,85 @@ extern const otai_attr_metadata_t* otai_metadata_get_attr_metadata_by_attr_id_na
 extern const otai_stat_metadata_t* otai_metadata_get_stat_metadata_by_stat_id_name(
         _In_ const char *stat_id_name);
 
+/**
+ * @brief Gets attribute metadata based on attribute kebab name
+ *
+ * Kebab names are unique only within object type, for example
+ * "admin-state" for #OTAI_PORT_ATTR_ADMIN_STATE.
+ *
+ * @param[in] object_type Object type
+ * @param[in] kebab_name Attribute kebab name
+ *
+ * @return Pointer to object metadata or NULL in case of failure
+ */
+extern const otai_attr_metadata_t* otai_metadata_get_attr_metadata_by_attr_id_kebab_name(
+        _In_ otai_object_type_t object_type,
+        _In_ const char *kebab_name);
+
+/**
+ * @brief Gets statistics metadata based on statistics kebab name
+ *
+ * @param[in] object_type Object type
+ * @param[in] kebab_name Statistics kebab name
+ *
+ * @return Pointer to object metadata or NULL in case of failure
+ */
+extern const otai_stat_metadata_t* otai_metadata_get_stat_metadata_by_stat_id_kebab_name(
+        _In_ otai_object_type_t object_type,
+        _In_ const char *kebab_name);
+
+/**
+ * @brief Gets statistics metadata based on statistics camel name
+ *
+ * @param[in] object_type Object type
+ * @param[in] camel_name Statistics camel name
+ *
+ * @return Pointer to object metadata or NULL in case of failure
+ */
+extern const otai_stat_metadata_t* otai_metadata_get_stat_metadata_by_stat_id_camel_name(
+        _In_ otai_object_type_t object_type,
+        _In_ const char *camel_name);
+
+/**
+ * @brief Calculates hash of metadata name
+ *
+ * Must be kept in sync with GetNameHash in utils.pm, since metadata parser
+ * is generating name hash tables using the same function.
+ *
+ * @param[in] seed Hash seed, zero for bucket selection
+ * @param[in] prefix Value mixed into hash before name, for example object type
+ * @param[in] name Name to be hashed, don't need to be NULL terminated
+ * @param[in] length Number of characters to hash
+ *
+ * @return Hash value
+ */
+extern uint32_t otai_metadata_hash_name(
+        _In_ int32_t seed,
+        _In_ int32_t prefix,
+        _In_ const char *name,
+        _In_ size_t length);
+
+/**
+ * @brief Finds candidate index of name in name hash
+ *
+ * Returned index must be verified by caller by comparing name, since perfect
+ * hash is not rejecting names which were not used to generate it.
+ *
+ * @param[in] hash Name hash generated by metadata parser
+ * @param[in] prefix Value mixed into hash before name
+ * @param[in] name Name to be found, don't need to be NULL terminated
+ * @param[in] length Number of characters in name
+ * @param[out] index Candidate index in hashed list
+ *
+ * @return True if candidate was found, false if hash is empty
+ */
+extern bool otai_metadata_name_hash_lookup(
+        _In_ const otai_name_hash_t *hash,
+        _In_ int32_t prefix,
+        _In_ const char *name,
+        _In_ size_t length,
+        _Out_ size_t *index);
+
 /**
  * @brief Gets string representation of enum value
  *
@@ -109,6 +204,36 @@ extern const char* otai_metadata_get_enum_value_name(
         _In_ const otai_enum_metadata_t *metadata,
         _In_ int value);
 
+/**
+ * @brief Gets position of enum value in enum metadata values array
+ *
+ * @param[in] metadata Enum metadata
+ * @param[in] value Enum value to be found
+ * @param[out] index Position of value in values array
+ *
+ * @return True if value was found, false otherwise
+ */
+extern bool otai_metadata_get_enum_value_index(
+        _In_ const otai_enum_metadata_t *metadata,
+        _In_ int value,
+        _Out_ size_t *index);
+
+/**
+ * @brief Gets position of enum value name in enum metadata values array
+ *
+ * @param[in] metadata Enum metadata
+ * @param[in] name Enum value name, don't need to be NULL terminated
+ * @param[in] length Number of characters in name
+ * @param[out] index Position of value in values array
+ *
+ * @return True if value name was found, false otherwise
+ */
+extern bool otai_metadata_get_enum_value_index_by_name(
+        _In_ const otai_enum_metadata_t *metadata,
+        _In_ const char *name,
+        _In_ size_t length,
+        _Out_ size_t *index);
+
 /**
  * @brief Gets attribute from attribute list by attribute id.
  *
@@ -155,6 +280,20 @@ extern bool otai_metadata_is_object_type_valid(
 extern bool otai_metadata_is_object_type_oid(
         _In_ otai_object_type_t object_type);
 
+/**
+ * @brief Check if single condition is met by attribute value.
+ *
+ * @param[in] metadata Metadata of condition attribute.
+ * @param[in] condition Condition to check.
+ * @param[in] value Value of condition attribute, passed by user or default.
+ *
+ * @return True if value is equal to condition value, false otherwise.
+ */
+extern bool otai_metadata_is_condition_value_met(
+        _In_ const otai_attr_metadata_t *metadata,
+        _In_ const otai_attr_condition_t *condition,
+        _In_ const otai_attribute_value_t *value);
+
 /**
  * @brief Check if condition met.
  *
@@ -180,6 +319,139 @@ extern bool otai_metadata_is_condition_met(
         _In_ uint32_t attr_count,
         _In_ const otai_attribute_t *attr_list);
 
+/**
+ * @brief Bulk create objects using generic meta keys
+ *
+ * Object ids are passed to native bulk API in fixed size chunks, so no
+ * allocation is needed. When native bulk API is NULL or reports
+ * #OTAI_STATUS_NOT_IMPLEMENTED or #OTAI_STATUS_NOT_SUPPORTED, remaining
+ * objects are created one by one using generic create function.
+ *
+ * @param[in] bulk_create Native bulk create function, can be NULL
+ * @param[in] create Generic create function
+ * @param[in] linecard_id Linecard Object id
+ * @param[in] object_count Number of objects to create
+ * @param[inout] meta_key List of meta keys, object id will be populated
+ * @param[in] attr_count List of attr_count for every object
+ * @param[in] attr_list List of attributes for every object
+ * @param[in] mode Bulk operation error handling mode
+ * @param[out] object_statuses List of status for every object
+ *
+ * @return #OTAI_STATUS_SUCCESS when all objects succeeded,
+ * #OTAI_STATUS_FAILURE otherwise
+ */
+extern otai_status_t otai_metadata_bulk_create(
+        _In_ otai_bulk_object_create_fn bulk_create,
+        _In_ otai_meta_generic_create_fn create,
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t object_count,
+        _Inout_ otai_object_meta_key_t *meta_key,
+        _In_ const uint32_t *attr_count,
+        _In_ const otai_attribute_t **attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses);
+
+/**
+ * @brief Bulk remove objects using generic meta keys
+ *
+ * @param[in] bulk_remove Native bulk remove function, can be NULL
+ * @param[in] remove Generic remove function
+ * @param[in] object_count Number of objects to remove
+ * @param[in] meta_key List of meta keys
+ * @param[in] mode Bulk operation error handling mode
+ * @param[out] object_statuses List of status for every object
+ *
+ * @return #OTAI_STATUS_SUCCESS when all objects succeeded,
+ * #OTAI_STATUS_FAILURE otherwise
+ */
+extern otai_status_t otai_metadata_bulk_remove(
+        _In_ otai_bulk_object_remove_fn bulk_remove,
+        _In_ otai_meta_generic_remove_fn remove,
+        _In_ uint32_t object_count,
+        _In_ const otai_object_meta_key_t *meta_key,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses);
+
+/**
+ * @brief Bulk set attribute using generic meta keys
+ *
+ * @param[in] bulk_set Native bulk set function, can be NULL
+ * @param[in] set Generic set function
+ * @param[in] object_count Number of objects to set attribute
+ * @param[in] meta_key List of meta keys
+ * @param[in] attr_list List of attributes, one attribute per object
+ * @param[in] mode Bulk operation error handling mode
+ * @param[out] object_statuses List of status for every object
+ *
+ * @return #OTAI_STATUS_SUCCESS when all objects succeeded,
+ * #OTAI_STATUS_FAILURE otherwise
+ */
+extern otai_status_t otai_metadata_bulk_set(
+        _In_ otai_bulk_object_set_attribute_fn bulk_set,
+        _In_ otai_meta_generic_set_fn set,
+        _In_ uint32_t object_count,
+        _In_ const otai_object_meta_key_t *meta_key,
+        _In_ const otai_attribute_t *attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses);
+
+/**
+ * @brief Bulk get attributes using generic meta keys
+ *
+ * @param[in] bulk_get Native bulk get function, can be NULL
+ * @param[in] get Generic get function
+ * @param[in] object_count Number of objects to get attributes
+ * @param[in] meta_key List of meta keys
+ * @param[in] attr_count List of attr_count for every object
+ * @param[inout] attr_list List of attributes for every object
+ * @param[in] mode Bulk operation error handling mode
+ * @param[out] object_statuses List of status for every object
+ *
+ * @return #OTAI_STATUS_SUCCESS when all objects succeeded,
+ * #OTAI_STATUS_FAILURE otherwise
+ */
+extern otai_status_t otai_metadata_bulk_get(
+        _In_ otai_bulk_object_get_attribute_fn bulk_get,
+        _In_ otai_meta_generic_get_fn get,
+        _In_ uint32_t object_count,
+        _In_ const otai_object_meta_key_t *meta_key,
+        _In_ const uint32_t *attr_count,
+        _Inout_ otai_attribute_t **attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses);
+
+/**
+ * @brief Bulk get statistics using generic meta keys
+ *
+ * Counters are returned as object_count x number_of_counters matrix in row
+ * major order. When native bulk API is NULL or reports
+ * #OTAI_STATUS_NOT_IMPLEMENTED or #OTAI_STATUS_NOT_SUPPORTED, remaining
+ * objects are read one by one using generic get stats extended function.
+ *
+ * @param[in] bulk_get_stats Native bulk get stats function, can be NULL
+ * @param[in] get_stats_ext Generic get stats extended function
+ * @param[in] object_count Number of objects to get statistics
+ * @param[in] meta_key List of meta keys
+ * @param[in] number_of_counters Number of counters in the array
+ * @param[in] counter_ids Specifies the array of counter ids
+ * @param[in] mode Statistics mode
+ * @param[out] object_statuses List of status for every object
+ * @param[out] counters Array of resulting counter values
+ *
+ * @return #OTAI_STATUS_SUCCESS when all objects succeeded,
+ * #OTAI_STATUS_FAILURE otherwise
+ */
+extern otai_status_t otai_metadata_bulk_get_stats(
+        _In_ otai_bulk_object_get_stats_fn bulk_get_stats,
+        _In_ otai_meta_generic_get_stats_ext_fn get_stats_ext,
+        _In_ uint32_t object_count,
+        _In_ const otai_object_meta_key_t *meta_key,
+        _In_ uint32_t number_of_counters,
+        _In_ const otai_stat_id_t *counter_ids,
+        _In_ otai_stats_mode_t mode,
+        _Out_ otai_status_t *object_statuses,
+        _Out_ otai_stat_value_t *counters);
+
 /**
  * @brief Allocation info
  *
@@ -193,6 +465,11 @@ typedef struct _otai_alloc_info_t
      * @brief Reference attribute for size information
      */
     const otai_attribute_t *reference;
+
+    /**
+     * @brief Arena for list values, NULL to use calloc and free
+     */
+    otai_metadata_arena_t *arena;
 } otai_alloc_info_t;
 
 /**
@@ -202,7 +479,7 @@ typedef struct _otai_alloc_info_t
  * allocation
  *
  * @param[in] metadata Attribute metadata
- * @param[in] attr Attribute to allocate
+ * @param[inout] attr Attribute to allocate
  * @param[in] info Allocation information
  *
  * @return #OTAI_STATUS_SUCCESS on success,
@@ -210,14 +487,14 @@ typedef struct _otai_alloc_info_t
  */
 extern otai_status_t otai_metadata_alloc_attr_value(
         _In_ const otai_attr_metadata_t *metadata,
-        _In_ const otai_attribute_t *attr,
+        _Inout_ otai_attribute_t *attr,
         _In_ const otai_alloc_info_t *info);
 
 /**
  * @brief Free otai_attribute_t value
  *
  * @param[in] metadata Attribute metadata
- * @param[in] attr Attribute to free
+ * @param[inout] attr Attribute to free
  * @param[in] info Allocation information
  *
  * @return #OTAI_STATUS_SUCCESS on success,
@@ -225,21 +502,21 @@ extern otai_status_t otai_metadata_alloc_attr_value(
  */
 extern otai_status_t otai_metadata_free_attr_value(
         _In_ const otai_attr_metadata_t *metadata,
-        _In_ const otai_attribute_t *attr,
+        _Inout_ otai_attribute_t *attr,
         _In_ const otai_alloc_info_t *info);
 
 /**
  * @brief Clear otai_attribute_t value
  *
  * @param[in] metadata Attribute metadata
- * @param[in] attr Attribute to clear
+ * @param[inout] attr Attribute to clear
  *
  * @return #OTAI_STATUS_SUCCESS on success,
  * #OTAI_STATUS_INVALID_PARAMETER on failure
  */
 extern otai_status_t otai_metadata_clear_attr_value(
         _In_ const otai_attr_metadata_t *metadata,
-        _In_ const otai_attribute_t *attr);
+        _Inout_ otai_attribute_t *attr);
 
 /**
  * @brief Deep copy otai_attribute_t value
@@ -256,6 +533,25 @@ extern otai_status_t otai_metadata_deepcopy_attr_value(
         _In_ const otai_attribute_t *src,
         _Inout_ otai_attribute_t *dest);
 
+/**
+ * @brief Deep copy otai_attribute_t value with allocation info
+ *
+ * List values are allocated from info arena, if it is set.
+ *
+ * @param[in] metadata Attribute metadata
+ * @param[in] src Original attribute for the copy
+ * @param[inout] dest Destination for the copy
+ * @param[in] info Allocation information
+ *
+ * @return #OTAI_STATUS_SUCCESS on success,
+ * #OTAI_STATUS_INVALID_PARAMETER on failure
+ */
+extern otai_status_t otai_metadata_deepcopy_attr_value_ext(
+        _In_ const otai_attr_metadata_t *metadata,
+        _In_ const otai_attribute_t *src,
+        _Inout_ otai_attribute_t *dest,
+        _In_ const otai_alloc_info_t *info);
+
 /**
  * @brief Deep equal otai_attribute_t value
  *
@@ -0,0 +1,275 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatavalidation.c
+ *
+ * @brief   This module implements OTAI Metadata attribute list validation
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <otai.h>
+#include "otaimetadatautils.h"
+#include "otaimetadatalogger.h"
+#include "otaimetadatavalidation.h"
+
+#define OTAI_METADATA_VALIDATION_MAX_SLOT 0xFFFF
+
+static bool otai_metadata_validation_context_get_offset(
+        _In_ const otai_metadata_validation_context_t *context,
+        _In_ otai_attr_id_t attr_id,
+        _Out_ uint32_t *offset)
+{
+    if (attr_id < context->info->attridstart)
+    {
+        return false;
+    }
+
+    *offset = attr_id - context->info->attridstart;
+
+    return *offset < OTAI_METADATA_VALIDATION_MAX_INDEXED_ATTRS;
+}
+
+static bool otai_metadata_validation_context_is_present(
+        _In_ const otai_metadata_validation_context_t *context,
+        _In_ uint32_t offset)
+{
+    return (context->present[offset / 64] >> (offset % 64)) & 1;
+}
+
+otai_status_t otai_metadata_validation_context_init(
+        _Out_ otai_metadata_validation_context_t *context,
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    memset(context->present, 0, sizeof(context->present));
+
+    context->info = otai_metadata_get_object_type_info(object_type);
+    context->attrcount = attr_count;
+    context->attrlist = attr_list;
+    context->hasunindexed = false;
+
+    if (context->info == NULL)
+    {
+        OTAI_META_LOG_ERROR("invalid object type %d", object_type);
+
+        return OTAI_STATUS_INVALID_OBJECT_TYPE;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < attr_count; ++idx)
+    {
+        otai_attr_id_t id = attr_list[idx].id;
+
+        uint32_t offset;
+
+        if (idx <= OTAI_METADATA_VALIDATION_MAX_SLOT &&
+                otai_metadata_validation_context_get_offset(context, id, &offset))
+        {
+            if (otai_metadata_validation_context_is_present(context, offset))
+            {
+                OTAI_META_LOG_ERROR("attribute id 0x%x is passed more than once", id);
+
+                return OTAI_METADATA_VALIDATION_ATTR_STATUS(OTAI_STATUS_INVALID_ATTRIBUTE_0, idx);
+            }
+
+            context->present[offset / 64] |= (uint64_t)1 << (offset % 64);
+            context->slot[offset] = (uint16_t)idx;
+
+            continue;
+        }
+
+        /*
+         * Custom range attributes and attributes beyond indexed range are
+         * rare, they are searched on the list.
+         */
+
+        if (otai_metadata_get_attr_by_id(id, idx, attr_list) != NULL)
+        {
+            OTAI_META_LOG_ERROR("attribute id 0x%x is passed more than once", id);
+
+            return OTAI_METADATA_VALIDATION_ATTR_STATUS(OTAI_STATUS_INVALID_ATTRIBUTE_0, idx);
+        }
+
+        context->hasunindexed = true;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+const otai_attribute_t* otai_metadata_validation_context_get_attr(
+        _In_ const otai_metadata_validation_context_t *context,
+        _In_ otai_attr_id_t attr_id)
+{
+    uint32_t offset;
+
+    if (otai_metadata_validation_context_get_offset(context, attr_id, &offset) &&
+            otai_metadata_validation_context_is_present(context, offset))
+    {
+        return &context->attrlist[context->slot[offset]];
+    }
+
+    if (!context->hasunindexed)
+    {
+        return NULL;
+    }
+
+    return otai_metadata_get_attr_by_id(attr_id, context->attrcount, context->attrlist);
+}
+
+static bool otai_metadata_validation_context_conditions_met(
+        _In_ const otai_metadata_validation_context_t *context,
+        _In_ otai_object_type_t object_type,
+        _In_ otai_attr_condition_type_t condition_type,
+        _In_ const otai_attr_condition_t* const *conditions,
+        _In_ size_t length)
+{
+    size_t idx = 0;
+
+    bool met = (condition_type == OTAI_ATTR_CONDITION_TYPE_AND);
+
+    for (; idx < length; ++idx)
+    {
+        const otai_attr_condition_t *condition = conditions[idx];
+
+        const otai_attr_metadata_t *cmd = otai_metadata_get_attr_metadata(object_type, condition->attrid);
+
+        const otai_attribute_t *cattr = otai_metadata_validation_context_get_attr(context, condition->attrid);
+
+        const otai_attribute_value_t *cvalue = (cattr == NULL) ? cmd->defaultvalue : &cattr->value;
+
+        if (cvalue == NULL)
+        {
+            /*
+             * There is no default value and user didn't passed attribute.
+             */
+
+            if (condition_type == OTAI_ATTR_CONDITION_TYPE_AND)
+            {
+                return false;
+            }
+
+            continue;
+        }
+
+        bool current = otai_metadata_is_condition_value_met(cmd, condition, cvalue);
+
+        if (condition_type == OTAI_ATTR_CONDITION_TYPE_AND)
+        {
+            met &= current;
+        }
+        else /* OR */
+        {
+            met |= current;
+        }
+    }
+
+    return met;
+}
+
+bool otai_metadata_validation_context_is_condition_met(
+        _In_ const otai_metadata_validation_context_t *context,
+        _In_ const otai_attr_metadata_t *metadata)
+{
+    if (metadata == NULL || !metadata->isconditional || context->info == NULL)
+    {
+        return false;
+    }
+
+    return otai_metadata_validation_context_conditions_met(context, metadata->objecttype,
+            metadata->conditiontype, metadata->conditions, metadata->conditionslength);
+}
+
+bool otai_metadata_validation_context_is_validonly_met(
+        _In_ const otai_metadata_validation_context_t *context,
+        _In_ const otai_attr_metadata_t *metadata)
+{
+    if (metadata == NULL || !metadata->isvalidonly || context->info == NULL)
+    {
+        return false;
+    }
+
+    return otai_metadata_validation_context_conditions_met(context, metadata->objecttype,
+            metadata->validonlytype, metadata->validonly, metadata->validonlylength);
+}
+
+otai_status_t otai_metadata_validation_context_check_create(
+        _In_ const otai_metadata_validation_context_t *context)
+{
+    if (context->info == NULL)
+    {
+        return OTAI_STATUS_INVALID_OBJECT_TYPE;
+    }
+
+    otai_object_type_t object_type = context->info->objecttype;
+
+    uint32_t idx = 0;
+
+    for (; idx < context->attrcount; ++idx)
+    {
+        otai_attr_id_t id = context->attrlist[idx].id;
+
+        const otai_attr_metadata_t *md = otai_metadata_get_attr_metadata(object_type, id);
+
+        if (md == NULL)
+        {
+            OTAI_META_LOG_ERROR("unable to find attribute metadata %d:0x%x", object_type, id);
+
+            return OTAI_METADATA_VALIDATION_ATTR_STATUS(OTAI_STATUS_UNKNOWN_ATTRIBUTE_0, idx);
+        }
+
+        if (md->isconditional && !otai_metadata_validation_context_is_condition_met(context, md))
+        {
+            OTAI_META_LOG_ERROR("attribute %s passed, but condition is not met", md->attridname);
+
+            return OTAI_METADATA_VALIDATION_ATTR_STATUS(OTAI_STATUS_INVALID_ATTRIBUTE_0, idx);
+        }
+
+        if (md->isvalidonly && !otai_metadata_validation_context_is_validonly_met(context, md))
+        {
+            OTAI_META_LOG_NOTICE("attribute %s passed, but valid only condition is not met, it will be ignored", md->attridname);
+        }
+    }
+
+    size_t index = 0;
+
+    for (; index < context->info->attrmetadatalength; ++index)
+    {
+        const otai_attr_metadata_t *md = context->info->attrmetadata[index];
+
+        if (!md->ismandatoryoncreate)
+        {
+            continue;
+        }
+
+        if (otai_metadata_validation_context_get_attr(context, md->attrid) != NULL)
+        {
+            continue;
+        }
+
+        if (md->isconditional && !otai_metadata_validation_context_is_condition_met(context, md))
+        {
+            continue;
+        }
+
+        OTAI_META_LOG_ERROR("attribute %s is mandatory on create, but it is missing", md->attridname);
+
+        return OTAI_STATUS_MANDATORY_ATTRIBUTE_MISSING;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
@@ -0,0 +1,169 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaimetadatavalidation.h
+ *
+ * @brief   This module defines OTAI Metadata attribute list validation
+ */
+
+#ifndef __OTAIMETADATAVALIDATION_H_
+#define __OTAIMETADATAVALIDATION_H_
+
+#include "otaimetadatatypes.h"
+
+/**
+ * @defgroup OTAIMETADATAVALIDATION OTAI - Metadata attribute list validation
+ *
+ * Validation context indexes attribute list once, so attribute lookup by
+ * id during condition evaluation is constant time instead of list scan.
+ *
+ * @{
+ */
+
+/**
+ * @def OTAI_METADATA_VALIDATION_MAX_INDEXED_ATTRS
+ *
+ * Number of attribute ids from object type attribute start, which are
+ * indexed. Other ids, like custom range attributes, are searched on list.
+ */
+#define OTAI_METADATA_VALIDATION_MAX_INDEXED_ATTRS 256
+
+/**
+ * @def OTAI_METADATA_VALIDATION_ATTR_STATUS
+ *
+ * Status code of attribute at index, like #OTAI_STATUS_INVALID_ATTRIBUTE_0
+ * plus index. Only 16 bits of index are available.
+ */
+#define OTAI_METADATA_VALIDATION_ATTR_STATUS(_base, _idx) \
+    ((otai_status_t)((_base) - (otai_status_t)((_idx) & 0xFFFF)))
+
+/**
+ * @brief Attribute list validation context.
+ */
+typedef struct _otai_metadata_validation_context_t
+{
+    /**
+     * @brief Object type info.
+     */
+    const otai_object_type_info_t*               info;
+
+    /**
+     * @brief Number of attributes on the list.
+     */
+    otai_uint32_t                                attrcount;
+
+    /**
+     * @brief Indexed attribute list.
+     */
+    const otai_attribute_t*                      attrlist;
+
+    /**
+     * @brief Indicates that some attributes on the list are not indexed.
+     */
+    bool                                         hasunindexed;
+
+    /**
+     * @brief Bitmap of attribute ids present on the list.
+     */
+    uint64_t                                     present[OTAI_METADATA_VALIDATION_MAX_INDEXED_ATTRS / 64];
+
+    /**
+     * @brief Attribute list index for each present attribute id.
+     */
+    uint16_t                                     slot[OTAI_METADATA_VALIDATION_MAX_INDEXED_ATTRS];
+
+} otai_metadata_validation_context_t;
+
+/**
+ * @brief Index attribute list
+ *
+ * Attribute list is not copied, it must be valid as long as context is
+ * used.
+ *
+ * @param[out] context Validation context
+ * @param[in] object_type Object type of attributes
+ * @param[in] attr_count Number of attributes
+ * @param[in] attr_list Attribute list
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_OBJECT_TYPE
+ * if object type is invalid, #OTAI_STATUS_INVALID_ATTRIBUTE_0 plus index
+ * of attribute which is on the list more than once
+ */
+extern otai_status_t otai_metadata_validation_context_init(
+        _Out_ otai_metadata_validation_context_t *context,
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list);
+
+/**
+ * @brief Get attribute from indexed list
+ *
+ * @param[in] context Validation context
+ * @param[in] attr_id Attribute id
+ *
+ * @return Attribute or NULL if attribute is not on the list
+ */
+extern const otai_attribute_t* otai_metadata_validation_context_get_attr(
+        _In_ const otai_metadata_validation_context_t *context,
+        _In_ otai_attr_id_t attr_id);
+
+/**
+ * @brief Check if condition met on indexed list
+ *
+ * Same as otai_metadata_is_condition_met(), but condition attributes
+ * are found in constant time.
+ *
+ * @param[in] context Validation context
+ * @param[in] metadata Metadata of conditional attribute
+ *
+ * @return True if condition is in force, false otherwise
+ */
+extern bool otai_metadata_validation_context_is_condition_met(
+        _In_ const otai_metadata_validation_context_t *context,
+        _In_ const otai_attr_metadata_t *metadata);
+
+/**
+ * @brief Check if valid only condition met on indexed list
+ *
+ * @param[in] context Validation context
+ * @param[in] metadata Metadata of valid only attribute
+ *
+ * @return True if valid only condition is in force, false otherwise
+ */
+extern bool otai_metadata_validation_context_is_validonly_met(
+        _In_ const otai_metadata_validation_context_t *context,
+        _In_ const otai_attr_metadata_t *metadata);
+
+/**
+ * @brief Validate attribute list for create
+ *
+ * Conditional attributes must have condition met, mandatory on create
+ * attributes must be on the list (conditional ones only when condition is
+ * met). Valid only attributes with condition not met are logged, since
+ * they are ignored by create.
+ *
+ * @param[in] context Validation context
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_UNKNOWN_ATTRIBUTE_0
+ * or #OTAI_STATUS_INVALID_ATTRIBUTE_0 plus attribute index, or
+ * #OTAI_STATUS_MANDATORY_ATTRIBUTE_MISSING on failure
+ */
+extern otai_status_t otai_metadata_validation_context_check_create(
+        _In_ const otai_metadata_validation_context_t *context);
+
+/**
+ * @}
+ */
+#endif /** __OTAIMETADATAVALIDATION_H_ */
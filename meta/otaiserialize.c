@@ -18,12 +18,16 @@
  * @brief   This file implements basic serialization functions for OTAI attributes
  */
 
+/* strtod_l is not declared in strict ANSI mode */
+#define _GNU_SOURCE
+
 #include <arpa/inet.h>
 #include <byteswap.h>
 #include <ctype.h>
 #include <errno.h>
 #include <inttypes.h>
 #include <limits.h>
+#include <locale.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -169,11 +173,82 @@ int otai_deserialize_chardata(
     return OTAI_SERIALIZE_ERROR;
 }
 
+/*
+ * Two digits per table entry, so integer is written with one division by
+ * 100 per two characters instead of printf format parsing.
+ */
+static const char otai_serialize_digit_pairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+static const char otai_serialize_hex_digits[] = "0123456789abcdef";
+
+static int otai_serialize_uint64_digits(
+        _Out_ char *buffer,
+        _In_ uint64_t u64)
+{
+    char tmp[20];
+    char *p = tmp + sizeof(tmp);
+
+    while (u64 >= 100)
+    {
+        const char *pair = &otai_serialize_digit_pairs[(u64 % 100) * 2];
+
+        u64 /= 100;
+        p -= 2;
+        p[0] = pair[0];
+        p[1] = pair[1];
+    }
+
+    if (u64 >= 10)
+    {
+        const char *pair = &otai_serialize_digit_pairs[u64 * 2];
+
+        p -= 2;
+        p[0] = pair[0];
+        p[1] = pair[1];
+    }
+    else
+    {
+        *--p = (char)('0' + u64);
+    }
+
+    size_t len = (size_t)(tmp + sizeof(tmp) - p);
+
+    memcpy(buffer, p, len);
+
+    buffer[len] = 0;
+
+    return (int)len;
+}
+
+static int otai_serialize_int64_digits(
+        _Out_ char *buffer,
+        _In_ int64_t s64)
+{
+    if (s64 < 0)
+    {
+        *buffer = '-';
+
+        return 1 + otai_serialize_uint64_digits(buffer + 1, (uint64_t)0 - (uint64_t)s64);
+    }
+
+    return otai_serialize_uint64_digits(buffer, (uint64_t)s64);
+}
+
 int otai_serialize_uint8(
         _Out_ char *buffer,
         _In_ uint8_t u8)
 {
-    return sprintf(buffer, "%u", u8);
+    return otai_serialize_uint64_digits(buffer, u8);
 }
 
 int otai_deserialize_uint8(
@@ -198,7 +273,7 @@ int otai_serialize_int8(
         _Out_ char *buffer,
         _In_ int8_t u8)
 {
-    return sprintf(buffer, "%d", u8);
+    return otai_serialize_int64_digits(buffer, u8);
 }
 
 int otai_deserialize_int8(
@@ -223,7 +298,7 @@ int otai_serialize_uint16(
         _Out_ char *buffer,
         _In_ uint16_t u16)
 {
-    return sprintf(buffer, "%u", u16);
+    return otai_serialize_uint64_digits(buffer, u16);
 }
 
 int otai_deserialize_uint16(
@@ -248,7 +323,7 @@ int otai_serialize_int16(
         _Out_ char *buffer,
         _In_ int16_t s16)
 {
-    return sprintf(buffer, "%d", s16);
+    return otai_serialize_int64_digits(buffer, s16);
 }
 
 int otai_deserialize_int16(
@@ -273,7 +348,7 @@ int otai_serialize_uint32(
         _Out_ char *buffer,
         _In_ uint32_t u32)
 {
-    return sprintf(buffer, "%u", u32);
+    return otai_serialize_uint64_digits(buffer, u32);
 }
 
 int otai_deserialize_uint32(
@@ -298,7 +373,7 @@ int otai_serialize_int32(
         _Out_ char *buffer,
         _In_ int32_t s32)
 {
-    return sprintf(buffer, "%d", s32);
+    return otai_serialize_int64_digits(buffer, s32);
 }
 
 int otai_deserialize_int32(
@@ -323,7 +398,7 @@ int otai_serialize_uint64(
         _Out_ char *buffer,
         _In_ uint64_t u64)
 {
-    return sprintf(buffer, "%" PRIu64, u64);
+    return otai_serialize_uint64_digits(buffer, u64);
 }
 
 #define OTAI_BASE_10 10
@@ -370,7 +445,7 @@ int otai_serialize_int64(
         _Out_ char *buffer,
         _In_ int64_t s64)
 {
-    return sprintf(buffer, "%" PRId64, s64);
+    return otai_serialize_int64_digits(buffer, s64);
 }
 
 int otai_deserialize_int64(
@@ -446,7 +521,7 @@ int otai_serialize_size(
         _Out_ char *buffer,
         _In_ otai_size_t size)
 {
-    return sprintf(buffer, "%zu", size);
+    return otai_serialize_uint64_digits(buffer, size);
 }
 
 int otai_deserialize_size(
@@ -471,187 +546,2568 @@ int otai_serialize_object_id(
         _Out_ char *buffer,
         _In_ otai_object_id_t oid)
 {
-    return sprintf(buffer, "oid:0x%" PRIx64, oid);
-}
+    memcpy(buffer, "oid:0x", 6);
 
-int otai_serialize_double(
-        _Out_ char *buffer,
-        _In_ otai_double_t d64)
-{
-    return sprintf(buffer, "%.2lf", d64);
+    int len = 1;
+
+    while (len < 16 && (oid >> (4 * len)) != 0)
+    {
+        len++;
+    }
+
+    int idx = len;
+
+    for (; idx > 0; oid >>= 4)
+    {
+        buffer[6 + --idx] = otai_serialize_hex_digits[oid & 0xf];
+    }
+
+    buffer[6 + len] = 0;
+
+    return 6 + len;
 }
 
-int otai_deserialize_double(
-        _In_ const char *buffer,
-        _Out_ otai_double_t *d64)
+/*
+ * Shortest round trip double formatting, this is Grisu2 algorithm by
+ * Florian Loitsch, which generates shortest digit string which parses back
+ * to the same double in almost all cases, and in remaining ones string
+ * which is one digit longer but still round trips.
+ */
+
+typedef struct _otai_serialize_diy_fp_t
 {
-    return sscanf(buffer, "%lf", d64);
-}
+    uint64_t f;
 
-int otai_serialize_pointer(
-        _Out_ char *buffer,
-        _In_ otai_pointer_t ptr)
+    int e;
+
+} otai_serialize_diy_fp_t;
+
+typedef struct _otai_serialize_cached_power_t
 {
-    return sprintf(buffer, "%p", ptr);
-}
+    uint64_t f;
 
-int otai_deserialize_pointer(
-        _In_ const char *buffer,
-        _Out_ otai_pointer_t *pointer)
+    int e;
+
+    int k;
+
+} otai_serialize_cached_power_t;
+
+/*
+ * Normalized 10^k values, for k from -300 to 324 with step 8.
+ */
+static const otai_serialize_cached_power_t otai_serialize_cached_powers[] = {
+    { UINT64_C(0xAB70FE17C79AC6CA), -1060, -300 },
+    { UINT64_C(0xFF77B1FCBEBCDC4F), -1034, -292 },
+    { UINT64_C(0xBE5691EF416BD60C), -1007, -284 },
+    { UINT64_C(0x8DD01FAD907FFC3C),  -980, -276 },
+    { UINT64_C(0xD3515C2831559A83),  -954, -268 },
+    { UINT64_C(0x9D71AC8FADA6C9B5),  -927, -260 },
+    { UINT64_C(0xEA9C227723EE8BCB),  -901, -252 },
+    { UINT64_C(0xAECC49914078536D),  -874, -244 },
+    { UINT64_C(0x823C12795DB6CE57),  -847, -236 },
+    { UINT64_C(0xC21094364DFB5637),  -821, -228 },
+    { UINT64_C(0x9096EA6F3848984F),  -794, -220 },
+    { UINT64_C(0xD77485CB25823AC7),  -768, -212 },
+    { UINT64_C(0xA086CFCD97BF97F4),  -741, -204 },
+    { UINT64_C(0xEF340A98172AACE5),  -715, -196 },
+    { UINT64_C(0xB23867FB2A35B28E),  -688, -188 },
+    { UINT64_C(0x84C8D4DFD2C63F3B),  -661, -180 },
+    { UINT64_C(0xC5DD44271AD3CDBA),  -635, -172 },
+    { UINT64_C(0x936B9FCEBB25C996),  -608, -164 },
+    { UINT64_C(0xDBAC6C247D62A584),  -582, -156 },
+    { UINT64_C(0xA3AB66580D5FDAF6),  -555, -148 },
+    { UINT64_C(0xF3E2F893DEC3F126),  -529, -140 },
+    { UINT64_C(0xB5B5ADA8AAFF80B8),  -502, -132 },
+    { UINT64_C(0x87625F056C7C4A8B),  -475, -124 },
+    { UINT64_C(0xC9BCFF6034C13053),  -449, -116 },
+    { UINT64_C(0x964E858C91BA2655),  -422, -108 },
+    { UINT64_C(0xDFF9772470297EBD),  -396, -100 },
+    { UINT64_C(0xA6DFBD9FB8E5B88F),  -369,  -92 },
+    { UINT64_C(0xF8A95FCF88747D94),  -343,  -84 },
+    { UINT64_C(0xB94470938FA89BCF),  -316,  -76 },
+    { UINT64_C(0x8A08F0F8BF0F156B),  -289,  -68 },
+    { UINT64_C(0xCDB02555653131B6),  -263,  -60 },
+    { UINT64_C(0x993FE2C6D07B7FAC),  -236,  -52 },
+    { UINT64_C(0xE45C10C42A2B3B06),  -210,  -44 },
+    { UINT64_C(0xAA242499697392D3),  -183,  -36 },
+    { UINT64_C(0xFD87B5F28300CA0E),  -157,  -28 },
+    { UINT64_C(0xBCE5086492111AEB),  -130,  -20 },
+    { UINT64_C(0x8CBCCC096F5088CC),  -103,  -12 },
+    { UINT64_C(0xD1B71758E219652C),   -77,   -4 },
+    { UINT64_C(0x9C40000000000000),   -50,    4 },
+    { UINT64_C(0xE8D4A51000000000),   -24,   12 },
+    { UINT64_C(0xAD78EBC5AC620000),     3,   20 },
+    { UINT64_C(0x813F3978F8940984),    30,   28 },
+    { UINT64_C(0xC097CE7BC90715B3),    56,   36 },
+    { UINT64_C(0x8F7E32CE7BEA5C70),    83,   44 },
+    { UINT64_C(0xD5D238A4ABE98068),   109,   52 },
+    { UINT64_C(0x9F4F2726179A2245),   136,   60 },
+    { UINT64_C(0xED63A231D4C4FB27),   162,   68 },
+    { UINT64_C(0xB0DE65388CC8ADA8),   189,   76 },
+    { UINT64_C(0x83C7088E1AAB65DB),   216,   84 },
+    { UINT64_C(0xC45D1DF942711D9A),   242,   92 },
+    { UINT64_C(0x924D692CA61BE758),   269,  100 },
+    { UINT64_C(0xDA01EE641A708DEA),   295,  108 },
+    { UINT64_C(0xA26DA3999AEF774A),   322,  116 },
+    { UINT64_C(0xF209787BB47D6B85),   348,  124 },
+    { UINT64_C(0xB454E4A179DD1877),   375,  132 },
+    { UINT64_C(0x865B86925B9BC5C2),   402,  140 },
+    { UINT64_C(0xC83553C5C8965D3D),   428,  148 },
+    { UINT64_C(0x952AB45CFA97A0B3),   455,  156 },
+    { UINT64_C(0xDE469FBD99A05FE3),   481,  164 },
+    { UINT64_C(0xA59BC234DB398C25),   508,  172 },
+    { UINT64_C(0xF6C69A72A3989F5C),   534,  180 },
+    { UINT64_C(0xB7DCBF5354E9BECE),   561,  188 },
+    { UINT64_C(0x88FCF317F22241E2),   588,  196 },
+    { UINT64_C(0xCC20CE9BD35C78A5),   614,  204 },
+    { UINT64_C(0x98165AF37B2153DF),   641,  212 },
+    { UINT64_C(0xE2A0B5DC971F303A),   667,  220 },
+    { UINT64_C(0xA8D9D1535CE3B396),   694,  228 },
+    { UINT64_C(0xFB9B7CD9A4A7443C),   720,  236 },
+    { UINT64_C(0xBB764C4CA7A44410),   747,  244 },
+    { UINT64_C(0x8BAB8EEFB6409C1A),   774,  252 },
+    { UINT64_C(0xD01FEF10A657842C),   800,  260 },
+    { UINT64_C(0x9B10A4E5E9913129),   827,  268 },
+    { UINT64_C(0xE7109BFBA19C0C9D),   853,  276 },
+    { UINT64_C(0xAC2820D9623BF429),   880,  284 },
+    { UINT64_C(0x80444B5E7AA7CF85),   907,  292 },
+    { UINT64_C(0xBF21E44003ACDD2D),   933,  300 },
+    { UINT64_C(0x8E679C2F5E44FF8F),   960,  308 },
+    { UINT64_C(0xD433179D9C8CB841),   986,  316 },
+    { UINT64_C(0x9E19DB92B4E31BA9),  1013,  324 },
+};
+
+#define OTAI_SERIALIZE_CACHED_POWERS_MIN_DEC_EXP (-300)
+#define OTAI_SERIALIZE_CACHED_POWERS_DEC_STEP 8
+
+/*
+ * Scaled value binary exponent is kept in [alpha, gamma] range, so integral
+ * part of scaled value fits in 32 bits.
+ */
+#define OTAI_SERIALIZE_GRISU_ALPHA (-60)
+
+static otai_serialize_diy_fp_t otai_serialize_diy_fp_mul(
+        _In_ otai_serialize_diy_fp_t x,
+        _In_ otai_serialize_diy_fp_t y)
 {
-    int read;
+    const uint64_t mask = 0xFFFFFFFFu;
 
-    int n = sscanf(buffer, "ptr:%p%n", pointer, &read);
+    uint64_t p0 = (x.f & mask) * (y.f & mask);
+    uint64_t p1 = (x.f & mask) * (y.f >> 32);
+    uint64_t p2 = (x.f >> 32) * (y.f & mask);
+    uint64_t p3 = (x.f >> 32) * (y.f >> 32);
 
-    if (n == 1 && otai_serialize_is_char_allowed(buffer[read]))
+    uint64_t q = (p0 >> 32) + (p1 & mask) + (p2 & mask) + (UINT64_C(1) << 31);
+
+    otai_serialize_diy_fp_t r;
+
+    r.f = p3 + (p1 >> 32) + (p2 >> 32) + (q >> 32);
+    r.e = x.e + y.e + 64;
+
+    return r;
+}
+
+static otai_serialize_diy_fp_t otai_serialize_diy_fp_normalize(
+        _In_ otai_serialize_diy_fp_t x)
+{
+    while ((x.f >> 63) == 0)
     {
-        return read;
+        x.f <<= 1;
+        x.e--;
     }
 
-    OTAI_META_LOG_WARN("failed to deserialize '%.*s' as pointer", MAX_CHARS_PRINT, buffer);
-    return OTAI_SERIALIZE_ERROR;
+    return x;
 }
 
-int otai_deserialize_object_id(
-        _In_ const char *buffer,
-        _Out_ otai_object_id_t *oid)
+static void otai_serialize_grisu2_round(
+        _Inout_ char *buffer,
+        _In_ int length,
+        _In_ uint64_t dist,
+        _In_ uint64_t delta,
+        _In_ uint64_t rest,
+        _In_ uint64_t ten_k)
 {
-    int read;
-
-    int n = sscanf(buffer, "oid:0x%16" PRIx64 "%n", oid, &read);
+    /*
+     * Move last digit down while result is still in boundaries and closer
+     * to exact value.
+     */
 
-    if (n == 1 && otai_serialize_is_char_allowed(buffer[read]))
+    while (rest < dist && delta - rest >= ten_k &&
+            (rest + ten_k < dist || dist - rest > rest + ten_k - dist))
     {
-        return read;
+        buffer[length - 1]--;
+        rest += ten_k;
     }
-
-    OTAI_META_LOG_WARN("failed to deserialize '%.*s' as oid", MAX_CHARS_PRINT, buffer);
-    return OTAI_SERIALIZE_ERROR;
 }
 
-int otai_serialize_enum(
+static void otai_serialize_grisu2_digit_gen(
         _Out_ char *buffer,
-        _In_ const otai_enum_metadata_t* meta,
-        _In_ int32_t value)
+        _Out_ int *length,
+        _Inout_ int *decimal_exponent,
+        _In_ otai_serialize_diy_fp_t m_minus,
+        _In_ otai_serialize_diy_fp_t w,
+        _In_ otai_serialize_diy_fp_t m_plus)
 {
-    if (meta == NULL)
+    uint64_t delta = m_plus.f - m_minus.f;
+    uint64_t dist = m_plus.f - w.f;
+
+    int shift = -m_plus.e;
+
+    uint64_t one = UINT64_C(1) << shift;
+
+    uint32_t p1 = (uint32_t)(m_plus.f >> shift);
+    uint64_t p2 = m_plus.f & (one - 1);
+
+    uint32_t pow10 = 1000000000;
+
+    int n = 10;
+
+    while (n > 1 && p1 < pow10)
     {
-        return otai_serialize_int32(buffer, value);
+        pow10 /= 10;
+        n--;
     }
 
-    size_t i = 0;
+    *length = 0;
 
-    for (; i < meta->valuescount; ++i)
+    while (n > 0)
     {
-        if (meta->values[i] == value)
+        buffer[(*length)++] = (char)('0' + p1 / pow10);
+
+        p1 %= pow10;
+        n--;
+
+        uint64_t rest = ((uint64_t)p1 << shift) + p2;
+
+        if (rest <= delta)
         {
-            return sprintf(buffer, "%s", meta->valuesnames[i]);
+            *decimal_exponent += n;
+
+            otai_serialize_grisu2_round(buffer, *length, dist, delta, rest, (uint64_t)pow10 << shift);
+            return;
         }
+
+        pow10 /= 10;
     }
 
-    OTAI_META_LOG_WARN("enum value %d not found in enum %s", value, meta->name);
+    int m = 0;
 
-    return otai_serialize_int32(buffer, value);
+    do
+    {
+        p2 *= 10;
+
+        buffer[(*length)++] = (char)('0' + (p2 >> shift));
+
+        p2 &= one - 1;
+        m++;
+
+        delta *= 10;
+        dist *= 10;
+    }
+    while (p2 > delta);
+
+    *decimal_exponent -= m;
+
+    otai_serialize_grisu2_round(buffer, *length, dist, delta, p2, one);
 }
 
-int otai_deserialize_enum(
-        _In_ const char *buffer,
-        _In_ const otai_enum_metadata_t* meta,
-        _Out_ int32_t *value)
+/*
+ * Generates shortest digits of positive finite value, value is equal to
+ * digits * 10^decimal_exponent.
+ */
+static int otai_serialize_grisu2(
+        _Out_ char *buffer,
+        _Out_ int *decimal_exponent,
+        _In_ double value)
 {
-    if (meta == NULL)
+    uint64_t bits;
+
+    memcpy(&bits, &value, sizeof(bits));
+
+    uint64_t hidden = UINT64_C(1) << 52;
+    uint64_t fraction = bits & (hidden - 1);
+    int exponent = (int)(bits >> 52);
+
+    otai_serialize_diy_fp_t v;
+
+    if (exponent == 0)
     {
-        return otai_deserialize_int32(buffer, value);
+        v.f = fraction;
+        v.e = 1 - 1075;
+    }
+    else
+    {
+        v.f = fraction + hidden;
+        v.e = exponent - 1075;
     }
 
-    size_t idx = 0;
+    /*
+     * Boundaries are half way to neighbor doubles, lower one is closer
+     * when fraction is zero (except smallest normal).
+     */
 
-    for (; idx < meta->valuescount; ++idx)
+    otai_serialize_diy_fp_t m_plus;
+    otai_serialize_diy_fp_t m_minus;
+
+    m_plus.f = 2 * v.f + 1;
+    m_plus.e = v.e - 1;
+
+    if (fraction == 0 && exponent > 1)
+    {
+        m_minus.f = 4 * v.f - 1;
+        m_minus.e = v.e - 2;
+    }
+    else
     {
-        size_t len = strlen(meta->valuesnames[idx]);
+        m_minus.f = 2 * v.f - 1;
+        m_minus.e = v.e - 1;
+    }
+
+    m_plus = otai_serialize_diy_fp_normalize(m_plus);
+
+    m_minus.f <<= m_minus.e - m_plus.e;
+    m_minus.e = m_plus.e;
+
+    v = otai_serialize_diy_fp_normalize(v);
+
+    /*
+     * Select cached power c = 10^-k, so that w * c binary exponent is in
+     * [alpha, gamma] range, k = ceil((alpha - e - 1) * log10(2)).
+     */
+
+    int f = OTAI_SERIALIZE_GRISU_ALPHA - m_plus.e - 1;
+    int k = (f * 78913) / (1 << 18) + (f > 0);
+
+    size_t idx = (size_t)((-OTAI_SERIALIZE_CACHED_POWERS_MIN_DEC_EXP + k + (OTAI_SERIALIZE_CACHED_POWERS_DEC_STEP - 1)) / OTAI_SERIALIZE_CACHED_POWERS_DEC_STEP);
+
+    const otai_serialize_cached_power_t *cached = &otai_serialize_cached_powers[idx];
+
+    otai_serialize_diy_fp_t c;
+
+    c.f = cached->f;
+    c.e = cached->e;
+
+    otai_serialize_diy_fp_t w = otai_serialize_diy_fp_mul(v, c);
+    otai_serialize_diy_fp_t w_minus = otai_serialize_diy_fp_mul(m_minus, c);
+    otai_serialize_diy_fp_t w_plus = otai_serialize_diy_fp_mul(m_plus, c);
+
+    /*
+     * Narrow boundaries by 1 ulp to compensate multiplication error.
+     */
+
+    w_minus.f += 1;
+    w_plus.f -= 1;
+
+    int length;
+
+    *decimal_exponent = -cached->k;
+
+    otai_serialize_grisu2_digit_gen(buffer, &length, decimal_exponent, w_minus, w, w_plus);
+
+    return length;
+}
+
+/*
+ * Places decimal point into digits, fixed notation is used for decimal
+ * point position in [-5, 17] range, exponent notation otherwise, like
+ * 1e-12 for pre FEC BER values.
+ */
+static int otai_serialize_double_digits(
+        _Out_ char *buffer,
+        _In_ const char *digits,
+        _In_ int length,
+        _In_ int decimal_exponent)
+{
+    char *buf = buffer;
 
-        if (strncmp(meta->valuesnames[idx], buffer, len) == 0 &&
-            otai_serialize_is_char_allowed(buffer[len]))
+    int point = length + decimal_exponent;
+
+    if (point > 0 && point <= 17)
+    {
+        if (decimal_exponent >= 0)
         {
-            *value = meta->values[idx];
-            return (int)len;
+            memcpy(buf, digits, (size_t)length);
+            memset(buf + length, '0', (size_t)decimal_exponent);
+            buf += point;
         }
+        else
+        {
+            memcpy(buf, digits, (size_t)point);
+            buf[point] = '.';
+            memcpy(buf + point + 1, digits + point, (size_t)(length - point));
+            buf += length + 1;
+        }
+    }
+    else if (point <= 0 && point > -5)
+    {
+        memcpy(buf, "0.", 2);
+        memset(buf + 2, '0', (size_t)-point);
+        memcpy(buf + 2 - point, digits, (size_t)length);
+        buf += 2 - point + length;
     }
+    else
+    {
+        *buf++ = digits[0];
 
-    OTAI_META_LOG_WARN("enum value '%.*s' not found in enum %s", MAX_CHARS_PRINT, buffer, meta->name);
+        if (length > 1)
+        {
+            *buf++ = '.';
+            memcpy(buf, digits + 1, (size_t)(length - 1));
+            buf += length - 1;
+        }
 
-    return otai_deserialize_int32(buffer, value);
-}
+        *buf++ = 'e';
 
+        buf += otai_serialize_int64_digits(buf, point - 1);
+    }
 
-int otai_serialize_attr_id(
-        _Out_ char *buf,
-        _In_ const otai_attr_metadata_t *meta,
-        _In_ otai_attr_id_t attr_id)
-{
-    strcpy(buf, meta->attridname);
+    *buf = 0;
 
-    return (int)strlen(buf);
+    return (int)(buf - buffer);
 }
 
-int otai_deserialize_attr_id(
-        _In_ const char *buffer,
-        _Out_ otai_attr_id_t *attr_id)
+int otai_serialize_double(
+        _Out_ char *buffer,
+        _In_ otai_double_t d64)
 {
-    OTAI_META_LOG_WARN("not implemented");
-    return OTAI_SERIALIZE_ERROR;
-}
+    char *buf = buffer;
 
-int otai_serialize_attribute(
-        _Out_ char *buf,
-        _In_ const otai_attr_metadata_t *meta,
-        _In_ const otai_attribute_t *attribute)
-{
-    char *begin_buf = buf;
-    int ret;
+    uint64_t bits;
 
-    /* can be auto generated */
+    memcpy(&bits, &d64, sizeof(bits));
 
-    buf += sprintf(buf, "{");
+    if (bits >> 63)
+    {
+        *buf++ = '-';
+        bits &= ~(UINT64_C(1) << 63);
+    }
 
-    buf += sprintf(buf, "\"id\":");
+    if ((bits >> 52) == 0x7ff)
+    {
+        /*
+         * Infinity and NaN are not valid JSON numbers, they are written the
+         * same way as by printf, so strtod can read them back.
+         */
 
-    buf += sprintf(buf, "\"");
+        memcpy(buf, (bits << 12) ? "nan" : "inf", 4);
 
-    ret = otai_serialize_attr_id(buf, meta, attribute->id);
+        return (int)(buf - buffer) + 3;
+    }
 
-    if (ret < 0)
+    if (bits == 0)
     {
-        OTAI_META_LOG_WARN("failed to serialize attr id");
-        return OTAI_SERIALIZE_ERROR;
+        *buf++ = '0';
+        *buf = 0;
+
+        return (int)(buf - buffer);
     }
 
-    buf += ret;
+    memcpy(&d64, &bits, sizeof(bits));
 
-    buf += sprintf(buf, "\",");
+    char digits[20];
 
-    buf += sprintf(buf, "\"value\":");
+    int decimal_exponent;
 
-    ret = otai_serialize_attribute_value(buf, meta, &attribute->value);
+    int length = otai_serialize_grisu2(digits, &decimal_exponent, d64);
 
-    if (ret < 0)
+    return (int)(buf - buffer) + otai_serialize_double_digits(buf, digits, length, decimal_exponent);
+}
+
+#define OTAI_SERIALIZE_FIXED_DOUBLE_LIMIT 18446744073709551616.0 /* 2^64 */
+
+int otai_serialize_double_precision(
+        _Out_ char *buffer,
+        _In_ otai_double_t d64,
+        _In_ otai_stat_value_precision_t precision)
+{
+    uint64_t scale;
+    int decimals;
+
+    switch (precision)
     {
-        OTAI_META_LOG_WARN("failed to serialize attribute value");
-        return OTAI_SERIALIZE_ERROR;
+        case OTAI_STAT_VALUE_PRECISION_0:
+            scale = 1;
+            decimals = 0;
+            break;
+
+        case OTAI_STAT_VALUE_PRECISION_1:
+            scale = 10;
+            decimals = 1;
+            break;
+
+        case OTAI_STAT_VALUE_PRECISION_2:
+            scale = 100;
+            decimals = 2;
+            break;
+
+        case OTAI_STAT_VALUE_PRECISION_18:
+
+            /*
+             * 18 decimal digits are beyond double precision, shortest round
+             * trip form keeps every significant digit.
+             */
+
+            return otai_serialize_double(buffer, d64);
+
+        default:
+            OTAI_META_LOG_WARN("invalid stat value precision %d", precision);
+            return OTAI_SERIALIZE_ERROR;
     }
 
-    buf += ret;
+    double q = (d64 < 0 ? -d64 : d64) * (double)scale;
 
-    buf += sprintf(buf, "}");
+    if (!(q < OTAI_SERIALIZE_FIXED_DOUBLE_LIMIT))
+    {
+        /*
+         * Scaled value does not fit in 64 bits, or it is infinity or NaN.
+         * Such values have no fractional part, but they are written in
+         * shortest form, not with fixed number of decimals.
+         */
 
-    return (int)(buf - begin_buf);
-}
+        return otai_serialize_double(buffer, d64);
+    }
 
-int otai_deserialize_attribute(
-        _In_ const char *buffer,
-        _Out_ otai_attribute_t *attribute)
-{
-    OTAI_META_LOG_WARN("not implemented");
-    return OTAI_SERIALIZE_ERROR;
-}
+    /*
+     * Scaled value is rounded from exact binary value, not from q, which is
+     * already rounded, ties are rounded to even like in printf.
+     */
 
+    uint64_t bits;
+
+    memcpy(&bits, &d64, sizeof(bits));
+
+    uint64_t hidden = UINT64_C(1) << 52;
+    uint64_t mantissa = bits & (hidden - 1);
+    int exponent = (int)((bits >> 52) & 0x7ff);
+
+    if (exponent == 0)
+    {
+        exponent = 1;
+    }
+    else
+    {
+        mantissa |= hidden;
+    }
+
+    mantissa *= scale;
+    exponent -= 1075;
+
+    uint64_t u = 0;
+
+    if (exponent >= 0)
+    {
+        u = mantissa << exponent;
+    }
+    else if (exponent > -64)
+    {
+        uint64_t half = UINT64_C(1) << (-exponent - 1);
+        uint64_t rest = mantissa & ((half << 1) - 1);
+
+        u = mantissa >> -exponent;
+
+        if (rest > half || (rest == half && (u & 1)))
+        {
+            u++;
+        }
+    }
+
+    char *buf = buffer;
+
+    if (bits >> 63)
+    {
+        *buf++ = '-';
+    }
+
+    buf += otai_serialize_uint64_digits(buf, u / scale);
+
+    if (decimals)
+    {
+        *buf++ = '.';
+
+        int idx = decimals;
+
+        for (u %= scale; idx > 0; u /= 10)
+        {
+            buf[--idx] = (char)('0' + u % 10);
+        }
+
+        buf += decimals;
+        *buf = 0;
+    }
+
+    return (int)(buf - buffer);
+}
+
+int otai_serialize_stat_value(
+        _Out_ char *buffer,
+        _In_ const otai_stat_metadata_t *meta,
+        _In_ const otai_stat_value_t *value)
+{
+    switch (meta->statvaluetype)
+    {
+        case OTAI_STAT_VALUE_TYPE_INT32:
+            return otai_serialize_int32(buffer, value->s32);
+
+        case OTAI_STAT_VALUE_TYPE_UINT32:
+            return otai_serialize_uint32(buffer, value->u32);
+
+        case OTAI_STAT_VALUE_TYPE_INT64:
+            return otai_serialize_int64(buffer, value->s64);
+
+        case OTAI_STAT_VALUE_TYPE_UINT64:
+            return otai_serialize_uint64(buffer, value->u64);
+
+        case OTAI_STAT_VALUE_TYPE_DOUBLE:
+            return otai_serialize_double_precision(buffer, value->d64, meta->statvalueprecision);
+
+        default:
+            OTAI_META_LOG_WARN("invalid stat value type %d on %s", meta->statvaluetype, meta->statidname);
+            return OTAI_SERIALIZE_ERROR;
+    }
+}
+
+/*
+ * Powers of 10 which are exactly representable as double.
+ */
+static const double otai_deserialize_exact_powers_of_10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+    1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+    1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+#define OTAI_DESERIALIZE_MAX_EXACT_POWER_OF_10 22
+#define OTAI_DESERIALIZE_MAX_EXACT_MANTISSA (UINT64_C(1) << 53)
+#define OTAI_DESERIALIZE_MAX_MANTISSA_DIGITS 19
+
+/*
+ * When decimal mantissa and power of 10 are both exactly representable,
+ * single multiplication or division gives correctly rounded result,
+ * otherwise -1 is returned and caller falls back to strtod_l.
+ */
+static int otai_deserialize_double_fast(
+        _In_ const char *buffer,
+        _Out_ otai_double_t *d64)
+{
+    const char *buf = buffer;
+
+    bool negative = (*buf == '-');
+
+    if (negative)
+    {
+        buf++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+
+    const char *start = buf;
+
+    for (; isdigit(*buf); buf++, digits++)
+    {
+        mantissa = mantissa * 10 + (uint64_t)(*buf - '0');
+    }
+
+    if (*buf == '.')
+    {
+        buf++;
+
+        for (; isdigit(*buf); buf++, digits++, exponent--)
+        {
+            mantissa = mantissa * 10 + (uint64_t)(*buf - '0');
+        }
+    }
+
+    if (buf == start || (buf == start + 1 && *start == '.') || digits > OTAI_DESERIALIZE_MAX_MANTISSA_DIGITS)
+    {
+        return -1;
+    }
+
+    if (*buf == 'e' || *buf == 'E')
+    {
+        buf++;
+
+        bool negative_exponent = (*buf == '-');
+
+        if (*buf == '-' || *buf == '+')
+        {
+            buf++;
+        }
+
+        if (!isdigit(*buf))
+        {
+            return -1;
+        }
+
+        int e = 0;
+
+        for (; isdigit(*buf) && e < 1000; buf++)
+        {
+            e = e * 10 + (*buf - '0');
+        }
+
+        exponent += negative_exponent ? -e : e;
+    }
+
+    if (!otai_serialize_is_char_allowed(*buf) ||
+            mantissa > OTAI_DESERIALIZE_MAX_EXACT_MANTISSA ||
+            exponent > OTAI_DESERIALIZE_MAX_EXACT_POWER_OF_10 ||
+            exponent < -OTAI_DESERIALIZE_MAX_EXACT_POWER_OF_10)
+    {
+        return -1;
+    }
+
+    double d = (double)mantissa;
+
+    if (exponent < 0)
+    {
+        d /= otai_deserialize_exact_powers_of_10[-exponent];
+    }
+    else
+    {
+        d *= otai_deserialize_exact_powers_of_10[exponent];
+    }
+
+    *d64 = negative ? -d : d;
+
+    return (int)(buf - buffer);
+}
+
+/*
+ * Serialized doubles always use '.', so fallback parses them in "C" locale
+ * whatever locale process set. Locale is created once and never freed.
+ */
+static locale_t otai_deserialize_c_locale(void)
+{
+    static locale_t c_locale = (locale_t)0;
+
+    locale_t current = __atomic_load_n(&c_locale, __ATOMIC_ACQUIRE);
+
+    if (current != (locale_t)0)
+    {
+        return current;
+    }
+
+    locale_t created = newlocale(LC_ALL_MASK, "C", (locale_t)0);
+
+    if (created == (locale_t)0)
+    {
+        return (locale_t)0;
+    }
+
+    if (!__atomic_compare_exchange_n(&c_locale, &current, created, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+    {
+        /* other thread was first */
+
+        freelocale(created);
+
+        return current;
+    }
+
+    return created;
+}
+
+int otai_deserialize_double(
+        _In_ const char *buffer,
+        _Out_ otai_double_t *d64)
+{
+    int ret = otai_deserialize_double_fast(buffer, d64);
+
+    if (ret > 0)
+    {
+        return ret;
+    }
+
+    locale_t c_locale = otai_deserialize_c_locale();
+
+    if (c_locale == (locale_t)0)
+    {
+        OTAI_META_LOG_ERROR("failed to create C locale");
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    char *endptr = NULL;
+
+    double d = strtod_l(buffer, &endptr, c_locale);
+
+    if (endptr != buffer && otai_serialize_is_char_allowed(*endptr))
+    {
+        *d64 = d;
+        return (int)(endptr - buffer);
+    }
+
+    OTAI_META_LOG_WARN("failed to deserialize '%.*s' as double", MAX_CHARS_PRINT, buffer);
+    return OTAI_SERIALIZE_ERROR;
+}
+
+int otai_serialize_pointer(
+        _Out_ char *buffer,
+        _In_ otai_pointer_t ptr)
+{
+    return sprintf(buffer, "ptr:%p", ptr);
+}
+
+int otai_deserialize_pointer(
+        _In_ const char *buffer,
+        _Out_ otai_pointer_t *pointer)
+{
+    int read;
+
+    int n = sscanf(buffer, "ptr:%p%n", pointer, &read);
+
+    if (n == 1 && otai_serialize_is_char_allowed(buffer[read]))
+    {
+        return read;
+    }
+
+    OTAI_META_LOG_WARN("failed to deserialize '%.*s' as pointer", MAX_CHARS_PRINT, buffer);
+    return OTAI_SERIALIZE_ERROR;
+}
+
+int otai_deserialize_object_id(
+        _In_ const char *buffer,
+        _Out_ otai_object_id_t *oid)
+{
+    if (strncmp(buffer, "oid:0x", 6) == 0)
+    {
+        const char *buf = buffer + 6;
+
+        uint64_t result = 0;
+
+        int idx = 0;
+
+        for (; idx < 16; idx++)
+        {
+            int c = (unsigned char)buf[idx];
+
+            if (c >= '0' && c <= '9')
+            {
+                c -= '0';
+            }
+            else if (c >= 'a' && c <= 'f')
+            {
+                c -= 'a' - 10;
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                c -= 'A' - 10;
+            }
+            else
+            {
+                break;
+            }
+
+            result = (result << 4) | (uint64_t)c;
+        }
+
+        if (idx > 0 && otai_serialize_is_char_allowed(buf[idx]))
+        {
+            *oid = result;
+            return 6 + idx;
+        }
+    }
+
+    OTAI_META_LOG_WARN("failed to deserialize '%.*s' as oid", MAX_CHARS_PRINT, buffer);
+    return OTAI_SERIALIZE_ERROR;
+}
+
+int otai_serialize_enum(
+        _Out_ char *buffer,
+        _In_ const otai_enum_metadata_t* meta,
+        _In_ int32_t value)
+{
+    if (meta == NULL)
+    {
+        return otai_serialize_int32(buffer, value);
+    }
+
+    size_t idx = 0;
+
+    if (otai_metadata_get_enum_value_index(meta, value, &idx))
+    {
+        return sprintf(buffer, "%s", meta->valuesnames[idx]);
+    }
+
+    OTAI_META_LOG_WARN("enum value %d not found in enum %s", value, meta->name);
+
+    return otai_serialize_int32(buffer, value);
+}
+
+int otai_deserialize_enum(
+        _In_ const char *buffer,
+        _In_ const otai_enum_metadata_t* meta,
+        _Out_ int32_t *value)
+{
+    if (meta == NULL)
+    {
+        return otai_deserialize_int32(buffer, value);
+    }
+
+    /*
+     * Enum names consist of [A-Z0-9_] characters, so value ends on first
+     * character allowed after serialized value.
+     */
+
+    size_t len = 0;
+
+    while (!otai_serialize_is_char_allowed(buffer[len]))
+    {
+        len++;
+    }
+
+    size_t idx = 0;
+
+    if (otai_metadata_get_enum_value_index_by_name(meta, buffer, len, &idx))
+    {
+        *value = meta->values[idx];
+        return (int)len;
+    }
+
+    OTAI_META_LOG_WARN("enum value '%.*s' not found in enum %s", MAX_CHARS_PRINT, buffer, meta->name);
+
+    return otai_deserialize_int32(buffer, value);
+}
+
+
+int otai_serialize_attr_id(
+        _Out_ char *buf,
+        _In_ const otai_attr_metadata_t *meta,
+        _In_ otai_attr_id_t attr_id)
+{
+    strcpy(buf, meta->attridname);
+
+    return (int)strlen(buf);
+}
+
+static int otai_deserialize_attr_id_metadata(
+        _In_ const char *buffer,
+        _Out_ const otai_attr_metadata_t **meta)
+{
+    /*
+     * Attribute id names consist of [A-Z0-9_] characters, so name ends on
+     * first character allowed after serialized value.
+     */
+
+    size_t len = 0;
+
+    while (!otai_serialize_is_char_allowed(buffer[len]))
+    {
+        len++;
+    }
+
+    *meta = otai_metadata_get_attr_metadata_by_attr_id_name_length(buffer, len);
+
+    if (*meta == NULL || len > INT_MAX)
+    {
+        OTAI_META_LOG_WARN("failed to deserialize '%.*s' as attr id", MAX_CHARS_PRINT, buffer);
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    return (int)len;
+}
+
+int otai_deserialize_attr_id(
+        _In_ const char *buffer,
+        _Out_ otai_attr_id_t *attr_id)
+{
+    const otai_attr_metadata_t *meta;
+
+    int ret = otai_deserialize_attr_id_metadata(buffer, &meta);
+
+    if (ret < 0)
+    {
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    *attr_id = meta->attrid;
+
+    return ret;
+}
+
+int otai_serialize_attribute(
+        _Out_ char *buf,
+        _In_ const otai_attr_metadata_t *meta,
+        _In_ const otai_attribute_t *attribute)
+{
+    char *begin_buf = buf;
+    int ret;
+
+    /* can be auto generated */
+
+    buf += sprintf(buf, "{");
+
+    buf += sprintf(buf, "\"id\":");
+
+    buf += sprintf(buf, "\"");
+
+    ret = otai_serialize_attr_id(buf, meta, attribute->id);
+
+    if (ret < 0)
+    {
+        OTAI_META_LOG_WARN("failed to serialize attr id");
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    buf += ret;
+
+    buf += sprintf(buf, "\",");
+
+    buf += sprintf(buf, "\"value\":");
+
+    ret = otai_serialize_attribute_value(buf, meta, &attribute->value);
+
+    if (ret < 0)
+    {
+        OTAI_META_LOG_WARN("failed to serialize attribute value");
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    buf += ret;
+
+    buf += sprintf(buf, "}");
+
+    return (int)(buf - begin_buf);
+}
+
+/*
+ * Same helpers as in generated deserialize methods, buf is advanced on
+ * success and function returns on any failure.
+ */
+
+#define EXPECT(x) { \
+    if (strncmp(buf, x, sizeof(x) - 1) == 0) { buf += sizeof(x) - 1; } \
+    else { \
+        OTAI_META_LOG_WARN("expected '%s' but got '%.*s...'", x, (int)sizeof(x), buf); \
+        return OTAI_SERIALIZE_ERROR; } }
+#define EXPECT_QUOTE     EXPECT("\"")
+#define EXPECT_KEY(k)    EXPECT("\"" k "\":")
+#define EXPECT_NEXT_KEY(k) { EXPECT(","); EXPECT_KEY(k); }
+#define EXPECT_CHECK(expr, suffix) {                                 \
+    ret = (expr);                                                  \
+    if (ret < 0) {                                                 \
+        OTAI_META_LOG_WARN("failed to deserialize " #suffix "");      \
+        return OTAI_SERIALIZE_ERROR; }                              \
+    buf += ret; }
+#define EXPECT_QUOTE_CHECK(expr, suffix) {\
+    EXPECT_QUOTE; EXPECT_CHECK(expr, suffix); EXPECT_QUOTE; }
+
+/*
+ * Caller supplied memory used for list values, when arena is NULL, lists
+ * provided by caller in attribute value are used and count is capacity.
+ */
+typedef struct _otai_deserialize_arena_t
+{
+    uint8_t *buffer;
+
+    size_t size;
+
+    size_t used;
+
+} otai_deserialize_arena_t;
+
+static void* otai_deserialize_arena_alloc(
+        _Inout_ otai_deserialize_arena_t *arena,
+        _In_ size_t size)
+{
+    size_t offset = arena->used;
+
+    size_t misalign = (uintptr_t)(arena->buffer + offset) % sizeof(uint64_t);
+
+    if (misalign)
+    {
+        offset += sizeof(uint64_t) - misalign;
+    }
+
+    if (offset > arena->size || arena->size - offset < size)
+    {
+        return NULL;
+    }
+
+    arena->used = offset + size;
+
+    return arena->buffer + offset;
+}
+
+static size_t otai_deserialize_list_item_size(
+        _In_ otai_attr_value_type_t type)
+{
+    switch (type)
+    {
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            return sizeof(otai_object_id_t);
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            return sizeof(uint8_t);
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            return sizeof(int8_t);
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            return sizeof(uint16_t);
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            return sizeof(int16_t);
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            return sizeof(uint32_t);
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            return sizeof(int32_t);
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            return sizeof(otai_spectrum_power_t);
+        default:
+            return 0;
+    }
+}
+
+static int otai_deserialize_list_item(
+        _In_ const char *buffer,
+        _In_ otai_attr_value_type_t type,
+        _Out_ void *list,
+        _In_ uint32_t idx)
+{
+    const char *buf = buffer;
+    int ret;
+
+    switch (type)
+    {
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            EXPECT_QUOTE_CHECK(otai_deserialize_object_id(buf, &((otai_object_id_t*)list)[idx]), object_id);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            EXPECT_CHECK(otai_deserialize_uint8(buf, &((uint8_t*)list)[idx]), uint8);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            EXPECT_CHECK(otai_deserialize_int8(buf, &((int8_t*)list)[idx]), int8);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            EXPECT_CHECK(otai_deserialize_uint16(buf, &((uint16_t*)list)[idx]), uint16);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            EXPECT_CHECK(otai_deserialize_int16(buf, &((int16_t*)list)[idx]), int16);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            EXPECT_CHECK(otai_deserialize_uint32(buf, &((uint32_t*)list)[idx]), uint32);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            EXPECT_CHECK(otai_deserialize_int32(buf, &((int32_t*)list)[idx]), int32);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            {
+                otai_spectrum_power_t *sp = &((otai_spectrum_power_t*)list)[idx];
+
+                EXPECT("{");
+                EXPECT_KEY("lower_frequency");
+                EXPECT_CHECK(otai_deserialize_uint64(buf, &sp->lower_frequency), uint64);
+                EXPECT_NEXT_KEY("upper_frequency");
+                EXPECT_CHECK(otai_deserialize_uint64(buf, &sp->upper_frequency), uint64);
+                EXPECT_NEXT_KEY("power");
+                EXPECT_CHECK(otai_deserialize_double(buf, &sp->power), double);
+                EXPECT("}");
+            }
+            break;
+
+        default:
+            OTAI_META_LOG_WARN("attr value type %d is not a list", type);
+            return OTAI_SERIALIZE_ERROR;
+    }
+
+    return (int)(buf - buffer);
+}
+
+/*
+ * Deserializes {"count":N,"list":[...]} or {"count":N,"list":null}, list
+ * will point to arena memory or to caller provided list.
+ */
+static int otai_deserialize_list(
+        _In_ const char *buffer,
+        _In_ otai_attr_value_type_t type,
+        _Inout_ otai_deserialize_arena_t *arena,
+        _Inout_ uint32_t *count,
+        _Inout_ void **list)
+{
+    const char *buf = buffer;
+    int ret;
+    uint32_t n;
+
+    EXPECT("{");
+    EXPECT_KEY("count");
+    EXPECT_CHECK(otai_deserialize_uint32(buf, &n), uint32);
+    EXPECT_NEXT_KEY("list");
+
+    if (strncmp(buf, "null", 4) == 0)
+    {
+        buf += 4;
+
+        if (arena != NULL)
+        {
+            *list = NULL;
+        }
+
+        *count = n;
+
+        EXPECT("}");
+
+        return (int)(buf - buffer);
+    }
+
+    if (arena != NULL)
+    {
+        *list = (n == 0) ? NULL : otai_deserialize_arena_alloc(arena, (size_t)n * otai_deserialize_list_item_size(type));
+
+        if (n && *list == NULL)
+        {
+            OTAI_META_LOG_WARN("arena is too small for %u list items", n);
+            return OTAI_SERIALIZE_ERROR;
+        }
+    }
+    else if (n > *count || (n && *list == NULL))
+    {
+        OTAI_META_LOG_WARN("list capacity %u is too small, required %u", *count, n);
+
+        *count = n;
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    *count = n;
+
+    EXPECT("[");
+
+    uint32_t idx = 0;
+
+    for (; idx < n; idx++)
+    {
+        if (idx != 0)
+        {
+            EXPECT(",");
+        }
+
+        EXPECT_CHECK(otai_deserialize_list_item(buf, type, *list, idx), list_item);
+    }
+
+    EXPECT("]");
+    EXPECT("}");
+
+    return (int)(buf - buffer);
+}
+
+static int otai_deserialize_attribute_value_list(
+        _In_ const char *buffer,
+        _In_ otai_attr_value_type_t type,
+        _Inout_ otai_deserialize_arena_t *arena,
+        _Inout_ otai_attribute_value_t *value)
+{
+    void *list;
+    int ret;
+
+    switch (type)
+    {
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            list = value->objlist.list;
+            ret = otai_deserialize_list(buffer, type, arena, &value->objlist.count, &list);
+            value->objlist.list = (otai_object_id_t*)list;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            list = value->u8list.list;
+            ret = otai_deserialize_list(buffer, type, arena, &value->u8list.count, &list);
+            value->u8list.list = (uint8_t*)list;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            list = value->s8list.list;
+            ret = otai_deserialize_list(buffer, type, arena, &value->s8list.count, &list);
+            value->s8list.list = (int8_t*)list;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            list = value->u16list.list;
+            ret = otai_deserialize_list(buffer, type, arena, &value->u16list.count, &list);
+            value->u16list.list = (uint16_t*)list;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            list = value->s16list.list;
+            ret = otai_deserialize_list(buffer, type, arena, &value->s16list.count, &list);
+            value->s16list.list = (int16_t*)list;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            list = value->u32list.list;
+            ret = otai_deserialize_list(buffer, type, arena, &value->u32list.count, &list);
+            value->u32list.list = (uint32_t*)list;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            list = value->s32list.list;
+            ret = otai_deserialize_list(buffer, type, arena, &value->s32list.count, &list);
+            value->s32list.list = (int32_t*)list;
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            list = value->spectrumpowerlist.list;
+            ret = otai_deserialize_list(buffer, type, arena, &value->spectrumpowerlist.count, &list);
+            value->spectrumpowerlist.list = (otai_spectrum_power_t*)list;
+            break;
+
+        default:
+            OTAI_META_LOG_WARN("attr value type %d is not a list", type);
+            return OTAI_SERIALIZE_ERROR;
+    }
+
+    return ret;
+}
+
+/*
+ * Deserializes attribute value union in format {"member":value}, where
+ * member is selected by attribute value type, same as in generated
+ * otai_serialize_attribute_value.
+ */
+static int otai_deserialize_attribute_value_json(
+        _In_ const char *buffer,
+        _In_ const otai_attr_metadata_t *meta,
+        _Inout_ otai_deserialize_arena_t *arena,
+        _Inout_ otai_attribute_value_t *value)
+{
+    const char *buf = buffer;
+    int ret;
+
+    EXPECT("{");
+
+    switch (meta->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_BOOL:
+            EXPECT_KEY("booldata");
+            EXPECT_CHECK(otai_deserialize_bool(buf, &value->booldata), bool);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_CHARDATA:
+            EXPECT_KEY("chardata");
+            EXPECT_QUOTE_CHECK(otai_deserialize_chardata(buf, value->chardata), chardata);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT8:
+            EXPECT_KEY("u8");
+            EXPECT_CHECK(otai_deserialize_uint8(buf, &value->u8), uint8);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT8:
+            EXPECT_KEY("s8");
+            EXPECT_CHECK(otai_deserialize_int8(buf, &value->s8), int8);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT16:
+            EXPECT_KEY("u16");
+            EXPECT_CHECK(otai_deserialize_uint16(buf, &value->u16), uint16);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT16:
+            EXPECT_KEY("s16");
+            EXPECT_CHECK(otai_deserialize_int16(buf, &value->s16), int16);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32:
+            EXPECT_KEY("u32");
+            EXPECT_CHECK(otai_deserialize_uint32(buf, &value->u32), uint32);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT32:
+            EXPECT_KEY("s32");
+            EXPECT_CHECK(otai_deserialize_int32(buf, &value->s32), int32);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT64:
+            EXPECT_KEY("u64");
+            EXPECT_CHECK(otai_deserialize_uint64(buf, &value->u64), uint64);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT64:
+            EXPECT_KEY("s64");
+            EXPECT_CHECK(otai_deserialize_int64(buf, &value->s64), int64);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_DOUBLE:
+            EXPECT_KEY("d64");
+            EXPECT_CHECK(otai_deserialize_double(buf, &value->d64), double);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_POINTER:
+            EXPECT_KEY("ptr");
+            EXPECT_QUOTE_CHECK(otai_deserialize_pointer(buf, &value->ptr), pointer);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_ID:
+            EXPECT_KEY("oid");
+            EXPECT_QUOTE_CHECK(otai_deserialize_object_id(buf, &value->oid), object_id);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            EXPECT_KEY("objlist");
+            EXPECT_CHECK(otai_deserialize_attribute_value_list(buf, meta->attrvaluetype, arena, value), object_list);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            EXPECT_KEY("u8list");
+            EXPECT_CHECK(otai_deserialize_attribute_value_list(buf, meta->attrvaluetype, arena, value), u8_list);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            EXPECT_KEY("s8list");
+            EXPECT_CHECK(otai_deserialize_attribute_value_list(buf, meta->attrvaluetype, arena, value), s8_list);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            EXPECT_KEY("u16list");
+            EXPECT_CHECK(otai_deserialize_attribute_value_list(buf, meta->attrvaluetype, arena, value), u16_list);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            EXPECT_KEY("s16list");
+            EXPECT_CHECK(otai_deserialize_attribute_value_list(buf, meta->attrvaluetype, arena, value), s16_list);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            EXPECT_KEY("u32list");
+            EXPECT_CHECK(otai_deserialize_attribute_value_list(buf, meta->attrvaluetype, arena, value), u32_list);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            EXPECT_KEY("s32list");
+            EXPECT_CHECK(otai_deserialize_attribute_value_list(buf, meta->attrvaluetype, arena, value), s32_list);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32_RANGE:
+            EXPECT_KEY("u32range");
+            EXPECT("{");
+            EXPECT_KEY("min");
+            EXPECT_CHECK(otai_deserialize_uint32(buf, &value->u32range.min), uint32);
+            EXPECT_NEXT_KEY("max");
+            EXPECT_CHECK(otai_deserialize_uint32(buf, &value->u32range.max), uint32);
+            EXPECT("}");
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT32_RANGE:
+            EXPECT_KEY("s32range");
+            EXPECT("{");
+            EXPECT_KEY("min");
+            EXPECT_CHECK(otai_deserialize_int32(buf, &value->s32range.min), int32);
+            EXPECT_NEXT_KEY("max");
+            EXPECT_CHECK(otai_deserialize_int32(buf, &value->s32range.max), int32);
+            EXPECT("}");
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            EXPECT_KEY("spectrumpowerlist");
+            EXPECT_CHECK(otai_deserialize_attribute_value_list(buf, meta->attrvaluetype, arena, value), spectrum_power_list);
+            break;
+
+        default:
+            OTAI_META_LOG_WARN("attr value type %d is not supported", meta->attrvaluetype);
+            return OTAI_SERIALIZE_ERROR;
+    }
+
+    EXPECT("}");
+
+    return (int)(buf - buffer);
+}
+
+static int otai_deserialize_attribute_json(
+        _In_ const char *buffer,
+        _Inout_ otai_deserialize_arena_t *arena,
+        _Inout_ otai_attribute_t *attribute)
+{
+    const char *buf = buffer;
+    const otai_attr_metadata_t *meta;
+    int ret;
+
+    EXPECT("{");
+    EXPECT_KEY("id");
+    EXPECT_QUOTE_CHECK(otai_deserialize_attr_id_metadata(buf, &meta), attr_id);
+    EXPECT_NEXT_KEY("value");
+    EXPECT_CHECK(otai_deserialize_attribute_value_json(buf, meta, arena, &attribute->value), attribute_value);
+    EXPECT("}");
+
+    attribute->id = meta->attrid;
+
+    return (int)(buf - buffer);
+}
+
+int otai_deserialize_attribute(
+        _In_ const char *buffer,
+        _Inout_ otai_attribute_t *attribute)
+{
+    return otai_deserialize_attribute_json(buffer, NULL, attribute);
+}
+
+int otai_deserialize_attribute_list(
+        _In_ const char *buffer,
+        _Out_ uint8_t *arena,
+        _In_ size_t arena_size,
+        _Inout_ uint32_t *attr_count,
+        _Out_ otai_attribute_t *attr_list)
+{
+    otai_deserialize_arena_t a = { arena, arena_size, 0 };
+
+    const char *buf = buffer;
+    int ret;
+
+    if (arena == NULL && arena_size != 0)
+    {
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    EXPECT("[");
+
+    uint32_t idx = 0;
+
+    for (; *buf != ']'; idx++)
+    {
+        if (idx != 0)
+        {
+            EXPECT(",");
+        }
+
+        if (idx >= *attr_count)
+        {
+            OTAI_META_LOG_WARN("attribute list capacity %u is too small", *attr_count);
+            return OTAI_SERIALIZE_ERROR;
+        }
+
+        memset(&attr_list[idx], 0, sizeof(otai_attribute_t));
+
+        EXPECT_CHECK(otai_deserialize_attribute_json(buf, &a, &attr_list[idx]), attribute);
+    }
+
+    EXPECT("]");
+
+    *attr_count = idx;
+
+    return (int)(buf - buffer);
+}
+
+int otai_serialize_aps_report_switch_info(
+        _Out_ char *buf,
+        _In_ otai_object_id_t aps_id,
+        _In_ const otai_olp_switch_t *switch_info)
+{
+    char *begin_buf = buf;
+    int ret;
+
+    buf += sprintf(buf, "{");
+
+    buf += sprintf(buf, "\"aps_id\":");
+
+    buf += sprintf(buf, "\"");
+
+    buf += otai_serialize_object_id(buf, aps_id);
+
+    buf += sprintf(buf, "\",");
+
+    buf += sprintf(buf, "\"switch_info\":");
+
+    ret = otai_serialize_olp_switch(buf, switch_info);
+
+    if (ret < 0)
+    {
+        OTAI_META_LOG_WARN("failed to serialize switch info");
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    buf += ret;
+
+    buf += sprintf(buf, "}");
+
+    return (int)(buf - begin_buf);
+}
+
+int otai_deserialize_aps_report_switch_info(
+        _In_ const char *buffer,
+        _Out_ otai_object_id_t *aps_id,
+        _Out_ otai_olp_switch_t *switch_info)
+{
+    const char *buf = buffer;
+    int ret;
+
+    EXPECT("{");
+    EXPECT_KEY("aps_id");
+    EXPECT_QUOTE_CHECK(otai_deserialize_object_id(buf, aps_id), object_id);
+    EXPECT_NEXT_KEY("switch_info");
+    EXPECT_CHECK(otai_deserialize_olp_switch(buf, switch_info), olp_switch);
+    EXPECT("}");
+
+    return (int)(buf - buffer);
+}
+
+#undef EXPECT_QUOTE_CHECK
+#undef EXPECT_CHECK
+#undef EXPECT_NEXT_KEY
+#undef EXPECT_KEY
+#undef EXPECT_QUOTE
+#undef EXPECT
+
+
+/*
+ * Binary attribute format.
+ */
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define OTAI_SERIALIZE_BINARY_BIG_ENDIAN
+#endif
+
+#define OTAI_SERIALIZE_BINARY_MAX_VARINT_LENGTH 10
+
+/* spectrum power list is encoded as array of 3 little endian 64 bit words */
+typedef char otai_serialize_binary_spectrum_power_size_check[(sizeof(otai_spectrum_power_t) == 3 * sizeof(uint64_t)) ? 1 : -1];
+
+typedef struct _otai_serialize_binary_writer_t
+{
+    uint8_t *buffer;
+
+    size_t length;
+
+    size_t offset;
+
+} otai_serialize_binary_writer_t;
+
+typedef struct _otai_serialize_binary_reader_t
+{
+    const uint8_t *buffer;
+
+    size_t length;
+
+    size_t offset;
+
+} otai_serialize_binary_reader_t;
+
+static bool otai_serialize_binary_put_byte(
+        _Inout_ otai_serialize_binary_writer_t *w,
+        _In_ uint8_t byte)
+{
+    if (w->offset >= w->length)
+    {
+        return false;
+    }
+
+    w->buffer[w->offset++] = byte;
+
+    return true;
+}
+
+static bool otai_serialize_binary_put_varint(
+        _Inout_ otai_serialize_binary_writer_t *w,
+        _In_ uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        if (!otai_serialize_binary_put_byte(w, (uint8_t)(value | 0x80)))
+        {
+            return false;
+        }
+
+        value >>= 7;
+    }
+
+    return otai_serialize_binary_put_byte(w, (uint8_t)value);
+}
+
+static bool otai_serialize_binary_put_zigzag(
+        _Inout_ otai_serialize_binary_writer_t *w,
+        _In_ int64_t value)
+{
+    return otai_serialize_binary_put_varint(w, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static bool otai_serialize_binary_put_fixed64(
+        _Inout_ otai_serialize_binary_writer_t *w,
+        _In_ uint64_t value)
+{
+    if (w->length - w->offset < sizeof(uint64_t))
+    {
+        return false;
+    }
+
+    size_t i = 0;
+
+    for (; i < sizeof(uint64_t); i++)
+    {
+        w->buffer[w->offset++] = (uint8_t)(value >> (8 * i));
+    }
+
+    return true;
+}
+
+/*
+ * Copies count elements of elemsize bytes, each made of little endian words
+ * of wordsize bytes. Elements are aligned to wordsize relative to buffer
+ * start, so decoder can point directly into buffer.
+ */
+static bool otai_serialize_binary_put_list(
+        _Inout_ otai_serialize_binary_writer_t *w,
+        _In_ uint32_t count,
+        _In_ const void *list,
+        _In_ size_t elemsize,
+        _In_ size_t wordsize)
+{
+    if (!otai_serialize_binary_put_varint(w, count))
+    {
+        return false;
+    }
+
+    if (count == 0)
+    {
+        return true;
+    }
+
+    if (list == NULL)
+    {
+        OTAI_META_LOG_WARN("list is NULL, but count is %u", count);
+        return false;
+    }
+
+    while (w->offset % wordsize)
+    {
+        if (!otai_serialize_binary_put_byte(w, 0))
+        {
+            return false;
+        }
+    }
+
+    size_t size = (size_t)count * elemsize;
+
+    if (w->length - w->offset < size)
+    {
+        return false;
+    }
+
+#ifdef OTAI_SERIALIZE_BINARY_BIG_ENDIAN
+
+    const uint8_t *src = (const uint8_t*)list;
+
+    size_t i = 0;
+
+    for (; i < size; i += wordsize)
+    {
+        size_t b = 0;
+
+        for (; b < wordsize; b++)
+        {
+            w->buffer[w->offset + i + b] = src[i + wordsize - 1 - b];
+        }
+    }
+
+#else
+
+    memcpy(w->buffer + w->offset, list, size);
+
+#endif
+
+    w->offset += size;
+
+    return true;
+}
+
+static bool otai_serialize_binary_put_value(
+        _Inout_ otai_serialize_binary_writer_t *w,
+        _In_ const otai_attr_metadata_t *meta,
+        _In_ const otai_attribute_value_t *value)
+{
+    uint64_t u64;
+    size_t len;
+
+    switch (meta->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_BOOL:
+            return otai_serialize_binary_put_byte(w, value->booldata ? 1 : 0);
+
+        case OTAI_ATTR_VALUE_TYPE_CHARDATA:
+
+            for (len = 0; len < OTAI_CHARDATA_LENGTH && value->chardata[len]; len++)
+            {
+            }
+
+            if (!otai_serialize_binary_put_varint(w, len) || w->length - w->offset < len)
+            {
+                return false;
+            }
+
+            memcpy(w->buffer + w->offset, value->chardata, len);
+
+            w->offset += len;
+
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT8:
+            return otai_serialize_binary_put_byte(w, value->u8);
+
+        case OTAI_ATTR_VALUE_TYPE_INT8:
+            return otai_serialize_binary_put_byte(w, (uint8_t)value->s8);
+
+        case OTAI_ATTR_VALUE_TYPE_UINT16:
+            return otai_serialize_binary_put_varint(w, value->u16);
+
+        case OTAI_ATTR_VALUE_TYPE_INT16:
+            return otai_serialize_binary_put_zigzag(w, value->s16);
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32:
+            return otai_serialize_binary_put_varint(w, value->u32);
+
+        case OTAI_ATTR_VALUE_TYPE_INT32:
+            return otai_serialize_binary_put_zigzag(w, value->s32);
+
+        case OTAI_ATTR_VALUE_TYPE_UINT64:
+            return otai_serialize_binary_put_varint(w, value->u64);
+
+        case OTAI_ATTR_VALUE_TYPE_INT64:
+            return otai_serialize_binary_put_zigzag(w, value->s64);
+
+        case OTAI_ATTR_VALUE_TYPE_DOUBLE:
+            memcpy(&u64, &value->d64, sizeof(u64));
+            return otai_serialize_binary_put_fixed64(w, u64);
+
+        case OTAI_ATTR_VALUE_TYPE_POINTER:
+            return otai_serialize_binary_put_fixed64(w, (uint64_t)(uintptr_t)value->ptr);
+
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_ID:
+            return otai_serialize_binary_put_fixed64(w, value->oid);
+
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            return otai_serialize_binary_put_list(w, value->objlist.count, value->objlist.list,
+                    sizeof(otai_object_id_t), sizeof(otai_object_id_t));
+
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            return otai_serialize_binary_put_list(w, value->u8list.count, value->u8list.list,
+                    sizeof(uint8_t), sizeof(uint8_t));
+
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            return otai_serialize_binary_put_list(w, value->s8list.count, value->s8list.list,
+                    sizeof(int8_t), sizeof(int8_t));
+
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            return otai_serialize_binary_put_list(w, value->u16list.count, value->u16list.list,
+                    sizeof(uint16_t), sizeof(uint16_t));
+
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            return otai_serialize_binary_put_list(w, value->s16list.count, value->s16list.list,
+                    sizeof(int16_t), sizeof(int16_t));
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            return otai_serialize_binary_put_list(w, value->u32list.count, value->u32list.list,
+                    sizeof(uint32_t), sizeof(uint32_t));
+
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            return otai_serialize_binary_put_list(w, value->s32list.count, value->s32list.list,
+                    sizeof(int32_t), sizeof(int32_t));
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32_RANGE:
+            return otai_serialize_binary_put_varint(w, value->u32range.min) &&
+                otai_serialize_binary_put_varint(w, value->u32range.max);
+
+        case OTAI_ATTR_VALUE_TYPE_INT32_RANGE:
+            return otai_serialize_binary_put_zigzag(w, value->s32range.min) &&
+                otai_serialize_binary_put_zigzag(w, value->s32range.max);
+
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            return otai_serialize_binary_put_list(w, value->spectrumpowerlist.count, value->spectrumpowerlist.list,
+                    sizeof(otai_spectrum_power_t), sizeof(uint64_t));
+
+        default:
+            OTAI_META_LOG_WARN("attr value type %d is not supported", meta->attrvaluetype);
+            return false;
+    }
+}
+
+static bool otai_serialize_binary_put_attribute(
+        _Inout_ otai_serialize_binary_writer_t *w,
+        _In_ const otai_attr_metadata_t *meta,
+        _In_ const otai_attribute_t *attribute)
+{
+    if (meta == NULL || attribute == NULL || meta->attrid != attribute->id)
+    {
+        OTAI_META_LOG_WARN("invalid attribute or metadata");
+        return false;
+    }
+
+    return otai_serialize_binary_put_varint(w, attribute->id) &&
+        otai_serialize_binary_put_byte(w, (uint8_t)meta->attrvaluetype) &&
+        otai_serialize_binary_put_value(w, meta, &attribute->value);
+}
+
+static int otai_serialize_binary_result(
+        _In_ bool success,
+        _In_ size_t offset)
+{
+    if (!success || offset > INT_MAX)
+    {
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    return (int)offset;
+}
+
+int otai_serialize_attribute_binary(
+        _Out_ uint8_t *buffer,
+        _In_ size_t length,
+        _In_ const otai_attr_metadata_t *meta,
+        _In_ const otai_attribute_t *attribute)
+{
+    otai_serialize_binary_writer_t w = { buffer, length, 0 };
+
+    bool success = otai_serialize_binary_put_byte(&w, OTAI_SERIALIZE_BINARY_VERSION) &&
+        otai_serialize_binary_put_attribute(&w, meta, attribute);
+
+    if (!success)
+    {
+        OTAI_META_LOG_WARN("failed to serialize attribute to binary, buffer size %zu", length);
+    }
+
+    return otai_serialize_binary_result(success, w.offset);
+}
+
+int otai_serialize_attribute_list_binary(
+        _Out_ uint8_t *buffer,
+        _In_ size_t length,
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    otai_serialize_binary_writer_t w = { buffer, length, 0 };
+
+    if (attr_count && attr_list == NULL)
+    {
+        OTAI_META_LOG_WARN("attr_list is NULL, but attr_count is %u", attr_count);
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    bool success = otai_serialize_binary_put_byte(&w, OTAI_SERIALIZE_BINARY_VERSION) &&
+        otai_serialize_binary_put_varint(&w, (uint64_t)object_type) &&
+        otai_serialize_binary_put_varint(&w, attr_count);
+
+    uint32_t idx = 0;
+
+    for (; success && idx < attr_count; idx++)
+    {
+        const otai_attr_metadata_t *meta = otai_metadata_get_attr_metadata(object_type, attr_list[idx].id);
+
+        success = otai_serialize_binary_put_attribute(&w, meta, &attr_list[idx]);
+    }
+
+    if (!success)
+    {
+        OTAI_META_LOG_WARN("failed to serialize attribute list to binary, buffer size %zu", length);
+    }
+
+    return otai_serialize_binary_result(success, w.offset);
+}
+
+static bool otai_deserialize_binary_get_byte(
+        _Inout_ otai_serialize_binary_reader_t *r,
+        _Out_ uint8_t *byte)
+{
+    if (r->offset >= r->length)
+    {
+        return false;
+    }
+
+    *byte = r->buffer[r->offset++];
+
+    return true;
+}
+
+static bool otai_deserialize_binary_get_varint(
+        _Inout_ otai_serialize_binary_reader_t *r,
+        _Out_ uint64_t *value)
+{
+    uint64_t result = 0;
+
+    int i = 0;
+
+    for (; i < OTAI_SERIALIZE_BINARY_MAX_VARINT_LENGTH; i++)
+    {
+        uint8_t byte;
+
+        if (!otai_deserialize_binary_get_byte(r, &byte))
+        {
+            return false;
+        }
+
+        if (i == OTAI_SERIALIZE_BINARY_MAX_VARINT_LENGTH - 1 && byte > 1)
+        {
+            return false; /* more than 64 bits */
+        }
+
+        result |= (uint64_t)(byte & 0x7f) << (7 * i);
+
+        if ((byte & 0x80) == 0)
+        {
+            *value = result;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool otai_deserialize_binary_get_varint_max(
+        _Inout_ otai_serialize_binary_reader_t *r,
+        _In_ uint64_t max,
+        _Out_ uint64_t *value)
+{
+    return otai_deserialize_binary_get_varint(r, value) && *value <= max;
+}
+
+static bool otai_deserialize_binary_get_zigzag(
+        _Inout_ otai_serialize_binary_reader_t *r,
+        _In_ int64_t min,
+        _In_ int64_t max,
+        _Out_ int64_t *value)
+{
+    uint64_t u64;
+
+    if (!otai_deserialize_binary_get_varint(r, &u64))
+    {
+        return false;
+    }
+
+    *value = (int64_t)(u64 >> 1) ^ -(int64_t)(u64 & 1);
+
+    return *value >= min && *value <= max;
+}
+
+static bool otai_deserialize_binary_get_fixed64(
+        _Inout_ otai_serialize_binary_reader_t *r,
+        _Out_ uint64_t *value)
+{
+    if (r->length - r->offset < sizeof(uint64_t))
+    {
+        return false;
+    }
+
+    uint64_t result = 0;
+
+    size_t i = 0;
+
+    for (; i < sizeof(uint64_t); i++)
+    {
+        result |= (uint64_t)r->buffer[r->offset++] << (8 * i);
+    }
+
+    *value = result;
+
+    return true;
+}
+
+/*
+ * In zero copy mode, data will point to elements inside input buffer,
+ * otherwise elements are copied to list and count on input is list capacity.
+ */
+static bool otai_deserialize_binary_get_list(
+        _Inout_ otai_serialize_binary_reader_t *r,
+        _In_ bool zero_copy,
+        _In_ size_t elemsize,
+        _In_ size_t wordsize,
+        _Inout_ uint32_t *count,
+        _Out_ void *list,
+        _Out_ const uint8_t **data)
+{
+    uint64_t n;
+
+    *data = NULL;
+
+    if (!otai_deserialize_binary_get_varint_max(r, UINT32_MAX, &n))
+    {
+        return false;
+    }
+
+    if (n == 0)
+    {
+        *count = 0;
+        return true;
+    }
+
+    while (r->offset % wordsize)
+    {
+        r->offset++;
+    }
+
+    if (r->offset > r->length || (r->length - r->offset) / elemsize < n)
+    {
+        return false;
+    }
+
+    const uint8_t *src = r->buffer + r->offset;
+
+    size_t size = (size_t)n * elemsize;
+
+    if (zero_copy)
+    {
+#ifdef OTAI_SERIALIZE_BINARY_BIG_ENDIAN
+        OTAI_META_LOG_WARN("zero copy is not supported on big endian host");
+        return false;
+#else
+        if ((uintptr_t)src % wordsize)
+        {
+            OTAI_META_LOG_WARN("zero copy requires aligned input buffer");
+            return false;
+        }
+
+        *data = src;
+#endif
+    }
+    else
+    {
+        if (*count < n)
+        {
+            OTAI_META_LOG_WARN("list capacity %u is too small, required %u", *count, (uint32_t)n);
+
+            *count = (uint32_t)n;
+            return false;
+        }
+
+        if (list == NULL)
+        {
+            OTAI_META_LOG_WARN("list is NULL, but count is %u", *count);
+            return false;
+        }
+
+#ifdef OTAI_SERIALIZE_BINARY_BIG_ENDIAN
+
+        uint8_t *dst = (uint8_t*)list;
+
+        size_t i = 0;
+
+        for (; i < size; i += wordsize)
+        {
+            size_t b = 0;
+
+            for (; b < wordsize; b++)
+            {
+                dst[i + b] = src[i + wordsize - 1 - b];
+            }
+        }
+
+#else
+
+        memcpy(list, src, size);
+
+#endif
+    }
+
+    *count = (uint32_t)n;
+
+    r->offset += size;
+
+    return true;
+}
+
+static bool otai_deserialize_binary_get_value(
+        _Inout_ otai_serialize_binary_reader_t *r,
+        _In_ const otai_attr_metadata_t *meta,
+        _In_ bool zero_copy,
+        _Inout_ otai_attribute_value_t *value)
+{
+    const uint8_t *data;
+    uint64_t u64;
+    int64_t s64;
+    uint8_t byte;
+
+    switch (meta->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_BOOL:
+
+            if (!otai_deserialize_binary_get_byte(r, &byte) || byte > 1)
+            {
+                return false;
+            }
+
+            value->booldata = (byte == 1);
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_CHARDATA:
+
+            if (!otai_deserialize_binary_get_varint_max(r, OTAI_CHARDATA_LENGTH, &u64) ||
+                    r->length - r->offset < u64)
+            {
+                return false;
+            }
+
+            memcpy(value->chardata, r->buffer + r->offset, (size_t)u64);
+            memset(value->chardata + u64, 0, OTAI_CHARDATA_LENGTH - (size_t)u64);
+
+            r->offset += (size_t)u64;
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT8:
+            return otai_deserialize_binary_get_byte(r, &value->u8);
+
+        case OTAI_ATTR_VALUE_TYPE_INT8:
+
+            if (!otai_deserialize_binary_get_byte(r, &byte))
+            {
+                return false;
+            }
+
+            value->s8 = (int8_t)byte;
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT16:
+
+            if (!otai_deserialize_binary_get_varint_max(r, UINT16_MAX, &u64))
+            {
+                return false;
+            }
+
+            value->u16 = (uint16_t)u64;
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_INT16:
+
+            if (!otai_deserialize_binary_get_zigzag(r, INT16_MIN, INT16_MAX, &s64))
+            {
+                return false;
+            }
+
+            value->s16 = (int16_t)s64;
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32:
+
+            if (!otai_deserialize_binary_get_varint_max(r, UINT32_MAX, &u64))
+            {
+                return false;
+            }
+
+            value->u32 = (uint32_t)u64;
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_INT32:
+
+            if (!otai_deserialize_binary_get_zigzag(r, INT32_MIN, INT32_MAX, &s64))
+            {
+                return false;
+            }
+
+            value->s32 = (int32_t)s64;
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT64:
+            return otai_deserialize_binary_get_varint(r, &value->u64);
+
+        case OTAI_ATTR_VALUE_TYPE_INT64:
+            return otai_deserialize_binary_get_zigzag(r, INT64_MIN, INT64_MAX, &value->s64);
+
+        case OTAI_ATTR_VALUE_TYPE_DOUBLE:
+
+            if (!otai_deserialize_binary_get_fixed64(r, &u64))
+            {
+                return false;
+            }
+
+            memcpy(&value->d64, &u64, sizeof(u64));
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_POINTER:
+
+            if (!otai_deserialize_binary_get_fixed64(r, &u64))
+            {
+                return false;
+            }
+
+            value->ptr = (otai_pointer_t)(uintptr_t)u64;
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_ID:
+            return otai_deserialize_binary_get_fixed64(r, &value->oid);
+
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+
+            if (!otai_deserialize_binary_get_list(r, zero_copy, sizeof(otai_object_id_t), sizeof(otai_object_id_t),
+                        &value->objlist.count, value->objlist.list, &data))
+            {
+                return false;
+            }
+
+            if (zero_copy)
+            {
+                value->objlist.list = (otai_object_id_t*)(uintptr_t)data;
+            }
+
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+
+            if (!otai_deserialize_binary_get_list(r, zero_copy, sizeof(uint8_t), sizeof(uint8_t),
+                        &value->u8list.count, value->u8list.list, &data))
+            {
+                return false;
+            }
+
+            if (zero_copy)
+            {
+                value->u8list.list = (uint8_t*)(uintptr_t)data;
+            }
+
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+
+            if (!otai_deserialize_binary_get_list(r, zero_copy, sizeof(int8_t), sizeof(int8_t),
+                        &value->s8list.count, value->s8list.list, &data))
+            {
+                return false;
+            }
+
+            if (zero_copy)
+            {
+                value->s8list.list = (int8_t*)(uintptr_t)data;
+            }
+
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+
+            if (!otai_deserialize_binary_get_list(r, zero_copy, sizeof(uint16_t), sizeof(uint16_t),
+                        &value->u16list.count, value->u16list.list, &data))
+            {
+                return false;
+            }
+
+            if (zero_copy)
+            {
+                value->u16list.list = (uint16_t*)(uintptr_t)data;
+            }
+
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+
+            if (!otai_deserialize_binary_get_list(r, zero_copy, sizeof(int16_t), sizeof(int16_t),
+                        &value->s16list.count, value->s16list.list, &data))
+            {
+                return false;
+            }
+
+            if (zero_copy)
+            {
+                value->s16list.list = (int16_t*)(uintptr_t)data;
+            }
+
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+
+            if (!otai_deserialize_binary_get_list(r, zero_copy, sizeof(uint32_t), sizeof(uint32_t),
+                        &value->u32list.count, value->u32list.list, &data))
+            {
+                return false;
+            }
+
+            if (zero_copy)
+            {
+                value->u32list.list = (uint32_t*)(uintptr_t)data;
+            }
+
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+
+            if (!otai_deserialize_binary_get_list(r, zero_copy, sizeof(int32_t), sizeof(int32_t),
+                        &value->s32list.count, value->s32list.list, &data))
+            {
+                return false;
+            }
+
+            if (zero_copy)
+            {
+                value->s32list.list = (int32_t*)(uintptr_t)data;
+            }
+
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_UINT32_RANGE:
+
+            if (!otai_deserialize_binary_get_varint_max(r, UINT32_MAX, &u64))
+            {
+                return false;
+            }
+
+            value->u32range.min = (uint32_t)u64;
+
+            if (!otai_deserialize_binary_get_varint_max(r, UINT32_MAX, &u64))
+            {
+                return false;
+            }
+
+            value->u32range.max = (uint32_t)u64;
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_INT32_RANGE:
+
+            if (!otai_deserialize_binary_get_zigzag(r, INT32_MIN, INT32_MAX, &s64))
+            {
+                return false;
+            }
+
+            value->s32range.min = (int32_t)s64;
+
+            if (!otai_deserialize_binary_get_zigzag(r, INT32_MIN, INT32_MAX, &s64))
+            {
+                return false;
+            }
+
+            value->s32range.max = (int32_t)s64;
+            return true;
+
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+
+            if (!otai_deserialize_binary_get_list(r, zero_copy, sizeof(otai_spectrum_power_t), sizeof(uint64_t),
+                        &value->spectrumpowerlist.count, value->spectrumpowerlist.list, &data))
+            {
+                return false;
+            }
+
+            if (zero_copy)
+            {
+                value->spectrumpowerlist.list = (otai_spectrum_power_t*)(uintptr_t)data;
+            }
+
+            return true;
+
+        default:
+            OTAI_META_LOG_WARN("attr value type %d is not supported", meta->attrvaluetype);
+            return false;
+    }
+}
+
+static bool otai_deserialize_binary_get_attribute(
+        _Inout_ otai_serialize_binary_reader_t *r,
+        _In_ otai_object_type_t object_type,
+        _In_ bool zero_copy,
+        _Inout_ otai_attribute_t *attribute)
+{
+    uint64_t id;
+    uint8_t type;
+
+    if (!otai_deserialize_binary_get_varint_max(r, UINT32_MAX, &id) ||
+            !otai_deserialize_binary_get_byte(r, &type))
+    {
+        return false;
+    }
+
+    const otai_attr_metadata_t *meta = otai_metadata_get_attr_metadata(object_type, (otai_attr_id_t)id);
+
+    if (meta == NULL)
+    {
+        OTAI_META_LOG_WARN("attribute id %u not found on object type %d", (uint32_t)id, object_type);
+        return false;
+    }
+
+    if (type != meta->attrvaluetype)
+    {
+        OTAI_META_LOG_WARN("attribute %s value type %u does not match %d", meta->attridname, type, meta->attrvaluetype);
+        return false;
+    }
+
+    attribute->id = (otai_attr_id_t)id;
+
+    return otai_deserialize_binary_get_value(r, meta, zero_copy, &attribute->value);
+}
+
+static bool otai_deserialize_binary_get_version(
+        _Inout_ otai_serialize_binary_reader_t *r)
+{
+    uint8_t version;
+
+    if (!otai_deserialize_binary_get_byte(r, &version))
+    {
+        return false;
+    }
+
+    if (version == 0 || version > OTAI_SERIALIZE_BINARY_VERSION)
+    {
+        OTAI_META_LOG_WARN("binary version %u is not supported", version);
+        return false;
+    }
+
+    return true;
+}
+
+int otai_deserialize_attribute_binary(
+        _In_ const uint8_t *buffer,
+        _In_ size_t length,
+        _In_ otai_object_type_t object_type,
+        _In_ bool zero_copy,
+        _Inout_ otai_attribute_t *attribute)
+{
+    otai_serialize_binary_reader_t r = { buffer, length, 0 };
+
+    if (buffer == NULL || attribute == NULL)
+    {
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    bool success = otai_deserialize_binary_get_version(&r) &&
+        otai_deserialize_binary_get_attribute(&r, object_type, zero_copy, attribute);
+
+    if (!success)
+    {
+        OTAI_META_LOG_WARN("failed to deserialize binary attribute at offset %zu", r.offset);
+    }
+
+    return otai_serialize_binary_result(success, r.offset);
+}
+
+int otai_deserialize_attribute_list_binary(
+        _In_ const uint8_t *buffer,
+        _In_ size_t length,
+        _In_ otai_object_type_t object_type,
+        _In_ bool zero_copy,
+        _Inout_ uint32_t *attr_count,
+        _Inout_ otai_attribute_t *attr_list)
+{
+    otai_serialize_binary_reader_t r = { buffer, length, 0 };
+
+    uint64_t ot;
+    uint64_t count;
+
+    if (buffer == NULL || attr_count == NULL)
+    {
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    if (!otai_deserialize_binary_get_version(&r) ||
+            !otai_deserialize_binary_get_varint(&r, &ot) ||
+            !otai_deserialize_binary_get_varint_max(&r, UINT32_MAX, &count))
+    {
+        OTAI_META_LOG_WARN("failed to deserialize binary attribute list header");
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    if (ot != (uint64_t)object_type)
+    {
+        OTAI_META_LOG_WARN("object type %u does not match expected %d", (uint32_t)ot, object_type);
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    if (count > *attr_count || (count && attr_list == NULL))
+    {
+        OTAI_META_LOG_WARN("attribute list capacity %u is too small, required %u", *attr_count, (uint32_t)count);
+
+        *attr_count = (uint32_t)count;
+        return OTAI_SERIALIZE_ERROR;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < count; idx++)
+    {
+        if (!otai_deserialize_binary_get_attribute(&r, object_type, zero_copy, &attr_list[idx]))
+        {
+            OTAI_META_LOG_WARN("failed to deserialize binary attribute %u at offset %zu", idx, r.offset);
+            return OTAI_SERIALIZE_ERROR;
+        }
+    }
+
+    *attr_count = (uint32_t)count;
+
+    return otai_serialize_binary_result(true, r.offset);
+}
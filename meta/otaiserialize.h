@@ -336,6 +336,11 @@ int otai_deserialize_int64(
 /**
  * @brief Serialize double.
  *
+ * Shortest representation which parses back to the same value is
+ * written, in exponent notation for very small or very large values.
+ * Use otai_serialize_double_precision() when fixed number of decimals is
+ * needed.
+ *
  * @param[out] buffer Output buffer for serialized value.
  * @param[in] d64 Double to be serialized.
  *
@@ -346,6 +351,45 @@ int otai_serialize_double(
         _Out_ char *buffer,
         _In_ otai_double_t d64);
 
+/**
+ * @brief Serialize double with statistics value precision.
+ *
+ * Value is rounded to precision decimal places, same as by printf
+ * "%.*f". #OTAI_STAT_VALUE_PRECISION_18 is beyond double precision, so
+ * shortest round trip representation is used, same as in
+ * otai_serialize_double(). Infinity, NaN and values whose magnitude
+ * times 10^precision is 2^64 or more are also written in shortest form.
+ *
+ * @param[out] buffer Output buffer for serialized value.
+ * @param[in] d64 Double to be serialized.
+ * @param[in] precision Statistics value precision.
+ *
+ * @return Number of characters written to buffer excluding '\0',
+ * or #OTAI_SERIALIZE_ERROR on error.
+ */
+int otai_serialize_double_precision(
+        _Out_ char *buffer,
+        _In_ otai_double_t d64,
+        _In_ otai_stat_value_precision_t precision);
+
+/**
+ * @brief Serialize OTAI statistics value.
+ *
+ * Value member is selected by statistics value type, double values are
+ * written with statistics value precision.
+ *
+ * @param[out] buffer Output buffer for serialized value.
+ * @param[in] meta Statistics metadata.
+ * @param[in] value Statistics value to be serialized.
+ *
+ * @return Number of characters written to buffer excluding '\0',
+ * or #OTAI_SERIALIZE_ERROR on error.
+ */
+int otai_serialize_stat_value(
+        _Out_ char *buffer,
+        _In_ const otai_stat_metadata_t *meta,
+        _In_ const otai_stat_value_t *value);
+
 /**
  * @brief Deserialize double.
  *
@@ -491,15 +535,180 @@ int otai_serialize_attribute(
 /**
  * @brief Deserialize OTAI attribute.
  *
+ * Buffer is parsed in single pass and no memory is allocated. For list
+ * values, attribute list count and list pointer must be set by caller to
+ * list capacity and list buffer. If list is too small, count is set to
+ * required number of elements and error is returned.
+ *
  * @param[in] buffer Input buffer to be examined.
- * @param[out] attribute Deserialized value.
+ * @param[inout] attribute Deserialized value.
  *
  * @return Number of characters consumed from the buffer,
  * or #OTAI_SERIALIZE_ERROR on error.
  */
 int otai_deserialize_attribute(
         _In_ const char *buffer,
-        _Out_ otai_attribute_t *attribute);
+        _Inout_ otai_attribute_t *attribute);
+
+/**
+ * @brief Deserialize OTAI attribute list.
+ *
+ * Input is JSON array of serialized attributes. Buffer is parsed in single
+ * pass and list values are placed in caller provided arena, so all lists
+ * are valid as long as arena is valid and no memory is allocated.
+ *
+ * @param[in] buffer Input buffer to be examined.
+ * @param[out] arena Memory used for list values.
+ * @param[in] arena_size Size of arena in bytes.
+ * @param[inout] attr_count Attribute list capacity on input, number of
+ * deserialized attributes on output.
+ * @param[out] attr_list Deserialized attributes.
+ *
+ * @return Number of characters consumed from the buffer,
+ * or #OTAI_SERIALIZE_ERROR on error.
+ */
+int otai_deserialize_attribute_list(
+        _In_ const char *buffer,
+        _Out_ uint8_t *arena,
+        _In_ size_t arena_size,
+        _Inout_ uint32_t *attr_count,
+        _Out_ otai_attribute_t *attr_list);
+
+/**
+ * @brief Serialize APS report switch info notification.
+ *
+ * Output is JSON object with "aps_id" and "switch_info" keys. It is the
+ * same for by value and by reference notification.
+ *
+ * @param[out] buf Output buffer for serialized notification.
+ * @param[in] aps_id APS id.
+ * @param[in] switch_info Switch info.
+ *
+ * @return Number of characters written to buffer excluding '\0',
+ * or #OTAI_SERIALIZE_ERROR on error.
+ */
+int otai_serialize_aps_report_switch_info(
+        _Out_ char *buf,
+        _In_ otai_object_id_t aps_id,
+        _In_ const otai_olp_switch_t *switch_info);
+
+/**
+ * @brief Deserialize APS report switch info notification.
+ *
+ * @param[in] buffer Input buffer to be examined.
+ * @param[out] aps_id Deserialized APS id.
+ * @param[out] switch_info Deserialized switch info.
+ *
+ * @return Number of characters consumed from the buffer,
+ * or #OTAI_SERIALIZE_ERROR on error.
+ */
+int otai_deserialize_aps_report_switch_info(
+        _In_ const char *buffer,
+        _Out_ otai_object_id_t *aps_id,
+        _Out_ otai_olp_switch_t *switch_info);
+
+/**
+ * @def OTAI_SERIALIZE_BINARY_VERSION
+ *
+ * Version of binary attribute encoding, written as first byte of encoded
+ * attribute or attribute list. Decoder rejects newer versions.
+ */
+#define OTAI_SERIALIZE_BINARY_VERSION 1
+
+/**
+ * @brief Serialize OTAI attribute to binary format.
+ *
+ * Encoded attribute is: version byte, attribute id as variable length
+ * integer, attribute value type byte and value. Unsigned integers are
+ * encoded as variable length integers, signed integers are zigzag encoded
+ * first. Double, pointer and object id are 8 bytes little endian. Char data
+ * is encoded as length followed by characters. Lists are encoded as count,
+ * zero padding to element alignment (relative to buffer start) and little
+ * endian elements, so they can be decoded without copy.
+ *
+ * @param[out] buffer Output buffer for serialized value.
+ * @param[in] length Size of output buffer in bytes.
+ * @param[in] meta Attribute metadata.
+ * @param[in] attribute Attribute to be serialized.
+ *
+ * @return Number of bytes written to buffer,
+ * or #OTAI_SERIALIZE_ERROR on error.
+ */
+int otai_serialize_attribute_binary(
+        _Out_ uint8_t *buffer,
+        _In_ size_t length,
+        _In_ const otai_attr_metadata_t *meta,
+        _In_ const otai_attribute_t *attribute);
+
+/**
+ * @brief Deserialize OTAI attribute from binary format.
+ *
+ * When zero copy is requested, list members of attribute value will point
+ * directly into input buffer, which must outlive attribute and must be 8
+ * bytes aligned. Zero copy is not supported on big endian hosts. Otherwise
+ * list values are copied to lists provided by caller, where count member
+ * specifies list capacity, like in get attribute API.
+ *
+ * @param[in] buffer Input buffer to be examined.
+ * @param[in] length Size of input buffer in bytes.
+ * @param[in] object_type Object type of serialized attribute.
+ * @param[in] zero_copy Point list values into input buffer.
+ * @param[inout] attribute Deserialized value.
+ *
+ * @return Number of bytes consumed from the buffer,
+ * or #OTAI_SERIALIZE_ERROR on error.
+ */
+int otai_deserialize_attribute_binary(
+        _In_ const uint8_t *buffer,
+        _In_ size_t length,
+        _In_ otai_object_type_t object_type,
+        _In_ bool zero_copy,
+        _Inout_ otai_attribute_t *attribute);
+
+/**
+ * @brief Serialize OTAI attribute list to binary format.
+ *
+ * Encoded list is: version byte, object type and attribute count as
+ * variable length integers, followed by attributes encoded as in
+ * otai_serialize_attribute_binary without version byte.
+ *
+ * @param[out] buffer Output buffer for serialized value.
+ * @param[in] length Size of output buffer in bytes.
+ * @param[in] object_type Object type of attributes.
+ * @param[in] attr_count Number of attributes.
+ * @param[in] attr_list Attribute list to be serialized.
+ *
+ * @return Number of bytes written to buffer,
+ * or #OTAI_SERIALIZE_ERROR on error.
+ */
+int otai_serialize_attribute_list_binary(
+        _Out_ uint8_t *buffer,
+        _In_ size_t length,
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list);
+
+/**
+ * @brief Deserialize OTAI attribute list from binary format.
+ *
+ * @param[in] buffer Input buffer to be examined.
+ * @param[in] length Size of input buffer in bytes.
+ * @param[in] object_type Expected object type of attributes.
+ * @param[in] zero_copy Point list values into input buffer.
+ * @param[inout] attr_count Capacity of attribute list on input, number of
+ * deserialized attributes on output.
+ * @param[inout] attr_list Deserialized attributes.
+ *
+ * @return Number of bytes consumed from the buffer,
+ * or #OTAI_SERIALIZE_ERROR on error.
+ */
+int otai_deserialize_attribute_list_binary(
+        _In_ const uint8_t *buffer,
+        _In_ size_t length,
+        _In_ otai_object_type_t object_type,
+        _In_ bool zero_copy,
+        _Inout_ uint32_t *attr_count,
+        _Inout_ otai_attribute_t *attr_list);
 
 /**
  * @}
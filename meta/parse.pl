@@ -59,6 +59,7 @@ our %EXTENSIONS_ATTRS = ();
 our %EXPERIMENTAL_OBJECTS = ();
 our %OBJECT_TYPE_TO_STATS_MAP = ();
 our %OBJECT_TYPE_TO_ALARMS_MAP = ();
+our %ENUM_NUMERIC_VALUES = ();
 our %ATTR_TO_CALLBACK = ();
 our %PRIMITIVE_TYPES = ();
 
@@ -1091,6 +1092,16 @@ sub ProcessSingleEnum
 
     my $count = @values;
 
+    # values were stripped of prefix when writing short names
+
+    @values = @{$enum->{values}};
+
+    my ($indexbase, $indexcount, $hasvalueshash) = ProcessEnumValuesIndex($typedef, @values);
+
+    my @names = map { [ 0, $_ ] } @values;
+
+    WriteNameHash("otai_metadata_${typedef}_enum_values_names_hash", @names);
+
     WriteHeader "extern const otai_enum_metadata_t otai_metadata_enum_$typedef;";
 
     WriteSource "const otai_enum_metadata_t otai_metadata_enum_$typedef = {";
@@ -1112,11 +1123,190 @@ sub ProcessSingleEnum
         WriteSource ".ignorevaluesnames = NULL,";
     }
 
+    if ($indexcount > 0)
+    {
+        WriteSource ".valuesindexbase   = $indexbase,";
+        WriteSource ".valuesindex       = otai_metadata_${typedef}_enum_values_index,";
+        WriteSource ".valuesindexcount  = $indexcount,";
+    }
+    else
+    {
+        WriteSource ".valuesindexbase   = 0,";
+        WriteSource ".valuesindex       = NULL,";
+        WriteSource ".valuesindexcount  = 0,";
+    }
+
+    if ($hasvalueshash)
+    {
+        WriteSource ".valueshash        = &otai_metadata_${typedef}_enum_values_hash,";
+    }
+    else
+    {
+        WriteSource ".valueshash        = NULL,";
+    }
+
+    WriteSource ".valuesnameshash   = &otai_metadata_${typedef}_enum_values_names_hash,";
+
     WriteSource "};";
 
     return $count;
 }
 
+sub GetEnumNumericValue
+{
+    my $value = shift;
+
+    return $ENUM_NUMERIC_VALUES{$value} if defined $ENUM_NUMERIC_VALUES{$value};
+
+    return EvaluateEnumInitializer($EXTRA_RANGE_DEFINES{$value}) if defined $EXTRA_RANGE_DEFINES{$value};
+
+    return undef;
+}
+
+sub ProcessEnumValuesIndex
+{
+    #
+    # Generates direct index table for dense enums, and value hash for sparse
+    # enums like flags or statuses. Tables are only hints, since each found
+    # index is verified against values array, so when numeric value can't be
+    # evaluated here, no table is generated and linear search is used.
+    #
+
+    my ($typedef, @values) = @_;
+
+    my @numbers = map { GetEnumNumericValue($_) } @values;
+
+    my $count = @values;
+
+    return (0, 0, 0) if $count == 0;
+
+    if (grep { not defined $_ } @numbers)
+    {
+        LogInfo "not all numeric values of $typedef are known, skipping values index";
+        return (0, 0, 0);
+    }
+
+    my @sorted = sort { $a <=> $b } @numbers;
+
+    my $min = $sorted[0];
+    my $max = $sorted[$#sorted];
+
+    my $span = $max - $min + 1;
+
+    if ($span <= 2 * $count)
+    {
+        my @index = (-1) x $span;
+
+        # when values are duplicated, first one wins like in linear search
+
+        for my $idx (reverse 0..$#numbers)
+        {
+            $index[$numbers[$idx] - $min] = $idx;
+        }
+
+        WriteSource "const int32_t otai_metadata_${typedef}_enum_values_index[] = {";
+
+        for (my $idx = 0; $idx < $span; $idx += 16)
+        {
+            my $last = ($idx + 15 < $span) ? $idx + 15 : $span - 1;
+
+            WriteSource join(", ", @index[$idx..$last]) . ",";
+        }
+
+        WriteSource "};";
+
+        return ($min, $span, 0);
+    }
+
+    my @keys = ();
+    my %seen = ();
+
+    for my $idx (0..$#numbers)
+    {
+        next if defined $seen{$numbers[$idx]};
+
+        $seen{$numbers[$idx]} = 1;
+
+        push @keys, [ $numbers[$idx] & 0xffffffff, "", $idx ];
+    }
+
+    WriteNameHash("otai_metadata_${typedef}_enum_values_hash", @keys);
+
+    return (0, 0, 1);
+}
+
+sub EvaluateEnumInitializer
+{
+    my $init = shift;
+
+    return undef if not defined $init;
+
+    $init =~ s/\b(0x[0-9a-fA-F]+|\d+)[uUlL]+\b/$1/g;
+
+    while ($init =~ /\b([A-Za-z_]\w*)\b/)
+    {
+        my $name = $1;
+
+        return undef if not defined $ENUM_NUMERIC_VALUES{$name};
+
+        my $number = $ENUM_NUMERIC_VALUES{$name};
+
+        $init =~ s/\b$name\b/($number)/g;
+    }
+
+    return undef if not $init =~ /^[\s\d()<>|&+\-~xa-fA-F]+$/;
+
+    my $value = eval $init;
+
+    return undef if $@ or not defined $value;
+
+    return $value;
+}
+
+sub ExtractEnumNumericValues
+{
+    #
+    # Enum values are known only by compiler, so to generate lookup tables
+    # initializers are evaluated directly from headers. Only simple
+    # expressions are supported: numbers, shifts, bit or, addition and
+    # references to previous enum values.
+    #
+
+    my @headers = (GetHeaderFiles(), GetMetaHeaderFiles());
+
+    for my $header (@headers)
+    {
+        next if $header eq "otaimetadata.h";
+
+        my $data = ReadHeaderFile($header);
+
+        $data =~ s!/\*.*?\*/!!gs;
+        $data =~ s!//[^\n]*!!g;
+
+        while ($data =~ /typedef\s+enum\s+_\w+\s*{(.*?)}\s*\w+\s*;/gs)
+        {
+            my $next = 0;
+
+            for my $item (split /,/, $1)
+            {
+                next if not $item =~ /^\s*(\w+)\s*(?:=\s*(.+?))?\s*$/s;
+
+                my $name = $1;
+
+                $next = EvaluateEnumInitializer($2) if defined $2;
+
+                if (not defined $next)
+                {
+                    LogDebug "can't evaluate numeric value of $name";
+                    next;
+                }
+
+                $ENUM_NUMERIC_VALUES{$name} = $next++;
+            }
+        }
+    }
+}
+
 sub ProcessExtraRangeDefines
 {
     WriteSectionComment "Enums metadata";
@@ -1134,6 +1324,8 @@ sub CreateMetadataHeaderAndSource
     WriteSource "#include <stdlib.h>";
     WriteSource "#include <stddef.h>";
     WriteSource "#include \"otaimetadata.h\"";
+    WriteSource "#include \"otaimetadatainstrument.h\"";
+    WriteSource "#include \"otaimetadatarecorder.h\"";
 
     WriteSectionComment "Enums metadata";
 
@@ -2143,6 +2335,10 @@ sub ProcessOtaiStatus
 
         push@values,$status;
 
+        (my $number = $base) =~ s/L$//;
+
+        $ENUM_NUMERIC_VALUES{$status} = -hex($number);
+
         next if not ($status =~ /(OTAI_\w+)_0$/);
 
         for my $idx (1..10)
@@ -2152,6 +2348,8 @@ sub ProcessOtaiStatus
             WriteHeader "#define $status  OTAI_STATUS_CODE(($base + ${idx}))";
 
             push@values,$status;
+
+            $ENUM_NUMERIC_VALUES{$status} = -(hex($number) + $idx);
         }
     }
 
@@ -2886,6 +3084,159 @@ sub ProcessClearStats
     return "otai_metadata_generic_clear_stats_$ot";
 }
 
+sub GetBulkApiName
+{
+    my $small = shift;
+
+    return ($small =~ /s$/) ? "${small}es" : "${small}s";
+}
+
+sub GetBulkApiPointer
+{
+    my ($struct, $ot, $member) = @_;
+
+    # native bulk api is only defined for object id objects
+
+    return "NULL" if defined $struct;
+
+    my $api = $OBJTOAPIMAP{$ot};
+
+    return "(otai_metadata_otai_${api}_api == NULL) ? NULL : otai_metadata_otai_${api}_api->$member";
+}
+
+sub ProcessBulkCreate
+{
+    my $struct = shift;
+    my $ot = shift;
+
+    my $small = lc($1) if $ot =~ /OTAI_OBJECT_TYPE_(\w+)/;
+
+    my $bulk = GetBulkApiName($small);
+
+    my $native = GetBulkApiPointer($struct, $ot, "create_$bulk");
+
+    WriteSource "otai_status_t otai_metadata_generic_bulk_create_$ot(";
+    WriteSource "_In_ otai_object_id_t linecard_id,";
+    WriteSource "_In_ uint32_t object_count,";
+    WriteSource "_Inout_ otai_object_meta_key_t *meta_key,";
+    WriteSource "_In_ const uint32_t *attr_count,";
+    WriteSource "_In_ const otai_attribute_t **attr_list,";
+    WriteSource "_In_ otai_bulk_op_error_mode_t mode,";
+    WriteSource "_Out_ otai_status_t *object_statuses)";
+    WriteSource "{";
+    WriteSource "return otai_metadata_bulk_create($native, otai_metadata_generic_create_$ot, linecard_id, object_count, meta_key, attr_count, attr_list, mode, object_statuses);";
+    WriteSource "}";
+
+    return "otai_metadata_generic_bulk_create_$ot";
+}
+
+sub ProcessBulkRemove
+{
+    my $struct = shift;
+    my $ot = shift;
+
+    my $small = lc($1) if $ot =~ /OTAI_OBJECT_TYPE_(\w+)/;
+
+    my $bulk = GetBulkApiName($small);
+
+    my $native = GetBulkApiPointer($struct, $ot, "remove_$bulk");
+
+    WriteSource "otai_status_t otai_metadata_generic_bulk_remove_$ot(";
+    WriteSource "_In_ uint32_t object_count,";
+    WriteSource "_In_ const otai_object_meta_key_t *meta_key,";
+    WriteSource "_In_ otai_bulk_op_error_mode_t mode,";
+    WriteSource "_Out_ otai_status_t *object_statuses)";
+    WriteSource "{";
+    WriteSource "return otai_metadata_bulk_remove($native, otai_metadata_generic_remove_$ot, object_count, meta_key, mode, object_statuses);";
+    WriteSource "}";
+
+    return "otai_metadata_generic_bulk_remove_$ot";
+}
+
+sub ProcessBulkSet
+{
+    my $struct = shift;
+    my $ot = shift;
+
+    my $small = lc($1) if $ot =~ /OTAI_OBJECT_TYPE_(\w+)/;
+
+    my $bulk = GetBulkApiName($small);
+
+    my $native = GetBulkApiPointer($struct, $ot, "set_${bulk}_attribute");
+
+    WriteSource "otai_status_t otai_metadata_generic_bulk_set_$ot(";
+    WriteSource "_In_ uint32_t object_count,";
+    WriteSource "_In_ const otai_object_meta_key_t *meta_key,";
+    WriteSource "_In_ const otai_attribute_t *attr_list,";
+    WriteSource "_In_ otai_bulk_op_error_mode_t mode,";
+    WriteSource "_Out_ otai_status_t *object_statuses)";
+    WriteSource "{";
+    WriteSource "return otai_metadata_bulk_set($native, otai_metadata_generic_set_$ot, object_count, meta_key, attr_list, mode, object_statuses);";
+    WriteSource "}";
+
+    return "otai_metadata_generic_bulk_set_$ot";
+}
+
+sub ProcessBulkGet
+{
+    my $struct = shift;
+    my $ot = shift;
+
+    my $small = lc($1) if $ot =~ /OTAI_OBJECT_TYPE_(\w+)/;
+
+    my $bulk = GetBulkApiName($small);
+
+    my $native = GetBulkApiPointer($struct, $ot, "get_${bulk}_attribute");
+
+    WriteSource "otai_status_t otai_metadata_generic_bulk_get_$ot(";
+    WriteSource "_In_ uint32_t object_count,";
+    WriteSource "_In_ const otai_object_meta_key_t *meta_key,";
+    WriteSource "_In_ const uint32_t *attr_count,";
+    WriteSource "_Inout_ otai_attribute_t **attr_list,";
+    WriteSource "_In_ otai_bulk_op_error_mode_t mode,";
+    WriteSource "_Out_ otai_status_t *object_statuses)";
+    WriteSource "{";
+    WriteSource "return otai_metadata_bulk_get($native, otai_metadata_generic_get_$ot, object_count, meta_key, attr_count, attr_list, mode, object_statuses);";
+    WriteSource "}";
+
+    return "otai_metadata_generic_bulk_get_$ot";
+}
+
+sub ProcessBulkGetStats
+{
+    my $struct = shift;
+    my $ot = shift;
+
+    my $small = lc($1) if $ot =~ /OTAI_OBJECT_TYPE_(\w+)/;
+
+    my $bulk = GetBulkApiName($small);
+
+    my $native = GetBulkApiPointer($struct, $ot, "get_${bulk}_stats");
+
+    WriteSource "otai_status_t otai_metadata_generic_bulk_get_stats_$ot(";
+    WriteSource "_In_ uint32_t object_count,";
+    WriteSource "_In_ const otai_object_meta_key_t *meta_key,";
+    WriteSource "_In_ uint32_t number_of_counters,";
+    WriteSource "_In_ const otai_stat_id_t *counter_ids,";
+    WriteSource "_In_ otai_stats_mode_t mode,";
+    WriteSource "_Out_ otai_status_t *object_statuses,";
+    WriteSource "_Out_ otai_stat_value_t *counters)";
+    WriteSource "{";
+
+    if (not defined $OBJECT_TYPE_TO_STATS_MAP{$small})
+    {
+        WriteSource "return OTAI_STATUS_NOT_SUPPORTED;";
+    }
+    else
+    {
+        WriteSource "return otai_metadata_bulk_get_stats($native, otai_metadata_generic_get_stats_ext_$ot, object_count, meta_key, number_of_counters, counter_ids, mode, object_statuses, counters);";
+    }
+
+    WriteSource "}";
+
+    return "otai_metadata_generic_bulk_get_stats_$ot";
+}
+
 sub CreateApis
 {
     WriteSectionComment "Global OTAI API declarations";
@@ -2988,6 +3339,296 @@ sub CreateApisQuery
     WriteHeader "_Inout_ otai_apis_t *apis);";
 }
 
+sub GetInstrumentSignature
+{
+    my ($api, $type) = @_;
+
+    # each signature is: operation, parameters, call arguments, recorded id
+
+    my $any = "OTAI_METADATA_INSTRUMENT_ID_ANY";
+    my $attrid = "(attr_count == 1 && attr_list != NULL) ? attr_list[0].id : $any";
+    my $statid = "(number_of_counters == 1 && counter_ids != NULL) ? counter_ids[0] : $any";
+
+    my @stats = ("_In_ uint32_t number_of_counters", "_In_ const otai_stat_id_t *counter_ids");
+
+    if ($type eq "otai_create_${api}_fn" and $api eq "linecard")
+    {
+        return ("CREATE", [ "_Out_ otai_object_id_t *object_id", "_In_ uint32_t attr_count", "_In_ const otai_attribute_t *attr_list" ], $any);
+    }
+
+    if ($type eq "otai_create_${api}_fn")
+    {
+        return ("CREATE", [ "_Out_ otai_object_id_t *object_id", "_In_ otai_object_id_t linecard_id", "_In_ uint32_t attr_count", "_In_ const otai_attribute_t *attr_list" ], $any);
+    }
+
+    return ("REMOVE", [ "_In_ otai_object_id_t object_id" ], $any) if $type eq "otai_remove_${api}_fn";
+
+    return ("SET", [ "_In_ otai_object_id_t object_id", "_In_ const otai_attribute_t *attr" ], "(attr != NULL) ? attr->id : $any") if $type eq "otai_set_${api}_attribute_fn";
+
+    return ("GET", [ "_In_ otai_object_id_t object_id", "_In_ uint32_t attr_count", "_Inout_ otai_attribute_t *attr_list" ], $attrid) if $type eq "otai_get_${api}_attribute_fn";
+
+    return ("GET_STATS", [ "_In_ otai_object_id_t object_id", @stats, "_Out_ otai_stat_value_t *counters" ], $statid) if $type eq "otai_get_${api}_stats_fn";
+
+    return ("GET_STATS_EXT", [ "_In_ otai_object_id_t object_id", @stats, "_In_ otai_stats_mode_t mode", "_Out_ otai_stat_value_t *counters" ], $statid) if $type eq "otai_get_${api}_stats_ext_fn";
+
+    return ("CLEAR_STATS", [ "_In_ otai_object_id_t object_id", @stats ], $statid) if $type eq "otai_clear_${api}_stats_fn";
+
+    my @bulk = ("_In_ uint32_t object_count", "_In_ const otai_object_id_t *object_id");
+
+    if ($type eq "otai_bulk_object_create_fn")
+    {
+        return ("BULK_CREATE", [ "_In_ otai_object_id_t linecard_id", "_In_ uint32_t object_count", "_In_ const uint32_t *attr_count",
+                "_In_ const otai_attribute_t **attr_list", "_In_ otai_bulk_op_error_mode_t mode", "_Out_ otai_object_id_t *object_id",
+                "_Out_ otai_status_t *object_statuses" ], $any);
+    }
+
+    return ("BULK_REMOVE", [ @bulk, "_In_ otai_bulk_op_error_mode_t mode", "_Out_ otai_status_t *object_statuses" ], $any) if $type eq "otai_bulk_object_remove_fn";
+
+    if ($type eq "otai_bulk_object_set_attribute_fn")
+    {
+        return ("BULK_SET", [ @bulk, "_In_ const otai_attribute_t *attr_list", "_In_ otai_bulk_op_error_mode_t mode", "_Out_ otai_status_t *object_statuses" ], $any);
+    }
+
+    if ($type eq "otai_bulk_object_get_attribute_fn")
+    {
+        return ("BULK_GET", [ @bulk, "_In_ const uint32_t *attr_count", "_Inout_ otai_attribute_t **attr_list",
+                "_In_ otai_bulk_op_error_mode_t mode", "_Out_ otai_status_t *object_statuses" ], $any);
+    }
+
+    if ($type eq "otai_bulk_object_get_stats_fn")
+    {
+        return ("BULK_GET_STATS", [ @bulk, @stats, "_In_ otai_stats_mode_t mode", "_Out_ otai_status_t *object_statuses",
+                "_Out_ otai_stat_value_t *counters" ], $statid);
+    }
+
+    # other methods are passed through
+
+    return ();
+}
+
+sub ExtractApiMembers
+{
+    my $api = shift;
+
+    for my $header (GetHeaderFiles())
+    {
+        my $data = ReadHeaderFile($header);
+
+        next if not $data =~ m!typedef\s+struct\s+_otai_${api}_api_t\s*\{(.+?)\}\s*otai_${api}_api_t;!s;
+
+        my $members = $1;
+
+        return $members =~ /(otai_\w+_fn)\s+(\w+);/g;
+    }
+
+    LogError "api struct otai_${api}_api_t members not found";
+
+    return ();
+}
+
+sub CreateApiShim
+{
+    my ($shim, $body) = @_;
+
+    #
+    # Generates method tables of the same type as adapter ones, whose
+    # methods call adapter through $body, one table per api, and
+    # otai_metadata_${shim}_wrap_api which fills them from adapter tables
+    #
+    # Other threads may call through tables while api is queried again, so
+    # new table is allocated and published with atomic exchange, and old
+    # one is never freed. Methods load adapter table with acquire.
+    #
+
+    for my $api (sort keys %APITOOBJMAP)
+    {
+        my $ot = $APITOOBJMAP{$api}->[0];
+
+        next if not defined $ot;
+
+        my $API = uc("OTAI_API_${api}");
+
+        my $native = "otai_metadata_${shim}_native_${api}_api";
+
+        WriteSource "const otai_${api}_api_t *$native = NULL;";
+        WriteSource "otai_${api}_api_t *otai_metadata_${shim}_${api}_api = NULL;";
+
+        WriteHeader "extern const otai_${api}_api_t *$native;";
+        WriteHeader "extern otai_${api}_api_t *otai_metadata_${shim}_${api}_api;";
+
+        my @members = ExtractApiMembers($api);
+
+        while (my ($type, $member) = splice(@members, 0, 2))
+        {
+            my ($op, $params, $id) = GetInstrumentSignature($api, $type);
+
+            next if not defined $op;
+
+            my @args = map { /(\w+)$/ } @$params;
+
+            my @decls = @$params;
+
+            my $last = pop @decls;
+
+            WriteSource "static otai_status_t otai_metadata_${shim}_$member(";
+            WriteSource "$_," for @decls;
+            WriteSource "$last)";
+            WriteSource "{";
+            WriteSource $_ for $body->($API, $ot, $op, $params, $id, "__atomic_load_n(&$native, __ATOMIC_ACQUIRE)->$member(" . join(", ", @args) . ")");
+            WriteSource "}";
+        }
+    }
+
+    WriteSource "otai_status_t otai_metadata_${shim}_wrap_api(";
+    WriteSource "_In_ otai_api_t api,";
+    WriteSource "_In_ void *native,";
+    WriteSource "_Out_ void **wrapped)";
+    WriteSource "{";
+    WriteSource "*wrapped = native;";
+    WriteSource "if (native == NULL)";
+    WriteSource "{";
+    WriteSource "return OTAI_STATUS_SUCCESS;";
+    WriteSource "}";
+    WriteSource "switch (api)";
+    WriteSource "{";
+
+    for my $api (sort keys %APITOOBJMAP)
+    {
+        next if not defined $APITOOBJMAP{$api}->[0];
+
+        my $native = "otai_metadata_${shim}_native_${api}_api";
+        my $table = "otai_metadata_${shim}_${api}_api";
+
+        WriteSource "case " . uc("OTAI_API_${api}") . ":";
+        WriteSource "{";
+        WriteSource "const otai_${api}_api_t *adapter = (const otai_${api}_api_t*)native;";
+        WriteSource "otai_${api}_api_t *table = __atomic_load_n(&$table, __ATOMIC_ACQUIRE);";
+        WriteSource "if (table != NULL && __atomic_load_n(&$native, __ATOMIC_ACQUIRE) == adapter)";
+        WriteSource "{";
+        WriteSource "*wrapped = table;";
+        WriteSource "break;";
+        WriteSource "}";
+        WriteSource "table = malloc(sizeof(otai_${api}_api_t));";
+        WriteSource "if (table == NULL)";
+        WriteSource "{";
+        WriteSource "return OTAI_STATUS_NO_MEMORY;";
+        WriteSource "}";
+        WriteSource "*table = *adapter;";
+
+        my @members = ExtractApiMembers($api);
+
+        while (my ($type, $member) = splice(@members, 0, 2))
+        {
+            my ($op) = GetInstrumentSignature($api, $type);
+
+            next if not defined $op;
+
+            WriteSource "table->$member = (adapter->$member == NULL) ? NULL : otai_metadata_${shim}_$member;";
+        }
+
+        WriteSource "__atomic_store_n(&$native, adapter, __ATOMIC_RELEASE);";
+        WriteSource "(void)__atomic_exchange_n(&$table, table, __ATOMIC_ACQ_REL);";
+        WriteSource "*wrapped = table;";
+        WriteSource "break;";
+        WriteSource "}";
+    }
+
+    WriteSource "default:";
+    WriteSource "break;";
+    WriteSource "}";
+    WriteSource "return OTAI_STATUS_SUCCESS;";
+    WriteSource "}";
+
+    WriteHeader "extern otai_status_t otai_metadata_${shim}_wrap_api(";
+    WriteHeader "_In_ otai_api_t api,";
+    WriteHeader "_In_ void *native,";
+    WriteHeader "_Out_ void **wrapped);";
+}
+
+sub CreateInstrumentApis
+{
+    #
+    # Purpose is to generate method tables of the same type as adapter
+    # ones, whose methods record calls for otaimetadatainstrument
+    #
+
+    WriteSectionComment "Instrumented API method tables";
+
+    CreateApiShim("instrument", sub {
+            my ($API, $ot, $op, $params, $id, $call) = @_;
+
+            return (
+                "uint64_t start = otai_metadata_instrument_now();",
+                "otai_status_t status = $call;",
+                "otai_metadata_instrument_record($API, OTAI_METADATA_INSTRUMENT_OP_$op, $ot, $id, start, status);",
+                "return status;");
+            });
+}
+
+sub GetRecorderAssignment
+{
+    my ($op, $param) = @_;
+
+    # maps wrapper parameter to member of otai_metadata_recorder_call_t
+
+    (my $decl = $param) =~ s/^_\w+_\s+//;
+
+    my $name = $1 if $decl =~ /(\w+)$/;
+
+    return "call.objectids = object_id;" if $decl eq "otai_object_id_t *object_id" or $decl eq "const otai_object_id_t *object_id";
+    return "call.objectids = &object_id;" if $decl eq "otai_object_id_t object_id";
+    return "call.linecardid = linecard_id;" if $name eq "linecard_id";
+    return "call.objectcount = object_count;" if $name eq "object_count";
+    return "call.attrcounts = &attr_count;" if $decl eq "uint32_t attr_count";
+    return "call.attrcounts = attr_count;" if $decl eq "const uint32_t *attr_count";
+    return "call.attrs = attr_list;" if $op eq "BULK_SET" and $name eq "attr_list";
+    return "call.attrlists = &attr_list;" if $decl eq "const otai_attribute_t *attr_list";
+    return "call.attrlists = (const otai_attribute_t *const*)&attr_list;" if $decl eq "otai_attribute_t *attr_list";
+    return "call.attrlists = attr_list;" if $decl eq "const otai_attribute_t **attr_list";
+    return "call.attrlists = (const otai_attribute_t *const*)attr_list;" if $decl eq "otai_attribute_t **attr_list";
+    return "call.attrs = attr;" if $name eq "attr";
+    return "call.countercount = number_of_counters;" if $name eq "number_of_counters";
+    return "call.counterids = counter_ids;" if $name eq "counter_ids";
+    return "call.statsmode = mode;" if $decl eq "otai_stats_mode_t mode";
+    return "call.errormode = mode;" if $decl eq "otai_bulk_op_error_mode_t mode";
+    return "call.objectstatuses = object_statuses;" if $name eq "object_statuses";
+
+    # counter values are output only and are not recorded
+
+    return () if $name eq "counters";
+
+    LogError "parameter '$param' of $op is not recorded";
+
+    return ();
+}
+
+sub CreateRecorderApis
+{
+    #
+    # Purpose is to generate method tables of the same type as adapter
+    # ones, whose methods record calls for otaimetadatarecorder
+    #
+
+    WriteSectionComment "Recorded API method tables";
+
+    CreateApiShim("recorder", sub {
+            my ($API, $ot, $op, $params, $id, $call) = @_;
+
+            return (
+                "otai_metadata_recorder_call_t call;",
+                "memset(&call, 0, sizeof(call));",
+                "call.api = $API;",
+                "call.op = OTAI_METADATA_INSTRUMENT_OP_$op;",
+                "call.objecttype = $ot;",
+                (grep({ /object_count$/ } @$params) ? () : "call.objectcount = 1;"),
+                map({ GetRecorderAssignment($op, $_) } @$params),
+                "call.start = otai_metadata_recorder_now();",
+                "call.status = $call;",
+                "otai_metadata_recorder_record(&call);",
+                "return call.status;");
+            });
+}
+
 sub ProcessIsExperimental
 {
     my $ot = shift;
@@ -3080,6 +3721,12 @@ sub CreateObjectInfo
         my $getstatsext = ProcessGetStatsExt($struct, $ot);
         my $clearstats  = ProcessClearStats($struct, $ot);
 
+        my $bulkcreate   = ProcessBulkCreate($struct, $ot);
+        my $bulkremove   = ProcessBulkRemove($struct, $ot);
+        my $bulkset      = ProcessBulkSet($struct, $ot);
+        my $bulkget      = ProcessBulkGet($struct, $ot);
+        my $bulkgetstats = ProcessBulkGetStats($struct, $ot);
+
         WriteHeader "extern const otai_object_type_info_t otai_metadata_object_type_info_$ot;";
 
         WriteSource "const otai_object_type_info_t otai_metadata_object_type_info_$ot = {";
@@ -3104,6 +3751,11 @@ sub CreateObjectInfo
         WriteSource ".getstats             = $getstats,";
         WriteSource ".getstatsext          = $getstatsext,";
         WriteSource ".clearstats           = $clearstats,";
+        WriteSource ".bulkcreate           = $bulkcreate,";
+        WriteSource ".bulkremove           = $bulkremove,";
+        WriteSource ".bulkset              = $bulkset,";
+        WriteSource ".bulkget              = $bulkget,";
+        WriteSource ".bulkgetstats         = $bulkgetstats,";
         WriteSource ".isexperimental       = $isexperimental,";
         WriteSource ".statenum             = $statenum,";
         WriteSource ".alarmenum            = $alarmenum,";
@@ -3252,7 +3904,7 @@ sub GetHashOfAllAttributes
 
             next if defined $METADATA{$typedef}{$attr}{ignore};
 
-            $ATTRIBUTES{$attr} = 1;
+            $ATTRIBUTES{$attr} = $typedef;
         }
     }
 
@@ -3285,6 +3937,27 @@ sub CreateListOfAllAttributes
 
     WriteSource "const size_t otai_metadata_attr_sorted_by_id_name_count = $count;";
     WriteHeader "extern const size_t otai_metadata_attr_sorted_by_id_name_count;";
+
+    # name hashes point to index in sorted list above
+
+    my @names = ();
+    my @kebabnames = ();
+
+    for my $attr (@keys)
+    {
+        my $kebabname = ProcessAttrKebabName($attr, "");
+
+        $kebabname =~ s/"//g;
+
+        push @names, [ 0, $attr ];
+        push @kebabnames, [ GetObjectTypeIndex($ATTRIBUTES{$attr}), $kebabname ];
+    }
+
+    WriteNameHash("otai_metadata_attr_sorted_by_id_name_hash", @names);
+    WriteNameHash("otai_metadata_attr_sorted_by_kebab_name_hash", @kebabnames);
+
+    WriteHeader "extern const otai_name_hash_t otai_metadata_attr_sorted_by_id_name_hash;";
+    WriteHeader "extern const otai_name_hash_t otai_metadata_attr_sorted_by_kebab_name_hash;";
 }
 
 sub GetHashOfAllStatistics
@@ -3309,7 +3982,7 @@ sub GetHashOfAllStatistics
                 next;
             }
 
-            $STATISTICS{$stat} = 1;
+            $STATISTICS{$stat} = $typedef;
         }
     }
 
@@ -3339,6 +4012,110 @@ sub CreateListOfAllStatistics
 
     WriteSource "const size_t otai_metadata_stat_sorted_by_id_name_count = $count;";
     WriteHeader "extern const size_t otai_metadata_stat_sorted_by_id_name_count;";
+
+    # name hashes point to index in sorted list above
+
+    my @names = ();
+    my @kebabnames = ();
+    my @camelnames = ();
+
+    for my $stat (@keys)
+    {
+        my $kebabname = ProcessStatKebabName($stat, "");
+        my $camelname = ProcessStatCamelName($stat, "");
+
+        $kebabname =~ s/"//g;
+        $camelname =~ s/"//g;
+
+        my $prefix = GetObjectTypeIndex($STATISTICS{$stat});
+
+        push @names, [ 0, $stat ];
+        push @kebabnames, [ $prefix, $kebabname ];
+        push @camelnames, [ $prefix, $camelname ];
+    }
+
+    WriteNameHash("otai_metadata_stat_sorted_by_id_name_hash", @names);
+    WriteNameHash("otai_metadata_stat_sorted_by_kebab_name_hash", @kebabnames);
+    WriteNameHash("otai_metadata_stat_sorted_by_camel_name_hash", @camelnames);
+
+    WriteHeader "extern const otai_name_hash_t otai_metadata_stat_sorted_by_id_name_hash;";
+    WriteHeader "extern const otai_name_hash_t otai_metadata_stat_sorted_by_kebab_name_hash;";
+    WriteHeader "extern const otai_name_hash_t otai_metadata_stat_sorted_by_camel_name_hash;";
+}
+
+sub GetObjectTypeIndex
+{
+    my $typedef = shift;
+
+    if (not $typedef =~ /^otai_(\w+)_(attr|stat)_t$/)
+    {
+        LogError "can't extract object type from $typedef";
+        return 0;
+    }
+
+    my $ot = "OTAI_OBJECT_TYPE_" . uc($1);
+
+    # object type enum values are continuous and start from zero, same
+    # assumption is used when generating *_by_object_type arrays
+
+    my @objects = @{ $OTAI_ENUMS{otai_object_type_t}{values} };
+
+    my ($index) = grep { $objects[$_] eq $ot } 0..$#objects;
+
+    if (not defined $index)
+    {
+        LogError "object type $ot not found in otai_object_type_t";
+        return 0;
+    }
+
+    return $index;
+}
+
+sub WriteNameHash
+{
+    my ($name, @keys) = @_;
+
+    my ($displacements, $slots) = CreateNameHash(@keys);
+
+    my $count = @keys;
+
+    # optional third key element overrides index stored in slot
+
+    @$slots = map { defined $keys[$_][2] ? $keys[$_][2] : $_ } @$slots if defined $slots;
+
+    if ($count == 0 or not defined $slots)
+    {
+        WriteSource "const otai_name_hash_t $name = { .count = 0, .displacements = NULL, .values = NULL };";
+        return;
+    }
+
+    WriteSource "const int32_t ${name}_displacements[] = {";
+
+    for (my $idx = 0; $idx < $count; $idx += 16)
+    {
+        my $last = ($idx + 15 < $count) ? $idx + 15 : $count - 1;
+
+        WriteSource join(", ", @$displacements[$idx..$last]) . ",";
+    }
+
+    WriteSource "};";
+
+    WriteSource "const uint32_t ${name}_values[] = {";
+
+    for (my $idx = 0; $idx < $count; $idx += 16)
+    {
+        my $last = ($idx + 15 < $count) ? $idx + 15 : $count - 1;
+
+        WriteSource join(", ", @$slots[$idx..$last]) . ",";
+    }
+
+    WriteSource "};";
+
+    WriteSource "const otai_name_hash_t $name = {";
+    WriteSource ".count         = $count,";
+    WriteSource ".displacements = ${name}_displacements,";
+    WriteSource ".values        = ${name}_values,";
+    WriteSource "};";
 }
 
 sub CheckApiStructNames
@@ -3445,6 +4222,7 @@ sub ExtractStatsFunctionMap
 
             next if $fn eq "clear_port_all_stats";
             next if $fn eq "get_tam_snapshot_stats";
+            next if $fn =~ /^bulk_/;
 
             if (not $fn =~ /^(?:get|clear)_(\w+)_stats(?:_ext)?$/)
             {
@@ -4135,6 +4913,8 @@ CreateObjectTypeMap();
 
 WriteHeaderHeader();
 
+ExtractEnumNumericValues();
+
 ProcessOtaiStatus();
 
 ProcessExtraRangeDefines();
@@ -4163,6 +4943,10 @@ CreateGlobalApis();
 
 CreateApisQuery();
 
+CreateInstrumentApis();
+
+CreateRecorderApis();
+
 CreateObjectInfo();
 
 CreateListOfAllAttributes();
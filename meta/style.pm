@@ -296,7 +296,7 @@ sub CheckFunctionsParams
         next if not $fname =~ /_fn$/; # below don't apply for global functions
 
         if (not $fnparams =~ /^(\w+)(| attr| attr_count attr_list| linecard_id attr_count attr_list)$/ and
-            not $fname =~ /_(stats|stats_ext|gauges|notification|event|handler|switch_info|report_result)_fn$|^otai_(send|allocate|free|recv|bulk)_|^otai_meta/)
+            not $fname =~ /_(stats|stats_ext|gauges|notification|event|handler|switch_info|switch_info_ref|report_result)_fn$|^otai_(send|allocate|free|recv|bulk)_|^otai_meta/)
         {
             LogWarning "wrong param names: $fnparams: $fname";
             LogWarning " expected: $params[0](| attr| attr_count attr_list| linecard_id attr_count attr_list)";
@@ -322,7 +322,7 @@ sub CheckFunctionsParams
             }
         }
 
-        if ($fname =~ /^otai_\w+_stats_/)
+        if ($fname =~ /^otai_\w+_stats_/ and not $fname =~ /^otai_bulk_/)
         {
             CheckStatsFunction($fname,$fn,$fnparams);
         }
@@ -450,13 +450,17 @@ sub CheckFunctionNaming
     my $typename = $1;
     my $name = $2;
 
-    if ($name =~ /^(recv_hostif_packet|send_hostif_packet|allocate_hostif_packet|free_hostif_packet|flush_fdb_entries|remove_all_neighbor_entries|profile_get_value|profile_get_next_value|switch_register_read|switch_register_write|switch_mdio_read|switch_mdio_write)$/)
+    if ($name =~ /^(recv_hostif_packet|send_hostif_packet|allocate_hostif_packet|free_hostif_packet|flush_fdb_entries|remove_all_neighbor_entries|profile_get_value|profile_get_next_value|release_aps_switch_info|switch_register_read|switch_register_write|switch_mdio_read|switch_mdio_write)$/)
     {
         # ok
     }
     elsif ($name =~ /^(get|clear)_(\w+?)_(all_)?stats(_ext)?$/)
     {
-        LogWarning "not object name $2 in $name" if not IsObjectName($2);
+        my $n = $2;
+
+        $n =~ s/(?<=s)es$|s$// if $typename =~ /^bulk/;
+
+        LogWarning "not object name $n in $name" if not IsObjectName($n);
     }
     elsif ($name =~ /^(get|clear)_(\w+?)_gauges?$/)
     {
@@ -467,7 +471,7 @@ sub CheckFunctionNaming
         my $n = $2;
 
         $n =~ s/_entries$/_entry/ if $typename =~ /^bulk/;
-        $n =~ s/s$// if $typename =~ /^bulk/;
+        $n =~ s/(?<=s)es$|s$// if $typename =~ /^bulk/;
 
         LogWarning "not object name $n in $name" if not IsObjectName($n);
     }
@@ -484,7 +488,7 @@ sub CheckFunctionNaming
     if (not $name =~ /^(create|remove|get|set)_\w+?(_attribute)?$|^clear_\w+_(stats|gauges)$/)
     {
         # exceptions
-        return if $name =~ /^(profile_get_value|profile_get_next_value)$/;
+        return if $name =~ /^(profile_get_value|profile_get_next_value|release_aps_switch_info)$/;
 
         LogWarning "function not follow convention in $header:$n:$line";
     }
@@ -336,6 +336,140 @@ sub ExitOnErrors
     exit 1;
 }
 
+#
+# Name hash must produce exactly the same values as
+# otai_metadata_hash_name() in otaimetadatautils.c, all arithmetic is done
+# modulo 2^32 and multiplication is split to not overflow perl integers.
+#
+
+sub NameHashMul32
+{
+    my ($x, $y) = @_;
+
+    my $lo = $x * ($y & 0xffff);
+    my $hi = (($x * ($y >> 16)) & 0xffff) << 16;
+
+    return ($lo + $hi) & 0xffffffff;
+}
+
+sub GetNameHash
+{
+    my ($seed, $prefix, $name) = @_;
+
+    my $hash = (0x811c9dc5 ^ $seed) & 0xffffffff;
+
+    my @bytes = map { ($prefix >> (8 * $_)) & 0xff } 0..3;
+
+    push @bytes, unpack("C*", $name);
+
+    for my $byte (@bytes)
+    {
+        $hash = NameHashMul32($hash ^ $byte, 0x01000193);
+    }
+
+    $hash ^= $hash >> 16;
+    $hash = NameHashMul32($hash, 0x85ebca6b);
+    $hash ^= $hash >> 13;
+    $hash = NameHashMul32($hash, 0xc2b2ae35);
+    $hash ^= $hash >> 16;
+
+    return $hash;
+}
+
+#
+# Creates minimal perfect hash using hash and displace method. Input is list
+# of [prefix, name] pairs, output are bucket displacements and slots which
+# contain index of input key. Bucket holding single key points directly to
+# slot as (-slot - 1), other buckets hold seed used to rehash keys.
+#
+
+sub CreateNameHash
+{
+    my @keys = @_;
+
+    my $count = @keys;
+
+    my @buckets = map { [] } 1..$count;
+    my @displacements = (0) x $count;
+    my @slots = (-1) x $count;
+
+    my %unique = ();
+
+    for my $idx (0..$#keys)
+    {
+        my ($prefix, $name) = @{ $keys[$idx] };
+
+        if (defined $unique{"$prefix:$name"})
+        {
+            LogError "name $name is not unique for prefix $prefix, can't create name hash";
+            return ();
+        }
+
+        $unique{"$prefix:$name"} = 1;
+
+        push @{ $buckets[GetNameHash(0, $prefix, $name) % $count] }, $idx;
+    }
+
+    my @order = sort { scalar @{ $buckets[$b] } <=> scalar @{ $buckets[$a] } or $a <=> $b } 0..$#buckets;
+
+    for my $bucket (@order)
+    {
+        my @items = @{ $buckets[$bucket] };
+
+        last if @items <= 1;
+
+        my $seed = 1;
+
+        while (1)
+        {
+            my %taken = ();
+
+            for my $idx (@items)
+            {
+                my $slot = GetNameHash($seed, $keys[$idx][0], $keys[$idx][1]) % $count;
+
+                last if $slots[$slot] != -1 or defined $taken{$slot};
+
+                $taken{$slot} = $idx;
+            }
+
+            if (scalar keys %taken == @items)
+            {
+                $slots[$_] = $taken{$_} for keys %taken;
+
+                $displacements[$bucket] = $seed;
+
+                last;
+            }
+
+            $seed++;
+
+            if ($seed > 0x7fffffff)
+            {
+                LogError "failed to find name hash seed for bucket $bucket";
+                return ();
+            }
+        }
+    }
+
+    my @free = grep { $slots[$_] == -1 } 0..$#slots;
+
+    for my $bucket (@order)
+    {
+        my @items = @{ $buckets[$bucket] };
+
+        next if @items != 1;
+
+        my $slot = shift @free;
+
+        $slots[$slot] = $items[0];
+
+        $displacements[$bucket] = -$slot - 1;
+    }
+
+    return (\@displacements, \@slots);
+}
+
 BEGIN
 {
     our @ISA    = qw(Exporter);
@@ -344,6 +478,7 @@ BEGIN
     WriteFile GetHeaderFiles GetMetaHeaderFiles GetMetadataSourceFiles ReadHeaderFile
     GetNonObjectIdStructNames GetStructLists GetStructKeysInOrder
     Trim ExitOnErrors
+    GetNameHash CreateNameHash
     WriteHeader WriteSource WriteTest WriteMetaDataFiles WriteSectionComment
     $errors $warnings $NUMBER_REGEX
     $HEADER_CONTENT $SOURCE_CONTENT $TEST_CONTENT
@@ -0,0 +1,410 @@
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "otaimetadata.h"
+#include "otaimetadataalarm.h"
+}
+
+#define ALARM_TEST_LINECARD 0x10
+#define ALARM_TEST_OTHER_LINECARD 0x11
+#define ALARM_TEST_RESOURCE 0x20
+#define ALARM_TEST_RAISE_HOLD 100
+#define ALARM_TEST_CLEAR_HOLD 200
+
+typedef struct _alarm_test_delivery_t
+{
+    otai_object_id_t linecardid;
+
+    otai_alarm_type_t alarmtype;
+
+    otai_alarm_status_t status;
+
+    otai_object_id_t resourceoid;
+
+    otai_alarm_severity_t severity;
+
+    std::string text;
+
+} alarm_test_delivery_t;
+
+static std::vector<alarm_test_delivery_t> alarm_test_deliveries;
+
+static std::vector<alarm_test_delivery_t> alarm_test_other_deliveries;
+
+static uint64_t alarm_test_now = 0;
+
+static alarm_test_delivery_t alarm_test_delivery(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_alarm_type_t alarm_type,
+        _In_ const otai_alarm_info_t &alarm_info)
+{
+    alarm_test_delivery_t delivery;
+
+    delivery.linecardid = linecard_id;
+    delivery.alarmtype = alarm_type;
+    delivery.status = alarm_info.status;
+    delivery.resourceoid = alarm_info.resource_oid;
+    delivery.severity = alarm_info.severity;
+    delivery.text.assign((const char*)alarm_info.text.list, alarm_info.text.count);
+
+    return delivery;
+}
+
+static void alarm_test_handler(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_alarm_type_t alarm_type,
+        _In_ otai_alarm_info_t alarm_info)
+{
+    alarm_test_deliveries.push_back(alarm_test_delivery(linecard_id, alarm_type, alarm_info));
+}
+
+static void alarm_test_other_handler(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_alarm_type_t alarm_type,
+        _In_ otai_alarm_info_t alarm_info)
+{
+    alarm_test_other_deliveries.push_back(alarm_test_delivery(linecard_id, alarm_type, alarm_info));
+}
+
+static uint64_t alarm_test_clock(void)
+{
+    return alarm_test_now;
+}
+
+/*
+ * Registers handler of linecard through aggregator as on linecard create
+ * and returns callback which adapter would get.
+ */
+static otai_linecard_alarm_notification_fn alarm_test_wrap(
+        _In_ otai_object_id_t linecard_id = ALARM_TEST_LINECARD,
+        _In_ otai_linecard_alarm_notification_fn handler = alarm_test_handler)
+{
+    otai_attribute_t attrs[2];
+
+    attrs[0].id = OTAI_LINECARD_ATTR_LINECARD_STATE_CHANGE_NOTIFY;
+    attrs[0].value.ptr = NULL;
+    attrs[1].id = OTAI_LINECARD_ATTR_LINECARD_ALARM_NOTIFY;
+    attrs[1].value.ptr = (otai_pointer_t)handler;
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_alarm_wrap_attr_list(OTAI_OBJECT_TYPE_LINECARD, OTAI_NULL_OBJECT_ID, 2, attrs));
+    EXPECT_EQ(NULL, attrs[0].value.ptr);
+    EXPECT_NE((otai_pointer_t)handler, attrs[1].value.ptr);
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_alarm_bind_linecard(linecard_id));
+
+    return (otai_linecard_alarm_notification_fn)attrs[1].value.ptr;
+}
+
+static void alarm_test_start(
+        _In_ uint32_t capacity,
+        _In_ uint32_t summary_interval)
+{
+    otai_metadata_alarm_config_t config = { capacity, ALARM_TEST_RAISE_HOLD, ALARM_TEST_CLEAR_HOLD,
+        summary_interval, alarm_test_clock };
+
+    alarm_test_now = 1000;
+    alarm_test_deliveries.clear();
+
+    alarm_test_wrap();
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_alarm_start(&config));
+}
+
+static void alarm_test_process(
+        _In_ otai_object_id_t resource_oid,
+        _In_ otai_alarm_status_t status,
+        _In_ otai_alarm_severity_t severity = OTAI_ALARM_SEVERITY_MAJOR,
+        _In_ otai_object_id_t linecard_id = ALARM_TEST_LINECARD)
+{
+    otai_alarm_info_t info;
+
+    memset(&info, 0, sizeof(info));
+
+    info.status = status;
+    info.resource_oid = resource_oid;
+    info.severity = severity;
+
+    otai_metadata_alarm_process(alarm_test_now, linecard_id, OTAI_ALARM_TYPE_RX_LOS, &info);
+}
+
+static otai_metadata_alarm_stats_t alarm_test_stats(void)
+{
+    otai_metadata_alarm_stats_t stats;
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_alarm_get_stats(&stats));
+
+    return stats;
+}
+
+TEST(OtaiAlarmTest, direct_when_not_started)
+{
+    otai_linecard_alarm_notification_fn callback = alarm_test_wrap();
+
+    alarm_test_deliveries.clear();
+
+    otai_alarm_info_t info;
+
+    memset(&info, 0, sizeof(info));
+
+    info.status = OTAI_ALARM_STATUS_ACTIVE;
+    info.resource_oid = ALARM_TEST_RESOURCE;
+
+    callback(ALARM_TEST_LINECARD, OTAI_ALARM_TYPE_RX_LOS, info);
+
+    ASSERT_EQ(1u, alarm_test_deliveries.size());
+    EXPECT_EQ(ALARM_TEST_LINECARD, alarm_test_deliveries[0].linecardid);
+    EXPECT_EQ(OTAI_ALARM_STATUS_ACTIVE, alarm_test_deliveries[0].status);
+    EXPECT_FALSE(otai_metadata_alarm_is_active(ALARM_TEST_LINECARD, ALARM_TEST_RESOURCE, OTAI_ALARM_TYPE_RX_LOS));
+
+    otai_metadata_alarm_stats_t stats;
+
+    EXPECT_EQ(OTAI_STATUS_UNINITIALIZED, otai_metadata_alarm_get_stats(&stats));
+
+    /* other object types are not touched */
+
+    otai_attribute_t attr;
+
+    attr.id = OTAI_LINECARD_ATTR_LINECARD_ALARM_NOTIFY;
+    attr.value.ptr = (otai_pointer_t)alarm_test_handler;
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_alarm_wrap_attr_list(OTAI_OBJECT_TYPE_PORT, OTAI_NULL_OBJECT_ID, 1, &attr));
+    EXPECT_EQ((otai_pointer_t)alarm_test_handler, attr.value.ptr);
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_alarm_wrap_attr_list(OTAI_OBJECT_TYPE_LINECARD, OTAI_NULL_OBJECT_ID, 1, NULL));
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_alarm_bind_linecard(ALARM_TEST_LINECARD));
+}
+
+TEST(OtaiAlarmTest, invalid_config)
+{
+    otai_metadata_alarm_config_t config = { 3, 0, 0, 0, alarm_test_clock };
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_alarm_start(&config));
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_alarm_start(NULL));
+
+    otai_metadata_alarm_config_t noclock = { 4, 0, 0, 0, NULL };
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_alarm_start(&noclock));
+}
+
+TEST(OtaiAlarmTest, raise_and_clear_hold)
+{
+    alarm_test_start(16, 0);
+
+    alarm_test_process(ALARM_TEST_RESOURCE, OTAI_ALARM_STATUS_ACTIVE);
+
+    otai_metadata_alarm_poll(alarm_test_now + ALARM_TEST_RAISE_HOLD - 1);
+
+    EXPECT_TRUE(alarm_test_deliveries.empty());
+
+    otai_metadata_alarm_poll(alarm_test_now + ALARM_TEST_RAISE_HOLD);
+
+    ASSERT_EQ(1u, alarm_test_deliveries.size());
+    EXPECT_EQ(OTAI_ALARM_STATUS_ACTIVE, alarm_test_deliveries[0].status);
+    EXPECT_EQ(ALARM_TEST_RESOURCE, alarm_test_deliveries[0].resourceoid);
+    EXPECT_EQ(OTAI_ALARM_TYPE_RX_LOS, alarm_test_deliveries[0].alarmtype);
+    EXPECT_TRUE(otai_metadata_alarm_is_active(ALARM_TEST_LINECARD, ALARM_TEST_RESOURCE, OTAI_ALARM_TYPE_RX_LOS));
+    EXPECT_EQ(1u, alarm_test_stats().active);
+
+    /* repeated notification with the same status and severity is dropped */
+
+    alarm_test_now += 500;
+
+    alarm_test_process(ALARM_TEST_RESOURCE, OTAI_ALARM_STATUS_ACTIVE);
+
+    otai_metadata_alarm_poll(alarm_test_now + ALARM_TEST_CLEAR_HOLD);
+
+    EXPECT_EQ(1u, alarm_test_deliveries.size());
+
+    /* severity change is reported without status change */
+
+    alarm_test_process(ALARM_TEST_RESOURCE, OTAI_ALARM_STATUS_ACTIVE, OTAI_ALARM_SEVERITY_CRITICAL);
+
+    otai_metadata_alarm_poll(alarm_test_now);
+
+    ASSERT_EQ(2u, alarm_test_deliveries.size());
+    EXPECT_EQ(OTAI_ALARM_STATUS_ACTIVE, alarm_test_deliveries[1].status);
+    EXPECT_EQ(OTAI_ALARM_SEVERITY_CRITICAL, alarm_test_deliveries[1].severity);
+
+    /* cleared alarm is reported after clear hold and removed from table */
+
+    alarm_test_process(ALARM_TEST_RESOURCE, OTAI_ALARM_STATUS_INACTIVE);
+
+    otai_metadata_alarm_poll(alarm_test_now + ALARM_TEST_RAISE_HOLD);
+
+    EXPECT_EQ(2u, alarm_test_deliveries.size());
+
+    otai_metadata_alarm_poll(alarm_test_now + ALARM_TEST_CLEAR_HOLD);
+
+    ASSERT_EQ(3u, alarm_test_deliveries.size());
+    EXPECT_EQ(OTAI_ALARM_STATUS_INACTIVE, alarm_test_deliveries[2].status);
+    EXPECT_FALSE(otai_metadata_alarm_is_active(ALARM_TEST_LINECARD, ALARM_TEST_RESOURCE, OTAI_ALARM_TYPE_RX_LOS));
+
+    otai_metadata_alarm_stats_t stats = alarm_test_stats();
+
+    EXPECT_EQ(0u, stats.entries);
+    EXPECT_EQ(0u, stats.active);
+    EXPECT_EQ(4u, stats.received);
+    EXPECT_EQ(3u, stats.delivered);
+
+    otai_metadata_alarm_stop();
+}
+
+TEST(OtaiAlarmTest, transient)
+{
+    alarm_test_start(16, 0);
+
+    /* alarm raised and cleared within hold time is reported once */
+
+    alarm_test_process(ALARM_TEST_RESOURCE, OTAI_ALARM_STATUS_ACTIVE);
+
+    alarm_test_now += 30;
+
+    alarm_test_process(ALARM_TEST_RESOURCE, OTAI_ALARM_STATUS_INACTIVE);
+
+    otai_metadata_alarm_poll(alarm_test_now + ALARM_TEST_CLEAR_HOLD);
+
+    ASSERT_EQ(1u, alarm_test_deliveries.size());
+    EXPECT_EQ(OTAI_ALARM_STATUS_TRANSIENT, alarm_test_deliveries[0].status);
+    EXPECT_FALSE(otai_metadata_alarm_is_active(ALARM_TEST_LINECARD, ALARM_TEST_RESOURCE, OTAI_ALARM_TYPE_RX_LOS));
+
+    otai_metadata_alarm_stats_t stats = alarm_test_stats();
+
+    EXPECT_EQ(1u, stats.transient);
+    EXPECT_EQ(0u, stats.entries);
+
+    otai_metadata_alarm_stop();
+}
+
+TEST(OtaiAlarmTest, flapping_summary)
+{
+    alarm_test_start(16, 100);
+
+    /* flapping every 10 ms never settles within raise hold */
+
+    for (int i = 0; i < 51; ++i)
+    {
+        alarm_test_process(ALARM_TEST_RESOURCE, (i % 2) ? OTAI_ALARM_STATUS_INACTIVE : OTAI_ALARM_STATUS_ACTIVE);
+
+        alarm_test_now += 10;
+
+        otai_metadata_alarm_poll(alarm_test_now);
+    }
+
+    /* one transient per summary interval */
+
+    EXPECT_EQ(5u, alarm_test_deliveries.size());
+
+    for (auto& delivery: alarm_test_deliveries)
+    {
+        EXPECT_EQ(OTAI_ALARM_STATUS_TRANSIENT, delivery.status);
+    }
+
+    /* last status is always reported when alarm settles */
+
+    otai_metadata_alarm_poll(alarm_test_now + ALARM_TEST_RAISE_HOLD);
+
+    ASSERT_EQ(6u, alarm_test_deliveries.size());
+    EXPECT_EQ(OTAI_ALARM_STATUS_ACTIVE, alarm_test_deliveries.back().status);
+    EXPECT_TRUE(otai_metadata_alarm_is_active(ALARM_TEST_LINECARD, ALARM_TEST_RESOURCE, OTAI_ALARM_TYPE_RX_LOS));
+
+    otai_metadata_alarm_stop();
+}
+
+TEST(OtaiAlarmTest, table_overflow)
+{
+    alarm_test_start(2, 0);
+
+    alarm_test_process(ALARM_TEST_RESOURCE, OTAI_ALARM_STATUS_ACTIVE);
+    alarm_test_process(ALARM_TEST_RESOURCE + 1, OTAI_ALARM_STATUS_ACTIVE);
+
+    EXPECT_TRUE(alarm_test_deliveries.empty());
+
+    /* alarm which doesn't fit is delivered without aggregation */
+
+    alarm_test_process(ALARM_TEST_RESOURCE + 2, OTAI_ALARM_STATUS_ACTIVE);
+
+    ASSERT_EQ(1u, alarm_test_deliveries.size());
+    EXPECT_EQ(ALARM_TEST_RESOURCE + 2u, alarm_test_deliveries[0].resourceoid);
+
+    otai_metadata_alarm_stats_t stats = alarm_test_stats();
+
+    EXPECT_EQ(1u, stats.overflow);
+    EXPECT_EQ(2u, stats.entries);
+
+    /* stop delivers pending changes without waiting for hold */
+
+    otai_metadata_alarm_stop();
+
+    EXPECT_EQ(3u, alarm_test_deliveries.size());
+}
+
+TEST(OtaiAlarmTest, text_truncated)
+{
+    alarm_test_start(16, 0);
+
+    std::string text(OTAI_METADATA_ALARM_MAX_TEXT + 10, 't');
+
+    otai_alarm_info_t info;
+
+    memset(&info, 0, sizeof(info));
+
+    info.status = OTAI_ALARM_STATUS_ACTIVE;
+    info.resource_oid = ALARM_TEST_RESOURCE;
+    info.text.count = (uint32_t)text.size();
+    info.text.list = (int8_t*)&text[0];
+
+    otai_metadata_alarm_process(alarm_test_now, ALARM_TEST_LINECARD, OTAI_ALARM_TYPE_RX_LOS, &info);
+
+    otai_metadata_alarm_poll(alarm_test_now + ALARM_TEST_RAISE_HOLD);
+
+    ASSERT_EQ(1u, alarm_test_deliveries.size());
+    EXPECT_EQ(text.substr(0, OTAI_METADATA_ALARM_MAX_TEXT), alarm_test_deliveries[0].text);
+
+    otai_metadata_alarm_stop();
+}
+
+TEST(OtaiAlarmTest, handler_per_linecard)
+{
+    alarm_test_start(16, 0);
+
+    otai_linecard_alarm_notification_fn callback = alarm_test_wrap(ALARM_TEST_OTHER_LINECARD, alarm_test_other_handler);
+
+    alarm_test_other_deliveries.clear();
+
+    /* each linecard's alarms go to its own handler, aggregated or not */
+
+    alarm_test_process(ALARM_TEST_RESOURCE, OTAI_ALARM_STATUS_ACTIVE);
+    alarm_test_process(ALARM_TEST_RESOURCE, OTAI_ALARM_STATUS_ACTIVE, OTAI_ALARM_SEVERITY_MAJOR, ALARM_TEST_OTHER_LINECARD);
+
+    otai_metadata_alarm_poll(alarm_test_now + ALARM_TEST_RAISE_HOLD);
+
+    ASSERT_EQ(1u, alarm_test_deliveries.size());
+    EXPECT_EQ(ALARM_TEST_LINECARD, alarm_test_deliveries[0].linecardid);
+    ASSERT_EQ(1u, alarm_test_other_deliveries.size());
+    EXPECT_EQ(ALARM_TEST_OTHER_LINECARD, alarm_test_other_deliveries[0].linecardid);
+
+    otai_metadata_alarm_stop();
+
+    otai_alarm_info_t info;
+
+    memset(&info, 0, sizeof(info));
+
+    info.status = OTAI_ALARM_STATUS_ACTIVE;
+
+    callback(ALARM_TEST_OTHER_LINECARD, OTAI_ALARM_TYPE_RX_LOS, info);
+    callback(ALARM_TEST_LINECARD, OTAI_ALARM_TYPE_RX_LOS, info);
+
+    EXPECT_EQ(2u, alarm_test_deliveries.size());
+    EXPECT_EQ(2u, alarm_test_other_deliveries.size());
+
+    /* removed linecard is not notified */
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_alarm_remove_linecard(ALARM_TEST_OTHER_LINECARD));
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_alarm_remove_linecard(ALARM_TEST_OTHER_LINECARD));
+
+    callback(ALARM_TEST_OTHER_LINECARD, OTAI_ALARM_TYPE_RX_LOS, info);
+
+    EXPECT_EQ(2u, alarm_test_deliveries.size());
+    EXPECT_EQ(2u, alarm_test_other_deliveries.size());
+}
@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+extern "C" {
+#include "otaimetadata.h"
+#include "otaimetadataanalytics.h"
+}
+
+#define ANALYTICS_TEST_GRANULARITY 12500
+
+static otai_spectrum_power_t analytics_test_entry(
+        _In_ uint64_t lower,
+        _In_ uint64_t upper,
+        _In_ double power)
+{
+    otai_spectrum_power_t entry;
+
+    entry.lower_frequency = lower;
+    entry.upper_frequency = upper;
+    entry.power = power;
+
+    return entry;
+}
+
+static otai_metadata_analytics_channel_t analytics_test_channel(
+        _In_ uint64_t lower,
+        _In_ uint64_t upper)
+{
+    otai_metadata_analytics_channel_t channel;
+
+    memset(&channel, 0, sizeof(channel));
+
+    channel.lowerfrequency = lower;
+    channel.upperfrequency = upper;
+
+    return channel;
+}
+
+static void analytics_test_compute(
+        _Inout_ std::vector<otai_spectrum_power_t> &entries,
+        _Inout_ std::vector<otai_metadata_analytics_channel_t> &channels)
+{
+    otai_metadata_analytics_t analytics;
+
+    otai_spectrum_power_list_t spectrum;
+
+    spectrum.count = (uint32_t)entries.size();
+    spectrum.list = entries.data();
+
+    /* work array grows from 1 entry */
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_analytics_init(&analytics, 1));
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_analytics_compute(&analytics, &spectrum,
+                ANALYTICS_TEST_GRANULARITY, (uint32_t)channels.size(), channels.data()));
+
+    otai_metadata_analytics_destroy(&analytics);
+}
+
+TEST(OtaiAnalyticsTest, conversion_accuracy)
+{
+    for (double dbm = -80; dbm <= 40; dbm += 0.37)
+    {
+        double mw = pow(10, dbm / 10);
+
+        EXPECT_NEAR(mw, otai_metadata_analytics_db_to_linear(dbm), mw * 1e-8) << dbm;
+        EXPECT_NEAR(dbm, otai_metadata_analytics_linear_to_db(mw), 1e-9) << dbm;
+    }
+
+    /* subnormal power */
+
+    EXPECT_NEAR(10 * log10(1e-310), otai_metadata_analytics_linear_to_db(1e-310), 1e-9);
+
+    EXPECT_EQ(0, otai_metadata_analytics_db_to_linear(-1001));
+    EXPECT_EQ(0, otai_metadata_analytics_db_to_linear(NAN));
+    EXPECT_EQ(HUGE_VAL, otai_metadata_analytics_db_to_linear(1001));
+    EXPECT_EQ(-HUGE_VAL, otai_metadata_analytics_linear_to_db(0));
+    EXPECT_EQ(-HUGE_VAL, otai_metadata_analytics_linear_to_db(-1));
+}
+
+TEST(OtaiAnalyticsTest, partial_overlap)
+{
+    /* 1 mW in each 100 MHz entry */
+
+    std::vector<otai_spectrum_power_t> entries;
+
+    for (uint64_t lower = 1000; lower < 2000; lower += 100)
+    {
+        entries.push_back(analytics_test_entry(lower, lower + 100, 0));
+    }
+
+    std::vector<otai_metadata_analytics_channel_t> channels;
+
+    channels.push_back(analytics_test_channel(1050, 1250));
+    channels.push_back(analytics_test_channel(1275, 1300));
+
+    analytics_test_compute(entries, channels);
+
+    /* half of first and last entry */
+
+    EXPECT_EQ(3u, channels[0].entries);
+    EXPECT_NEAR(10 * log10(2.0), channels[0].power, 1e-9);
+    EXPECT_NEAR(0, channels[0].peak, 1e-9);
+
+    /* quarter of entry shared with previous channel */
+
+    EXPECT_EQ(1u, channels[1].entries);
+    EXPECT_NEAR(10 * log10(0.25), channels[1].power, 1e-9);
+    EXPECT_EQ(1250u, channels[1].peakfrequency);
+}
+
+TEST(OtaiAnalyticsTest, samples_cover_granularity)
+{
+    /* samples at center of 12.5 GHz bins, channel covers 4 of them */
+
+    std::vector<otai_spectrum_power_t> entries;
+
+    for (uint64_t center = 191306250; center < 191400000; center += ANALYTICS_TEST_GRANULARITY)
+    {
+        entries.push_back(analytics_test_entry(center, center, -10));
+    }
+
+    std::vector<otai_metadata_analytics_channel_t> channels;
+
+    channels.push_back(analytics_test_channel(191300000, 191350000));
+
+    analytics_test_compute(entries, channels);
+
+    EXPECT_EQ(4u, channels[0].entries);
+    EXPECT_NEAR(10 * log10(0.4), channels[0].power, 1e-9);
+    EXPECT_EQ(191306250u, channels[0].peakfrequency);
+}
+
+TEST(OtaiAnalyticsTest, empty_channels)
+{
+    std::vector<otai_spectrum_power_t> entries;
+
+    entries.push_back(analytics_test_entry(1000, 1100, 0));
+
+    std::vector<otai_metadata_analytics_channel_t> channels;
+
+    channels.push_back(analytics_test_channel(500, 1000));
+    channels.push_back(analytics_test_channel(1100, 1200));
+
+    analytics_test_compute(entries, channels);
+
+    for (auto &channel: channels)
+    {
+        EXPECT_EQ(0u, channel.entries);
+        EXPECT_EQ(-HUGE_VAL, channel.power);
+        EXPECT_EQ(-HUGE_VAL, channel.peak);
+        EXPECT_EQ(-HUGE_VAL, channel.osnr);
+    }
+
+    /* no spectrum at all */
+
+    entries.clear();
+
+    analytics_test_compute(entries, channels);
+
+    EXPECT_EQ(0u, channels[0].entries);
+    EXPECT_EQ(-HUGE_VAL, channels[0].power);
+}
+
+TEST(OtaiAnalyticsTest, osnr)
+{
+    std::vector<otai_spectrum_power_t> entries;
+
+    /* noise entry is twice as wide as signal entries */
+
+    entries.push_back(analytics_test_entry(0, 25000, -30));
+    entries.push_back(analytics_test_entry(25000, 37500, 0));
+    entries.push_back(analytics_test_entry(37500, 50000, 3));
+    entries.push_back(analytics_test_entry(50000, 62500, 0));
+
+    std::vector<otai_metadata_analytics_channel_t> channels;
+
+    channels.push_back(analytics_test_channel(0, 62500));
+
+    analytics_test_compute(entries, channels);
+
+    double power = pow(10, -3.0) + 1 + pow(10, 0.3) + 1;
+    double noise = pow(10, -3.0) / 25000;
+    double osnr = 10 * log10((power - noise * 62500) / (noise * OTAI_METADATA_ANALYTICS_REFERENCE_BANDWIDTH));
+
+    EXPECT_EQ(4u, channels[0].entries);
+    EXPECT_NEAR(10 * log10(power), channels[0].power, 1e-9);
+    EXPECT_NEAR(3, channels[0].peak, 1e-9);
+    EXPECT_EQ(43750u, channels[0].peakfrequency);
+    EXPECT_NEAR(osnr, channels[0].osnr, 1e-6);
+
+    /* flat spectrum has no signal above noise */
+
+    for (auto &entry: entries)
+    {
+        entry.lower_frequency = (&entry - entries.data()) * 12500;
+        entry.upper_frequency = entry.lower_frequency + 12500;
+        entry.power = -20;
+    }
+
+    channels[0].upperfrequency = 50000;
+
+    analytics_test_compute(entries, channels);
+
+    EXPECT_EQ(-HUGE_VAL, channels[0].osnr);
+}
+
+TEST(OtaiAnalyticsTest, invalid_input)
+{
+    otai_metadata_analytics_t analytics;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_analytics_init(&analytics, 0));
+
+    otai_spectrum_power_t entries[2] = {
+        analytics_test_entry(2000, 2100, 0),
+        analytics_test_entry(1000, 1100, 0)
+    };
+
+    otai_spectrum_power_list_t spectrum = { 2, entries };
+
+    otai_metadata_analytics_channel_t channels[2] = {
+        analytics_test_channel(1000, 2000),
+        analytics_test_channel(1500, 2500)
+    };
+
+    /* unsorted spectrum */
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_analytics_compute(&analytics, &spectrum, 0, 1, channels));
+
+    /* power out of range */
+
+    entries[1] = analytics_test_entry(3000, 3100, 1001);
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_analytics_compute(&analytics, &spectrum, 0, 1, channels));
+
+    /* overlapping channels */
+
+    entries[1].power = 0;
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_analytics_compute(&analytics, &spectrum, 0, 1, channels));
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_analytics_compute(&analytics, &spectrum, 0, 2, channels));
+
+    otai_metadata_analytics_destroy(&analytics);
+}
@@ -6,6 +6,8 @@
 
 extern "C" {
 #include "otai.h"
+#include "otaimetadata.h"
+#include "otaimetadatapool.h"
 }
 
 using namespace std;
@@ -78,6 +80,12 @@ otai_get_stat_t test_get_aps_stat[] = {
     
 };
 
+otai_metadata_pool_t              gApsSwitchInfoPool;
+otai_object_id_t                  gApsSwitchInfoId = OTAI_NULL_OBJECT_ID;
+const otai_olp_switch_t*          gApsSwitchInfo = NULL;
+int                               gApsSwitchInfoCount = 0;
+int                               gApsSwitchInfoRefCount = 0;
+
 void test_otai_aps_report_switch_info_fn(
         _In_ otai_object_id_t aps_id,
         _In_ otai_olp_switch_t switch_info) {
@@ -86,6 +94,44 @@ void test_otai_aps_report_switch_info_fn(
     Logg(DEBUG)<<"Call test_otai_aps_report_switch_info_fn";
 }
 
+void test_otai_aps_report_switch_info_value_fn(
+        _In_ otai_object_id_t aps_id,
+        _In_ otai_olp_switch_t switch_info) {
+    Logg(DEBUG)<<"Call test_otai_aps_report_switch_info_value_fn";
+    EXPECT_EQ(gApsSwitchInfoId, aps_id);
+    ASSERT_TRUE(gApsSwitchInfo != NULL);
+    /* by value notification gets copy of switch info */
+    EXPECT_EQ(gApsSwitchInfo->num, switch_info.num);
+    EXPECT_EQ(gApsSwitchInfo->info[0].time_stamp, switch_info.info[0].time_stamp);
+    gApsSwitchInfoCount++;
+}
+
+void test_otai_aps_report_switch_info_ref_fn(
+        _In_ otai_object_id_t aps_id,
+        _In_ const otai_olp_switch_t *switch_info) {
+    Logg(DEBUG)<<"Call test_otai_aps_report_switch_info_ref_fn";
+    EXPECT_EQ(gApsSwitchInfoId, aps_id);
+    /* by reference notification gets adapter buffer itself */
+    EXPECT_EQ(gApsSwitchInfo, switch_info);
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pool_release(&gApsSwitchInfoPool, switch_info));
+    gApsSwitchInfoRefCount++;
+}
+
+otai_olp_switch_t* acquire_aps_switch_info(
+        _In_ uint8_t num) {
+    otai_olp_switch_t *switch_info = (otai_olp_switch_t*)otai_metadata_pool_acquire(&gApsSwitchInfoPool);
+    if (switch_info != NULL) {
+        memset(switch_info, 0, sizeof(otai_olp_switch_t));
+        switch_info->num = num;
+        switch_info->channel_id = 2;
+        switch_info->info[0].index = 3;
+        switch_info->info[0].time_stamp = 1700000000000000000ULL;
+        switch_info->info[0].before[0].primary_in = -3.5;
+    }
+    gApsSwitchInfo = switch_info;
+    return switch_info;
+}
+
 void init_aps() {
     ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_api_query(OTAI_API_APS,                   (void **)&otai_aps_api));
     ASSERT_TRUE(otai_aps_api != NULL);
@@ -222,4 +268,88 @@ void test_aps() {
     get_aps_attribute();
     Logg(INFO)<<"testing get_aps_statistics";
     get_aps_statistics();
-}
\ No newline at end of file
+}
+
+TEST(OtaiApsTest, switch_info_notify) {
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pool_init(&gApsSwitchInfoPool, sizeof(otai_olp_switch_t), 2));
+    gApsSwitchInfoId = 0x1234;
+    gApsSwitchInfoCount = 0;
+    gApsSwitchInfoRefCount = 0;
+
+    /* without reference notification switch info is passed by value and released */
+    otai_olp_switch_t *switch_info = acquire_aps_switch_info(1);
+    ASSERT_TRUE(switch_info != NULL);
+    otai_metadata_pool_report_aps_switch_info(&gApsSwitchInfoPool, NULL,
+            (otai_pointer_t)test_otai_aps_report_switch_info_value_fn, gApsSwitchInfoId, switch_info);
+    EXPECT_EQ(1, gApsSwitchInfoCount);
+    EXPECT_EQ(0, gApsSwitchInfoRefCount);
+    EXPECT_EQ(2u, otai_metadata_pool_get_available(&gApsSwitchInfoPool));
+
+    otai_metadata_pool_destroy(&gApsSwitchInfoPool);
+}
+
+TEST(OtaiApsTest, switch_info_ref_notify) {
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pool_init(&gApsSwitchInfoPool, sizeof(otai_olp_switch_t), 2));
+    gApsSwitchInfoId = 0x1234;
+    gApsSwitchInfoCount = 0;
+    gApsSwitchInfoRefCount = 0;
+
+    /* reference notification takes precedence, user releases buffer */
+    otai_olp_switch_t *switch_info = acquire_aps_switch_info(2);
+    ASSERT_TRUE(switch_info != NULL);
+    EXPECT_EQ(1u, otai_metadata_pool_get_available(&gApsSwitchInfoPool));
+    otai_metadata_pool_report_aps_switch_info(&gApsSwitchInfoPool,
+            (otai_pointer_t)test_otai_aps_report_switch_info_ref_fn,
+            (otai_pointer_t)test_otai_aps_report_switch_info_value_fn, gApsSwitchInfoId, switch_info);
+    EXPECT_EQ(0, gApsSwitchInfoCount);
+    EXPECT_EQ(1, gApsSwitchInfoRefCount);
+    EXPECT_EQ(2u, otai_metadata_pool_get_available(&gApsSwitchInfoPool));
+
+    /* released buffer is not in use any more */
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_pool_release(&gApsSwitchInfoPool, switch_info));
+
+    otai_metadata_pool_destroy(&gApsSwitchInfoPool);
+}
+
+TEST(OtaiApsTest, release_switch_info) {
+    /* API table is queried by test_aps */
+    ASSERT_TRUE(otai_aps_api != NULL);
+    ASSERT_TRUE(otai_aps_api->release_aps_switch_info != NULL);
+
+    /* adapter sends no switch info, so there is no buffer to release */
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_aps_api->release_aps_switch_info(NULL));
+}
+
+TEST(OtaiApsTest, switch_info_serialize) {
+    otai_olp_switch_t *switch_info = (otai_olp_switch_t*)calloc(1, sizeof(otai_olp_switch_t));
+    otai_olp_switch_t *out = (otai_olp_switch_t*)calloc(1, sizeof(otai_olp_switch_t));
+    ASSERT_TRUE(switch_info != NULL && out != NULL);
+
+    switch_info->num = 1;
+    switch_info->channel_id = 2;
+    switch_info->pointers = 300;
+    switch_info->info[0].index = 3;
+    switch_info->info[0].time_stamp = 1700000000000000000ULL;
+
+    /* by value and by reference notifications serialize the same way */
+    vector<char> buf(1024 * 1024);
+    int len = otai_serialize_aps_report_switch_info(buf.data(), 0x1234, switch_info);
+    ASSERT_GT(len, 0);
+    EXPECT_EQ((size_t)len, strlen(buf.data()));
+
+    otai_object_id_t aps_id = OTAI_NULL_OBJECT_ID;
+    EXPECT_EQ(len, otai_deserialize_aps_report_switch_info(buf.data(), &aps_id, out));
+    EXPECT_EQ(0x1234u, aps_id);
+    EXPECT_EQ(switch_info->num, out->num);
+    EXPECT_EQ(switch_info->channel_id, out->channel_id);
+    EXPECT_EQ(switch_info->pointers, out->pointers);
+    EXPECT_EQ(switch_info->info[0].index, out->info[0].index);
+    EXPECT_EQ(switch_info->info[0].time_stamp, out->info[0].time_stamp);
+
+    /* truncated input is rejected */
+    buf[len - 1] = 0;
+    EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_deserialize_aps_report_switch_info(buf.data(), &aps_id, out));
+
+    free(switch_info);
+    free(out);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+#include "otaimetadata.h"
+}
+
+static const otai_attr_metadata_t* arena_test_find_list(void)
+{
+    for (size_t i = 0; i < otai_metadata_attr_sorted_by_id_name_count; ++i)
+    {
+        const otai_attr_metadata_t *md = otai_metadata_attr_sorted_by_id_name[i];
+
+        if (md->attrvaluetype == OTAI_ATTR_VALUE_TYPE_OBJECT_LIST ||
+                md->attrvaluetype == OTAI_ATTR_VALUE_TYPE_UINT32_LIST)
+        {
+            return md;
+        }
+    }
+
+    return NULL;
+}
+
+TEST(OtaiArenaTest, alloc_and_reset)
+{
+    otai_metadata_arena_t arena;
+
+    otai_metadata_arena_init(&arena, 256, false);
+
+    uint8_t *first = (uint8_t*)otai_metadata_arena_alloc(&arena, 3);
+    uint8_t *second = (uint8_t*)otai_metadata_arena_alloc(&arena, 100);
+
+    ASSERT_NE(first, nullptr);
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(0u, (uintptr_t)second % sizeof(uint64_t));
+    EXPECT_EQ(0, second[0] | second[99]);
+
+    memset(second, 0xff, 100);
+
+    /* request bigger than block gets own block */
+
+    EXPECT_NE(nullptr, otai_metadata_arena_alloc(&arena, 1000));
+
+    size_t reserved = arena.reserved;
+
+    otai_metadata_arena_reset(&arena);
+
+    /* memory is reused and zeroed after reset */
+
+    EXPECT_EQ(first, otai_metadata_arena_alloc(&arena, 3));
+    EXPECT_EQ(second, otai_metadata_arena_alloc(&arena, 100));
+    EXPECT_EQ(0, second[0] | second[99]);
+    EXPECT_EQ(reserved, arena.reserved);
+
+    otai_metadata_arena_destroy(&arena);
+}
+
+TEST(OtaiArenaTest, pool_reuse)
+{
+    otai_metadata_arena_t arena;
+
+    otai_metadata_arena_init(&arena, 0, true);
+
+    void *ptr = otai_metadata_arena_alloc(&arena, 40);
+
+    ASSERT_NE(ptr, nullptr);
+
+    otai_metadata_arena_free(&arena, ptr);
+
+    /* same size class is taken from free list */
+
+    EXPECT_EQ(ptr, otai_metadata_arena_alloc(&arena, 64));
+
+    otai_metadata_arena_destroy(&arena);
+}
+
+TEST(OtaiArenaTest, too_large)
+{
+    otai_metadata_arena_t arena;
+
+    otai_metadata_arena_init(&arena, 0, true);
+
+    EXPECT_EQ(nullptr, otai_metadata_arena_alloc(&arena, SIZE_MAX));
+    EXPECT_EQ(nullptr, otai_metadata_arena_alloc(&arena, SIZE_MAX - 7));
+
+    arena.pool = false;
+
+    EXPECT_EQ(nullptr, otai_metadata_arena_alloc(&arena, SIZE_MAX - 7));
+    EXPECT_EQ(0u, arena.reserved);
+
+    otai_metadata_arena_destroy(&arena);
+}
+
+TEST(OtaiArenaTest, attr_value)
+{
+    const otai_attr_metadata_t *md = arena_test_find_list();
+
+    ASSERT_NE(md, nullptr);
+
+    otai_metadata_arena_t arena;
+
+    otai_metadata_arena_init(&arena, 0, true);
+
+    otai_alloc_info_t info;
+
+    memset(&info, 0, sizeof(info));
+
+    info.list_size = 7;
+    info.arena = &arena;
+
+    otai_attribute_t attr;
+
+    attr.id = md->attrid;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_alloc_attr_value(md, &attr, &info));
+    ASSERT_EQ(7u, attr.value.u32list.count);
+    ASSERT_NE(nullptr, attr.value.u32list.list);
+
+    attr.value.u32list.list[0] = 0x1234;
+
+    otai_attribute_t copy;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_deepcopy_attr_value_ext(md, &attr, &copy, &info));
+    EXPECT_NE(attr.value.u32list.list, copy.value.u32list.list);
+
+    bool equal = false;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_deepequal_attr_value(md, &attr, &copy, &equal));
+    EXPECT_TRUE(equal);
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_free_attr_value(md, &copy, &info));
+    EXPECT_EQ(0u, copy.value.u32list.count);
+    EXPECT_EQ(nullptr, copy.value.u32list.list);
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_free_attr_value(md, &attr, &info));
+
+    otai_metadata_arena_destroy(&arena);
+}
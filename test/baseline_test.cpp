@@ -0,0 +1,297 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+extern "C" {
+#include "otaimetadata.h"
+#include "otaimetadatabaseline.h"
+}
+
+#define BASELINE_TEST_OTDR(idx) ((otai_object_id_t)(0x2c00000000000000ULL + (idx)))
+
+static otai_metadata_baseline_config_t baseline_test_config(
+        _In_ uint32_t capacity)
+{
+    otai_metadata_baseline_config_t config;
+
+    memset(&config, 0, sizeof(config));
+
+    config.capacity = capacity;
+    config.distanceaccuracy = 10;
+    config.samplingresolution = 1;
+    config.lossthreshold = 0.2;
+
+    return config;
+}
+
+static otai_otdr_event_t baseline_test_event(
+        _In_ otai_otdr_event_type_t type,
+        _In_ double length,
+        _In_ double loss)
+{
+    otai_otdr_event_t event;
+
+    memset(&event, 0, sizeof(event));
+
+    event.type = type;
+    event.length = length;
+    event.loss = loss;
+
+    return event;
+}
+
+/*
+ * Trace of 0.2 dB/km fiber in 0.001 dB units, with offset at start and
+ * extra loss after sample.
+ */
+static std::vector<uint8_t> baseline_test_trace(
+        _In_ uint32_t count,
+        _In_ double offset,
+        _In_ uint32_t losssample,
+        _In_ double loss)
+{
+    std::vector<uint8_t> trace;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        double level = 5 + offset + 0.0002 * i + (i >= losssample ? loss : 0);
+
+        uint16_t sample = (uint16_t)(level * 1000 + 0.5);
+
+        trace.push_back((uint8_t)(sample >> 8));
+        trace.push_back((uint8_t)sample);
+    }
+
+    return trace;
+}
+
+static otai_otdr_result_t baseline_test_result(
+        _In_ std::vector<otai_otdr_event_t> &events,
+        _In_ std::vector<uint8_t> &trace)
+{
+    otai_otdr_result_t result;
+
+    memset(&result, 0, sizeof(result));
+
+    result.events.events.count = (uint32_t)events.size();
+    result.events.events.list = events.data();
+    result.trace.data.count = (uint32_t)trace.size();
+    result.trace.data.list = trace.data();
+
+    return result;
+}
+
+TEST(OtaiBaselineTest, invalid_config)
+{
+    otai_metadata_baseline_config_t config = baseline_test_config(0);
+    otai_metadata_baseline_t baseline;
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_baseline_init(&baseline, &config));
+
+    config = baseline_test_config(4);
+    config.lossthreshold = 0;
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_baseline_init(&baseline, &config));
+
+    /* same attributes as OTDR analysis, others are ignored */
+
+    otai_attribute_t attrs[4];
+
+    attrs[0].id = OTAI_OTDR_ATTR_DISTANCE_ACCURACY;
+    attrs[0].value.d64 = 2;
+    attrs[1].id = OTAI_OTDR_ATTR_SAMPLING_RESOLUTION;
+    attrs[1].value.d64 = 0.5;
+    attrs[2].id = OTAI_OTDR_ATTR_SPLICE_LOSS_THRESHOLD;
+    attrs[2].value.d64 = 0.3;
+    attrs[3].id = OTAI_OTDR_ATTR_PULSE_WIDTH;
+    attrs[3].value.u32 = 100;
+
+    config = baseline_test_config(4);
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_baseline_config_from_attr_list(&config, 4, attrs));
+    EXPECT_EQ(2, config.distanceaccuracy);
+    EXPECT_EQ(0.5, config.samplingresolution);
+    EXPECT_EQ(0.3, config.lossthreshold);
+    EXPECT_EQ(4u, config.capacity);
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_baseline_config_from_attr_list(&config, 1, NULL));
+}
+
+TEST(OtaiBaselineTest, set_get_remove)
+{
+    otai_metadata_baseline_config_t config = baseline_test_config(64);
+    otai_metadata_baseline_t baseline;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_baseline_init(&baseline, &config));
+
+    std::vector<uint8_t> trace = baseline_test_trace(16, 0, 16, 0);
+
+    uint32_t idx = 0;
+
+    for (; idx < 64; idx++)
+    {
+        std::vector<otai_otdr_event_t> events = { baseline_test_event(OTAI_OTDR_EVENT_TYPE_END, idx, 0) };
+
+        otai_otdr_result_t result = baseline_test_result(events, trace);
+
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_baseline_set(&baseline, BASELINE_TEST_OTDR(idx), &result));
+    }
+
+    std::vector<otai_otdr_event_t> events = { baseline_test_event(OTAI_OTDR_EVENT_TYPE_END, 100, 0) };
+
+    otai_otdr_result_t result = baseline_test_result(events, trace);
+
+    EXPECT_EQ(OTAI_STATUS_TABLE_FULL, otai_metadata_baseline_set(&baseline, BASELINE_TEST_OTDR(64), &result));
+
+    /* existing baseline is replaced even when store is full */
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_baseline_set(&baseline, BASELINE_TEST_OTDR(1), &result));
+
+    for (idx = 0; idx < 64; idx += 2)
+    {
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_baseline_remove(&baseline, BASELINE_TEST_OTDR(idx)));
+    }
+
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_baseline_remove(&baseline, BASELINE_TEST_OTDR(0)));
+    EXPECT_EQ(nullptr, otai_metadata_baseline_get(&baseline, BASELINE_TEST_OTDR(0)));
+
+    /* moved baselines are still found, and own copy of result */
+
+    events[0].length = -1;
+    trace[0] = 0xff;
+
+    for (idx = 1; idx < 64; idx += 2)
+    {
+        const otai_metadata_baseline_entry_t *entry = otai_metadata_baseline_get(&baseline, BASELINE_TEST_OTDR(idx));
+
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(BASELINE_TEST_OTDR(idx), entry->otdrid);
+        ASSERT_EQ(1u, entry->events.events.count);
+        EXPECT_EQ(idx == 1 ? 100 : (double)idx, entry->events.events.list[0].length);
+        ASSERT_EQ(16u, entry->samplecount);
+        EXPECT_EQ(5000, entry->samples[0]);
+    }
+
+    otai_metadata_baseline_destroy(&baseline);
+}
+
+TEST(OtaiBaselineTest, diff_events)
+{
+    otai_metadata_baseline_config_t config = baseline_test_config(4);
+    otai_metadata_baseline_t baseline;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_baseline_init(&baseline, &config));
+
+    std::vector<uint8_t> trace;
+
+    std::vector<otai_otdr_event_t> events = {
+        baseline_test_event(OTAI_OTDR_EVENT_TYPE_START, 0, 0),
+        baseline_test_event(OTAI_OTDR_EVENT_TYPE_FIBER_SECTION, 5, 1),
+        baseline_test_event(OTAI_OTDR_EVENT_TYPE_NON_REFLECTION, 5, 0.3),
+        baseline_test_event(OTAI_OTDR_EVENT_TYPE_FIBER_SECTION, 5, 1),
+        baseline_test_event(OTAI_OTDR_EVENT_TYPE_REFLECTION, 10, 0.5),
+        baseline_test_event(OTAI_OTDR_EVENT_TYPE_FIBER_SECTION, 10, 2),
+        baseline_test_event(OTAI_OTDR_EVENT_TYPE_END, 20, 0) };
+
+    otai_otdr_result_t result = baseline_test_result(events, trace);
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_baseline_set(&baseline, BASELINE_TEST_OTDR(0), &result));
+
+    /* splice grew, connector is gone, new bend, end within accuracy */
+
+    std::vector<otai_otdr_event_t> scan = {
+        baseline_test_event(OTAI_OTDR_EVENT_TYPE_START, 0, 0),
+        baseline_test_event(OTAI_OTDR_EVENT_TYPE_NON_REFLECTION, 5.005, 0.6),
+        baseline_test_event(OTAI_OTDR_EVENT_TYPE_NON_REFLECTION, 12, 0.4),
+        baseline_test_event(OTAI_OTDR_EVENT_TYPE_NON_REFLECTION, 15, 0.1),
+        baseline_test_event(OTAI_OTDR_EVENT_TYPE_END, 20.008, 0) };
+
+    otai_otdr_events_t scanevents;
+
+    memset(&scanevents, 0, sizeof(scanevents));
+
+    scanevents.events.count = (uint32_t)scan.size();
+    scanevents.events.list = scan.data();
+
+    otai_metadata_baseline_change_t changes[4];
+
+    uint32_t count = 4;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_baseline_diff_events(&baseline, BASELINE_TEST_OTDR(0), &scanevents, &count, changes));
+    ASSERT_EQ(3u, count);
+
+    EXPECT_EQ(OTAI_METADATA_BASELINE_CHANGE_TYPE_GROWN, changes[0].type);
+    EXPECT_EQ(5.005, changes[0].distance);
+    EXPECT_EQ(0.3, changes[0].baselineloss);
+    EXPECT_EQ(0.6, changes[0].loss);
+
+    EXPECT_EQ(OTAI_METADATA_BASELINE_CHANGE_TYPE_MISSING, changes[1].type);
+    EXPECT_EQ(OTAI_OTDR_EVENT_TYPE_REFLECTION, changes[1].eventtype);
+    EXPECT_EQ(10, changes[1].distance);
+
+    EXPECT_EQ(OTAI_METADATA_BASELINE_CHANGE_TYPE_NEW, changes[2].type);
+    EXPECT_EQ(12, changes[2].distance);
+
+    count = 1;
+
+    EXPECT_EQ(OTAI_STATUS_BUFFER_OVERFLOW, otai_metadata_baseline_diff_events(&baseline, BASELINE_TEST_OTDR(0), &scanevents, &count, changes));
+    EXPECT_EQ(1u, count);
+    EXPECT_EQ(OTAI_METADATA_BASELINE_CHANGE_TYPE_GROWN, changes[0].type);
+
+    count = 4;
+
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_baseline_diff_events(&baseline, BASELINE_TEST_OTDR(1), &scanevents, &count, changes));
+
+    otai_metadata_baseline_destroy(&baseline);
+}
+
+TEST(OtaiBaselineTest, diff_trace)
+{
+    otai_metadata_baseline_config_t config = baseline_test_config(4);
+    otai_metadata_baseline_t baseline;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_baseline_init(&baseline, &config));
+
+    std::vector<otai_otdr_event_t> events;
+    std::vector<uint8_t> trace = baseline_test_trace(5000, 0, 5000, 0);
+
+    otai_otdr_result_t result = baseline_test_result(events, trace);
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_baseline_set(&baseline, BASELINE_TEST_OTDR(0), &result));
+
+    otai_metadata_baseline_trace_diff_t diff;
+
+    /* launch level change alone is not deviation */
+
+    std::vector<uint8_t> scan = baseline_test_trace(5000, 0.5, 5000, 0);
+
+    otai_u8_list_t list;
+
+    list.count = (uint32_t)scan.size();
+    list.list = scan.data();
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_baseline_diff_trace(&baseline, BASELINE_TEST_OTDR(0), &list, &diff));
+    EXPECT_EQ(5000u, diff.samples);
+    EXPECT_NEAR(0.5, diff.offset, 0.001);
+    EXPECT_LT(diff.distance, 0);
+    EXPECT_NEAR(0, diff.extraloss, 0.001);
+
+    /* new loss at 3 km is located within window */
+
+    scan = baseline_test_trace(6000, 0.5, 3000, 1);
+
+    list.count = (uint32_t)scan.size();
+    list.list = scan.data();
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_baseline_diff_trace(&baseline, BASELINE_TEST_OTDR(0), &list, &diff));
+    EXPECT_EQ(5000u, diff.samples);
+    EXPECT_NEAR(0.5, diff.offset, 0.001);
+    EXPECT_NEAR(3, diff.distance, 0.256);
+    EXPECT_NEAR(1, diff.extraloss, 0.001);
+    EXPECT_NEAR(1, diff.deviation, 0.001);
+
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_baseline_diff_trace(&baseline, BASELINE_TEST_OTDR(1), &list, &diff));
+
+    otai_metadata_baseline_destroy(&baseline);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+extern "C" {
+#include "otaimetadata.h"
+}
+
+#define BULK_TEST_FAILED_INDEX 130
+
+/* chunk size used by meta bulk wrappers */
+#define BULK_TEST_CHUNK_SIZE 128
+
+static otai_status_t bulk_test_create(
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t object_count,
+        _In_ const uint32_t *attr_count,
+        _In_ const otai_attribute_t **attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_object_id_t *object_id,
+        _Out_ otai_status_t *object_statuses)
+{
+    otai_status_t status = OTAI_STATUS_SUCCESS;
+
+    for (uint32_t i = 0; i < object_count; ++i)
+    {
+        /* attr_count carries global object index, failed ids are left untouched */
+
+        if (attr_count[i] == BULK_TEST_FAILED_INDEX)
+        {
+            object_statuses[i] = OTAI_STATUS_INVALID_PARAMETER;
+            status = OTAI_STATUS_FAILURE;
+
+            if (mode == OTAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR)
+            {
+                for (++i; i < object_count; ++i)
+                {
+                    object_statuses[i] = OTAI_STATUS_NOT_EXECUTED;
+                }
+            }
+
+            continue;
+        }
+
+        object_id[i] = 0x1000 + attr_count[i];
+        object_statuses[i] = OTAI_STATUS_SUCCESS;
+    }
+
+    return status;
+}
+
+static otai_status_t bulk_test_generic_create(
+        _Inout_ otai_object_meta_key_t *meta_key,
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    return OTAI_STATUS_FAILURE;
+}
+
+static void bulk_test_run(
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ std::vector<otai_object_meta_key_t>& keys,
+        _Out_ std::vector<otai_status_t>& statuses)
+{
+    const uint32_t count = 300;
+
+    std::vector<uint32_t> attr_count(count);
+    std::vector<const otai_attribute_t*> attr_list(count, NULL);
+
+    keys.assign(count, otai_object_meta_key_t());
+    statuses.assign(count, OTAI_STATUS_SUCCESS);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        attr_count[i] = i;
+        keys[i].objectkey.key.object_id = 0xdead;
+    }
+
+    EXPECT_EQ(OTAI_STATUS_FAILURE, otai_metadata_bulk_create(bulk_test_create, bulk_test_generic_create,
+                1, count, keys.data(), attr_count.data(), attr_list.data(), mode, statuses.data()));
+}
+
+TEST(OtaiBulkTest, create_ignore_error)
+{
+    std::vector<otai_object_meta_key_t> keys;
+    std::vector<otai_status_t> statuses;
+
+    bulk_test_run(OTAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, keys, statuses);
+
+    for (uint32_t i = 0; i < keys.size(); ++i)
+    {
+        if (i == BULK_TEST_FAILED_INDEX)
+        {
+            EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, statuses[i]);
+            EXPECT_EQ(OTAI_NULL_OBJECT_ID, keys[i].objectkey.key.object_id);
+            continue;
+        }
+
+        EXPECT_EQ(OTAI_STATUS_SUCCESS, statuses[i]) << i;
+        EXPECT_EQ(0x1000u + i, keys[i].objectkey.key.object_id) << i;
+    }
+}
+
+TEST(OtaiBulkTest, create_stop_on_error)
+{
+    std::vector<otai_object_meta_key_t> keys;
+    std::vector<otai_status_t> statuses;
+
+    bulk_test_run(OTAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR, keys, statuses);
+
+    for (uint32_t i = 0; i < keys.size(); ++i)
+    {
+        if (i < BULK_TEST_FAILED_INDEX)
+        {
+            EXPECT_EQ(OTAI_STATUS_SUCCESS, statuses[i]) << i;
+            EXPECT_EQ(0x1000u + i, keys[i].objectkey.key.object_id) << i;
+            continue;
+        }
+
+        EXPECT_NE(OTAI_STATUS_SUCCESS, statuses[i]) << i;
+
+        /* ids of failed and not executed objects in failing chunk are cleared */
+
+        if (i / BULK_TEST_CHUNK_SIZE == BULK_TEST_FAILED_INDEX / BULK_TEST_CHUNK_SIZE)
+        {
+            EXPECT_EQ(OTAI_NULL_OBJECT_ID, keys[i].objectkey.key.object_id) << i;
+        }
+    }
+
+    EXPECT_EQ(OTAI_STATUS_NOT_EXECUTED, statuses[BULK_TEST_FAILED_INDEX + 1]);
+    EXPECT_EQ(OTAI_STATUS_NOT_EXECUTED, statuses[keys.size() - 1]);
+}
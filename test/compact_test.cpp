@@ -0,0 +1,250 @@
+#include <gtest/gtest.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "otaimetadata.h"
+#include "otaimetadatacompact.h"
+}
+
+#define COMPACT_TEST_ATTRS 8
+#define COMPACT_TEST_HEAP_WORDS 512
+
+typedef struct _compact_test_list_t
+{
+    otai_compact_attribute_list_t list;
+
+    otai_compact_attribute_t attrs[COMPACT_TEST_ATTRS];
+
+    uint64_t heap[COMPACT_TEST_HEAP_WORDS];
+
+} compact_test_list_t;
+
+static void compact_test_init(
+        _Out_ compact_test_list_t *t,
+        _In_ const otai_attr_metadata_t *meta,
+        _In_ uint32_t count,
+        _In_ size_t heap_size)
+{
+    otai_metadata_compact_list_init(&t->list, meta->objecttype, count, t->attrs, heap_size, (uint8_t*)t->heap);
+}
+
+static const otai_attr_metadata_t* compact_test_find(
+        _In_ otai_attr_value_type_t type)
+{
+    for (size_t i = 0; i < otai_metadata_attr_sorted_by_id_name_count; ++i)
+    {
+        if (otai_metadata_attr_sorted_by_id_name[i]->attrvaluetype == type)
+        {
+            return otai_metadata_attr_sorted_by_id_name[i];
+        }
+    }
+
+    return NULL;
+}
+
+TEST(OtaiCompactTest, attribute_size)
+{
+    EXPECT_EQ(16u, sizeof(otai_compact_attribute_t));
+}
+
+TEST(OtaiCompactTest, scalar_round_trip)
+{
+    const otai_attr_metadata_t *meta = compact_test_find(OTAI_ATTR_VALUE_TYPE_UINT32);
+
+    ASSERT_NE(meta, nullptr);
+
+    compact_test_list_t t;
+
+    compact_test_init(&t, meta, COMPACT_TEST_ATTRS, sizeof(t.heap));
+
+    otai_attribute_t attr;
+
+    attr.id = meta->attrid;
+    attr.value.u32 = 0xfffffffe;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_compact_list_append(&t.list, &attr));
+
+    EXPECT_EQ(0u, t.list.heapused);
+
+    const otai_compact_attribute_t *compact = otai_metadata_compact_list_find(&t.list, meta->attrid);
+
+    ASSERT_NE(compact, nullptr);
+    EXPECT_EQ(0xfffffffeu, compact->value.u32);
+    EXPECT_EQ(nullptr, otai_metadata_compact_list_get_chardata(&t.list, compact));
+    EXPECT_EQ(nullptr, otai_metadata_compact_list_get_items(&t.list, compact));
+
+    otai_attribute_t out;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_compact_list_get_attr(&t.list, compact, &out));
+    EXPECT_EQ(attr.id, out.id);
+    EXPECT_EQ(attr.value.u32, out.value.u32);
+}
+
+TEST(OtaiCompactTest, chardata_round_trip)
+{
+    const otai_attr_metadata_t *meta = compact_test_find(OTAI_ATTR_VALUE_TYPE_CHARDATA);
+
+    ASSERT_NE(meta, nullptr);
+
+    compact_test_list_t t;
+
+    compact_test_init(&t, meta, COMPACT_TEST_ATTRS, sizeof(t.heap));
+
+    otai_attribute_t attr;
+
+    attr.id = meta->attrid;
+    strcpy(attr.value.chardata, "compact");
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_compact_list_append(&t.list, &attr));
+
+    const otai_compact_attribute_t *compact = &t.list.attrlist[0];
+
+    EXPECT_EQ(7u, compact->count);
+    EXPECT_STREQ("compact", otai_metadata_compact_list_get_chardata(&t.list, compact));
+
+    /* char data using whole buffer without terminating zero is kept whole */
+
+    memset(attr.value.chardata, 'x', sizeof(attr.value.chardata));
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_compact_list_append(&t.list, &attr));
+
+    compact = &t.list.attrlist[1];
+
+    EXPECT_EQ((uint32_t)sizeof(attr.value.chardata), compact->count);
+    EXPECT_EQ(std::string(sizeof(attr.value.chardata), 'x'), otai_metadata_compact_list_get_chardata(&t.list, compact));
+
+    otai_attribute_t out;
+
+    memset(&out, 0, sizeof(out));
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_compact_list_get_attr(&t.list, compact, &out));
+    EXPECT_EQ(0, memcmp(attr.value.chardata, out.value.chardata, sizeof(out.value.chardata)));
+}
+
+TEST(OtaiCompactTest, list_round_trip)
+{
+    const otai_attr_metadata_t *meta = compact_test_find(OTAI_ATTR_VALUE_TYPE_UINT32_LIST);
+
+    if (meta == NULL)
+    {
+        meta = compact_test_find(OTAI_ATTR_VALUE_TYPE_OBJECT_LIST);
+    }
+
+    ASSERT_NE(meta, nullptr);
+
+    compact_test_list_t t;
+
+    compact_test_init(&t, meta, COMPACT_TEST_ATTRS, sizeof(t.heap));
+
+    std::vector<otai_object_id_t> items(5);
+
+    for (size_t i = 0; i < items.size(); ++i)
+    {
+        items[i] = 0x1000 + i;
+    }
+
+    otai_attribute_t attr;
+
+    attr.id = meta->attrid;
+
+    /* object list and u32 list share count and list layout */
+
+    if (meta->attrvaluetype == OTAI_ATTR_VALUE_TYPE_OBJECT_LIST)
+    {
+        attr.value.objlist.count = (uint32_t)items.size();
+        attr.value.objlist.list = items.data();
+    }
+    else
+    {
+        attr.value.u32list.count = (uint32_t)(items.size() * 2);
+        attr.value.u32list.list = (uint32_t*)items.data();
+    }
+
+    uint32_t count = attr.value.u32list.count;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_compact_list_append(&t.list, &attr));
+
+    const otai_compact_attribute_t *compact = &t.list.attrlist[0];
+
+    ASSERT_EQ(count, compact->count);
+
+    const void *stored = otai_metadata_compact_list_get_items(&t.list, compact);
+
+    ASSERT_NE(stored, nullptr);
+    EXPECT_NE((const void*)items.data(), stored);
+    EXPECT_EQ(0u, (uintptr_t)stored % sizeof(uint64_t));
+    EXPECT_EQ(0, memcmp(items.data(), stored, items.size() * sizeof(otai_object_id_t)));
+
+    /* converted list points to heap */
+
+    otai_attribute_t out[COMPACT_TEST_ATTRS];
+    uint32_t out_count = COMPACT_TEST_ATTRS;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_compact_list_to_attr_list(&t.list, &out_count, out));
+    ASSERT_EQ(1u, out_count);
+    EXPECT_EQ(count, out[0].value.u32list.count);
+    EXPECT_EQ(stored, (const void*)out[0].value.u32list.list);
+
+    /* empty list stores no items */
+
+    attr.value.u32list.count = 0;
+    attr.value.u32list.list = NULL;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_compact_list_append(&t.list, &attr));
+    EXPECT_EQ(nullptr, otai_metadata_compact_list_get_items(&t.list, &t.list.attrlist[1]));
+
+    /* count without list is rejected */
+
+    attr.value.u32list.count = 1;
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_compact_list_append(&t.list, &attr));
+    EXPECT_EQ(2u, t.list.attrcount);
+}
+
+TEST(OtaiCompactTest, overflow)
+{
+    const otai_attr_metadata_t *meta = compact_test_find(OTAI_ATTR_VALUE_TYPE_CHARDATA);
+
+    ASSERT_NE(meta, nullptr);
+
+    compact_test_list_t t;
+
+    /* heap smaller than one char data */
+
+    compact_test_init(&t, meta, COMPACT_TEST_ATTRS, 16);
+
+    otai_attribute_t attr;
+
+    attr.id = meta->attrid;
+    memset(attr.value.chardata, 'y', sizeof(attr.value.chardata));
+
+    EXPECT_EQ(OTAI_STATUS_BUFFER_OVERFLOW, otai_metadata_compact_list_append(&t.list, &attr));
+    EXPECT_EQ(0u, t.list.attrcount);
+
+    /* attribute array full */
+
+    compact_test_init(&t, meta, 1, sizeof(t.heap));
+
+    strcpy(attr.value.chardata, "a");
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_compact_list_from_attr_list(&t.list, 1, &attr));
+    EXPECT_EQ(OTAI_STATUS_BUFFER_OVERFLOW, otai_metadata_compact_list_append(&t.list, &attr));
+
+    otai_attribute_t out;
+    uint32_t out_count = 0;
+
+    EXPECT_EQ(OTAI_STATUS_BUFFER_OVERFLOW, otai_metadata_compact_list_to_attr_list(&t.list, &out_count, &out));
+    EXPECT_EQ(1u, out_count);
+
+    otai_metadata_compact_list_clear(&t.list);
+
+    EXPECT_EQ(0u, t.list.attrcount);
+    EXPECT_EQ(0u, t.list.heapused);
+    EXPECT_EQ(nullptr, otai_metadata_compact_list_find(&t.list, meta->attrid));
+
+    attr.id = 0xffffff;
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_compact_list_append(&t.list, &attr));
+}
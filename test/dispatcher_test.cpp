@@ -0,0 +1,643 @@
+#include <gtest/gtest.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <vector>
+
+extern "C" {
+#include "otaimetadata.h"
+#include "otaimetadatadispatcher.h"
+#include "otaimetadatapool.h"
+}
+
+#define DISPATCHER_TEST_TIMEOUT_MS 5000
+
+typedef struct _dispatcher_test_callbacks_t
+{
+    otai_linecard_state_change_notification_fn statechange;
+
+    otai_linecard_alarm_notification_fn alarm;
+
+    otai_aps_report_switch_info_fn switchinfo;
+
+    otai_aps_report_switch_info_ref_fn switchinforef;
+
+} dispatcher_test_callbacks_t;
+
+typedef struct _dispatcher_test_call_t
+{
+    int handler;
+
+    otai_object_id_t id;
+
+    otai_object_id_t resource;
+
+} dispatcher_test_call_t;
+
+/* callbacks adapter got on create, by object id */
+static std::map<otai_object_id_t, dispatcher_test_callbacks_t> dispatcher_test_objects;
+
+static otai_object_id_t dispatcher_test_next_id = 0x100;
+
+static bool dispatcher_test_notify_on_create = false;
+
+static otai_object_id_t dispatcher_test_aps_linecard = OTAI_NULL_OBJECT_ID;
+
+static std::mutex dispatcher_test_mutex;
+
+static std::condition_variable dispatcher_test_cond;
+
+static std::vector<dispatcher_test_call_t> dispatcher_test_calls;
+
+static bool dispatcher_test_gate = true;
+
+static otai_metadata_pool_t dispatcher_test_pool;
+
+static void dispatcher_test_record(
+        _In_ int handler,
+        _In_ otai_object_id_t id,
+        _In_ otai_object_id_t resource)
+{
+    std::unique_lock<std::mutex> lock(dispatcher_test_mutex);
+
+    /* closed gate blocks dispatcher thread, so rings fill up */
+
+    dispatcher_test_cond.wait(lock, []{ return dispatcher_test_gate; });
+
+    dispatcher_test_calls.push_back({handler, id, resource});
+}
+
+static void dispatcher_test_set_gate(
+        _In_ bool open)
+{
+    std::lock_guard<std::mutex> lock(dispatcher_test_mutex);
+
+    dispatcher_test_gate = open;
+
+    dispatcher_test_cond.notify_all();
+}
+
+static std::vector<dispatcher_test_call_t> dispatcher_test_take_calls(void)
+{
+    std::lock_guard<std::mutex> lock(dispatcher_test_mutex);
+
+    std::vector<dispatcher_test_call_t> calls;
+
+    calls.swap(dispatcher_test_calls);
+
+    return calls;
+}
+
+static void dispatcher_test_state_a(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_oper_status_t linecard_oper_status)
+{
+    dispatcher_test_record(1, linecard_id, OTAI_NULL_OBJECT_ID);
+}
+
+static void dispatcher_test_state_b(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_oper_status_t linecard_oper_status)
+{
+    dispatcher_test_record(2, linecard_id, OTAI_NULL_OBJECT_ID);
+}
+
+static void dispatcher_test_alarm(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_alarm_type_t alarm_type,
+        _In_ otai_alarm_info_t alarm_info)
+{
+    dispatcher_test_record(3, linecard_id, alarm_info.resource_oid);
+}
+
+static void dispatcher_test_switch_info(
+        _In_ otai_object_id_t aps_id,
+        _In_ otai_olp_switch_t switch_info)
+{
+    dispatcher_test_record(4, aps_id, switch_info.num);
+}
+
+static otai_status_t dispatcher_test_release_switch_info(
+        _In_ const otai_olp_switch_t *switch_info)
+{
+    return otai_metadata_pool_release(&dispatcher_test_pool, switch_info);
+}
+
+static void dispatcher_test_switch_info_ref(
+        _In_ otai_object_id_t aps_id,
+        _In_ const otai_olp_switch_t *switch_info)
+{
+    /* buffer pointer is recorded, so test sees it was not copied */
+
+    dispatcher_test_record(5, aps_id, (otai_object_id_t)(uintptr_t)switch_info);
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, dispatcher_test_release_switch_info(switch_info));
+}
+
+static dispatcher_test_callbacks_t dispatcher_test_collect(
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list,
+        _In_ bool aps)
+{
+    dispatcher_test_callbacks_t callbacks = { NULL, NULL, NULL, NULL };
+
+    for (uint32_t i = 0; i < attr_count; ++i)
+    {
+        otai_pointer_t ptr = attr_list[i].value.ptr;
+
+        if (aps && attr_list[i].id == OTAI_APS_ATTR_SWITCH_INFO_NOTIFY)
+        {
+            callbacks.switchinfo = (otai_aps_report_switch_info_fn)ptr;
+        }
+        else if (aps && attr_list[i].id == OTAI_APS_ATTR_SWITCH_INFO_REF_NOTIFY)
+        {
+            callbacks.switchinforef = (otai_aps_report_switch_info_ref_fn)ptr;
+        }
+        else if (!aps && attr_list[i].id == OTAI_LINECARD_ATTR_LINECARD_STATE_CHANGE_NOTIFY)
+        {
+            callbacks.statechange = (otai_linecard_state_change_notification_fn)ptr;
+        }
+        else if (!aps && attr_list[i].id == OTAI_LINECARD_ATTR_LINECARD_ALARM_NOTIFY)
+        {
+            callbacks.alarm = (otai_linecard_alarm_notification_fn)ptr;
+        }
+    }
+
+    return callbacks;
+}
+
+static otai_status_t dispatcher_test_create_linecard(
+        _Out_ otai_object_id_t *linecard_id,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    otai_object_id_t id = dispatcher_test_next_id++;
+
+    dispatcher_test_callbacks_t callbacks = dispatcher_test_collect(attr_count, attr_list, false);
+
+    /* adapter may notify before create returns */
+
+    if (dispatcher_test_notify_on_create && callbacks.statechange != NULL)
+    {
+        callbacks.statechange(id, OTAI_OPER_STATUS_ACTIVE);
+    }
+
+    dispatcher_test_objects[id] = callbacks;
+
+    *linecard_id = id;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static otai_status_t dispatcher_test_create_aps(
+        _Out_ otai_object_id_t *aps_id,
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    *aps_id = dispatcher_test_next_id++;
+
+    dispatcher_test_objects[*aps_id] = dispatcher_test_collect(attr_count, attr_list, true);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static otai_status_t dispatcher_test_create_failed(
+        _Out_ otai_object_id_t *linecard_id,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    return OTAI_STATUS_FAILURE;
+}
+
+static otai_object_id_t dispatcher_test_linecard_query(
+        _In_ otai_object_id_t object_id)
+{
+    return dispatcher_test_aps_linecard;
+}
+
+static otai_object_id_t dispatcher_test_linecard(
+        _In_ otai_linecard_state_change_notification_fn statechange)
+{
+    otai_attribute_t attrs[2];
+
+    attrs[0].id = OTAI_LINECARD_ATTR_LINECARD_STATE_CHANGE_NOTIFY;
+    attrs[0].value.ptr = (otai_pointer_t)statechange;
+    attrs[1].id = OTAI_LINECARD_ATTR_LINECARD_ALARM_NOTIFY;
+    attrs[1].value.ptr = (otai_pointer_t)dispatcher_test_alarm;
+
+    otai_object_id_t id = OTAI_NULL_OBJECT_ID;
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_create_linecard(dispatcher_test_create_linecard, &id, 2, attrs));
+
+    /* caller list is not modified */
+
+    EXPECT_EQ((otai_pointer_t)statechange, attrs[0].value.ptr);
+
+    return id;
+}
+
+static void dispatcher_test_alarm_of(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_object_id_t resource)
+{
+    otai_alarm_info_t info;
+
+    memset(&info, 0, sizeof(info));
+
+    info.resource_oid = resource;
+
+    dispatcher_test_objects[linecard_id].alarm(linecard_id, OTAI_ALARM_TYPE_RX_LOS, info);
+}
+
+static void dispatcher_test_start(
+        _In_ uint32_t ring_size,
+        _In_ uint32_t threads,
+        _In_ otai_metadata_dispatcher_policy_t policy)
+{
+    otai_metadata_dispatcher_config_t config = { ring_size, threads, policy, dispatcher_test_linecard_query,
+        dispatcher_test_release_switch_info };
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_start(&config));
+}
+
+/*
+ * Notifications are dispatched asynchronously, wait until all queued ones
+ * are delivered or dropped. Lost wakeup shows up as timeout. Sum of all
+ * objects also counts notifications of unknown objects as dropped, so
+ * only per object wait accounts for drops.
+ */
+static otai_metadata_dispatcher_stats_t dispatcher_test_wait_idle(
+        _In_ otai_object_id_t object_id = OTAI_NULL_OBJECT_ID)
+{
+    otai_metadata_dispatcher_stats_t stats;
+
+    int waited = 0;
+
+    do
+    {
+        EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_get_stats(object_id, &stats));
+
+        uint64_t dropped = (object_id == OTAI_NULL_OBJECT_ID) ? 0 : stats.dropped;
+
+        if (stats.depth == 0 && stats.dispatched + dropped == stats.enqueued)
+        {
+            return stats;
+        }
+
+        usleep(1000);
+    }
+    while (++waited < DISPATCHER_TEST_TIMEOUT_MS);
+
+    ADD_FAILURE() << "notifications not delivered, depth " << stats.depth;
+
+    return stats;
+}
+
+static void dispatcher_test_cleanup(void)
+{
+    otai_metadata_dispatcher_stop();
+
+    for (auto& object: dispatcher_test_objects)
+    {
+        EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_remove(object.first));
+    }
+
+    dispatcher_test_objects.clear();
+    dispatcher_test_take_calls();
+    dispatcher_test_aps_linecard = OTAI_NULL_OBJECT_ID;
+    dispatcher_test_notify_on_create = false;
+}
+
+TEST(OtaiDispatcherTest, direct_when_not_started)
+{
+    otai_object_id_t id = dispatcher_test_linecard(dispatcher_test_state_a);
+
+    dispatcher_test_objects[id].statechange(id, OTAI_OPER_STATUS_ACTIVE);
+
+    std::vector<dispatcher_test_call_t> calls = dispatcher_test_take_calls();
+
+    ASSERT_EQ(1u, calls.size());
+    EXPECT_EQ(1, calls[0].handler);
+    EXPECT_EQ(id, calls[0].id);
+
+    otai_metadata_dispatcher_stats_t stats;
+
+    EXPECT_EQ(OTAI_STATUS_UNINITIALIZED, otai_metadata_dispatcher_get_stats(id, &stats));
+
+    /* failed create is not remembered */
+
+    otai_object_id_t failed = OTAI_NULL_OBJECT_ID;
+
+    EXPECT_EQ(OTAI_STATUS_FAILURE, otai_metadata_dispatcher_create_linecard(dispatcher_test_create_failed, &failed, 0, NULL));
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_dispatcher_create_linecard(NULL, &failed, 0, NULL));
+
+    dispatcher_test_cleanup();
+
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_dispatcher_remove(id));
+}
+
+TEST(OtaiDispatcherTest, handlers_per_linecard)
+{
+    dispatcher_test_start(64, 2, OTAI_METADATA_DISPATCHER_POLICY_DROP_OLDEST);
+
+    otai_object_id_t a = dispatcher_test_linecard(dispatcher_test_state_a);
+    otai_object_id_t b = dispatcher_test_linecard(dispatcher_test_state_b);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        dispatcher_test_objects[a].statechange(a, OTAI_OPER_STATUS_ACTIVE);
+        dispatcher_test_objects[b].statechange(b, OTAI_OPER_STATUS_INACTIVE);
+    }
+
+    dispatcher_test_wait_idle();
+
+    std::vector<dispatcher_test_call_t> calls = dispatcher_test_take_calls();
+
+    ASSERT_EQ(20u, calls.size());
+
+    for (auto& call: calls)
+    {
+        EXPECT_EQ(call.handler == 1 ? a : b, call.id);
+    }
+
+    dispatcher_test_cleanup();
+}
+
+TEST(OtaiDispatcherTest, ring_per_linecard)
+{
+    dispatcher_test_start(4, 3, OTAI_METADATA_DISPATCHER_POLICY_DROP_OLDEST);
+
+    /* notifications of unknown objects are counted globally */
+
+    otai_metadata_dispatcher_stats_t stats;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_get_stats(OTAI_NULL_OBJECT_ID, &stats));
+
+    uint64_t dropped = stats.dropped;
+
+    std::vector<otai_object_id_t> ids;
+
+    for (int i = 0; i < 40; ++i)
+    {
+        ids.push_back(dispatcher_test_linecard(dispatcher_test_state_a));
+    }
+
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        for (size_t n = 0; n <= i % 3; ++n)
+        {
+            dispatcher_test_alarm_of(ids[i], n);
+        }
+    }
+
+    otai_metadata_dispatcher_stats_t total = dispatcher_test_wait_idle();
+
+    EXPECT_EQ(40u * 4, total.capacity);
+    EXPECT_EQ(dropped, total.dropped);
+
+    for (size_t i = 0; i < ids.size(); ++i)
+    {
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_get_stats(ids[i], &stats));
+        EXPECT_EQ(i % 3 + 1, stats.enqueued) << i;
+        EXPECT_EQ(i % 3 + 1, stats.dispatched) << i;
+        EXPECT_EQ(4u, stats.capacity);
+    }
+
+    /* ring is released on remove */
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_remove(ids[0]));
+
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_dispatcher_get_stats(ids[0], &stats));
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_dispatcher_remove(ids[0]));
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_get_stats(OTAI_NULL_OBJECT_ID, &stats));
+    EXPECT_EQ(39u * 4, stats.capacity);
+
+    /* late notification of removed linecard is dropped */
+
+    dispatcher_test_alarm_of(ids[0], 0);
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_get_stats(OTAI_NULL_OBJECT_ID, &stats));
+    EXPECT_EQ(dropped + 1, stats.dropped);
+
+    dispatcher_test_objects.erase(ids[0]);
+
+    dispatcher_test_cleanup();
+}
+
+TEST(OtaiDispatcherTest, coalesce_frees_slots)
+{
+    dispatcher_test_start(2, 1, OTAI_METADATA_DISPATCHER_POLICY_COALESCE);
+
+    otai_object_id_t id = dispatcher_test_linecard(dispatcher_test_state_a);
+
+    otai_metadata_dispatcher_stats_t stats;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_get_stats(id, &stats));
+
+    size_t sent = 0;
+
+    /* more distinct keys than coalesce slots over all rounds */
+
+    for (int round = 0; round < 4; ++round)
+    {
+        dispatcher_test_set_gate(false);
+
+        for (int key = 0; key < 100; ++key, ++sent)
+        {
+            dispatcher_test_alarm_of(id, (otai_object_id_t)(round * 100 + key));
+        }
+
+        /* newer alarm of pending key replaces older one */
+
+        dispatcher_test_alarm_of(id, (otai_object_id_t)(round * 100 + 99));
+
+        dispatcher_test_set_gate(true);
+
+        dispatcher_test_wait_idle();
+
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_get_stats(id, &stats));
+
+        EXPECT_EQ(0u, stats.dropped) << round;
+        EXPECT_EQ(sent, stats.dispatched) << round;
+        EXPECT_EQ((uint64_t)round + 1, stats.coalesced) << round;
+    }
+
+    std::vector<dispatcher_test_call_t> calls = dispatcher_test_take_calls();
+
+    EXPECT_EQ(sent, calls.size());
+
+    dispatcher_test_cleanup();
+}
+
+TEST(OtaiDispatcherTest, aps_on_linecard_ring)
+{
+    dispatcher_test_start(16, 2, OTAI_METADATA_DISPATCHER_POLICY_BLOCK);
+
+    otai_object_id_t linecard = dispatcher_test_linecard(dispatcher_test_state_a);
+
+    otai_attribute_t attr;
+
+    attr.id = OTAI_APS_ATTR_SWITCH_INFO_NOTIFY;
+    attr.value.ptr = (otai_pointer_t)dispatcher_test_switch_info;
+
+    otai_object_id_t aps = OTAI_NULL_OBJECT_ID;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_create_aps(dispatcher_test_create_aps, &aps, linecard, 1, &attr));
+
+    otai_olp_switch_t *info = (otai_olp_switch_t*)calloc(1, sizeof(otai_olp_switch_t));
+
+    info->num = 7;
+
+    /* without linecard APS has own ring */
+
+    dispatcher_test_objects[aps].switchinfo(aps, *info);
+
+    dispatcher_test_aps_linecard = linecard;
+
+    dispatcher_test_objects[aps].switchinfo(aps, *info);
+
+    free(info);
+
+    dispatcher_test_wait_idle();
+
+    otai_metadata_dispatcher_stats_t stats;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_get_stats(linecard, &stats));
+    EXPECT_EQ(1u, stats.enqueued);
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_get_stats(aps, &stats));
+    EXPECT_EQ(1u, stats.enqueued);
+
+    std::vector<dispatcher_test_call_t> calls = dispatcher_test_take_calls();
+
+    ASSERT_EQ(2u, calls.size());
+
+    for (auto& call: calls)
+    {
+        EXPECT_EQ(4, call.handler);
+        EXPECT_EQ(aps, call.id);
+        EXPECT_EQ(7u, call.resource);
+    }
+
+    dispatcher_test_cleanup();
+}
+
+TEST(OtaiDispatcherTest, notify_during_create)
+{
+    dispatcher_test_start(16, 1, OTAI_METADATA_DISPATCHER_POLICY_DROP_OLDEST);
+
+    dispatcher_test_notify_on_create = true;
+
+    otai_object_id_t id = dispatcher_test_linecard(dispatcher_test_state_b);
+
+    dispatcher_test_wait_idle();
+
+    std::vector<dispatcher_test_call_t> calls = dispatcher_test_take_calls();
+
+    ASSERT_EQ(1u, calls.size());
+    EXPECT_EQ(2, calls[0].handler);
+    EXPECT_EQ(id, calls[0].id);
+
+    dispatcher_test_cleanup();
+}
+
+TEST(OtaiDispatcherTest, stop_delivers_queued)
+{
+    dispatcher_test_start(64, 1, OTAI_METADATA_DISPATCHER_POLICY_BLOCK);
+
+    otai_object_id_t id = dispatcher_test_linecard(dispatcher_test_state_a);
+
+    dispatcher_test_set_gate(false);
+
+    for (int i = 0; i < 30; ++i)
+    {
+        dispatcher_test_alarm_of(id, i);
+    }
+
+    dispatcher_test_set_gate(true);
+
+    otai_metadata_dispatcher_stop();
+
+    std::vector<dispatcher_test_call_t> calls = dispatcher_test_take_calls();
+
+    ASSERT_EQ(30u, calls.size());
+
+    /* same linecard is delivered in order */
+
+    for (size_t i = 0; i < calls.size(); ++i)
+    {
+        EXPECT_EQ(i, calls[i].resource);
+    }
+
+    dispatcher_test_cleanup();
+}
+
+TEST(OtaiDispatcherTest, aps_switch_info_ref)
+{
+    const uint32_t count = 8;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pool_init(&dispatcher_test_pool, sizeof(otai_olp_switch_t), count));
+
+    dispatcher_test_start(2, 1, OTAI_METADATA_DISPATCHER_POLICY_DROP_OLDEST);
+
+    otai_attribute_t attr;
+
+    attr.id = OTAI_APS_ATTR_SWITCH_INFO_REF_NOTIFY;
+    attr.value.ptr = (otai_pointer_t)dispatcher_test_switch_info_ref;
+
+    otai_object_id_t aps = OTAI_NULL_OBJECT_ID;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_dispatcher_create_aps(dispatcher_test_create_aps, &aps, OTAI_NULL_OBJECT_ID, 1, &attr));
+    ASSERT_NE(nullptr, dispatcher_test_objects[aps].switchinforef);
+    EXPECT_EQ(nullptr, dispatcher_test_objects[aps].switchinfo);
+
+    std::vector<otai_object_id_t> buffers;
+
+    dispatcher_test_set_gate(false);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        otai_olp_switch_t *info = (otai_olp_switch_t*)otai_metadata_pool_acquire(&dispatcher_test_pool);
+
+        ASSERT_NE(nullptr, info);
+
+        info->num = (otai_uint8_t)i;
+
+        buffers.push_back((otai_object_id_t)(uintptr_t)info);
+
+        dispatcher_test_objects[aps].switchinforef(aps, info);
+    }
+
+    dispatcher_test_set_gate(true);
+
+    otai_metadata_dispatcher_stats_t stats = dispatcher_test_wait_idle(aps);
+
+    std::vector<dispatcher_test_call_t> calls = dispatcher_test_take_calls();
+
+    /* dropped notifications are released by dispatcher */
+
+    EXPECT_EQ(count, calls.size() + stats.dropped);
+    EXPECT_LT(0u, stats.dropped);
+    EXPECT_EQ(count, otai_metadata_pool_get_available(&dispatcher_test_pool));
+
+    for (auto& call: calls)
+    {
+        EXPECT_EQ(5, call.handler);
+        EXPECT_EQ(aps, call.id);
+        EXPECT_NE(buffers.end(), std::find(buffers.begin(), buffers.end(), call.resource));
+    }
+
+    /* latest report is never dropped */
+
+    ASSERT_FALSE(calls.empty());
+    EXPECT_EQ(buffers.back(), calls.back().resource);
+
+    dispatcher_test_cleanup();
+
+    otai_metadata_pool_destroy(&dispatcher_test_pool);
+}
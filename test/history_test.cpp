@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+extern "C" {
+#include "otaimetadata.h"
+#include "otaimetadatahistory.h"
+}
+
+#define HISTORY_TEST_OBJECT(idx) ((otai_object_id_t)(0x1000000000000ULL + (idx)))
+
+static const otai_stat_metadata_t* history_test_find_stat(
+        _In_ bool counter)
+{
+    for (size_t i = 0; i < otai_metadata_stat_sorted_by_id_name_count; ++i)
+    {
+        const otai_stat_metadata_t *md = otai_metadata_stat_sorted_by_id_name[i];
+
+        /* gauge values of test are doubles */
+
+        if (md->statvalueiscounter == counter && (counter || md->statvaluetype == OTAI_STAT_VALUE_TYPE_DOUBLE))
+        {
+            return md;
+        }
+    }
+
+    return NULL;
+}
+
+static otai_status_t history_test_init(
+        _Out_ otai_metadata_history_t *history,
+        _In_ const otai_stat_metadata_t *md,
+        _In_ uint32_t capacity,
+        _In_ uint32_t blocksize,
+        _In_ uint32_t blockcount)
+{
+    otai_metadata_history_config_t config;
+
+    memset(&config, 0, sizeof(config));
+
+    config.objecttype = md->objecttype;
+    config.statcount = 1;
+    config.statids = &md->statid;
+    config.capacity = capacity;
+    config.blocksize = blocksize;
+    config.blockcount = blockcount;
+
+    return otai_metadata_history_init(history, &config);
+}
+
+static otai_status_t history_test_update(
+        _Inout_ otai_metadata_history_t *history,
+        _In_ otai_object_id_t object_id,
+        _In_ uint64_t time,
+        _In_ double value)
+{
+    otai_stat_value_t gauge;
+
+    gauge.d64 = value;
+
+    return otai_metadata_history_update(history, object_id, time, &gauge);
+}
+
+TEST(OtaiHistoryTest, invalid_config)
+{
+    const otai_stat_metadata_t *gauge = history_test_find_stat(false);
+
+    ASSERT_NE(gauge, nullptr);
+
+    otai_metadata_history_t history;
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, history_test_init(&history, gauge, 0, 64, 4));
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, history_test_init(&history, gauge, 4, 64, 0));
+
+    /* block must fit header and one sample */
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, history_test_init(&history, gauge, 4, 16, 4));
+
+    const otai_stat_metadata_t *counter = history_test_find_stat(true);
+
+    if (counter != NULL)
+    {
+        EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, history_test_init(&history, counter, 4, 64, 4));
+    }
+}
+
+TEST(OtaiHistoryTest, round_trip)
+{
+    const otai_stat_metadata_t *gauge = history_test_find_stat(false);
+
+    ASSERT_NE(gauge, nullptr);
+
+    otai_metadata_history_t history;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, history_test_init(&history, gauge, 2, 256, 16));
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_history_add_object(&history, HISTORY_TEST_OBJECT(0)));
+
+    /* steady interval with jitter and value which changes from time to time */
+
+    std::vector<uint64_t> times;
+    std::vector<double> values;
+
+    uint64_t time = 1000000;
+
+    for (int i = 0; i < 300; ++i)
+    {
+        time += 1000 + (uint64_t)(i % 7 == 0 ? 3 : 0) + (uint64_t)(i % 50 == 0 ? 5000 : 0);
+
+        double value = (double)(-40 + (i / 10));
+
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, history_test_update(&history, HISTORY_TEST_OBJECT(0), time, value));
+
+        times.push_back(time);
+        values.push_back(value);
+    }
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, history_test_update(&history, HISTORY_TEST_OBJECT(0), time - 1, 0));
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, history_test_update(&history, HISTORY_TEST_OBJECT(1), time, 0));
+
+    std::vector<uint64_t> outtimes(300);
+    std::vector<double> outvalues(300);
+
+    uint32_t count = 300;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_history_query(&history, HISTORY_TEST_OBJECT(0), gauge->statid,
+                0, UINT64_MAX, &count, outtimes.data(), outvalues.data()));
+    ASSERT_EQ(300u, count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        EXPECT_EQ(times[i], outtimes[i]);
+        EXPECT_EQ(values[i], outvalues[i]);
+    }
+
+    /* range query returns inclusive range */
+
+    count = 300;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_history_query(&history, HISTORY_TEST_OBJECT(0), gauge->statid,
+                times[100], times[149], &count, outtimes.data(), outvalues.data()));
+    ASSERT_EQ(50u, count);
+    EXPECT_EQ(times[100], outtimes[0]);
+    EXPECT_EQ(values[149], outvalues[49]);
+
+    count = 10;
+
+    EXPECT_EQ(OTAI_STATUS_BUFFER_OVERFLOW, otai_metadata_history_query(&history, HISTORY_TEST_OBJECT(0), gauge->statid,
+                0, UINT64_MAX, &count, outtimes.data(), outvalues.data()));
+    EXPECT_EQ(times[9], outtimes[9]);
+
+    count = 300;
+
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_history_query(&history, HISTORY_TEST_OBJECT(0), gauge->statid + 1000,
+                0, UINT64_MAX, &count, outtimes.data(), outvalues.data()));
+
+    otai_metadata_history_destroy(&history);
+}
+
+TEST(OtaiHistoryTest, oldest_block_dropped)
+{
+    const otai_stat_metadata_t *gauge = history_test_find_stat(false);
+
+    ASSERT_NE(gauge, nullptr);
+
+    otai_metadata_history_t history;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, history_test_init(&history, gauge, 1, 64, 2));
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_history_add_object(&history, HISTORY_TEST_OBJECT(0)));
+
+    uint64_t time = 0;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        time += 1000;
+
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, history_test_update(&history, HISTORY_TEST_OBJECT(0), time, (double)(i & 1)));
+    }
+
+    std::vector<uint64_t> outtimes(1000);
+    std::vector<double> outvalues(1000);
+
+    uint32_t count = 1000;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_history_query(&history, HISTORY_TEST_OBJECT(0), gauge->statid,
+                0, UINT64_MAX, &count, outtimes.data(), outvalues.data()));
+
+    /* only newest samples, which fit two blocks, are kept */
+
+    ASSERT_GT(count, 0u);
+    ASSERT_LT(count, 1000u);
+    EXPECT_EQ(time, outtimes[count - 1]);
+    EXPECT_EQ(time - (count - 1) * 1000, outtimes[0]);
+
+    otai_metadata_history_destroy(&history);
+}
+
+TEST(OtaiHistoryTest, add_and_remove)
+{
+    const otai_stat_metadata_t *gauge = history_test_find_stat(false);
+
+    ASSERT_NE(gauge, nullptr);
+
+    otai_metadata_history_t history;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, history_test_init(&history, gauge, 32, 64, 2));
+
+    uint32_t idx = 0;
+
+    for (; idx < 32; idx++)
+    {
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_history_add_object(&history, HISTORY_TEST_OBJECT(idx)));
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, history_test_update(&history, HISTORY_TEST_OBJECT(idx), 1000, (double)idx));
+    }
+
+    EXPECT_EQ(OTAI_STATUS_ITEM_ALREADY_EXISTS, otai_metadata_history_add_object(&history, HISTORY_TEST_OBJECT(0)));
+    EXPECT_EQ(OTAI_STATUS_TABLE_FULL, otai_metadata_history_add_object(&history, HISTORY_TEST_OBJECT(32)));
+
+    for (idx = 0; idx < 32; idx += 2)
+    {
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_history_remove_object(&history, HISTORY_TEST_OBJECT(idx)));
+    }
+
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_history_remove_object(&history, HISTORY_TEST_OBJECT(0)));
+
+    /* moved objects keep their series */
+
+    for (idx = 1; idx < 32; idx += 2)
+    {
+        uint64_t time = 0;
+        double value = -1;
+        uint32_t count = 1;
+
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_history_query(&history, HISTORY_TEST_OBJECT(idx), gauge->statid,
+                    0, UINT64_MAX, &count, &time, &value));
+        ASSERT_EQ(1u, count);
+        EXPECT_EQ(1000u, time);
+        EXPECT_EQ((double)idx, value);
+    }
+
+    /* object added again starts with empty series */
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_history_add_object(&history, HISTORY_TEST_OBJECT(0)));
+
+    uint64_t time = 0;
+    double value = 0;
+    uint32_t count = 1;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_history_query(&history, HISTORY_TEST_OBJECT(0), gauge->statid,
+                0, UINT64_MAX, &count, &time, &value));
+    EXPECT_EQ(0u, count);
+
+    otai_metadata_history_destroy(&history);
+}
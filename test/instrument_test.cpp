@@ -0,0 +1,258 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "otaimetadata.h"
+#include "otaimetadatainstrument.h"
+}
+
+#define INSTRUMENT_TEST_THREADS 4
+#define INSTRUMENT_TEST_CALLS 1000
+
+static otai_status_t instrument_test_get_port_attribute(
+        _In_ otai_object_id_t port_id,
+        _In_ uint32_t attr_count,
+        _Inout_ otai_attribute_t *attr_list)
+{
+    (void)attr_count;
+    (void)attr_list;
+
+    return port_id == 0 ? OTAI_STATUS_INVALID_PARAMETER : OTAI_STATUS_SUCCESS;
+}
+
+static otai_port_api_t gInstrumentPortApi;
+static otai_port_api_t gInstrumentOtherPortApi;
+static otai_port_api_t *gInstrumentAdapterPortApi = &gInstrumentPortApi;
+
+static otai_status_t instrument_test_api_query(
+        _In_ otai_api_t api,
+        _Out_ void **api_method_table)
+{
+    if (api != OTAI_API_PORT)
+    {
+        *api_method_table = NULL;
+
+        return OTAI_STATUS_NOT_SUPPORTED;
+    }
+
+    *api_method_table = gInstrumentAdapterPortApi;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+/*
+ * Instrumentation is global, so it is initialized once for all tests,
+ * each test clears it.
+ */
+static void instrument_test_init(void)
+{
+    static bool initialized = false;
+
+    if (!initialized)
+    {
+        gInstrumentPortApi.get_port_attribute = instrument_test_get_port_attribute;
+        gInstrumentOtherPortApi.get_port_attribute = instrument_test_get_port_attribute;
+
+        otai_metadata_instrument_config_t config = { instrument_test_api_query, 0 };
+
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_instrument_init(&config));
+
+        initialized = true;
+    }
+
+    otai_metadata_instrument_clear();
+}
+
+static std::vector<otai_metadata_instrument_entry_t> instrument_test_snapshot(void)
+{
+    uint32_t count = 0;
+
+    otai_status_t status = otai_metadata_instrument_snapshot(&count, NULL);
+
+    std::vector<otai_metadata_instrument_entry_t> entries(count);
+
+    if (status == OTAI_STATUS_BUFFER_OVERFLOW)
+    {
+        EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_instrument_snapshot(&count, entries.data()));
+    }
+
+    entries.resize(count);
+
+    return entries;
+}
+
+TEST(OtaiInstrumentTest, invalid_config)
+{
+    otai_metadata_instrument_config_t config = { instrument_test_api_query, 3 };
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_instrument_init(NULL));
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_instrument_init(&config));
+
+    instrument_test_init();
+
+    otai_metadata_instrument_config_t valid = { instrument_test_api_query, 0 };
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_instrument_init(&valid));
+}
+
+TEST(OtaiInstrumentTest, record_and_snapshot)
+{
+    instrument_test_init();
+
+    uint64_t now = otai_metadata_instrument_now();
+
+    otai_metadata_instrument_record(OTAI_API_PORT, OTAI_METADATA_INSTRUMENT_OP_GET, OTAI_OBJECT_TYPE_PORT, 2, now - 2000000, OTAI_STATUS_SUCCESS);
+    otai_metadata_instrument_record(OTAI_API_PORT, OTAI_METADATA_INSTRUMENT_OP_GET, OTAI_OBJECT_TYPE_PORT, 2, now - 2000000, OTAI_STATUS_FAILURE);
+    otai_metadata_instrument_record(OTAI_API_PORT, OTAI_METADATA_INSTRUMENT_OP_GET, OTAI_OBJECT_TYPE_PORT, 1, now, OTAI_STATUS_SUCCESS);
+    otai_metadata_instrument_record(OTAI_API_LINECARD, OTAI_METADATA_INSTRUMENT_OP_SET, OTAI_OBJECT_TYPE_LINECARD, 1, now, OTAI_STATUS_SUCCESS);
+
+    std::vector<otai_metadata_instrument_entry_t> entries = instrument_test_snapshot();
+
+    ASSERT_EQ(3u, entries.size());
+
+    /* sorted by api, operation, object type and id */
+
+    EXPECT_EQ(OTAI_API_LINECARD, entries[0].api);
+    EXPECT_EQ(1u, entries[1].id);
+    EXPECT_EQ(2u, entries[2].id);
+
+    EXPECT_EQ(2u, entries[2].calls);
+    EXPECT_EQ(1u, entries[2].errors);
+    EXPECT_GE(entries[2].max, 2000000u);
+
+    /* percentile is within bucket width of latency */
+
+    uint64_t p50 = otai_metadata_instrument_percentile(&entries[2], 50);
+
+    EXPECT_GE(p50, 2000000u);
+    EXPECT_LE(p50, entries[2].max);
+
+    uint32_t count = 1;
+
+    EXPECT_EQ(OTAI_STATUS_BUFFER_OVERFLOW, otai_metadata_instrument_snapshot(&count, entries.data()));
+    EXPECT_EQ(3u, count);
+
+    otai_metadata_instrument_clear();
+
+    EXPECT_EQ(0u, instrument_test_snapshot().size());
+    EXPECT_EQ(0u, otai_metadata_instrument_get_dropped());
+}
+
+TEST(OtaiInstrumentTest, threads_merge)
+{
+    instrument_test_init();
+
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < INSTRUMENT_TEST_THREADS; ++t)
+    {
+        threads.push_back(std::thread([]() {
+                    for (int i = 0; i < INSTRUMENT_TEST_CALLS; ++i)
+                    {
+                        otai_metadata_instrument_record(OTAI_API_PORT, OTAI_METADATA_INSTRUMENT_OP_GET_STATS,
+                                OTAI_OBJECT_TYPE_PORT, OTAI_METADATA_INSTRUMENT_ID_ANY,
+                                otai_metadata_instrument_now(), OTAI_STATUS_SUCCESS);
+                    }
+                    }));
+    }
+
+    for (auto &thread: threads)
+    {
+        thread.join();
+    }
+
+    std::vector<otai_metadata_instrument_entry_t> entries = instrument_test_snapshot();
+
+    ASSERT_EQ(1u, entries.size());
+    EXPECT_EQ((uint64_t)INSTRUMENT_TEST_THREADS * INSTRUMENT_TEST_CALLS, entries[0].calls);
+    EXPECT_EQ(OTAI_METADATA_INSTRUMENT_ID_ANY, entries[0].id);
+}
+
+TEST(OtaiInstrumentTest, api_query)
+{
+    instrument_test_init();
+
+    otai_port_api_t *port_api = NULL;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_instrument_api_query(OTAI_API_PORT, (void**)&port_api));
+    ASSERT_NE(port_api, nullptr);
+    EXPECT_NE(&gInstrumentPortApi, port_api);
+    EXPECT_EQ(nullptr, port_api->create_port);
+
+    otai_attribute_t attr;
+
+    attr.id = 3;
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, port_api->get_port_attribute(1, 1, &attr));
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, port_api->get_port_attribute(0, 1, &attr));
+
+    /* same adapter table gives same table */
+
+    otai_port_api_t *again = NULL;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_instrument_api_query(OTAI_API_PORT, (void**)&again));
+    EXPECT_EQ(port_api, again);
+
+    /* new adapter table gives new table, old one still works */
+
+    gInstrumentAdapterPortApi = &gInstrumentOtherPortApi;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_instrument_api_query(OTAI_API_PORT, (void**)&again));
+    EXPECT_NE(port_api, again);
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, port_api->get_port_attribute(1, 1, &attr));
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, again->get_port_attribute(1, 1, &attr));
+
+    gInstrumentAdapterPortApi = &gInstrumentPortApi;
+
+    std::vector<otai_metadata_instrument_entry_t> entries = instrument_test_snapshot();
+
+    ASSERT_EQ(1u, entries.size());
+    EXPECT_EQ(OTAI_API_PORT, entries[0].api);
+    EXPECT_EQ(OTAI_METADATA_INSTRUMENT_OP_GET, entries[0].op);
+    EXPECT_EQ(OTAI_OBJECT_TYPE_PORT, entries[0].objecttype);
+    EXPECT_EQ(3u, entries[0].id);
+    EXPECT_EQ(4u, entries[0].calls);
+    EXPECT_EQ(1u, entries[0].errors);
+
+    void *table = NULL;
+
+    EXPECT_EQ(OTAI_STATUS_NOT_SUPPORTED, otai_metadata_instrument_api_query(OTAI_API_LINECARD, &table));
+}
+
+TEST(OtaiInstrumentTest, adapter_dump)
+{
+    instrument_test_init();
+
+    otai_metadata_instrument_record(OTAI_API_PORT, OTAI_METADATA_INSTRUMENT_OP_GET, OTAI_OBJECT_TYPE_PORT,
+            OTAI_METADATA_INSTRUMENT_ID_ANY, otai_metadata_instrument_now(), OTAI_STATUS_SUCCESS);
+
+    char name[] = "/tmp/otai_instrument_test_XXXXXX";
+
+    int fd = mkstemp(name);
+
+    ASSERT_GE(fd, 0);
+
+    close(fd);
+
+    /* adapter dump includes API call latencies */
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_dbg_generate_dump(name));
+
+    std::ifstream file(name);
+    std::stringstream content;
+
+    content << file.rdbuf();
+
+    unlink(name);
+
+    EXPECT_NE(std::string::npos, content.str().find("virtual adapter"));
+    EXPECT_NE(std::string::npos, content.str().find("OTAI API calls"));
+    EXPECT_NE(std::string::npos, content.str().find("get"));
+}
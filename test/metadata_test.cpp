@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <string>
+
+extern "C" {
+#include "otaimetadata.h"
+}
+
+TEST(OtaiMetadataTest, attr_names_resolve)
+{
+    ASSERT_GT(otai_metadata_attr_sorted_by_id_name_count, 0u);
+
+    for (size_t i = 0; i < otai_metadata_attr_sorted_by_id_name_count; ++i)
+    {
+        const otai_attr_metadata_t *md = otai_metadata_attr_sorted_by_id_name[i];
+
+        ASSERT_NE(md, nullptr);
+
+        EXPECT_EQ(md, otai_metadata_get_attr_metadata_by_attr_id_name(md->attridname)) << md->attridname;
+
+        /* length variant must not read past given length */
+
+        std::string padded = std::string(md->attridname) + "_X";
+
+        EXPECT_EQ(md, otai_metadata_get_attr_metadata_by_attr_id_name_length(padded.c_str(), strlen(md->attridname))) << md->attridname;
+        EXPECT_EQ(nullptr, otai_metadata_get_attr_metadata_by_attr_id_name(padded.c_str())) << padded;
+
+        EXPECT_EQ(md, otai_metadata_get_attr_metadata_by_attr_id_kebab_name(md->objecttype, md->attridkebabname)) << md->attridkebabname;
+
+        EXPECT_EQ(md, otai_metadata_get_attr_metadata(md->objecttype, md->attrid)) << md->attridname;
+    }
+
+    EXPECT_EQ(nullptr, otai_metadata_get_attr_metadata_by_attr_id_name("OTAI_NOT_AN_ATTR"));
+    EXPECT_EQ(nullptr, otai_metadata_get_attr_metadata_by_attr_id_name(""));
+    EXPECT_EQ(nullptr, otai_metadata_get_attr_metadata_by_attr_id_name(NULL));
+    EXPECT_EQ(nullptr, otai_metadata_get_attr_metadata_by_attr_id_kebab_name(OTAI_OBJECT_TYPE_NULL, "not-an-attr"));
+}
+
+TEST(OtaiMetadataTest, stat_names_resolve)
+{
+    for (size_t i = 0; i < otai_metadata_stat_sorted_by_id_name_count; ++i)
+    {
+        const otai_stat_metadata_t *md = otai_metadata_stat_sorted_by_id_name[i];
+
+        ASSERT_NE(md, nullptr);
+
+        EXPECT_EQ(md, otai_metadata_get_stat_metadata_by_stat_id_name(md->statidname)) << md->statidname;
+        EXPECT_EQ(md, otai_metadata_get_stat_metadata_by_stat_id_kebab_name(md->objecttype, md->statidkebabname)) << md->statidkebabname;
+        EXPECT_EQ(md, otai_metadata_get_stat_metadata_by_stat_id_camel_name(md->objecttype, md->statidcamelname)) << md->statidcamelname;
+        EXPECT_EQ(md, otai_metadata_get_stat_metadata(md->objecttype, md->statid)) << md->statidname;
+
+        /* kebab and camel names are unique only within object type */
+
+        EXPECT_EQ(nullptr, otai_metadata_get_stat_metadata_by_stat_id_kebab_name(OTAI_OBJECT_TYPE_NULL, md->statidkebabname));
+    }
+
+    EXPECT_EQ(nullptr, otai_metadata_get_stat_metadata_by_stat_id_name("OTAI_NOT_A_STAT"));
+    EXPECT_EQ(nullptr, otai_metadata_get_stat_metadata_by_stat_id_camel_name(OTAI_OBJECT_TYPE_NULL, "notAStat"));
+}
+
+TEST(OtaiMetadataTest, enum_values_resolve)
+{
+    ASSERT_GT(otai_metadata_all_enums_count, 0u);
+
+    for (size_t i = 0; i < otai_metadata_all_enums_count; ++i)
+    {
+        const otai_enum_metadata_t *emd = otai_metadata_all_enums[i];
+
+        ASSERT_NE(emd, nullptr);
+
+        for (size_t j = 0; j < emd->valuescount; ++j)
+        {
+            int value = emd->values[j];
+
+            size_t index = emd->valuescount;
+
+            /* aliases share value, so resolved index must only hold the same value */
+
+            ASSERT_TRUE(otai_metadata_get_enum_value_index(emd, value, &index)) << emd->name << " " << value;
+            ASSERT_LT(index, emd->valuescount);
+            EXPECT_EQ(value, emd->values[index]) << emd->name;
+
+            const char *name = otai_metadata_get_enum_value_name(emd, value);
+
+            ASSERT_NE(name, nullptr) << emd->name << " " << value;
+            EXPECT_STREQ(emd->valuesnames[index], name);
+
+            const char *own = emd->valuesnames[j];
+
+            ASSERT_TRUE(otai_metadata_get_enum_value_index_by_name(emd, own, strlen(own), &index)) << own;
+            EXPECT_EQ(j, index) << own;
+
+            std::string padded = std::string(own) + "_X";
+
+            ASSERT_TRUE(otai_metadata_get_enum_value_index_by_name(emd, padded.c_str(), strlen(own), &index)) << own;
+            EXPECT_EQ(j, index) << own;
+
+            EXPECT_FALSE(otai_metadata_get_enum_value_index_by_name(emd, padded.c_str(), padded.size(), &index)) << padded;
+        }
+
+        size_t index = 0;
+
+        EXPECT_FALSE(otai_metadata_get_enum_value_index_by_name(emd, "", 0, &index)) << emd->name;
+    }
+}
@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <map>
+
+extern "C" {
+#include "otaimetadata.h"
+#include "otaimetadataobjectmap.h"
+}
+
+TEST(OtaiObjectMapTest, insert_find_remove)
+{
+    otai_metadata_objectmap_t map;
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_objectmap_init(&map, 0));
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_objectmap_init(&map, 2));
+
+    uint32_t index = 0;
+
+    EXPECT_FALSE(otai_metadata_objectmap_find(&map, 0x10, &index));
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_objectmap_insert(&map, 0x10, 0));
+    EXPECT_EQ(OTAI_STATUS_ITEM_ALREADY_EXISTS, otai_metadata_objectmap_insert(&map, 0x10, 1));
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_objectmap_insert(&map, 0x20, 1));
+    EXPECT_EQ(OTAI_STATUS_TABLE_FULL, otai_metadata_objectmap_insert(&map, 0x30, 2));
+
+    ASSERT_TRUE(otai_metadata_objectmap_find(&map, 0x20, &index));
+    EXPECT_EQ(1u, index);
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_objectmap_set(&map, 0x20, 0));
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_objectmap_set(&map, 0x30, 0));
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_objectmap_remove(&map, 0x10));
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_objectmap_remove(&map, 0x10));
+
+    ASSERT_TRUE(otai_metadata_objectmap_find(&map, 0x20, &index));
+    EXPECT_EQ(0u, index);
+    EXPECT_FALSE(otai_metadata_objectmap_find(&map, 0x10, &index));
+
+    otai_metadata_objectmap_destroy(&map);
+
+    EXPECT_FALSE(otai_metadata_objectmap_find(&map, 0x20, &index));
+}
+
+TEST(OtaiObjectMapTest, matches_reference)
+{
+    otai_metadata_objectmap_t map;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_objectmap_init(&map, 512));
+
+    std::map<otai_object_id_t, uint32_t> reference;
+
+    uint64_t seed = 1;
+
+    /* random inserts and removes over small key range make long probe runs */
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+        otai_object_id_t object_id = 0x1000000000000ULL + ((seed >> 33) % 700);
+
+        uint32_t index = (uint32_t)i;
+
+        if (reference.count(object_id))
+        {
+            ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_objectmap_remove(&map, object_id));
+
+            reference.erase(object_id);
+        }
+        else if (reference.size() < 512)
+        {
+            ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_objectmap_insert(&map, object_id, index));
+
+            reference[object_id] = index;
+        }
+
+        ASSERT_EQ(reference.size(), map.count);
+    }
+
+    for (uint64_t key = 0; key < 700; ++key)
+    {
+        otai_object_id_t object_id = 0x1000000000000ULL + key;
+
+        uint32_t index = 0;
+
+        bool found = otai_metadata_objectmap_find(&map, object_id, &index);
+
+        ASSERT_EQ(reference.count(object_id) != 0, found);
+
+        if (found)
+        {
+            EXPECT_EQ(reference[object_id], index);
+        }
+    }
+
+    otai_metadata_objectmap_destroy(&map);
+}
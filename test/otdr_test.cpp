@@ -0,0 +1,320 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+extern "C" {
+#include "otaimetadata.h"
+#include "otaimetadataotdr.h"
+}
+
+/*
+ * Synthetic trace, level in dB at distance, sample units of 0.001 dB below
+ * OTDR_TEST_TOP. Events ramp over pulse length, reflections add spike of
+ * pulse length.
+ */
+
+#define OTDR_TEST_TOP 30.0
+#define OTDR_TEST_ATTENUATION 0.2
+#define OTDR_TEST_FLOOR 25.0
+
+typedef struct _otdr_test_event_t
+{
+    double distance;
+    double loss;
+    double spike;
+
+} otdr_test_event_t;
+
+static std::vector<uint8_t> otdr_test_trace(
+        _In_ const otai_metadata_otdr_t *analysis,
+        _In_ const std::vector<otdr_test_event_t> &events,
+        _In_ double length,
+        _In_ uint32_t noise)
+{
+    double resolution = analysis->config.samplingresolution;
+    double pulselength = analysis->pulse * resolution;
+
+    uint32_t count = (uint32_t)((length + 2000 + 5 * pulselength) / resolution);
+
+    std::vector<uint8_t> trace;
+
+    uint64_t seed = 1;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        double distance = i * resolution;
+        double level = -OTDR_TEST_ATTENUATION * (distance < length ? distance : length) / 1000;
+
+        for (size_t e = 0; e < events.size(); ++e)
+        {
+            double into = distance - events[e].distance;
+
+            if (into < 0)
+            {
+                continue;
+            }
+
+            level -= events[e].loss * (into < pulselength ? into / pulselength : 1);
+            level += into < pulselength ? events[e].spike : 0;
+        }
+
+        /* end drops to noise floor */
+
+        double into = distance - length;
+
+        if (into >= 0)
+        {
+            level -= OTDR_TEST_FLOOR * (into < pulselength ? into / pulselength : 1);
+        }
+
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+        int32_t jitter = noise == 0 ? 0 : (int32_t)((seed >> 33) % (2 * noise + 1)) - (int32_t)noise;
+
+        uint16_t sample = (uint16_t)((OTDR_TEST_TOP - level) * 1000 + 0.5 + jitter);
+
+        trace.push_back((uint8_t)(sample >> 8));
+        trace.push_back((uint8_t)sample);
+    }
+
+    return trace;
+}
+
+static otai_metadata_otdr_config_t otdr_test_config(
+        _In_ uint32_t pulsewidth,
+        _In_ double resolution)
+{
+    otai_metadata_otdr_config_t config;
+
+    memset(&config, 0, sizeof(config));
+
+    config.reflectionthreshold = -40;
+    config.splicelossthreshold = 0.1;
+    config.endoffiberthreshold = 5;
+    config.backscatterindex = -80;
+    config.refractiveindex = 1.4682;
+    config.pulsewidth = pulsewidth;
+    config.samplingresolution = resolution;
+    config.capacity = 16;
+
+    return config;
+}
+
+static otai_otdr_events_t otdr_test_analyze(
+        _Inout_ otai_metadata_otdr_t *analysis,
+        _In_ const std::vector<uint8_t> &trace,
+        _In_ uint32_t chunk)
+{
+    otai_metadata_otdr_reset(analysis);
+
+    for (size_t offset = 0; offset < trace.size(); offset += chunk)
+    {
+        size_t count = trace.size() - offset < chunk ? trace.size() - offset : chunk;
+
+        otai_metadata_otdr_process(analysis, (uint32_t)count, trace.data() + offset);
+    }
+
+    otai_metadata_otdr_finish(analysis);
+
+    otai_otdr_events_t events;
+
+    otai_metadata_otdr_get_events(analysis, &events);
+
+    return events;
+}
+
+static void otdr_test_offset(
+        _Inout_ std::vector<uint8_t> &trace,
+        _In_ size_t sample,
+        _In_ int32_t delta)
+{
+    uint16_t value = (uint16_t)(trace[2 * sample] << 8 | trace[2 * sample + 1]);
+
+    value = (uint16_t)(value + delta);
+
+    trace[2 * sample] = (uint8_t)(value >> 8);
+    trace[2 * sample + 1] = (uint8_t)value;
+}
+
+/*
+ * Events except fiber sections.
+ */
+static std::vector<otai_otdr_event_t> otdr_test_points(
+        _In_ const otai_otdr_events_t &events)
+{
+    std::vector<otai_otdr_event_t> points;
+
+    for (uint32_t i = 0; i < events.events.count; ++i)
+    {
+        if (events.events.list[i].type != OTAI_OTDR_EVENT_TYPE_FIBER_SECTION)
+        {
+            points.push_back(events.events.list[i]);
+        }
+    }
+
+    return points;
+}
+
+TEST(OtaiOtdrTest, invalid_config)
+{
+    otai_metadata_otdr_config_t config = otdr_test_config(100, 1);
+    otai_metadata_otdr_t analysis;
+
+    config.capacity = 0;
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_otdr_init(&analysis, &config));
+
+    config = otdr_test_config(100, 0);
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_otdr_init(&analysis, &config));
+
+    config = otdr_test_config(100, 1);
+    config.window = 3;
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_otdr_init(&analysis, &config));
+
+    otai_attribute_t attrs[2];
+
+    attrs[0].id = OTAI_OTDR_ATTR_PULSE_WIDTH;
+    attrs[0].value.u32 = 1000;
+    attrs[1].id = OTAI_OTDR_ATTR_SAMPLING_RESOLUTION;
+    attrs[1].value.d64 = 2.5;
+
+    config = otdr_test_config(100, 1);
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_otdr_config_from_attr_list(&config, 2, attrs));
+    EXPECT_EQ(1000u, config.pulsewidth);
+    EXPECT_EQ(2.5, config.samplingresolution);
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_otdr_config_from_attr_list(&config, 2, NULL));
+}
+
+TEST(OtaiOtdrTest, splice_connector_and_end)
+{
+    otai_metadata_otdr_config_t config = otdr_test_config(100, 1);
+    otai_metadata_otdr_t analysis;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_otdr_init(&analysis, &config));
+
+    std::vector<otdr_test_event_t> fiber = { { 4000, 0.5, 0 }, { 7000, 0.3, 15 } };
+
+    std::vector<uint8_t> trace = otdr_test_trace(&analysis, fiber, 10000, 10);
+
+    otai_otdr_events_t events = otdr_test_analyze(&analysis, trace, (uint32_t)trace.size());
+
+    std::vector<otai_otdr_event_t> points = otdr_test_points(events);
+
+    ASSERT_EQ(4u, points.size());
+
+    EXPECT_EQ(OTAI_OTDR_EVENT_TYPE_START, points[0].type);
+
+    EXPECT_EQ(OTAI_OTDR_EVENT_TYPE_NON_REFLECTION, points[1].type);
+    EXPECT_NEAR(4, points[1].length, 0.005);
+    EXPECT_NEAR(0.5, points[1].loss, 0.05);
+
+    EXPECT_EQ(OTAI_OTDR_EVENT_TYPE_REFLECTION, points[2].type);
+    EXPECT_NEAR(7, points[2].length, 0.005);
+    EXPECT_NEAR(0.3, points[2].loss, 0.05);
+    EXPECT_GT(points[2].reflection, config.reflectionthreshold);
+
+    EXPECT_EQ(OTAI_OTDR_EVENT_TYPE_END, points[3].type);
+    EXPECT_NEAR(10, points[3].length, 0.005);
+
+    EXPECT_NEAR(10, events.span_distance, 0.005);
+    EXPECT_NEAR(0.2 * 10 + 0.5 + 0.3 + points[3].loss, events.span_loss, 0.1);
+
+    /* sections between events have fiber attenuation */
+
+    for (uint32_t i = 0; i < events.events.count; ++i)
+    {
+        if (events.events.list[i].type == OTAI_OTDR_EVENT_TYPE_FIBER_SECTION)
+        {
+            EXPECT_NEAR(OTDR_TEST_ATTENUATION, events.events.list[i].loss / events.events.list[i].length, 0.02);
+        }
+    }
+
+    /* chunks split in middle of samples give same events */
+
+    otai_otdr_events_t chunked = otdr_test_analyze(&analysis, trace, 7);
+
+    ASSERT_EQ(events.events.count, chunked.events.count);
+
+    otai_metadata_otdr_destroy(&analysis);
+}
+
+TEST(OtaiOtdrTest, noise_is_not_event)
+{
+    otai_metadata_otdr_config_t config = otdr_test_config(100, 1);
+    otai_metadata_otdr_t analysis;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_otdr_init(&analysis, &config));
+
+    std::vector<otdr_test_event_t> fiber = { { 3060, 0.5, 0 } };
+
+    std::vector<uint8_t> trace = otdr_test_trace(&analysis, fiber, 8000, 10);
+
+    /* single sample spikes and dips */
+
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        otdr_test_offset(trace, 1500 + i * 700, i % 2 ? 400 : -4000);
+    }
+
+    /* dip without loss, which is classified as noise */
+
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        otdr_test_offset(trace, 3000 + i, 200);
+    }
+
+    otai_otdr_events_t events = otdr_test_analyze(&analysis, trace, 4096);
+
+    std::vector<otai_otdr_event_t> points = otdr_test_points(events);
+
+    /* splice is found before window fills after noise */
+
+    ASSERT_EQ(3u, points.size());
+    EXPECT_EQ(OTAI_OTDR_EVENT_TYPE_NON_REFLECTION, points[1].type);
+    EXPECT_NEAR(3.06, points[1].length, 0.005);
+    EXPECT_NEAR(0.5, points[1].loss, 0.05);
+    EXPECT_EQ(OTAI_OTDR_EVENT_TYPE_END, points[2].type);
+    EXPECT_NEAR(8, points[2].length, 0.005);
+
+    otai_metadata_otdr_destroy(&analysis);
+}
+
+TEST(OtaiOtdrTest, long_pulse_after_event)
+{
+    /* 10 us pulse covers 1 km, fit window after splice is 8 km */
+
+    otai_metadata_otdr_config_t config = otdr_test_config(10000, 10);
+    otai_metadata_otdr_t analysis;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_otdr_init(&analysis, &config));
+
+    std::vector<otdr_test_event_t> fiber = { { 15000, 1, 0 }, { 20000, 0.5, 3 } };
+
+    std::vector<uint8_t> trace = otdr_test_trace(&analysis, fiber, 40000, 5);
+
+    otai_otdr_events_t events = otdr_test_analyze(&analysis, trace, 1000);
+
+    std::vector<otai_otdr_event_t> points = otdr_test_points(events);
+
+    ASSERT_EQ(4u, points.size());
+
+    /* ramp of long pulse crosses threshold later */
+
+    EXPECT_NEAR(15, points[1].length, 0.1);
+    EXPECT_NEAR(1, points[1].loss, 0.1);
+
+    /* connector is found while fit window refills */
+
+    EXPECT_EQ(OTAI_OTDR_EVENT_TYPE_REFLECTION, points[2].type);
+    EXPECT_NEAR(20, points[2].length, 0.1);
+    EXPECT_NEAR(0.5, points[2].loss, 0.1);
+
+    EXPECT_EQ(OTAI_OTDR_EVENT_TYPE_END, points[3].type);
+    EXPECT_NEAR(40, points[3].length, 0.1);
+
+    otai_metadata_otdr_destroy(&analysis);
+}
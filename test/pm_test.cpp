@@ -0,0 +1,357 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+#include "otaimetadata.h"
+#include "otaimetadatapm.h"
+}
+
+#define PM_TEST_OBJECT(idx) ((otai_object_id_t)(0x1000000000000ULL + (idx)))
+
+static const otai_stat_metadata_t* pm_test_find_stat(
+        _In_ otai_object_type_t object_type,
+        _In_ bool counter,
+        _In_ otai_stat_value_type_t type)
+{
+    for (size_t i = 0; i < otai_metadata_stat_sorted_by_id_name_count; ++i)
+    {
+        const otai_stat_metadata_t *md = otai_metadata_stat_sorted_by_id_name[i];
+
+        if ((object_type == OTAI_OBJECT_TYPE_NULL || md->objecttype == object_type) &&
+                md->statvalueiscounter == counter && md->statvaluetype == type)
+        {
+            return md;
+        }
+    }
+
+    return NULL;
+}
+
+static otai_status_t pm_test_init(
+        _Out_ otai_metadata_pm_t *pm,
+        _In_ const otai_stat_metadata_t *md,
+        _In_ uint32_t capacity,
+        _In_ otai_stats_mode_t mode)
+{
+    otai_metadata_pm_config_t config;
+
+    memset(&config, 0, sizeof(config));
+
+    config.objecttype = md->objecttype;
+    config.statcount = 1;
+    config.statids = &md->statid;
+    config.capacity = capacity;
+    config.history[OTAI_METADATA_PM_INTERVAL_15_MIN] = 2;
+    config.history[OTAI_METADATA_PM_INTERVAL_24_HOUR] = 1;
+    config.mode = mode;
+
+    return otai_metadata_pm_init(pm, &config);
+}
+
+static otai_metadata_pm_value_t pm_test_get(
+        _In_ const otai_metadata_pm_t *pm,
+        _In_ size_t age,
+        _In_ otai_object_id_t object_id)
+{
+    otai_metadata_pm_value_t value;
+    uint64_t start_time = 0;
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_get_value(pm, OTAI_METADATA_PM_INTERVAL_15_MIN, age,
+                object_id, pm->statids[0], &start_time, &value));
+
+    return value;
+}
+
+static void pm_test_update_u64(
+        _Inout_ otai_metadata_pm_t *pm,
+        _In_ otai_object_id_t object_id,
+        _In_ uint64_t value)
+{
+    otai_stat_value_t counter;
+
+    counter.u64 = value;
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_update(pm, object_id, &counter));
+}
+
+TEST(OtaiPmTest, invalid_config)
+{
+    const otai_stat_metadata_t *md = pm_test_find_stat(OTAI_OBJECT_TYPE_NULL, true, OTAI_STAT_VALUE_TYPE_UINT64);
+
+    ASSERT_NE(md, nullptr);
+
+    otai_metadata_pm_t pm;
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, pm_test_init(&pm, md, 0, OTAI_STATS_MODE_READ));
+
+    otai_metadata_pm_config_t config;
+
+    memset(&config, 0, sizeof(config));
+
+    config.objecttype = md->objecttype;
+    config.capacity = 4;
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_pm_init(&pm, &config));
+
+    otai_stat_id_t bad = 0x7fffffff;
+
+    config.statcount = 1;
+    config.statids = &bad;
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_pm_init(&pm, &config));
+}
+
+TEST(OtaiPmTest, add_and_remove)
+{
+    const otai_stat_metadata_t *md = pm_test_find_stat(OTAI_OBJECT_TYPE_NULL, true, OTAI_STAT_VALUE_TYPE_UINT64);
+
+    ASSERT_NE(md, nullptr);
+
+    otai_metadata_pm_t pm;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, pm_test_init(&pm, md, 100, OTAI_STATS_MODE_READ));
+
+    uint32_t idx = 0;
+
+    for (; idx < 100; idx++)
+    {
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_add_object(&pm, PM_TEST_OBJECT(idx)));
+    }
+
+    EXPECT_EQ(OTAI_STATUS_ITEM_ALREADY_EXISTS, otai_metadata_pm_add_object(&pm, PM_TEST_OBJECT(7)));
+    EXPECT_EQ(OTAI_STATUS_TABLE_FULL, otai_metadata_pm_add_object(&pm, PM_TEST_OBJECT(100)));
+
+    /* each object gets delta equal to its number */
+
+    for (idx = 0; idx < 100; idx++)
+    {
+        pm_test_update_u64(&pm, PM_TEST_OBJECT(idx), 1000);
+        pm_test_update_u64(&pm, PM_TEST_OBJECT(idx), 1000 + idx);
+    }
+
+    /* last object takes place of removed ones and keeps its bins */
+
+    for (idx = 0; idx < 100; idx += 2)
+    {
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_remove_object(&pm, PM_TEST_OBJECT(idx)));
+    }
+
+    EXPECT_EQ(50u, pm.objectcount);
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_pm_remove_object(&pm, PM_TEST_OBJECT(0)));
+
+    otai_stat_value_t counter;
+
+    counter.u64 = 0;
+
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_pm_update(&pm, PM_TEST_OBJECT(2), &counter));
+
+    for (idx = 1; idx < 100; idx += 2)
+    {
+        otai_metadata_pm_value_t value = pm_test_get(&pm, 0, PM_TEST_OBJECT(idx));
+
+        EXPECT_EQ(2u, value.samples);
+        EXPECT_EQ(idx, value.delta.u64);
+    }
+
+    /* removed object can be added again and starts with empty bins */
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_add_object(&pm, PM_TEST_OBJECT(4)));
+
+    otai_metadata_pm_value_t value = pm_test_get(&pm, 0, PM_TEST_OBJECT(4));
+
+    EXPECT_EQ(0u, value.samples);
+    EXPECT_EQ(0u, value.delta.u64);
+
+    otai_metadata_pm_destroy(&pm);
+}
+
+TEST(OtaiPmTest, counter_bins)
+{
+    const otai_stat_metadata_t *md = pm_test_find_stat(OTAI_OBJECT_TYPE_NULL, true, OTAI_STAT_VALUE_TYPE_UINT64);
+
+    ASSERT_NE(md, nullptr);
+
+    otai_metadata_pm_t pm;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, pm_test_init(&pm, md, 4, OTAI_STATS_MODE_READ));
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_add_object(&pm, PM_TEST_OBJECT(0)));
+
+    /* first sample only sets last value */
+
+    pm_test_update_u64(&pm, PM_TEST_OBJECT(0), 100);
+    pm_test_update_u64(&pm, PM_TEST_OBJECT(0), 150);
+
+    EXPECT_EQ(50u, pm_test_get(&pm, 0, PM_TEST_OBJECT(0)).delta.u64);
+
+    otai_metadata_pm_end_bin(&pm, OTAI_METADATA_PM_INTERVAL_15_MIN, 900);
+
+    /* counter reset is counted from zero */
+
+    pm_test_update_u64(&pm, PM_TEST_OBJECT(0), 10);
+
+    otai_metadata_pm_value_t value = pm_test_get(&pm, 0, PM_TEST_OBJECT(0));
+
+    EXPECT_EQ(1u, value.samples);
+    EXPECT_EQ(10u, value.delta.u64);
+    EXPECT_EQ(50u, pm_test_get(&pm, 1, PM_TEST_OBJECT(0)).delta.u64);
+
+    uint64_t start_time = 0;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_get_value(&pm, OTAI_METADATA_PM_INTERVAL_15_MIN, 0,
+                PM_TEST_OBJECT(0), md->statid, &start_time, &value));
+    EXPECT_EQ(900u, start_time);
+
+    /* 24 hour bin was not ended */
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_get_value(&pm, OTAI_METADATA_PM_INTERVAL_24_HOUR, 0,
+                PM_TEST_OBJECT(0), md->statid, &start_time, &value));
+    EXPECT_EQ(60u, value.delta.u64);
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_pm_get_value(&pm, OTAI_METADATA_PM_INTERVAL_15_MIN, 3,
+                PM_TEST_OBJECT(0), md->statid, &start_time, &value));
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_pm_get_value(&pm, OTAI_METADATA_PM_INTERVAL_15_MIN, 0,
+                PM_TEST_OBJECT(1), md->statid, &start_time, &value));
+
+    /* oldest bin is reused */
+
+    otai_metadata_pm_end_bin(&pm, OTAI_METADATA_PM_INTERVAL_15_MIN, 1800);
+    otai_metadata_pm_end_bin(&pm, OTAI_METADATA_PM_INTERVAL_15_MIN, 2700);
+
+    value = pm_test_get(&pm, 0, PM_TEST_OBJECT(0));
+
+    EXPECT_EQ(0u, value.samples);
+    EXPECT_EQ(0u, value.delta.u64);
+    EXPECT_EQ(10u, pm_test_get(&pm, 2, PM_TEST_OBJECT(0)).delta.u64);
+
+    otai_metadata_pm_destroy(&pm);
+}
+
+TEST(OtaiPmTest, read_and_clear)
+{
+    const otai_stat_metadata_t *md = pm_test_find_stat(OTAI_OBJECT_TYPE_NULL, true, OTAI_STAT_VALUE_TYPE_UINT64);
+
+    ASSERT_NE(md, nullptr);
+
+    otai_metadata_pm_t pm;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, pm_test_init(&pm, md, 4, OTAI_STATS_MODE_READ_AND_CLEAR));
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_add_object(&pm, PM_TEST_OBJECT(0)));
+
+    pm_test_update_u64(&pm, PM_TEST_OBJECT(0), 100);
+    pm_test_update_u64(&pm, PM_TEST_OBJECT(0), 20);
+
+    EXPECT_EQ(120u, pm_test_get(&pm, 0, PM_TEST_OBJECT(0)).delta.u64);
+
+    otai_metadata_pm_destroy(&pm);
+}
+
+TEST(OtaiPmTest, u32_wrap)
+{
+    const otai_stat_metadata_t *md = pm_test_find_stat(OTAI_OBJECT_TYPE_NULL, true, OTAI_STAT_VALUE_TYPE_UINT32);
+
+    if (md == NULL)
+    {
+        /* no 32 bit counters in metadata */
+
+        return;
+    }
+
+    otai_metadata_pm_t pm;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, pm_test_init(&pm, md, 4, OTAI_STATS_MODE_READ));
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_add_object(&pm, PM_TEST_OBJECT(0)));
+
+    otai_stat_value_t counter;
+
+    counter.u32 = UINT32_MAX - 9;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_update(&pm, PM_TEST_OBJECT(0), &counter));
+
+    /* wrap counts 10 up to zero and 5 after it */
+
+    counter.u32 = 5;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_update(&pm, PM_TEST_OBJECT(0), &counter));
+
+    EXPECT_EQ(15u, pm_test_get(&pm, 0, PM_TEST_OBJECT(0)).delta.u64);
+
+    /* counter far from wrap going down was cleared */
+
+    counter.u32 = 1000;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_update(&pm, PM_TEST_OBJECT(0), &counter));
+
+    counter.u32 = 7;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_update(&pm, PM_TEST_OBJECT(0), &counter));
+
+    EXPECT_EQ(15u + 995u + 7u, pm_test_get(&pm, 0, PM_TEST_OBJECT(0)).delta.u64);
+
+    otai_metadata_pm_destroy(&pm);
+}
+
+TEST(OtaiPmTest, gauge)
+{
+    const otai_stat_metadata_t *counter = pm_test_find_stat(OTAI_OBJECT_TYPE_NULL, true, OTAI_STAT_VALUE_TYPE_UINT64);
+
+    ASSERT_NE(counter, nullptr);
+
+    const otai_stat_metadata_t *gauge = pm_test_find_stat(counter->objecttype, false, OTAI_STAT_VALUE_TYPE_DOUBLE);
+
+    if (gauge == NULL)
+    {
+        /* no double gauge next to counter in metadata */
+
+        return;
+    }
+
+    otai_stat_id_t statids[2] = { counter->statid, gauge->statid };
+
+    otai_metadata_pm_config_t config;
+
+    memset(&config, 0, sizeof(config));
+
+    config.objecttype = counter->objecttype;
+    config.statcount = 2;
+    config.statids = statids;
+    config.capacity = 2;
+    config.mode = OTAI_STATS_MODE_READ;
+
+    otai_metadata_pm_t pm;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_init(&pm, &config));
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_add_object(&pm, PM_TEST_OBJECT(0)));
+
+    static const double samples[] = { 2, -1, 5 };
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+        otai_stat_value_t values[2];
+
+        values[0].u64 = i;
+        values[1].d64 = samples[i];
+
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_update(&pm, PM_TEST_OBJECT(0), values));
+    }
+
+    otai_metadata_pm_value_t value;
+    uint64_t start_time;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_get_value(&pm, OTAI_METADATA_PM_INTERVAL_15_MIN, 0,
+                PM_TEST_OBJECT(0), gauge->statid, &start_time, &value));
+
+    EXPECT_FALSE(value.iscounter);
+    EXPECT_EQ(3u, value.samples);
+    EXPECT_DOUBLE_EQ(-1, value.min);
+    EXPECT_DOUBLE_EQ(5, value.max);
+    EXPECT_DOUBLE_EQ(2, value.avg);
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_pm_get_value(&pm, OTAI_METADATA_PM_INTERVAL_15_MIN, 0,
+                PM_TEST_OBJECT(0), counter->statid, &start_time, &value));
+
+    EXPECT_TRUE(value.iscounter);
+    EXPECT_EQ(2u, value.delta.u64);
+
+    otai_metadata_pm_destroy(&pm);
+}
@@ -0,0 +1,294 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+
+extern "C" {
+#include "otaimetadata.h"
+#include "otaimetadatarate.h"
+}
+
+#define RATE_TEST_OBJECT(idx) ((otai_object_id_t)(0x1000000000000ULL + (idx)))
+
+static const otai_stat_metadata_t* rate_test_find_stat(
+        _In_ bool counter,
+        _In_ otai_stat_value_type_t type)
+{
+    for (size_t i = 0; i < otai_metadata_stat_sorted_by_id_name_count; ++i)
+    {
+        const otai_stat_metadata_t *md = otai_metadata_stat_sorted_by_id_name[i];
+
+        if (md->statvalueiscounter == counter && md->statvaluetype == type)
+        {
+            return md;
+        }
+    }
+
+    return NULL;
+}
+
+static otai_status_t rate_test_init(
+        _Out_ otai_metadata_rate_t *rate,
+        _In_ const otai_stat_metadata_t *md,
+        _In_ uint32_t capacity)
+{
+    otai_metadata_rate_config_t config;
+
+    memset(&config, 0, sizeof(config));
+
+    config.objecttype = md->objecttype;
+    config.statcount = 1;
+    config.statids = &md->statid;
+    config.capacity = capacity;
+    config.mode = OTAI_STATS_MODE_READ;
+
+    return otai_metadata_rate_init(rate, &config);
+}
+
+static void rate_test_update(
+        _Inout_ otai_metadata_rate_t *rate,
+        _In_ otai_object_id_t object_id,
+        _In_ uint64_t value)
+{
+    otai_stat_value_t counter;
+
+    counter.u64 = 0;
+
+    if (rate->statvaluetypes[0] == OTAI_STAT_VALUE_TYPE_UINT32)
+    {
+        counter.u32 = (uint32_t)value;
+    }
+    else
+    {
+        counter.u64 = value;
+    }
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_rate_update(rate, object_id, &counter));
+}
+
+static otai_metadata_rate_value_t rate_test_get(
+        _In_ const otai_metadata_rate_t *rate,
+        _In_ otai_object_id_t object_id)
+{
+    otai_metadata_rate_value_t value;
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_rate_get_value(rate, object_id, rate->statids[0], &value));
+
+    return value;
+}
+
+TEST(OtaiRateTest, invalid_config)
+{
+    const otai_stat_metadata_t *gauge = rate_test_find_stat(false, OTAI_STAT_VALUE_TYPE_DOUBLE);
+
+    otai_metadata_rate_t rate;
+
+    if (gauge != NULL)
+    {
+        /* gauges have no rate */
+
+        EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, rate_test_init(&rate, gauge, 4));
+    }
+
+    const otai_stat_metadata_t *md = rate_test_find_stat(true, OTAI_STAT_VALUE_TYPE_UINT64);
+
+    ASSERT_NE(md, nullptr);
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, rate_test_init(&rate, md, 0));
+}
+
+TEST(OtaiRateTest, add_and_remove)
+{
+    const otai_stat_metadata_t *md = rate_test_find_stat(true, OTAI_STAT_VALUE_TYPE_UINT64);
+
+    ASSERT_NE(md, nullptr);
+
+    otai_metadata_rate_t rate;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, rate_test_init(&rate, md, 64));
+
+    uint32_t idx = 0;
+
+    for (; idx < 64; idx++)
+    {
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_rate_add_object(&rate, RATE_TEST_OBJECT(idx)));
+
+        rate_test_update(&rate, RATE_TEST_OBJECT(idx), 0);
+    }
+
+    EXPECT_EQ(OTAI_STATUS_ITEM_ALREADY_EXISTS, otai_metadata_rate_add_object(&rate, RATE_TEST_OBJECT(1)));
+    EXPECT_EQ(OTAI_STATUS_TABLE_FULL, otai_metadata_rate_add_object(&rate, RATE_TEST_OBJECT(64)));
+
+    otai_metadata_rate_compute(&rate, 1000);
+
+    for (idx = 0; idx < 64; idx++)
+    {
+        rate_test_update(&rate, RATE_TEST_OBJECT(idx), idx * 10);
+    }
+
+    otai_metadata_rate_compute(&rate, 3000);
+
+    /* moved objects keep their values */
+
+    for (idx = 0; idx < 64; idx += 3)
+    {
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_rate_remove_object(&rate, RATE_TEST_OBJECT(idx)));
+    }
+
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_rate_remove_object(&rate, RATE_TEST_OBJECT(0)));
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_rate_reset(&rate, RATE_TEST_OBJECT(3)));
+
+    for (idx = 0; idx < 64; idx++)
+    {
+        otai_metadata_rate_value_t value;
+
+        otai_status_t status = otai_metadata_rate_get_value(&rate, RATE_TEST_OBJECT(idx), md->statid, &value);
+
+        if (idx % 3 == 0)
+        {
+            EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, status);
+
+            continue;
+        }
+
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, status);
+        EXPECT_EQ(idx * 10u, value.delta.u64);
+        EXPECT_DOUBLE_EQ(idx * 5.0, value.rate);
+    }
+
+    otai_metadata_rate_destroy(&rate);
+}
+
+TEST(OtaiRateTest, keep_last_rate)
+{
+    const otai_stat_metadata_t *md = rate_test_find_stat(true, OTAI_STAT_VALUE_TYPE_UINT64);
+
+    ASSERT_NE(md, nullptr);
+
+    otai_metadata_rate_t rate;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, rate_test_init(&rate, md, 4));
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_rate_add_object(&rate, RATE_TEST_OBJECT(0)));
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_rate_add_object(&rate, RATE_TEST_OBJECT(1)));
+
+    /* first sample has no delta */
+
+    rate_test_update(&rate, RATE_TEST_OBJECT(0), 100);
+    rate_test_update(&rate, RATE_TEST_OBJECT(1), 100);
+
+    otai_metadata_rate_compute(&rate, 1000);
+
+    EXPECT_EQ(0u, rate_test_get(&rate, RATE_TEST_OBJECT(0)).delta.u64);
+    EXPECT_EQ(0, rate_test_get(&rate, RATE_TEST_OBJECT(0)).rate);
+
+    rate_test_update(&rate, RATE_TEST_OBJECT(0), 300);
+    rate_test_update(&rate, RATE_TEST_OBJECT(1), 200);
+
+    otai_metadata_rate_compute(&rate, 2000);
+
+    EXPECT_DOUBLE_EQ(200, rate_test_get(&rate, RATE_TEST_OBJECT(0)).rate);
+    EXPECT_DOUBLE_EQ(100, rate_test_get(&rate, RATE_TEST_OBJECT(1)).rate);
+
+    /* object which failed to be sampled keeps last valid rate */
+
+    rate_test_update(&rate, RATE_TEST_OBJECT(1), 250);
+
+    otai_metadata_rate_compute(&rate, 2500);
+
+    otai_metadata_rate_value_t value = rate_test_get(&rate, RATE_TEST_OBJECT(0));
+
+    EXPECT_EQ(200u, value.delta.u64);
+    EXPECT_DOUBLE_EQ(200, value.rate);
+    EXPECT_DOUBLE_EQ(100, rate_test_get(&rate, RATE_TEST_OBJECT(1)).rate);
+
+    /* next sample is computed over whole time since last one */
+
+    rate_test_update(&rate, RATE_TEST_OBJECT(0), 900);
+
+    otai_metadata_rate_compute(&rate, 4000);
+
+    value = rate_test_get(&rate, RATE_TEST_OBJECT(0));
+
+    EXPECT_EQ(600u, value.delta.u64);
+    EXPECT_DOUBLE_EQ(300, value.rate);
+
+    /* after reset next sample is only previous one */
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_rate_reset(&rate, RATE_TEST_OBJECT(0)));
+
+    rate_test_update(&rate, RATE_TEST_OBJECT(0), 5);
+
+    otai_metadata_rate_compute(&rate, 5000);
+
+    value = rate_test_get(&rate, RATE_TEST_OBJECT(0));
+
+    EXPECT_EQ(0u, value.delta.u64);
+    EXPECT_EQ(0, value.rate);
+
+    otai_metadata_rate_destroy(&rate);
+}
+
+TEST(OtaiRateTest, u64_reset)
+{
+    const otai_stat_metadata_t *md = rate_test_find_stat(true, OTAI_STAT_VALUE_TYPE_UINT64);
+
+    ASSERT_NE(md, nullptr);
+
+    otai_metadata_rate_t rate;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, rate_test_init(&rate, md, 4));
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_rate_add_object(&rate, RATE_TEST_OBJECT(0)));
+
+    rate_test_update(&rate, RATE_TEST_OBJECT(0), 1000);
+    otai_metadata_rate_compute(&rate, 1000);
+
+    rate_test_update(&rate, RATE_TEST_OBJECT(0), 40);
+    otai_metadata_rate_compute(&rate, 2000);
+
+    EXPECT_EQ(40u, rate_test_get(&rate, RATE_TEST_OBJECT(0)).delta.u64);
+
+    otai_metadata_rate_destroy(&rate);
+}
+
+TEST(OtaiRateTest, u32_wrap_and_clear)
+{
+    const otai_stat_metadata_t *md = rate_test_find_stat(true, OTAI_STAT_VALUE_TYPE_UINT32);
+
+    if (md == NULL)
+    {
+        /* no 32 bit counters in metadata */
+
+        return;
+    }
+
+    otai_metadata_rate_t rate;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, rate_test_init(&rate, md, 4));
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_rate_add_object(&rate, RATE_TEST_OBJECT(0)));
+
+    rate_test_update(&rate, RATE_TEST_OBJECT(0), UINT32_MAX - 9);
+    otai_metadata_rate_compute(&rate, 1000);
+
+    /* wrap counts 10 up to zero and 5 after it */
+
+    rate_test_update(&rate, RATE_TEST_OBJECT(0), 5);
+    otai_metadata_rate_compute(&rate, 2000);
+
+    EXPECT_EQ(15u, rate_test_get(&rate, RATE_TEST_OBJECT(0)).delta.u64);
+
+    rate_test_update(&rate, RATE_TEST_OBJECT(0), 1000);
+    otai_metadata_rate_compute(&rate, 3000);
+
+    EXPECT_EQ(995u, rate_test_get(&rate, RATE_TEST_OBJECT(0)).delta.u64);
+
+    /* counter cleared outside of engine is counted from zero, not as wrap */
+
+    rate_test_update(&rate, RATE_TEST_OBJECT(0), 7);
+    otai_metadata_rate_compute(&rate, 4000);
+
+    otai_metadata_rate_value_t value = rate_test_get(&rate, RATE_TEST_OBJECT(0));
+
+    EXPECT_EQ(7u, value.delta.u64);
+    EXPECT_DOUBLE_EQ(7, value.rate);
+
+    otai_metadata_rate_destroy(&rate);
+}
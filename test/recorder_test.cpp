@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+
+extern "C" {
+#include "otaimetadata.h"
+#include "otaimetadatarecorder.h"
+}
+
+#define RECORDER_TEST_RECORDED_LINECARD ((otai_object_id_t)0x2100000000000001ULL)
+#define RECORDER_TEST_REPLAYED_LINECARD ((otai_object_id_t)0x2100000000000002ULL)
+
+/* adapter calls seen by replay */
+
+static std::vector<otai_attribute_t> gRecorderCreateAttrs;
+static std::vector<otai_attribute_t> gRecorderSetAttrs;
+static std::vector<otai_object_id_t> gRecorderSetIds;
+
+static otai_status_t recorder_test_create_linecard(
+        _Out_ otai_object_id_t *linecard_id,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    gRecorderCreateAttrs.assign(attr_list, attr_list + attr_count);
+
+    *linecard_id = RECORDER_TEST_REPLAYED_LINECARD;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static otai_status_t recorder_test_set_linecard_attribute(
+        _In_ otai_object_id_t linecard_id,
+        _In_ const otai_attribute_t *attr)
+{
+    gRecorderSetIds.push_back(linecard_id);
+    gRecorderSetAttrs.push_back(*attr);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static otai_status_t recorder_test_api_query(
+        _In_ otai_api_t api,
+        _Out_ void **api_method_table)
+{
+    static otai_linecard_api_t linecard_api;
+
+    if (api != OTAI_API_LINECARD)
+    {
+        *api_method_table = NULL;
+
+        return OTAI_STATUS_NOT_SUPPORTED;
+    }
+
+    linecard_api.create_linecard = recorder_test_create_linecard;
+    linecard_api.set_linecard_attribute = recorder_test_set_linecard_attribute;
+
+    *api_method_table = &linecard_api;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static void recorder_test_notify(void)
+{
+}
+
+static otai_pointer_t recorder_test_pointer(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_attr_id_t attr_id)
+{
+    (void)attr_id;
+
+    return object_type == OTAI_OBJECT_TYPE_LINECARD ? (otai_pointer_t)recorder_test_notify : NULL;
+}
+
+static const otai_attr_metadata_t* recorder_test_find_attr(
+        _In_ bool pointer)
+{
+    for (size_t i = 0; i < otai_metadata_attr_sorted_by_id_name_count; ++i)
+    {
+        const otai_attr_metadata_t *md = otai_metadata_attr_sorted_by_id_name[i];
+
+        if (md->objecttype == OTAI_OBJECT_TYPE_LINECARD && md->iscreateandset &&
+                (md->attrvaluetype == OTAI_ATTR_VALUE_TYPE_POINTER) == pointer &&
+                (pointer || md->attrvaluetype == OTAI_ATTR_VALUE_TYPE_UINT32 || md->attrvaluetype == OTAI_ATTR_VALUE_TYPE_BOOL))
+        {
+            return md;
+        }
+    }
+
+    return NULL;
+}
+
+static void recorder_test_record_set(
+        _In_ const otai_attribute_t *attr)
+{
+    otai_metadata_recorder_call_t call;
+
+    otai_object_id_t linecard_id = RECORDER_TEST_RECORDED_LINECARD;
+
+    memset(&call, 0, sizeof(call));
+
+    call.api = OTAI_API_LINECARD;
+    call.op = OTAI_METADATA_INSTRUMENT_OP_SET;
+    call.objecttype = OTAI_OBJECT_TYPE_LINECARD;
+    call.start = otai_metadata_recorder_now();
+    call.objectcount = 1;
+    call.objectids = &linecard_id;
+    call.attrs = attr;
+
+    otai_metadata_recorder_record(&call);
+}
+
+/*
+ * Records create of linecard with value and notification, and sets of
+ * notification, NULL notification and value.
+ */
+static void recorder_test_record(
+        _In_ const char *filename,
+        _In_ const otai_attr_metadata_t *value,
+        _In_ const otai_attr_metadata_t *pointer)
+{
+    otai_metadata_recorder_config_t config = { recorder_test_api_query, filename, 0 };
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_recorder_start(&config));
+
+    otai_attribute_t attrs[2];
+
+    memset(attrs, 0, sizeof(attrs));
+
+    attrs[0].id = value->attrid;
+    attrs[0].value.u32 = 1;
+    attrs[1].id = pointer->attrid;
+    attrs[1].value.ptr = (otai_pointer_t)&config;
+
+    otai_metadata_recorder_call_t call;
+
+    otai_object_id_t linecard_id = RECORDER_TEST_RECORDED_LINECARD;
+
+    uint32_t attr_count = 2;
+
+    const otai_attribute_t *attr_list = attrs;
+
+    memset(&call, 0, sizeof(call));
+
+    call.api = OTAI_API_LINECARD;
+    call.op = OTAI_METADATA_INSTRUMENT_OP_CREATE;
+    call.objecttype = OTAI_OBJECT_TYPE_LINECARD;
+    call.start = otai_metadata_recorder_now();
+    call.objectcount = 1;
+    call.objectids = &linecard_id;
+    call.attrcounts = &attr_count;
+    call.attrlists = &attr_list;
+
+    otai_metadata_recorder_record(&call);
+
+    recorder_test_record_set(&attrs[1]);
+
+    attrs[1].value.ptr = NULL;
+
+    recorder_test_record_set(&attrs[1]);
+    recorder_test_record_set(&attrs[0]);
+
+    EXPECT_EQ(0u, otai_metadata_recorder_get_dropped());
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_recorder_stop());
+}
+
+static void recorder_test_replay(
+        _In_ const char *filename,
+        _In_ otai_metadata_recorder_pointer_fn pointer,
+        _Out_ otai_metadata_recorder_replay_stats_t *stats)
+{
+    otai_metadata_recorder_replay_config_t config = { recorder_test_api_query, 0, 0, pointer };
+
+    gRecorderCreateAttrs.clear();
+    gRecorderSetAttrs.clear();
+    gRecorderSetIds.clear();
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_recorder_replay(filename, &config, stats));
+}
+
+TEST(OtaiRecorderTest, invalid_config)
+{
+    otai_metadata_recorder_config_t config = { recorder_test_api_query, NULL, 0 };
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_recorder_start(NULL));
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_recorder_start(&config));
+    EXPECT_EQ(OTAI_STATUS_UNINITIALIZED, otai_metadata_recorder_stop());
+
+    otai_metadata_recorder_replay_config_t replay = { recorder_test_api_query, -1, 0, NULL };
+    otai_metadata_recorder_replay_stats_t stats;
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_recorder_replay("recorder_test.rec", &replay, &stats));
+}
+
+TEST(OtaiRecorderTest, round_trip)
+{
+    const otai_attr_metadata_t *value = recorder_test_find_attr(false);
+    const otai_attr_metadata_t *pointer = recorder_test_find_attr(true);
+
+    ASSERT_NE(value, nullptr);
+    ASSERT_NE(pointer, nullptr);
+
+    char filename[] = "/tmp/otai_recorder_test_XXXXXX";
+
+    int fd = mkstemp(filename);
+
+    ASSERT_GE(fd, 0);
+
+    close(fd);
+
+    recorder_test_record(filename, value, pointer);
+
+    /* recorded pointer is dropped without replacement */
+
+    otai_metadata_recorder_replay_stats_t stats;
+
+    recorder_test_replay(filename, NULL, &stats);
+
+    EXPECT_EQ(3u, stats.calls);
+    EXPECT_EQ(1u, stats.skipped);
+    EXPECT_EQ(0u, stats.mismatches);
+
+    ASSERT_EQ(1u, gRecorderCreateAttrs.size());
+    EXPECT_EQ(value->attrid, gRecorderCreateAttrs[0].id);
+
+    ASSERT_EQ(2u, gRecorderSetAttrs.size());
+    EXPECT_EQ(pointer->attrid, gRecorderSetAttrs[0].id);
+    EXPECT_EQ(nullptr, gRecorderSetAttrs[0].value.ptr);
+    EXPECT_EQ(value->attrid, gRecorderSetAttrs[1].id);
+
+    /* created object id replaces recorded one */
+
+    EXPECT_EQ(RECORDER_TEST_REPLAYED_LINECARD, gRecorderSetIds[0]);
+    EXPECT_EQ(RECORDER_TEST_REPLAYED_LINECARD, gRecorderSetIds[1]);
+
+    /* recorded pointer is replaced by configured one */
+
+    recorder_test_replay(filename, recorder_test_pointer, &stats);
+
+    EXPECT_EQ(4u, stats.calls);
+    EXPECT_EQ(0u, stats.skipped);
+
+    ASSERT_EQ(2u, gRecorderCreateAttrs.size());
+    EXPECT_EQ(pointer->attrid, gRecorderCreateAttrs[1].id);
+    EXPECT_EQ((otai_pointer_t)recorder_test_notify, gRecorderCreateAttrs[1].value.ptr);
+
+    ASSERT_EQ(3u, gRecorderSetAttrs.size());
+    EXPECT_EQ((otai_pointer_t)recorder_test_notify, gRecorderSetAttrs[0].value.ptr);
+    EXPECT_EQ(nullptr, gRecorderSetAttrs[1].value.ptr);
+
+    unlink(filename);
+}
@@ -0,0 +1,727 @@
+#include <gtest/gtest.h>
+#include <locale.h>
+#include <math.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "otaimetadata.h"
+}
+
+#define SERIALIZE_TEST_BUFFER_WORDS 4096
+
+/* all list values share count and list layout */
+
+static size_t serialize_test_item_size(
+        _In_ otai_attr_value_type_t type)
+{
+    switch (type)
+    {
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            return sizeof(otai_object_id_t);
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            return sizeof(uint8_t);
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            return sizeof(uint16_t);
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            return sizeof(uint32_t);
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            return sizeof(otai_spectrum_power_t);
+        default:
+            return 0;
+    }
+}
+
+static void serialize_test_fill(
+        _In_ const otai_attr_metadata_t *meta,
+        _Inout_ otai_attribute_t *attr)
+{
+    memset(attr, 0, sizeof(*attr));
+
+    attr->id = meta->attrid;
+
+    switch (meta->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_BOOL:
+            attr->value.booldata = true;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_CHARDATA:
+            strcpy(attr->value.chardata, "binary \"codec\" \\ test");
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT8:
+            attr->value.u8 = 0xfe;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT8:
+            attr->value.s8 = -128;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT16:
+            attr->value.u16 = 0xfffe;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT16:
+            attr->value.s16 = -32768;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT32:
+            attr->value.u32 = 0xfffffffe;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT32:
+            attr->value.s32 = INT32_MIN;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT64:
+            attr->value.u64 = UINT64_MAX;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT64:
+            attr->value.s64 = INT64_MIN;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_DOUBLE:
+            attr->value.d64 = -17.25e-3;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_POINTER:
+            attr->value.ptr = (otai_pointer_t)attr;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_ID:
+            attr->value.oid = 0x1122334455667788ULL;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT32_RANGE:
+            attr->value.u32range.min = 0;
+            attr->value.u32range.max = UINT32_MAX;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT32_RANGE:
+            attr->value.s32range.min = INT32_MIN;
+            attr->value.s32range.max = -1;
+            break;
+        default:
+        {
+            ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_alloc_attr_value(meta, attr, NULL));
+
+            uint8_t *bytes = (uint8_t*)attr->value.u8list.list;
+
+            for (size_t i = 0; i < attr->value.u8list.count * serialize_test_item_size(meta->attrvaluetype); ++i)
+            {
+                bytes[i] = (uint8_t)(i * 37 + 1);
+            }
+
+            break;
+        }
+    }
+}
+
+static const otai_attr_metadata_t* serialize_test_find(
+        _In_ otai_attr_value_type_t type)
+{
+    for (size_t i = 0; i < otai_metadata_attr_sorted_by_id_name_count; ++i)
+    {
+        if (otai_metadata_attr_sorted_by_id_name[i]->attrvaluetype == type)
+        {
+            return otai_metadata_attr_sorted_by_id_name[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void serialize_test_expect_equal(
+        _In_ const otai_attr_metadata_t *meta,
+        _In_ const otai_attribute_t *lhs,
+        _In_ const otai_attribute_t *rhs)
+{
+    bool equal = false;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_deepequal_attr_value(meta, lhs, rhs, &equal));
+
+    EXPECT_TRUE(equal) << meta->attridname;
+}
+
+TEST(OtaiSerializeBinaryTest, attribute_round_trip)
+{
+    std::vector<uint64_t> storage(SERIALIZE_TEST_BUFFER_WORDS);
+
+    uint8_t *buffer = (uint8_t*)storage.data();
+
+    size_t length = storage.size() * sizeof(uint64_t);
+
+    int covered = 0;
+
+    for (int type = OTAI_ATTR_VALUE_TYPE_BOOL; type <= OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST; ++type)
+    {
+        const otai_attr_metadata_t *meta = serialize_test_find((otai_attr_value_type_t)type);
+
+        if (meta == NULL)
+        {
+            continue;
+        }
+
+        covered++;
+
+        otai_attribute_t src;
+
+        serialize_test_fill(meta, &src);
+
+        int size = otai_serialize_attribute_binary(buffer, length, meta, &src);
+
+        ASSERT_GT(size, 0) << meta->attridname;
+        EXPECT_EQ(OTAI_SERIALIZE_BINARY_VERSION, buffer[0]);
+
+        /* copy mode, caller provided lists */
+
+        otai_attribute_t dst;
+
+        memset(&dst, 0, sizeof(dst));
+
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_alloc_attr_value(meta, &dst, NULL));
+
+        EXPECT_EQ(size, otai_deserialize_attribute_binary(buffer, length, meta->objecttype, false, &dst)) << meta->attridname;
+
+        serialize_test_expect_equal(meta, &src, &dst);
+
+        /* zero copy mode, lists point into buffer */
+
+        otai_attribute_t view;
+
+        memset(&view, 0, sizeof(view));
+
+        EXPECT_EQ(size, otai_deserialize_attribute_binary(buffer, length, meta->objecttype, true, &view)) << meta->attridname;
+
+        serialize_test_expect_equal(meta, &src, &view);
+
+        if (serialize_test_item_size(meta->attrvaluetype) && view.value.u8list.count)
+        {
+            EXPECT_GE(view.value.u8list.list, buffer);
+            EXPECT_LT(view.value.u8list.list, buffer + size);
+        }
+
+        /* truncated input and output are rejected */
+
+        for (int len = 0; len < size; ++len)
+        {
+            EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_deserialize_attribute_binary(buffer, (size_t)len, meta->objecttype, true, &view))
+                << meta->attridname << " " << len;
+
+            EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_serialize_attribute_binary(buffer + length / 2, (size_t)len, meta, &src))
+                << meta->attridname << " " << len;
+        }
+
+        /* newer encoding version is rejected */
+
+        buffer[0] = OTAI_SERIALIZE_BINARY_VERSION + 1;
+
+        EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_deserialize_attribute_binary(buffer, length, meta->objecttype, true, &view));
+
+        otai_metadata_free_attr_value(meta, &dst, NULL);
+        otai_metadata_free_attr_value(meta, &src, NULL);
+    }
+
+    EXPECT_GT(covered, 0);
+}
+
+TEST(OtaiSerializeBinaryTest, list_capacity)
+{
+    const otai_attr_metadata_t *meta = serialize_test_find(OTAI_ATTR_VALUE_TYPE_UINT32_LIST);
+
+    if (meta == NULL)
+    {
+        return;
+    }
+
+    std::vector<uint64_t> storage(SERIALIZE_TEST_BUFFER_WORDS);
+
+    uint8_t *buffer = (uint8_t*)storage.data();
+
+    otai_attribute_t src;
+
+    serialize_test_fill(meta, &src);
+
+    int size = otai_serialize_attribute_binary(buffer, storage.size() * sizeof(uint64_t), meta, &src);
+
+    ASSERT_GT(size, 0);
+
+    /* like get attribute API, too small list reports required count */
+
+    uint32_t small[2];
+
+    otai_attribute_t dst;
+
+    memset(&dst, 0, sizeof(dst));
+
+    dst.value.u32list.count = 2;
+    dst.value.u32list.list = small;
+
+    EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_deserialize_attribute_binary(buffer, (size_t)size, meta->objecttype, false, &dst));
+    EXPECT_EQ(src.value.u32list.count, dst.value.u32list.count);
+
+    otai_metadata_free_attr_value(meta, &src, NULL);
+}
+
+TEST(OtaiSerializeBinaryTest, attribute_list_round_trip)
+{
+    const otai_attr_metadata_t *first = serialize_test_find(OTAI_ATTR_VALUE_TYPE_UINT32);
+
+    ASSERT_NE(first, nullptr);
+
+    std::vector<const otai_attr_metadata_t*> metas;
+
+    for (size_t i = 0; i < otai_metadata_attr_sorted_by_id_name_count; ++i)
+    {
+        const otai_attr_metadata_t *meta = otai_metadata_attr_sorted_by_id_name[i];
+
+        if (meta->objecttype == first->objecttype && meta->attrvaluetype != OTAI_ATTR_VALUE_TYPE_POINTER)
+        {
+            metas.push_back(meta);
+        }
+    }
+
+    std::vector<otai_attribute_t> src(metas.size());
+    std::vector<otai_attribute_t> dst(metas.size());
+
+    for (size_t i = 0; i < metas.size(); ++i)
+    {
+        serialize_test_fill(metas[i], &src[i]);
+    }
+
+    std::vector<uint64_t> storage(SERIALIZE_TEST_BUFFER_WORDS * 4);
+
+    uint8_t *buffer = (uint8_t*)storage.data();
+
+    size_t length = storage.size() * sizeof(uint64_t);
+
+    int size = otai_serialize_attribute_list_binary(buffer, length, first->objecttype, (uint32_t)src.size(), src.data());
+
+    ASSERT_GT(size, 0);
+
+    uint32_t count = (uint32_t)dst.size();
+
+    EXPECT_EQ(size, otai_deserialize_attribute_list_binary(buffer, length, first->objecttype, true, &count, dst.data()));
+    ASSERT_EQ(src.size(), count);
+
+    for (size_t i = 0; i < metas.size(); ++i)
+    {
+        serialize_test_expect_equal(metas[i], &src[i], &dst[i]);
+    }
+
+    /* object type must match */
+
+    count = (uint32_t)dst.size();
+
+    EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_deserialize_attribute_list_binary(buffer, length, OTAI_OBJECT_TYPE_NULL, true, &count, dst.data()));
+
+    /* list capacity too small */
+
+    count = (uint32_t)dst.size() - 1;
+
+    EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_deserialize_attribute_list_binary(buffer, length, first->objecttype, true, &count, dst.data()));
+
+    for (size_t i = 0; i < metas.size(); ++i)
+    {
+        otai_metadata_free_attr_value(metas[i], &src[i], NULL);
+    }
+}
+
+static std::string serialize_test_json(
+        _In_ const otai_attr_metadata_t *meta,
+        _In_ const std::string& value)
+{
+    return std::string("{\"id\":\"") + meta->attridname + "\",\"value\":" + value + "}";
+}
+
+TEST(OtaiSerializeJsonTest, nested_list_round_trip)
+{
+    const otai_attr_metadata_t *first = serialize_test_find(OTAI_ATTR_VALUE_TYPE_UINT32);
+
+    ASSERT_NE(first, nullptr);
+
+    std::vector<const otai_attr_metadata_t*> metas;
+
+    for (size_t i = 0; i < otai_metadata_attr_sorted_by_id_name_count; ++i)
+    {
+        const otai_attr_metadata_t *meta = otai_metadata_attr_sorted_by_id_name[i];
+
+        /* JSON serializer does not escape, so chardata is filled with plain text */
+
+        if (meta->objecttype == first->objecttype && meta->attrvaluetype != OTAI_ATTR_VALUE_TYPE_POINTER)
+        {
+            metas.push_back(meta);
+        }
+    }
+
+    std::vector<otai_attribute_t> src(metas.size());
+    std::vector<otai_attribute_t> dst(metas.size());
+
+    std::string json = "[";
+
+    for (size_t i = 0; i < metas.size(); ++i)
+    {
+        serialize_test_fill(metas[i], &src[i]);
+
+        if (metas[i]->attrvaluetype == OTAI_ATTR_VALUE_TYPE_CHARDATA)
+        {
+            strcpy(src[i].value.chardata, "a{b}[c],:d");
+        }
+
+        std::vector<char> buffer(SERIALIZE_TEST_BUFFER_WORDS * 8);
+
+        ASSERT_GT(otai_serialize_attribute(buffer.data(), metas[i], &src[i]), 0) << metas[i]->attridname;
+
+        json += (i ? "," : "") + std::string(buffer.data());
+    }
+
+    json += "]";
+
+    std::vector<uint64_t> arena(SERIALIZE_TEST_BUFFER_WORDS);
+
+    uint32_t count = (uint32_t)dst.size();
+
+    EXPECT_EQ((int)json.size(), otai_deserialize_attribute_list(json.c_str(), (uint8_t*)arena.data(),
+                arena.size() * sizeof(uint64_t), &count, dst.data()));
+
+    ASSERT_EQ(src.size(), count);
+
+    for (size_t i = 0; i < metas.size(); ++i)
+    {
+        serialize_test_expect_equal(metas[i], &src[i], &dst[i]);
+    }
+
+    /* every truncated input is rejected */
+
+    for (size_t len = 0; len < json.size(); ++len)
+    {
+        std::string truncated = json.substr(0, len);
+
+        count = (uint32_t)dst.size();
+
+        EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_deserialize_attribute_list(truncated.c_str(), (uint8_t*)arena.data(),
+                    arena.size() * sizeof(uint64_t), &count, dst.data())) << truncated;
+    }
+
+    /* list values don't fit into arena */
+
+    bool haslist = false;
+
+    for (size_t i = 0; i < metas.size(); ++i)
+    {
+        haslist = haslist || serialize_test_item_size(metas[i]->attrvaluetype) != 0;
+    }
+
+    count = (uint32_t)dst.size();
+
+    if (haslist)
+    {
+        EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_deserialize_attribute_list(json.c_str(), (uint8_t*)arena.data(), 8, &count, dst.data()));
+    }
+
+    for (size_t i = 0; i < metas.size(); ++i)
+    {
+        otai_metadata_free_attr_value(metas[i], &src[i], NULL);
+    }
+}
+
+TEST(OtaiSerializeJsonTest, malformed)
+{
+    const otai_attr_metadata_t *meta = serialize_test_find(OTAI_ATTR_VALUE_TYPE_UINT32);
+
+    ASSERT_NE(meta, nullptr);
+
+    otai_attribute_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+
+    std::string good = serialize_test_json(meta, "{\"u32\":4294967295}");
+
+    EXPECT_EQ((int)good.size(), otai_deserialize_attribute(good.c_str(), &attr));
+    EXPECT_EQ(meta->attrid, attr.id);
+    EXPECT_EQ(UINT32_MAX, attr.value.u32);
+
+    const std::string bad[] = {
+        "",
+        "{}",
+        "[]",
+        serialize_test_json(meta, "{\"u32\":5}").substr(1),
+        serialize_test_json(meta, "{\"u32\":5"),
+        serialize_test_json(meta, "{\"u32\":-5}"),
+        serialize_test_json(meta, "{\"u32\":4294967296}"),
+        serialize_test_json(meta, "{\"u32\":5x}"),
+        serialize_test_json(meta, "{\"u32\":}"),
+        serialize_test_json(meta, "{\"s32\":5}"),
+        serialize_test_json(meta, "{\"u32\":\"5\"}"),
+        serialize_test_json(meta, "5"),
+        std::string("{\"id\":\"") + meta->attridname + "_X\",\"value\":{\"u32\":5}}",
+        std::string("{\"id\":") + meta->attridname + ",\"value\":{\"u32\":5}}",
+        std::string("{\"value\":{\"u32\":5},\"id\":\"") + meta->attridname + "\"}",
+        std::string("{\"id\":\"") + meta->attridname + "\"}",
+    };
+
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i)
+    {
+        EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_deserialize_attribute(bad[i].c_str(), &attr)) << bad[i];
+    }
+
+    otai_attribute_t list[2];
+
+    uint8_t arena[64];
+
+    const std::string badlist[] = {
+        "[" + good,
+        "[" + good + ",]",
+        "[" + good + good + "]",
+        "[," + good + "]",
+        "[" + good + "," + good + "," + good + "]",
+    };
+
+    for (size_t i = 0; i < sizeof(badlist) / sizeof(badlist[0]); ++i)
+    {
+        uint32_t count = 2;
+
+        EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_deserialize_attribute_list(badlist[i].c_str(), arena, sizeof(arena), &count, list)) << badlist[i];
+    }
+
+    uint32_t count = 2;
+
+    EXPECT_EQ(2, otai_deserialize_attribute_list("[]", arena, sizeof(arena), &count, list));
+    EXPECT_EQ(0u, count);
+}
+
+TEST(OtaiSerializeJsonTest, list_count)
+{
+    const otai_attr_metadata_t *meta = serialize_test_find(OTAI_ATTR_VALUE_TYPE_UINT32_LIST);
+
+    if (meta == NULL)
+    {
+        return;
+    }
+
+    uint32_t items[4];
+
+    otai_attribute_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+
+    attr.value.u32list.count = 4;
+    attr.value.u32list.list = items;
+
+    std::string good = serialize_test_json(meta, "{\"u32list\":{\"count\":3,\"list\":[1,2,3]}}");
+
+    EXPECT_EQ((int)good.size(), otai_deserialize_attribute(good.c_str(), &attr));
+    EXPECT_EQ(3u, attr.value.u32list.count);
+    EXPECT_EQ(3u, items[2]);
+
+    /* count must match number of items */
+
+    attr.value.u32list.count = 4;
+
+    EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_deserialize_attribute(serialize_test_json(meta, "{\"u32list\":{\"count\":3,\"list\":[1,2]}}").c_str(), &attr));
+
+    attr.value.u32list.count = 4;
+
+    EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_deserialize_attribute(serialize_test_json(meta, "{\"u32list\":{\"count\":2,\"list\":[1,2,3]}}").c_str(), &attr));
+
+    /* too small list reports required count */
+
+    attr.value.u32list.count = 2;
+
+    EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_deserialize_attribute(good.c_str(), &attr));
+    EXPECT_EQ(3u, attr.value.u32list.count);
+
+    /* null list only reports count */
+
+    attr.value.u32list.count = 4;
+
+    std::string null = serialize_test_json(meta, "{\"u32list\":{\"count\":7,\"list\":null}}");
+
+    EXPECT_EQ((int)null.size(), otai_deserialize_attribute(null.c_str(), &attr));
+    EXPECT_EQ(7u, attr.value.u32list.count);
+}
+
+TEST(OtaiSerializeJsonTest, escaped_chardata)
+{
+    const otai_attr_metadata_t *meta = serialize_test_find(OTAI_ATTR_VALUE_TYPE_CHARDATA);
+
+    if (meta == NULL)
+    {
+        return;
+    }
+
+    otai_attribute_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+
+    attr.id = meta->attrid;
+
+    char buffer[2 * OTAI_CHARDATA_LENGTH];
+
+    /* serializer doesn't escape, so quote and backslash are refused */
+
+    strcpy(attr.value.chardata, "a\"b");
+
+    EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_serialize_attribute(buffer, meta, &attr));
+
+    strcpy(attr.value.chardata, "a\\b");
+
+    EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_serialize_attribute(buffer, meta, &attr));
+
+    const std::string bad[] = {
+        serialize_test_json(meta, "{\"chardata\":\"a\\\"b\"}"),
+        serialize_test_json(meta, "{\"chardata\":\"a\\\\b\"}"),
+        serialize_test_json(meta, "{\"chardata\":\"a\\u0041\"}"),
+        serialize_test_json(meta, "{\"chardata\":\"a\nb\"}"),
+        serialize_test_json(meta, "{\"chardata\":\"ab}"),
+        serialize_test_json(meta, "{\"chardata\":\"" + std::string(OTAI_CHARDATA_LENGTH + 1, 'x') + "\"}"),
+    };
+
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); ++i)
+    {
+        EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_deserialize_attribute(bad[i].c_str(), &attr)) << bad[i];
+    }
+
+    /* JSON structural characters inside string are data */
+
+    std::string good = serialize_test_json(meta, "{\"chardata\":\"a{b}[c],:d\"}");
+
+    EXPECT_EQ((int)good.size(), otai_deserialize_attribute(good.c_str(), &attr));
+    EXPECT_STREQ("a{b}[c],:d", attr.value.chardata);
+
+    /* chardata may use whole buffer without terminating zero */
+
+    std::string longest = std::string(OTAI_CHARDATA_LENGTH, 'y');
+
+    std::string full = serialize_test_json(meta, "{\"chardata\":\"" + longest + "\"}");
+
+    EXPECT_EQ((int)full.size(), otai_deserialize_attribute(full.c_str(), &attr));
+    EXPECT_EQ(longest, std::string(attr.value.chardata, OTAI_CHARDATA_LENGTH));
+}
+
+TEST(OtaiSerializeDoubleTest, precision_matches_printf)
+{
+    const double values[] = {
+        0.0, -0.0, 0.005, 0.015, 0.125, -0.125, 1e-12, 2.675, -99.995,
+        12345.678, 1e15 + 0.3, 9007199254740993.0, 1e17, -1.5e17,
+    };
+
+    const otai_stat_value_precision_t precisions[] = {
+        OTAI_STAT_VALUE_PRECISION_0,
+        OTAI_STAT_VALUE_PRECISION_1,
+        OTAI_STAT_VALUE_PRECISION_2,
+    };
+
+    const int decimals[] = { 0, 1, 2 };
+
+    char buffer[64];
+    char expected[64];
+
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+    {
+        for (size_t j = 0; j < sizeof(precisions) / sizeof(precisions[0]); ++j)
+        {
+            /* values up to 2^64 after scaling keep fixed decimals */
+
+            int len = snprintf(expected, sizeof(expected), "%.*f", decimals[j], values[i]);
+
+            EXPECT_EQ(len, otai_serialize_double_precision(buffer, values[i], precisions[j]));
+            EXPECT_STREQ(expected, buffer) << values[i];
+        }
+    }
+
+    /* beyond 2^64 after scaling and non finite values use shortest form */
+
+    const double large[] = { 1e19, 2e17, -1e300, INFINITY, -INFINITY };
+
+    for (size_t i = 0; i < sizeof(large) / sizeof(large[0]); ++i)
+    {
+        otai_serialize_double(expected, large[i]);
+
+        EXPECT_LT(0, otai_serialize_double_precision(buffer, large[i], OTAI_STAT_VALUE_PRECISION_2));
+        EXPECT_STREQ(expected, buffer) << large[i];
+    }
+
+    otai_serialize_double(expected, 1e-12);
+
+    EXPECT_LT(0, otai_serialize_double_precision(buffer, 1e-12, OTAI_STAT_VALUE_PRECISION_18));
+    EXPECT_STREQ(expected, buffer);
+
+    EXPECT_EQ(OTAI_SERIALIZE_ERROR, otai_serialize_double_precision(buffer, 1.0, (otai_stat_value_precision_t)-1));
+}
+
+static std::string serialize_test_stat_value(
+        _In_ otai_stat_value_type_t type,
+        _In_ otai_stat_value_precision_t precision,
+        _In_ const otai_stat_value_t& value)
+{
+    const otai_stat_metadata_t meta = { OTAI_OBJECT_TYPE_NULL, 0, "OTAI_TEST_STAT", "test-stat", "testStat",
+        type, OTAI_STAT_VALUE_UNIT_NORMAL, precision, false };
+
+    char buffer[64];
+
+    int len = otai_serialize_stat_value(buffer, &meta, &value);
+
+    if (len < 0)
+    {
+        return "error";
+    }
+
+    EXPECT_EQ((size_t)len, strlen(buffer));
+
+    return buffer;
+}
+
+TEST(OtaiSerializeDoubleTest, stat_value)
+{
+    otai_stat_value_t value;
+
+    value.s32 = -7;
+
+    EXPECT_EQ("-7", serialize_test_stat_value(OTAI_STAT_VALUE_TYPE_INT32, OTAI_STAT_VALUE_PRECISION_2, value));
+
+    value.u64 = UINT64_MAX;
+
+    EXPECT_EQ("18446744073709551615", serialize_test_stat_value(OTAI_STAT_VALUE_TYPE_UINT64, OTAI_STAT_VALUE_PRECISION_2, value));
+
+    value.d64 = 2.25;
+
+    EXPECT_EQ("2.2", serialize_test_stat_value(OTAI_STAT_VALUE_TYPE_DOUBLE, OTAI_STAT_VALUE_PRECISION_1, value));
+    EXPECT_EQ("2", serialize_test_stat_value(OTAI_STAT_VALUE_TYPE_DOUBLE, OTAI_STAT_VALUE_PRECISION_0, value));
+
+    value.d64 = 1.5e-9;
+
+    EXPECT_EQ(1.5e-9, strtod(serialize_test_stat_value(OTAI_STAT_VALUE_TYPE_DOUBLE, OTAI_STAT_VALUE_PRECISION_18, value).c_str(), NULL));
+
+    EXPECT_EQ("error", serialize_test_stat_value((otai_stat_value_type_t)-1, OTAI_STAT_VALUE_PRECISION_2, value));
+}
+
+TEST(OtaiSerializeDoubleTest, deserialize_ignores_locale)
+{
+    /* locale with decimal comma, when one is installed */
+
+    const char *locales[] = { "de_DE.UTF-8", "fr_FR.UTF-8", "ru_RU.UTF-8" };
+
+    for (size_t i = 0; i < sizeof(locales) / sizeof(locales[0]); ++i)
+    {
+        if (setlocale(LC_NUMERIC, locales[i]) != NULL)
+        {
+            break;
+        }
+    }
+
+    /* values which don't fit fast path are parsed by fallback */
+
+    const double values[] = { 1.5e300, 2.2250738585072014e-308, 0.1234567890123456789, 123456789.123456789 };
+
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+    {
+        char buffer[64];
+
+        otai_double_t d64 = 0;
+
+        int len = otai_serialize_double(buffer, values[i]);
+
+        EXPECT_EQ(len, otai_deserialize_double(buffer, &d64)) << buffer;
+        EXPECT_EQ(values[i], d64) << buffer;
+    }
+
+    otai_double_t d64 = 0;
+
+    EXPECT_EQ(7, otai_deserialize_double("1.5e300,2", &d64));
+    EXPECT_EQ(1.5e300, d64);
+
+    setlocale(LC_NUMERIC, "C");
+}
@@ -0,0 +1,346 @@
+#include <gtest/gtest.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+extern "C" {
+#include "otaimetadata.h"
+#include "otaimetadataspectrum.h"
+}
+
+#define SPECTRUM_TEST_LINECARD ((otai_object_id_t)0x2100000000000000ULL)
+#define SPECTRUM_TEST_OTHER_LINECARD ((otai_object_id_t)0x2100000000000001ULL)
+#define SPECTRUM_TEST_OCM(idx) ((otai_object_id_t)(0x2f00000000000000ULL + (idx)))
+
+static uint32_t gSpectrumCalls = 0;
+static otai_object_id_t gSpectrumOcm = OTAI_NULL_OBJECT_ID;
+static otai_spectrum_power_list_t gSpectrumResult;
+static bool gSpectrumStopInHandler = false;
+static uint32_t gSpectrumOtherCalls = 0;
+
+static void spectrum_test_on_ocm_spectrum_power(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_object_id_t ocm_id,
+        _In_ otai_spectrum_power_list_t ocm_result)
+{
+    EXPECT_EQ(SPECTRUM_TEST_LINECARD, linecard_id);
+
+    gSpectrumCalls++;
+    gSpectrumOcm = ocm_id;
+    gSpectrumResult = ocm_result;
+
+    if (gSpectrumStopInHandler)
+    {
+        /* cache lock is not held while user callback runs */
+
+        otai_metadata_spectrum_stop();
+    }
+}
+
+static void spectrum_test_on_other_ocm_spectrum_power(
+        _In_ otai_object_id_t linecard_id,
+        _In_ otai_object_id_t ocm_id,
+        _In_ otai_spectrum_power_list_t ocm_result)
+{
+    (void)ocm_id;
+    (void)ocm_result;
+
+    EXPECT_EQ(SPECTRUM_TEST_OTHER_LINECARD, linecard_id);
+
+    gSpectrumOtherCalls++;
+}
+
+static otai_linecard_ocm_spectrum_power_notification_fn spectrum_test_wrap(void)
+{
+    otai_attribute_t attr;
+
+    attr.id = OTAI_LINECARD_ATTR_LINECARD_OCM_SPECTRUM_POWER_NOTIFY;
+    attr.value.ptr = (otai_pointer_t)spectrum_test_on_ocm_spectrum_power;
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_spectrum_wrap_attr_list(OTAI_OBJECT_TYPE_LINECARD, OTAI_NULL_OBJECT_ID, 1, &attr));
+    EXPECT_NE((otai_pointer_t)spectrum_test_on_ocm_spectrum_power, attr.value.ptr);
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_spectrum_bind_linecard(SPECTRUM_TEST_LINECARD));
+
+    gSpectrumCalls = 0;
+    gSpectrumStopInHandler = false;
+
+    return (otai_linecard_ocm_spectrum_power_notification_fn)attr.value.ptr;
+}
+
+static std::vector<otai_spectrum_power_t> spectrum_test_sweep(
+        _In_ uint32_t count,
+        _In_ double power)
+{
+    std::vector<otai_spectrum_power_t> sweep(count);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        sweep[i].lower_frequency = 191300000 + i * 6250;
+        sweep[i].upper_frequency = 191300000 + (i + 1) * 6250;
+        sweep[i].power = power - i;
+    }
+
+    return sweep;
+}
+
+static void spectrum_test_notify(
+        _In_ otai_linecard_ocm_spectrum_power_notification_fn notify,
+        _In_ otai_object_id_t ocm_id,
+        _Inout_ std::vector<otai_spectrum_power_t> &sweep)
+{
+    otai_spectrum_power_list_t list;
+
+    list.count = (uint32_t)sweep.size();
+    list.list = sweep.data();
+
+    notify(SPECTRUM_TEST_LINECARD, ocm_id, list);
+}
+
+static otai_metadata_spectrum_config_t spectrum_test_config(
+        _In_ uint32_t capacity,
+        _In_ uint32_t buffers,
+        _In_ uint32_t entries)
+{
+    otai_metadata_spectrum_config_t config;
+
+    config.capacity = capacity;
+    config.buffers = buffers;
+    config.entries = entries;
+
+    return config;
+}
+
+TEST(OtaiSpectrumTest, direct_when_not_started)
+{
+    otai_linecard_ocm_spectrum_power_notification_fn notify = spectrum_test_wrap();
+
+    std::vector<otai_spectrum_power_t> sweep = spectrum_test_sweep(4, -10);
+
+    spectrum_test_notify(notify, SPECTRUM_TEST_OCM(0), sweep);
+
+    EXPECT_EQ(1u, gSpectrumCalls);
+    EXPECT_EQ(SPECTRUM_TEST_OCM(0), gSpectrumOcm);
+    EXPECT_EQ(sweep.data(), gSpectrumResult.list);
+    EXPECT_EQ(nullptr, otai_metadata_spectrum_borrow(SPECTRUM_TEST_OCM(0)));
+    EXPECT_EQ(0u, otai_metadata_spectrum_get_version(SPECTRUM_TEST_OCM(0)));
+
+    otai_metadata_spectrum_stats_t stats;
+
+    EXPECT_EQ(OTAI_STATUS_UNINITIALIZED, otai_metadata_spectrum_get_stats(&stats));
+}
+
+TEST(OtaiSpectrumTest, invalid_config)
+{
+    otai_metadata_spectrum_config_t config = spectrum_test_config(0, 2, 8);
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_spectrum_start(NULL));
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_spectrum_start(&config));
+
+    config = spectrum_test_config(4, 1, 8);
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_spectrum_start(&config));
+
+    config = spectrum_test_config(4, 2, 8);
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_spectrum_start(&config));
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_spectrum_start(&config));
+
+    otai_metadata_spectrum_stop();
+
+    /* only linecard notification attribute is wrapped */
+
+    otai_attribute_t attr;
+
+    attr.id = OTAI_LINECARD_ATTR_LINECARD_OCM_SPECTRUM_POWER_NOTIFY;
+    attr.value.ptr = (otai_pointer_t)spectrum_test_on_ocm_spectrum_power;
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_spectrum_wrap_attr_list(OTAI_OBJECT_TYPE_PORT, OTAI_NULL_OBJECT_ID, 1, &attr));
+    EXPECT_EQ((otai_pointer_t)spectrum_test_on_ocm_spectrum_power, attr.value.ptr);
+    EXPECT_EQ(OTAI_STATUS_INVALID_PARAMETER, otai_metadata_spectrum_wrap_attr_list(OTAI_OBJECT_TYPE_LINECARD, OTAI_NULL_OBJECT_ID, 1, NULL));
+}
+
+TEST(OtaiSpectrumTest, borrow_latest)
+{
+    otai_linecard_ocm_spectrum_power_notification_fn notify = spectrum_test_wrap();
+
+    otai_metadata_spectrum_config_t config = spectrum_test_config(4, 2, 2);
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_spectrum_start(&config));
+
+    /* sweep bigger than initial entries grows buffer */
+
+    std::vector<otai_spectrum_power_t> sweep = spectrum_test_sweep(16, -5);
+
+    spectrum_test_notify(notify, SPECTRUM_TEST_OCM(1), sweep);
+
+    /* user gets adapter list */
+
+    EXPECT_EQ(1u, gSpectrumCalls);
+    EXPECT_EQ(sweep.data(), gSpectrumResult.list);
+    EXPECT_EQ(16u, gSpectrumResult.count);
+
+    const otai_metadata_spectrum_sweep_t *cached = otai_metadata_spectrum_borrow(SPECTRUM_TEST_OCM(1));
+
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(SPECTRUM_TEST_LINECARD, cached->linecardid);
+    EXPECT_EQ(SPECTRUM_TEST_OCM(1), cached->ocmid);
+    EXPECT_EQ(1u, cached->version);
+    ASSERT_EQ(16u, cached->spectrum.count);
+    EXPECT_NE(sweep.data(), cached->spectrum.list);
+    EXPECT_EQ(0, memcmp(sweep.data(), cached->spectrum.list, sizeof(otai_spectrum_power_t) * 16));
+
+    /* adapter list may be reused after notification */
+
+    sweep[0].power = 0;
+
+    EXPECT_DOUBLE_EQ(-5, cached->spectrum.list[0].power);
+
+    otai_metadata_spectrum_release(cached);
+
+    EXPECT_EQ(1u, otai_metadata_spectrum_get_version(SPECTRUM_TEST_OCM(1)));
+    EXPECT_EQ(0u, otai_metadata_spectrum_get_version(SPECTRUM_TEST_OCM(2)));
+    EXPECT_EQ(nullptr, otai_metadata_spectrum_borrow(SPECTRUM_TEST_OCM(2)));
+
+    otai_metadata_spectrum_stop();
+}
+
+TEST(OtaiSpectrumTest, dropped_and_overflow)
+{
+    otai_linecard_ocm_spectrum_power_notification_fn notify = spectrum_test_wrap();
+
+    otai_metadata_spectrum_config_t config = spectrum_test_config(1, 2, 8);
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_spectrum_start(&config));
+
+    std::vector<otai_spectrum_power_t> first = spectrum_test_sweep(4, -1);
+    std::vector<otai_spectrum_power_t> second = spectrum_test_sweep(4, -2);
+    std::vector<otai_spectrum_power_t> third = spectrum_test_sweep(4, -3);
+
+    spectrum_test_notify(notify, SPECTRUM_TEST_OCM(0), first);
+
+    const otai_metadata_spectrum_sweep_t *old = otai_metadata_spectrum_borrow(SPECTRUM_TEST_OCM(0));
+
+    spectrum_test_notify(notify, SPECTRUM_TEST_OCM(0), second);
+
+    const otai_metadata_spectrum_sweep_t *latest = otai_metadata_spectrum_borrow(SPECTRUM_TEST_OCM(0));
+
+    ASSERT_NE(old, nullptr);
+    ASSERT_NE(latest, nullptr);
+    EXPECT_NE(old, latest);
+    EXPECT_EQ(2u, latest->version);
+
+    /* both buffers are borrowed, so sweep is dropped but still delivered */
+
+    spectrum_test_notify(notify, SPECTRUM_TEST_OCM(0), third);
+
+    EXPECT_EQ(3u, gSpectrumCalls);
+    EXPECT_EQ(2u, otai_metadata_spectrum_get_version(SPECTRUM_TEST_OCM(0)));
+
+    /* no room for second OCM */
+
+    spectrum_test_notify(notify, SPECTRUM_TEST_OCM(1), third);
+
+    EXPECT_EQ(4u, gSpectrumCalls);
+    EXPECT_EQ(SPECTRUM_TEST_OCM(1), gSpectrumOcm);
+
+    otai_metadata_spectrum_stats_t stats;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_spectrum_get_stats(&stats));
+    EXPECT_EQ(4u, stats.received);
+    EXPECT_EQ(1u, stats.dropped);
+    EXPECT_EQ(1u, stats.overflow);
+    EXPECT_EQ(1u, stats.ocms);
+
+    otai_metadata_spectrum_release(old);
+
+    /* released buffer takes next sweep */
+
+    spectrum_test_notify(notify, SPECTRUM_TEST_OCM(0), third);
+
+    EXPECT_EQ(3u, otai_metadata_spectrum_get_version(SPECTRUM_TEST_OCM(0)));
+
+    otai_metadata_spectrum_release(latest);
+
+    otai_metadata_spectrum_stop();
+}
+
+TEST(OtaiSpectrumTest, stop_in_handler)
+{
+    otai_linecard_ocm_spectrum_power_notification_fn notify = spectrum_test_wrap();
+
+    otai_metadata_spectrum_config_t config = spectrum_test_config(2, 2, 8);
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_spectrum_start(&config));
+
+    gSpectrumStopInHandler = true;
+
+    std::vector<otai_spectrum_power_t> sweep = spectrum_test_sweep(8, -7);
+
+    spectrum_test_notify(notify, SPECTRUM_TEST_OCM(0), sweep);
+
+    /* handler list stays valid after cache is stopped and freed */
+
+    EXPECT_EQ(1u, gSpectrumCalls);
+    EXPECT_EQ(sweep.data(), gSpectrumResult.list);
+
+    otai_metadata_spectrum_stats_t stats;
+
+    EXPECT_EQ(OTAI_STATUS_UNINITIALIZED, otai_metadata_spectrum_get_stats(&stats));
+
+    gSpectrumStopInHandler = false;
+}
+
+TEST(OtaiSpectrumTest, handler_per_linecard)
+{
+    otai_linecard_ocm_spectrum_power_notification_fn notify = spectrum_test_wrap();
+
+    otai_attribute_t attr;
+
+    attr.id = OTAI_LINECARD_ATTR_LINECARD_OCM_SPECTRUM_POWER_NOTIFY;
+    attr.value.ptr = (otai_pointer_t)spectrum_test_on_other_ocm_spectrum_power;
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_spectrum_wrap_attr_list(OTAI_OBJECT_TYPE_LINECARD, OTAI_NULL_OBJECT_ID, 1, &attr));
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_spectrum_bind_linecard(SPECTRUM_TEST_OTHER_LINECARD));
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_spectrum_bind_linecard(SPECTRUM_TEST_OTHER_LINECARD));
+
+    gSpectrumOtherCalls = 0;
+
+    otai_metadata_spectrum_config_t config = spectrum_test_config(4, 2, 8);
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_spectrum_start(&config));
+
+    std::vector<otai_spectrum_power_t> sweep = spectrum_test_sweep(4, -10);
+
+    otai_spectrum_power_list_t list;
+
+    list.count = (uint32_t)sweep.size();
+    list.list = sweep.data();
+
+    /* each linecard's sweeps go to its own handler */
+
+    spectrum_test_notify(notify, SPECTRUM_TEST_OCM(0), sweep);
+    notify(SPECTRUM_TEST_OTHER_LINECARD, SPECTRUM_TEST_OCM(1), list);
+
+    EXPECT_EQ(1u, gSpectrumCalls);
+    EXPECT_EQ(1u, gSpectrumOtherCalls);
+
+    const otai_metadata_spectrum_sweep_t *cached = otai_metadata_spectrum_borrow(SPECTRUM_TEST_OCM(1));
+
+    ASSERT_NE(nullptr, cached);
+    EXPECT_EQ(SPECTRUM_TEST_OTHER_LINECARD, cached->linecardid);
+
+    otai_metadata_spectrum_release(cached);
+
+    /* removed linecard is still cached, but not notified */
+
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_spectrum_remove_linecard(SPECTRUM_TEST_OTHER_LINECARD));
+    EXPECT_EQ(OTAI_STATUS_ITEM_NOT_FOUND, otai_metadata_spectrum_remove_linecard(SPECTRUM_TEST_OTHER_LINECARD));
+
+    notify(SPECTRUM_TEST_OTHER_LINECARD, SPECTRUM_TEST_OCM(1), list);
+
+    EXPECT_EQ(1u, gSpectrumCalls);
+    EXPECT_EQ(1u, gSpectrumOtherCalls);
+    EXPECT_EQ(2u, otai_metadata_spectrum_get_version(SPECTRUM_TEST_OCM(1)));
+
+    otai_metadata_spectrum_stop();
+}
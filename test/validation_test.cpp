@@ -0,0 +1,297 @@
+#include <gtest/gtest.h>
+#include <stddef.h>
+#include <string.h>
+#include <vector>
+
+extern "C" {
+#include "otaimetadata.h"
+#include "otaimetadatavalidation.h"
+}
+
+#define VALIDATION_TEST_CUSTOM_ATTR OTAI_LINECARD_ATTR_CUSTOM_RANGE_START
+
+static bool validation_test_is_scalar(
+        _In_ const otai_attr_metadata_t *md)
+{
+    return !md->isreadonly && (md->attrvaluetype == OTAI_ATTR_VALUE_TYPE_BOOL ||
+            md->attrvaluetype == OTAI_ATTR_VALUE_TYPE_INT32 ||
+            md->attrvaluetype == OTAI_ATTR_VALUE_TYPE_UINT32);
+}
+
+static otai_attribute_value_t validation_test_value(
+        _In_ const otai_attr_metadata_t *md,
+        _In_ int32_t value)
+{
+    otai_attribute_value_t result;
+
+    memset(&result, 0, sizeof(result));
+
+    switch (md->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_BOOL:
+            result.booldata = (value != 0);
+            break;
+
+        case OTAI_ATTR_VALUE_TYPE_INT32:
+            result.s32 = value;
+            break;
+
+        default:
+            result.u32 = (uint32_t)value;
+            break;
+    }
+
+    return result;
+}
+
+static otai_attribute_t validation_test_attr(
+        _In_ const otai_attr_metadata_t *md,
+        _In_ int32_t value)
+{
+    otai_attribute_t attr;
+
+    attr.id = md->attrid;
+    attr.value = validation_test_value(md, value);
+
+    return attr;
+}
+
+/*
+ * Finds two settable scalar attributes of the same object type, used as
+ * condition attributes.
+ */
+static bool validation_test_find_pair(
+        _Out_ const otai_attr_metadata_t **first,
+        _Out_ const otai_attr_metadata_t **second)
+{
+    for (size_t i = 0; i < otai_metadata_attr_sorted_by_id_name_count; ++i)
+    {
+        *first = otai_metadata_attr_sorted_by_id_name[i];
+
+        for (size_t j = 0; validation_test_is_scalar(*first) && j < otai_metadata_attr_sorted_by_id_name_count; ++j)
+        {
+            *second = otai_metadata_attr_sorted_by_id_name[j];
+
+            if (*second != *first && (*second)->objecttype == (*first)->objecttype && validation_test_is_scalar(*second))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+TEST(OtaiValidationTest, duplicate_attributes)
+{
+    otai_metadata_validation_context_t context;
+
+    otai_attribute_t attrs[4];
+
+    memset(attrs, 0, sizeof(attrs));
+
+    attrs[0].id = 0;
+    attrs[1].id = 1;
+    attrs[2].id = VALIDATION_TEST_CUSTOM_ATTR;
+    attrs[3].id = 0;
+
+    EXPECT_EQ(OTAI_METADATA_VALIDATION_ATTR_STATUS(OTAI_STATUS_INVALID_ATTRIBUTE_0, 3),
+            otai_metadata_validation_context_init(&context, OTAI_OBJECT_TYPE_LINECARD, 4, attrs));
+
+    /* attribute which is not indexed is searched on list */
+
+    attrs[3].id = VALIDATION_TEST_CUSTOM_ATTR;
+
+    EXPECT_EQ(OTAI_METADATA_VALIDATION_ATTR_STATUS(OTAI_STATUS_INVALID_ATTRIBUTE_0, 3),
+            otai_metadata_validation_context_init(&context, OTAI_OBJECT_TYPE_LINECARD, 4, attrs));
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_validation_context_init(&context, OTAI_OBJECT_TYPE_LINECARD, 3, attrs));
+
+    EXPECT_EQ(&attrs[1], otai_metadata_validation_context_get_attr(&context, 1));
+    EXPECT_EQ(&attrs[2], otai_metadata_validation_context_get_attr(&context, VALIDATION_TEST_CUSTOM_ATTR));
+    EXPECT_EQ(nullptr, otai_metadata_validation_context_get_attr(&context, 2));
+
+    EXPECT_EQ(OTAI_STATUS_INVALID_OBJECT_TYPE,
+            otai_metadata_validation_context_init(&context, OTAI_OBJECT_TYPE_NULL, 3, attrs));
+}
+
+TEST(OtaiValidationTest, conditions_agree)
+{
+    const otai_attr_metadata_t *first;
+    const otai_attr_metadata_t *second;
+
+    ASSERT_TRUE(validation_test_find_pair(&first, &second));
+
+    /*
+     * Metadata of attribute conditional on first == 1 and second == 2,
+     * condition pointers are const, so copy is patched in place.
+     */
+
+    const otai_attr_condition_t cfirst = { first->attrid, validation_test_value(first, 1) };
+    const otai_attr_condition_t csecond = { second->attrid, validation_test_value(second, 2) };
+
+    const otai_attr_condition_t *conditions[] = { &cfirst, &csecond };
+
+    const otai_attr_condition_t * const *list = conditions;
+
+    std::vector<char> storage(sizeof(otai_attr_metadata_t));
+
+    memcpy(storage.data(), first, sizeof(otai_attr_metadata_t));
+    memcpy(storage.data() + offsetof(otai_attr_metadata_t, conditions), &list, sizeof(list));
+    memcpy(storage.data() + offsetof(otai_attr_metadata_t, validonly), &list, sizeof(list));
+
+    otai_attr_metadata_t *md = (otai_attr_metadata_t*)storage.data();
+
+    md->conditionslength = 2;
+    md->validonlylength = 2;
+    md->isconditional = true;
+    md->isvalidonly = true;
+
+    /* none, either or both condition attributes, with matching values or not */
+
+    for (int type = OTAI_ATTR_CONDITION_TYPE_OR; type <= OTAI_ATTR_CONDITION_TYPE_AND; ++type)
+    {
+        md->conditiontype = (otai_attr_condition_type_t)type;
+        md->validonlytype = (otai_attr_condition_type_t)type;
+
+        for (int variant = 0; variant < 9; ++variant)
+        {
+            otai_attribute_t attrs[2];
+
+            uint32_t count = 0;
+
+            if (variant % 3 != 0)
+            {
+                attrs[count++] = validation_test_attr(first, variant % 3 == 1 ? 1 : 5);
+            }
+
+            if (variant / 3 != 0)
+            {
+                attrs[count++] = validation_test_attr(second, variant / 3 == 1 ? 2 : 5);
+            }
+
+            otai_metadata_validation_context_t context;
+
+            ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_validation_context_init(&context, md->objecttype, count, attrs));
+
+            bool met = otai_metadata_is_condition_met(md, count, attrs);
+
+            EXPECT_EQ(met, otai_metadata_validation_context_is_condition_met(&context, md)) << type << " " << variant;
+            EXPECT_EQ(met, otai_metadata_validation_context_is_validonly_met(&context, md)) << type << " " << variant;
+        }
+    }
+
+    /* attribute without conditions is never met */
+
+    otai_metadata_validation_context_t context;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_validation_context_init(&context, first->objecttype, 0, NULL));
+
+    EXPECT_FALSE(otai_metadata_validation_context_is_condition_met(&context, first));
+    EXPECT_FALSE(otai_metadata_validation_context_is_validonly_met(&context, first));
+}
+
+TEST(OtaiValidationTest, conditional_on_create)
+{
+    /* each conditional attribute passed alone is accepted only when condition is met */
+
+    for (size_t i = 0; i < otai_metadata_attr_sorted_by_id_name_count; ++i)
+    {
+        const otai_attr_metadata_t *md = otai_metadata_attr_sorted_by_id_name[i];
+
+        if (!md->isconditional)
+        {
+            continue;
+        }
+
+        otai_attribute_t attr;
+
+        memset(&attr, 0, sizeof(attr));
+
+        attr.id = md->attrid;
+
+        otai_metadata_validation_context_t context;
+
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_validation_context_init(&context, md->objecttype, 1, &attr));
+
+        otai_status_t status = otai_metadata_validation_context_check_create(&context);
+
+        if (otai_metadata_is_condition_met(md, 1, &attr))
+        {
+            EXPECT_NE(OTAI_METADATA_VALIDATION_ATTR_STATUS(OTAI_STATUS_INVALID_ATTRIBUTE_0, 0), status) << md->attridname;
+        }
+        else
+        {
+            EXPECT_EQ(OTAI_METADATA_VALIDATION_ATTR_STATUS(OTAI_STATUS_INVALID_ATTRIBUTE_0, 0), status) << md->attridname;
+        }
+    }
+}
+
+TEST(OtaiValidationTest, mandatory_on_create)
+{
+    const otai_attr_metadata_t *mandatory = NULL;
+
+    for (size_t i = 0; mandatory == NULL && i < otai_metadata_attr_sorted_by_id_name_count; ++i)
+    {
+        const otai_attr_metadata_t *md = otai_metadata_attr_sorted_by_id_name[i];
+
+        if (md->ismandatoryoncreate && !md->isconditional)
+        {
+            mandatory = md;
+        }
+    }
+
+    ASSERT_NE(nullptr, mandatory);
+
+    const otai_object_type_info_t *info = otai_metadata_get_object_type_info(mandatory->objecttype);
+
+    std::vector<otai_attribute_t> attrs;
+
+    for (size_t i = 0; i < info->attrmetadatalength; ++i)
+    {
+        const otai_attr_metadata_t *md = info->attrmetadata[i];
+
+        if (md->ismandatoryoncreate && !md->isconditional)
+        {
+            otai_attribute_t attr;
+
+            memset(&attr, 0, sizeof(attr));
+
+            attr.id = md->attrid;
+
+            attrs.push_back(attr);
+        }
+    }
+
+    otai_metadata_validation_context_t context;
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_validation_context_init(&context, info->objecttype, (uint32_t)attrs.size(), attrs.data()));
+    EXPECT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_validation_context_check_create(&context));
+
+    /* each mandatory attribute left out */
+
+    for (size_t i = 0; i < attrs.size(); ++i)
+    {
+        std::vector<otai_attribute_t> missing(attrs);
+
+        missing.erase(missing.begin() + (ptrdiff_t)i);
+
+        ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_validation_context_init(&context, info->objecttype,
+                    (uint32_t)missing.size(), missing.data()));
+        EXPECT_EQ(OTAI_STATUS_MANDATORY_ATTRIBUTE_MISSING, otai_metadata_validation_context_check_create(&context));
+    }
+
+    /* attribute without metadata */
+
+    otai_attribute_t unknown;
+
+    memset(&unknown, 0, sizeof(unknown));
+
+    unknown.id = info->attridend + 1;
+
+    attrs.push_back(unknown);
+
+    ASSERT_EQ(OTAI_STATUS_SUCCESS, otai_metadata_validation_context_init(&context, info->objecttype, (uint32_t)attrs.size(), attrs.data()));
+    EXPECT_EQ(OTAI_METADATA_VALIDATION_ATTR_STATUS(OTAI_STATUS_UNKNOWN_ATTRIBUTE_0, attrs.size() - 1),
+            otai_metadata_validation_context_check_create(&context));
+}
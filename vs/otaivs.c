@@ -0,0 +1,2600 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaivs.c
+ *
+ * @brief   This module implements OTAI virtual adapter
+ */
+
+/* clock_gettime and clock_nanosleep are not declared in strict ANSI mode */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <time.h>
+#include <pthread.h>
+#include "otaimetadata.h"
+#include "otaimetadatalogger.h"
+#include "otaimetadatacompact.h"
+#include "otaimetadatainstrument.h"
+#include "otaimetadatavalidation.h"
+#include "otaivs.h"
+
+/*
+ * Object id has object type in bits 63-56, linecard index in bits 55-40
+ * and object index in bits 39-0. Linecard object index is 0.
+ */
+#define OTAI_VS_TYPE_SHIFT 56
+#define OTAI_VS_LINECARD_SHIFT 40
+#define OTAI_VS_LINECARD_MASK UINT64_C(0xFFFF)
+#define OTAI_VS_INDEX_MASK ((UINT64_C(1) << OTAI_VS_LINECARD_SHIFT) - 1)
+#define OTAI_VS_MAX_LINECARDS (OTAI_VS_LINECARD_MASK + 1)
+
+/* power of 2 */
+#define OTAI_VS_SHARDS 64
+
+#define OTAI_VS_INITIAL_BUCKETS 64
+
+/* shorter latencies are spun, since sleep overshoots them */
+#define OTAI_VS_SPIN_NS 20000
+
+#define OTAI_VS_LOAD(_ptr) __atomic_load_n((_ptr), __ATOMIC_RELAXED)
+#define OTAI_VS_STORE(_ptr, _val) __atomic_store_n((_ptr), (_val), __ATOMIC_RELAXED)
+#define OTAI_VS_ADD(_ptr, _val) __atomic_fetch_add((_ptr), (_val), __ATOMIC_RELAXED)
+#define OTAI_VS_SUB(_ptr, _val) __atomic_fetch_sub((_ptr), (_val), __ATOMIC_RELAXED)
+
+typedef struct _otai_vs_stat_base_t
+{
+    otai_stat_id_t id;
+
+    /* raw generator value at last clear */
+    otai_stat_value_t value;
+
+} otai_vs_stat_base_t;
+
+/*
+ * Object is single allocation, compact attribute array and heap follow
+ * object, so object is reallocated when attribute doesn't fit.
+ */
+typedef struct _otai_vs_object_t
+{
+    struct _otai_vs_object_t *next;
+
+    otai_object_id_t oid;
+
+    /* time of create, statistics are generated from it */
+    uint64_t created;
+
+    /* bytes of object allocation */
+    uint64_t size;
+
+    /* number of objects of linecard */
+    uint64_t children;
+
+    uint32_t basecount;
+
+    otai_vs_stat_base_t *bases;
+
+    otai_compact_attribute_list_t attrs;
+
+} otai_vs_object_t;
+
+typedef struct _otai_vs_shard_t
+{
+    pthread_mutex_t mutex;
+
+    otai_vs_object_t **buckets;
+
+    uint64_t mask;
+
+    uint64_t count;
+
+    /* shards are locked by different threads */
+    uint8_t pad[64];
+
+} otai_vs_shard_t;
+
+typedef struct _otai_vs_fault_slot_t
+{
+    uint64_t latency;
+
+    uint64_t jitter;
+
+    /* failure when 32 bit random number is below */
+    uint64_t threshold;
+
+    otai_status_t status;
+
+} otai_vs_fault_slot_t;
+
+typedef struct _otai_vs_t
+{
+    bool initialized;
+
+    otai_vs_shard_t shards[OTAI_VS_SHARDS];
+
+    uint64_t nextlinecard;
+
+    uint64_t nextindex;
+
+    uint64_t objects[OTAI_OBJECT_TYPE_MAX];
+
+    uint64_t memory;
+
+    otai_vs_fault_slot_t faults[OTAI_OBJECT_TYPE_MAX];
+
+    otai_vs_stats_generator_fn generators[OTAI_OBJECT_TYPE_MAX];
+
+    uint64_t seed;
+
+    uint64_t sequence;
+
+} otai_vs_t;
+
+static otai_vs_t otai_vs_global;
+
+static pthread_mutex_t otai_vs_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static uint64_t otai_vs_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec * UINT64_C(1000000000) + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t otai_vs_mix(
+        _In_ uint64_t value)
+{
+    value ^= value >> 30;
+    value *= UINT64_C(0xbf58476d1ce4e5b9);
+    value ^= value >> 27;
+    value *= UINT64_C(0x94d049bb133111eb);
+    value ^= value >> 31;
+
+    return value;
+}
+
+static uint64_t otai_vs_random(void)
+{
+    uint64_t sequence = OTAI_VS_ADD(&otai_vs_global.sequence, 1);
+
+    return otai_vs_mix(sequence + OTAI_VS_LOAD(&otai_vs_global.seed));
+}
+
+static bool otai_vs_is_initialized(void)
+{
+    return __atomic_load_n(&otai_vs_global.initialized, __ATOMIC_ACQUIRE);
+}
+
+static otai_object_type_t otai_vs_object_type(
+        _In_ otai_object_id_t object_id)
+{
+    uint64_t type = object_id >> OTAI_VS_TYPE_SHIFT;
+
+    if (type == OTAI_OBJECT_TYPE_NULL || type >= OTAI_OBJECT_TYPE_MAX)
+    {
+        return OTAI_OBJECT_TYPE_NULL;
+    }
+
+    return (otai_object_type_t)type;
+}
+
+static otai_object_id_t otai_vs_make_oid(
+        _In_ otai_object_type_t object_type,
+        _In_ uint64_t linecard,
+        _In_ uint64_t index)
+{
+    return ((uint64_t)object_type << OTAI_VS_TYPE_SHIFT) |
+        ((linecard & OTAI_VS_LINECARD_MASK) << OTAI_VS_LINECARD_SHIFT) |
+        (index & OTAI_VS_INDEX_MASK);
+}
+
+static otai_object_id_t otai_vs_linecard_oid(
+        _In_ otai_object_id_t object_id)
+{
+    return otai_vs_make_oid(OTAI_OBJECT_TYPE_LINECARD,
+            (object_id >> OTAI_VS_LINECARD_SHIFT) & OTAI_VS_LINECARD_MASK, 0);
+}
+
+/* faults */
+
+static void otai_vs_store_fault(
+        _In_ otai_object_type_t object_type,
+        _In_ const otai_vs_fault_t *fault)
+{
+    otai_vs_fault_slot_t *slot = &otai_vs_global.faults[object_type];
+
+    OTAI_VS_STORE(&slot->latency, fault->latency);
+    OTAI_VS_STORE(&slot->jitter, fault->jitter);
+    OTAI_VS_STORE(&slot->threshold, (uint64_t)(fault->failurerate * 4294967296.0));
+    OTAI_VS_STORE(&slot->status, fault->failurestatus == OTAI_STATUS_SUCCESS ? OTAI_STATUS_FAILURE : fault->failurestatus);
+}
+
+otai_status_t otai_vs_set_fault(
+        _In_ otai_object_type_t object_type,
+        _In_ const otai_vs_fault_t *fault)
+{
+    if (fault == NULL || object_type >= OTAI_OBJECT_TYPE_MAX ||
+            !(fault->failurerate >= 0 && fault->failurerate <= 1))
+    {
+        OTAI_META_LOG_ERROR("invalid fault profile of object type %d", object_type);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (object_type != OTAI_OBJECT_TYPE_NULL)
+    {
+        otai_vs_store_fault(object_type, fault);
+
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    int type = OTAI_OBJECT_TYPE_NULL + 1;
+
+    for (; type < OTAI_OBJECT_TYPE_MAX; type++)
+    {
+        otai_vs_store_fault((otai_object_type_t)type, fault);
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static void otai_vs_delay(
+        _In_ otai_object_type_t object_type)
+{
+    const otai_vs_fault_slot_t *slot = &otai_vs_global.faults[object_type];
+
+    uint64_t delay = OTAI_VS_LOAD(&slot->latency);
+    uint64_t jitter = OTAI_VS_LOAD(&slot->jitter);
+
+    if (jitter != 0)
+    {
+        delay += otai_vs_random() % (jitter + 1);
+    }
+
+    if (delay == 0)
+    {
+        return;
+    }
+
+    if (delay < OTAI_VS_SPIN_NS)
+    {
+        uint64_t end = otai_vs_now() + delay;
+
+        while (otai_vs_now() < end)
+        {
+        }
+
+        return;
+    }
+
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(delay / UINT64_C(1000000000));
+    ts.tv_nsec = (long)(delay % UINT64_C(1000000000));
+
+    clock_nanosleep(CLOCK_MONOTONIC, 0, &ts, NULL);
+}
+
+/*
+ * Returns status of injected failure, or success.
+ */
+static otai_status_t otai_vs_fail(
+        _In_ otai_object_type_t object_type)
+{
+    const otai_vs_fault_slot_t *slot = &otai_vs_global.faults[object_type];
+
+    uint64_t threshold = OTAI_VS_LOAD(&slot->threshold);
+
+    if (threshold == 0 || (otai_vs_random() >> 32) >= threshold)
+    {
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    return OTAI_VS_LOAD(&slot->status);
+}
+
+/* statistics generators */
+
+otai_status_t otai_vs_set_stats_generator(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_vs_stats_generator_fn generator)
+{
+    if (object_type >= OTAI_OBJECT_TYPE_MAX)
+    {
+        OTAI_META_LOG_ERROR("invalid object type %d", object_type);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    int type = object_type == OTAI_OBJECT_TYPE_NULL ? OTAI_OBJECT_TYPE_NULL + 1 : (int)object_type;
+
+    for (; type < OTAI_OBJECT_TYPE_MAX; type++)
+    {
+        __atomic_store_n(&otai_vs_global.generators[type], generator, __ATOMIC_RELEASE);
+
+        if (object_type != OTAI_OBJECT_TYPE_NULL)
+        {
+            break;
+        }
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+void otai_vs_default_stats_generator(
+        _In_ otai_object_id_t object_id,
+        _In_ const otai_stat_metadata_t *metadata,
+        _In_ uint64_t elapsed,
+        _Out_ otai_stat_value_t *value)
+{
+    uint64_t hash = otai_vs_mix(object_id ^ otai_vs_mix((uint64_t)metadata->statid + 1));
+
+    uint64_t ms = elapsed / 1000000;
+
+    if (metadata->statvalueiscounter)
+    {
+        /* 1 to 1000000 per second */
+        uint64_t count = ms * (hash % 1000000 + 1) / 1000;
+
+        switch (metadata->statvaluetype)
+        {
+            case OTAI_STAT_VALUE_TYPE_INT32:
+                value->s32 = (int32_t)(count & 0x7FFFFFFF);
+                break;
+            case OTAI_STAT_VALUE_TYPE_UINT32:
+                value->u32 = (uint32_t)count;
+                break;
+            case OTAI_STAT_VALUE_TYPE_INT64:
+                value->s64 = (int64_t)(count & INT64_MAX);
+                break;
+            case OTAI_STAT_VALUE_TYPE_DOUBLE:
+                value->d64 = (double)count;
+                break;
+            default:
+                value->u64 = count;
+                break;
+        }
+
+        return;
+    }
+
+    /* level of object and counter, with triangle wave of 60 s period */
+    uint64_t phase = (ms + hash) % 60000;
+    uint64_t wave = phase < 30000 ? phase : 60000 - phase;
+
+    switch (metadata->statvaluetype)
+    {
+        case OTAI_STAT_VALUE_TYPE_INT32:
+            value->s32 = (int32_t)(hash % 1000) - 500 + (int32_t)(wave / 1000);
+            break;
+        case OTAI_STAT_VALUE_TYPE_UINT32:
+            value->u32 = (uint32_t)(hash % 1000 + wave / 1000);
+            break;
+        case OTAI_STAT_VALUE_TYPE_INT64:
+            value->s64 = (int64_t)(hash % 1000) - 500 + (int64_t)(wave / 1000);
+            break;
+        case OTAI_STAT_VALUE_TYPE_DOUBLE:
+            value->d64 = (double)(hash % 4000) / 100.0 - 20.0 + (double)wave / 10000.0;
+            break;
+        default:
+            value->u64 = hash % 1000 + wave / 1000;
+            break;
+    }
+}
+
+/* values */
+
+static size_t otai_vs_item_size(
+        _In_ otai_attr_value_type_t attr_value_type)
+{
+    switch (attr_value_type)
+    {
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            return sizeof(uint8_t);
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            return sizeof(int8_t);
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            return sizeof(uint16_t);
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            return sizeof(int16_t);
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            return sizeof(uint32_t);
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            return sizeof(int32_t);
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            return sizeof(otai_object_id_t);
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            return sizeof(otai_spectrum_power_t);
+        default:
+            return 0;
+    }
+}
+
+/*
+ * Gets count and items of list value, false is returned if attribute
+ * value type is not a list.
+ */
+static bool otai_vs_get_list(
+        _In_ otai_attr_value_type_t attr_value_type,
+        _In_ const otai_attribute_value_t *value,
+        _Out_ uint32_t *count,
+        _Out_ const void **items)
+{
+    switch (attr_value_type)
+    {
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            *count = value->objlist.count;
+            *items = value->objlist.list;
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            *count = value->u8list.count;
+            *items = value->u8list.list;
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            *count = value->s8list.count;
+            *items = value->s8list.list;
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            *count = value->u16list.count;
+            *items = value->u16list.list;
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            *count = value->s16list.count;
+            *items = value->s16list.list;
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            *count = value->u32list.count;
+            *items = value->u32list.list;
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            *count = value->s32list.count;
+            *items = value->s32list.list;
+            return true;
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            *count = value->spectrumpowerlist.count;
+            *items = value->spectrumpowerlist.list;
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*
+ * Gets count and items of caller list value to be filled, NULL is
+ * returned if attribute value type is not a list.
+ */
+static uint32_t* otai_vs_get_out_list(
+        _In_ otai_attr_value_type_t attr_value_type,
+        _Inout_ otai_attribute_value_t *value,
+        _Out_ void **items)
+{
+    switch (attr_value_type)
+    {
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            *items = value->objlist.list;
+            return &value->objlist.count;
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            *items = value->u8list.list;
+            return &value->u8list.count;
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            *items = value->s8list.list;
+            return &value->s8list.count;
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            *items = value->u16list.list;
+            return &value->u16list.count;
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            *items = value->s16list.list;
+            return &value->s16list.count;
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            *items = value->u32list.list;
+            return &value->u32list.count;
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            *items = value->s32list.list;
+            return &value->s32list.count;
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            *items = value->spectrumpowerlist.list;
+            return &value->spectrumpowerlist.count;
+        default:
+            *items = NULL;
+            return NULL;
+    }
+}
+
+/*
+ * Copies list items to caller list, or sets required count and returns
+ * buffer overflow.
+ */
+static otai_status_t otai_vs_copy_list(
+        _In_ const otai_attr_metadata_t *metadata,
+        _In_ uint32_t count,
+        _In_ const void *items,
+        _Inout_ otai_attribute_value_t *value)
+{
+    void *list;
+
+    uint32_t *listcount = otai_vs_get_out_list(metadata->attrvaluetype, value, &list);
+
+    if (*listcount < count)
+    {
+        *listcount = count;
+
+        return OTAI_STATUS_BUFFER_OVERFLOW;
+    }
+
+    if (count != 0)
+    {
+        if (list == NULL)
+        {
+            return OTAI_STATUS_INVALID_PARAMETER;
+        }
+
+        memcpy(list, items, count * otai_vs_item_size(metadata->attrvaluetype));
+    }
+
+    *listcount = count;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static void otai_vs_copy_scalar(
+        _In_ const otai_attr_metadata_t *metadata,
+        _In_ const otai_attribute_value_t *src,
+        _Inout_ otai_attribute_value_t *dst)
+{
+    switch (metadata->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_BOOL:
+            dst->booldata = src->booldata;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_CHARDATA:
+            strcpy(dst->chardata, src->chardata);
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT8:
+            dst->u8 = src->u8;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT8:
+            dst->s8 = src->s8;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT16:
+            dst->u16 = src->u16;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT16:
+            dst->s16 = src->s16;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT32:
+            dst->u32 = src->u32;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT32:
+            dst->s32 = src->s32;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT64:
+            dst->u64 = src->u64;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT64:
+            dst->s64 = src->s64;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_DOUBLE:
+            dst->d64 = src->d64;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_POINTER:
+            dst->ptr = src->ptr;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_ID:
+            dst->oid = src->oid;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT32_RANGE:
+            dst->u32range = src->u32range;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT32_RANGE:
+            dst->s32range = src->s32range;
+            break;
+        default:
+            break;
+    }
+}
+
+/*
+ * Heap bytes of value in compact list, with alignment.
+ */
+static size_t otai_vs_value_size(
+        _In_ const otai_attr_metadata_t *metadata,
+        _In_ const otai_attribute_value_t *value)
+{
+    uint32_t count;
+    const void *items;
+
+    if (metadata->attrvaluetype == OTAI_ATTR_VALUE_TYPE_CHARDATA)
+    {
+        return strlen(value->chardata) + 1 + sizeof(uint64_t);
+    }
+
+    if (otai_vs_get_list(metadata->attrvaluetype, value, &count, &items))
+    {
+        return count * otai_vs_item_size(metadata->attrvaluetype) + sizeof(uint64_t);
+    }
+
+    return 0;
+}
+
+/* objects */
+
+static otai_vs_shard_t* otai_vs_get_shard(
+        _In_ otai_object_id_t object_id)
+{
+    return &otai_vs_global.shards[otai_vs_mix(object_id) & (OTAI_VS_SHARDS - 1)];
+}
+
+/*
+ * Returns link to object in shard, whose value is NULL if object is not
+ * found. Shard must be locked.
+ */
+static otai_vs_object_t** otai_vs_find(
+        _In_ otai_vs_shard_t *shard,
+        _In_ otai_object_id_t object_id)
+{
+    otai_vs_object_t **link = &shard->buckets[otai_vs_mix(object_id >> 8 ^ object_id) & shard->mask];
+
+    while (*link != NULL && (*link)->oid != object_id)
+    {
+        link = &(*link)->next;
+    }
+
+    return link;
+}
+
+static otai_status_t otai_vs_insert(
+        _In_ otai_vs_shard_t *shard,
+        _In_ otai_vs_object_t *object)
+{
+    if (shard->count >= 2 * (shard->mask + 1))
+    {
+        uint64_t mask = 2 * shard->mask + 1;
+
+        otai_vs_object_t **buckets = calloc(mask + 1, sizeof(otai_vs_object_t*));
+
+        if (buckets != NULL)
+        {
+            uint64_t idx = 0;
+
+            for (; idx <= shard->mask; idx++)
+            {
+                while (shard->buckets[idx] != NULL)
+                {
+                    otai_vs_object_t *moved = shard->buckets[idx];
+
+                    shard->buckets[idx] = moved->next;
+
+                    otai_vs_object_t **bucket = &buckets[otai_vs_mix(moved->oid >> 8 ^ moved->oid) & mask];
+
+                    moved->next = *bucket;
+                    *bucket = moved;
+                }
+            }
+
+            free(shard->buckets);
+
+            shard->buckets = buckets;
+            shard->mask = mask;
+        }
+    }
+
+    otai_vs_object_t **link = otai_vs_find(shard, object->oid);
+
+    if (*link != NULL)
+    {
+        return OTAI_STATUS_ITEM_ALREADY_EXISTS;
+    }
+
+    *link = object;
+    shard->count++;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static bool otai_vs_exists(
+        _In_ otai_object_id_t object_id)
+{
+    otai_vs_shard_t *shard = otai_vs_get_shard(object_id);
+
+    pthread_mutex_lock(&shard->mutex);
+
+    bool exists = *otai_vs_find(shard, object_id) != NULL;
+
+    pthread_mutex_unlock(&shard->mutex);
+
+    return exists;
+}
+
+/*
+ * Allocates object with empty compact list of given capacity.
+ */
+static otai_vs_object_t* otai_vs_alloc_object(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t object_id,
+        _In_ uint32_t capacity,
+        _In_ size_t heap_size)
+{
+    size_t size = sizeof(otai_vs_object_t) + capacity * sizeof(otai_compact_attribute_t) + heap_size;
+
+    otai_vs_object_t *object = calloc(1, size);
+
+    if (object == NULL)
+    {
+        return NULL;
+    }
+
+    otai_compact_attribute_t *attrs = (otai_compact_attribute_t*)(void*)(object + 1);
+
+    otai_metadata_compact_list_init(&object->attrs, object_type, capacity, attrs,
+            heap_size, (uint8_t*)(void*)(attrs + capacity));
+
+    object->oid = object_id;
+    object->size = size;
+
+    return object;
+}
+
+/*
+ * Builds object of attribute list, heap is grown while it doesn't fit.
+ */
+static otai_vs_object_t* otai_vs_build_object(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t object_id,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    size_t heap_size = 0;
+
+    uint32_t idx = 0;
+
+    for (; idx < attr_count; idx++)
+    {
+        const otai_attr_metadata_t *md = otai_metadata_get_attr_metadata(object_type, attr_list[idx].id);
+
+        heap_size += otai_vs_value_size(md, &attr_list[idx].value);
+    }
+
+    while (true)
+    {
+        otai_vs_object_t *object = otai_vs_alloc_object(object_type, object_id, attr_count, heap_size);
+
+        if (object == NULL)
+        {
+            return NULL;
+        }
+
+        otai_status_t status = otai_metadata_compact_list_from_attr_list(&object->attrs, attr_count, attr_list);
+
+        if (status == OTAI_STATUS_SUCCESS)
+        {
+            return object;
+        }
+
+        free(object);
+
+        if (status != OTAI_STATUS_BUFFER_OVERFLOW)
+        {
+            OTAI_META_LOG_ERROR("failed to store attributes of object 0x%" PRIx64 ": %d", object_id, status);
+
+            return NULL;
+        }
+
+        heap_size = 2 * heap_size + sizeof(uint64_t);
+    }
+}
+
+/*
+ * Builds copy of object with attribute replaced or added.
+ */
+static otai_vs_object_t* otai_vs_rebuild_object(
+        _In_ const otai_vs_object_t *object,
+        _In_ const otai_attr_metadata_t *metadata,
+        _In_ const otai_attribute_t *attr)
+{
+    const otai_compact_attribute_list_t *list = &object->attrs;
+
+    uint32_t capacity = list->attrcount + 1;
+
+    size_t heap_size = list->heapused + otai_vs_value_size(metadata, &attr->value) + capacity * sizeof(uint64_t);
+
+    while (true)
+    {
+        otai_vs_object_t *copy = otai_vs_alloc_object(list->objecttype, object->oid, capacity, heap_size);
+
+        if (copy == NULL)
+        {
+            return NULL;
+        }
+
+        otai_status_t status = OTAI_STATUS_SUCCESS;
+
+        uint32_t idx = 0;
+
+        for (; idx < list->attrcount && status == OTAI_STATUS_SUCCESS; idx++)
+        {
+            otai_attribute_t item;
+
+            if (list->attrlist[idx].id == attr->id)
+            {
+                continue;
+            }
+
+            status = otai_metadata_compact_list_get_attr(list, &list->attrlist[idx], &item);
+
+            if (status == OTAI_STATUS_SUCCESS)
+            {
+                status = otai_metadata_compact_list_append(&copy->attrs, &item);
+            }
+        }
+
+        if (status == OTAI_STATUS_SUCCESS)
+        {
+            status = otai_metadata_compact_list_append(&copy->attrs, attr);
+        }
+
+        if (status == OTAI_STATUS_SUCCESS)
+        {
+            copy->created = object->created;
+            copy->children = object->children;
+            copy->basecount = object->basecount;
+            copy->bases = object->bases;
+
+            return copy;
+        }
+
+        free(copy);
+
+        if (status != OTAI_STATUS_BUFFER_OVERFLOW)
+        {
+            OTAI_META_LOG_ERROR("failed to store attribute %s: %d", metadata->attridname, status);
+
+            return NULL;
+        }
+
+        heap_size *= 2;
+    }
+}
+
+static void otai_vs_free_object(
+        _In_ otai_vs_object_t *object)
+{
+    OTAI_VS_SUB(&otai_vs_global.memory, object->size + object->basecount * sizeof(otai_vs_stat_base_t));
+    OTAI_VS_SUB(&otai_vs_global.objects[object->attrs.objecttype], 1);
+
+    free(object->bases);
+    free(object);
+}
+
+/* validation */
+
+static bool otai_vs_is_valid_oid(
+        _In_ const otai_attr_metadata_t *metadata,
+        _In_ otai_object_id_t object_id)
+{
+    if (object_id == OTAI_NULL_OBJECT_ID)
+    {
+        return metadata->allownullobjectid;
+    }
+
+    return otai_metadata_is_allowed_object_type(metadata, otai_vs_object_type(object_id)) &&
+        otai_vs_exists(object_id);
+}
+
+/*
+ * Checks attribute value against metadata, no shard may be locked, since
+ * object id values are looked up.
+ */
+static bool otai_vs_is_valid_value(
+        _In_ const otai_attr_metadata_t *metadata,
+        _In_ const otai_attribute_value_t *value)
+{
+    uint32_t count;
+    const void *items;
+
+    if (metadata->attrvaluetype == OTAI_ATTR_VALUE_TYPE_CHARDATA)
+    {
+        return memchr(value->chardata, 0, sizeof(value->chardata)) != NULL;
+    }
+
+    if (metadata->attrvaluetype == OTAI_ATTR_VALUE_TYPE_OBJECT_ID)
+    {
+        return otai_vs_is_valid_oid(metadata, value->oid);
+    }
+
+    if (metadata->isenum && !metadata->isenumlist)
+    {
+        return otai_metadata_is_allowed_enum_value(metadata, value->s32);
+    }
+
+    if (!otai_vs_get_list(metadata->attrvaluetype, value, &count, &items))
+    {
+        return true;
+    }
+
+    if (count != 0 && items == NULL)
+    {
+        return false;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < count; idx++)
+    {
+        if (metadata->isenumlist && !otai_metadata_is_allowed_enum_value(metadata, value->s32list.list[idx]))
+        {
+            return false;
+        }
+
+        if (metadata->attrvaluetype == OTAI_ATTR_VALUE_TYPE_OBJECT_LIST &&
+                (value->objlist.list[idx] == OTAI_NULL_OBJECT_ID || !otai_vs_is_valid_oid(metadata, value->objlist.list[idx])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static otai_status_t otai_vs_validate_create(
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    otai_metadata_validation_context_t context;
+
+    otai_status_t status = otai_metadata_validation_context_init(&context, object_type, attr_count, attr_list);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < attr_count; idx++)
+    {
+        const otai_attr_metadata_t *md = otai_metadata_get_attr_metadata(object_type, attr_list[idx].id);
+
+        if (md == NULL)
+        {
+            OTAI_META_LOG_ERROR("unknown attribute 0x%x of object type %d", attr_list[idx].id, object_type);
+
+            return OTAI_METADATA_VALIDATION_ATTR_STATUS(OTAI_STATUS_UNKNOWN_ATTRIBUTE_0, idx);
+        }
+
+        if (md->isreadonly)
+        {
+            OTAI_META_LOG_ERROR("attribute %s is read only", md->attridname);
+
+            return OTAI_METADATA_VALIDATION_ATTR_STATUS(OTAI_STATUS_INVALID_ATTRIBUTE_0, idx);
+        }
+
+        if (!otai_vs_is_valid_value(md, &attr_list[idx].value))
+        {
+            OTAI_META_LOG_ERROR("invalid value of attribute %s", md->attridname);
+
+            return OTAI_METADATA_VALIDATION_ATTR_STATUS(OTAI_STATUS_INVALID_ATTR_VALUE_0, idx);
+        }
+    }
+
+    return otai_metadata_validation_context_check_create(&context);
+}
+
+/* operations, without fault injection */
+
+static otai_status_t otai_vs_do_create(
+        _In_ otai_object_type_t object_type,
+        _Out_ otai_object_id_t *object_id,
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    if (object_id == NULL || (attr_count != 0 && attr_list == NULL))
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    otai_status_t status = otai_vs_validate_create(object_type, attr_count, attr_list);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    otai_object_id_t oid;
+
+    if (object_type == OTAI_OBJECT_TYPE_LINECARD)
+    {
+        uint64_t linecard = OTAI_VS_ADD(&otai_vs_global.nextlinecard, 1);
+
+        if (linecard >= OTAI_VS_MAX_LINECARDS)
+        {
+            OTAI_META_LOG_ERROR("no more than %d linecards can be created", (int)OTAI_VS_MAX_LINECARDS);
+
+            return OTAI_STATUS_INSUFFICIENT_RESOURCES;
+        }
+
+        oid = otai_vs_make_oid(OTAI_OBJECT_TYPE_LINECARD, linecard, 0);
+    }
+    else
+    {
+        if (otai_vs_object_type(linecard_id) != OTAI_OBJECT_TYPE_LINECARD ||
+                otai_vs_linecard_oid(linecard_id) != linecard_id)
+        {
+            OTAI_META_LOG_ERROR("invalid linecard 0x%" PRIx64, linecard_id);
+
+            return OTAI_STATUS_INVALID_OBJECT_ID;
+        }
+
+        otai_vs_shard_t *shard = otai_vs_get_shard(linecard_id);
+
+        pthread_mutex_lock(&shard->mutex);
+
+        otai_vs_object_t *linecard = *otai_vs_find(shard, linecard_id);
+
+        if (linecard != NULL)
+        {
+            linecard->children++;
+        }
+
+        pthread_mutex_unlock(&shard->mutex);
+
+        if (linecard == NULL)
+        {
+            OTAI_META_LOG_ERROR("linecard 0x%" PRIx64 " doesn't exist", linecard_id);
+
+            return OTAI_STATUS_INVALID_OBJECT_ID;
+        }
+
+        oid = otai_vs_make_oid(object_type, linecard_id >> OTAI_VS_LINECARD_SHIFT,
+                OTAI_VS_ADD(&otai_vs_global.nextindex, 1) + 1);
+    }
+
+    otai_vs_object_t *object = otai_vs_build_object(object_type, oid, attr_count, attr_list);
+
+    if (object != NULL)
+    {
+        object->created = otai_vs_now();
+
+        otai_vs_shard_t *shard = otai_vs_get_shard(oid);
+
+        pthread_mutex_lock(&shard->mutex);
+
+        status = otai_vs_insert(shard, object);
+
+        pthread_mutex_unlock(&shard->mutex);
+
+        if (status == OTAI_STATUS_SUCCESS)
+        {
+            OTAI_VS_ADD(&otai_vs_global.memory, object->size);
+            OTAI_VS_ADD(&otai_vs_global.objects[object_type], 1);
+
+            *object_id = oid;
+
+            return OTAI_STATUS_SUCCESS;
+        }
+
+        free(object);
+    }
+    else
+    {
+        status = OTAI_STATUS_NO_MEMORY;
+    }
+
+    if (object_type != OTAI_OBJECT_TYPE_LINECARD)
+    {
+        otai_vs_shard_t *shard = otai_vs_get_shard(linecard_id);
+
+        pthread_mutex_lock(&shard->mutex);
+
+        otai_vs_object_t *linecard = *otai_vs_find(shard, linecard_id);
+
+        linecard->children--;
+
+        pthread_mutex_unlock(&shard->mutex);
+    }
+
+    return status;
+}
+
+static otai_status_t otai_vs_do_remove(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t object_id)
+{
+    otai_vs_shard_t *shard = otai_vs_get_shard(object_id);
+
+    pthread_mutex_lock(&shard->mutex);
+
+    otai_vs_object_t **link = otai_vs_find(shard, object_id);
+
+    otai_vs_object_t *object = *link;
+
+    if (object == NULL || object->children != 0)
+    {
+        pthread_mutex_unlock(&shard->mutex);
+
+        if (object == NULL)
+        {
+            OTAI_META_LOG_ERROR("object 0x%" PRIx64 " doesn't exist", object_id);
+
+            return OTAI_STATUS_INVALID_OBJECT_ID;
+        }
+
+        OTAI_META_LOG_ERROR("linecard 0x%" PRIx64 " has %" PRIu64 " objects", object_id, object->children);
+
+        return OTAI_STATUS_OBJECT_IN_USE;
+    }
+
+    *link = object->next;
+    shard->count--;
+
+    pthread_mutex_unlock(&shard->mutex);
+
+    otai_vs_free_object(object);
+
+    if (object_type != OTAI_OBJECT_TYPE_LINECARD)
+    {
+        otai_object_id_t linecard_id = otai_vs_linecard_oid(object_id);
+
+        shard = otai_vs_get_shard(linecard_id);
+
+        pthread_mutex_lock(&shard->mutex);
+
+        otai_vs_object_t *linecard = *otai_vs_find(shard, linecard_id);
+
+        linecard->children--;
+
+        pthread_mutex_unlock(&shard->mutex);
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static otai_status_t otai_vs_do_set(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t object_id,
+        _In_ const otai_attribute_t *attr,
+        _In_ bool inject)
+{
+    if (attr == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    const otai_attr_metadata_t *md = otai_metadata_get_attr_metadata(object_type, attr->id);
+
+    if (md == NULL)
+    {
+        OTAI_META_LOG_ERROR("unknown attribute 0x%x of object type %d", attr->id, object_type);
+
+        return OTAI_STATUS_UNKNOWN_ATTRIBUTE_0;
+    }
+
+    if (!inject && (md->isreadonly || md->iscreateonly))
+    {
+        OTAI_META_LOG_ERROR("attribute %s can't be set", md->attridname);
+
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (!otai_vs_is_valid_value(md, &attr->value))
+    {
+        OTAI_META_LOG_ERROR("invalid value of attribute %s", md->attridname);
+
+        return OTAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    otai_status_t status = OTAI_STATUS_SUCCESS;
+
+    otai_vs_shard_t *shard = otai_vs_get_shard(object_id);
+
+    pthread_mutex_lock(&shard->mutex);
+
+    otai_vs_object_t **link = otai_vs_find(shard, object_id);
+
+    otai_vs_object_t *object = *link;
+
+    const otai_compact_attribute_t *compact = NULL;
+
+    if (object == NULL)
+    {
+        status = OTAI_STATUS_INVALID_OBJECT_ID;
+    }
+    else
+    {
+        compact = otai_metadata_compact_list_find(&object->attrs, attr->id);
+    }
+
+    if (compact != NULL && md->attrvaluetype != OTAI_ATTR_VALUE_TYPE_CHARDATA &&
+            otai_vs_item_size(md->attrvaluetype) == 0)
+    {
+        /* scalar is replaced in place, converted by single item list */
+        otai_compact_attribute_list_t scalar;
+        otai_compact_attribute_t value;
+
+        otai_metadata_compact_list_init(&scalar, object_type, 1, &value, 0, NULL);
+
+        status = otai_metadata_compact_list_append(&scalar, attr);
+
+        if (status == OTAI_STATUS_SUCCESS)
+        {
+            object->attrs.attrlist[compact - object->attrs.attrlist] = value;
+        }
+    }
+    else if (object != NULL)
+    {
+        otai_vs_object_t *copy = otai_vs_rebuild_object(object, md, attr);
+
+        if (copy == NULL)
+        {
+            status = OTAI_STATUS_NO_MEMORY;
+        }
+        else
+        {
+            copy->next = object->next;
+            *link = copy;
+
+            OTAI_VS_ADD(&otai_vs_global.memory, copy->size);
+            OTAI_VS_SUB(&otai_vs_global.memory, object->size);
+
+            free(object);
+        }
+    }
+
+    pthread_mutex_unlock(&shard->mutex);
+
+    return status;
+}
+
+/*
+ * Gets value of attribute which is not stored. Shard must be locked.
+ */
+static otai_status_t otai_vs_get_default(
+        _In_ const otai_attr_metadata_t *metadata,
+        _Inout_ otai_attribute_value_t *value)
+{
+    uint32_t count = 0;
+    const void *items = NULL;
+
+    if (metadata->defaultvaluetype == OTAI_DEFAULT_VALUE_TYPE_CONST && metadata->defaultvalue != NULL)
+    {
+        if (otai_vs_get_list(metadata->attrvaluetype, metadata->defaultvalue, &count, &items))
+        {
+            return otai_vs_copy_list(metadata, count, items, value);
+        }
+
+        otai_vs_copy_scalar(metadata, metadata->defaultvalue, value);
+
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    if (metadata->defaultvaluetype == OTAI_DEFAULT_VALUE_TYPE_EMPTY_LIST || metadata->isreadonly)
+    {
+        if (otai_vs_item_size(metadata->attrvaluetype) != 0)
+        {
+            return otai_vs_copy_list(metadata, 0, NULL, value);
+        }
+
+        otai_attribute_value_t zero;
+
+        memset(&zero, 0, sizeof(zero));
+
+        otai_vs_copy_scalar(metadata, &zero, value);
+
+        return OTAI_STATUS_SUCCESS;
+    }
+
+    return OTAI_STATUS_ITEM_NOT_FOUND;
+}
+
+static otai_status_t otai_vs_do_get(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t object_id,
+        _In_ uint32_t attr_count,
+        _Inout_ otai_attribute_t *attr_list)
+{
+    if (attr_count == 0 || attr_list == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    otai_vs_shard_t *shard = otai_vs_get_shard(object_id);
+
+    pthread_mutex_lock(&shard->mutex);
+
+    const otai_vs_object_t *object = *otai_vs_find(shard, object_id);
+
+    if (object == NULL)
+    {
+        pthread_mutex_unlock(&shard->mutex);
+
+        OTAI_META_LOG_ERROR("object 0x%" PRIx64 " doesn't exist", object_id);
+
+        return OTAI_STATUS_INVALID_OBJECT_ID;
+    }
+
+    otai_status_t status = OTAI_STATUS_SUCCESS;
+
+    uint32_t idx = 0;
+
+    for (; idx < attr_count; idx++)
+    {
+        otai_attribute_t *attr = &attr_list[idx];
+
+        const otai_attr_metadata_t *md = otai_metadata_get_attr_metadata(object_type, attr->id);
+
+        if (md == NULL)
+        {
+            status = OTAI_METADATA_VALIDATION_ATTR_STATUS(OTAI_STATUS_UNKNOWN_ATTRIBUTE_0, idx);
+            break;
+        }
+
+        if (md->issetonly)
+        {
+            status = OTAI_METADATA_VALIDATION_ATTR_STATUS(OTAI_STATUS_INVALID_ATTRIBUTE_0, idx);
+            break;
+        }
+
+        otai_status_t attr_status;
+
+        const otai_compact_attribute_t *compact = otai_metadata_compact_list_find(&object->attrs, attr->id);
+
+        if (compact == NULL)
+        {
+            attr_status = otai_vs_get_default(md, &attr->value);
+        }
+        else if (otai_vs_item_size(md->attrvaluetype) != 0)
+        {
+            attr_status = otai_vs_copy_list(md, compact->count,
+                    otai_metadata_compact_list_get_items(&object->attrs, compact), &attr->value);
+        }
+        else
+        {
+            attr_status = otai_metadata_compact_list_get_attr(&object->attrs, compact, attr);
+        }
+
+        if (attr_status == OTAI_STATUS_BUFFER_OVERFLOW)
+        {
+            /* remaining lists still get required count */
+            status = OTAI_STATUS_BUFFER_OVERFLOW;
+        }
+        else if (attr_status != OTAI_STATUS_SUCCESS)
+        {
+            status = attr_status;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&shard->mutex);
+
+    return status;
+}
+
+/*
+ * Returns base of counter, adding one if needed. Shard must be locked.
+ */
+static otai_vs_stat_base_t* otai_vs_get_base(
+        _Inout_ otai_vs_object_t *object,
+        _In_ otai_stat_id_t stat_id,
+        _In_ bool add)
+{
+    uint32_t idx = 0;
+
+    for (; idx < object->basecount; idx++)
+    {
+        if (object->bases[idx].id == stat_id)
+        {
+            return &object->bases[idx];
+        }
+    }
+
+    if (!add)
+    {
+        return NULL;
+    }
+
+    otai_vs_stat_base_t *bases = realloc(object->bases, (object->basecount + 1) * sizeof(otai_vs_stat_base_t));
+
+    if (bases == NULL)
+    {
+        return NULL;
+    }
+
+    OTAI_VS_ADD(&otai_vs_global.memory, sizeof(otai_vs_stat_base_t));
+
+    object->bases = bases;
+
+    otai_vs_stat_base_t *base = &bases[object->basecount++];
+
+    memset(base, 0, sizeof(*base));
+
+    base->id = stat_id;
+
+    return base;
+}
+
+static void otai_vs_subtract(
+        _In_ otai_stat_value_type_t stat_value_type,
+        _In_ const otai_stat_value_t *base,
+        _Inout_ otai_stat_value_t *value)
+{
+    switch (stat_value_type)
+    {
+        case OTAI_STAT_VALUE_TYPE_INT32:
+            value->s32 -= base->s32;
+            break;
+        case OTAI_STAT_VALUE_TYPE_UINT32:
+            value->u32 -= base->u32;
+            break;
+        case OTAI_STAT_VALUE_TYPE_INT64:
+            value->s64 -= base->s64;
+            break;
+        case OTAI_STAT_VALUE_TYPE_DOUBLE:
+            value->d64 -= base->d64;
+            break;
+        default:
+            value->u64 -= base->u64;
+            break;
+    }
+}
+
+/*
+ * Reads counters, or only clears them when counters is NULL.
+ */
+static otai_status_t otai_vs_do_get_stats(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t object_id,
+        _In_ uint32_t number_of_counters,
+        _In_ const otai_stat_id_t *counter_ids,
+        _In_ otai_stats_mode_t mode,
+        _Out_ otai_stat_value_t *counters)
+{
+    if (number_of_counters == 0 || counter_ids == NULL ||
+            (mode != OTAI_STATS_MODE_READ && mode != OTAI_STATS_MODE_READ_AND_CLEAR))
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < number_of_counters; idx++)
+    {
+        if (otai_metadata_get_stat_metadata(object_type, counter_ids[idx]) == NULL)
+        {
+            OTAI_META_LOG_ERROR("unknown statistics 0x%x of object type %d", counter_ids[idx], object_type);
+
+            return OTAI_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    otai_vs_stats_generator_fn generator = __atomic_load_n(&otai_vs_global.generators[object_type], __ATOMIC_ACQUIRE);
+
+    if (generator == NULL)
+    {
+        generator = otai_vs_default_stats_generator;
+    }
+
+    uint64_t now = otai_vs_now();
+
+    otai_status_t status = OTAI_STATUS_SUCCESS;
+
+    otai_vs_shard_t *shard = otai_vs_get_shard(object_id);
+
+    pthread_mutex_lock(&shard->mutex);
+
+    otai_vs_object_t *object = *otai_vs_find(shard, object_id);
+
+    if (object == NULL)
+    {
+        status = OTAI_STATUS_INVALID_OBJECT_ID;
+    }
+
+    for (idx = 0; idx < number_of_counters && object != NULL; idx++)
+    {
+        const otai_stat_metadata_t *sm = otai_metadata_get_stat_metadata(object_type, counter_ids[idx]);
+
+        otai_stat_value_t value;
+
+        memset(&value, 0, sizeof(value));
+
+        generator(object_id, sm, now > object->created ? now - object->created : 0, &value);
+
+        if (!sm->statvalueiscounter)
+        {
+            if (counters != NULL)
+            {
+                counters[idx] = value;
+            }
+
+            continue;
+        }
+
+        bool clear = counters == NULL || mode == OTAI_STATS_MODE_READ_AND_CLEAR;
+
+        otai_vs_stat_base_t *base = otai_vs_get_base(object, counter_ids[idx], clear);
+
+        if (counters != NULL)
+        {
+            counters[idx] = value;
+
+            if (base != NULL)
+            {
+                otai_vs_subtract(sm->statvaluetype, &base->value, &counters[idx]);
+            }
+        }
+
+        if (clear)
+        {
+            if (base == NULL)
+            {
+                status = OTAI_STATUS_NO_MEMORY;
+                break;
+            }
+
+            base->value = value;
+        }
+    }
+
+    pthread_mutex_unlock(&shard->mutex);
+
+    return status;
+}
+
+/* generic methods */
+
+static otai_status_t otai_vs_check_oid(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t object_id)
+{
+    if (!otai_vs_is_initialized())
+    {
+        return OTAI_STATUS_UNINITIALIZED;
+    }
+
+    if (otai_vs_object_type(object_id) != object_type)
+    {
+        OTAI_META_LOG_ERROR("object 0x%" PRIx64 " is not of object type %d", object_id, object_type);
+
+        return OTAI_STATUS_INVALID_OBJECT_ID;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+static otai_status_t otai_vs_create(
+        _In_ otai_object_type_t object_type,
+        _Out_ otai_object_id_t *object_id,
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    if (!otai_vs_is_initialized())
+    {
+        return OTAI_STATUS_UNINITIALIZED;
+    }
+
+    otai_vs_delay(object_type);
+
+    otai_status_t status = otai_vs_fail(object_type);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    return otai_vs_do_create(object_type, object_id, linecard_id, attr_count, attr_list);
+}
+
+static otai_status_t otai_vs_remove(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t object_id)
+{
+    otai_status_t status = otai_vs_check_oid(object_type, object_id);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    otai_vs_delay(object_type);
+
+    status = otai_vs_fail(object_type);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    return otai_vs_do_remove(object_type, object_id);
+}
+
+static otai_status_t otai_vs_set(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t object_id,
+        _In_ const otai_attribute_t *attr)
+{
+    otai_status_t status = otai_vs_check_oid(object_type, object_id);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    otai_vs_delay(object_type);
+
+    status = otai_vs_fail(object_type);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    return otai_vs_do_set(object_type, object_id, attr, false);
+}
+
+static otai_status_t otai_vs_get(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t object_id,
+        _In_ uint32_t attr_count,
+        _Inout_ otai_attribute_t *attr_list)
+{
+    otai_status_t status = otai_vs_check_oid(object_type, object_id);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    otai_vs_delay(object_type);
+
+    status = otai_vs_fail(object_type);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    return otai_vs_do_get(object_type, object_id, attr_count, attr_list);
+}
+
+static otai_status_t otai_vs_get_stats_ext(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t object_id,
+        _In_ uint32_t number_of_counters,
+        _In_ const otai_stat_id_t *counter_ids,
+        _In_ otai_stats_mode_t mode,
+        _Out_ otai_stat_value_t *counters)
+{
+    otai_status_t status = otai_vs_check_oid(object_type, object_id);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    if (counters == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    otai_vs_delay(object_type);
+
+    status = otai_vs_fail(object_type);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    return otai_vs_do_get_stats(object_type, object_id, number_of_counters, counter_ids, mode, counters);
+}
+
+static otai_status_t otai_vs_clear_stats(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t object_id,
+        _In_ uint32_t number_of_counters,
+        _In_ const otai_stat_id_t *counter_ids)
+{
+    otai_status_t status = otai_vs_check_oid(object_type, object_id);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    otai_vs_delay(object_type);
+
+    status = otai_vs_fail(object_type);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    return otai_vs_do_get_stats(object_type, object_id, number_of_counters, counter_ids,
+            OTAI_STATS_MODE_READ_AND_CLEAR, NULL);
+}
+
+/*
+ * Bulk operations are delayed once, and each object may fail.
+ */
+static otai_status_t otai_vs_bulk_check(
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t object_count,
+        _In_ const void *objects,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _In_ const otai_status_t *object_statuses)
+{
+    if (!otai_vs_is_initialized())
+    {
+        return OTAI_STATUS_UNINITIALIZED;
+    }
+
+    if (object_count == 0 || objects == NULL || object_statuses == NULL ||
+            (mode != OTAI_BULK_OP_ERROR_MODE_STOP_ON_ERROR && mode != OTAI_BULK_OP_ERROR_MODE_IGNORE_ERROR))
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    otai_vs_delay(object_type);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+/*
+ * Sets status of object, and of remaining objects when bulk operation
+ * stops. Returns true if bulk operation continues.
+ */
+static bool otai_vs_bulk_status(
+        _In_ uint32_t object_count,
+        _In_ uint32_t idx,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _In_ otai_status_t status,
+        _Inout_ otai_status_t *object_statuses,
+        _Inout_ otai_status_t *bulk_status)
+{
+    object_statuses[idx] = status;
+
+    if (status == OTAI_STATUS_SUCCESS)
+    {
+        return true;
+    }
+
+    *bulk_status = OTAI_STATUS_FAILURE;
+
+    if (mode == OTAI_BULK_OP_ERROR_MODE_IGNORE_ERROR)
+    {
+        return true;
+    }
+
+    for (idx++; idx < object_count; idx++)
+    {
+        object_statuses[idx] = OTAI_STATUS_NOT_EXECUTED;
+    }
+
+    return false;
+}
+
+static otai_status_t otai_vs_bulk_create(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t object_count,
+        _In_ const uint32_t *attr_count,
+        _In_ const otai_attribute_t **attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_object_id_t *object_id,
+        _Out_ otai_status_t *object_statuses)
+{
+    otai_status_t status = otai_vs_bulk_check(object_type, object_count, object_id, mode, object_statuses);
+
+    if (status != OTAI_STATUS_SUCCESS || attr_count == NULL || attr_list == NULL)
+    {
+        return status != OTAI_STATUS_SUCCESS ? status : OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < object_count; idx++)
+    {
+        otai_status_t object_status = otai_vs_fail(object_type);
+
+        object_id[idx] = OTAI_NULL_OBJECT_ID;
+
+        if (object_status == OTAI_STATUS_SUCCESS)
+        {
+            object_status = otai_vs_do_create(object_type, &object_id[idx], linecard_id, attr_count[idx], attr_list[idx]);
+        }
+
+        if (!otai_vs_bulk_status(object_count, idx, mode, object_status, object_statuses, &status))
+        {
+            break;
+        }
+    }
+
+    return status;
+}
+
+static otai_status_t otai_vs_bulk_remove(
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t object_count,
+        _In_ const otai_object_id_t *object_id,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses)
+{
+    otai_status_t status = otai_vs_bulk_check(object_type, object_count, object_id, mode, object_statuses);
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        return status;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < object_count; idx++)
+    {
+        otai_status_t object_status = otai_vs_check_oid(object_type, object_id[idx]);
+
+        if (object_status == OTAI_STATUS_SUCCESS)
+        {
+            object_status = otai_vs_fail(object_type);
+        }
+
+        if (object_status == OTAI_STATUS_SUCCESS)
+        {
+            object_status = otai_vs_do_remove(object_type, object_id[idx]);
+        }
+
+        if (!otai_vs_bulk_status(object_count, idx, mode, object_status, object_statuses, &status))
+        {
+            break;
+        }
+    }
+
+    return status;
+}
+
+static otai_status_t otai_vs_bulk_set(
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t object_count,
+        _In_ const otai_object_id_t *object_id,
+        _In_ const otai_attribute_t *attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses)
+{
+    otai_status_t status = otai_vs_bulk_check(object_type, object_count, object_id, mode, object_statuses);
+
+    if (status != OTAI_STATUS_SUCCESS || attr_list == NULL)
+    {
+        return status != OTAI_STATUS_SUCCESS ? status : OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < object_count; idx++)
+    {
+        otai_status_t object_status = otai_vs_check_oid(object_type, object_id[idx]);
+
+        if (object_status == OTAI_STATUS_SUCCESS)
+        {
+            object_status = otai_vs_fail(object_type);
+        }
+
+        if (object_status == OTAI_STATUS_SUCCESS)
+        {
+            object_status = otai_vs_do_set(object_type, object_id[idx], &attr_list[idx], false);
+        }
+
+        if (!otai_vs_bulk_status(object_count, idx, mode, object_status, object_statuses, &status))
+        {
+            break;
+        }
+    }
+
+    return status;
+}
+
+static otai_status_t otai_vs_bulk_get(
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t object_count,
+        _In_ const otai_object_id_t *object_id,
+        _In_ const uint32_t *attr_count,
+        _Inout_ otai_attribute_t **attr_list,
+        _In_ otai_bulk_op_error_mode_t mode,
+        _Out_ otai_status_t *object_statuses)
+{
+    otai_status_t status = otai_vs_bulk_check(object_type, object_count, object_id, mode, object_statuses);
+
+    if (status != OTAI_STATUS_SUCCESS || attr_count == NULL || attr_list == NULL)
+    {
+        return status != OTAI_STATUS_SUCCESS ? status : OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < object_count; idx++)
+    {
+        otai_status_t object_status = otai_vs_check_oid(object_type, object_id[idx]);
+
+        if (object_status == OTAI_STATUS_SUCCESS)
+        {
+            object_status = otai_vs_fail(object_type);
+        }
+
+        if (object_status == OTAI_STATUS_SUCCESS)
+        {
+            object_status = otai_vs_do_get(object_type, object_id[idx], attr_count[idx], attr_list[idx]);
+        }
+
+        if (!otai_vs_bulk_status(object_count, idx, mode, object_status, object_statuses, &status))
+        {
+            break;
+        }
+    }
+
+    return status;
+}
+
+static otai_status_t otai_vs_bulk_get_stats(
+        _In_ otai_object_type_t object_type,
+        _In_ uint32_t object_count,
+        _In_ const otai_object_id_t *object_id,
+        _In_ uint32_t number_of_counters,
+        _In_ const otai_stat_id_t *counter_ids,
+        _In_ otai_stats_mode_t mode,
+        _Out_ otai_status_t *object_statuses,
+        _Out_ otai_stat_value_t *counters)
+{
+    otai_status_t status = otai_vs_bulk_check(object_type, object_count, object_id,
+            OTAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, object_statuses);
+
+    if (status != OTAI_STATUS_SUCCESS || counters == NULL)
+    {
+        return status != OTAI_STATUS_SUCCESS ? status : OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    uint32_t idx = 0;
+
+    for (; idx < object_count; idx++)
+    {
+        otai_status_t object_status = otai_vs_check_oid(object_type, object_id[idx]);
+
+        if (object_status == OTAI_STATUS_SUCCESS)
+        {
+            object_status = otai_vs_fail(object_type);
+        }
+
+        if (object_status == OTAI_STATUS_SUCCESS)
+        {
+            object_status = otai_vs_do_get_stats(object_type, object_id[idx], number_of_counters, counter_ids,
+                    mode, &counters[(size_t)idx * number_of_counters]);
+        }
+
+        otai_vs_bulk_status(object_count, idx, OTAI_BULK_OP_ERROR_MODE_IGNORE_ERROR, object_status, object_statuses, &status);
+    }
+
+    return status;
+}
+
+otai_status_t otai_vs_inject_attribute(
+        _In_ otai_object_id_t object_id,
+        _In_ const otai_attribute_t *attr)
+{
+    otai_object_type_t object_type = otai_vs_object_type(object_id);
+
+    otai_status_t status = otai_vs_check_oid(object_type, object_id);
+
+    if (status != OTAI_STATUS_SUCCESS || object_type == OTAI_OBJECT_TYPE_NULL)
+    {
+        return status != OTAI_STATUS_SUCCESS ? status : OTAI_STATUS_INVALID_OBJECT_ID;
+    }
+
+    return otai_vs_do_set(object_type, object_id, attr, true);
+}
+
+uint64_t otai_vs_get_object_count(
+        _In_ otai_object_type_t object_type)
+{
+    if (object_type != OTAI_OBJECT_TYPE_NULL)
+    {
+        return object_type < OTAI_OBJECT_TYPE_MAX ? OTAI_VS_LOAD(&otai_vs_global.objects[object_type]) : 0;
+    }
+
+    uint64_t count = 0;
+
+    int type = OTAI_OBJECT_TYPE_NULL + 1;
+
+    for (; type < OTAI_OBJECT_TYPE_MAX; type++)
+    {
+        count += OTAI_VS_LOAD(&otai_vs_global.objects[type]);
+    }
+
+    return count;
+}
+
+uint64_t otai_vs_get_memory_usage(void)
+{
+    return OTAI_VS_LOAD(&otai_vs_global.memory);
+}
+
+/* method tables */
+
+/*
+ * Defines methods of API, which pass object type to generic methods,
+ * except create method.
+ */
+#define OTAI_VS_API_METHODS(_name, _type)                                       \
+                                                                                \
+static otai_status_t otai_vs_remove_##_name(                                    \
+        _In_ otai_object_id_t object_id)                                        \
+{                                                                               \
+    return otai_vs_remove(_type, object_id);                                    \
+}                                                                               \
+                                                                                \
+static otai_status_t otai_vs_set_##_name##_attribute(                           \
+        _In_ otai_object_id_t object_id,                                        \
+        _In_ const otai_attribute_t *attr)                                      \
+{                                                                               \
+    return otai_vs_set(_type, object_id, attr);                                 \
+}                                                                               \
+                                                                                \
+static otai_status_t otai_vs_get_##_name##_attribute(                           \
+        _In_ otai_object_id_t object_id,                                        \
+        _In_ uint32_t attr_count,                                               \
+        _Inout_ otai_attribute_t *attr_list)                                    \
+{                                                                               \
+    return otai_vs_get(_type, object_id, attr_count, attr_list);                \
+}                                                                               \
+                                                                                \
+static otai_status_t otai_vs_get_##_name##_stats(                               \
+        _In_ otai_object_id_t object_id,                                        \
+        _In_ uint32_t number_of_counters,                                       \
+        _In_ const otai_stat_id_t *counter_ids,                                 \
+        _Out_ otai_stat_value_t *counters)                                      \
+{                                                                               \
+    return otai_vs_get_stats_ext(_type, object_id, number_of_counters,          \
+            counter_ids, OTAI_STATS_MODE_READ, counters);                       \
+}                                                                               \
+                                                                                \
+static otai_status_t otai_vs_get_##_name##_stats_ext(                           \
+        _In_ otai_object_id_t object_id,                                        \
+        _In_ uint32_t number_of_counters,                                       \
+        _In_ const otai_stat_id_t *counter_ids,                                 \
+        _In_ otai_stats_mode_t mode,                                            \
+        _Out_ otai_stat_value_t *counters)                                      \
+{                                                                               \
+    return otai_vs_get_stats_ext(_type, object_id, number_of_counters,          \
+            counter_ids, mode, counters);                                       \
+}                                                                               \
+                                                                                \
+static otai_status_t otai_vs_clear_##_name##_stats(                             \
+        _In_ otai_object_id_t object_id,                                        \
+        _In_ uint32_t number_of_counters,                                       \
+        _In_ const otai_stat_id_t *counter_ids)                                 \
+{                                                                               \
+    return otai_vs_clear_stats(_type, object_id, number_of_counters,            \
+            counter_ids);                                                       \
+}                                                                               \
+                                                                                \
+static otai_status_t otai_vs_bulk_create_##_name(                               \
+        _In_ otai_object_id_t linecard_id,                                      \
+        _In_ uint32_t object_count,                                             \
+        _In_ const uint32_t *attr_count,                                        \
+        _In_ const otai_attribute_t **attr_list,                                \
+        _In_ otai_bulk_op_error_mode_t mode,                                    \
+        _Out_ otai_object_id_t *object_id,                                      \
+        _Out_ otai_status_t *object_statuses)                                   \
+{                                                                               \
+    return otai_vs_bulk_create(_type, linecard_id, object_count, attr_count,    \
+            attr_list, mode, object_id, object_statuses);                       \
+}                                                                               \
+                                                                                \
+static otai_status_t otai_vs_bulk_remove_##_name(                               \
+        _In_ uint32_t object_count,                                             \
+        _In_ const otai_object_id_t *object_id,                                 \
+        _In_ otai_bulk_op_error_mode_t mode,                                    \
+        _Out_ otai_status_t *object_statuses)                                   \
+{                                                                               \
+    return otai_vs_bulk_remove(_type, object_count, object_id, mode,            \
+            object_statuses);                                                   \
+}                                                                               \
+                                                                                \
+static otai_status_t otai_vs_bulk_set_##_name(                                  \
+        _In_ uint32_t object_count,                                             \
+        _In_ const otai_object_id_t *object_id,                                 \
+        _In_ const otai_attribute_t *attr_list,                                 \
+        _In_ otai_bulk_op_error_mode_t mode,                                    \
+        _Out_ otai_status_t *object_statuses)                                   \
+{                                                                               \
+    return otai_vs_bulk_set(_type, object_count, object_id, attr_list, mode,    \
+            object_statuses);                                                   \
+}                                                                               \
+                                                                                \
+static otai_status_t otai_vs_bulk_get_##_name(                                  \
+        _In_ uint32_t object_count,                                             \
+        _In_ const otai_object_id_t *object_id,                                 \
+        _In_ const uint32_t *attr_count,                                        \
+        _Inout_ otai_attribute_t **attr_list,                                   \
+        _In_ otai_bulk_op_error_mode_t mode,                                    \
+        _Out_ otai_status_t *object_statuses)                                   \
+{                                                                               \
+    return otai_vs_bulk_get(_type, object_count, object_id, attr_count,         \
+            attr_list, mode, object_statuses);                                  \
+}                                                                               \
+                                                                                \
+static otai_status_t otai_vs_bulk_get_##_name##_stats(                          \
+        _In_ uint32_t object_count,                                             \
+        _In_ const otai_object_id_t *object_id,                                 \
+        _In_ uint32_t number_of_counters,                                       \
+        _In_ const otai_stat_id_t *counter_ids,                                 \
+        _In_ otai_stats_mode_t mode,                                            \
+        _Out_ otai_status_t *object_statuses,                                   \
+        _Out_ otai_stat_value_t *counters)                                      \
+{                                                                               \
+    return otai_vs_bulk_get_stats(_type, object_count, object_id,               \
+            number_of_counters, counter_ids, mode, object_statuses, counters);  \
+}
+
+/*
+ * Defines create method of API, other than linecard.
+ */
+#define OTAI_VS_API_CREATE(_name, _type)                                        \
+                                                                                \
+static otai_status_t otai_vs_create_##_name(                                    \
+        _Out_ otai_object_id_t *object_id,                                      \
+        _In_ otai_object_id_t linecard_id,                                      \
+        _In_ uint32_t attr_count,                                               \
+        _In_ const otai_attribute_t *attr_list)                                 \
+{                                                                               \
+    return otai_vs_create(_type, object_id, linecard_id, attr_count,            \
+            attr_list);                                                         \
+}
+
+/*
+ * Initializer of API method table members, in order of declaration.
+ */
+#define OTAI_VS_API_TABLE(_name)                                                \
+    otai_vs_create_##_name,                                                     \
+    otai_vs_remove_##_name,                                                     \
+    otai_vs_set_##_name##_attribute,                                            \
+    otai_vs_get_##_name##_attribute,                                            \
+    otai_vs_get_##_name##_stats,                                                \
+    otai_vs_get_##_name##_stats_ext,                                            \
+    otai_vs_clear_##_name##_stats,                                              \
+    otai_vs_bulk_create_##_name,                                                \
+    otai_vs_bulk_remove_##_name,                                                \
+    otai_vs_bulk_set_##_name,                                                   \
+    otai_vs_bulk_get_##_name,                                                   \
+    otai_vs_bulk_get_##_name##_stats
+
+static otai_status_t otai_vs_create_linecard(
+        _Out_ otai_object_id_t *linecard_id,
+        _In_ uint32_t attr_count,
+        _In_ const otai_attribute_t *attr_list)
+{
+    return otai_vs_create(OTAI_OBJECT_TYPE_LINECARD, linecard_id, OTAI_NULL_OBJECT_ID, attr_count, attr_list);
+}
+
+OTAI_VS_API_METHODS(linecard, OTAI_OBJECT_TYPE_LINECARD)
+OTAI_VS_API_METHODS(port, OTAI_OBJECT_TYPE_PORT)
+OTAI_VS_API_METHODS(transceiver, OTAI_OBJECT_TYPE_TRANSCEIVER)
+OTAI_VS_API_METHODS(logicalchannel, OTAI_OBJECT_TYPE_LOGICALCHANNEL)
+OTAI_VS_API_METHODS(otn, OTAI_OBJECT_TYPE_OTN)
+OTAI_VS_API_METHODS(ethernet, OTAI_OBJECT_TYPE_ETHERNET)
+OTAI_VS_API_METHODS(physicalchannel, OTAI_OBJECT_TYPE_PHYSICALCHANNEL)
+OTAI_VS_API_METHODS(och, OTAI_OBJECT_TYPE_OCH)
+OTAI_VS_API_METHODS(lldp, OTAI_OBJECT_TYPE_LLDP)
+OTAI_VS_API_METHODS(assignment, OTAI_OBJECT_TYPE_ASSIGNMENT)
+OTAI_VS_API_METHODS(interface, OTAI_OBJECT_TYPE_INTERFACE)
+OTAI_VS_API_METHODS(oa, OTAI_OBJECT_TYPE_OA)
+OTAI_VS_API_METHODS(osc, OTAI_OBJECT_TYPE_OSC)
+OTAI_VS_API_METHODS(aps, OTAI_OBJECT_TYPE_APS)
+OTAI_VS_API_METHODS(apsport, OTAI_OBJECT_TYPE_APSPORT)
+OTAI_VS_API_METHODS(attenuator, OTAI_OBJECT_TYPE_ATTENUATOR)
+OTAI_VS_API_METHODS(wss, OTAI_OBJECT_TYPE_WSS)
+OTAI_VS_API_METHODS(mediachannel, OTAI_OBJECT_TYPE_MEDIACHANNEL)
+OTAI_VS_API_METHODS(ocm, OTAI_OBJECT_TYPE_OCM)
+OTAI_VS_API_METHODS(otdr, OTAI_OBJECT_TYPE_OTDR)
+
+OTAI_VS_API_CREATE(port, OTAI_OBJECT_TYPE_PORT)
+OTAI_VS_API_CREATE(transceiver, OTAI_OBJECT_TYPE_TRANSCEIVER)
+OTAI_VS_API_CREATE(logicalchannel, OTAI_OBJECT_TYPE_LOGICALCHANNEL)
+OTAI_VS_API_CREATE(otn, OTAI_OBJECT_TYPE_OTN)
+OTAI_VS_API_CREATE(ethernet, OTAI_OBJECT_TYPE_ETHERNET)
+OTAI_VS_API_CREATE(physicalchannel, OTAI_OBJECT_TYPE_PHYSICALCHANNEL)
+OTAI_VS_API_CREATE(och, OTAI_OBJECT_TYPE_OCH)
+OTAI_VS_API_CREATE(lldp, OTAI_OBJECT_TYPE_LLDP)
+OTAI_VS_API_CREATE(assignment, OTAI_OBJECT_TYPE_ASSIGNMENT)
+OTAI_VS_API_CREATE(interface, OTAI_OBJECT_TYPE_INTERFACE)
+OTAI_VS_API_CREATE(oa, OTAI_OBJECT_TYPE_OA)
+OTAI_VS_API_CREATE(osc, OTAI_OBJECT_TYPE_OSC)
+OTAI_VS_API_CREATE(aps, OTAI_OBJECT_TYPE_APS)
+OTAI_VS_API_CREATE(apsport, OTAI_OBJECT_TYPE_APSPORT)
+OTAI_VS_API_CREATE(attenuator, OTAI_OBJECT_TYPE_ATTENUATOR)
+OTAI_VS_API_CREATE(wss, OTAI_OBJECT_TYPE_WSS)
+OTAI_VS_API_CREATE(mediachannel, OTAI_OBJECT_TYPE_MEDIACHANNEL)
+OTAI_VS_API_CREATE(ocm, OTAI_OBJECT_TYPE_OCM)
+OTAI_VS_API_CREATE(otdr, OTAI_OBJECT_TYPE_OTDR)
+
+/*
+ * Adapter doesn't send switch info notifications, so there is no buffer
+ * to release.
+ */
+static otai_status_t otai_vs_release_aps_switch_info(
+        _In_ const otai_olp_switch_t *switch_info)
+{
+    return switch_info == NULL ? OTAI_STATUS_INVALID_PARAMETER : OTAI_STATUS_SUCCESS;
+}
+
+static otai_linecard_api_t otai_vs_linecard_api = { OTAI_VS_API_TABLE(linecard) };
+static otai_port_api_t otai_vs_port_api = { OTAI_VS_API_TABLE(port) };
+static otai_transceiver_api_t otai_vs_transceiver_api = { OTAI_VS_API_TABLE(transceiver) };
+static otai_logicalchannel_api_t otai_vs_logicalchannel_api = { OTAI_VS_API_TABLE(logicalchannel) };
+static otai_otn_api_t otai_vs_otn_api = { OTAI_VS_API_TABLE(otn) };
+static otai_ethernet_api_t otai_vs_ethernet_api = { OTAI_VS_API_TABLE(ethernet) };
+static otai_physicalchannel_api_t otai_vs_physicalchannel_api = { OTAI_VS_API_TABLE(physicalchannel) };
+static otai_och_api_t otai_vs_och_api = { OTAI_VS_API_TABLE(och) };
+static otai_lldp_api_t otai_vs_lldp_api = { OTAI_VS_API_TABLE(lldp) };
+static otai_assignment_api_t otai_vs_assignment_api = { OTAI_VS_API_TABLE(assignment) };
+static otai_interface_api_t otai_vs_interface_api = { OTAI_VS_API_TABLE(interface) };
+static otai_oa_api_t otai_vs_oa_api = { OTAI_VS_API_TABLE(oa) };
+static otai_osc_api_t otai_vs_osc_api = { OTAI_VS_API_TABLE(osc) };
+static otai_aps_api_t otai_vs_aps_api = { OTAI_VS_API_TABLE(aps), otai_vs_release_aps_switch_info };
+static otai_apsport_api_t otai_vs_apsport_api = { OTAI_VS_API_TABLE(apsport) };
+static otai_attenuator_api_t otai_vs_attenuator_api = { OTAI_VS_API_TABLE(attenuator) };
+static otai_wss_api_t otai_vs_wss_api = { OTAI_VS_API_TABLE(wss) };
+static otai_mediachannel_api_t otai_vs_mediachannel_api = { OTAI_VS_API_TABLE(mediachannel) };
+static otai_ocm_api_t otai_vs_ocm_api = { OTAI_VS_API_TABLE(ocm) };
+static otai_otdr_api_t otai_vs_otdr_api = { OTAI_VS_API_TABLE(otdr) };
+
+/* adapter */
+
+/*
+ * Reads fault profile of all object types from profile values, if any is
+ * set, invalid values are ignored.
+ */
+static void otai_vs_read_profile(
+        _In_ const otai_service_method_table_t *services)
+{
+    if (services == NULL || services->profile_get_value == NULL)
+    {
+        return;
+    }
+
+    const char *names[] = { "OTAI_VS_LATENCY_NS", "OTAI_VS_JITTER_NS", "OTAI_VS_FAILURE_RATE", "OTAI_VS_SEED" };
+
+    double values[] = { 0, 0, 0, 0 };
+
+    bool found = false;
+
+    size_t idx = 0;
+
+    for (; idx < sizeof(values) / sizeof(values[0]); idx++)
+    {
+        const char *value = services->profile_get_value(0, names[idx]);
+
+        char *end = NULL;
+
+        double parsed = value == NULL ? 0 : strtod(value, &end);
+
+        if (value != NULL && end != value && *end == 0 && parsed >= 0)
+        {
+            values[idx] = parsed;
+
+            found = true;
+        }
+    }
+
+    if (!found)
+    {
+        return;
+    }
+
+    otai_vs_fault_t fault;
+
+    memset(&fault, 0, sizeof(fault));
+
+    fault.latency = (uint64_t)values[0];
+    fault.jitter = (uint64_t)values[1];
+    fault.failurerate = values[2] > 1 ? 1 : values[2];
+
+    otai_vs_set_fault(OTAI_OBJECT_TYPE_NULL, &fault);
+
+    OTAI_VS_STORE(&otai_vs_global.seed, (uint64_t)values[3]);
+}
+
+otai_status_t otai_api_initialize(
+        _In_ uint64_t flags,
+        _In_ const otai_service_method_table_t *services)
+{
+    pthread_mutex_lock(&otai_vs_mutex);
+
+    if (otai_vs_global.initialized)
+    {
+        pthread_mutex_unlock(&otai_vs_mutex);
+
+        OTAI_META_LOG_ERROR("adapter is already initialized");
+
+        return OTAI_STATUS_FAILURE;
+    }
+
+    otai_status_t status = OTAI_STATUS_SUCCESS;
+
+    size_t idx = 0;
+
+    for (; idx < OTAI_VS_SHARDS; idx++)
+    {
+        otai_vs_shard_t *shard = &otai_vs_global.shards[idx];
+
+        shard->buckets = calloc(OTAI_VS_INITIAL_BUCKETS, sizeof(otai_vs_object_t*));
+        shard->mask = OTAI_VS_INITIAL_BUCKETS - 1;
+        shard->count = 0;
+
+        if (shard->buckets == NULL)
+        {
+            status = OTAI_STATUS_NO_MEMORY;
+            break;
+        }
+
+        pthread_mutex_init(&shard->mutex, NULL);
+    }
+
+    if (status != OTAI_STATUS_SUCCESS)
+    {
+        while (idx-- > 0)
+        {
+            pthread_mutex_destroy(&otai_vs_global.shards[idx].mutex);
+
+            free(otai_vs_global.shards[idx].buckets);
+        }
+
+        pthread_mutex_unlock(&otai_vs_mutex);
+
+        return status;
+    }
+
+    otai_vs_read_profile(services);
+
+    OTAI_VS_STORE(&otai_vs_global.nextlinecard, 0);
+    OTAI_VS_STORE(&otai_vs_global.nextindex, 0);
+
+    __atomic_store_n(&otai_vs_global.initialized, true, __ATOMIC_RELEASE);
+
+    pthread_mutex_unlock(&otai_vs_mutex);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_api_query(
+        _In_ otai_api_t api,
+        _Out_ void **api_method_table)
+{
+    if (api_method_table == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (!otai_vs_is_initialized())
+    {
+        return OTAI_STATUS_UNINITIALIZED;
+    }
+
+    switch (api)
+    {
+        case OTAI_API_LINECARD:
+            *api_method_table = &otai_vs_linecard_api;
+            break;
+        case OTAI_API_PORT:
+            *api_method_table = &otai_vs_port_api;
+            break;
+        case OTAI_API_TRANSCEIVER:
+            *api_method_table = &otai_vs_transceiver_api;
+            break;
+        case OTAI_API_LOGICALCHANNEL:
+            *api_method_table = &otai_vs_logicalchannel_api;
+            break;
+        case OTAI_API_OTN:
+            *api_method_table = &otai_vs_otn_api;
+            break;
+        case OTAI_API_ETHERNET:
+            *api_method_table = &otai_vs_ethernet_api;
+            break;
+        case OTAI_API_PHYSICALCHANNEL:
+            *api_method_table = &otai_vs_physicalchannel_api;
+            break;
+        case OTAI_API_OCH:
+            *api_method_table = &otai_vs_och_api;
+            break;
+        case OTAI_API_LLDP:
+            *api_method_table = &otai_vs_lldp_api;
+            break;
+        case OTAI_API_ASSIGNMENT:
+            *api_method_table = &otai_vs_assignment_api;
+            break;
+        case OTAI_API_INTERFACE:
+            *api_method_table = &otai_vs_interface_api;
+            break;
+        case OTAI_API_OA:
+            *api_method_table = &otai_vs_oa_api;
+            break;
+        case OTAI_API_OSC:
+            *api_method_table = &otai_vs_osc_api;
+            break;
+        case OTAI_API_APS:
+            *api_method_table = &otai_vs_aps_api;
+            break;
+        case OTAI_API_APSPORT:
+            *api_method_table = &otai_vs_apsport_api;
+            break;
+        case OTAI_API_ATTENUATOR:
+            *api_method_table = &otai_vs_attenuator_api;
+            break;
+        case OTAI_API_WSS:
+            *api_method_table = &otai_vs_wss_api;
+            break;
+        case OTAI_API_MEDIACHANNEL:
+            *api_method_table = &otai_vs_mediachannel_api;
+            break;
+        case OTAI_API_OCM:
+            *api_method_table = &otai_vs_ocm_api;
+            break;
+        case OTAI_API_OTDR:
+            *api_method_table = &otai_vs_otdr_api;
+            break;
+        default:
+            OTAI_META_LOG_ERROR("invalid API %d", api);
+            return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_api_uninitialize(void)
+{
+    pthread_mutex_lock(&otai_vs_mutex);
+
+    if (!otai_vs_global.initialized)
+    {
+        pthread_mutex_unlock(&otai_vs_mutex);
+
+        return OTAI_STATUS_UNINITIALIZED;
+    }
+
+    __atomic_store_n(&otai_vs_global.initialized, false, __ATOMIC_RELEASE);
+
+    size_t idx = 0;
+
+    for (; idx < OTAI_VS_SHARDS; idx++)
+    {
+        otai_vs_shard_t *shard = &otai_vs_global.shards[idx];
+
+        uint64_t bucket = 0;
+
+        for (; bucket <= shard->mask; bucket++)
+        {
+            while (shard->buckets[bucket] != NULL)
+            {
+                otai_vs_object_t *object = shard->buckets[bucket];
+
+                shard->buckets[bucket] = object->next;
+
+                otai_vs_free_object(object);
+            }
+        }
+
+        free(shard->buckets);
+
+        shard->buckets = NULL;
+
+        pthread_mutex_destroy(&shard->mutex);
+    }
+
+    pthread_mutex_unlock(&otai_vs_mutex);
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_log_set(
+        _In_ otai_api_t api,
+        _In_ otai_log_level_t log_level)
+{
+    if (log_level >= OTAI_LOG_LEVEL_MAX)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    /* metadata logger has single level */
+    otai_metadata_log_level = log_level;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_object_type_t otai_object_type_query(
+        _In_ otai_object_id_t object_id)
+{
+    return otai_vs_object_type(object_id);
+}
+
+otai_object_id_t otai_linecard_id_query(
+        _In_ otai_object_id_t object_id)
+{
+    if (otai_vs_object_type(object_id) == OTAI_OBJECT_TYPE_NULL)
+    {
+        return OTAI_NULL_OBJECT_ID;
+    }
+
+    return otai_vs_linecard_oid(object_id);
+}
+
+otai_status_t otai_link_check(
+        _Out_ bool *up)
+{
+    if (up == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *up = true;
+
+    return OTAI_STATUS_SUCCESS;
+}
+
+otai_status_t otai_dbg_generate_dump(
+        _In_ const char *dump_file_name)
+{
+    if (dump_file_name == NULL)
+    {
+        return OTAI_STATUS_INVALID_PARAMETER;
+    }
+
+    FILE *file = fopen(dump_file_name, "a");
+
+    if (file == NULL)
+    {
+        OTAI_META_LOG_ERROR("failed to open %s", dump_file_name);
+
+        return OTAI_STATUS_FAILURE;
+    }
+
+    fprintf(file, "virtual adapter: %" PRIu64 " objects, %" PRIu64 " bytes\n",
+            otai_vs_get_object_count(OTAI_OBJECT_TYPE_NULL), otai_vs_get_memory_usage());
+
+    int type = OTAI_OBJECT_TYPE_NULL + 1;
+
+    for (; type < OTAI_OBJECT_TYPE_MAX; type++)
+    {
+        const otai_object_type_info_t *info = otai_metadata_get_object_type_info((otai_object_type_t)type);
+
+        uint64_t count = otai_vs_get_object_count((otai_object_type_t)type);
+
+        if (info != NULL && count != 0)
+        {
+            fprintf(file, "  %s: %" PRIu64 "\n", info->objecttypename, count);
+        }
+    }
+
+    if (fclose(file) != 0)
+    {
+        return OTAI_STATUS_FAILURE;
+    }
+
+    /* calls made through instrumented API tables, if any */
+
+    return otai_metadata_instrument_dump(dump_file_name);
+}
@@ -0,0 +1,180 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaivs.h
+ *
+ * @brief   This module defines OTAI virtual adapter controls
+ */
+
+#ifndef __OTAIVS_H_
+#define __OTAIVS_H_
+
+#include <otai.h>
+#include "otaimetadatatypes.h"
+
+/**
+ * @defgroup OTAIVS OTAI - Virtual adapter
+ *
+ * Virtual adapter implements otai_api_initialize(), otai_api_query() and
+ * all API method tables in memory, so application and tests run without
+ * hardware. Attributes are validated by metadata: unknown, read only and
+ * create only attributes, enum values, object id types and mandatory on
+ * create attributes. Values are stored as compact attribute lists.
+ *
+ * Get returns stored value, or const default value, or zero value of read
+ * only attribute, which may be changed by otai_vs_inject_attribute() to
+ * simulate hardware state.
+ *
+ * Statistics are made by generator of object type, default one makes
+ * counters growing at constant rate of each object and counter, and gauges
+ * moving around constant level, both derived from object id, counter id
+ * and time since create.
+ *
+ * Each call may be delayed and failed by fault profile of its object type,
+ * to simulate hardware latency and errors.
+ *
+ * Profile values read by otai_api_initialize(), all optional:
+ * - OTAI_VS_LATENCY_NS: latency of each call in nanoseconds
+ * - OTAI_VS_JITTER_NS: random latency added to each call in nanoseconds
+ * - OTAI_VS_FAILURE_RATE: probability of call failure from 0 to 1
+ * - OTAI_VS_SEED: random seed
+ *
+ * @{
+ */
+
+/**
+ * @brief Fault profile.
+ */
+typedef struct _otai_vs_fault_t
+{
+    /**
+     * @brief Latency of each call in nanoseconds.
+     */
+    otai_uint64_t                                latency;
+
+    /**
+     * @brief Maximum random latency added to each call in nanoseconds.
+     */
+    otai_uint64_t                                jitter;
+
+    /**
+     * @brief Probability of call failure from 0 to 1.
+     */
+    otai_double_t                                failurerate;
+
+    /**
+     * @brief Status of failed call, #OTAI_STATUS_FAILURE if success.
+     */
+    otai_status_t                                failurestatus;
+
+} otai_vs_fault_t;
+
+/**
+ * @brief Statistics generator.
+ *
+ * Counter values must not decrease with elapsed time. Generator is called
+ * under adapter lock, so it must not call adapter.
+ *
+ * @param[in] object_id Object id
+ * @param[in] metadata Statistics metadata
+ * @param[in] elapsed Time since object create in nanoseconds
+ * @param[out] value Statistics value of metadata value type
+ */
+typedef void (*otai_vs_stats_generator_fn)(
+        _In_ otai_object_id_t object_id,
+        _In_ const otai_stat_metadata_t *metadata,
+        _In_ uint64_t elapsed,
+        _Out_ otai_stat_value_t *value);
+
+/**
+ * @brief Set fault profile
+ *
+ * May be called before otai_api_initialize() and while calls are made.
+ *
+ * @param[in] object_type Object type, #OTAI_OBJECT_TYPE_NULL for all types
+ * @param[in] fault Fault profile
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if object type or fault profile is invalid
+ */
+extern otai_status_t otai_vs_set_fault(
+        _In_ otai_object_type_t object_type,
+        _In_ const otai_vs_fault_t *fault);
+
+/**
+ * @brief Set statistics generator
+ *
+ * May be called before otai_api_initialize() and while calls are made.
+ *
+ * @param[in] object_type Object type, #OTAI_OBJECT_TYPE_NULL for all types
+ * @param[in] generator Generator, NULL for default one
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, #OTAI_STATUS_INVALID_PARAMETER
+ * if object type is invalid
+ */
+extern otai_status_t otai_vs_set_stats_generator(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_vs_stats_generator_fn generator);
+
+/**
+ * @brief Default statistics generator
+ *
+ * @param[in] object_id Object id
+ * @param[in] metadata Statistics metadata
+ * @param[in] elapsed Time since object create in nanoseconds
+ * @param[out] value Statistics value of metadata value type
+ */
+extern void otai_vs_default_stats_generator(
+        _In_ otai_object_id_t object_id,
+        _In_ const otai_stat_metadata_t *metadata,
+        _In_ uint64_t elapsed,
+        _Out_ otai_stat_value_t *value);
+
+/**
+ * @brief Set attribute as hardware would
+ *
+ * Attribute is validated as on set, except read only and create only
+ * attributes are allowed. No fault is injected.
+ *
+ * @param[in] object_id Object id
+ * @param[in] attr Attribute
+ *
+ * @return #OTAI_STATUS_SUCCESS on success, failure status code on error
+ */
+extern otai_status_t otai_vs_inject_attribute(
+        _In_ otai_object_id_t object_id,
+        _In_ const otai_attribute_t *attr);
+
+/**
+ * @brief Get number of objects
+ *
+ * @param[in] object_type Object type, #OTAI_OBJECT_TYPE_NULL for all types
+ *
+ * @return Number of objects
+ */
+extern uint64_t otai_vs_get_object_count(
+        _In_ otai_object_type_t object_type);
+
+/**
+ * @brief Get memory used by objects
+ *
+ * @return Bytes allocated for objects, their attributes and statistics
+ */
+extern uint64_t otai_vs_get_memory_usage(void);
+
+/**
+ * @}
+ */
+#endif /** __OTAIVS_H_ */
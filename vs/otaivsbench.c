@@ -0,0 +1,1456 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaivsbench.c
+ *
+ * @brief   This file contains microbenchmarks of metadata, serialization,
+ *          analytics and API dispatch
+ *
+ * Each benchmark runs fixed number of iterations over fixed data set made
+ * by fixed random seed, so runs are comparable between releases. Output is
+ * CSV, one line per benchmark with time per operation in nanoseconds:
+ *
+ *   benchmark,ops,min_ns,median_ns,max_ns
+ *
+ * Optional argument runs only benchmarks whose name starts with it.
+ *
+ * Payload benchmarks compare JSON and binary encoding of all attributes of
+ * object type with most attributes, encoded sizes are printed to stderr.
+ *
+ * Number benchmarks compare numeric serialize functions with printf, scanf
+ * and strtod, whose rows have the name of C library function as suffix.
+ *
+ * Analytics benchmarks compare spectrum analytics with scalar pow/log10
+ * loop on C+L band sweeps, time is per channel. Results of both are
+ * compared first, and program fails when they differ. Gain depends on how
+ * many entries each channel has, since conversion is vectorized but log10
+ * of results is not.
+ *
+ * Statistics and dispatch benchmarks run against virtual adapter linked
+ * with this program, on objects created with mandatory on create
+ * attributes. Object types which adapter can't create are skipped.
+ */
+
+/* snprintf is not declared in strict ANSI mode */
+#define _POSIX_C_SOURCE 200112L
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <otai.h>
+#include "otaimetadata.h"
+#include "otaiserialize.h"
+#include "otaimetadatavalidation.h"
+#include "otaimetadataarena.h"
+#include "otaimetadataanalytics.h"
+#include "otaimetadatarecorder.h"
+
+#define REPEATS 7
+#define LIST_SIZE 16
+#define MAX_ATTRS 64
+#define MAX_ENUMS 1024
+#define MAX_CONDITIONS 8
+#define MAX_CONDITIONAL 256
+#define BUFFER_SIZE 8192
+#define PAYLOAD_SIZE 0x40000
+#define NUMBER_COUNT 1024
+#define SWEEP_COUNT 3
+
+#define LOOKUP_ITERATIONS 200
+#define VALUE_ITERATIONS 20000
+#define ENUM_ITERATIONS 200
+#define CONDITION_ITERATIONS 2000
+#define CREATE_ITERATIONS 20000
+#define ADAPTER_ITERATIONS 20000
+#define PAYLOAD_ITERATIONS 2000
+#define NUMBER_ITERATIONS 200
+#define ANALYTICS_ITERATIONS 200
+
+/*
+ * Allowed difference of analytics results in dB.
+ */
+#define ANALYTICS_TOLERANCE 1e-6
+
+/*
+ * C+L band and flexgrid channels, in MHz.
+ */
+#define BAND_LOWER_FREQUENCY 186000000
+#define BAND_UPPER_FREQUENCY 196200000
+#define CHANNEL_WIDTH 75000
+
+#define CHANNEL_COUNT ((BAND_UPPER_FREQUENCY - BAND_LOWER_FREQUENCY) / CHANNEL_WIDTH)
+
+#define VALUE_TYPE_COUNT (OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST + 1)
+
+typedef void (*bench_fn)(
+        _In_ const void *arg);
+
+typedef struct _bench_value_t
+{
+    const otai_attr_metadata_t *md;
+    otai_attribute_t attr;
+    otai_attribute_t capacity;
+    char buffer[BUFFER_SIZE];
+    uint64_t binary[BUFFER_SIZE / sizeof(uint64_t)];
+} bench_value_t;
+
+/*
+ * All attributes of single object type, serialized as JSON array and as
+ * binary attribute list.
+ */
+typedef struct _bench_payload_t
+{
+    otai_object_type_t objecttype;
+    uint32_t count;
+    otai_attribute_t attrs[MAX_ATTRS];
+    const otai_attr_metadata_t *mds[MAX_ATTRS];
+    otai_attribute_t decoded[MAX_ATTRS];
+    char json[PAYLOAD_SIZE];
+    uint64_t binary[PAYLOAD_SIZE / sizeof(uint64_t)];
+    uint64_t arena[PAYLOAD_SIZE / sizeof(uint64_t)];
+} bench_payload_t;
+
+typedef struct _bench_conditional_t
+{
+    const otai_attr_metadata_t *md;
+    uint32_t count;
+    otai_attribute_t attrs[MAX_CONDITIONS];
+} bench_conditional_t;
+
+/*
+ * Spectrum sweep of band with bins of granularity.
+ */
+typedef struct _bench_sweep_t
+{
+    const char *name;
+    uint64_t granularity;
+    otai_spectrum_power_list_t spectrum;
+    otai_metadata_analytics_t analytics;
+} bench_sweep_t;
+
+typedef struct _bench_object_t
+{
+    const otai_object_type_info_t *info;
+    otai_object_meta_key_t key;
+    uint32_t attrcount;
+    otai_attribute_t attrs[MAX_ATTRS];
+    uint32_t countercount;
+    otai_stat_id_t counters[MAX_ATTRS];
+} bench_object_t;
+
+static const char *filter;
+
+static const otai_enum_metadata_t *enums[MAX_ENUMS];
+static size_t enum_count;
+static size_t enum_values_count;
+
+static bench_value_t values[VALUE_TYPE_COUNT];
+
+static bench_conditional_t conditionals[MAX_CONDITIONAL];
+static size_t conditional_count;
+
+static bench_object_t objects[OTAI_OBJECT_TYPE_MAX];
+
+static bench_payload_t payload;
+
+static uint64_t u64_values[NUMBER_COUNT];
+static double d64_values[NUMBER_COUNT];
+static char d64_strings[NUMBER_COUNT][64];
+static char oid_strings[NUMBER_COUNT][64];
+
+static bench_sweep_t sweeps[SWEEP_COUNT];
+static otai_metadata_analytics_channel_t channels[CHANNEL_COUNT];
+static otai_metadata_analytics_channel_t reference[CHANNEL_COUNT];
+
+static otai_metadata_arena_t arena;
+
+static char buffer[BUFFER_SIZE];
+
+static char payload_buffer[PAYLOAD_SIZE];
+
+static volatile size_t sink;
+
+static uint64_t next_random(void)
+{
+    static uint64_t state = UINT64_C(88172645463325252);
+
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return state;
+}
+
+static int compare_double(
+        _In_ const void *lhs,
+        _In_ const void *rhs)
+{
+    double l = *(const double*)lhs;
+    double r = *(const double*)rhs;
+
+    return (l > r) - (l < r);
+}
+
+/*
+ * Runs function once to warm up caches, then measures REPEATS batches of
+ * iterations, each function call being items operations.
+ */
+static void run(
+        _In_ const char *name,
+        _In_ bench_fn fn,
+        _In_ const void *arg,
+        _In_ uint64_t items,
+        _In_ uint32_t iterations)
+{
+    double results[REPEATS];
+    uint64_t ops = items * iterations;
+    int repeat;
+
+    if (ops == 0 || (filter != NULL && strncmp(name, filter, strlen(filter)) != 0))
+    {
+        return;
+    }
+
+    fn(arg);
+
+    for (repeat = 0; repeat < REPEATS; repeat++)
+    {
+        uint64_t start = otai_metadata_recorder_now();
+        uint32_t iter;
+
+        for (iter = 0; iter < iterations; iter++)
+        {
+            fn(arg);
+        }
+
+        results[repeat] = (double)(otai_metadata_recorder_now() - start) / (double)ops;
+    }
+
+    qsort(results, REPEATS, sizeof(double), compare_double);
+
+    printf("%s,%" PRIu64 ",%.1f,%.1f,%.1f\n", name, ops, results[0], results[REPEATS / 2], results[REPEATS - 1]);
+
+    fflush(stdout);
+}
+
+/*
+ * Makes benchmark name from prefix and enum short name, like
+ * "serialize/uint32-list".
+ */
+static const char* name_of(
+        _In_ const char *prefix,
+        _In_ const otai_enum_metadata_t *md,
+        _In_ int value)
+{
+    static char name[128];
+    const char *shortname = NULL;
+    size_t len;
+    size_t idx;
+
+    if (otai_metadata_get_enum_value_index(md, value, &idx))
+    {
+        shortname = md->valuesshortnames[idx];
+    }
+
+    snprintf(name, sizeof(name), "%s/%s", prefix, shortname == NULL ? "unknown" : shortname);
+
+    for (len = strlen(prefix); name[len] != 0; len++)
+    {
+        name[len] = name[len] == '_' ? '-' : (char)(name[len] >= 'A' && name[len] <= 'Z' ? name[len] - 'A' + 'a' : name[len]);
+    }
+
+    return name;
+}
+
+static void fill_value(
+        _In_ const otai_attr_metadata_t *md,
+        _Inout_ otai_attribute_value_t *value)
+{
+    const otai_enum_metadata_t *em = md->enummetadata;
+    uint32_t idx;
+
+    switch (md->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_BOOL:
+            value->booldata = true;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_CHARDATA:
+            strcpy(value->chardata, "bench");
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT8:
+            value->u8 = (uint8_t)next_random();
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT8:
+            value->s8 = (int8_t)next_random();
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT16:
+            value->u16 = (uint16_t)next_random();
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT16:
+            value->s16 = (int16_t)next_random();
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT32:
+            value->u32 = (uint32_t)next_random();
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT32:
+            value->s32 = md->isenum ? em->values[em->valuescount - 1] : (int32_t)next_random();
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT64:
+            value->u64 = next_random();
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT64:
+            value->s64 = (int64_t)next_random();
+            break;
+        case OTAI_ATTR_VALUE_TYPE_DOUBLE:
+            value->d64 = (double)(next_random() % 100000) / 100;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_ID:
+            value->oid = next_random() >> 8;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_LIST:
+            for (idx = 0; idx < value->objlist.count; idx++)
+            {
+                value->objlist.list[idx] = next_random() >> 8;
+            }
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT8_LIST:
+            for (idx = 0; idx < value->u8list.count; idx++)
+            {
+                value->u8list.list[idx] = (uint8_t)next_random();
+            }
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT8_LIST:
+            for (idx = 0; idx < value->s8list.count; idx++)
+            {
+                value->s8list.list[idx] = (int8_t)next_random();
+            }
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT16_LIST:
+            for (idx = 0; idx < value->u16list.count; idx++)
+            {
+                value->u16list.list[idx] = (uint16_t)next_random();
+            }
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT16_LIST:
+            for (idx = 0; idx < value->s16list.count; idx++)
+            {
+                value->s16list.list[idx] = (int16_t)next_random();
+            }
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT32_LIST:
+            for (idx = 0; idx < value->u32list.count; idx++)
+            {
+                value->u32list.list[idx] = (uint32_t)next_random();
+            }
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT32_LIST:
+            for (idx = 0; idx < value->s32list.count; idx++)
+            {
+                value->s32list.list[idx] = md->isenumlist ? em->values[idx % em->valuescount] : (int32_t)next_random();
+            }
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT32_RANGE:
+            value->u32range.min = (uint32_t)(next_random() % 1000);
+            value->u32range.max = value->u32range.min + 1000;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT32_RANGE:
+            value->s32range.min = -(int32_t)(next_random() % 1000);
+            value->s32range.max = value->s32range.min + 1000;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_SPECTRUM_POWER_LIST:
+            for (idx = 0; idx < value->spectrumpowerlist.count; idx++)
+            {
+                value->spectrumpowerlist.list[idx].lower_frequency = 191000000 + (uint64_t)idx * 75000;
+                value->spectrumpowerlist.list[idx].upper_frequency = 191075000 + (uint64_t)idx * 75000;
+                value->spectrumpowerlist.list[idx].power = -(double)(next_random() % 4000) / 100;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static void add_enum(
+        _In_ const otai_enum_metadata_t *md)
+{
+    size_t idx;
+
+    if (md == NULL || enum_count == MAX_ENUMS)
+    {
+        return;
+    }
+
+    for (idx = 0; idx < enum_count; idx++)
+    {
+        if (enums[idx] == md)
+        {
+            return;
+        }
+    }
+
+    enums[enum_count++] = md;
+    enum_values_count += md->valuescount;
+}
+
+static void prepare_metadata(void)
+{
+    otai_alloc_info_t info = { LIST_SIZE, NULL, NULL };
+    size_t idx;
+
+    for (idx = 0; idx < otai_metadata_attr_sorted_by_id_name_count; idx++)
+    {
+        const otai_attr_metadata_t *md = otai_metadata_attr_sorted_by_id_name[idx];
+        bench_value_t *v = &values[md->attrvaluetype];
+
+        add_enum(otai_metadata_all_object_type_infos[md->objecttype]->enummetadata);
+        add_enum(md->enummetadata);
+
+        if (md->isconditional && conditional_count < MAX_CONDITIONAL && md->conditionslength <= MAX_CONDITIONS)
+        {
+            bench_conditional_t *c = &conditionals[conditional_count++];
+
+            c->md = md;
+
+            for (c->count = 0; c->count < md->conditionslength; c->count++)
+            {
+                c->attrs[c->count].id = md->conditions[c->count]->attrid;
+                c->attrs[c->count].value = md->conditions[c->count]->condition;
+            }
+        }
+
+        if (v->md != NULL || md->attrvaluetype == OTAI_ATTR_VALUE_TYPE_POINTER)
+        {
+            continue;
+        }
+
+        if (otai_metadata_alloc_attr_value(md, &v->attr, &info) != OTAI_STATUS_SUCCESS ||
+                otai_metadata_alloc_attr_value(md, &v->capacity, &info) != OTAI_STATUS_SUCCESS)
+        {
+            fprintf(stderr, "%s: out of memory\n", md->attridname);
+
+            exit(1);
+        }
+
+        v->md = md;
+        v->attr.id = md->attrid;
+
+        fill_value(md, &v->attr.value);
+
+        otai_attribute_t attr = v->capacity;
+
+        if (otai_serialize_attribute(v->buffer, md, &v->attr) < 0 ||
+                otai_deserialize_attribute(v->buffer, &attr) < 0 ||
+                otai_serialize_attribute_binary((uint8_t*)v->binary, sizeof(v->binary), md, &v->attr) < 0 ||
+                otai_deserialize_attribute_binary((const uint8_t*)v->binary, sizeof(v->binary), md->objecttype, true, &attr) < 0)
+        {
+            fprintf(stderr, "%s: serialize failed\n", md->attridname);
+
+            exit(1);
+        }
+    }
+
+    otai_metadata_arena_init(&arena, 0, true);
+}
+
+static int serialize_payload_json(
+        _Out_ char *json)
+{
+    char *ptr = json;
+    uint32_t idx;
+
+    *ptr++ = '[';
+
+    for (idx = 0; idx < payload.count; idx++)
+    {
+        int ret = otai_serialize_attribute(ptr, payload.mds[idx], &payload.attrs[idx]);
+
+        if (ret < 0)
+        {
+            return ret;
+        }
+
+        ptr += ret;
+
+        *ptr++ = (idx + 1 < payload.count) ? ',' : ']';
+    }
+
+    *ptr = 0;
+
+    return (int)(ptr - json);
+}
+
+/*
+ * Prepares payload from object type with most attributes, lists have
+ * LIST_SIZE elements, like typical statistics and spectrum readouts.
+ */
+static void prepare_payload(void)
+{
+    otai_alloc_info_t info = { LIST_SIZE, NULL, NULL };
+    size_t best = 0;
+    int type;
+    size_t idx;
+
+    for (type = OTAI_OBJECT_TYPE_NULL + 1; type < OTAI_OBJECT_TYPE_MAX; type++)
+    {
+        const otai_object_type_info_t *oi = otai_metadata_get_object_type_info((otai_object_type_t)type);
+
+        if (oi != NULL && oi->attrmetadatalength > best)
+        {
+            best = oi->attrmetadatalength;
+            payload.objecttype = (otai_object_type_t)type;
+        }
+    }
+
+    if (best == 0)
+    {
+        return;
+    }
+
+    const otai_object_type_info_t *oi = otai_metadata_get_object_type_info(payload.objecttype);
+
+    for (idx = 0; idx < oi->attrmetadatalength && payload.count < MAX_ATTRS; idx++)
+    {
+        const otai_attr_metadata_t *md = oi->attrmetadata[idx];
+        otai_attribute_t *attr = &payload.attrs[payload.count];
+
+        if (md->attrvaluetype == OTAI_ATTR_VALUE_TYPE_POINTER ||
+                otai_metadata_alloc_attr_value(md, attr, &info) != OTAI_STATUS_SUCCESS)
+        {
+            continue;
+        }
+
+        attr->id = md->attrid;
+
+        fill_value(md, &attr->value);
+
+        payload.mds[payload.count++] = md;
+    }
+
+    int json = serialize_payload_json(payload.json);
+
+    int binary = otai_serialize_attribute_list_binary((uint8_t*)payload.binary, sizeof(payload.binary),
+            payload.objecttype, payload.count, payload.attrs);
+
+    uint32_t count = payload.count;
+
+    if (json < 0 || binary < 0 ||
+            otai_deserialize_attribute_list(payload.json, (uint8_t*)payload.arena, sizeof(payload.arena), &count, payload.decoded) < 0)
+    {
+        fprintf(stderr, "payload: serialize failed\n");
+
+        exit(1);
+    }
+
+    fprintf(stderr, "payload/%s: %u attributes, json %d bytes, binary %d bytes\n",
+            oi->objecttypename, payload.count, json, binary);
+}
+
+/*
+ * Prepares numbers, mix of dBm like and BER like doubles.
+ */
+static void prepare_numbers(void)
+{
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        u64_values[idx] = next_random() >> (next_random() % 64);
+
+        if (idx % 2)
+        {
+            d64_values[idx] = (double)(int64_t)(next_random() % 4000) / 100.0 - 20.0;
+        }
+        else
+        {
+            d64_values[idx] = (double)(next_random() % 100000) / 1e17;
+        }
+
+        otai_serialize_double(d64_strings[idx], d64_values[idx]);
+        otai_serialize_object_id(oid_strings[idx], u64_values[idx]);
+    }
+}
+
+/*
+ * Straightforward implementation of analytics, converting each entry with
+ * pow and results with log10. Entries are samples covering granularity
+ * around them, and entry partially overlapping channel adds overlapping
+ * part.
+ */
+static void analytics_scalar(
+        _In_ const otai_spectrum_power_list_t *spectrum,
+        _In_ uint64_t granularity)
+{
+    uint32_t first = 0;
+    uint32_t idx;
+
+    for (idx = 0; idx < CHANNEL_COUNT; idx++)
+    {
+        otai_metadata_analytics_channel_t *channel = &reference[idx];
+
+        double power = 0;
+        double peak = 0;
+        double noise = HUGE_VAL;
+        uint32_t entry;
+
+        while (first < spectrum->count &&
+                spectrum->list[first].lower_frequency + granularity / 2 <= channel->lowerfrequency)
+        {
+            first++;
+        }
+
+        for (entry = first; entry < spectrum->count &&
+                spectrum->list[entry].lower_frequency - granularity / 2 < channel->upperfrequency; entry++)
+        {
+            uint64_t start = spectrum->list[entry].lower_frequency - granularity / 2;
+            uint64_t end = start + granularity;
+
+            uint64_t lower = start > channel->lowerfrequency ? start : channel->lowerfrequency;
+            uint64_t upper = end < channel->upperfrequency ? end : channel->upperfrequency;
+
+            double linear = pow(10, spectrum->list[entry].power / 10);
+
+            power += linear * (double)(upper - lower) / (double)granularity;
+            peak = linear > peak ? linear : peak;
+            noise = linear < noise ? linear : noise;
+        }
+
+        noise = noise / (double)granularity;
+
+        channel->power = 10 * log10(power);
+        channel->peak = 10 * log10(peak);
+        channel->osnr = 10 * log10((power - noise * CHANNEL_WIDTH) / (noise * OTAI_METADATA_ANALYTICS_REFERENCE_BANDWIDTH));
+    }
+}
+
+static bool differs(
+        _In_ double expected,
+        _In_ double actual)
+{
+    return !(fabs(expected - actual) <= ANALYTICS_TOLERANCE);
+}
+
+/*
+ * Compares analytics of sweep with scalar loop, returns false if any
+ * channel differs.
+ */
+static bool check_sweep(
+        _Inout_ bench_sweep_t *sweep)
+{
+    uint32_t idx;
+
+    analytics_scalar(&sweep->spectrum, sweep->granularity);
+
+    if (otai_metadata_analytics_compute(&sweep->analytics, &sweep->spectrum, sweep->granularity, CHANNEL_COUNT, channels) != OTAI_STATUS_SUCCESS)
+    {
+        fprintf(stderr, "%s: compute failed\n", sweep->name);
+
+        return false;
+    }
+
+    for (idx = 0; idx < CHANNEL_COUNT; idx++)
+    {
+        if (differs(reference[idx].power, channels[idx].power) ||
+                differs(reference[idx].peak, channels[idx].peak) ||
+                differs(reference[idx].osnr, channels[idx].osnr))
+        {
+            fprintf(stderr, "%s: channel %u differs, power %f/%f dBm, peak %f/%f dBm, osnr %f/%f dB\n",
+                    sweep->name, idx,
+                    reference[idx].power, channels[idx].power,
+                    reference[idx].peak, channels[idx].peak,
+                    reference[idx].osnr, channels[idx].osnr);
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Prepares sweeps of flat top channels over ASE noise floor. 6 GHz bins
+ * don't align with channel edges, so edge entries are weighted by
+ * overlap. Returns false if analytics differs from scalar loop.
+ */
+static bool prepare_sweeps(void)
+{
+    static const char* const names[SWEEP_COUNT] = { "analytics/6ghz", "analytics/6.25ghz", "analytics/12.5ghz" };
+    static const uint64_t granularities[SWEEP_COUNT] = { 6000, 6250, 12500 };
+    bool success = true;
+    uint32_t idx;
+    int s;
+
+    for (idx = 0; idx < CHANNEL_COUNT; idx++)
+    {
+        channels[idx].lowerfrequency = BAND_LOWER_FREQUENCY + (uint64_t)idx * CHANNEL_WIDTH;
+        channels[idx].upperfrequency = channels[idx].lowerfrequency + CHANNEL_WIDTH;
+
+        reference[idx] = channels[idx];
+    }
+
+    for (s = 0; s < SWEEP_COUNT; s++)
+    {
+        bench_sweep_t *sweep = &sweeps[s];
+
+        sweep->name = names[s];
+        sweep->granularity = granularities[s];
+        sweep->spectrum.count = (uint32_t)((BAND_UPPER_FREQUENCY - BAND_LOWER_FREQUENCY) / sweep->granularity);
+        sweep->spectrum.list = (otai_spectrum_power_t*)calloc(sweep->spectrum.count, sizeof(otai_spectrum_power_t));
+
+        if (sweep->spectrum.list == NULL ||
+                otai_metadata_analytics_init(&sweep->analytics, sweep->spectrum.count) != OTAI_STATUS_SUCCESS)
+        {
+            fprintf(stderr, "%s: out of memory\n", sweep->name);
+
+            exit(1);
+        }
+
+        for (idx = 0; idx < sweep->spectrum.count; idx++)
+        {
+            uint64_t frequency = BAND_LOWER_FREQUENCY + sweep->granularity / 2 + idx * sweep->granularity;
+            uint64_t offset = (frequency - BAND_LOWER_FREQUENCY) % CHANNEL_WIDTH;
+
+            sweep->spectrum.list[idx].lower_frequency = frequency;
+            sweep->spectrum.list[idx].upper_frequency = frequency;
+            sweep->spectrum.list[idx].power = (offset > 6250 && offset < CHANNEL_WIDTH - 6250 ? -15.0 : -40.0) +
+                (double)(next_random() % 100) / 100.0;
+        }
+
+        success = check_sweep(sweep) && success;
+    }
+
+    return success;
+}
+
+static void destroy_sweeps(void)
+{
+    int s;
+
+    for (s = 0; s < SWEEP_COUNT; s++)
+    {
+        otai_metadata_analytics_destroy(&sweeps[s].analytics);
+
+        free(sweeps[s].spectrum.list);
+    }
+}
+
+static void bench_attr_id_name(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < otai_metadata_attr_sorted_by_id_name_count; idx++)
+    {
+        sink += otai_metadata_get_attr_metadata_by_attr_id_name(otai_metadata_attr_sorted_by_id_name[idx]->attridname) != NULL;
+    }
+}
+
+static void bench_attr_kebab_name(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < otai_metadata_attr_sorted_by_id_name_count; idx++)
+    {
+        const otai_attr_metadata_t *md = otai_metadata_attr_sorted_by_id_name[idx];
+
+        sink += otai_metadata_get_attr_metadata_by_attr_id_kebab_name(md->objecttype, md->attridkebabname) != NULL;
+    }
+}
+
+static void bench_attr_id(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < otai_metadata_attr_sorted_by_id_name_count; idx++)
+    {
+        const otai_attr_metadata_t *md = otai_metadata_attr_sorted_by_id_name[idx];
+
+        sink += otai_metadata_get_attr_metadata(md->objecttype, md->attrid) != NULL;
+    }
+}
+
+static void bench_stat_id_name(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < otai_metadata_stat_sorted_by_id_name_count; idx++)
+    {
+        sink += otai_metadata_get_stat_metadata_by_stat_id_name(otai_metadata_stat_sorted_by_id_name[idx]->statidname) != NULL;
+    }
+}
+
+static void bench_stat_kebab_name(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < otai_metadata_stat_sorted_by_id_name_count; idx++)
+    {
+        const otai_stat_metadata_t *md = otai_metadata_stat_sorted_by_id_name[idx];
+
+        sink += otai_metadata_get_stat_metadata_by_stat_id_kebab_name(md->objecttype, md->statidkebabname) != NULL;
+    }
+}
+
+static void bench_stat_camel_name(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < otai_metadata_stat_sorted_by_id_name_count; idx++)
+    {
+        const otai_stat_metadata_t *md = otai_metadata_stat_sorted_by_id_name[idx];
+
+        sink += otai_metadata_get_stat_metadata_by_stat_id_camel_name(md->objecttype, md->statidcamelname) != NULL;
+    }
+}
+
+static void bench_stat_id(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < otai_metadata_stat_sorted_by_id_name_count; idx++)
+    {
+        const otai_stat_metadata_t *md = otai_metadata_stat_sorted_by_id_name[idx];
+
+        sink += otai_metadata_get_stat_metadata(md->objecttype, md->statid) != NULL;
+    }
+}
+
+static void bench_enum_value_name(
+        _In_ const void *arg)
+{
+    size_t e;
+    size_t idx;
+
+    for (e = 0; e < enum_count; e++)
+    {
+        for (idx = 0; idx < enums[e]->valuescount; idx++)
+        {
+            sink += otai_metadata_get_enum_value_name(enums[e], enums[e]->values[idx]) != NULL;
+        }
+    }
+}
+
+static void bench_enum_value_index_by_name(
+        _In_ const void *arg)
+{
+    size_t e;
+    size_t idx;
+    size_t index;
+
+    for (e = 0; e < enum_count; e++)
+    {
+        for (idx = 0; idx < enums[e]->valuescount; idx++)
+        {
+            const char *name = enums[e]->valuesnames[idx];
+
+            sink += otai_metadata_get_enum_value_index_by_name(enums[e], name, strlen(name), &index);
+        }
+    }
+}
+
+static void bench_serialize_enum(
+        _In_ const void *arg)
+{
+    size_t e;
+    size_t idx;
+
+    for (e = 0; e < enum_count; e++)
+    {
+        for (idx = 0; idx < enums[e]->valuescount; idx++)
+        {
+            sink += (size_t)otai_serialize_enum(buffer, enums[e], enums[e]->values[idx]);
+        }
+    }
+}
+
+static void bench_deserialize_enum(
+        _In_ const void *arg)
+{
+    size_t e;
+    size_t idx;
+    int32_t value;
+
+    for (e = 0; e < enum_count; e++)
+    {
+        for (idx = 0; idx < enums[e]->valuescount; idx++)
+        {
+            sink += (size_t)otai_deserialize_enum(enums[e]->valuesnames[idx], enums[e], &value);
+        }
+    }
+}
+
+static void bench_serialize(
+        _In_ const void *arg)
+{
+    const bench_value_t *v = (const bench_value_t*)arg;
+
+    sink += (size_t)otai_serialize_attribute(buffer, v->md, &v->attr);
+}
+
+static void bench_deserialize(
+        _In_ const void *arg)
+{
+    const bench_value_t *v = (const bench_value_t*)arg;
+    otai_attribute_t attr = v->capacity;
+
+    sink += (size_t)otai_deserialize_attribute(v->buffer, &attr);
+}
+
+static void bench_serialize_binary(
+        _In_ const void *arg)
+{
+    const bench_value_t *v = (const bench_value_t*)arg;
+
+    sink += (size_t)otai_serialize_attribute_binary((uint8_t*)buffer, sizeof(buffer), v->md, &v->attr);
+}
+
+static void bench_deserialize_binary(
+        _In_ const void *arg)
+{
+    const bench_value_t *v = (const bench_value_t*)arg;
+    otai_attribute_t attr = v->capacity;
+
+    sink += (size_t)otai_deserialize_attribute_binary((const uint8_t*)v->binary, sizeof(v->binary), v->md->objecttype, false, &attr);
+}
+
+static void bench_payload_serialize_json(
+        _In_ const void *arg)
+{
+    sink += (size_t)serialize_payload_json(payload_buffer);
+}
+
+static void bench_payload_deserialize_json(
+        _In_ const void *arg)
+{
+    uint32_t count = payload.count;
+
+    sink += (size_t)otai_deserialize_attribute_list(payload.json, (uint8_t*)payload.arena,
+            sizeof(payload.arena), &count, payload.decoded);
+}
+
+static void bench_payload_serialize_binary(
+        _In_ const void *arg)
+{
+    sink += (size_t)otai_serialize_attribute_list_binary((uint8_t*)payload_buffer, sizeof(payload_buffer),
+            payload.objecttype, payload.count, payload.attrs);
+}
+
+static void bench_payload_deserialize_binary(
+        _In_ const void *arg)
+{
+    uint32_t count = payload.count;
+
+    sink += (size_t)otai_deserialize_attribute_list_binary((const uint8_t*)payload.binary, sizeof(payload.binary),
+            payload.objecttype, true, &count, payload.decoded);
+}
+
+static void bench_serialize_uint64(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        sink += (size_t)otai_serialize_uint64(buffer, u64_values[idx]);
+    }
+}
+
+static void bench_serialize_uint64_printf(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        sink += (size_t)sprintf(buffer, "%" PRIu64, u64_values[idx]);
+    }
+}
+
+static void bench_serialize_int64(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        sink += (size_t)otai_serialize_int64(buffer, (int64_t)u64_values[idx]);
+    }
+}
+
+static void bench_serialize_int64_printf(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        sink += (size_t)sprintf(buffer, "%" PRId64, (int64_t)u64_values[idx]);
+    }
+}
+
+static void bench_serialize_object_id(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        sink += (size_t)otai_serialize_object_id(buffer, u64_values[idx]);
+    }
+}
+
+static void bench_serialize_object_id_printf(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        sink += (size_t)sprintf(buffer, "oid:0x%" PRIx64, u64_values[idx]);
+    }
+}
+
+static void bench_serialize_double(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        sink += (size_t)otai_serialize_double(buffer, d64_values[idx]);
+    }
+}
+
+static void bench_serialize_double_printf(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        sink += (size_t)sprintf(buffer, "%.17g", d64_values[idx]);
+    }
+}
+
+static void bench_serialize_double_precision(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        sink += (size_t)otai_serialize_double_precision(buffer, d64_values[idx], OTAI_STAT_VALUE_PRECISION_2);
+    }
+}
+
+static void bench_serialize_double_precision_printf(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        sink += (size_t)sprintf(buffer, "%.2f", d64_values[idx]);
+    }
+}
+
+static void bench_deserialize_object_id(
+        _In_ const void *arg)
+{
+    otai_object_id_t oid;
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        sink += (size_t)otai_deserialize_object_id(oid_strings[idx], &oid);
+    }
+}
+
+static void bench_deserialize_object_id_scanf(
+        _In_ const void *arg)
+{
+    otai_object_id_t oid;
+    int read;
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        sink += (size_t)sscanf(oid_strings[idx], "oid:0x%16" SCNx64 "%n", &oid, &read);
+    }
+}
+
+static void bench_deserialize_double(
+        _In_ const void *arg)
+{
+    otai_double_t d64;
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        sink += (size_t)otai_deserialize_double(d64_strings[idx], &d64);
+    }
+}
+
+static void bench_deserialize_double_strtod(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < NUMBER_COUNT; idx++)
+    {
+        sink += (size_t)(strtod(d64_strings[idx], NULL) > 0);
+    }
+}
+
+static void bench_analytics(
+        _In_ const void *arg)
+{
+    /* analytics state of sweep changes */
+
+    bench_sweep_t *sweep = &sweeps[(const bench_sweep_t*)arg - sweeps];
+
+    otai_metadata_analytics_compute(&sweep->analytics, &sweep->spectrum, sweep->granularity, CHANNEL_COUNT, channels);
+
+    sink += (size_t)channels[0].power;
+}
+
+static void bench_analytics_scalar(
+        _In_ const void *arg)
+{
+    const bench_sweep_t *sweep = (const bench_sweep_t*)arg;
+
+    analytics_scalar(&sweep->spectrum, sweep->granularity);
+
+    sink += (size_t)reference[0].power;
+}
+
+static void bench_alloc(
+        _In_ const void *arg)
+{
+    const bench_value_t *v = (const bench_value_t*)arg;
+    otai_alloc_info_t info = { LIST_SIZE, NULL, NULL };
+    otai_attribute_t attr;
+
+    memset(&attr, 0, sizeof(attr));
+
+    otai_metadata_alloc_attr_value(v->md, &attr, &info);
+    otai_metadata_free_attr_value(v->md, &attr, &info);
+}
+
+static void bench_deepcopy(
+        _In_ const void *arg)
+{
+    const bench_value_t *v = (const bench_value_t*)arg;
+    otai_attribute_t attr;
+
+    otai_metadata_deepcopy_attr_value(v->md, &v->attr, &attr);
+    otai_metadata_free_attr_value(v->md, &attr, NULL);
+}
+
+static void bench_deepcopy_arena(
+        _In_ const void *arg)
+{
+    const bench_value_t *v = (const bench_value_t*)arg;
+    otai_alloc_info_t info = { 0, NULL, &arena };
+    otai_attribute_t attr;
+
+    otai_metadata_deepcopy_attr_value_ext(v->md, &v->attr, &attr, &info);
+    otai_metadata_free_attr_value(v->md, &attr, &info);
+}
+
+static void bench_condition_list(
+        _In_ const void *arg)
+{
+    size_t idx;
+
+    for (idx = 0; idx < conditional_count; idx++)
+    {
+        const bench_conditional_t *c = &conditionals[idx];
+
+        sink += otai_metadata_is_condition_met(c->md, c->count, c->attrs);
+    }
+}
+
+static void bench_condition_context(
+        _In_ const void *arg)
+{
+    otai_metadata_validation_context_t context;
+    size_t idx;
+
+    for (idx = 0; idx < conditional_count; idx++)
+    {
+        const bench_conditional_t *c = &conditionals[idx];
+
+        otai_metadata_validation_context_init(&context, c->md->objecttype, c->count, c->attrs);
+
+        sink += otai_metadata_validation_context_is_condition_met(&context, c->md);
+    }
+}
+
+static void bench_check_create(
+        _In_ const void *arg)
+{
+    const bench_object_t *o = (const bench_object_t*)arg;
+    otai_metadata_validation_context_t context;
+
+    otai_metadata_validation_context_init(&context, o->info->objecttype, o->attrcount, o->attrs);
+
+    sink += otai_metadata_validation_context_check_create(&context) == OTAI_STATUS_SUCCESS;
+}
+
+static void bench_get(
+        _In_ const void *arg)
+{
+    const bench_object_t *o = (const bench_object_t*)arg;
+    otai_attribute_t attr = o->attrs[0];
+
+    sink += o->info->get(&o->key, 1, &attr) == OTAI_STATUS_SUCCESS;
+}
+
+static void bench_get_stats(
+        _In_ const void *arg)
+{
+    const bench_object_t *o = (const bench_object_t*)arg;
+    otai_stat_value_t counters[MAX_ATTRS];
+
+    sink += o->info->getstats(&o->key, o->countercount, o->counters, counters) == OTAI_STATUS_SUCCESS;
+}
+
+/*
+ * Prepares mandatory on create attributes of object type, object id
+ * attributes refer to linecard. Conditional attributes are left out.
+ */
+static void prepare_object(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t linecard_id)
+{
+    bench_object_t *o = &objects[object_type];
+    const otai_stat_metadata_t* const* stats = otai_metadata_stat_by_object_type[object_type];
+    size_t idx;
+
+    o->info = otai_metadata_get_object_type_info(object_type);
+    o->key.objecttype = object_type;
+
+    for (idx = 0; idx < o->info->attrmetadatalength && o->attrcount < MAX_ATTRS; idx++)
+    {
+        const otai_attr_metadata_t *md = o->info->attrmetadata[idx];
+        otai_attribute_t *attr = &o->attrs[o->attrcount];
+
+        if (!md->ismandatoryoncreate || md->isconditional)
+        {
+            continue;
+        }
+
+        memset(attr, 0, sizeof(otai_attribute_t));
+
+        attr->id = md->attrid;
+
+        if (md->attrvaluetype == OTAI_ATTR_VALUE_TYPE_OBJECT_ID)
+        {
+            attr->value.oid = linecard_id;
+        }
+        else
+        {
+            fill_value(md, &attr->value);
+        }
+
+        o->attrcount++;
+    }
+
+    for (idx = 0; stats != NULL && stats[idx] != NULL && o->countercount < MAX_ATTRS; idx++)
+    {
+        o->counters[o->countercount++] = stats[idx]->statid;
+    }
+}
+
+static bool create_object(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t linecard_id)
+{
+    bench_object_t *o = &objects[object_type];
+
+    prepare_object(object_type, linecard_id);
+
+    if (o->info->create == NULL)
+    {
+        return false;
+    }
+
+    return o->info->create(&o->key, linecard_id, o->attrcount, o->attrs) == OTAI_STATUS_SUCCESS;
+}
+
+static void run_values(void)
+{
+    int type;
+
+    for (type = 0; type < VALUE_TYPE_COUNT; type++)
+    {
+        const bench_value_t *v = &values[type];
+
+        if (v->md == NULL)
+        {
+            continue;
+        }
+
+        run(name_of("serialize", &otai_metadata_enum_otai_attr_value_type_t, type), bench_serialize, v, 1, VALUE_ITERATIONS);
+        run(name_of("deserialize", &otai_metadata_enum_otai_attr_value_type_t, type), bench_deserialize, v, 1, VALUE_ITERATIONS);
+        run(name_of("serialize-binary", &otai_metadata_enum_otai_attr_value_type_t, type), bench_serialize_binary, v, 1, VALUE_ITERATIONS);
+        run(name_of("deserialize-binary", &otai_metadata_enum_otai_attr_value_type_t, type), bench_deserialize_binary, v, 1, VALUE_ITERATIONS);
+        run(name_of("alloc-free", &otai_metadata_enum_otai_attr_value_type_t, type), bench_alloc, v, 1, VALUE_ITERATIONS);
+        run(name_of("deepcopy-free", &otai_metadata_enum_otai_attr_value_type_t, type), bench_deepcopy, v, 1, VALUE_ITERATIONS);
+        run(name_of("deepcopy-arena", &otai_metadata_enum_otai_attr_value_type_t, type), bench_deepcopy_arena, v, 1, VALUE_ITERATIONS);
+    }
+}
+
+static void run_numbers(void)
+{
+    run("number/serialize-uint64", bench_serialize_uint64, NULL, NUMBER_COUNT, NUMBER_ITERATIONS);
+    run("number/serialize-uint64-printf", bench_serialize_uint64_printf, NULL, NUMBER_COUNT, NUMBER_ITERATIONS);
+    run("number/serialize-int64", bench_serialize_int64, NULL, NUMBER_COUNT, NUMBER_ITERATIONS);
+    run("number/serialize-int64-printf", bench_serialize_int64_printf, NULL, NUMBER_COUNT, NUMBER_ITERATIONS);
+    run("number/serialize-object-id", bench_serialize_object_id, NULL, NUMBER_COUNT, NUMBER_ITERATIONS);
+    run("number/serialize-object-id-printf", bench_serialize_object_id_printf, NULL, NUMBER_COUNT, NUMBER_ITERATIONS);
+    run("number/serialize-double", bench_serialize_double, NULL, NUMBER_COUNT, NUMBER_ITERATIONS);
+    run("number/serialize-double-printf", bench_serialize_double_printf, NULL, NUMBER_COUNT, NUMBER_ITERATIONS);
+    run("number/serialize-double-precision", bench_serialize_double_precision, NULL, NUMBER_COUNT, NUMBER_ITERATIONS);
+    run("number/serialize-double-precision-printf", bench_serialize_double_precision_printf, NULL, NUMBER_COUNT, NUMBER_ITERATIONS);
+    run("number/deserialize-object-id", bench_deserialize_object_id, NULL, NUMBER_COUNT, NUMBER_ITERATIONS);
+    run("number/deserialize-object-id-scanf", bench_deserialize_object_id_scanf, NULL, NUMBER_COUNT, NUMBER_ITERATIONS);
+    run("number/deserialize-double", bench_deserialize_double, NULL, NUMBER_COUNT, NUMBER_ITERATIONS);
+    run("number/deserialize-double-strtod", bench_deserialize_double_strtod, NULL, NUMBER_COUNT, NUMBER_ITERATIONS);
+}
+
+static void run_sweeps(void)
+{
+    char name[128];
+    int s;
+
+    for (s = 0; s < SWEEP_COUNT; s++)
+    {
+        const bench_sweep_t *sweep = &sweeps[s];
+
+        run(sweep->name, bench_analytics, sweep, CHANNEL_COUNT, ANALYTICS_ITERATIONS);
+
+        snprintf(name, sizeof(name), "%s-scalar", sweep->name);
+
+        run(name, bench_analytics_scalar, sweep, CHANNEL_COUNT, ANALYTICS_ITERATIONS);
+    }
+}
+
+static void run_adapter(void)
+{
+    otai_apis_t apis;
+    int type;
+
+    if (otai_api_initialize(0, NULL) != OTAI_STATUS_SUCCESS)
+    {
+        fprintf(stderr, "adapter initialize failed, skipping adapter benchmarks\n");
+
+        return;
+    }
+
+    otai_metadata_apis_query(otai_api_query, &apis);
+
+    if (!create_object(OTAI_OBJECT_TYPE_LINECARD, OTAI_NULL_OBJECT_ID))
+    {
+        fprintf(stderr, "linecard create failed, skipping adapter benchmarks\n");
+
+        otai_api_uninitialize();
+
+        return;
+    }
+
+    otai_object_id_t linecard_id = objects[OTAI_OBJECT_TYPE_LINECARD].key.objectkey.key.object_id;
+
+    for (type = OTAI_OBJECT_TYPE_NULL + 1; type < OTAI_OBJECT_TYPE_MAX; type++)
+    {
+        const bench_object_t *o = &objects[type];
+
+        if (otai_metadata_get_object_type_info((otai_object_type_t)type) == NULL ||
+                (type != OTAI_OBJECT_TYPE_LINECARD && !create_object((otai_object_type_t)type, linecard_id)))
+        {
+            continue;
+        }
+
+        run(name_of("check-create", &otai_metadata_enum_otai_object_type_t, type), bench_check_create, o, 1, CREATE_ITERATIONS);
+
+        if (o->info->get != NULL && o->attrcount != 0)
+        {
+            run(name_of("get", &otai_metadata_enum_otai_object_type_t, type), bench_get, o, 1, ADAPTER_ITERATIONS);
+        }
+
+        if (o->info->getstats != NULL)
+        {
+            run(name_of("get-stats", &otai_metadata_enum_otai_object_type_t, type), bench_get_stats, o, o->countercount, ADAPTER_ITERATIONS);
+        }
+    }
+
+    otai_api_uninitialize();
+}
+
+int main(int argc, char **argv)
+{
+    filter = argc > 1 ? argv[1] : NULL;
+
+    otai_metadata_log_level = OTAI_LOG_LEVEL_ERROR;
+
+    prepare_metadata();
+    prepare_payload();
+    prepare_numbers();
+
+    bool success = prepare_sweeps();
+
+    printf("benchmark,ops,min_ns,median_ns,max_ns\n");
+
+    run("lookup/attr-id-name", bench_attr_id_name, NULL, otai_metadata_attr_sorted_by_id_name_count, LOOKUP_ITERATIONS);
+    run("lookup/attr-kebab-name", bench_attr_kebab_name, NULL, otai_metadata_attr_sorted_by_id_name_count, LOOKUP_ITERATIONS);
+    run("lookup/attr-id", bench_attr_id, NULL, otai_metadata_attr_sorted_by_id_name_count, LOOKUP_ITERATIONS);
+    run("lookup/stat-id-name", bench_stat_id_name, NULL, otai_metadata_stat_sorted_by_id_name_count, LOOKUP_ITERATIONS);
+    run("lookup/stat-kebab-name", bench_stat_kebab_name, NULL, otai_metadata_stat_sorted_by_id_name_count, LOOKUP_ITERATIONS);
+    run("lookup/stat-camel-name", bench_stat_camel_name, NULL, otai_metadata_stat_sorted_by_id_name_count, LOOKUP_ITERATIONS);
+    run("lookup/stat-id", bench_stat_id, NULL, otai_metadata_stat_sorted_by_id_name_count, LOOKUP_ITERATIONS);
+    run("lookup/enum-value-name", bench_enum_value_name, NULL, enum_values_count, ENUM_ITERATIONS);
+    run("lookup/enum-value-index-by-name", bench_enum_value_index_by_name, NULL, enum_values_count, ENUM_ITERATIONS);
+
+    run("serialize/enum", bench_serialize_enum, NULL, enum_values_count, ENUM_ITERATIONS);
+    run("deserialize/enum", bench_deserialize_enum, NULL, enum_values_count, ENUM_ITERATIONS);
+
+    run_values();
+
+    run("payload/serialize-json", bench_payload_serialize_json, NULL, payload.count, PAYLOAD_ITERATIONS);
+    run("payload/deserialize-json", bench_payload_deserialize_json, NULL, payload.count, PAYLOAD_ITERATIONS);
+    run("payload/serialize-binary", bench_payload_serialize_binary, NULL, payload.count, PAYLOAD_ITERATIONS);
+    run("payload/deserialize-binary", bench_payload_deserialize_binary, NULL, payload.count, PAYLOAD_ITERATIONS);
+
+    run("condition/attr-list", bench_condition_list, NULL, conditional_count, CONDITION_ITERATIONS);
+    run("condition/context", bench_condition_context, NULL, conditional_count, CONDITION_ITERATIONS);
+
+    run_numbers();
+    run_sweeps();
+    run_adapter();
+
+    destroy_sweeps();
+
+    otai_metadata_arena_destroy(&arena);
+
+    return success ? 0 : 1;
+}
@@ -0,0 +1,594 @@
+/**
+ * Copyright (c) 2021 Alibaba Group.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABILITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ * @file    otaivsscale.c
+ *
+ * @brief   This file contains multi linecard scale test of API layer and
+ *          virtual adapter
+ *
+ * Harness creates linecards, each with ports, transceivers, logical
+ * channels, OTN, ethernet and interface objects, then threads make fixed
+ * number of get, set and statistics calls each on random objects. Calls
+ * go through instrumented method tables, whose latency histograms give
+ * tail latency of each operation.
+ *
+ * Objects are created with mandatory on create attributes, and traffic
+ * uses non list attributes only: set on create and set attributes, get on
+ * attributes which have value, statistics read all counters of object.
+ *
+ * Usage: otaivsscale [-l linecards] [-f fanout] [-t threads] [-n calls]
+ *        [-s set percent] [-S stats percent] [-L latency ns]
+ */
+
+/* getopt and pthread barrier are not declared in strict ANSI mode */
+#define _POSIX_C_SOURCE 200112L
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <otai.h>
+#include "otaimetadata.h"
+#include "otaimetadatainstrument.h"
+#include "otaivs.h"
+
+#define MAX_ATTRS 64
+#define MAX_THREADS 256
+
+typedef struct _scale_fanout_t
+{
+    otai_object_type_t objecttype;
+    uint32_t count;
+} scale_fanout_t;
+
+/*
+ * Objects of each linecard at fanout 1, like 16 client and 16 line side
+ * ports with their transceivers and channels.
+ */
+static const scale_fanout_t fanouts[] = {
+    { OTAI_OBJECT_TYPE_PORT, 32 },
+    { OTAI_OBJECT_TYPE_TRANSCEIVER, 32 },
+    { OTAI_OBJECT_TYPE_LOGICALCHANNEL, 32 },
+    { OTAI_OBJECT_TYPE_OTN, 16 },
+    { OTAI_OBJECT_TYPE_ETHERNET, 16 },
+    { OTAI_OBJECT_TYPE_INTERFACE, 8 },
+};
+
+#define FANOUT_COUNT (sizeof(fanouts) / sizeof(fanouts[0]))
+
+typedef struct _scale_class_t
+{
+    const otai_object_type_info_t *info;
+    uint32_t attrcount;
+    otai_attribute_t attrs[MAX_ATTRS];
+    uint32_t getcount;
+    otai_attribute_t gets[MAX_ATTRS];
+    uint32_t setcount;
+    otai_attribute_t sets[MAX_ATTRS];
+    uint32_t countercount;
+    otai_stat_id_t counters[MAX_ATTRS];
+} scale_class_t;
+
+typedef struct _scale_op_t
+{
+    const char *name;
+    otai_metadata_instrument_op_t op;
+} scale_op_t;
+
+static const scale_op_t ops[] = {
+    { "create", OTAI_METADATA_INSTRUMENT_OP_CREATE },
+    { "get", OTAI_METADATA_INSTRUMENT_OP_GET },
+    { "set", OTAI_METADATA_INSTRUMENT_OP_SET },
+    { "get-stats", OTAI_METADATA_INSTRUMENT_OP_GET_STATS },
+};
+
+#define OP_COUNT (sizeof(ops) / sizeof(ops[0]))
+
+static uint32_t linecards = 64;
+static uint32_t fanout = 1;
+static uint32_t threads = 4;
+static uint32_t calls = 100000;
+static uint32_t set_percent = 10;
+static uint32_t stats_percent = 30;
+static uint64_t latency;
+
+static scale_class_t classes[OTAI_OBJECT_TYPE_MAX];
+
+static otai_object_meta_key_t *objects;
+static uint32_t object_count;
+
+static pthread_barrier_t barrier;
+
+static uint64_t next_random(
+        _Inout_ uint64_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return *state;
+}
+
+static bool is_scalar(
+        _In_ const otai_attr_metadata_t *md)
+{
+    switch (md->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_BOOL:
+        case OTAI_ATTR_VALUE_TYPE_CHARDATA:
+        case OTAI_ATTR_VALUE_TYPE_UINT8:
+        case OTAI_ATTR_VALUE_TYPE_INT8:
+        case OTAI_ATTR_VALUE_TYPE_UINT16:
+        case OTAI_ATTR_VALUE_TYPE_INT16:
+        case OTAI_ATTR_VALUE_TYPE_UINT32:
+        case OTAI_ATTR_VALUE_TYPE_INT32:
+        case OTAI_ATTR_VALUE_TYPE_UINT64:
+        case OTAI_ATTR_VALUE_TYPE_INT64:
+        case OTAI_ATTR_VALUE_TYPE_DOUBLE:
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_ID:
+        case OTAI_ATTR_VALUE_TYPE_UINT32_RANGE:
+        case OTAI_ATTR_VALUE_TYPE_INT32_RANGE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/*
+ * Fills scalar value, enums get first value, numbers get index, so
+ * mandatory ids are unique on linecard.
+ */
+static void fill_value(
+        _In_ const otai_attr_metadata_t *md,
+        _In_ uint32_t index,
+        _In_ otai_object_id_t linecard_id,
+        _Out_ otai_attribute_value_t *value)
+{
+    memset(value, 0, sizeof(otai_attribute_value_t));
+
+    switch (md->attrvaluetype)
+    {
+        case OTAI_ATTR_VALUE_TYPE_BOOL:
+            value->booldata = (index & 1) != 0;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_CHARDATA:
+            sprintf(value->chardata, "scale-%u", index);
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT8:
+            value->u8 = (uint8_t)index;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT8:
+            value->s8 = (int8_t)index;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT16:
+            value->u16 = (uint16_t)index;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT16:
+            value->s16 = (int16_t)index;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT32:
+            value->u32 = index;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT32:
+            value->s32 = md->isenum ? md->enummetadata->values[0] : (int32_t)index;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT64:
+            value->u64 = index;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT64:
+            value->s64 = index;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_DOUBLE:
+            value->d64 = (double)index / 100;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_OBJECT_ID:
+            value->oid = linecard_id;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_UINT32_RANGE:
+            value->u32range.min = index;
+            value->u32range.max = index + 100;
+            break;
+        case OTAI_ATTR_VALUE_TYPE_INT32_RANGE:
+            value->s32range.min = (int32_t)index;
+            value->s32range.max = (int32_t)index + 100;
+            break;
+        default:
+            break;
+    }
+}
+
+static void prepare_class(
+        _In_ otai_object_type_t object_type)
+{
+    scale_class_t *c = &classes[object_type];
+    const otai_stat_metadata_t* const* stats = otai_metadata_stat_by_object_type[object_type];
+    size_t idx;
+
+    c->info = otai_metadata_get_object_type_info(object_type);
+
+    if (c->info == NULL)
+    {
+        return;
+    }
+
+    for (idx = 0; idx < c->info->attrmetadatalength; idx++)
+    {
+        const otai_attr_metadata_t *md = c->info->attrmetadata[idx];
+
+        if (md->isconditional || !is_scalar(md))
+        {
+            continue;
+        }
+
+        if (md->ismandatoryoncreate && c->attrcount < MAX_ATTRS)
+        {
+            c->attrs[c->attrcount].id = md->attrid;
+
+            fill_value(md, 1, OTAI_NULL_OBJECT_ID, &c->attrs[c->attrcount++].value);
+        }
+
+        if (md->iscreateandset && md->attrvaluetype != OTAI_ATTR_VALUE_TYPE_OBJECT_ID && c->setcount < MAX_ATTRS)
+        {
+            c->sets[c->setcount].id = md->attrid;
+
+            fill_value(md, 1, OTAI_NULL_OBJECT_ID, &c->sets[c->setcount++].value);
+        }
+
+        if ((md->isreadonly || md->ismandatoryoncreate || md->defaultvaluetype == OTAI_DEFAULT_VALUE_TYPE_CONST) &&
+                !md->issetonly && c->getcount < MAX_ATTRS)
+        {
+            memset(&c->gets[c->getcount], 0, sizeof(otai_attribute_t));
+
+            c->gets[c->getcount++].id = md->attrid;
+        }
+    }
+
+    for (idx = 0; stats != NULL && stats[idx] != NULL && c->countercount < MAX_ATTRS; idx++)
+    {
+        c->counters[c->countercount++] = stats[idx]->statid;
+    }
+}
+
+static otai_status_t create_object(
+        _In_ otai_object_type_t object_type,
+        _In_ otai_object_id_t linecard_id,
+        _In_ uint32_t index,
+        _Out_ otai_object_meta_key_t *key)
+{
+    const scale_class_t *c = &classes[object_type];
+    otai_attribute_t attrs[MAX_ATTRS];
+    uint32_t idx;
+
+    for (idx = 0; idx < c->attrcount; idx++)
+    {
+        attrs[idx].id = c->attrs[idx].id;
+
+        fill_value(otai_metadata_get_attr_metadata(object_type, c->attrs[idx].id), index, linecard_id, &attrs[idx].value);
+    }
+
+    memset(key, 0, sizeof(otai_object_meta_key_t));
+
+    key->objecttype = object_type;
+
+    return c->info->create(key, linecard_id, c->attrcount, attrs);
+}
+
+static bool create_objects(void)
+{
+    uint32_t total = linecards;
+    uint32_t lc;
+    size_t idx;
+
+    for (idx = 0; idx < FANOUT_COUNT; idx++)
+    {
+        total += linecards * fanouts[idx].count * fanout;
+    }
+
+    objects = (otai_object_meta_key_t*)calloc(total, sizeof(otai_object_meta_key_t));
+
+    if (objects == NULL)
+    {
+        printf("out of memory\n");
+
+        return false;
+    }
+
+    for (lc = 0; lc < linecards; lc++)
+    {
+        otai_object_meta_key_t *linecard = &objects[object_count];
+        otai_status_t status = create_object(OTAI_OBJECT_TYPE_LINECARD, OTAI_NULL_OBJECT_ID, lc + 1, linecard);
+
+        if (status != OTAI_STATUS_SUCCESS)
+        {
+            printf("linecard %u create failed: %d\n", lc, status);
+
+            return false;
+        }
+
+        object_count++;
+
+        for (idx = 0; idx < FANOUT_COUNT; idx++)
+        {
+            uint32_t count = fanouts[idx].count * fanout;
+            uint32_t obj;
+
+            if (classes[fanouts[idx].objecttype].info == NULL || classes[fanouts[idx].objecttype].info->create == NULL)
+            {
+                continue;
+            }
+
+            for (obj = 0; obj < count; obj++)
+            {
+                status = create_object(fanouts[idx].objecttype, linecard->objectkey.key.object_id, obj + 1, &objects[object_count]);
+
+                if (status != OTAI_STATUS_SUCCESS)
+                {
+                    printf("%s %u create failed: %d\n", classes[fanouts[idx].objecttype].info->objecttypename, obj, status);
+
+                    return false;
+                }
+
+                object_count++;
+            }
+        }
+    }
+
+    return true;
+}
+
+static void* worker(
+        _In_ void *arg)
+{
+    uint64_t state = UINT64_C(88172645463325252) ^ ((uint64_t)(uintptr_t)arg + 1) * UINT64_C(0x9E3779B97F4A7C15);
+    otai_stat_value_t counters[MAX_ATTRS];
+    uint32_t call;
+
+    pthread_barrier_wait(&barrier);
+
+    for (call = 0; call < calls; call++)
+    {
+        const otai_object_meta_key_t *key = &objects[next_random(&state) % object_count];
+        const scale_class_t *c = &classes[key->objecttype];
+        uint32_t mix = (uint32_t)(next_random(&state) % 100);
+        uint32_t pick = (uint32_t)next_random(&state);
+
+        if (mix < set_percent && c->setcount != 0 && c->info->set != NULL)
+        {
+            c->info->set(key, &c->sets[pick % c->setcount]);
+        }
+        else if (mix < set_percent + stats_percent && c->countercount != 0 && c->info->getstats != NULL)
+        {
+            c->info->getstats(key, c->countercount, c->counters, counters);
+        }
+        else if (c->getcount != 0 && c->info->get != NULL)
+        {
+            otai_attribute_t attr = c->gets[pick % c->getcount];
+
+            c->info->get(key, 1, &attr);
+        }
+    }
+
+    pthread_barrier_wait(&barrier);
+
+    return NULL;
+}
+
+static uint64_t peak_rss(void)
+{
+    struct rusage usage;
+
+    getrusage(RUSAGE_SELF, &usage);
+
+    return (uint64_t)usage.ru_maxrss * 1024;
+}
+
+static void report(
+        _In_ const otai_metadata_instrument_entry_t *entries,
+        _In_ uint32_t count,
+        _In_ uint64_t create_elapsed,
+        _In_ uint64_t traffic_elapsed)
+{
+    size_t op;
+    uint32_t idx;
+
+    printf("%-10s %10s %8s %12s %10s %10s %10s %10s\n", "op", "calls", "errors", "calls/s", "p50 us", "p99 us", "p99.9 us", "max us");
+
+    for (op = 0; op < OP_COUNT; op++)
+    {
+        otai_metadata_instrument_entry_t total;
+        uint64_t elapsed = ops[op].op == OTAI_METADATA_INSTRUMENT_OP_CREATE ? create_elapsed : traffic_elapsed;
+        int bucket;
+
+        memset(&total, 0, sizeof(total));
+
+        for (idx = 0; idx < count; idx++)
+        {
+            if (entries[idx].op != ops[op].op)
+            {
+                continue;
+            }
+
+            total.calls += entries[idx].calls;
+            total.errors += entries[idx].errors;
+            total.max = entries[idx].max > total.max ? entries[idx].max : total.max;
+
+            for (bucket = 0; bucket < OTAI_METADATA_INSTRUMENT_BUCKETS; bucket++)
+            {
+                total.histogram[bucket] += entries[idx].histogram[bucket];
+            }
+        }
+
+        printf("%-10s %10" PRIu64 " %8" PRIu64 " %12.0f %10.1f %10.1f %10.1f %10.1f\n", ops[op].name, total.calls, total.errors,
+                elapsed ? (double)total.calls * 1e9 / (double)elapsed : 0,
+                (double)otai_metadata_instrument_percentile(&total, 50) / 1000,
+                (double)otai_metadata_instrument_percentile(&total, 99) / 1000,
+                (double)otai_metadata_instrument_percentile(&total, 99.9) / 1000,
+                (double)total.max / 1000);
+    }
+}
+
+static bool parse_options(
+        _In_ int argc,
+        _In_ char **argv)
+{
+    int opt;
+
+    while ((opt = getopt(argc, argv, "l:f:t:n:s:S:L:")) != -1)
+    {
+        switch (opt)
+        {
+            case 'l':
+                linecards = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'f':
+                fanout = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 't':
+                threads = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'n':
+                calls = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                set_percent = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'S':
+                stats_percent = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+            case 'L':
+                latency = strtoull(optarg, NULL, 0);
+                break;
+            default:
+                return false;
+        }
+    }
+
+    return linecards != 0 && threads != 0 && threads <= MAX_THREADS && set_percent + stats_percent <= 100;
+}
+
+int main(int argc, char **argv)
+{
+    const otai_metadata_instrument_config_t config = { otai_api_query, 0 };
+    pthread_t tids[MAX_THREADS];
+    otai_metadata_instrument_entry_t *entries;
+    otai_apis_t apis;
+    uint64_t rss;
+    uint64_t start;
+    uint64_t create_elapsed;
+    uint64_t traffic_elapsed;
+    uint32_t count = 0;
+    uint32_t idx;
+
+    if (!parse_options(argc, argv))
+    {
+        printf("usage: %s [-l linecards] [-f fanout] [-t threads] [-n calls] [-s set percent] [-S stats percent] [-L latency ns]\n", argv[0]);
+
+        return 1;
+    }
+
+    otai_metadata_log_level = OTAI_LOG_LEVEL_ERROR;
+
+    if (otai_api_initialize(0, NULL) != OTAI_STATUS_SUCCESS ||
+            otai_metadata_instrument_init(&config) != OTAI_STATUS_SUCCESS)
+    {
+        printf("initialize failed\n");
+
+        return 1;
+    }
+
+    otai_metadata_apis_query(otai_metadata_instrument_api_query, &apis);
+
+    prepare_class(OTAI_OBJECT_TYPE_LINECARD);
+
+    for (idx = 0; idx < FANOUT_COUNT; idx++)
+    {
+        prepare_class(fanouts[idx].objecttype);
+    }
+
+    rss = peak_rss();
+    start = otai_metadata_instrument_now();
+
+    if (!create_objects())
+    {
+        return 1;
+    }
+
+    create_elapsed = otai_metadata_instrument_now() - start;
+
+    printf("linecards %u, objects %u, threads %u, calls %" PRIu64 ", latency %" PRIu64 " ns\n",
+            linecards, object_count, threads, (uint64_t)calls * threads, latency);
+    printf("memory: adapter %.0f bytes/object, peak rss %.0f bytes/object\n",
+            (double)otai_vs_get_memory_usage() / (double)otai_vs_get_object_count(OTAI_OBJECT_TYPE_NULL),
+            (double)(peak_rss() - rss) / (double)object_count);
+
+    if (latency != 0)
+    {
+        otai_vs_fault_t fault = { 0, 0, 0, OTAI_STATUS_SUCCESS };
+
+        fault.latency = latency;
+
+        otai_vs_set_fault(OTAI_OBJECT_TYPE_NULL, &fault);
+    }
+
+    pthread_barrier_init(&barrier, NULL, threads + 1);
+
+    for (idx = 0; idx < threads; idx++)
+    {
+        pthread_create(&tids[idx], NULL, worker, (void*)(uintptr_t)idx);
+    }
+
+    pthread_barrier_wait(&barrier);
+
+    start = otai_metadata_instrument_now();
+
+    pthread_barrier_wait(&barrier);
+
+    traffic_elapsed = otai_metadata_instrument_now() - start;
+
+    for (idx = 0; idx < threads; idx++)
+    {
+        pthread_join(tids[idx], NULL);
+    }
+
+    pthread_barrier_destroy(&barrier);
+
+    otai_metadata_instrument_snapshot(&count, NULL);
+
+    entries = (otai_metadata_instrument_entry_t*)calloc(count + 1, sizeof(otai_metadata_instrument_entry_t));
+
+    if (entries == NULL || otai_metadata_instrument_snapshot(&count, entries) != OTAI_STATUS_SUCCESS)
+    {
+        printf("snapshot failed\n");
+
+        return 1;
+    }
+
+    report(entries, count, create_elapsed, traffic_elapsed);
+
+    if (otai_metadata_instrument_get_dropped() != 0)
+    {
+        printf("dropped %" PRIu64 " calls not recorded\n", otai_metadata_instrument_get_dropped());
+    }
+
+    free(entries);
+    free(objects);
+
+    otai_api_uninitialize();
+
+    return 0;
+}